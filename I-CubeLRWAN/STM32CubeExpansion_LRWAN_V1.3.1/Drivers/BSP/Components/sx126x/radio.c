@@ -337,6 +337,14 @@ void RadioRxBoosted( uint32_t timeout );
  */
 void RadioSetRxDutyCycle( uint32_t rxTime, uint32_t sleepTime );
 
+/*!
+ * \brief Sets the buffer the next received frames are read into
+ *
+ * \param [IN] buffer Buffer of at least 255 bytes,
+ *                    NULL to use the driver internal buffer
+ */
+void RadioSetRxBuffer( uint8_t *buffer );
+
 /*!
  * Radio driver structure initialization
  */
@@ -371,7 +379,8 @@ const struct Radio_s Radio =
     RadioIrqProcess,
     // Available on SX126x only
     RadioRxBoosted,
-    RadioSetRxDutyCycle
+    RadioSetRxDutyCycle,
+    RadioSetRxBuffer
 };
 
 /*
@@ -435,6 +444,11 @@ bool RxContinuous = false;
 PacketStatus_t RadioPktStatus;
 uint8_t RadioRxPayload[255];
 
+/*!
+ * Buffer the received frames are read into
+ */
+static uint8_t *RadioRxBuffer = RadioRxPayload;
+
 bool IrqFired = false;
 
 /*
@@ -1012,6 +1026,11 @@ void RadioSetRxDutyCycle( uint32_t rxTime, uint32_t sleepTime )
     SX126xSetRxDutyCycle( rxTime, sleepTime );
 }
 
+void RadioSetRxBuffer( uint8_t *buffer )
+{
+    RadioRxBuffer = ( buffer != NULL ) ? buffer : RadioRxPayload;
+}
+
 void RadioStartCad( void )
 {
     SX126xSetCad( );
@@ -1173,11 +1192,11 @@ void RadioIrqProcess( void )
                 SX126xWriteRegister( 0x0944, SX126xReadRegister( 0x0944 ) | ( 1 << 1 ) );
                 // WORKAROUND END
             }
-            SX126xGetPayload( RadioRxPayload, &size , 255 );
+            SX126xGetPayload( RadioRxBuffer, &size , 255 );
             SX126xGetPacketStatus( &RadioPktStatus );
             if( ( RadioEvents != NULL ) && ( RadioEvents->RxDone != NULL ) )
             {
-                RadioEvents->RxDone( RadioRxPayload, size, RadioPktStatus.Params.LoRa.RssiPkt, RadioPktStatus.Params.LoRa.SnrPkt );
+                RadioEvents->RxDone( RadioRxBuffer, size, RadioPktStatus.Params.LoRa.RssiPkt, RadioPktStatus.Params.LoRa.SnrPkt );
                 SX126xBoardSetLedRx(false);
             }
         }
@@ -204,6 +204,11 @@ static RadioEvents_t *RadioEvents;
  */
 static uint8_t RxTxBuffer[RX_BUFFER_SIZE];
 
+/*!
+ * Buffer the received frames are read into
+ */
+static uint8_t *RxBuffer = RxTxBuffer;
+
 static LoRaBoardCallback_t *LoRaBoardCallbacks;
 
 /*
@@ -728,6 +733,82 @@ void SX1276SetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev,
     }
 }
 
+#if defined( LORA_FIXED_POINT_TIMING )
+/*
+ * Integer variant of the time on air computation below, giving the same
+ * results without double support.
+ */
+uint32_t SX1276GetTimeOnAir( RadioModems_t modem, uint8_t pktLen )
+{
+    uint32_t airTime = 0;
+
+    switch( modem )
+    {
+    case MODEM_FSK:
+        {
+            uint32_t nbBytes = SX1276.Settings.Fsk.PreambleLen +
+                               ( ( SX1276Read( REG_SYNCCONFIG ) & ~RF_SYNCCONFIG_SYNCSIZE_MASK ) + 1 ) +
+                               ( ( SX1276.Settings.Fsk.FixLen == 0x01 ) ? 0 : 1 ) +
+                               ( ( ( SX1276Read( REG_PACKETCONFIG1 ) & ~RF_PACKETCONFIG1_ADDRSFILTERING_MASK ) != 0x00 ) ? 1 : 0 ) +
+                               pktLen +
+                               ( ( SX1276.Settings.Fsk.CrcOn == 0x01 ) ? 2 : 0 );
+            uint32_t datarate = SX1276.Settings.Fsk.Datarate;
+
+            if( datarate != 0 )
+            {
+                // round( 8000 * nbBytes / datarate ) ms
+                airTime = ( 2 * 8000 * nbBytes + datarate ) / ( 2 * datarate );
+            }
+        }
+        break;
+    case MODEM_LORA:
+        {
+            uint32_t bwKhz = 0;
+            // REMARK: When using LoRa modem only bandwidths 125, 250 and 500 kHz are supported
+            switch( SX1276.Settings.LoRa.Bandwidth )
+            {
+            case 7: // 125 kHz
+                bwKhz = 125;
+                break;
+            case 8: // 250 kHz
+                bwKhz = 250;
+                break;
+            case 9: // 500 kHz
+                bwKhz = 500;
+                break;
+            }
+            if( bwKhz == 0 )
+            {
+                break;
+            }
+
+            int32_t sf = SX1276.Settings.LoRa.Datarate;
+            // Symbol length of payload
+            int32_t num = 8 * pktLen - 4 * sf + 28 + 16 * SX1276.Settings.LoRa.CrcOn -
+                          ( SX1276.Settings.LoRa.FixLen ? 20 : 0 );
+            int32_t den = 4 * ( sf - ( ( SX1276.Settings.LoRa.LowDatarateOptimize > 0 ) ? 2 : 0 ) );
+            int32_t nbPayloadSymbols = 8;
+            if( num > 0 )
+            {
+                nbPayloadSymbols += ( ( num + den - 1 ) / den ) * ( SX1276.Settings.LoRa.Coderate + 4 );
+            }
+            // Preamble and payload length in quarters of symbol
+            uint32_t nbQuarterSymbols = 4 * SX1276.Settings.LoRa.PreambleLen + 17 + 4 * nbPayloadSymbols;
+            // Time on air is nbQuarterSymbols * 2^SF / ( 4 * bw ) ms
+            uint32_t num2 = nbQuarterSymbols << sf;
+            uint32_t den2 = 4 * bwKhz;
+            // return ms secs, floor( tOnAir + 0.999 )
+            airTime = num2 / den2;
+            if( ( num2 % den2 ) * 1000 >= den2 )
+            {
+                airTime++;
+            }
+        }
+        break;
+    }
+    return airTime;
+}
+#else
 uint32_t SX1276GetTimeOnAir( RadioModems_t modem, uint8_t pktLen )
 {
     uint32_t airTime = 0;
@@ -806,6 +887,7 @@ uint32_t SX1276GetTimeOnAir( RadioModems_t modem, uint8_t pktLen )
     }
     return airTime;
 }
+#endif /* LORA_FIXED_POINT_TIMING */
 
 void SX1276Send( uint8_t *buffer, uint8_t size )
 {
@@ -1040,7 +1122,10 @@ void SX1276SetRx( uint32_t timeout )
         break;
     }
 
-    memset( RxTxBuffer, 0, ( size_t )RX_BUFFER_SIZE );
+    if( RxBuffer == RxTxBuffer )
+    {
+        memset( RxTxBuffer, 0, ( size_t )RX_BUFFER_SIZE );
+    }
 
     SX1276.Settings.State = RF_RX_RUNNING;
     if( timeout != 0 )
@@ -1392,6 +1477,11 @@ uint32_t SX1276GetWakeupTime( void )
     return ( uint32_t )LoRaBoardCallbacks->SX1276BoardGetWakeTime( ) + RADIO_WAKEUP_TIME;// BOARD_WAKEUP_TIME;
 }
 
+void SX1276SetRxBuffer( uint8_t *buffer )
+{
+    RxBuffer = ( buffer != NULL ) ? buffer : RxTxBuffer;
+}
+
 void SX1276OnTimeoutIrq( void* context )
 {
     switch( SX1276.Settings.State )
@@ -1527,12 +1617,12 @@ void SX1276OnDio0Irq( void* context )
                     {
                         SX1276.Settings.FskPacketHandler.Size = SX1276Read( REG_PAYLOADLENGTH );
                     }
-                    SX1276ReadFifo( RxTxBuffer + SX1276.Settings.FskPacketHandler.NbBytes, SX1276.Settings.FskPacketHandler.Size - SX1276.Settings.FskPacketHandler.NbBytes );
+                    SX1276ReadFifo( RxBuffer + SX1276.Settings.FskPacketHandler.NbBytes, SX1276.Settings.FskPacketHandler.Size - SX1276.Settings.FskPacketHandler.NbBytes );
                     SX1276.Settings.FskPacketHandler.NbBytes += ( SX1276.Settings.FskPacketHandler.Size - SX1276.Settings.FskPacketHandler.NbBytes );
                 }
                 else
                 {
-                    SX1276ReadFifo( RxTxBuffer + SX1276.Settings.FskPacketHandler.NbBytes, SX1276.Settings.FskPacketHandler.Size - SX1276.Settings.FskPacketHandler.NbBytes );
+                    SX1276ReadFifo( RxBuffer + SX1276.Settings.FskPacketHandler.NbBytes, SX1276.Settings.FskPacketHandler.Size - SX1276.Settings.FskPacketHandler.NbBytes );
                     SX1276.Settings.FskPacketHandler.NbBytes += ( SX1276.Settings.FskPacketHandler.Size - SX1276.Settings.FskPacketHandler.NbBytes );
                 }
 
@@ -1552,7 +1642,7 @@ void SX1276OnDio0Irq( void* context )
 
                 if( ( RadioEvents != NULL ) && ( RadioEvents->RxDone != NULL ) )
                 {
-                    RadioEvents->RxDone( RxTxBuffer, SX1276.Settings.FskPacketHandler.Size, SX1276.Settings.FskPacketHandler.RssiValue, 0 );
+                    RadioEvents->RxDone( RxBuffer, SX1276.Settings.FskPacketHandler.Size, SX1276.Settings.FskPacketHandler.RssiValue, 0 );
                 }
                 SX1276.Settings.FskPacketHandler.PreambleDetected = false;
                 SX1276.Settings.FskPacketHandler.SyncWordDetected = false;
@@ -1614,7 +1704,7 @@ void SX1276OnDio0Irq( void* context )
 
                     SX1276.Settings.LoRaPacketHandler.Size = SX1276Read( REG_LR_RXNBBYTES );
                     SX1276Write( REG_LR_FIFOADDRPTR, SX1276Read( REG_LR_FIFORXCURRENTADDR ) );
-                    SX1276ReadFifo( RxTxBuffer, SX1276.Settings.LoRaPacketHandler.Size );
+                    SX1276ReadFifo( RxBuffer, SX1276.Settings.LoRaPacketHandler.Size );
 
                     if( SX1276.Settings.LoRa.RxContinuous == false )
                     {
@@ -1624,7 +1714,7 @@ void SX1276OnDio0Irq( void* context )
 
                     if( ( RadioEvents != NULL ) && ( RadioEvents->RxDone != NULL ) )
                     {
-                        RadioEvents->RxDone( RxTxBuffer, SX1276.Settings.LoRaPacketHandler.Size, SX1276.Settings.LoRaPacketHandler.RssiValue, SX1276.Settings.LoRaPacketHandler.SnrValue );
+                        RadioEvents->RxDone( RxBuffer, SX1276.Settings.LoRaPacketHandler.Size, SX1276.Settings.LoRaPacketHandler.RssiValue, SX1276.Settings.LoRaPacketHandler.SnrValue );
                     }
                 }
                 break;
@@ -1690,12 +1780,12 @@ void SX1276OnDio1Irq( void* context )
                 //              when FifoLevel fires
                 if( ( SX1276.Settings.FskPacketHandler.Size - SX1276.Settings.FskPacketHandler.NbBytes ) >= SX1276.Settings.FskPacketHandler.FifoThresh )
                 {
-                    SX1276ReadFifo( ( RxTxBuffer + SX1276.Settings.FskPacketHandler.NbBytes ), SX1276.Settings.FskPacketHandler.FifoThresh - 1 );
+                    SX1276ReadFifo( ( RxBuffer + SX1276.Settings.FskPacketHandler.NbBytes ), SX1276.Settings.FskPacketHandler.FifoThresh - 1 );
                     SX1276.Settings.FskPacketHandler.NbBytes += SX1276.Settings.FskPacketHandler.FifoThresh - 1;
                 }
                 else
                 {
-                    SX1276ReadFifo( ( RxTxBuffer + SX1276.Settings.FskPacketHandler.NbBytes ), SX1276.Settings.FskPacketHandler.Size - SX1276.Settings.FskPacketHandler.NbBytes );
+                    SX1276ReadFifo( ( RxBuffer + SX1276.Settings.FskPacketHandler.NbBytes ), SX1276.Settings.FskPacketHandler.Size - SX1276.Settings.FskPacketHandler.NbBytes );
                     SX1276.Settings.FskPacketHandler.NbBytes += ( SX1276.Settings.FskPacketHandler.Size - SX1276.Settings.FskPacketHandler.NbBytes );
                 }
                 break;
@@ -541,4 +541,14 @@ void SX1276SetPublicNetwork( bool enable );
  */
 uint32_t SX1276GetWakeupTime( void );
 
+/*!
+ * \brief Sets the buffer the next received frames are read into
+ *
+ * \remark The transmitted frames keep using the internal buffer.
+ *
+ * \param [IN] buffer Buffer of at least 255 bytes,
+ *                    NULL to use the internal buffer
+ */
+void SX1276SetRxBuffer( uint8_t *buffer );
+
 #endif /* __SX1276_H__ */
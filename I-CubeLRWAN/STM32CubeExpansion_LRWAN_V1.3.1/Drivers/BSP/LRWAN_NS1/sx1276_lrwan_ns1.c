@@ -109,7 +109,12 @@ const struct Radio_s Radio =
   SX1276ReadBuffer,
   SX1276SetMaxPayloadLength,
   SX1276SetPublicNetwork,
-  SX1276GetRadioWakeUpTime
+  SX1276GetRadioWakeUpTime,
+  NULL,
+  // Available on SX126x only
+  NULL,
+  NULL,
+  SX1276SetRxBuffer
 };
 
 uint32_t SX1276GetWakeTime(void)
@@ -110,7 +110,12 @@ const struct Radio_s Radio =
     SX1272ReadBuffer,
     SX1272SetMaxPayloadLength,
     SX1272SetPublicNetwork,
-    SX1272GetWakeupTime
+    SX1272GetWakeupTime,
+    NULL,
+    // Available on SX126x only
+    NULL,
+    NULL,
+    SX1272SetRxBuffer
 };
 
 uint32_t SX1272GetWakeTime( void )
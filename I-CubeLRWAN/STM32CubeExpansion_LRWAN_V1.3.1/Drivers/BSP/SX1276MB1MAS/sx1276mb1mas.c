@@ -116,7 +116,12 @@ const struct Radio_s Radio =
     SX1276ReadBuffer,
     SX1276SetMaxPayloadLength,
     SX1276SetPublicNetwork,
-    SX1276GetWakeupTime
+    SX1276GetWakeupTime,
+    NULL,
+    // Available on SX126x only
+    NULL,
+    NULL,
+    SX1276SetRxBuffer
 };
 
 uint32_t SX1276GetWakeTime( void )
@@ -179,6 +179,13 @@ def do_header_lib(args):
     magic = args.magic.encode()
     version = args.version
     reserved = b'\0'*args.reserved
+    if args.delta:
+        with open(args.delta, 'rb') as f:
+            descriptor = f.read()
+        if len(descriptor) > args.reserved:
+            print("reserved field too small for the delta descriptor")
+            exit(1)
+        reserved = descriptor + reserved[len(descriptor):]
     if args.nonce and args.iv:
         print("either IV or Nonce Required !!!")
         exit(1)
@@ -484,6 +491,109 @@ def do_diff(args):
     with open(args.poffset, 'w') as f:
         f.write(str(first_diff*args.align))
 
+def delta_varint(value):
+    out = bytearray()
+    while True:
+        byte = value & 0x7f
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return out
+
+def delta_command(copy, length):
+    # bit 7: COPY (1) or INSERT (0), bits 6..0: length, 0 if it follows as a varint
+    cmd = 0x80 if copy else 0x00
+    if length < 0x80:
+        return bytearray([cmd | length])
+    return bytearray([cmd]) + delta_varint(length)
+
+def delta_match(old, new, src, dst):
+    length = 0
+    while src + length < len(old) and dst + length < len(new) and old[src + length] == new[dst + length]:
+        length += 1
+    return length
+
+def delta_encode(old, new, offset):
+    # Greedy COPY/INSERT encoding of new[offset:] against old.
+    # The source cursor follows the output: it moves forward with COPY and INSERT alike,
+    # so a substituted constant costs an INSERT and a COPY without displacement.
+    gram = 8
+    index = {}
+    for pos in range(0, len(old) - gram + 1):
+        slots = index.setdefault(old[pos:pos + gram], [])
+        if len(slots) < 64:
+            slots.append(pos)
+    patch = bytearray()
+    literal = bytearray()
+    src = offset
+    dst = offset
+    while dst < len(new):
+        best_len = 0
+        best_src = 0
+        if 0 <= src < len(old):
+            best_len = delta_match(old, new, src, dst)
+            best_src = src
+        if best_len < gram:
+            for cand in index.get(new[dst:dst + gram], []):
+                length = delta_match(old, new, cand, dst)
+                if length > best_len or (length == best_len and abs(cand - src) < abs(best_src - src)):
+                    best_len = length
+                    best_src = cand
+        # A COPY at the cursor costs 2 bytes, elsewhere it also carries a displacement
+        if best_len >= (4 if best_src == src else gram):
+            if literal:
+                patch += delta_command(False, len(literal)) + literal
+                literal = bytearray()
+            # Source displacement from the cursor, zigzag encoded
+            disp = best_src - src
+            patch += delta_command(True, best_len) + delta_varint(disp << 1 if disp >= 0 else ((-disp) << 1) - 1)
+            src = best_src + best_len
+            dst += best_len
+        else:
+            literal.append(new[dst])
+            src += 1
+            dst += 1
+    if literal:
+        patch += delta_command(False, len(literal)) + literal
+    return patch
+
+def do_delta(args):
+    # Check args
+    if args.align == 0:
+        msg = "Wrong alignment value, must be greater than 0"
+        raise argparse.ArgumentTypeError(msg)
+    with open(args.file1, 'rb') as f:
+        old = f.read()
+    with open(args.file2, 'rb') as f:
+        new = f.read()
+    with open(args.stag, 'rb') as f:
+        stag = f.read()
+    if len(stag) < 16:
+        msg = "Wrong source tag file ({}), must contain the FW tag of the primary binary file".format(args.stag)
+        raise argparse.ArgumentTypeError(msg)
+    # The patch rebuilds the secondary file from its first difference up to its end
+    first_diff = 0
+    while first_diff < min(len(old), len(new)) and old[first_diff] == new[first_diff]:
+        first_diff += 1
+    if first_diff == len(new):
+        sys.stderr.write("Secondary file is identical to the beginning of the primary file")
+        exit(1)
+    offset = first_diff - first_diff % args.align
+    patch = delta_encode(old, new, offset)
+    # Padding is ignored by the patch applier, it stops when the target range is rebuilt
+    if len(patch) % args.align > 0:
+        patch += b'\0'*(args.align - len(patch) % args.align)
+    print("delta: {} bytes rebuilt from offset {} with a {} bytes patch".format(len(new) - offset, offset, len(patch)))
+    with open(args.outfile, 'wb') as f:
+        f.write(patch)
+    with open(args.poffset, 'w') as f:
+        f.write(str(offset))
+    # Delta descriptor, stored at the beginning of the reserved field of the FW header
+    with open(args.descriptor, 'wb') as f:
+        f.write(pack('<4sI16s', b'SFUD', len(new) - offset, stag[:16]))
+
 def do_inject(args):
     key = keys.load(args.key)
     np_key = numpy.frombuffer(key.get_key(args.type), numpy.uint8)
@@ -594,6 +704,8 @@ subcmds = {
         'pack':do_pack,
         #
         'diff':do_diff,
+        #
+        'delta':do_delta,
         #merge appli.elf , header binary and sbsfu elf in a big binary
         #input file appli.elf
         #-h header file
@@ -666,6 +778,7 @@ def args():
     head.add_argument('--pfw', help ='partial firmware', metavar='filename', required = ('--poffset' in sys.argv) or ('--ptag' in sys.argv))
     head.add_argument('--poffset', help ='file that contains offset at which the partial firmware should be applied', type=str, metavar='filename', required = ('--pfw' in sys.argv) or ('--ptag' in sys.argv))
     head.add_argument('--ptag', metavar='filename', required = ('--pfw' in sys.argv) or ('--poffset' in sys.argv))
+    head.add_argument('--delta', help ='delta descriptor, when the partial firmware is a patch', metavar='filename', required = False)
     head.add_argument("outfile")
     pack = subs.add_parser('pack', help='build header file and compute mac according to key provided')
     pack.add_argument('-k', '--key', metavar='filename', required = True)
@@ -684,6 +797,7 @@ def args():
     pack.add_argument('--pfw', help ='partial firmware', metavar='filename', required = ('--poffset' in sys.argv) or ('--ptag' in sys.argv))
     pack.add_argument('--poffset', help ='file that contains offset at which the partial firmware should be applied', type=str, metavar='filename', required = ('--pfw' in sys.argv) or ('--ptag' in sys.argv))
     pack.add_argument('--ptag', metavar='filename', required = ('--pfw' in sys.argv) or ('--poffset' in sys.argv))
+    pack.add_argument('--delta', help ='delta descriptor, when the partial firmware is a patch', metavar='filename', required = False)
     pack.add_argument("outfile")
     
     diff = subs.add_parser('diff', help='compute differences between 2 binary files')
@@ -694,6 +808,15 @@ def args():
     diff.add_argument('-e', '--end',   type=auto_int, metavar='filename', default='0x0', required=False, help="offset at which ending comparison - in bytes. use 0 to specify end of given binary files (default: 0)")
     diff.add_argument('-a', '--align', type=int, metavar='align', default=2, required=False, help="difference binary file alignment in bytes (default: 2)")
     diff.add_argument("outfile")
+
+    delta = subs.add_parser('delta', help='compute a patch rebuilding a binary file from another one')
+    delta.add_argument('-1', '--file1', type=str, metavar='filename', required=True, help="binary file of the active firmware")
+    delta.add_argument('-2', '--file2', type=str, metavar='filename', required=True, help="binary file of the new firmware")
+    delta.add_argument('-s', '--stag', type=str, metavar='filename', required=True, help="FW tag of the active firmware")
+    delta.add_argument('-p', '--poffset', type=str, metavar='filename', required=True, help="file that will contain offset from which the patch rebuilds the new firmware")
+    delta.add_argument('-d', '--descriptor', type=str, metavar='filename', required=True, help="file that will contain the delta descriptor for the FW header")
+    delta.add_argument('-a', '--align', type=int, metavar='align', default=16, required=False, help="patch offset and size alignment in bytes (default: 16)")
+    delta.add_argument("outfile")
     
     mrg = subs.add_parser('merge', help='merge elf appli , install header and sbsfu.elf in a contiguous binary')
     mrg.add_argument('-i', '--install', metavar='filename',  help="filename of installed binary header", required = True)
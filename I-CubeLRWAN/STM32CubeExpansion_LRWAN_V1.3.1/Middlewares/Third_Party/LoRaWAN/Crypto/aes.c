@@ -64,6 +64,31 @@
 
 #include "aes.h"
 
+/* the byte oriented rounds are needed by the byte backend and 'on the fly' keying */
+#if ( AES_BACKEND == AES_BACKEND_BYTE ) || defined( AES_ENC_128_OTFK ) || defined( AES_ENC_256_OTFK )
+#  define AES_BYTE_ENC_ROUNDS
+#endif
+
+#if defined( AES_BYTE_ENC_ROUNDS ) || defined( AES_DEC_PREKEYED ) || defined( AES_DEC_128_OTFK ) || defined( AES_DEC_256_OTFK )
+#  define AES_BYTE_ROUND_KEYS
+#endif
+
+/* the bitsliced backend has no S-box lookup */
+#if ( AES_BACKEND != AES_BACKEND_BITSLICE ) || defined( AES_BYTE_ENC_ROUNDS ) || defined( AES_DEC_128_OTFK ) || defined( AES_DEC_256_OTFK )
+#  define AES_SBOX_LOOKUP
+#endif
+
+#if ( AES_BACKEND == AES_BACKEND_TTABLE ) && !defined( USE_TABLES )
+#  error "AES_BACKEND_TTABLE needs USE_TABLES"
+#endif
+
+#if ( AES_BACKEND == AES_BACKEND_AESNI )
+#  if !defined( __AES__ )
+#    error "AES_BACKEND_AESNI needs a compiler targeting AES-NI (e.g. gcc -maes)"
+#  endif
+#  include <wmmintrin.h>
+#endif
+
 //#if defined( HAVE_UINT_32T )
 //  typedef unsigned long uint32_t;
 //#endif
@@ -191,14 +216,18 @@
     w(0xf0), w(0xf1), w(0xf2), w(0xf3), w(0xf4), w(0xf5), w(0xf6), w(0xf7),\
     w(0xf8), w(0xf9), w(0xfa), w(0xfb), w(0xfc), w(0xfd), w(0xfe), w(0xff) }
 
+#if defined( AES_SBOX_LOOKUP )
 static const uint8_t sbox[256]  =  sb_data(f1);
+#endif
 
 #if defined( AES_DEC_PREKEYED )
 static const uint8_t isbox[256] = isb_data(f1);
 #endif
 
+#if defined( AES_BYTE_ENC_ROUNDS )
 static const uint8_t gfm2_sbox[256] = sb_data(f2);
 static const uint8_t gfm3_sbox[256] = sb_data(f3);
+#endif
 
 #if defined( AES_DEC_PREKEYED )
 static const uint8_t gfmul_9[256] = mm_data(f9);
@@ -373,6 +402,8 @@ static void xor_block( void *d, const void *s )
 #endif
 }
 
+#if defined( AES_BYTE_ROUND_KEYS )
+
 static void copy_and_key( void *d, const void *s, const void *k )
 {
 #if defined( HAVE_UINT_32T )
@@ -408,6 +439,10 @@ static void add_round_key( uint8_t d[N_BLOCK], const uint8_t k[N_BLOCK] )
     xor_block(d, k);
 }
 
+#endif
+
+#if defined( AES_BYTE_ENC_ROUNDS )
+
 static void shift_sub_rows( uint8_t st[N_BLOCK] )
 {   uint8_t tt;
 
@@ -424,6 +459,8 @@ static void shift_sub_rows( uint8_t st[N_BLOCK] )
     st[ 7] = s_box(st[ 3]); st[ 3] = s_box( tt );
 }
 
+#endif
+
 #if defined( AES_DEC_PREKEYED )
 
 static void inv_shift_sub_rows( uint8_t st[N_BLOCK] )
@@ -444,6 +481,8 @@ static void inv_shift_sub_rows( uint8_t st[N_BLOCK] )
 
 #endif
 
+#if defined( AES_BYTE_ENC_ROUNDS )
+
 #if defined( VERSION_1 )
   static void mix_sub_columns( uint8_t dt[N_BLOCK] )
   { uint8_t st[N_BLOCK];
@@ -473,6 +512,8 @@ static void inv_shift_sub_rows( uint8_t st[N_BLOCK] )
     dt[15] = gfm3_sb(st[12]) ^ s_box(st[1]) ^ s_box(st[6]) ^ gfm2_sb(st[11]);
   }
 
+#endif
+
 #if defined( AES_DEC_PREKEYED )
 
 #if defined( VERSION_1 )
@@ -506,6 +547,165 @@ static void inv_shift_sub_rows( uint8_t st[N_BLOCK] )
 
 #endif
 
+#if ( AES_BACKEND == AES_BACKEND_BITSLICE )
+
+/*  Bitsliced state: bit i of plane q[b] is bit b of the state byte i, so
+    that each operation processes the same bit of the 16 bytes at once and
+    no table is indexed by key or data.
+*/
+
+static void bs_pack( uint16_t q[8], const uint8_t *s, uint8_t n )
+{   uint8_t i, b;
+
+    for( b = 0; b < 8; ++b )
+        q[b] = 0;
+    for( i = 0; i < n; ++i )
+        for( b = 0; b < 8; ++b )
+            q[b] |= (uint16_t)(((s[i] >> b) & 1) << i);
+}
+
+static void bs_unpack( uint8_t *d, const uint16_t q[8], uint8_t n )
+{   uint8_t i, b;
+
+    for( i = 0; i < n; ++i )
+    {
+        d[i] = 0;
+        for( b = 0; b < 8; ++b )
+            d[i] |= (uint8_t)(((q[b] >> i) & 1) << b);
+    }
+}
+
+/*  S-box circuit of Boyar and Peralta (113 gates) */
+
+static void bs_sub_bytes( uint16_t q[8] )
+{
+    uint16_t x0, x1, x2, x3, x4, x5, x6, x7;
+    uint16_t y1, y2, y3, y4, y5, y6, y7, y8, y9;
+    uint16_t y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+    uint16_t y20, y21;
+    uint16_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+    uint16_t z10, z11, z12, z13, z14, z15, z16, z17;
+    uint16_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+    uint16_t t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+    uint16_t t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+    uint16_t t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+    uint16_t t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+    uint16_t t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+    uint16_t t60, t61, t62, t63, t64, t65, t66, t67;
+    uint16_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+    x0 = q[7]; x1 = q[6]; x2 = q[5]; x3 = q[4];
+    x4 = q[3]; x5 = q[2]; x6 = q[1]; x7 = q[0];
+
+    /* top linear transformation */
+    y14 = x3 ^ x5;  y13 = x0 ^ x6;  y9 = x0 ^ x3;   y8 = x0 ^ x5;
+    t0 = x1 ^ x2;   y1 = t0 ^ x7;   y4 = y1 ^ x3;   y12 = y13 ^ y14;
+    y2 = y1 ^ x0;   y5 = y1 ^ x6;   y3 = y5 ^ y8;   t1 = x4 ^ y12;
+    y15 = t1 ^ x5;  y20 = t1 ^ x1;  y6 = y15 ^ x7;  y10 = y15 ^ t0;
+    y11 = y20 ^ y9; y7 = x7 ^ y11;  y17 = y10 ^ y11; y19 = y10 ^ y8;
+    y16 = t0 ^ y11; y21 = y13 ^ y16; y18 = x0 ^ y16;
+
+    /* non-linear section */
+    t2 = y12 & y15; t3 = y3 & y6;   t4 = t3 ^ t2;   t5 = y4 & x7;
+    t6 = t5 ^ t2;   t7 = y13 & y16; t8 = y5 & y1;   t9 = t8 ^ t7;
+    t10 = y2 & y7;  t11 = t10 ^ t7; t12 = y9 & y11; t13 = y14 & y17;
+    t14 = t13 ^ t12; t15 = y8 & y10; t16 = t15 ^ t12; t17 = t4 ^ t14;
+    t18 = t6 ^ t16; t19 = t9 ^ t14; t20 = t11 ^ t16; t21 = t17 ^ y20;
+    t22 = t18 ^ y19; t23 = t19 ^ y21; t24 = t20 ^ y18; t25 = t21 ^ t22;
+    t26 = t21 & t23; t27 = t24 ^ t26; t28 = t25 & t27; t29 = t28 ^ t22;
+    t30 = t23 ^ t24; t31 = t22 ^ t26; t32 = t31 & t30; t33 = t32 ^ t24;
+    t34 = t23 ^ t33; t35 = t27 ^ t33; t36 = t24 & t35; t37 = t36 ^ t34;
+    t38 = t27 ^ t36; t39 = t29 & t38; t40 = t25 ^ t39; t41 = t40 ^ t37;
+    t42 = t29 ^ t33; t43 = t29 ^ t40; t44 = t33 ^ t37; t45 = t42 ^ t41;
+    z0 = t44 & y15; z1 = t37 & y6;  z2 = t33 & x7;  z3 = t43 & y16;
+    z4 = t40 & y1;  z5 = t29 & y7;  z6 = t42 & y11; z7 = t45 & y17;
+    z8 = t41 & y10; z9 = t44 & y12; z10 = t37 & y3; z11 = t33 & y4;
+    z12 = t43 & y13; z13 = t40 & y5; z14 = t29 & y2; z15 = t42 & y9;
+    z16 = t45 & y14; z17 = t41 & y8;
+
+    /* bottom linear transformation */
+    t46 = z15 ^ z16; t47 = z10 ^ z11; t48 = z5 ^ z13; t49 = z9 ^ z10;
+    t50 = z2 ^ z12; t51 = z2 ^ z5;  t52 = z7 ^ z8;  t53 = z0 ^ z3;
+    t54 = z6 ^ z7;  t55 = z16 ^ z17; t56 = z12 ^ t48; t57 = t50 ^ t53;
+    t58 = z4 ^ t46; t59 = z3 ^ t54; t60 = t46 ^ t57; t61 = z14 ^ t57;
+    t62 = t52 ^ t58; t63 = t49 ^ t58; t64 = z4 ^ t59; t65 = t61 ^ t62;
+    t66 = z1 ^ t63; s0 = t59 ^ t63; s6 = t56 ^ ~t62; s7 = t48 ^ ~t60;
+    t67 = t64 ^ t65; s3 = t53 ^ t66; s4 = t51 ^ t66; s5 = t47 ^ t65;
+    s1 = t64 ^ ~s3; s2 = t55 ^ ~t67;
+
+    q[7] = s0; q[6] = s1; q[5] = s2; q[4] = s3;
+    q[3] = s4; q[2] = s5; q[1] = s6; q[0] = s7;
+}
+
+/*  Byte i of the state is row i % 4 of column i / 4: the rows are the
+    bits 0x1111 << row of a plane and the columns its nibbles.
+*/
+
+#define bs_rotr16(x, n) ((uint16_t)(((x) >> (n)) | ((x) << (16 - (n)))))
+
+static void bs_shift_rows( uint16_t q[8] )
+{   uint8_t b;
+
+    for( b = 0; b < 8; ++b )
+    {   uint16_t x = q[b];
+        q[b] = (x & 0x1111) | (bs_rotr16(x, 4) & 0x2222)
+             | (bs_rotr16(x, 8) & 0x4444) | (bs_rotr16(x, 12) & 0x8888);
+    }
+}
+
+/* rotate the rows of each column by 1, 2 and 3 */
+#define bs_row1(x)  ((uint16_t)((((x) >> 1) & 0x7777) | (((x) << 3) & 0x8888)))
+#define bs_row2(x)  ((uint16_t)((((x) >> 2) & 0x3333) | (((x) << 2) & 0xcccc)))
+#define bs_row3(x)  ((uint16_t)((((x) >> 3) & 0x1111) | (((x) << 1) & 0xeeee)))
+
+static void bs_mix_columns( uint16_t q[8] )
+{   uint16_t u[8], v[8];
+    uint8_t b;
+
+    /* dt[r] = 2 * (st[r] ^ st[r + 1]) ^ st[r + 1] ^ st[r + 2] ^ st[r + 3] */
+    for( b = 0; b < 8; ++b )
+    {   uint16_t r1 = bs_row1(q[b]);
+        u[b] = q[b] ^ r1;
+        v[b] = r1 ^ bs_row2(q[b]) ^ bs_row3(q[b]);
+    }
+    q[0] = u[7] ^ v[0];
+    q[1] = u[0] ^ u[7] ^ v[1];
+    q[2] = u[1] ^ v[2];
+    q[3] = u[2] ^ u[7] ^ v[3];
+    q[4] = u[3] ^ u[7] ^ v[4];
+    q[5] = u[4] ^ v[5];
+    q[6] = u[5] ^ v[6];
+    q[7] = u[6] ^ v[7];
+}
+
+static void bs_add_round_key( uint16_t q[8], const uint8_t k[N_BLOCK] )
+{   uint16_t kq[8];
+    uint8_t b;
+
+    bs_pack( kq, k, N_BLOCK );
+    for( b = 0; b < 8; ++b )
+        q[b] ^= kq[b];
+}
+
+/* the key schedule substitutions are constant time as well */
+
+static uint8_t bs_s_box( uint8_t x )
+{   uint16_t q[8];
+
+    bs_pack( q, &x, 1 );
+    bs_sub_bytes( q );
+    bs_unpack( &x, q, 1 );
+    return x;
+}
+
+#define key_s_box(x)    bs_s_box(x)
+
+#else
+
+#define key_s_box(x)    s_box(x)
+
+#endif
+
 #if defined( AES_ENC_PREKEYED ) || defined( AES_DEC_PREKEYED )
 
 /*  Set the cipher key for the pre-keyed version */
@@ -537,18 +737,18 @@ return_type aes_set_key( const uint8_t key[], length_type keylen, aes_context ct
         if( cc % keylen == 0 )
         {
             tt = t0;
-            t0 = s_box(t1) ^ rc;
-            t1 = s_box(t2);
-            t2 = s_box(t3);
-            t3 = s_box(tt);
+            t0 = key_s_box(t1) ^ rc;
+            t1 = key_s_box(t2);
+            t2 = key_s_box(t3);
+            t3 = key_s_box(tt);
             rc = f2(rc);
         }
         else if( keylen > 24 && cc % keylen == 16 )
         {
-            t0 = s_box(t0);
-            t1 = s_box(t1);
-            t2 = s_box(t2);
-            t3 = s_box(t3);
+            t0 = key_s_box(t0);
+            t1 = key_s_box(t1);
+            t2 = key_s_box(t2);
+            t3 = key_s_box(t3);
         }
         tt = cc - keylen;
         ctx->ksch[cc + 0] = ctx->ksch[tt + 0] ^ t0;
@@ -565,6 +765,127 @@ return_type aes_set_key( const uint8_t key[], length_type keylen, aes_context ct
 
 /*  Encrypt a single block of 16 bytes */
 
+#if ( AES_BACKEND == AES_BACKEND_TTABLE )
+
+/*  The state columns are held in 32-bit words, row 0 in the low byte.
+    te_tab[x] is the column of MixColumns applied to S(x) in row 0, the
+    other rows are obtained by rotating it.
+*/
+
+#define te_word(x)  ( (uint32_t)f2(x) | ((uint32_t)(x) << 8) \
+                    | ((uint32_t)(x) << 16) | ((uint32_t)f3(x) << 24) )
+
+static const uint32_t te_tab[256] = sb_data(te_word);
+
+#define rotl32(x, n)    (((x) << (n)) | ((x) >> (32 - (n))))
+
+/* byte accesses, the key schedule and the blocks may be unaligned */
+#define load_le32(p)    ( (uint32_t)(p)[0] | ((uint32_t)(p)[1] << 8) \
+                        | ((uint32_t)(p)[2] << 16) | ((uint32_t)(p)[3] << 24) )
+
+static void store_le32( uint8_t *p, uint32_t v )
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+#define te_round(a, b, c, d, k) ( te_tab[(a) & 0xff] \
+                                ^ rotl32(te_tab[((b) >> 8) & 0xff], 8) \
+                                ^ rotl32(te_tab[((c) >> 16) & 0xff], 16) \
+                                ^ rotl32(te_tab[(d) >> 24], 24) ^ load_le32(k) )
+
+#define te_last(a, b, c, d, k)  ( ( (uint32_t)s_box((a) & 0xff) \
+                                  | ((uint32_t)s_box(((b) >> 8) & 0xff) << 8) \
+                                  | ((uint32_t)s_box(((c) >> 16) & 0xff) << 16) \
+                                  | ((uint32_t)s_box((d) >> 24) << 24) ) ^ load_le32(k) )
+
+return_type aes_encrypt( const uint8_t in[N_BLOCK], uint8_t  out[N_BLOCK], const aes_context ctx[1] )
+{
+    if( ctx->rnd )
+    {
+        const uint8_t *k = ctx->ksch;
+        uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+        uint8_t r;
+
+        s0 = load_le32(in) ^ load_le32(k);
+        s1 = load_le32(in + 4) ^ load_le32(k + 4);
+        s2 = load_le32(in + 8) ^ load_le32(k + 8);
+        s3 = load_le32(in + 12) ^ load_le32(k + 12);
+
+        for( r = 1 ; r < ctx->rnd ; ++r )
+        {
+            k += N_BLOCK;
+            t0 = te_round(s0, s1, s2, s3, k);
+            t1 = te_round(s1, s2, s3, s0, k + 4);
+            t2 = te_round(s2, s3, s0, s1, k + 8);
+            t3 = te_round(s3, s0, s1, s2, k + 12);
+            s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+        }
+        k += N_BLOCK;
+        store_le32(out, te_last(s0, s1, s2, s3, k));
+        store_le32(out + 4, te_last(s1, s2, s3, s0, k + 4));
+        store_le32(out + 8, te_last(s2, s3, s0, s1, k + 8));
+        store_le32(out + 12, te_last(s3, s0, s1, s2, k + 12));
+    }
+    else
+        return ( uint8_t )-1;
+    return 0;
+}
+
+#elif ( AES_BACKEND == AES_BACKEND_BITSLICE )
+
+return_type aes_encrypt( const uint8_t in[N_BLOCK], uint8_t  out[N_BLOCK], const aes_context ctx[1] )
+{
+    if( ctx->rnd )
+    {
+        uint16_t q[8];
+        uint8_t r;
+
+        bs_pack( q, in, N_BLOCK );
+        bs_add_round_key( q, ctx->ksch );
+
+        for( r = 1 ; r < ctx->rnd ; ++r )
+        {
+            bs_sub_bytes( q );
+            bs_shift_rows( q );
+            bs_mix_columns( q );
+            bs_add_round_key( q, ctx->ksch + r * N_BLOCK );
+        }
+        bs_sub_bytes( q );
+        bs_shift_rows( q );
+        bs_add_round_key( q, ctx->ksch + r * N_BLOCK );
+        bs_unpack( out, q, N_BLOCK );
+    }
+    else
+        return ( uint8_t )-1;
+    return 0;
+}
+
+#elif ( AES_BACKEND == AES_BACKEND_AESNI )
+
+return_type aes_encrypt( const uint8_t in[N_BLOCK], uint8_t  out[N_BLOCK], const aes_context ctx[1] )
+{
+    if( ctx->rnd )
+    {
+        __m128i s;
+        uint8_t r;
+
+        s = _mm_xor_si128( _mm_loadu_si128( (const __m128i *)in ),
+                           _mm_loadu_si128( (const __m128i *)ctx->ksch ) );
+        for( r = 1 ; r < ctx->rnd ; ++r )
+            s = _mm_aesenc_si128( s, _mm_loadu_si128( (const __m128i *)( ctx->ksch + r * N_BLOCK ) ) );
+        s = _mm_aesenclast_si128( s, _mm_loadu_si128( (const __m128i *)( ctx->ksch + r * N_BLOCK ) ) );
+        _mm_storeu_si128( (__m128i *)out, s );
+    }
+    else
+        return ( uint8_t )-1;
+    return 0;
+}
+
+#else
+
 return_type aes_encrypt( const uint8_t in[N_BLOCK], uint8_t  out[N_BLOCK], const aes_context ctx[1] )
 {
     if( ctx->rnd )
@@ -592,6 +913,8 @@ return_type aes_encrypt( const uint8_t in[N_BLOCK], uint8_t  out[N_BLOCK], const
     return 0;
 }
 
+#endif
+
 /* CBC encrypt a number of blocks (input and return an IV) */
 
 return_type aes_cbc_encrypt( const uint8_t *in, uint8_t *out,
@@ -52,6 +52,27 @@
 #  define AES_DEC_256_OTFK  /* AES decryption with 'on the fly' 256 bit keying */
 #endif
 
+/*  Implementation of the pre-keyed encryption (aes_encrypt), selected at
+    build time by defining AES_BACKEND to one of:
+
+    AES_BACKEND_BYTE      byte oriented tables (768 bytes), suits Cortex-M0+
+    AES_BACKEND_TTABLE    32-bit T-table (1 Kbyte), faster on Cortex-M3/M4
+    AES_BACKEND_BITSLICE  bitsliced, no key or data dependent table lookups
+                          nor branches (constant time), slower
+    AES_BACKEND_AESNI     x86 AES-NI instructions, host builds only (-maes)
+
+    All backends share the aes_context layout and key schedule, so the
+    selection is transparent to the callers.
+*/
+#define AES_BACKEND_BYTE        0
+#define AES_BACKEND_TTABLE      1
+#define AES_BACKEND_BITSLICE    2
+#define AES_BACKEND_AESNI       3
+
+#if !defined( AES_BACKEND )
+#  define AES_BACKEND           AES_BACKEND_BYTE
+#endif
+
 #define N_ROW                   4
 #define N_COL                   4
 #define N_BLOCK   (N_ROW * N_COL)
@@ -43,6 +43,7 @@ DEALINGS WITH THE SOFTWARE
  
 typedef struct _AES_CMAC_CTX {
             aes_context    rijndael;
+            const aes_context *ksch;    /* key schedule in use */
             uint8_t        X[16];
             uint8_t        M_last[16];
             uint32_t       M_n;
@@ -53,6 +54,8 @@ typedef struct _AES_CMAC_CTX {
 //__BEGIN_DECLS
 void     AES_CMAC_Init(AES_CMAC_CTX * ctx);
 void     AES_CMAC_SetKey(AES_CMAC_CTX * ctx, const uint8_t key[AES_CMAC_KEY_LENGTH]);
+/* uses an already expanded key, which must stay valid until AES_CMAC_Final */
+void     AES_CMAC_SetKeySchedule(AES_CMAC_CTX * ctx, const aes_context * ksch);
 void     AES_CMAC_Update(AES_CMAC_CTX * ctx, const uint8_t * data, uint32_t len);
           //          __attribute__((__bounded__(__string__,2,3)));
 void     AES_CMAC_Final(uint8_t digest[AES_CMAC_DIGEST_LENGTH], AES_CMAC_CTX  * ctx);
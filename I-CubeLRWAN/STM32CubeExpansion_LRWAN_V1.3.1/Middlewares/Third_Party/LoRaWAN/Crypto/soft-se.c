@@ -22,16 +22,27 @@ Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ),
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "LoRaMacCrypto.h"
 #include "utilities.h"
 #include "aes.h"
 #include "cmac.h"
 #include "radio.h"
+#include "LoRaMacInstance.h"
 
 #define NUM_OF_KEYS      24
 #define KEY_SIZE         16
 
+/*!
+ * Number of expanded AES key schedules kept in RAM. A frame uses up to four
+ * keys (payload, FOpts and MIC keys), their schedules are computed once and
+ * reused by the next frames.
+ */
+#ifndef SE_KEY_SCHEDULE_CACHE_SIZE
+#define SE_KEY_SCHEDULE_CACHE_SIZE                  4
+#endif
+
 /*!
  * Identifier value pair type for Keys
  */
@@ -60,10 +71,6 @@ typedef struct sSecureElementNvCtx
      * Join EUI storage
      */
     uint8_t JoinEui[SE_EUI_SIZE];
-    /*
-     * AES computation context variable
-     */
-    aes_context AesContext;
     /*
      * CMAC computation context variable
      */
@@ -74,11 +81,65 @@ typedef struct sSecureElementNvCtx
     Key_t KeyList[NUM_OF_KEYS];
 }SecureElementNvCtx_t;
 
+/*
+ * Expanded AES key schedule of a key
+ */
+typedef struct sKeySchedule
+{
+    /*
+     * Key identifier, valid if LastUse is not 0
+     */
+    KeyIdentifier_t KeyID;
+    /*
+     * Value of KeySchedulesUse when the schedule was last used
+     */
+    uint32_t LastUse;
+    /*
+     * Expanded key
+     */
+    aes_context AesContext;
+}KeySchedule_t;
+
+/*
+ * Cache of the expanded key schedules, least recently used replacement
+ */
+typedef struct sKeyScheduleCache
+{
+    /*
+     * Use counter of the schedules
+     */
+    uint32_t KeySchedulesUse;
+    /*
+     * Expanded key schedules
+     */
+    KeySchedule_t KeySchedules[SE_KEY_SCHEDULE_CACHE_SIZE];
+}KeyScheduleCache_t;
+
+#if defined( LORAMAC_MULTI_INSTANCE )
+/*
+ * Per-instance context of the module
+ */
+typedef struct sSecureElementInstanceCtx
+{
+    SecureElementNvCtx_t SeNvmCtx;
+    KeyScheduleCache_t KeyScheduleCache;
+}SecureElementInstanceCtx_t;
+
+#define SE_INSTANCE_CTX                             ( ( SecureElementInstanceCtx_t* )LORAMAC_INSTANCE_MODULE_CTX( LORAMAC_INSTANCE_MODULE_SECURE_ELEMENT ) )
+#define SeNvmCtx                                    ( SE_INSTANCE_CTX->SeNvmCtx )
+#define KeyScheduleCache                            ( SE_INSTANCE_CTX->KeyScheduleCache )
+#else
 /*
  * Module context
  */
 static SecureElementNvCtx_t SeNvmCtx;
 
+/*
+ * Expanded key schedules, not part of the non-volatile context
+ */
+static KeyScheduleCache_t KeyScheduleCache;
+#endif
+
 static SecureElementNvmEvent SeNvmCtxChanged;
 
 /*
@@ -107,6 +168,78 @@ SecureElementStatus_t GetKeyByID( KeyIdentifier_t keyID, Key_t** keyItem )
     return SECURE_ELEMENT_ERROR_INVALID_KEY_ID;
 }
 
+/*
+ * Drops the cached key schedule of a key
+ *
+ * \param[IN]  keyID          - Key identifier
+ */
+static void KeyScheduleInvalidate( KeyIdentifier_t keyID )
+{
+    for( uint8_t i = 0; i < SE_KEY_SCHEDULE_CACHE_SIZE; i++ )
+    {
+        if( KeyScheduleCache.KeySchedules[i].KeyID == keyID )
+        {
+            KeyScheduleCache.KeySchedules[i].LastUse = 0;
+        }
+    }
+}
+
+/*
+ * Drops all the cached key schedules
+ */
+static void KeyScheduleInvalidateAll( void )
+{
+    memset1( ( uint8_t* )&KeyScheduleCache, 0, sizeof( KeyScheduleCache_t ) );
+}
+
+/*
+ * Gets the expanded key schedule of a key, the key is expanded only if its
+ * schedule is not cached
+ *
+ * \param[IN]  keyID          - Key identifier
+ * \param[OUT] keySchedule    - Key schedule reference
+ * \retval                    - Status of the operation
+ */
+static SecureElementStatus_t GetKeySchedule( KeyIdentifier_t keyID, const aes_context** keySchedule )
+{
+    KeySchedule_t* slot = &KeyScheduleCache.KeySchedules[0];
+    Key_t* keyItem;
+
+    if( KeyScheduleCache.KeySchedulesUse == UINT32_MAX )
+    { // Keep the use counter ordered
+        KeyScheduleInvalidateAll( );
+    }
+    KeyScheduleCache.KeySchedulesUse++;
+
+    for( uint8_t i = 0; i < SE_KEY_SCHEDULE_CACHE_SIZE; i++ )
+    {
+        KeySchedule_t* item = &KeyScheduleCache.KeySchedules[i];
+
+        if( ( item->LastUse != 0 ) && ( item->KeyID == keyID ) )
+        {
+            item->LastUse = KeyScheduleCache.KeySchedulesUse;
+            *keySchedule = &item->AesContext;
+            return SECURE_ELEMENT_SUCCESS;
+        }
+        if( item->LastUse < slot->LastUse )
+        { // Least recently used or free slot
+            slot = item;
+        }
+    }
+
+    SecureElementStatus_t retval = GetKeyByID( keyID, &keyItem );
+    if( retval != SECURE_ELEMENT_SUCCESS )
+    {
+        return retval;
+    }
+
+    aes_set_key( keyItem->KeyValue, KEY_SIZE, &slot->AesContext );
+    slot->KeyID = keyID;
+    slot->LastUse = KeyScheduleCache.KeySchedulesUse;
+    *keySchedule = &slot->AesContext;
+    return SECURE_ELEMENT_SUCCESS;
+}
+
 /*
  * Dummy callback in case if the user provides NULL function pointer
  */
@@ -138,12 +271,12 @@ static SecureElementStatus_t ComputeCmac( uint8_t *micBxBuffer, uint8_t *buffer,
 
     AES_CMAC_Init( SeNvmCtx.AesCmacCtx );
 
-    Key_t* keyItem;
-    SecureElementStatus_t retval = GetKeyByID( keyID, &keyItem );
+    const aes_context* keySchedule;
+    SecureElementStatus_t retval = GetKeySchedule( keyID, &keySchedule );
 
     if( retval == SECURE_ELEMENT_SUCCESS )
     {
-        AES_CMAC_SetKey( SeNvmCtx.AesCmacCtx, keyItem->KeyValue );
+        AES_CMAC_SetKeySchedule( SeNvmCtx.AesCmacCtx, keySchedule );
 
         if( micBxBuffer != NULL )
         {
@@ -202,6 +335,8 @@ SecureElementStatus_t SecureElementInit( SecureElementNvmEvent seNvmCtxChanged )
     memset1( SeNvmCtx.DevEui, 0, SE_EUI_SIZE );
     memset1( SeNvmCtx.JoinEui, 0, SE_EUI_SIZE );
 
+    KeyScheduleInvalidateAll( );
+
     // Assign callback
     if( seNvmCtxChanged != 0 )
     {
@@ -221,6 +356,7 @@ SecureElementStatus_t SecureElementRestoreNvmCtx( void* seNvmCtx )
     if( seNvmCtx != 0 )
     {
         memcpy1( ( uint8_t* ) &SeNvmCtx, ( uint8_t* ) seNvmCtx, sizeof( SeNvmCtx ) );
+        KeyScheduleInvalidateAll( );
         return SECURE_ELEMENT_SUCCESS;
     }
     else
@@ -254,6 +390,7 @@ SecureElementStatus_t SecureElementSetKey( KeyIdentifier_t keyID, uint8_t* key )
                 retval = SecureElementAesEncrypt( key, 16, MC_KE_KEY, decryptedKey );
 
                 memcpy1( SeNvmCtx.KeyList[i].KeyValue, decryptedKey, KEY_SIZE );
+                KeyScheduleInvalidate( keyID );
                 SeNvmCtxChanged( );
 
                 return retval;
@@ -261,6 +398,7 @@ SecureElementStatus_t SecureElementSetKey( KeyIdentifier_t keyID, uint8_t* key )
             else
             {
                 memcpy1( SeNvmCtx.KeyList[i].KeyValue, key, KEY_SIZE );
+                KeyScheduleInvalidate( keyID );
                 SeNvmCtxChanged( );
                 return SECURE_ELEMENT_SUCCESS;
             }
@@ -317,20 +455,16 @@ SecureElementStatus_t SecureElementAesEncrypt( uint8_t* buffer, uint16_t size, K
         return SECURE_ELEMENT_ERROR_BUF_SIZE;
     }
 
-    memset1( SeNvmCtx.AesContext.ksch, '\0', 240 );
-
-    Key_t* pItem;
-    SecureElementStatus_t retval = GetKeyByID( keyID, &pItem );
+    const aes_context* keySchedule;
+    SecureElementStatus_t retval = GetKeySchedule( keyID, &keySchedule );
 
     if( retval == SECURE_ELEMENT_SUCCESS )
     {
-        aes_set_key( pItem->KeyValue, 16, &SeNvmCtx.AesContext );
-
         uint8_t block = 0;
 
         while( size != 0 )
         {
-            aes_encrypt( &buffer[block], &encBuffer[block], &SeNvmCtx.AesContext );
+            aes_encrypt( &buffer[block], &encBuffer[block], keySchedule );
             block = block + 16;
             size = size - 16;
         }
@@ -338,6 +472,53 @@ SecureElementStatus_t SecureElementAesEncrypt( uint8_t* buffer, uint16_t size, K
     return retval;
 }
 
+SecureElementStatus_t SecureElementAesCtrEncrypt( const uint8_t* aBlock, uint8_t* buffer, uint16_t size, KeyIdentifier_t keyID )
+{
+    if( aBlock == NULL || buffer == NULL )
+    {
+        return SECURE_ELEMENT_ERROR_NPE;
+    }
+
+    const aes_context* keySchedule;
+    SecureElementStatus_t retval = GetKeySchedule( keyID, &keySchedule );
+
+    if( retval == SECURE_ELEMENT_SUCCESS )
+    {
+        uint8_t ctrBlock[16];
+        uint8_t sBlock[16];
+
+        memcpy1( ctrBlock, aBlock, 16 );
+        while( size >= 16 )
+        {
+            uint32_t data[4];
+            uint32_t keystream[4];
+
+            aes_encrypt( ctrBlock, sBlock, keySchedule );
+            ctrBlock[15]++;
+            // Word-wise XOR through local copies, whatever the buffer alignment.
+            // The compiler turns the fixed size memcpy into word loads and stores.
+            memcpy( data, buffer, 16 );
+            memcpy( keystream, sBlock, 16 );
+            data[0] ^= keystream[0];
+            data[1] ^= keystream[1];
+            data[2] ^= keystream[2];
+            data[3] ^= keystream[3];
+            memcpy( buffer, data, 16 );
+            buffer += 16;
+            size -= 16;
+        }
+        if( size > 0 )
+        {
+            aes_encrypt( ctrBlock, sBlock, keySchedule );
+            for( uint8_t i = 0; i < size; i++ )
+            {
+                buffer[i] ^= sBlock[i];
+            }
+        }
+    }
+    return retval;
+}
+
 SecureElementStatus_t SecureElementDeriveAndStoreKey( Version_t version, uint8_t* input, KeyIdentifier_t rootKeyID, KeyIdentifier_t targetKeyID )
 {
     if( input == NULL )
@@ -415,3 +596,10 @@ uint8_t* SecureElementGetJoinEui( void )
 {
     return SeNvmCtx.JoinEui;
 }
+
+#if defined( LORAMAC_MULTI_INSTANCE )
+size_t SecureElementGetInstanceCtxSize( void )
+{
+    return sizeof( SecureElementInstanceCtx_t );
+}
+#endif
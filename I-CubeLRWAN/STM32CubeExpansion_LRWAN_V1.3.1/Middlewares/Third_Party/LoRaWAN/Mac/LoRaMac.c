@@ -43,6 +43,7 @@
 #include "LoRaMacParser.h"
 #include "LoRaMacCommands.h"
 #include "LoRaMacAdr.h"
+#include "LoRaMacInstance.h"
 
 #include "LoRaMac.h"
 #include "util_console.h"
@@ -52,6 +53,15 @@
  */
 #define LORAMAC_PHY_MAXPAYLOAD                      255
 
+/*!
+ * No reception buffer index
+ */
+#define LORAMAC_RX_BUFFER_NONE                      LORAMAC_RX_POOL_SIZE
+
+#if ( LORAMAC_RX_POOL_SIZE < 2 ) || ( LORAMAC_RX_POOL_SIZE > 8 )
+#error "LORAMAC_RX_POOL_SIZE must be between 2 and 8"
+#endif
+
 /*!
  * Maximum MAC commands buffer size
  */
@@ -223,9 +233,30 @@ typedef struct sLoRaMacCtx
     */
     uint8_t AppDataSize;
     /*
-    * Buffer containing the upper layer data.
+    * Buffers the radio receives the downlinks into. The frames are parsed,
+    * decrypted and indicated in place.
+    */
+    uint8_t RxPool[LORAMAC_RX_POOL_SIZE][LORAMAC_PHY_MAXPAYLOAD];
+    /*
+    * Reception buffers in use, one bit per buffer
+    */
+    uint8_t RxPoolUsed;
+    /*
+    * Reception buffers retained by the application, one bit per buffer
+    */
+    uint8_t RxPoolRetained;
+    /*
+    * Reception buffer set to the radio
+    */
+    uint8_t RxPoolRadio;
+    /*
+    * Reception buffer holding the received frame not processed yet
+    */
+    uint8_t RxPoolPending;
+    /*
+    * Reception buffer holding the indicated frame
     */
-    uint8_t RxPayload[LORAMAC_PHY_MAXPAYLOAD];
+    uint8_t RxPoolIndication;
     SysTime_t LastTxSysTime;
     /*
     * LoRaMac internal state
@@ -336,11 +367,16 @@ typedef struct sLoRaMacCtx
     */
     LoRaMacRequestHandling_t AllowRequests;
     /*
+    * Interface of the active region, bound to NvmCtx->Region
+    */
+    const RegionInterface_t* RegionIf;
+    /*
     * Non-volatile module context structure
     */
     LoRaMacNvmCtx_t* NvmCtx;
 }LoRaMacCtx_t;
 
+#if !defined( LORAMAC_MULTI_INSTANCE )
 /*
  * Module context.
  */
@@ -350,6 +386,7 @@ static LoRaMacCtx_t MacCtx;
  * Non-volatile module context.
  */
 static LoRaMacNvmCtx_t NvmMacCtx;
+#endif
 
 
 
@@ -374,10 +411,12 @@ typedef union uLoRaMacRadioEvents
     }Events;
 }LoRaMacRadioEvents_t;
 
+#if !defined( LORAMAC_MULTI_INSTANCE )
 /*!
  * LoRaMac radio events status
  */
 LoRaMacRadioEvents_t LoRaMacRadioEvents = { .Value = 0 };
+#endif
 
 /*!
  * \brief Function to be executed on Radio Tx Done event
@@ -771,25 +810,117 @@ static void LoRaMacHandleRequestEvents( void );
  */
 static void LoRaMacHandleIndicationEvents( void );
 
+/*!
+ * \brief Sets a free reception buffer to the radio if it has none
+ *
+ * \remark To be called from the radio events or with interrupts disabled.
+ */
+static void RxPoolFeedRadio( void );
+
+/*!
+ * \brief Frees a reception buffer unless it is retained by the application
+ *
+ * \param [IN] index Reception buffer index, may be LORAMAC_RX_BUFFER_NONE
+ */
+static void RxPoolFree( uint8_t index );
+
+/*!
+ * \brief Returns the reception buffer a pointer belongs to
+ *
+ * \param [IN] buffer Pointer within a reception buffer
+ *
+ * \retval Reception buffer index, LORAMAC_RX_BUFFER_NONE if not found
+ */
+static uint8_t RxPoolFind( uint8_t* buffer );
+
 /*!
  * Structure used to store the radio Tx event data
  */
-struct
+typedef struct sTxDoneParams
 {
     TimerTime_t CurTime;
-}TxDoneParams;
+}TxDoneParams_t;
 
 /*!
  * Structure used to store the radio Rx event data
  */
-struct
+typedef struct sRxDoneParams
 {
     TimerTime_t LastRxDone;
     uint8_t *Payload;
     uint16_t Size;
     int16_t Rssi;
     int8_t Snr;
-}RxDoneParams;
+}RxDoneParams_t;
+
+#if defined( LORAMAC_MULTI_INSTANCE )
+/*
+ * Per-instance context of the module.
+ */
+typedef struct sLoRaMacInstanceCtx
+{
+    LoRaMacCtx_t MacCtx;
+    LoRaMacNvmCtx_t NvmMacCtx;
+    LoRaMacRadioEvents_t LoRaMacRadioEvents;
+    TxDoneParams_t TxDoneParams;
+    RxDoneParams_t RxDoneParams;
+}LoRaMacInstanceCtx_t;
+
+#define MAC_INSTANCE_CTX                            ( ( LoRaMacInstanceCtx_t* )LORAMAC_INSTANCE_MODULE_CTX( LORAMAC_INSTANCE_MODULE_MAC ) )
+#define MacCtx                                      ( MAC_INSTANCE_CTX->MacCtx )
+#define NvmMacCtx                                   ( MAC_INSTANCE_CTX->NvmMacCtx )
+#define LoRaMacRadioEvents                          ( MAC_INSTANCE_CTX->LoRaMacRadioEvents )
+#define TxDoneParams                                ( MAC_INSTANCE_CTX->TxDoneParams )
+#define RxDoneParams                                ( MAC_INSTANCE_CTX->RxDoneParams )
+#else
+TxDoneParams_t TxDoneParams;
+
+RxDoneParams_t RxDoneParams;
+#endif
+
+static void RxPoolFeedRadio( void )
+{
+    // With several instances the radio keeps its own buffer
+#if !defined( LORAMAC_MULTI_INSTANCE )
+    if( ( Radio.SetRxBuffer == NULL ) || ( MacCtx.RxPoolRadio != LORAMAC_RX_BUFFER_NONE ) )
+    {
+        return;
+    }
+
+    for( uint8_t i = 0; i < LORAMAC_RX_POOL_SIZE; i++ )
+    {
+        if( ( MacCtx.RxPoolUsed & ( 1 << i ) ) == 0 )
+        {
+            MacCtx.RxPoolUsed |= ( 1 << i );
+            MacCtx.RxPoolRadio = i;
+            Radio.SetRxBuffer( MacCtx.RxPool[i] );
+            return;
+        }
+    }
+    // All buffers are in use, the radio receives in its own buffer
+    Radio.SetRxBuffer( NULL );
+#endif
+}
+
+static void RxPoolFree( uint8_t index )
+{
+    if( ( index != LORAMAC_RX_BUFFER_NONE ) && ( ( MacCtx.RxPoolRetained & ( 1 << index ) ) == 0 ) )
+    {
+        MacCtx.RxPoolUsed &= ~( 1 << index );
+    }
+}
+
+static uint8_t RxPoolFind( uint8_t* buffer )
+{
+    for( uint8_t i = 0; i < LORAMAC_RX_POOL_SIZE; i++ )
+    {
+        if( ( buffer >= MacCtx.RxPool[i] ) && ( buffer < ( MacCtx.RxPool[i] + LORAMAC_PHY_MAXPAYLOAD ) ) )
+        {
+            return i;
+        }
+    }
+    return LORAMAC_RX_BUFFER_NONE;
+}
 
 static void OnRadioTxDone( void )
 {
@@ -815,6 +946,12 @@ static void OnRadioRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t
     RxDoneParams.Rssi = rssi;
     RxDoneParams.Snr = snr;
 
+    // The frame stays in its buffer, a frame not processed yet is dropped
+    RxPoolFree( MacCtx.RxPoolPending );
+    MacCtx.RxPoolPending = MacCtx.RxPoolRadio;
+    MacCtx.RxPoolRadio = LORAMAC_RX_BUFFER_NONE;
+    RxPoolFeedRadio( );
+
     LoRaMacRadioEvents.Events.RxDone = 1;
 
     if( ( MacCtx.MacCallbacks != NULL ) && ( MacCtx.MacCallbacks->MacProcessNotify != NULL ) )
@@ -893,7 +1030,7 @@ static void ProcessRadioTxDone( void )
     if( ( MacCtx.NvmCtx->DeviceClass == CLASS_C ) || ( MacCtx.NodeAckRequested == true ) )
     {
         getPhy.Attribute = PHY_ACK_TIMEOUT;
-        phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+        phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
         TimerSetValue( &MacCtx.AckTimeoutTimer, MacCtx.RxWindow2Delay + phyParam.Value );
         TimerStart( &MacCtx.AckTimeoutTimer );
     }
@@ -911,7 +1048,7 @@ static void ProcessRadioTxDone( void )
         txDone.Joined  = true;
     }
     txDone.LastTxDoneTime = TxDoneParams.CurTime;
-    RegionSetBandTxDone( MacCtx.NvmCtx->Region, &txDone );
+    MacCtx.RegionIf->SetBandTxDone( &txDone );
     // Update Aggregated last tx done time
     MacCtx.NvmCtx->LastTxDoneTime = TxDoneParams.CurTime;
 
@@ -946,10 +1083,10 @@ static void ProcessRadioRxDone( void )
 
     LoRaMacMessageData_t macMsgData;
     LoRaMacMessageJoinAccept_t macMsgJoinAccept;
-    uint8_t *payload = RxDoneParams.Payload;
-    uint16_t size = RxDoneParams.Size;
-    int16_t rssi = RxDoneParams.Rssi;
-    int8_t snr = RxDoneParams.Snr;
+    uint8_t *payload;
+    uint16_t size;
+    int16_t rssi;
+    int8_t snr;
 
     uint8_t pktHeaderLen = 0;
 
@@ -959,6 +1096,16 @@ static void ProcessRadioRxDone( void )
     AddressIdentifier_t addrID = UNICAST_DEV_ADDR;
     FCntIdentifier_t fCntID;
 
+    // Take the frame with its buffer, a new reception may overwrite both
+    CRITICAL_SECTION_BEGIN( );
+    payload = RxDoneParams.Payload;
+    size = RxDoneParams.Size;
+    rssi = RxDoneParams.Rssi;
+    snr = RxDoneParams.Snr;
+    MacCtx.RxPoolIndication = MacCtx.RxPoolPending;
+    MacCtx.RxPoolPending = LORAMAC_RX_BUFFER_NONE;
+    CRITICAL_SECTION_END( );
+
     MacCtx.McpsConfirm.AckReceived = false;
     MacCtx.McpsIndication.Rssi = rssi;
     MacCtx.McpsIndication.Snr = snr;
@@ -1050,7 +1197,7 @@ static void ProcessRadioRxDone( void )
                 // Size of the regular payload is 12. Plus 1 byte MHDR and 4 bytes MIC
                 applyCFList.Size = size - 17;
 
-                RegionApplyCFList( MacCtx.NvmCtx->Region, &applyCFList );
+                MacCtx.RegionIf->ApplyCFList( &applyCFList );
 
                 MacCtx.NvmCtx->NetworkActivation = ACTIVATION_TYPE_OTAA;
 
@@ -1083,7 +1230,7 @@ static void ProcessRadioRxDone( void )
             {
                 getPhy.Attribute = PHY_MAX_PAYLOAD_REPEATER;
             }
-            phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+            phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
             if( MAX( 0, ( int16_t )( ( int16_t ) size - ( int16_t ) LORA_MAC_FRMPAYLOAD_OVERHEAD ) ) > ( int16_t )phyParam.Value )
             {
                 MacCtx.McpsIndication.Status = LORAMAC_EVENT_INFO_STATUS_ERROR;
@@ -1092,7 +1239,8 @@ static void ProcessRadioRxDone( void )
             }
             macMsgData.Buffer = payload;
             macMsgData.BufSize = size;
-            macMsgData.FRMPayload = MacCtx.RxPayload;
+            // Parsed and decrypted in place
+            macMsgData.FRMPayload = NULL;
             macMsgData.FRMPayloadSize = LORAMAC_PHY_MAXPAYLOAD;
 
             if( LORAMAC_PARSER_SUCCESS != LoRaMacParserData( &macMsgData ) )
@@ -1135,7 +1283,7 @@ static void ProcessRadioRxDone( void )
 
             // Get maximum allowed counter difference
             getPhy.Attribute = PHY_MAX_FCNT_GAP;
-            phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+            phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
 
             // Get downlink frame counter value
             macCryptoStatus = GetFCntDown( addrID, fType, &macMsgData, MacCtx.NvmCtx->Version, phyParam.Value, &fCntID, &downLinkCounter );
@@ -1297,11 +1445,9 @@ static void ProcessRadioRxDone( void )
 
             break;
         case FRAME_TYPE_PROPRIETARY:
-            memcpy1( MacCtx.RxPayload, &payload[pktHeaderLen], size - pktHeaderLen );
-
             MacCtx.McpsIndication.McpsIndication = MCPS_PROPRIETARY;
             MacCtx.McpsIndication.Status = LORAMAC_EVENT_INFO_STATUS_OK;
-            MacCtx.McpsIndication.Buffer = MacCtx.RxPayload;
+            MacCtx.McpsIndication.Buffer = &payload[pktHeaderLen];
             MacCtx.McpsIndication.BufferSize = size - pktHeaderLen;
 
             MacCtx.MacFlags.Bits.McpsInd = 1;
@@ -1683,6 +1829,17 @@ void LoRaMacProcess( void )
         LoRaMacEnableRequests( LORAMAC_REQUEST_HANDLING_ON );
     }
     LoRaMacHandleIndicationEvents( );
+
+    // The indicated frame buffer goes back to the pool unless retained
+    CRITICAL_SECTION_BEGIN( );
+    RxPoolFree( MacCtx.RxPoolIndication );
+    MacCtx.RxPoolIndication = LORAMAC_RX_BUFFER_NONE;
+    if( Radio.GetStatus( ) != RF_RX_RUNNING )
+    {
+        RxPoolFeedRadio( );
+    }
+    CRITICAL_SECTION_END( );
+
     if( MacCtx.RxSlot == RX_SLOT_WIN_CLASS_C )
     {
         OpenContinuousRxCWindow( );
@@ -1691,6 +1848,7 @@ void LoRaMacProcess( void )
 
 static void OnTxDelayedTimerEvent( void* context )
 {
+    LORAMAC_INSTANCE_SELECT( context );
     TimerStop( &MacCtx.TxDelayedTimer );
     MacCtx.MacState &= ~LORAMAC_TX_DELAYED;
 
@@ -1717,6 +1875,7 @@ static void OnTxDelayedTimerEvent( void* context )
 
 static void OnRxWindow1TimerEvent( void* context )
 {
+    LORAMAC_INSTANCE_SELECT( context );
     MacCtx.RxWindow1Config.Channel = MacCtx.Channel;
     MacCtx.RxWindow1Config.DrOffset = MacCtx.NvmCtx->MacParams.Rx1DrOffset;
     MacCtx.RxWindow1Config.DownlinkDwellTime = MacCtx.NvmCtx->MacParams.DownlinkDwellTime;
@@ -1729,6 +1888,7 @@ static void OnRxWindow1TimerEvent( void* context )
 
 static void OnRxWindow2TimerEvent( void* context )
 {
+    LORAMAC_INSTANCE_SELECT( context );
     // Check if we are processing Rx1 window.
     // If yes, we don't setup the Rx2 window.
     if( MacCtx.RxSlot == RX_SLOT_WIN_1 )
@@ -1747,6 +1907,7 @@ static void OnRxWindow2TimerEvent( void* context )
 
 static void OnAckTimeoutTimerEvent( void* context )
 {
+    LORAMAC_INSTANCE_SELECT( context );
     TimerStop( &MacCtx.AckTimeoutTimer );
 
     if( MacCtx.NodeAckRequested == true )
@@ -1863,11 +2024,10 @@ static LoRaMacStatus_t SwitchClass( DeviceClass_t deviceClass )
                 // Set the radio into sleep mode in case we are still in RX mode
                 Radio.Sleep( );
                 // Compute Rx2 windows parameters in case the RX2 datarate has changed
-                RegionComputeRxWindowParameters( MacCtx.NvmCtx->Region,
-                                                 MacCtx.NvmCtx->MacParams.RxCChannel.Datarate,
-                                                 MacCtx.NvmCtx->MacParams.MinRxSymbols,
-                                                 MacCtx.NvmCtx->MacParams.SystemMaxRxError,
-                                                 &MacCtx.RxWindowCConfig );
+                MacCtx.RegionIf->ComputeRxWindowParameters( MacCtx.NvmCtx->MacParams.RxCChannel.Datarate,
+                                                            MacCtx.NvmCtx->MacParams.MinRxSymbols,
+                                                            MacCtx.NvmCtx->MacParams.SystemMaxRxError,
+                                                            &MacCtx.RxWindowCConfig );
                 OpenContinuousRxCWindow( );
 
                 status = LORAMAC_STATUS_OK;
@@ -1916,7 +2076,7 @@ static uint8_t GetMaxAppPayloadWithoutFOptsLength( int8_t datarate )
     {
         getPhy.Attribute = PHY_MAX_PAYLOAD_REPEATER;
     }
-    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
 
     return phyParam.Value;
 }
@@ -1988,7 +2148,7 @@ static void ProcessMacCommands( uint8_t *payload, uint8_t macIndex, uint8_t comm
                     linkAdrReq.Version = MacCtx.NvmCtx->Version;
 
                     // Process the ADR requests
-                    status = RegionLinkAdrReq( MacCtx.NvmCtx->Region, &linkAdrReq, &linkAdrDatarate,
+                    status = MacCtx.RegionIf->LinkAdrReq( &linkAdrReq, &linkAdrDatarate,
                                                &linkAdrTxPower, &linkAdrNbRep, &linkAdrNbBytesParsed );
 
                     if( ( status & 0x07 ) == 0x07 )
@@ -2030,7 +2190,7 @@ static void ProcessMacCommands( uint8_t *payload, uint8_t macIndex, uint8_t comm
                 rxParamSetupReq.Frequency *= 100;
 
                 // Perform request on region
-                status = RegionRxParamSetupReq( MacCtx.NvmCtx->Region, &rxParamSetupReq );
+                status = MacCtx.RegionIf->RxParamSetupReq( &rxParamSetupReq );
 
                 if( ( status & 0x07 ) == 0x07 )
                 {
@@ -2074,7 +2234,7 @@ static void ProcessMacCommands( uint8_t *payload, uint8_t macIndex, uint8_t comm
                 chParam.Rx1Frequency = 0;
                 chParam.DrRange.Value = payload[macIndex++];
 
-                status = RegionNewChannelReq( MacCtx.NvmCtx->Region, &newChannelReq );
+                status = MacCtx.RegionIf->NewChannelReq( &newChannelReq );
 
                 macCmdPayload[0] = status;
                 LoRaMacCommandsAddCmd( MOTE_MAC_NEW_CHANNEL_ANS, macCmdPayload, 1 );
@@ -2116,7 +2276,7 @@ static void ProcessMacCommands( uint8_t *payload, uint8_t macIndex, uint8_t comm
                 txParamSetupReq.MaxEirp = eirpDwellTime & 0x0F;
 
                 // Check the status for correctness
-                if( RegionTxParamSetupReq( MacCtx.NvmCtx->Region, &txParamSetupReq ) != -1 )
+                if( MacCtx.RegionIf->TxParamSetupReq( &txParamSetupReq ) != -1 )
                 {
                     // Accept command
                     MacCtx.NvmCtx->MacParams.UplinkDwellTime = txParamSetupReq.UplinkDwellTime;
@@ -2125,7 +2285,7 @@ static void ProcessMacCommands( uint8_t *payload, uint8_t macIndex, uint8_t comm
                     // Update the datarate in case of the new configuration limits it
                     getPhy.Attribute = PHY_MIN_TX_DR;
                     getPhy.UplinkDwellTime = MacCtx.NvmCtx->MacParams.UplinkDwellTime;
-                    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+                    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
                     MacCtx.NvmCtx->MacParams.ChannelsDatarate = MAX( MacCtx.NvmCtx->MacParams.ChannelsDatarate, ( int8_t )phyParam.Value );
 
                     // Add command response
@@ -2144,7 +2304,7 @@ static void ProcessMacCommands( uint8_t *payload, uint8_t macIndex, uint8_t comm
                 dlChannelReq.Rx1Frequency |= ( uint32_t ) payload[macIndex++] << 16;
                 dlChannelReq.Rx1Frequency *= 100;
 
-                status = RegionDlChannelReq( MacCtx.NvmCtx->Region, &dlChannelReq );
+                status = MacCtx.RegionIf->DlChannelReq( &dlChannelReq );
                 macCmdPayload[0] = status;
                 LoRaMacCommandsAddCmd( MOTE_MAC_DL_CHANNEL_ANS, macCmdPayload, 1 );
                 // Setup indication to inform the application
@@ -2396,7 +2556,7 @@ static LoRaMacStatus_t ScheduleTx( bool allowDelayedTx )
     nextChan.LastAggrTx = MacCtx.NvmCtx->LastTxDoneTime;
 
     // Select channel
-    status = RegionNextChannel( MacCtx.NvmCtx->Region, &nextChan, &MacCtx.Channel, &dutyCycleTimeOff, &MacCtx.NvmCtx->AggregatedTimeOff );
+    status = MacCtx.RegionIf->NextChannel( &nextChan, &MacCtx.Channel, &dutyCycleTimeOff, &MacCtx.NvmCtx->AggregatedTimeOff );
 
     if( status != LORAMAC_STATUS_OK )
     {
@@ -2420,17 +2580,15 @@ static LoRaMacStatus_t ScheduleTx( bool allowDelayedTx )
     }
 
     // Compute Rx1 windows parameters
-    RegionComputeRxWindowParameters( MacCtx.NvmCtx->Region,
-                                     RegionApplyDrOffset( MacCtx.NvmCtx->Region, MacCtx.NvmCtx->MacParams.DownlinkDwellTime, MacCtx.NvmCtx->MacParams.ChannelsDatarate, MacCtx.NvmCtx->MacParams.Rx1DrOffset ),
-                                     MacCtx.NvmCtx->MacParams.MinRxSymbols,
-                                     MacCtx.NvmCtx->MacParams.SystemMaxRxError,
-                                     &MacCtx.RxWindow1Config );
+    MacCtx.RegionIf->ComputeRxWindowParameters( MacCtx.RegionIf->ApplyDrOffset( MacCtx.NvmCtx->MacParams.DownlinkDwellTime, MacCtx.NvmCtx->MacParams.ChannelsDatarate, MacCtx.NvmCtx->MacParams.Rx1DrOffset ),
+                                                MacCtx.NvmCtx->MacParams.MinRxSymbols,
+                                                MacCtx.NvmCtx->MacParams.SystemMaxRxError,
+                                                &MacCtx.RxWindow1Config );
     // Compute Rx2 windows parameters
-    RegionComputeRxWindowParameters( MacCtx.NvmCtx->Region,
-                                     MacCtx.NvmCtx->MacParams.Rx2Channel.Datarate,
-                                     MacCtx.NvmCtx->MacParams.MinRxSymbols,
-                                     MacCtx.NvmCtx->MacParams.SystemMaxRxError,
-                                     &MacCtx.RxWindow2Config );
+    MacCtx.RegionIf->ComputeRxWindowParameters( MacCtx.NvmCtx->MacParams.Rx2Channel.Datarate,
+                                                MacCtx.NvmCtx->MacParams.MinRxSymbols,
+                                                MacCtx.NvmCtx->MacParams.SystemMaxRxError,
+                                                &MacCtx.RxWindow2Config );
 
     if( MacCtx.NvmCtx->NetworkActivation == ACTIVATION_TYPE_NONE )
     {
@@ -2528,7 +2686,7 @@ static void CalculateBackOff( uint8_t channel )
     }
 
     // Update regional back-off
-    RegionCalcBackOff( MacCtx.NvmCtx->Region, &calcBackOff );
+    MacCtx.RegionIf->CalcBackOff( &calcBackOff );
 
     // Update aggregated time-off. This must be an assignment and no incremental
     // update as we do only calculate the time-off based on the last transmission
@@ -2616,7 +2774,7 @@ static void RxWindowSetup( TimerEvent_t* rxTimer, RxConfigParams_t* rxConfig )
     // Ensure the radio is Idle
     Radio.Standby( );
 
-    if( RegionRxConfig( MacCtx.NvmCtx->Region, rxConfig, ( int8_t* )&MacCtx.McpsIndication.RxDatarate ) == true )
+    if( MacCtx.RegionIf->RxConfig( rxConfig, ( int8_t* )&MacCtx.McpsIndication.RxDatarate ) == true )
     {
         Radio.Rx( MacCtx.NvmCtx->MacParams.MaxRxWindow );
         MacCtx.RxSlot = rxConfig->RxSlot;
@@ -2631,7 +2789,7 @@ static void OpenContinuousRxCWindow( void )
 
     // At this point the Radio should be idle.
     // Thus, there is no need to set the radio in standby mode.
-    if( RegionRxConfig( MacCtx.NvmCtx->Region, &MacCtx.RxWindowCConfig, ( int8_t* )&MacCtx.McpsIndication.RxDatarate ) == true )
+    if( MacCtx.RegionIf->RxConfig( &MacCtx.RxWindowCConfig, ( int8_t* )&MacCtx.McpsIndication.RxDatarate ) == true )
     {
         Radio.Rx( 0 ); // Continuous mode
         MacCtx.RxSlot = MacCtx.RxWindowCConfig.RxSlot;
@@ -2776,7 +2934,7 @@ LoRaMacStatus_t SendFrameOnChannel( uint8_t channel )
             LoRaMacClassBStopRxSlots( );
         }
     }
-    RegionTxConfig( MacCtx.NvmCtx->Region, &txConfig, &txPower, &MacCtx.TxTimeOnAir );
+    MacCtx.RegionIf->TxConfig( &txConfig, &txPower, &MacCtx.TxTimeOnAir );
 
     MacCtx.McpsConfirm.Status = LORAMAC_EVENT_INFO_STATUS_ERROR;
     MacCtx.McpsConfirm.Datarate = MacCtx.NvmCtx->MacParams.ChannelsDatarate;
@@ -2824,7 +2982,7 @@ LoRaMacStatus_t SetTxContinuousWave( uint16_t timeout )
     continuousWave.AntennaGain = MacCtx.NvmCtx->MacParams.AntennaGain;
     continuousWave.Timeout = timeout;
 
-    RegionSetContinuousWave( MacCtx.NvmCtx->Region, &continuousWave );
+    MacCtx.RegionIf->SetContinuousWave( &continuousWave );
 
     MacCtx.MacState |= LORAMAC_TX_RUNNING;
 
@@ -2871,6 +3029,13 @@ LoRaMacStatus_t RestoreCtxs( LoRaMacCtxs_t* contexts )
         memcpy1( ( uint8_t* ) &NvmMacCtx, ( uint8_t* ) contexts->MacNvmCtx, contexts->MacNvmCtxSize );
     }
 
+    // The restored context may select another region
+    MacCtx.RegionIf = RegionGetInterface( MacCtx.NvmCtx->Region );
+    if( MacCtx.RegionIf == NULL )
+    {
+        return LORAMAC_STATUS_REGION_NOT_SUPPORTED;
+    }
+
     InitDefaultsParams_t params;
     params.Type = INIT_TYPE_RESTORE_CTX;
     params.NvmCtx = contexts->RegionNvmCtx;
@@ -3034,7 +3199,7 @@ static void AckTimeoutRetriesProcess( void )
             getPhy.Attribute = PHY_NEXT_LOWER_TX_DR;
             getPhy.UplinkDwellTime = MacCtx.NvmCtx->MacParams.UplinkDwellTime;
             getPhy.Datarate = MacCtx.NvmCtx->MacParams.ChannelsDatarate;
-            phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+            phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
             MacCtx.NvmCtx->MacParams.ChannelsDatarate = phyParam.Value;
         }
     }
@@ -3147,6 +3312,7 @@ LoRaMacStatus_t LoRaMacInitialization( LoRaMacPrimitives_t* primitives, LoRaMacC
     MacCtx.AckTimeoutRetriesCounter = 1;
     MacCtx.AckTimeoutRetries = 1;
     MacCtx.NvmCtx->Region = region;
+    MacCtx.RegionIf = RegionGetInterface( region );
     MacCtx.NvmCtx->DeviceClass = CLASS_A;
     MacCtx.NvmCtx->RepeaterSupport = false;
 
@@ -3159,73 +3325,73 @@ LoRaMacStatus_t LoRaMacInitialization( LoRaMacPrimitives_t* primitives, LoRaMacC
 
     // Reset to defaults
     getPhy.Attribute = PHY_DUTY_CYCLE;
-    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
     MacCtx.NvmCtx->DutyCycleOn = ( bool ) phyParam.Value;
 
     getPhy.Attribute = PHY_DEF_TX_POWER;
-    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
     MacCtx.NvmCtx->MacParamsDefaults.ChannelsTxPower = phyParam.Value;
 
     getPhy.Attribute = PHY_DEF_TX_DR;
-    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
     MacCtx.NvmCtx->MacParamsDefaults.ChannelsDatarate = phyParam.Value;
 
     getPhy.Attribute = PHY_MAX_RX_WINDOW;
-    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
     MacCtx.NvmCtx->MacParamsDefaults.MaxRxWindow = phyParam.Value;
 
     getPhy.Attribute = PHY_RECEIVE_DELAY1;
-    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
     MacCtx.NvmCtx->MacParamsDefaults.ReceiveDelay1 = phyParam.Value;
 
     getPhy.Attribute = PHY_RECEIVE_DELAY2;
-    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
     MacCtx.NvmCtx->MacParamsDefaults.ReceiveDelay2 = phyParam.Value;
 
     getPhy.Attribute = PHY_JOIN_ACCEPT_DELAY1;
-    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
     MacCtx.NvmCtx->MacParamsDefaults.JoinAcceptDelay1 = phyParam.Value;
 
     getPhy.Attribute = PHY_JOIN_ACCEPT_DELAY2;
-    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
     MacCtx.NvmCtx->MacParamsDefaults.JoinAcceptDelay2 = phyParam.Value;
 
     getPhy.Attribute = PHY_DEF_DR1_OFFSET;
-    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
     MacCtx.NvmCtx->MacParamsDefaults.Rx1DrOffset = phyParam.Value;
 
     getPhy.Attribute = PHY_DEF_RX2_FREQUENCY;
-    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
     MacCtx.NvmCtx->MacParamsDefaults.Rx2Channel.Frequency = phyParam.Value;
     MacCtx.NvmCtx->MacParamsDefaults.RxCChannel.Frequency = phyParam.Value;
 
     getPhy.Attribute = PHY_DEF_RX2_DR;
-    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
     MacCtx.NvmCtx->MacParamsDefaults.Rx2Channel.Datarate = phyParam.Value;
     MacCtx.NvmCtx->MacParamsDefaults.RxCChannel.Datarate = phyParam.Value;
 
     getPhy.Attribute = PHY_DEF_UPLINK_DWELL_TIME;
-    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
     MacCtx.NvmCtx->MacParamsDefaults.UplinkDwellTime = phyParam.Value;
 
     getPhy.Attribute = PHY_DEF_DOWNLINK_DWELL_TIME;
-    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
     MacCtx.NvmCtx->MacParamsDefaults.DownlinkDwellTime = phyParam.Value;
 
     getPhy.Attribute = PHY_DEF_MAX_EIRP;
-    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
     MacCtx.NvmCtx->MacParamsDefaults.MaxEirp = phyParam.fValue;
 
     getPhy.Attribute = PHY_DEF_ANTENNA_GAIN;
-    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
     MacCtx.NvmCtx->MacParamsDefaults.AntennaGain = phyParam.fValue;
 
     getPhy.Attribute = PHY_DEF_ADR_ACK_LIMIT;
-    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
     MacCtx.AdrAckLimit = phyParam.Value;
 
     getPhy.Attribute = PHY_DEF_ADR_ACK_DELAY;
-    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
     MacCtx.AdrAckDelay = phyParam.Value;
 
     // Init parameters which are not set in function ResetMacParameters
@@ -3260,6 +3426,10 @@ LoRaMacStatus_t LoRaMacInitialization( LoRaMacPrimitives_t* primitives, LoRaMacC
     TimerInit( &MacCtx.RxWindowTimer1, OnRxWindow1TimerEvent );
     TimerInit( &MacCtx.RxWindowTimer2, OnRxWindow2TimerEvent );
     TimerInit( &MacCtx.AckTimeoutTimer, OnAckTimeoutTimerEvent );
+    LORAMAC_INSTANCE_TIMER_BIND( &MacCtx.TxDelayedTimer );
+    LORAMAC_INSTANCE_TIMER_BIND( &MacCtx.RxWindowTimer1 );
+    LORAMAC_INSTANCE_TIMER_BIND( &MacCtx.RxWindowTimer2 );
+    LORAMAC_INSTANCE_TIMER_BIND( &MacCtx.AckTimeoutTimer );
 
     // Store the current initialization time
     MacCtx.NvmCtx->InitializationTime = TimerGetCurrentTime( );
@@ -3272,6 +3442,12 @@ LoRaMacStatus_t LoRaMacInitialization( LoRaMacPrimitives_t* primitives, LoRaMacC
     MacCtx.RadioEvents.RxTimeout = OnRadioRxTimeout;
     Radio.Init( &MacCtx.RadioEvents );
 
+    // Receive in the MAC buffers
+    MacCtx.RxPoolRadio = LORAMAC_RX_BUFFER_NONE;
+    MacCtx.RxPoolPending = LORAMAC_RX_BUFFER_NONE;
+    MacCtx.RxPoolIndication = LORAMAC_RX_BUFFER_NONE;
+    RxPoolFeedRadio( );
+
     InitDefaultsParams_t params;
     params.Type = INIT_TYPE_INIT;
     params.NvmCtx = NULL;
@@ -3473,7 +3649,7 @@ LoRaMacStatus_t LoRaMacMibGetRequestConfirm( MibRequestConfirm_t* mibGet )
         case MIB_CHANNELS:
         {
             getPhy.Attribute = PHY_CHANNELS;
-            phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+            phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
 
             mibGet->Param.ChannelList = phyParam.Channels;
             break;
@@ -3501,7 +3677,7 @@ LoRaMacStatus_t LoRaMacMibGetRequestConfirm( MibRequestConfirm_t* mibGet )
         case MIB_CHANNELS_DEFAULT_MASK:
         {
             getPhy.Attribute = PHY_CHANNELS_DEFAULT_MASK;
-            phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+            phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
 
             mibGet->Param.ChannelsDefaultMask = phyParam.ChannelsMask;
             break;
@@ -3509,7 +3685,7 @@ LoRaMacStatus_t LoRaMacMibGetRequestConfirm( MibRequestConfirm_t* mibGet )
         case MIB_CHANNELS_MASK:
         {
             getPhy.Attribute = PHY_CHANNELS_MASK;
-            phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+            phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
 
             mibGet->Param.ChannelsMask = phyParam.ChannelsMask;
             break;
@@ -4009,7 +4185,7 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
             verify.DatarateParams.Datarate = mibSet->Param.Rx2Channel.Datarate;
             verify.DatarateParams.DownlinkDwellTime = MacCtx.NvmCtx->MacParams.DownlinkDwellTime;
 
-            if( RegionVerify( MacCtx.NvmCtx->Region, &verify, PHY_RX_DR ) == true )
+            if( MacCtx.RegionIf->Verify( &verify, PHY_RX_DR ) == true )
             {
                 MacCtx.NvmCtx->MacParams.Rx2Channel = mibSet->Param.Rx2Channel;
             }
@@ -4024,7 +4200,7 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
             verify.DatarateParams.Datarate = mibSet->Param.Rx2Channel.Datarate;
             verify.DatarateParams.DownlinkDwellTime = MacCtx.NvmCtx->MacParams.DownlinkDwellTime;
 
-            if( RegionVerify( MacCtx.NvmCtx->Region, &verify, PHY_RX_DR ) == true )
+            if( MacCtx.RegionIf->Verify( &verify, PHY_RX_DR ) == true )
             {
                 MacCtx.NvmCtx->MacParamsDefaults.Rx2Channel = mibSet->Param.Rx2DefaultChannel;
             }
@@ -4039,7 +4215,7 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
             verify.DatarateParams.Datarate = mibSet->Param.RxCChannel.Datarate;
             verify.DatarateParams.DownlinkDwellTime = MacCtx.NvmCtx->MacParams.DownlinkDwellTime;
 
-            if( RegionVerify( MacCtx.NvmCtx->Region, &verify, PHY_RX_DR ) == true )
+            if( MacCtx.RegionIf->Verify( &verify, PHY_RX_DR ) == true )
             {
                 MacCtx.NvmCtx->MacParams.RxCChannel = mibSet->Param.RxCChannel;
 
@@ -4051,11 +4227,10 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
                     // Set the radio into sleep mode in case we are still in RX mode
                     Radio.Sleep( );
                     // Compute RxC windows parameters
-                    RegionComputeRxWindowParameters( MacCtx.NvmCtx->Region,
-                                                     MacCtx.NvmCtx->MacParams.RxCChannel.Datarate,
-                                                     MacCtx.NvmCtx->MacParams.MinRxSymbols,
-                                                     MacCtx.NvmCtx->MacParams.SystemMaxRxError,
-                                                     &MacCtx.RxWindowCConfig );
+                    MacCtx.RegionIf->ComputeRxWindowParameters( MacCtx.NvmCtx->MacParams.RxCChannel.Datarate,
+                                                                MacCtx.NvmCtx->MacParams.MinRxSymbols,
+                                                                MacCtx.NvmCtx->MacParams.SystemMaxRxError,
+                                                                &MacCtx.RxWindowCConfig );
                     OpenContinuousRxCWindow( );
                 }
             }
@@ -4070,7 +4245,7 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
             verify.DatarateParams.Datarate = mibSet->Param.RxCChannel.Datarate;
             verify.DatarateParams.DownlinkDwellTime = MacCtx.NvmCtx->MacParams.DownlinkDwellTime;
 
-            if( RegionVerify( MacCtx.NvmCtx->Region, &verify, PHY_RX_DR ) == true )
+            if( MacCtx.RegionIf->Verify( &verify, PHY_RX_DR ) == true )
             {
                 MacCtx.NvmCtx->MacParamsDefaults.RxCChannel = mibSet->Param.RxCDefaultChannel;
             }
@@ -4085,7 +4260,7 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
             chanMaskSet.ChannelsMaskIn = mibSet->Param.ChannelsDefaultMask;
             chanMaskSet.ChannelsMaskType = CHANNELS_DEFAULT_MASK;
 
-            if( RegionChanMaskSet( MacCtx.NvmCtx->Region, &chanMaskSet ) == false )
+            if( MacCtx.RegionIf->ChanMaskSet( &chanMaskSet ) == false )
             {
                 status = LORAMAC_STATUS_PARAMETER_INVALID;
             }
@@ -4096,7 +4271,7 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
             chanMaskSet.ChannelsMaskIn = mibSet->Param.ChannelsMask;
             chanMaskSet.ChannelsMaskType = CHANNELS_MASK;
 
-            if( RegionChanMaskSet( MacCtx.NvmCtx->Region, &chanMaskSet ) == false )
+            if( MacCtx.RegionIf->ChanMaskSet( &chanMaskSet ) == false )
             {
                 status = LORAMAC_STATUS_PARAMETER_INVALID;
             }
@@ -4144,7 +4319,7 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
         {
             verify.DatarateParams.Datarate = mibSet->Param.ChannelsDefaultDatarate;
 
-            if( RegionVerify( MacCtx.NvmCtx->Region, &verify, PHY_DEF_TX_DR ) == true )
+            if( MacCtx.RegionIf->Verify( &verify, PHY_DEF_TX_DR ) == true )
             {
                 MacCtx.NvmCtx->MacParamsDefaults.ChannelsDatarate = verify.DatarateParams.Datarate;
             }
@@ -4159,7 +4334,7 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
             verify.DatarateParams.Datarate = mibSet->Param.ChannelsDatarate;
             verify.DatarateParams.UplinkDwellTime = MacCtx.NvmCtx->MacParams.UplinkDwellTime;
 
-            if( RegionVerify( MacCtx.NvmCtx->Region, &verify, PHY_TX_DR ) == true )
+            if( MacCtx.RegionIf->Verify( &verify, PHY_TX_DR ) == true )
             {
                 MacCtx.NvmCtx->MacParams.ChannelsDatarate = verify.DatarateParams.Datarate;
             }
@@ -4173,7 +4348,7 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
         {
             verify.TxPower = mibSet->Param.ChannelsDefaultTxPower;
 
-            if( RegionVerify( MacCtx.NvmCtx->Region, &verify, PHY_DEF_TX_POWER ) == true )
+            if( MacCtx.RegionIf->Verify( &verify, PHY_DEF_TX_POWER ) == true )
             {
                 MacCtx.NvmCtx->MacParamsDefaults.ChannelsTxPower = verify.TxPower;
             }
@@ -4187,7 +4362,7 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
         {
             verify.TxPower = mibSet->Param.ChannelsTxPower;
 
-            if( RegionVerify( MacCtx.NvmCtx->Region, &verify, PHY_TX_POWER ) == true )
+            if( MacCtx.RegionIf->Verify( &verify, PHY_TX_POWER ) == true )
             {
                 MacCtx.NvmCtx->MacParams.ChannelsTxPower = verify.TxPower;
             }
@@ -4274,7 +4449,7 @@ LoRaMacStatus_t LoRaMacChannelAdd( uint8_t id, ChannelParams_t params )
     channelAdd.ChannelId = id;
 
     EventRegionNvmCtxChanged( );
-    return RegionChannelAdd( MacCtx.NvmCtx->Region, &channelAdd );
+    return MacCtx.RegionIf->ChannelAdd( &channelAdd );
 }
 
 LoRaMacStatus_t LoRaMacChannelRemove( uint8_t id )
@@ -4291,7 +4466,7 @@ LoRaMacStatus_t LoRaMacChannelRemove( uint8_t id )
 
     channelRemove.ChannelId = id;
 
-    if( RegionChannelsRemove( MacCtx.NvmCtx->Region, &channelRemove ) == false )
+    if( MacCtx.RegionIf->ChannelsRemove( &channelRemove ) == false )
     {
         return LORAMAC_STATUS_PARAMETER_INVALID;
     }
@@ -4407,7 +4582,7 @@ LoRaMacStatus_t LoRaMacMcChannelSetupRxParams( AddressIdentifier_t groupID, McRx
     }
     verify.DatarateParams.DownlinkDwellTime = MacCtx.NvmCtx->MacParams.DownlinkDwellTime;
 
-    if( RegionVerify( MacCtx.NvmCtx->Region, &verify, PHY_RX_DR ) == true )
+    if( MacCtx.RegionIf->Verify( &verify, PHY_RX_DR ) == true )
     {
         *status &= 0xFB; // datarate OK
     }
@@ -4421,7 +4596,7 @@ LoRaMacStatus_t LoRaMacMcChannelSetupRxParams( AddressIdentifier_t groupID, McRx
     {
         verify.Frequency = rxParams->ClassC.Frequency;
     }
-    if( RegionVerify( MacCtx.NvmCtx->Region, &verify, PHY_FREQUENCY ) == true )
+    if( MacCtx.RegionIf->Verify( &verify, PHY_FREQUENCY ) == true )
     {
         *status &= 0xF7; // frequency OK
     }
@@ -4478,7 +4653,7 @@ LoRaMacStatus_t LoRaMacMlmeRequest( MlmeReq_t* mlmeRequest )
 
             ResetMacParameters( );
 
-            MacCtx.NvmCtx->MacParams.ChannelsDatarate = RegionAlternateDr( MacCtx.NvmCtx->Region, mlmeRequest->Req.Join.Datarate, ALTERNATE_DR );
+            MacCtx.NvmCtx->MacParams.ChannelsDatarate = MacCtx.RegionIf->AlternateDr( mlmeRequest->Req.Join.Datarate, ALTERNATE_DR );
 
             queueElement.Status = LORAMAC_EVENT_INFO_STATUS_JOIN_FAIL;
 
@@ -4487,7 +4662,7 @@ LoRaMacStatus_t LoRaMacMlmeRequest( MlmeReq_t* mlmeRequest )
             if( status != LORAMAC_STATUS_OK )
             {
                 // Revert back the previous datarate ( mainly used for US915 like regions )
-                MacCtx.NvmCtx->MacParams.ChannelsDatarate = RegionAlternateDr( MacCtx.NvmCtx->Region, mlmeRequest->Req.Join.Datarate, ALTERNATE_DR_RESTORE );
+                MacCtx.NvmCtx->MacParams.ChannelsDatarate = MacCtx.RegionIf->AlternateDr( mlmeRequest->Req.Join.Datarate, ALTERNATE_DR_RESTORE );
             }
             break;
         }
@@ -4661,7 +4836,7 @@ LoRaMacStatus_t LoRaMacMcpsRequest( McpsReq_t* mcpsRequest )
     // Get the minimum possible datarate
     getPhy.Attribute = PHY_MIN_TX_DR;
     getPhy.UplinkDwellTime = MacCtx.NvmCtx->MacParams.UplinkDwellTime;
-    phyParam = RegionGetPhyParam( MacCtx.NvmCtx->Region, &getPhy );
+    phyParam = MacCtx.RegionIf->GetPhyParam( &getPhy );
     // Apply the minimum possible datarate.
     // Some regions have limitations for the minimum datarate.
     datarate = MAX( datarate, ( int8_t )phyParam.Value );
@@ -4673,7 +4848,7 @@ LoRaMacStatus_t LoRaMacMcpsRequest( McpsReq_t* mcpsRequest )
             verify.DatarateParams.Datarate = datarate;
             verify.DatarateParams.UplinkDwellTime = MacCtx.NvmCtx->MacParams.UplinkDwellTime;
 
-            if( RegionVerify( MacCtx.NvmCtx->Region, &verify, PHY_TX_DR ) == true )
+            if( MacCtx.RegionIf->Verify( &verify, PHY_TX_DR ) == true )
             {
                 MacCtx.NvmCtx->MacParams.ChannelsDatarate = verify.DatarateParams.Datarate;
             }
@@ -4699,14 +4874,71 @@ LoRaMacStatus_t LoRaMacMcpsRequest( McpsReq_t* mcpsRequest )
     return status;
 }
 
+LoRaMacStatus_t LoRaMacRxBufferRetain( uint8_t* buffer )
+{
+    uint8_t index = RxPoolFind( buffer );
+    uint8_t retained = 0;
+
+    if( ( index == LORAMAC_RX_BUFFER_NONE ) || ( index != MacCtx.RxPoolIndication ) )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+
+    for( uint8_t i = 0; i < LORAMAC_RX_POOL_SIZE; i++ )
+    {
+        if( ( MacCtx.RxPoolRetained & ( 1 << i ) ) != 0 )
+        {
+            retained++;
+        }
+    }
+    // Keep one buffer for the radio
+    if( ( retained + 1 ) >= LORAMAC_RX_POOL_SIZE )
+    {
+        return LORAMAC_STATUS_BUSY;
+    }
+
+    MacCtx.RxPoolRetained |= ( 1 << index );
+    return LORAMAC_STATUS_OK;
+}
+
+LoRaMacStatus_t LoRaMacRxBufferRelease( uint8_t* buffer )
+{
+    uint8_t index = RxPoolFind( buffer );
+
+    if( ( index == LORAMAC_RX_BUFFER_NONE ) || ( ( MacCtx.RxPoolRetained & ( 1 << index ) ) == 0 ) )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+
+    CRITICAL_SECTION_BEGIN( );
+    MacCtx.RxPoolRetained &= ~( 1 << index );
+    if( index != MacCtx.RxPoolIndication )
+    {
+        RxPoolFree( index );
+    }
+    if( Radio.GetStatus( ) != RF_RX_RUNNING )
+    {
+        RxPoolFeedRadio( );
+    }
+    CRITICAL_SECTION_END( );
+    return LORAMAC_STATUS_OK;
+}
+
 void LoRaMacTestSetDutyCycleOn( bool enable )
 {
     VerifyParams_t verify;
 
     verify.DutyCycle = enable;
 
-    if( RegionVerify( MacCtx.NvmCtx->Region, &verify, PHY_DUTY_CYCLE ) == true )
+    if( MacCtx.RegionIf->Verify( &verify, PHY_DUTY_CYCLE ) == true )
     {
         MacCtx.NvmCtx->DutyCycleOn = enable;
     }
 }
+
+#if defined( LORAMAC_MULTI_INSTANCE )
+size_t LoRaMacGetInstanceCtxSize( void )
+{
+    return sizeof( LoRaMacInstanceCtx_t );
+}
+#endif
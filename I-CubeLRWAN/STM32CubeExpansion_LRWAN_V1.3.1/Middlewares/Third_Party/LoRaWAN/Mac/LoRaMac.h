@@ -172,6 +172,15 @@
  */
 #define LORAMAC_CRYPTO_MULTICAST_KEYS   127
 
+/*!
+ * Number of buffers the downlinks are received into, from 2 to 8. Each
+ * buffer retained by the application with \ref LoRaMacRxBufferRetain is
+ * lent to it until released, one buffer is always kept for the radio.
+ */
+#ifndef LORAMAC_RX_POOL_SIZE
+#define LORAMAC_RX_POOL_SIZE                        2
+#endif
+
 /*!
  * End-Device activation type
  */
@@ -877,6 +886,10 @@ typedef struct sMcpsIndication
     uint8_t FramePending;
     /*!
      * Pointer to the received data stream
+     *
+     * \remark Decrypted in place in the reception buffer, valid until the
+     *         indication callback returns unless retained with
+     *         \ref LoRaMacRxBufferRetain.
      */
     uint8_t* Buffer;
     /*!
@@ -2697,6 +2710,37 @@ LoRaMacStatus_t LoRaMacMlmeRequest( MlmeReq_t* mlmeRequest );
  */
 LoRaMacStatus_t LoRaMacMcpsRequest( McpsReq_t* mcpsRequest );
 
+/*!
+ * \brief   Keeps the reception buffer of the indicated frame after the
+ *          MCPS-Indication callback returns
+ *
+ * \details The frame stays in place and the buffer is removed from the MAC
+ *          reception buffers until \ref LoRaMacRxBufferRelease is called, so
+ *          the application can defer the processing of a downlink without
+ *          copying it. Only to be called from the MCPS-Indication callback.
+ *
+ * \param   [IN] buffer - McpsIndication.Buffer of the indicated frame.
+ *
+ * \retval  LoRaMacStatus_t Status of the operation. Possible returns are:
+ *          \ref LORAMAC_STATUS_OK,
+ *          \ref LORAMAC_STATUS_PARAMETER_INVALID when the frame is not in a
+ *          MAC reception buffer, e.g. when the radio driver doesn't support
+ *          Radio.SetRxBuffer. The application must copy the frame then.
+ *          \ref LORAMAC_STATUS_BUSY when no other buffer is left.
+ */
+LoRaMacStatus_t LoRaMacRxBufferRetain( uint8_t* buffer );
+
+/*!
+ * \brief   Gives back a reception buffer retained by \ref LoRaMacRxBufferRetain
+ *
+ * \param   [IN] buffer - Pointer passed to \ref LoRaMacRxBufferRetain.
+ *
+ * \retval  LoRaMacStatus_t Status of the operation. Possible returns are:
+ *          \ref LORAMAC_STATUS_OK,
+ *          \ref LORAMAC_STATUS_PARAMETER_INVALID.
+ */
+LoRaMacStatus_t LoRaMacRxBufferRelease( uint8_t* buffer );
+
 /*!
  * Automatically add the Region.h file at the end of LoRaMac.h file.
  * This is required because Region.h uses definitions from LoRaMac.h
@@ -25,6 +25,7 @@ Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ) and Daniel Jae
 #include "LoRaMacClassBConfig.h"
 #include "LoRaMacCrypto.h"
 #include "LoRaMacConfirmQueue.h"
+#include "LoRaMacInstance.h"
 
 #ifdef LORAMAC_CLASSB_ENABLED
 
@@ -149,6 +150,14 @@ typedef struct sLoRaMacClassBCtx
      */
     LoRaMacClassBNvmEvent LoRaMacClassBNvmEvent;
     /*!
+    * Rx configuration of the ping slots.
+    */
+    RxConfigParams_t PingSlotRxConfig;
+    /*!
+    * Rx configuration of the multicast slots.
+    */
+    RxConfigParams_t MulticastSlotRxConfig;
+    /*!
     * Non-volatile module context.
     */
     LoRaMacClassBNvmCtx_t* NvmCtx;
@@ -168,17 +177,34 @@ typedef union uLoRaMacClassBEvents
     }Events;
 }LoRaMacClassBEvents_t;
 
+#if defined( LORAMAC_MULTI_INSTANCE )
+/*
+ * Per-instance context of the module.
+ */
+typedef struct sLoRaMacClassBInstanceCtx
+{
+    LoRaMacClassBEvents_t LoRaMacClassBEvents;
+    LoRaMacClassBNvmCtx_t NvmClassBCtx;
+    LoRaMacClassBCtx_t Ctx;
+}LoRaMacClassBInstanceCtx_t;
+
+#define CLASS_B_INSTANCE_CTX                        ( ( LoRaMacClassBInstanceCtx_t* )LORAMAC_INSTANCE_MODULE_CTX( LORAMAC_INSTANCE_MODULE_CLASS_B ) )
+#define LoRaMacClassBEvents                         ( CLASS_B_INSTANCE_CTX->LoRaMacClassBEvents )
+#define NvmClassBCtx                                ( CLASS_B_INSTANCE_CTX->NvmClassBCtx )
+#define Ctx                                         ( CLASS_B_INSTANCE_CTX->Ctx )
+#else
 LoRaMacClassBEvents_t LoRaMacClassBEvents = { .Value = 0 };
 
 /*
  * Non-volatile module context.
  */
-static LoRaMacClassBNvmCtx_t NvmCtx;
+static LoRaMacClassBNvmCtx_t NvmClassBCtx;
 
 /*
  * Module context.
  */
 /*static*/ LoRaMacClassBCtx_t Ctx;
+#endif
 
 /*!
  * Computes the Ping Offset
@@ -447,7 +473,7 @@ static void InitClassB( void )
     LoRaMacClassBEvents.Value = 0;
 
     // Init variables to default
-    memset1( ( uint8_t* ) &NvmCtx, 0, sizeof( LoRaMacClassBNvmCtx_t ) );
+    memset1( ( uint8_t* ) &NvmClassBCtx, 0, sizeof( LoRaMacClassBNvmCtx_t ) );
     memset1( ( uint8_t* ) &Ctx.PingSlotCtx, 0, sizeof( PingSlotContext_t ) );
     memset1( ( uint8_t* ) &Ctx.BeaconCtx, 0, sizeof( BeaconContext_t ) );
 
@@ -609,7 +635,7 @@ void LoRaMacClassBInit( LoRaMacClassBParams_t *classBParams, LoRaMacClassBCallba
     Ctx.LoRaMacClassBParams = *classBParams;
 
     // Assign non-volatile context
-    Ctx.NvmCtx = &NvmCtx;
+    Ctx.NvmCtx = &NvmClassBCtx;
 
     // Assign callback
     Ctx.LoRaMacClassBNvmEvent = classBNvmCtxChanged;
@@ -618,6 +644,9 @@ void LoRaMacClassBInit( LoRaMacClassBParams_t *classBParams, LoRaMacClassBCallba
     TimerInit( &Ctx.BeaconTimer, LoRaMacClassBBeaconTimerEvent );
     TimerInit( &Ctx.PingSlotTimer, LoRaMacClassBPingSlotTimerEvent );
     TimerInit( &Ctx.MulticastSlotTimer, LoRaMacClassBMulticastSlotTimerEvent );
+    LORAMAC_INSTANCE_TIMER_BIND( &Ctx.BeaconTimer );
+    LORAMAC_INSTANCE_TIMER_BIND( &Ctx.PingSlotTimer );
+    LORAMAC_INSTANCE_TIMER_BIND( &Ctx.MulticastSlotTimer );
 
     InitClassB( );
 #endif // LORAMAC_CLASSB_ENABLED
@@ -629,7 +658,7 @@ bool LoRaMacClassBRestoreNvmCtx( void* classBNvmCtx )
     // Restore module context
     if( classBNvmCtx != NULL )
     {
-        memcpy1( ( uint8_t* ) &NvmCtx, ( uint8_t* ) classBNvmCtx, sizeof( NvmCtx ) );
+        memcpy1( ( uint8_t* ) &NvmClassBCtx, ( uint8_t* ) classBNvmCtx, sizeof( NvmClassBCtx ) );
         return true;
     }
     else
@@ -644,8 +673,8 @@ bool LoRaMacClassBRestoreNvmCtx( void* classBNvmCtx )
 void* LoRaMacClassBGetNvmCtx( size_t* classBNvmCtxSize )
 {
 #ifdef LORAMAC_CLASSB_ENABLED
-    *classBNvmCtxSize = sizeof( NvmCtx );
-    return &NvmCtx;
+    *classBNvmCtxSize = sizeof( NvmClassBCtx );
+    return &NvmClassBCtx;
 #else
     *classBNvmCtxSize = 0;
     return NULL;
@@ -718,6 +747,7 @@ bool LoRaMacClassBIsAcquisitionInProgress( void )
 void LoRaMacClassBBeaconTimerEvent( void* context )
 {
 #ifdef LORAMAC_CLASSB_ENABLED
+    LORAMAC_INSTANCE_SELECT( context );
     Ctx.BeaconCtx.TimeStamp = TimerGetCurrentTime( );
     TimerStop( &Ctx.BeaconTimer );
     LoRaMacClassBEvents.Events.Beacon = 1;
@@ -959,6 +989,7 @@ static void LoRaMacClassBProcessBeacon( void )
 void LoRaMacClassBPingSlotTimerEvent( void* context )
 {
 #ifdef LORAMAC_CLASSB_ENABLED
+    LORAMAC_INSTANCE_SELECT( context );
     LoRaMacClassBEvents.Events.PingSlot = 1;
 
     if( Ctx.LoRaMacClassBCallbacks.MacProcessNotify != NULL )
@@ -971,7 +1002,6 @@ void LoRaMacClassBPingSlotTimerEvent( void* context )
 #ifdef LORAMAC_CLASSB_ENABLED
 static void LoRaMacClassBProcessPingSlot( void )
 {
-    static RxConfigParams_t pingSlotRxConfig;
     TimerTime_t pingSlotTime = 0;
 
     switch( Ctx.PingSlotState )
@@ -997,12 +1027,12 @@ static void LoRaMacClassBProcessPingSlot( void )
                                                      Ctx.NvmCtx->PingSlotCtx.Datarate,
                                                      Ctx.LoRaMacClassBParams.LoRaMacParams->MinRxSymbols,
                                                      Ctx.LoRaMacClassBParams.LoRaMacParams->SystemMaxRxError,
-                                                     &pingSlotRxConfig );
-                    Ctx.PingSlotCtx.SymbolTimeout = pingSlotRxConfig.WindowTimeout;
+                                                     &Ctx.PingSlotRxConfig );
+                    Ctx.PingSlotCtx.SymbolTimeout = Ctx.PingSlotRxConfig.WindowTimeout;
 
-                    if( ( int32_t )pingSlotTime > pingSlotRxConfig.WindowOffset )
+                    if( ( int32_t )pingSlotTime > Ctx.PingSlotRxConfig.WindowOffset )
                     {// Apply the window offset
-                        pingSlotTime += pingSlotRxConfig.WindowOffset;
+                        pingSlotTime += Ctx.PingSlotRxConfig.WindowOffset;
                     }
                 }
 
@@ -1030,16 +1060,16 @@ static void LoRaMacClassBProcessPingSlot( void )
             {
                 Ctx.PingSlotState = PINGSLOT_STATE_RX;
 
-                pingSlotRxConfig.Datarate = Ctx.NvmCtx->PingSlotCtx.Datarate;
-                pingSlotRxConfig.DownlinkDwellTime = Ctx.LoRaMacClassBParams.LoRaMacParams->DownlinkDwellTime;
-                pingSlotRxConfig.RepeaterSupport = Ctx.LoRaMacClassBParams.LoRaMacParams->RepeaterSupport;
-                pingSlotRxConfig.Frequency = frequency;
-                pingSlotRxConfig.RxContinuous = false;
-                pingSlotRxConfig.RxSlot = RX_SLOT_WIN_CLASS_B_PING_SLOT;
+                Ctx.PingSlotRxConfig.Datarate = Ctx.NvmCtx->PingSlotCtx.Datarate;
+                Ctx.PingSlotRxConfig.DownlinkDwellTime = Ctx.LoRaMacClassBParams.LoRaMacParams->DownlinkDwellTime;
+                Ctx.PingSlotRxConfig.RepeaterSupport = Ctx.LoRaMacClassBParams.LoRaMacParams->RepeaterSupport;
+                Ctx.PingSlotRxConfig.Frequency = frequency;
+                Ctx.PingSlotRxConfig.RxContinuous = false;
+                Ctx.PingSlotRxConfig.RxSlot = RX_SLOT_WIN_CLASS_B_PING_SLOT;
 
-                RegionRxConfig( *Ctx.LoRaMacClassBParams.LoRaMacRegion, &pingSlotRxConfig, ( int8_t* )&Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate );
+                RegionRxConfig( *Ctx.LoRaMacClassBParams.LoRaMacRegion, &Ctx.PingSlotRxConfig, ( int8_t* )&Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate );
 
-                if( pingSlotRxConfig.RxContinuous == false )
+                if( Ctx.PingSlotRxConfig.RxContinuous == false )
                 {
                     Radio.Rx( Ctx.LoRaMacClassBParams.LoRaMacParams->MaxRxWindow );
                 }
@@ -1069,6 +1099,7 @@ static void LoRaMacClassBProcessPingSlot( void )
 void LoRaMacClassBMulticastSlotTimerEvent( void* context )
 {
 #ifdef LORAMAC_CLASSB_ENABLED
+    LORAMAC_INSTANCE_SELECT( context );
     LoRaMacClassBEvents.Events.MulticastSlot = 1;
 
     if( Ctx.LoRaMacClassBCallbacks.MacProcessNotify != NULL )
@@ -1081,7 +1112,6 @@ void LoRaMacClassBMulticastSlotTimerEvent( void* context )
 #ifdef LORAMAC_CLASSB_ENABLED
 static void LoRaMacClassBProcessMulticastSlot( void )
 {
-    static RxConfigParams_t multicastSlotRxConfig;
     TimerTime_t multicastSlotTime = 0;
     TimerTime_t slotTime = 0;
     MulticastCtx_t *cur = Ctx.LoRaMacClassBParams.MulticastChannels;
@@ -1143,13 +1173,13 @@ static void LoRaMacClassBProcessMulticastSlot( void )
                                                     Ctx.NvmCtx->PingSlotCtx.Datarate,
                                                     Ctx.LoRaMacClassBParams.LoRaMacParams->MinRxSymbols,
                                                     Ctx.LoRaMacClassBParams.LoRaMacParams->SystemMaxRxError,
-                                                    &multicastSlotRxConfig );
-                    Ctx.PingSlotCtx.SymbolTimeout = multicastSlotRxConfig.WindowTimeout;
+                                                    &Ctx.MulticastSlotRxConfig );
+                    Ctx.PingSlotCtx.SymbolTimeout = Ctx.MulticastSlotRxConfig.WindowTimeout;
                 }
 
-                if( ( int32_t )multicastSlotTime > multicastSlotRxConfig.WindowOffset )
+                if( ( int32_t )multicastSlotTime > Ctx.MulticastSlotRxConfig.WindowOffset )
                 {// Apply the window offset
-                    multicastSlotTime += multicastSlotRxConfig.WindowOffset;
+                    multicastSlotTime += Ctx.MulticastSlotRxConfig.WindowOffset;
                 }
 
                 // Start the timer if the ping slot time is in range
@@ -1184,14 +1214,14 @@ static void LoRaMacClassBProcessMulticastSlot( void )
 
             Ctx.MulticastSlotState = PINGSLOT_STATE_RX;
 
-            multicastSlotRxConfig.Datarate = Ctx.PingSlotCtx.NextMulticastChannel->ChannelParams.RxParams.ClassB.Datarate;
-            multicastSlotRxConfig.DownlinkDwellTime = Ctx.LoRaMacClassBParams.LoRaMacParams->DownlinkDwellTime;
-            multicastSlotRxConfig.RepeaterSupport = Ctx.LoRaMacClassBParams.LoRaMacParams->RepeaterSupport;
-            multicastSlotRxConfig.Frequency = frequency;
-            multicastSlotRxConfig.RxContinuous = false;
-            multicastSlotRxConfig.RxSlot = RX_SLOT_WIN_CLASS_B_MULTICAST_SLOT;
+            Ctx.MulticastSlotRxConfig.Datarate = Ctx.PingSlotCtx.NextMulticastChannel->ChannelParams.RxParams.ClassB.Datarate;
+            Ctx.MulticastSlotRxConfig.DownlinkDwellTime = Ctx.LoRaMacClassBParams.LoRaMacParams->DownlinkDwellTime;
+            Ctx.MulticastSlotRxConfig.RepeaterSupport = Ctx.LoRaMacClassBParams.LoRaMacParams->RepeaterSupport;
+            Ctx.MulticastSlotRxConfig.Frequency = frequency;
+            Ctx.MulticastSlotRxConfig.RxContinuous = false;
+            Ctx.MulticastSlotRxConfig.RxSlot = RX_SLOT_WIN_CLASS_B_MULTICAST_SLOT;
 
-            RegionRxConfig( *Ctx.LoRaMacClassBParams.LoRaMacRegion, &multicastSlotRxConfig, ( int8_t* )&Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate );
+            RegionRxConfig( *Ctx.LoRaMacClassBParams.LoRaMacRegion, &Ctx.MulticastSlotRxConfig, ( int8_t* )&Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate );
 
             if( Ctx.PingSlotState == PINGSLOT_STATE_RX )
             {
@@ -1202,7 +1232,7 @@ static void LoRaMacClassBProcessMulticastSlot( void )
                 TimerStart( &Ctx.PingSlotTimer );
             }
 
-            if( multicastSlotRxConfig.RxContinuous == false )
+            if( Ctx.MulticastSlotRxConfig.RxContinuous == false )
             {
                 Radio.Rx( Ctx.LoRaMacClassBParams.LoRaMacParams->MaxRxWindow );
             }
@@ -1765,3 +1795,14 @@ void LoRaMacClassBProcess( void )
     }
 #endif // LORAMAC_CLASSB_ENABLED
 }
+
+#if defined( LORAMAC_MULTI_INSTANCE )
+size_t LoRaMacClassBGetInstanceCtxSize( void )
+{
+#ifdef LORAMAC_CLASSB_ENABLED
+    return sizeof( LoRaMacClassBInstanceCtx_t );
+#else
+    return 0;
+#endif // LORAMAC_CLASSB_ENABLED
+}
+#endif
@@ -21,6 +21,7 @@ Maintainer: Miguel Luis ( Semtech ), Daniel Jaeckle ( STACKFORCE ), Johannes Bru
 #include "utilities.h"
 #include "LoRaMacCommands.h"
 #include "LoRaMacConfirmQueue.h"
+#include "LoRaMacInstance.h"
 
 /*!
  * Number of MAC Command slots
@@ -71,10 +72,17 @@ typedef struct sLoRaMacCommandsCtx
  */
 static LoRaMacCommandsNvmEvent CommandsNvmCtxChanged;
 
+#if defined( LORAMAC_MULTI_INSTANCE )
+/*!
+ * Non-volatile module context of the selected instance.
+ */
+#define NvmCtx                                      ( *( LoRaMacCommandsCtx_t* )LORAMAC_INSTANCE_MODULE_CTX( LORAMAC_INSTANCE_MODULE_COMMANDS ) )
+#else
 /*!
  * Non-volatile module context.
  */
 static LoRaMacCommandsCtx_t NvmCtx;
+#endif
 
 /* Memory management functions */
 
@@ -532,3 +540,10 @@ LoRaMacCommandStatus_t LoRaMacCommandsStickyCmdsPending( bool* cmdsPending )
 
     return LORAMAC_COMMANDS_SUCCESS;
 }
+
+#if defined( LORAMAC_MULTI_INSTANCE )
+size_t LoRaMacCommandsGetInstanceCtxSize( void )
+{
+    return sizeof( LoRaMacCommandsCtx_t );
+}
+#endif
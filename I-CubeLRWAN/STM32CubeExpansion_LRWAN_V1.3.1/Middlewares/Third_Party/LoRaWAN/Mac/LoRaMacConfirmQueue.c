@@ -25,6 +25,7 @@ Maintainer: Miguel Luis ( Semtech ), Gregory Cristian ( Semtech ) and Daniel Jae
 #include "utilities.h"
 #include "LoRaMac.h"
 #include "LoRaMacConfirmQueue.h"
+#include "LoRaMacInstance.h"
 
 
 /*
@@ -73,15 +74,30 @@ typedef struct sLoRaMacConfirmQueueCtx
     LoRaMacConfirmQueueNvmCtx_t* ConfirmQueueNvmCtx;
 } LoRaMacConfirmQueueCtx_t;
 
+#if defined( LORAMAC_MULTI_INSTANCE )
+/*
+ * Per-instance context of the module.
+ */
+typedef struct sLoRaMacConfirmQueueInstanceCtx
+{
+    LoRaMacConfirmQueueNvmCtx_t NvmConfirmQueueCtx;
+    LoRaMacConfirmQueueCtx_t ConfirmQueueCtx;
+}LoRaMacConfirmQueueInstanceCtx_t;
+
+#define CONFIRM_QUEUE_INSTANCE_CTX                  ( ( LoRaMacConfirmQueueInstanceCtx_t* )LORAMAC_INSTANCE_MODULE_CTX( LORAMAC_INSTANCE_MODULE_CONFIRM_QUEUE ) )
+#define NvmConfirmQueueCtx                          ( CONFIRM_QUEUE_INSTANCE_CTX->NvmConfirmQueueCtx )
+#define ConfirmQueueCtx                             ( CONFIRM_QUEUE_INSTANCE_CTX->ConfirmQueueCtx )
+#else
 /*
  * Non-volatile module context.
  */
-static LoRaMacConfirmQueueNvmCtx_t ConfirmQueueNvmCtx;
+static LoRaMacConfirmQueueNvmCtx_t NvmConfirmQueueCtx;
 
 /*
  * Module context.
  */
 static LoRaMacConfirmQueueCtx_t ConfirmQueueCtx;
+#endif
 
 static MlmeConfirmQueue_t* IncreaseBufferPointer( MlmeConfirmQueue_t* bufferPointer )
 {
@@ -136,7 +152,7 @@ void LoRaMacConfirmQueueInit( LoRaMacPrimitives_t* primitives, LoRaMacConfirmQue
     ConfirmQueueCtx.Primitives = primitives;
 
     // Assign nvm context
-    ConfirmQueueCtx.ConfirmQueueNvmCtx = &ConfirmQueueNvmCtx;
+    ConfirmQueueCtx.ConfirmQueueNvmCtx = &NvmConfirmQueueCtx;
 
     // Init counter
     ConfirmQueueCtx.ConfirmQueueNvmCtx->MlmeConfirmQueueCnt = 0;
@@ -159,7 +175,7 @@ bool LoRaMacConfirmQueueRestoreNvmCtx( void* confirmQueueNvmCtx )
     // Restore module context
     if( confirmQueueNvmCtx != NULL )
     {
-        memcpy1( ( uint8_t* )&ConfirmQueueNvmCtx, ( uint8_t* ) confirmQueueNvmCtx, sizeof( ConfirmQueueNvmCtx ) );
+        memcpy1( ( uint8_t* )&NvmConfirmQueueCtx, ( uint8_t* ) confirmQueueNvmCtx, sizeof( NvmConfirmQueueCtx ) );
         return true;
     }
     else
@@ -170,8 +186,8 @@ bool LoRaMacConfirmQueueRestoreNvmCtx( void* confirmQueueNvmCtx )
 
 void* LoRaMacConfirmQueueGetNvmCtx( size_t* confirmQueueNvmCtxSize )
 {
-    *confirmQueueNvmCtxSize = sizeof( ConfirmQueueNvmCtx );
-    return &ConfirmQueueNvmCtx;
+    *confirmQueueNvmCtxSize = sizeof( NvmConfirmQueueCtx );
+    return &NvmConfirmQueueCtx;
 }
 
 bool LoRaMacConfirmQueueAdd( MlmeConfirmQueue_t* mlmeConfirm )
@@ -342,3 +358,10 @@ bool LoRaMacConfirmQueueIsFull( void )
         return false;
     }
 }
+
+#if defined( LORAMAC_MULTI_INSTANCE )
+size_t LoRaMacConfirmQueueGetInstanceCtxSize( void )
+{
+    return sizeof( LoRaMacConfirmQueueInstanceCtx_t );
+}
+#endif
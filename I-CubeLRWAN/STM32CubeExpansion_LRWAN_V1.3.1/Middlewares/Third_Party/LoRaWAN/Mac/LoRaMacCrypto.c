@@ -40,6 +40,7 @@
 #include "LoRaMacParser.h"
 #include "LoRaMacSerializer.h"
 #include "LoRaMacCrypto.h"
+#include "LoRaMacInstance.h"
 
 /*!
  * Indicates if LoRaWAN 1.1.x crypto scheme is enabled
@@ -230,6 +231,20 @@ typedef struct sKeyAddr
     KeyIdentifier_t RootKey;
 }KeyAddr_t;
 
+#if defined( LORAMAC_MULTI_INSTANCE )
+/*
+ * Per-instance context of the module.
+ */
+typedef struct sLoRaMacCryptoInstanceCtx
+{
+    LoRaMacCryptoCtx_t CryptoCtx;
+    LoRaMacCryptoNvmCtx_t NvmCryptoCtx;
+}LoRaMacCryptoInstanceCtx_t;
+
+#define CRYPTO_INSTANCE_CTX                         ( ( LoRaMacCryptoInstanceCtx_t* )LORAMAC_INSTANCE_MODULE_CTX( LORAMAC_INSTANCE_MODULE_CRYPTO ) )
+#define CryptoCtx                                   ( CRYPTO_INSTANCE_CTX->CryptoCtx )
+#define NvmCryptoCtx                                ( CRYPTO_INSTANCE_CTX->NvmCryptoCtx )
+#else
 /*
  *Crypto module context.
  */
@@ -239,6 +254,7 @@ static LoRaMacCryptoCtx_t CryptoCtx;
  * Non volatile module context.
  */
 static LoRaMacCryptoNvmCtx_t NvmCryptoCtx;
+#endif
 
 /*
  * Key-Address list
@@ -274,9 +290,6 @@ static LoRaMacCryptoStatus_t PayloadEncrypt( uint8_t* buffer, int16_t size, KeyI
         return LORAMAC_CRYPTO_ERROR_NPE;
     }
 
-    uint8_t bufferIndex = 0;
-    uint16_t ctr = 1;
-    uint8_t sBlock[16] = { 0 };
     uint8_t aBlock[16] = { 0 };
 
     aBlock[0] = 0x01;
@@ -293,21 +306,14 @@ static LoRaMacCryptoStatus_t PayloadEncrypt( uint8_t* buffer, int16_t size, KeyI
     aBlock[12] = ( frameCounter >> 16 ) & 0xFF;
     aBlock[13] = ( frameCounter >> 24 ) & 0xFF;
 
-    while( size > 0 )
+    aBlock[15] = 0x01;
+
+    if( size > 0 )
     {
-        aBlock[15] = ctr & 0xFF;
-        ctr++;
-        if( SecureElementAesEncrypt( aBlock, 16, keyID, sBlock ) != SECURE_ELEMENT_SUCCESS )
+        if( SecureElementAesCtrEncrypt( aBlock, buffer, size, keyID ) != SECURE_ELEMENT_SUCCESS )
         {
             return LORAMAC_CRYPTO_ERROR_SECURE_ELEMENT_FUNC;
         }
-
-        for( uint8_t i = 0; i < ( ( size > 16 ) ? 16 : size ); i++ )
-        {
-            buffer[bufferIndex + i] = buffer[bufferIndex + i] ^ sBlock[i];
-        }
-        size -= 16;
-        bufferIndex += 16;
     }
 
     return LORAMAC_CRYPTO_SUCCESS;
@@ -332,8 +338,6 @@ static LoRaMacCryptoStatus_t FOptsEncrypt( uint16_t size, uint32_t address, uint
         return LORAMAC_CRYPTO_ERROR_NPE;
     }
 
-    uint8_t bufferIndex = 0;
-    uint8_t sBlock[16] = { 0 };
     uint8_t aBlock[16] = { 0 };
 
     aBlock[0] = 0x01;
@@ -383,14 +387,10 @@ static LoRaMacCryptoStatus_t FOptsEncrypt( uint16_t size, uint32_t address, uint
 
     if( size > 0 )
     {
-        if( SecureElementAesEncrypt( aBlock, 16, NWK_S_ENC_KEY, sBlock ) != SECURE_ELEMENT_SUCCESS )
+        if( SecureElementAesCtrEncrypt( aBlock, buffer, size, NWK_S_ENC_KEY ) != SECURE_ELEMENT_SUCCESS )
         {
             return LORAMAC_CRYPTO_ERROR_SECURE_ELEMENT_FUNC;
         }
-        for( uint8_t i = 0; i < size; i++ )
-        {
-            buffer[bufferIndex + i] = buffer[bufferIndex + i] ^ sBlock[i];
-        }
     }
 
     return LORAMAC_CRYPTO_SUCCESS;
@@ -1696,3 +1696,10 @@ LoRaMacCryptoStatus_t LoRaMacCryptoDeriveMcSessionKeyPair( AddressIdentifier_t a
 
     return LORAMAC_CRYPTO_SUCCESS;
 }
+
+#if defined( LORAMAC_MULTI_INSTANCE )
+size_t LoRaMacCryptoGetInstanceCtxSize( void )
+{
+    return sizeof( LoRaMacCryptoInstanceCtx_t );
+}
+#endif
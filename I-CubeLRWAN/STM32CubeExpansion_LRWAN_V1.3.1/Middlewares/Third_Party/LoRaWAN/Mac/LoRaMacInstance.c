@@ -0,0 +1,184 @@
+/******************************************************************************
+  * @file    LoRaMacInstance.c
+  * @author  MCD Application Team
+  * @brief   LoRaMac multi-instance contexts
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+#include "utilities.h"
+#include "region/Region.h"
+#include "LoRaMacInstance.h"
+
+#if defined( LORAMAC_MULTI_INSTANCE )
+
+/*!
+ * Alignment of the module contexts in the instance buffer
+ */
+#define LORAMAC_INSTANCE_CTX_ALIGN( size )          ( ( ( size ) + 7 ) & ~( ( size_t )7 ) )
+
+LoRaMacInstance_t* LoRaMacInstanceCurrent = NULL;
+
+/*!
+ * \brief Fills the size of the context of each module
+ *
+ * \param [IN]  region - LoRaWAN region
+ * \param [OUT] sizes  - Context size of each module
+ *
+ * \retval false if the region is not supported
+ */
+static bool GetModuleCtxSizes( LoRaMacRegion_t region, size_t* sizes )
+{
+    LoRaMacInstance_t probe = { 0 };
+    LoRaMacInstance_t* current = LoRaMacInstanceCurrent;
+    GetNvmCtxParams_t getNvmCtx;
+
+    if( RegionIsActive( region ) == false )
+    {
+        return false;
+    }
+
+    sizes[LORAMAC_INSTANCE_MODULE_MAC] = LoRaMacGetInstanceCtxSize( );
+    sizes[LORAMAC_INSTANCE_MODULE_CRYPTO] = LoRaMacCryptoGetInstanceCtxSize( );
+    sizes[LORAMAC_INSTANCE_MODULE_SECURE_ELEMENT] = SecureElementGetInstanceCtxSize( );
+    sizes[LORAMAC_INSTANCE_MODULE_COMMANDS] = LoRaMacCommandsGetInstanceCtxSize( );
+    sizes[LORAMAC_INSTANCE_MODULE_CONFIRM_QUEUE] = LoRaMacConfirmQueueGetInstanceCtxSize( );
+    sizes[LORAMAC_INSTANCE_MODULE_CLASS_B] = LoRaMacClassBGetInstanceCtxSize( );
+
+    // The region only reports its size through RegionGetNvmCtx, which needs a
+    // selected instance. The probe has no context, nothing is dereferenced.
+    getNvmCtx.nvmCtxSize = 0;
+    LoRaMacInstanceCurrent = &probe;
+    RegionGetNvmCtx( region, &getNvmCtx );
+    LoRaMacInstanceCurrent = current;
+    sizes[LORAMAC_INSTANCE_MODULE_REGION] = getNvmCtx.nvmCtxSize;
+
+    return true;
+}
+
+size_t LoRaMacInstanceGetSize( LoRaMacRegion_t region )
+{
+    size_t sizes[LORAMAC_INSTANCE_MODULE_NUMBER];
+    size_t size = 0;
+
+    if( GetModuleCtxSizes( region, sizes ) == false )
+    {
+        return 0;
+    }
+    for( uint8_t i = 0; i < LORAMAC_INSTANCE_MODULE_NUMBER; i++ )
+    {
+        size += LORAMAC_INSTANCE_CTX_ALIGN( sizes[i] );
+    }
+    return size;
+}
+
+LoRaMacStatus_t LoRaMacInstanceInit( LoRaMacInstance_t* instance, LoRaMacRegion_t region, void* buffer, size_t size )
+{
+    size_t sizes[LORAMAC_INSTANCE_MODULE_NUMBER];
+    uint8_t* ctx = ( uint8_t* )buffer;
+
+    if( ( instance == NULL ) || ( buffer == NULL ) || ( ( ( uintptr_t )buffer & 7 ) != 0 ) )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+    if( GetModuleCtxSizes( region, sizes ) == false )
+    {
+        return LORAMAC_STATUS_REGION_NOT_SUPPORTED;
+    }
+    if( size < LoRaMacInstanceGetSize( region ) )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+
+    // Same initial state as the file-static contexts of a single instance
+    memset1( ctx, 0, size );
+    for( uint8_t i = 0; i < LORAMAC_INSTANCE_MODULE_NUMBER; i++ )
+    {
+        instance->ModuleCtx[i] = ctx;
+        ctx += LORAMAC_INSTANCE_CTX_ALIGN( sizes[i] );
+    }
+    instance->Radio = NULL;
+
+    LoRaMacInstanceSelect( instance );
+    return LORAMAC_STATUS_OK;
+}
+
+void LoRaMacInstanceSetRadio( LoRaMacInstance_t* instance, void* radio )
+{
+    instance->Radio = radio;
+}
+
+void LoRaMacInstanceSelect( LoRaMacInstance_t* instance )
+{
+    LoRaMacInstanceCurrent = instance;
+}
+
+LoRaMacInstance_t* LoRaMacInstanceGetCurrent( void )
+{
+    return LoRaMacInstanceCurrent;
+}
+
+LoRaMacStatus_t LoRaMacInstanceInitialization( LoRaMacInstance_t* instance, LoRaMacPrimitives_t* primitives, LoRaMacCallback_t* callbacks, LoRaMacRegion_t region )
+{
+    LoRaMacInstanceSelect( instance );
+    return LoRaMacInitialization( primitives, callbacks, region );
+}
+
+LoRaMacStatus_t LoRaMacInstanceStart( LoRaMacInstance_t* instance )
+{
+    LoRaMacInstanceSelect( instance );
+    return LoRaMacStart( );
+}
+
+LoRaMacStatus_t LoRaMacInstanceStop( LoRaMacInstance_t* instance )
+{
+    LoRaMacInstanceSelect( instance );
+    return LoRaMacStop( );
+}
+
+void LoRaMacInstanceProcess( LoRaMacInstance_t* instance )
+{
+    LoRaMacInstanceSelect( instance );
+    LoRaMacProcess( );
+}
+
+LoRaMacStatus_t LoRaMacInstanceQueryTxPossible( LoRaMacInstance_t* instance, uint8_t size, LoRaMacTxInfo_t* txInfo )
+{
+    LoRaMacInstanceSelect( instance );
+    return LoRaMacQueryTxPossible( size, txInfo );
+}
+
+LoRaMacStatus_t LoRaMacInstanceMibGetRequestConfirm( LoRaMacInstance_t* instance, MibRequestConfirm_t* mibGet )
+{
+    LoRaMacInstanceSelect( instance );
+    return LoRaMacMibGetRequestConfirm( mibGet );
+}
+
+LoRaMacStatus_t LoRaMacInstanceMibSetRequestConfirm( LoRaMacInstance_t* instance, MibRequestConfirm_t* mibSet )
+{
+    LoRaMacInstanceSelect( instance );
+    return LoRaMacMibSetRequestConfirm( mibSet );
+}
+
+LoRaMacStatus_t LoRaMacInstanceMlmeRequest( LoRaMacInstance_t* instance, MlmeReq_t* mlmeRequest )
+{
+    LoRaMacInstanceSelect( instance );
+    return LoRaMacMlmeRequest( mlmeRequest );
+}
+
+LoRaMacStatus_t LoRaMacInstanceMcpsRequest( LoRaMacInstance_t* instance, McpsReq_t* mcpsRequest )
+{
+    LoRaMacInstanceSelect( instance );
+    return LoRaMacMcpsRequest( mcpsRequest );
+}
+
+#endif /* LORAMAC_MULTI_INSTANCE */
@@ -0,0 +1,268 @@
+/******************************************************************************
+  * @file    LoRaMacInstance.h
+  * @author  MCD Application Team
+  * @brief   LoRaMac multi-instance contexts
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+/*!
+ * \defgroup  LORAMACINSTANCE LoRa MAC multi-instance contexts
+ *            By default every module of the stack (LoRaMac, LoRaMacCrypto,
+ *            LoRaMacCommands, LoRaMacConfirmQueue, LoRaMacClassB, the secure
+ *            element and the regions) keeps its state in file-static contexts,
+ *            so a firmware image runs exactly one end-device.
+ *
+ *            When LORAMAC_MULTI_INSTANCE is defined these contexts are carried
+ *            by a \ref LoRaMacInstance_t object instead. Each instance owns a
+ *            buffer of \ref LoRaMacInstanceGetSize bytes holding the state of
+ *            all modules, and the stack works on the instance selected with
+ *            \ref LoRaMacInstanceSelect. This allows a host build to run
+ *            thousands of end-devices in a single process, e.g. to load-test a
+ *            network server with the real stack.
+ *
+ *            The LoRaMacInstanceXxx wrappers select the instance and call the
+ *            matching LoRaMac API. Timer events select the instance which owns
+ *            the timer before running. Radio events are routed the same way
+ *            through the radio handle of each instance, see
+ *            \ref LoRaMacInstanceSetRadio: a driver able to run several radios
+ *            (e.g. the simulated radio) works on the radio of the selected
+ *            instance and selects the instance owning a radio before raising
+ *            its events. The radio keeps receiving in its own buffer, the
+ *            frames can't be retained with \ref LoRaMacRxBufferRetain.
+ *            The MAC primitives and callbacks are called with the instance
+ *            selected, so the application can retrieve it with
+ *            \ref LoRaMacInstanceGetCurrent.
+ *
+ *            The instance switch is not protected against interrupts: in this
+ *            mode all the stack events must be raised from the same context.
+ * \{
+ */
+#ifndef __LORAMAC_INSTANCE_H__
+#define __LORAMAC_INSTANCE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "LoRaMac.h"
+
+#if defined( LORAMAC_MULTI_INSTANCE )
+
+/*!
+ * Modules of the stack having a per-instance context
+ */
+typedef enum eLoRaMacInstanceModule
+{
+    /*!
+     * LoRaMac context
+     */
+    LORAMAC_INSTANCE_MODULE_MAC,
+    /*!
+     * LoRaMacCrypto context
+     */
+    LORAMAC_INSTANCE_MODULE_CRYPTO,
+    /*!
+     * Secure element context
+     */
+    LORAMAC_INSTANCE_MODULE_SECURE_ELEMENT,
+    /*!
+     * LoRaMacCommands context
+     */
+    LORAMAC_INSTANCE_MODULE_COMMANDS,
+    /*!
+     * LoRaMacConfirmQueue context
+     */
+    LORAMAC_INSTANCE_MODULE_CONFIRM_QUEUE,
+    /*!
+     * LoRaMacClassB context
+     */
+    LORAMAC_INSTANCE_MODULE_CLASS_B,
+    /*!
+     * Context of the active region
+     */
+    LORAMAC_INSTANCE_MODULE_REGION,
+    /*!
+     * Number of modules
+     */
+    LORAMAC_INSTANCE_MODULE_NUMBER
+}LoRaMacInstanceModule_t;
+
+/*!
+ * LoRaMac instance
+ */
+typedef struct sLoRaMacInstance
+{
+    /*!
+     * Context of each module, located in the instance buffer
+     */
+    void* ModuleCtx[LORAMAC_INSTANCE_MODULE_NUMBER];
+    /*!
+     * Radio of the instance, given to the radio driver. NULL when the
+     * instances share the radio of the driver.
+     */
+    void* Radio;
+}LoRaMacInstance_t;
+
+/*!
+ * Currently selected instance
+ *
+ * \remark Only to be used through \ref LORAMAC_INSTANCE_MODULE_CTX
+ */
+extern LoRaMacInstance_t* LoRaMacInstanceCurrent;
+
+/*!
+ * Context of a module for the selected instance
+ */
+#define LORAMAC_INSTANCE_MODULE_CTX( module )       ( LoRaMacInstanceCurrent->ModuleCtx[( module )] )
+
+/*!
+ * Selects the instance passed as timer context. The handlers called directly
+ * by the MAC get a NULL context and keep the selected instance.
+ */
+#define LORAMAC_INSTANCE_SELECT( context )          do { if( ( context ) != NULL ) { LoRaMacInstanceSelect( ( LoRaMacInstance_t* )( context ) ); } } while( 0 )
+
+/*!
+ * Binds a timer to the selected instance
+ */
+#define LORAMAC_INSTANCE_TIMER_BIND( timer )        TimerSetContext( ( timer ), LoRaMacInstanceCurrent )
+
+/*!
+ * \brief   Returns the size of the buffer holding the module contexts of one
+ *          instance
+ *
+ * \param   [IN] region - LoRaWAN region the instance will use
+ *
+ * \retval  Buffer size in bytes, 0 if the region is not supported
+ */
+size_t LoRaMacInstanceGetSize( LoRaMacRegion_t region );
+
+/*!
+ * \brief   Initializes an instance and selects it
+ *
+ * \details The module contexts are cleared and located in the buffer, the
+ *          stack itself is initialized by \ref LoRaMacInstanceInitialization.
+ *
+ * \param   [IN] instance - Instance to initialize
+ *
+ * \param   [IN] region - LoRaWAN region the instance will use
+ *
+ * \param   [IN] buffer - Buffer holding the module contexts, aligned on 8 bytes
+ *
+ * \param   [IN] size - Size of the buffer, see \ref LoRaMacInstanceGetSize
+ *
+ * \retval  Possible returns are:
+ *          \ref LORAMAC_STATUS_OK,
+ *          \ref LORAMAC_STATUS_PARAMETER_INVALID,
+ *          \ref LORAMAC_STATUS_REGION_NOT_SUPPORTED.
+ */
+LoRaMacStatus_t LoRaMacInstanceInit( LoRaMacInstance_t* instance, LoRaMacRegion_t region, void* buffer, size_t size );
+
+/*!
+ * \brief   Binds a radio to an instance
+ *
+ * \details The radio driver works on the radio of the selected instance, and
+ *          routes the events of a radio to the instance which initialized it.
+ *          To be called between \ref LoRaMacInstanceInit and
+ *          \ref LoRaMacInstanceInitialization, which initializes the radio.
+ *
+ * \param   [IN] instance - Initialized instance
+ *
+ * \param   [IN] radio - Radio handle of the driver, e.g. a SimRadio_t
+ */
+void LoRaMacInstanceSetRadio( LoRaMacInstance_t* instance, void* radio );
+
+/*!
+ * \brief   Selects the instance the stack works on
+ *
+ * \param   [IN] instance - Initialized instance
+ */
+void LoRaMacInstanceSelect( LoRaMacInstance_t* instance );
+
+/*!
+ * \brief   Returns the selected instance
+ *
+ * \retval  Selected instance
+ */
+LoRaMacInstance_t* LoRaMacInstanceGetCurrent( void );
+
+/*!
+ * \brief   LoRaMacInitialization on an instance initialized by
+ *          \ref LoRaMacInstanceInit, with the same region
+ */
+LoRaMacStatus_t LoRaMacInstanceInitialization( LoRaMacInstance_t* instance, LoRaMacPrimitives_t* primitives, LoRaMacCallback_t* callbacks, LoRaMacRegion_t region );
+
+/*!
+ * \brief   LoRaMacStart on an instance
+ */
+LoRaMacStatus_t LoRaMacInstanceStart( LoRaMacInstance_t* instance );
+
+/*!
+ * \brief   LoRaMacStop on an instance
+ */
+LoRaMacStatus_t LoRaMacInstanceStop( LoRaMacInstance_t* instance );
+
+/*!
+ * \brief   LoRaMacProcess on an instance
+ */
+void LoRaMacInstanceProcess( LoRaMacInstance_t* instance );
+
+/*!
+ * \brief   LoRaMacQueryTxPossible on an instance
+ */
+LoRaMacStatus_t LoRaMacInstanceQueryTxPossible( LoRaMacInstance_t* instance, uint8_t size, LoRaMacTxInfo_t* txInfo );
+
+/*!
+ * \brief   LoRaMacMibGetRequestConfirm on an instance
+ */
+LoRaMacStatus_t LoRaMacInstanceMibGetRequestConfirm( LoRaMacInstance_t* instance, MibRequestConfirm_t* mibGet );
+
+/*!
+ * \brief   LoRaMacMibSetRequestConfirm on an instance
+ */
+LoRaMacStatus_t LoRaMacInstanceMibSetRequestConfirm( LoRaMacInstance_t* instance, MibRequestConfirm_t* mibSet );
+
+/*!
+ * \brief   LoRaMacMlmeRequest on an instance
+ */
+LoRaMacStatus_t LoRaMacInstanceMlmeRequest( LoRaMacInstance_t* instance, MlmeReq_t* mlmeRequest );
+
+/*!
+ * \brief   LoRaMacMcpsRequest on an instance
+ */
+LoRaMacStatus_t LoRaMacInstanceMcpsRequest( LoRaMacInstance_t* instance, McpsReq_t* mcpsRequest );
+
+/*
+ * Size of the per-instance context of each module, used by
+ * LoRaMacInstanceGetSize. The region context is its non-volatile context.
+ */
+size_t LoRaMacGetInstanceCtxSize( void );
+
+size_t LoRaMacCryptoGetInstanceCtxSize( void );
+
+size_t SecureElementGetInstanceCtxSize( void );
+
+size_t LoRaMacCommandsGetInstanceCtxSize( void );
+
+size_t LoRaMacConfirmQueueGetInstanceCtxSize( void );
+
+size_t LoRaMacClassBGetInstanceCtxSize( void );
+
+#else
+
+#define LORAMAC_INSTANCE_SELECT( context )
+#define LORAMAC_INSTANCE_TIMER_BIND( timer )
+
+#endif /* LORAMAC_MULTI_INSTANCE */
+
+/*! \} defgroup LORAMACINSTANCE */
+
+#endif /* __LORAMAC_INSTANCE_H__ */
@@ -105,9 +105,18 @@ LoRaMacParserStatus_t LoRaMacParserData( LoRaMacMessageData_t* macMsg )
         macMsg->FPort = macMsg->Buffer[bufItr++];
 
         macMsg->FRMPayloadSize = ( macMsg->BufSize - bufItr - LORAMAC_MIC_FIELD_SIZE );
+    }
+
+    if( ( macMsg->FRMPayload == 0 ) || ( macMsg->FRMPayload == &macMsg->Buffer[bufItr] ) )
+    {
+        // The payload is left in place in the serialized message
+        macMsg->FRMPayload = &macMsg->Buffer[bufItr];
+    }
+    else
+    {
         memcpy1( macMsg->FRMPayload, &macMsg->Buffer[bufItr], macMsg->FRMPayloadSize );
-        bufItr = bufItr + macMsg->FRMPayloadSize;
     }
+    bufItr = bufItr + macMsg->FRMPayloadSize;
 
     macMsg->MIC = ( uint32_t ) macMsg->Buffer[( macMsg->BufSize - LORAMAC_MIC_FIELD_SIZE )];
     macMsg->MIC |= ( ( uint32_t ) macMsg->Buffer[( macMsg->BufSize - LORAMAC_MIC_FIELD_SIZE ) + 1] << 8 );
@@ -75,6 +75,9 @@ LoRaMacParserStatus_t LoRaMacParserJoinAccept( LoRaMacMessageJoinAccept_t *macMs
 /*!
  * Parse a serialized data message and fills the structured object.
  *
+ * \remark The frame payload is copied to macMsg->FRMPayload. When it is NULL
+ *         it is pointed to the payload within macMsg->Buffer instead.
+ *
  * \param[IN/OUT] macMsg       - Data message object
  * \retval                     - Status of the operation
  */
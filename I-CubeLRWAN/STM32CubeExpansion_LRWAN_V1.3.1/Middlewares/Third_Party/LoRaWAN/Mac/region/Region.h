@@ -1360,6 +1360,119 @@ typedef struct sRxBeaconSetupParams
 
 
 
+/*!
+ * Region interface, functions of one region. The MAC selects it once with
+ * \ref RegionGetInterface and calls the region directly on its hot paths
+ * instead of dispatching on the region at every call.
+ *
+ * The functions are documented with their RegionXxx counterpart, without the
+ * region parameter.
+ */
+typedef struct sRegionInterface
+{
+    /*!
+     * \ref RegionGetPhyParam
+     */
+    PhyParam_t ( *GetPhyParam )( GetPhyParams_t* getPhy );
+    /*!
+     * \ref RegionSetBandTxDone
+     */
+    void ( *SetBandTxDone )( SetBandTxDoneParams_t* txDone );
+    /*!
+     * \ref RegionInitDefaults
+     */
+    void ( *InitDefaults )( InitDefaultsParams_t* params );
+    /*!
+     * \ref RegionGetNvmCtx
+     */
+    void* ( *GetNvmCtx )( GetNvmCtxParams_t* params );
+    /*!
+     * \ref RegionVerify
+     */
+    bool ( *Verify )( VerifyParams_t* verify, PhyAttribute_t phyAttribute );
+    /*!
+     * \ref RegionApplyCFList
+     */
+    void ( *ApplyCFList )( ApplyCFListParams_t* applyCFList );
+    /*!
+     * \ref RegionChanMaskSet
+     */
+    bool ( *ChanMaskSet )( ChanMaskSetParams_t* chanMaskSet );
+    /*!
+     * \ref RegionComputeRxWindowParameters
+     */
+    void ( *ComputeRxWindowParameters )( int8_t datarate, uint8_t minRxSymbols, uint32_t rxError, RxConfigParams_t *rxConfigParams );
+    /*!
+     * \ref RegionRxConfig
+     */
+    bool ( *RxConfig )( RxConfigParams_t* rxConfig, int8_t* datarate );
+    /*!
+     * \ref RegionTxConfig
+     */
+    bool ( *TxConfig )( TxConfigParams_t* txConfig, int8_t* txPower, TimerTime_t* txTimeOnAir );
+    /*!
+     * \ref RegionLinkAdrReq
+     */
+    uint8_t ( *LinkAdrReq )( LinkAdrReqParams_t* linkAdrReq, int8_t* drOut, int8_t* txPowOut, uint8_t* nbRepOut, uint8_t* nbBytesParsed );
+    /*!
+     * \ref RegionRxParamSetupReq
+     */
+    uint8_t ( *RxParamSetupReq )( RxParamSetupReqParams_t* rxParamSetupReq );
+    /*!
+     * \ref RegionNewChannelReq
+     */
+    uint8_t ( *NewChannelReq )( NewChannelReqParams_t* newChannelReq );
+    /*!
+     * \ref RegionTxParamSetupReq
+     */
+    int8_t ( *TxParamSetupReq )( TxParamSetupReqParams_t* txParamSetupReq );
+    /*!
+     * \ref RegionDlChannelReq
+     */
+    uint8_t ( *DlChannelReq )( DlChannelReqParams_t* dlChannelReq );
+    /*!
+     * \ref RegionAlternateDr
+     */
+    int8_t ( *AlternateDr )( int8_t currentDr, AlternateDrType_t type );
+    /*!
+     * \ref RegionCalcBackOff
+     */
+    void ( *CalcBackOff )( CalcBackOffParams_t* calcBackOff );
+    /*!
+     * \ref RegionNextChannel
+     */
+    LoRaMacStatus_t ( *NextChannel )( NextChanParams_t* nextChanParams, uint8_t* channel, TimerTime_t* time, TimerTime_t* aggregatedTimeOff );
+    /*!
+     * \ref RegionChannelAdd
+     */
+    LoRaMacStatus_t ( *ChannelAdd )( ChannelAddParams_t* channelAdd );
+    /*!
+     * \ref RegionChannelsRemove
+     */
+    bool ( *ChannelsRemove )( ChannelRemoveParams_t* channelRemove );
+    /*!
+     * \ref RegionSetContinuousWave
+     */
+    void ( *SetContinuousWave )( ContinuousWaveParams_t* continuousWave );
+    /*!
+     * \ref RegionApplyDrOffset
+     */
+    uint8_t ( *ApplyDrOffset )( uint8_t downlinkDwellTime, int8_t dr, int8_t drOffset );
+    /*!
+     * \ref RegionRxBeaconSetup
+     */
+    void ( *RxBeaconSetup )( RxBeaconSetup_t* rxBeaconSetup, uint8_t* outDr );
+}RegionInterface_t;
+
+/*!
+ * \brief Returns the interface of a region.
+ *
+ * \param [IN] region LoRaWAN region.
+ *
+ * \retval Region interface, NULL if the region is not supported.
+ */
+const RegionInterface_t* RegionGetInterface( LoRaMacRegion_t region );
+
 /*!
  * \brief The function verifies if a region is active or not. If a region
  *        is not active, it cannot be used.
@@ -33,6 +33,7 @@
 #include "RegionCommon.h"
 #include "RegionAU915.h"
 #include "util_console.h"
+#include "LoRaMacInstance.h"
 
 // Definitions
 #define CHANNELS_MASK_SIZE              6
@@ -65,12 +66,27 @@ typedef struct sRegionAU915NvmCtx
      * LoRaMac channels default mask
      */
     uint16_t ChannelsDefaultMask[ CHANNELS_MASK_SIZE ];
+    /*!
+     * Channels supporting each datarate, indexed by the datarate
+     */
+    uint16_t ChannelsDrMask[ AU915_TX_MAX_DATARATE + 1 ][ CHANNELS_MASK_SIZE ];
+    /*!
+     * Counts the number of data rate alternations
+     */
+    int8_t AlternateDrCounter;
 }RegionAU915NvmCtx_t;
 
+#if defined( LORAMAC_MULTI_INSTANCE )
+/*
+ * Non-volatile module context of the selected instance.
+ */
+#define NvmCtx                                      ( *( RegionAU915NvmCtx_t* )LORAMAC_INSTANCE_MODULE_CTX( LORAMAC_INSTANCE_MODULE_REGION ) )
+#else
 /*
  * Non-volatile module context.
  */
 static RegionAU915NvmCtx_t NvmCtx;
+#endif
 
 // Static functions
 static int8_t GetNextLowerTxDr( int8_t dr, int8_t minDr )
@@ -141,38 +157,15 @@ static bool VerifyRfFreq( uint32_t freq )
     return true;
 }
 
-static uint8_t CountNbOfEnabledChannels( uint8_t datarate, uint16_t* channelsMask, ChannelParams_t* channels, Band_t* bands, uint8_t* enabledChannels, uint8_t* delayTx )
+static uint8_t CountNbOfEnabledChannels( uint8_t datarate, uint16_t* channelsMask, ChannelParams_t* channels, Band_t* bands, uint16_t* availableMask, uint8_t* delayTx )
 {
-    uint8_t nbEnabledChannels = 0;
-    uint8_t delayTransmission = 0;
-
-    for( uint8_t i = 0, k = 0; i < AU915_MAX_NB_CHANNELS; i += 16, k++ )
-    {
-        for( uint8_t j = 0; j < 16; j++ )
-        {
-            if( ( channelsMask[k] & ( 1 << j ) ) != 0 )
-            {
-                if( channels[i + j].Frequency == 0 )
-                { // Check if the channel is enabled
-                    continue;
-                }
-                if( RegionCommonValueInRange( datarate, channels[i + j].DrRange.Fields.Min,
-                                              channels[i + j].DrRange.Fields.Max ) == false )
-                { // Check if the current channel selection supports the given datarate
-                    continue;
-                }
-                if( bands[channels[i + j].Band].TimeOff > 0 )
-                { // Check if the band is available for transmission
-                    delayTransmission++;
-                    continue;
-                }
-                enabledChannels[nbEnabledChannels++] = i + j;
-            }
-        }
+    if( datarate > AU915_TX_MAX_DATARATE )
+    { // No channel supports the datarate
+        *delayTx = 0;
+        return 0;
     }
-
-    *delayTx = delayTransmission;
-    return nbEnabledChannels;
+    return RegionCommonChanAvailableMask( availableMask, channelsMask, NvmCtx.ChannelsDrMask[datarate],
+                                          channels, bands, CHANNELS_MASK_SIZE, delayTx );
 }
 
 PhyParam_t RegionAU915GetPhyParam( GetPhyParams_t* getPhy )
@@ -445,14 +438,9 @@ void RegionAU915InitDefaults( InitDefaultsParams_t* params )
 
             // Copy into channels mask remaining
             RegionCommonChanMaskCopy( NvmCtx.ChannelsMaskRemaining, NvmCtx.ChannelsMask, 6 );
-            break;
-        }
-        case INIT_TYPE_RESTORE_CTX:
-        {
-            if( params->NvmCtx != 0 )
-            {
-                memcpy1( (uint8_t*) &NvmCtx, (uint8_t*) params->NvmCtx, sizeof( NvmCtx ) );
-            }
+
+            // Update the channels supporting each datarate
+            RegionCommonChanDrMaskInit( ( uint16_t* )NvmCtx.ChannelsDrMask, AU915_TX_MAX_DATARATE + 1, CHANNELS_MASK_SIZE, NvmCtx.Channels, AU915_MAX_NB_CHANNELS );
             break;
         }
         case INIT_TYPE_RESTORE_DEFAULT_CHANNELS:
@@ -583,7 +571,7 @@ bool RegionAU915ChanMaskSet( ChanMaskSetParams_t* chanMaskSet )
 
 void RegionAU915ComputeRxWindowParameters( int8_t datarate, uint8_t minRxSymbols, uint32_t rxError, RxConfigParams_t *rxConfigParams )
 {
-    double tSymbol = 0.0;
+    RegionCommonSymbolTime_t tSymbol = 0;
 
     // Get the datarate, perform a boundary check
     rxConfigParams->Datarate = MIN( datarate, AU915_RX_MAX_DATARATE );
@@ -870,12 +858,10 @@ uint8_t RegionAU915DlChannelReq( DlChannelReqParams_t* dlChannelReq )
 
 int8_t RegionAU915AlternateDr( int8_t currentDr, AlternateDrType_t type )
 {
-    static int8_t trialsCount = 0;
-
     // Re-enable 500 kHz default channels
     NvmCtx.ChannelsMask[4] = CHANNELS_MASK_500KHZ_MASK;
 
-    if( ( trialsCount & 0x01 ) == 0x01 )
+    if( ( NvmCtx.AlternateDrCounter & 0x01 ) == 0x01 )
     {
         currentDr = DR_6;
     }
@@ -883,7 +869,7 @@ int8_t RegionAU915AlternateDr( int8_t currentDr, AlternateDrType_t type )
     {
         currentDr = DR_2;
     }
-    trialsCount++;
+    NvmCtx.AlternateDrCounter++;
     return currentDr;
 }
 
@@ -907,7 +893,7 @@ LoRaMacStatus_t RegionAU915NextChannel( NextChanParams_t* nextChanParams, uint8_
 {
     uint8_t nbEnabledChannels = 0;
     uint8_t delayTx = 0;
-    uint8_t enabledChannels[AU915_MAX_NB_CHANNELS] = { 0 };
+    uint16_t availableMask[CHANNELS_MASK_SIZE] = { 0 };
     TimerTime_t nextTxDelay = 0;
 
     // Count 125kHz channels
@@ -936,7 +922,7 @@ LoRaMacStatus_t RegionAU915NextChannel( NextChanParams_t* nextChanParams, uint8_
         // Search how many channels are enabled
         nbEnabledChannels = CountNbOfEnabledChannels( nextChanParams->Datarate,
                                                       NvmCtx.ChannelsMaskRemaining, NvmCtx.Channels,
-                                                      NvmCtx.Bands, enabledChannels, &delayTx );
+                                                      NvmCtx.Bands, availableMask, &delayTx );
     }
     else
     {
@@ -947,7 +933,7 @@ LoRaMacStatus_t RegionAU915NextChannel( NextChanParams_t* nextChanParams, uint8_
     if( nbEnabledChannels > 0 )
     {
         // We found a valid channel
-        *channel = enabledChannels[randr( 0, nbEnabledChannels - 1 )];
+        *channel = RegionCommonChanMaskGetNth( availableMask, CHANNELS_MASK_SIZE, randr( 0, nbEnabledChannels - 1 ) );
         // Disable the channel in the mask
         RegionCommonChanDisable( NvmCtx.ChannelsMaskRemaining, *channel, AU915_MAX_NB_CHANNELS - 8 );
 
@@ -33,6 +33,7 @@
 #include "RegionCommon.h"
 #include "RegionCN470.h"
 #include "util_console.h"
+#include "LoRaMacInstance.h"
 
 // Definitions
 #define CHANNELS_MASK_SIZE              6
@@ -58,12 +59,23 @@ typedef struct sRegionCN470NvmCtx
      * LoRaMac channels default mask
      */
     uint16_t ChannelsDefaultMask[ CHANNELS_MASK_SIZE ];
+    /*!
+     * Channels supporting each datarate, indexed by the datarate
+     */
+    uint16_t ChannelsDrMask[ CN470_TX_MAX_DATARATE + 1 ][ CHANNELS_MASK_SIZE ];
 }RegionCN470NvmCtx_t;
 
+#if defined( LORAMAC_MULTI_INSTANCE )
+/*
+ * Non-volatile module context of the selected instance.
+ */
+#define NvmCtx                                      ( *( RegionCN470NvmCtx_t* )LORAMAC_INSTANCE_MODULE_CTX( LORAMAC_INSTANCE_MODULE_REGION ) )
+#else
 /*
  * Non-volatile module context.
  */
 static RegionCN470NvmCtx_t NvmCtx;
+#endif
 
 // Static functions
 static int8_t GetNextLowerTxDr( int8_t dr, int8_t minDr )
@@ -129,38 +141,15 @@ static bool VerifyRfFreq( uint32_t freq )
     return true;
 }
 
-static uint8_t CountNbOfEnabledChannels( uint8_t datarate, uint16_t* channelsMask, ChannelParams_t* channels, Band_t* bands, uint8_t* enabledChannels, uint8_t* delayTx )
+static uint8_t CountNbOfEnabledChannels( uint8_t datarate, uint16_t* channelsMask, ChannelParams_t* channels, Band_t* bands, uint16_t* availableMask, uint8_t* delayTx )
 {
-    uint8_t nbEnabledChannels = 0;
-    uint8_t delayTransmission = 0;
-
-    for( uint8_t i = 0, k = 0; i < CN470_MAX_NB_CHANNELS; i += 16, k++ )
-    {
-        for( uint8_t j = 0; j < 16; j++ )
-        {
-            if( ( channelsMask[k] & ( 1 << j ) ) != 0 )
-            {
-                if( channels[i + j].Frequency == 0 )
-                { // Check if the channel is enabled
-                    continue;
-                }
-                if( RegionCommonValueInRange( datarate, channels[i + j].DrRange.Fields.Min,
-                                              channels[i + j].DrRange.Fields.Max ) == false )
-                { // Check if the current channel selection supports the given datarate
-                    continue;
-                }
-                if( bands[channels[i + j].Band].TimeOff > 0 )
-                { // Check if the band is available for transmission
-                    delayTransmission++;
-                    continue;
-                }
-                enabledChannels[nbEnabledChannels++] = i + j;
-            }
-        }
+    if( datarate > CN470_TX_MAX_DATARATE )
+    { // No channel supports the datarate
+        *delayTx = 0;
+        return 0;
     }
-
-    *delayTx = delayTransmission;
-    return nbEnabledChannels;
+    return RegionCommonChanAvailableMask( availableMask, channelsMask, NvmCtx.ChannelsDrMask[datarate],
+                                          channels, bands, CHANNELS_MASK_SIZE, delayTx );
 }
 
 PhyParam_t RegionCN470GetPhyParam( GetPhyParams_t* getPhy )
@@ -384,14 +373,9 @@ void RegionCN470InitDefaults( InitDefaultsParams_t* params )
 
             // Update the channels mask
             RegionCommonChanMaskCopy( NvmCtx.ChannelsMask, NvmCtx.ChannelsDefaultMask, 6 );
-            break;
-        }
-        case INIT_TYPE_RESTORE_CTX:
-        {
-            if( params->NvmCtx != 0 )
-            {
-                memcpy1( (uint8_t*) &NvmCtx, (uint8_t*) params->NvmCtx, sizeof( NvmCtx ) );
-            }
+
+            // Update the channels supporting each datarate
+            RegionCommonChanDrMaskInit( ( uint16_t* )NvmCtx.ChannelsDrMask, CN470_TX_MAX_DATARATE + 1, CHANNELS_MASK_SIZE, NvmCtx.Channels, CN470_MAX_NB_CHANNELS );
             break;
         }
         case INIT_TYPE_RESTORE_DEFAULT_CHANNELS:
@@ -489,7 +473,7 @@ bool RegionCN470ChanMaskSet( ChanMaskSetParams_t* chanMaskSet )
 
 void RegionCN470ComputeRxWindowParameters( int8_t datarate, uint8_t minRxSymbols, uint32_t rxError, RxConfigParams_t *rxConfigParams )
 {
-    double tSymbol = 0.0;
+    RegionCommonSymbolTime_t tSymbol = 0;
 
     // Get the datarate, perform a boundary check
     rxConfigParams->Datarate = MIN( datarate, CN470_RX_MAX_DATARATE );
@@ -728,7 +712,7 @@ LoRaMacStatus_t RegionCN470NextChannel( NextChanParams_t* nextChanParams, uint8_
 {
     uint8_t nbEnabledChannels = 0;
     uint8_t delayTx = 0;
-    uint8_t enabledChannels[CN470_MAX_NB_CHANNELS] = { 0 };
+    uint16_t availableMask[CHANNELS_MASK_SIZE] = { 0 };
     TimerTime_t nextTxDelay = 0;
 
     // Count 125kHz channels
@@ -754,7 +738,7 @@ LoRaMacStatus_t RegionCN470NextChannel( NextChanParams_t* nextChanParams, uint8_
         // Search how many channels are enabled
         nbEnabledChannels = CountNbOfEnabledChannels( nextChanParams->Datarate,
                                                       NvmCtx.ChannelsMask, NvmCtx.Channels,
-                                                      NvmCtx.Bands, enabledChannels, &delayTx );
+                                                      NvmCtx.Bands, availableMask, &delayTx );
     }
     else
     {
@@ -765,7 +749,7 @@ LoRaMacStatus_t RegionCN470NextChannel( NextChanParams_t* nextChanParams, uint8_
     if( nbEnabledChannels > 0 )
     {
         // We found a valid channel
-        *channel = enabledChannels[randr( 0, nbEnabledChannels - 1 )];
+        *channel = RegionCommonChanMaskGetNth( availableMask, CHANNELS_MASK_SIZE, randr( 0, nbEnabledChannels - 1 ) );
 
         *time = 0;
         return LORAMAC_STATUS_OK;
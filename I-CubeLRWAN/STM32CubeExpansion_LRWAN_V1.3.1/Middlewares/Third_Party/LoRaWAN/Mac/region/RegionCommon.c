@@ -37,18 +37,43 @@
 #define BACKOFF_DC_10_HOURS     1000
 #define BACKOFF_DC_24_HOURS     10000
 
-static uint8_t CountChannels( uint16_t mask, uint8_t nbBits )
+/*!
+ * Bit index of a single bit set in a 32 bit word, see LowestChannel
+ */
+static const uint8_t DeBruijnBitIndex[32] =
 {
-    uint8_t nbActiveBits = 0;
+    0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+    31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+};
 
-    for( uint8_t j = 0; j < nbBits; j++ )
-    {
-        if( ( mask & ( 1 << j ) ) == ( 1 << j ) )
-        {
-            nbActiveBits++;
-        }
-    }
-    return nbActiveBits;
+/*!
+ * \brief Counts the channels set in a channels mask word (population count).
+ *
+ * \param [IN] mask Channels mask word.
+ *
+ * \retval Returns the number of channels set.
+ */
+static uint8_t CountChannels( uint16_t mask )
+{
+    mask = mask - ( ( mask >> 1 ) & 0x5555 );
+    mask = ( mask & 0x3333 ) + ( ( mask >> 2 ) & 0x3333 );
+    mask = ( mask + ( mask >> 4 ) ) & 0x0F0F;
+    return ( uint8_t )( ( mask + ( mask >> 8 ) ) & 0x1F );
+}
+
+/*!
+ * \brief Returns the index of the lowest channel set in a channels mask word
+ *        (count of trailing zeros).
+ *
+ * \param [IN] mask Channels mask word, not 0.
+ *
+ * \retval Returns the index of the channel in the word.
+ */
+static uint8_t LowestChannel( uint16_t mask )
+{
+    uint32_t lowestBit = ( uint32_t )mask & ( ~( uint32_t )mask + 1 );
+
+    return DeBruijnBitIndex[( uint32_t )( lowestBit * 0x077CB531UL ) >> 27];
 }
 
 uint16_t RegionCommonGetJoinDc( TimerTime_t elapsedTime )
@@ -130,7 +155,7 @@ uint8_t RegionCommonCountChannels( uint16_t* channelsMask, uint8_t startIdx, uin
 
     for( uint8_t i = startIdx; i < stopIdx; i++ )
     {
-        nbChannels += CountChannels( channelsMask[i], 16 );
+        nbChannels += CountChannels( channelsMask[i] );
     }
 
     return nbChannels;
@@ -147,6 +172,84 @@ void RegionCommonChanMaskCopy( uint16_t* channelsMaskDest, uint16_t* channelsMas
     }
 }
 
+void RegionCommonChanDrMaskUpdate( uint16_t* channelsDrMask, uint8_t nbDr, uint8_t len, uint8_t id, ChannelParams_t* channel )
+{
+    uint8_t index = id / 16;
+    uint16_t bit = 1 << ( id % 16 );
+
+    for( uint8_t dr = 0; dr < nbDr; dr++ )
+    {
+        if( ( channel->Frequency != 0 ) &&
+            ( RegionCommonValueInRange( dr, channel->DrRange.Fields.Min, channel->DrRange.Fields.Max ) == 1 ) )
+        {
+            channelsDrMask[dr * len + index] |= bit;
+        }
+        else
+        {
+            channelsDrMask[dr * len + index] &= ~bit;
+        }
+    }
+}
+
+void RegionCommonChanDrMaskInit( uint16_t* channelsDrMask, uint8_t nbDr, uint8_t len, ChannelParams_t* channels, uint8_t nbChannels )
+{
+    for( uint8_t i = 0; i < nbChannels; i++ )
+    {
+        RegionCommonChanDrMaskUpdate( channelsDrMask, nbDr, len, i, &channels[i] );
+    }
+}
+
+uint8_t RegionCommonChanAvailableMask( uint16_t* availableMask, uint16_t* channelsMask, uint16_t* drMask, ChannelParams_t* channels, Band_t* bands, uint8_t len, uint8_t* delayTx )
+{
+    uint8_t nbAvailable = 0;
+    uint8_t delayTransmission = 0;
+
+    for( uint8_t k = 0; k < len; k++ )
+    {
+        uint16_t enabled = channelsMask[k] & drMask[k];
+        uint16_t available = enabled;
+
+        // Only the enabled channels supporting the datarate are visited
+        while( enabled != 0 )
+        {
+            uint8_t j = LowestChannel( enabled );
+
+            enabled &= enabled - 1;
+            if( bands[channels[k * 16 + j].Band].TimeOff > 0 )
+            { // The band is not available for transmission
+                available &= ~( 1 << j );
+                delayTransmission++;
+            }
+        }
+        availableMask[k] = available;
+        nbAvailable += CountChannels( available );
+    }
+
+    *delayTx = delayTransmission;
+    return nbAvailable;
+}
+
+uint8_t RegionCommonChanMaskGetNth( uint16_t* channelsMask, uint8_t len, uint8_t n )
+{
+    for( uint8_t k = 0; k < len; k++ )
+    {
+        uint16_t mask = channelsMask[k];
+        uint8_t nbChannels = CountChannels( mask );
+
+        if( n < nbChannels )
+        {
+            // Drop the n lowest channels of the word
+            while( n-- > 0 )
+            {
+                mask &= mask - 1;
+            }
+            return k * 16 + LowestChannel( mask );
+        }
+        n -= nbChannels;
+    }
+    return 0;
+}
+
 void RegionCommonSetBandTxDone( bool joined, Band_t* band, TimerTime_t lastTxDone )
 {
     if( joined == true )
@@ -289,22 +392,67 @@ uint8_t RegionCommonLinkAdrReqVerifyParams( RegionCommonLinkAdrReqVerifyParams_t
     return status;
 }
 
-double RegionCommonComputeSymbolTimeLoRa( uint8_t phyDr, uint32_t bandwidth )
+#if defined( LORA_FIXED_POINT_TIMING )
+
+/*!
+ * \brief Integer division of a signed numerator rounded up.
+ *
+ * \param [IN] num Numerator.
+ *
+ * \param [IN] den Denominator, positive.
+ *
+ * \retval Returns ceil( num / den ).
+ */
+static int32_t DivCeil( int32_t num, int32_t den )
+{
+    if( num >= 0 )
+    {
+        return ( num + den - 1 ) / den;
+    }
+    return -( -num / den );
+}
+
+RegionCommonSymbolTime_t RegionCommonComputeSymbolTimeLoRa( uint8_t phyDr, uint32_t bandwidth )
+{
+    // LoRa bandwidths are kHz multiples dividing 1000 * 2^SF, the result is exact
+    return ( ( uint32_t )1000 << phyDr ) / ( bandwidth / 1000 );
+}
+
+RegionCommonSymbolTime_t RegionCommonComputeSymbolTimeFsk( uint8_t phyDr )
+{
+    return ( 8000 / ( uint32_t )phyDr ); // 1 symbol equals 1 byte, phyDr in kbps
+}
+
+void RegionCommonComputeRxWindowParameters( RegionCommonSymbolTime_t tSymbol, uint8_t minRxSymbols, uint32_t rxError, uint32_t wakeUpTime, uint32_t* windowTimeout, int32_t* windowOffset )
+{
+    // ceil( ( ( 2 * minRxSymbols - 8 ) * tSymbol + 2 * rxError ) / tSymbol ), rxError being in ms
+    int32_t nbSymbols = ( 2 * minRxSymbols - 8 ) + DivCeil( ( int32_t )( 2000 * rxError ), ( int32_t )tSymbol );
+
+    *windowTimeout = MAX( ( uint32_t )MAX( nbSymbols, 0 ), minRxSymbols ); // Computed number of symbols
+    // ceil( 4 * tSymbol - windowTimeout * tSymbol / 2 - wakeUpTime ), in half microseconds
+    *windowOffset = DivCeil( ( int32_t )( 8 * tSymbol ) - ( int32_t )( *windowTimeout * tSymbol ), 2000 ) - ( int32_t )wakeUpTime;
+}
+
+#else
+
+RegionCommonSymbolTime_t RegionCommonComputeSymbolTimeLoRa( uint8_t phyDr, uint32_t bandwidth )
 {
     return ( ( double )( 1 << phyDr ) / ( double )bandwidth ) * 1000;
 }
 
-double RegionCommonComputeSymbolTimeFsk( uint8_t phyDr )
+RegionCommonSymbolTime_t RegionCommonComputeSymbolTimeFsk( uint8_t phyDr )
 {
     return ( 8.0 / ( double )phyDr ); // 1 symbol equals 1 byte
 }
 
-void RegionCommonComputeRxWindowParameters( double tSymbol, uint8_t minRxSymbols, uint32_t rxError, uint32_t wakeUpTime, uint32_t* windowTimeout, int32_t* windowOffset )
+void RegionCommonComputeRxWindowParameters( RegionCommonSymbolTime_t tSymbol, uint8_t minRxSymbols, uint32_t rxError, uint32_t wakeUpTime, uint32_t* windowTimeout, int32_t* windowOffset )
 {
     *windowTimeout = MAX( ( uint32_t )ceil( ( ( 2 * minRxSymbols - 8 ) * tSymbol + 2 * rxError ) / tSymbol ), minRxSymbols ); // Computed number of symbols
     *windowOffset = ( int32_t )ceil( ( 4.0 * tSymbol ) - ( ( *windowTimeout * tSymbol ) / 2.0 ) - wakeUpTime );
 }
 
+#endif /* LORA_FIXED_POINT_TIMING */
+
 int8_t RegionCommonComputeTxPower( int8_t txPowerIndex, float maxEirp, float antennaGain )
 {
     int8_t phyTxPower = 0;
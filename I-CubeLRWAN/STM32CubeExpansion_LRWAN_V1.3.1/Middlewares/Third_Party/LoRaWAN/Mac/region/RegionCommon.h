@@ -40,6 +40,21 @@
 #include "LoRaMacTypes.h"
 #include "region/Region.h"
 
+/*!
+ * Symbol time type.
+ *
+ * When LORA_FIXED_POINT_TIMING is defined the symbol time and the RX window
+ * parameters are computed with integer math, the symbol time being in
+ * microseconds. Otherwise they are computed with doubles, the symbol time being
+ * in milliseconds. Both give the same RX window parameters, the fixed point
+ * variant avoids the soft-float double support on cores without FPU.
+ */
+#if defined( LORA_FIXED_POINT_TIMING )
+typedef uint32_t RegionCommonSymbolTime_t;
+#else
+typedef double RegionCommonSymbolTime_t;
+#endif
+
 typedef struct sRegionCommonLinkAdrParams
 {
     /*!
@@ -285,6 +300,83 @@ uint8_t RegionCommonCountChannels( uint16_t* channelsMask, uint8_t startIdx, uin
  */
 void RegionCommonChanMaskCopy( uint16_t* channelsMaskDest, uint16_t* channelsMaskSrc, uint8_t len );
 
+/*!
+ * \brief Updates the per-datarate channels masks for one channel. The channel
+ *        is set in the mask of each datarate it supports and cleared in the
+ *        others. A channel without frequency supports no datarate.
+ *        This is a generic function and valid for all regions.
+ *
+ * \param [IN] channelsDrMask The per-datarate channels masks of the region,
+ *                            nbDr masks of len words, indexed by the datarate.
+ *
+ * \param [IN] nbDr Number of datarates.
+ *
+ * \param [IN] len Number of words of a channels mask.
+ *
+ * \param [IN] id The id of the channel.
+ *
+ * \param [IN] channel The channel parameters.
+ */
+void RegionCommonChanDrMaskUpdate( uint16_t* channelsDrMask, uint8_t nbDr, uint8_t len, uint8_t id, ChannelParams_t* channel );
+
+/*!
+ * \brief Computes the per-datarate channels masks from the channels list.
+ *        This is a generic function and valid for all regions.
+ *
+ * \param [IN] channelsDrMask The per-datarate channels masks of the region,
+ *                            see \ref RegionCommonChanDrMaskUpdate.
+ *
+ * \param [IN] nbDr Number of datarates.
+ *
+ * \param [IN] len Number of words of a channels mask.
+ *
+ * \param [IN] channels The channels list of the region.
+ *
+ * \param [IN] nbChannels Number of channels in the list.
+ */
+void RegionCommonChanDrMaskInit( uint16_t* channelsDrMask, uint8_t nbDr, uint8_t len, ChannelParams_t* channels, uint8_t nbChannels );
+
+/*!
+ * \brief Computes the mask of the channels available for a transmission: the
+ *        channels enabled in the channels mask, supporting the datarate and
+ *        whose band is available.
+ *        This is a generic function and valid for all regions.
+ *
+ * \param [OUT] availableMask The mask of the available channels.
+ *
+ * \param [IN] channelsMask The channels mask of the region.
+ *
+ * \param [IN] drMask The channels supporting the datarate, the mask of the
+ *                    datarate in the per-datarate channels masks.
+ *
+ * \param [IN] channels The channels list of the region.
+ *
+ * \param [IN] bands The bands of the region.
+ *
+ * \param [IN] len Number of words of a channels mask.
+ *
+ * \param [OUT] delayTx Number of channels which can't be used because their
+ *                      band is not available.
+ *
+ * \retval Returns the number of available channels.
+ */
+uint8_t RegionCommonChanAvailableMask( uint16_t* availableMask, uint16_t* channelsMask, uint16_t* drMask, ChannelParams_t* channels, Band_t* bands, uint8_t len, uint8_t* delayTx );
+
+/*!
+ * \brief Returns the id of the nth channel set in a channels mask, the
+ *        channels being counted by increasing id.
+ *        This is a generic function and valid for all regions.
+ *
+ * \param [IN] channelsMask The channels mask.
+ *
+ * \param [IN] len Number of words of the channels mask.
+ *
+ * \param [IN] n Rank of the channel, lower than the number of channels set.
+ *
+ * \retval Returns the id of the channel.
+ */
+uint8_t RegionCommonChanMaskGetNth( uint16_t* channelsMask, uint8_t len, uint8_t n );
+
 /*!
  * \brief Sets the last tx done property.
  *        This is a generic function and valid for all regions.
@@ -350,9 +442,9 @@ uint8_t RegionCommonLinkAdrReqVerifyParams( RegionCommonLinkAdrReqVerifyParams_t
  *
  * \param [IN] bandwidth Bandwidth to use.
  *
- * \retval Returns the symbol time.
+ * \retval Returns the symbol time, see \ref RegionCommonSymbolTime_t.
  */
-double RegionCommonComputeSymbolTimeLoRa( uint8_t phyDr, uint32_t bandwidth );
+RegionCommonSymbolTime_t RegionCommonComputeSymbolTimeLoRa( uint8_t phyDr, uint32_t bandwidth );
 
 /*!
  * \brief Computes the symbol time for FSK modulation.
@@ -363,7 +455,7 @@ double RegionCommonComputeSymbolTimeLoRa( uint8_t phyDr, uint32_t bandwidth );
  *
  * \retval Returns the symbol time.
  */
-double RegionCommonComputeSymbolTimeFsk( uint8_t phyDr );
+RegionCommonSymbolTime_t RegionCommonComputeSymbolTimeFsk( uint8_t phyDr );
 
 /*!
  * \brief Computes the RX window timeout and the RX window offset.
@@ -381,7 +473,7 @@ double RegionCommonComputeSymbolTimeFsk( uint8_t phyDr );
  *
  * \param [OUT] windowOffset RX window time offset to be applied to the RX delay.
  */
-void RegionCommonComputeRxWindowParameters( double tSymbol, uint8_t minRxSymbols, uint32_t rxError, uint32_t wakeUpTime, uint32_t* windowTimeout, int32_t* windowOffset );
+void RegionCommonComputeRxWindowParameters( RegionCommonSymbolTime_t tSymbol, uint8_t minRxSymbols, uint32_t rxError, uint32_t wakeUpTime, uint32_t* windowTimeout, int32_t* windowOffset );
 
 /*!
  * \brief Computes the txPower, based on the max EIRP and the antenna gain.
@@ -33,6 +33,7 @@
 #include "RegionCommon.h"
 #include "RegionEU433.h"
 #include "util_console.h"
+#include "LoRaMacInstance.h"
 
 // Definitions
 #define CHANNELS_MASK_SIZE              1
@@ -58,12 +59,23 @@ typedef struct sRegionEU433NvmCtx
      * LoRaMac channels default mask
      */
     uint16_t ChannelsDefaultMask[ CHANNELS_MASK_SIZE ];
+    /*!
+     * Channels supporting each datarate, indexed by the datarate
+     */
+    uint16_t ChannelsDrMask[ EU433_TX_MAX_DATARATE + 1 ][ CHANNELS_MASK_SIZE ];
 }RegionEU433NvmCtx_t;
 
+#if defined( LORAMAC_MULTI_INSTANCE )
+/*
+ * Non-volatile module context of the selected instance.
+ */
+#define NvmCtx                                      ( *( RegionEU433NvmCtx_t* )LORAMAC_INSTANCE_MODULE_CTX( LORAMAC_INSTANCE_MODULE_REGION ) )
+#else
 /*
  * Non-volatile module context.
  */
 static RegionEU433NvmCtx_t NvmCtx;
+#endif
 
 // Static functions
 static int8_t GetNextLowerTxDr( int8_t dr, int8_t minDr )
@@ -120,45 +132,23 @@ static bool VerifyRfFreq( uint32_t freq )
     return true;
 }
 
-static uint8_t CountNbOfEnabledChannels( bool joined, uint8_t datarate, uint16_t* channelsMask, ChannelParams_t* channels, Band_t* bands, uint8_t* enabledChannels, uint8_t* delayTx )
+static uint8_t CountNbOfEnabledChannels( bool joined, uint8_t datarate, uint16_t* channelsMask, ChannelParams_t* channels, Band_t* bands, uint16_t* availableMask, uint8_t* delayTx )
 {
-    uint8_t nbEnabledChannels = 0;
-    uint8_t delayTransmission = 0;
+    uint16_t enabledMask[CHANNELS_MASK_SIZE];
 
-    for( uint8_t i = 0, k = 0; i < EU433_MAX_NB_CHANNELS; i += 16, k++ )
-    {
-        for( uint8_t j = 0; j < 16; j++ )
-        {
-            if( ( channelsMask[k] & ( 1 << j ) ) != 0 )
-            {
-                if( channels[i + j].Frequency == 0 )
-                { // Check if the channel is enabled
-                    continue;
-                }
-                if( joined == false )
-                {
-                    if( ( EU433_JOIN_CHANNELS & ( 1 << j ) ) == 0 )
-                    {
-                        continue;
-                    }
-                }
-                if( RegionCommonValueInRange( datarate, channels[i + j].DrRange.Fields.Min,
-                                              channels[i + j].DrRange.Fields.Max ) == false )
-                { // Check if the current channel selection supports the given datarate
-                    continue;
-                }
-                if( bands[channels[i + j].Band].TimeOff > 0 )
-                { // Check if the band is available for transmission
-                    delayTransmission++;
-                    continue;
-                }
-                enabledChannels[nbEnabledChannels++] = i + j;
-            }
-        }
+    if( datarate > EU433_TX_MAX_DATARATE )
+    { // No channel supports the datarate
+        *delayTx = 0;
+        return 0;
     }
 
-    *delayTx = delayTransmission;
-    return nbEnabledChannels;
+    RegionCommonChanMaskCopy( enabledMask, channelsMask, CHANNELS_MASK_SIZE );
+    if( joined == false )
+    { // Only the join channels can be used
+        enabledMask[0] &= EU433_JOIN_CHANNELS;
+    }
+    return RegionCommonChanAvailableMask( availableMask, enabledMask, NvmCtx.ChannelsDrMask[datarate],
+                                          channels, bands, CHANNELS_MASK_SIZE, delayTx );
 }
 
 PhyParam_t RegionEU433GetPhyParam( GetPhyParams_t* getPhy )
@@ -367,14 +357,9 @@ void RegionEU433InitDefaults( InitDefaultsParams_t* params )
             NvmCtx.ChannelsDefaultMask[0] = LC( 1 ) + LC( 2 ) + LC( 3 );
             // Update the channels mask
             RegionCommonChanMaskCopy( NvmCtx.ChannelsMask, NvmCtx.ChannelsDefaultMask, 1 );
-            break;
-        }
-        case INIT_TYPE_RESTORE_CTX:
-        {
-            if( params->NvmCtx != 0 )
-            {
-                memcpy1( (uint8_t*) &NvmCtx, (uint8_t*) params->NvmCtx, sizeof( NvmCtx ) );
-            }
+
+            // Update the channels supporting each datarate
+            RegionCommonChanDrMaskInit( ( uint16_t* )NvmCtx.ChannelsDrMask, EU433_TX_MAX_DATARATE + 1, CHANNELS_MASK_SIZE, NvmCtx.Channels, EU433_MAX_NB_CHANNELS );
             break;
         }
         case INIT_TYPE_RESTORE_DEFAULT_CHANNELS:
@@ -386,6 +371,9 @@ void RegionEU433InitDefaults( InitDefaultsParams_t* params )
             NvmCtx.Channels[0] = ( ChannelParams_t ) EU433_LC1;
             NvmCtx.Channels[1] = ( ChannelParams_t ) EU433_LC2;
             NvmCtx.Channels[2] = ( ChannelParams_t ) EU433_LC3;
+
+            // Update the channels supporting each datarate
+            RegionCommonChanDrMaskInit( ( uint16_t* )NvmCtx.ChannelsDrMask, EU433_TX_MAX_DATARATE + 1, CHANNELS_MASK_SIZE, NvmCtx.Channels, EU433_MAX_NB_CHANNELS );
             break;
         }
         default:
@@ -517,7 +505,7 @@ bool RegionEU433ChanMaskSet( ChanMaskSetParams_t* chanMaskSet )
 
 void RegionEU433ComputeRxWindowParameters( int8_t datarate, uint8_t minRxSymbols, uint32_t rxError, RxConfigParams_t *rxConfigParams )
 {
-    double tSymbol = 0.0;
+    RegionCommonSymbolTime_t tSymbol = 0;
 
     // Get the datarate, perform a boundary check
     rxConfigParams->Datarate = MIN( datarate, EU433_RX_MAX_DATARATE );
@@ -864,7 +852,7 @@ LoRaMacStatus_t RegionEU433NextChannel( NextChanParams_t* nextChanParams, uint8_
 {
     uint8_t nbEnabledChannels = 0;
     uint8_t delayTx = 0;
-    uint8_t enabledChannels[EU433_MAX_NB_CHANNELS] = { 0 };
+    uint16_t availableMask[CHANNELS_MASK_SIZE] = { 0 };
     TimerTime_t nextTxDelay = 0;
 
     if( RegionCommonCountChannels( NvmCtx.ChannelsMask, 0, 1 ) == 0 )
@@ -884,7 +872,7 @@ LoRaMacStatus_t RegionEU433NextChannel( NextChanParams_t* nextChanParams, uint8_
         // Search how many channels are enabled
         nbEnabledChannels = CountNbOfEnabledChannels( nextChanParams->Joined, nextChanParams->Datarate,
                                                       NvmCtx.ChannelsMask, NvmCtx.Channels,
-                                                      NvmCtx.Bands, enabledChannels, &delayTx );
+                                                      NvmCtx.Bands, availableMask, &delayTx );
     }
     else
     {
@@ -895,7 +883,7 @@ LoRaMacStatus_t RegionEU433NextChannel( NextChanParams_t* nextChanParams, uint8_
     if( nbEnabledChannels > 0 )
     {
         // We found a valid channel
-        *channel = enabledChannels[randr( 0, nbEnabledChannels - 1 )];
+        *channel = RegionCommonChanMaskGetNth( availableMask, CHANNELS_MASK_SIZE, randr( 0, nbEnabledChannels - 1 ) );
 
         *time = 0;
         return LORAMAC_STATUS_OK;
@@ -970,6 +958,7 @@ LoRaMacStatus_t RegionEU433ChannelAdd( ChannelAddParams_t* channelAdd )
 
     memcpy1( ( uint8_t* ) &(NvmCtx.Channels[id]), ( uint8_t* ) channelAdd->NewChannel, sizeof( NvmCtx.Channels[id] ) );
     NvmCtx.Channels[id].Band = 0;
+    RegionCommonChanDrMaskUpdate( ( uint16_t* )NvmCtx.ChannelsDrMask, EU433_TX_MAX_DATARATE + 1, CHANNELS_MASK_SIZE, id, &NvmCtx.Channels[id] );
     NvmCtx.ChannelsMask[0] |= ( 1 << id );
     return LORAMAC_STATUS_OK;
 }
@@ -985,6 +974,7 @@ bool RegionEU433ChannelsRemove( ChannelRemoveParams_t* channelRemove  )
 
     // Remove the channel from the list of channels
     NvmCtx.Channels[id] = ( ChannelParams_t ){ 0, 0, { 0 }, 0 };
+    RegionCommonChanDrMaskUpdate( ( uint16_t* )NvmCtx.ChannelsDrMask, EU433_TX_MAX_DATARATE + 1, CHANNELS_MASK_SIZE, id, &NvmCtx.Channels[id] );
 
     return RegionCommonChanDisable( NvmCtx.ChannelsMask, id, EU433_MAX_NB_CHANNELS );
 }
@@ -153,6 +153,21 @@ SecureElementStatus_t SecureElementVerifyAesCmac( uint8_t* buffer, uint16_t size
  */
 SecureElementStatus_t SecureElementAesEncrypt( uint8_t* buffer, uint16_t size, KeyIdentifier_t keyID, uint8_t* encBuffer );
 
+/*!
+ * Encrypts or decrypts a buffer in place in counter mode
+ *
+ * The keystream block i is the encryption of aBlock with its last byte
+ * incremented by i, the whole keystream of the buffer is generated in one
+ * call with the key schedule looked up once.
+ *
+ * \param[IN]     aBlock         - Initial counter block ( 16 bytes )
+ * \param[IN/OUT] buffer         - Data buffer
+ * \param[IN]     size           - Data buffer size
+ * \param[IN]     keyID          - Key identifier to determine the AES key to be used
+ * \retval                       - Status of the operation
+ */
+SecureElementStatus_t SecureElementAesCtrEncrypt( const uint8_t* aBlock, uint8_t* buffer, uint16_t size, KeyIdentifier_t keyID );
+
 /*!
  * Derives and store a key
  *
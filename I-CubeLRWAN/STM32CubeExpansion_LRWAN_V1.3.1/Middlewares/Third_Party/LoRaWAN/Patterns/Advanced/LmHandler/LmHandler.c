@@ -35,6 +35,7 @@
 #include "LmhpClockSync.h"
 #include "LmhpRemoteMcastSetup.h"
 #include "LmhpFragmentation.h"
+#include "LmhpAggregation.h"
 
 #ifndef ACTIVE_REGION
 
@@ -938,6 +939,11 @@ LmHandlerErrorStatus_t LmHandlerPackageRegister( uint8_t id, void *params )
             package = LmhpFragmentationPackageFactory( );
             break;
         }
+        case PACKAGE_ID_AGGREGATION:
+        {
+            package = LmhpAggregationPackageFactory( );
+            break;
+        }
     }
     if( package != NULL )
     {
@@ -42,6 +42,25 @@
 #endif
 
 
+
+/*!
+ * Number of 32 bits words of a bit array
+ */
+#define FRAG_BIT_WORDS( bits )                      ( ( ( bits ) + 31 ) >> 5 )
+
+/*!
+ * Word offset of a row of the lost fragments matrix. Row k only holds its
+ * bits k and above, from the word containing bit k up to the last word of a
+ * row of the given number of words.
+ */
+#define FRAG_M2B_ROW_OFFSET( row, words )           ( 32 * ( ( ( row ) >> 5 ) * ( words ) - ( ( ( ( row ) >> 5 ) * ( ( ( row ) >> 5 ) - 1 ) ) >> 1 ) ) + \
+                                                      ( ( row ) & 31 ) * ( ( words ) - ( ( row ) >> 5 ) ) )
+
+/*!
+ * Size in words of the lost fragments matrix
+ */
+#define FRAG_M2B_WORDS                              FRAG_M2B_ROW_OFFSET( FRAG_MAX_REDUNDANCY, FRAG_BIT_WORDS( FRAG_MAX_REDUNDANCY ) )
+
 /*
  *=============================================================================
  * Fragmentation decoder algorithm utilities
@@ -60,10 +79,34 @@ typedef struct
     uint8_t FragSize;
 
     uint32_t M2BLine;
-    uint8_t MatrixM2B[( ( FRAG_MAX_REDUNDANCY >> 3 ) + 1 ) * FRAG_MAX_REDUNDANCY];
-    uint16_t FragNbMissingIndex[FRAG_MAX_NB];
+    /*!
+     * Upper triangular matrix of the equations on the lost fragments, see
+     * FRAG_M2B_ROW_OFFSET
+     */
+    uint32_t MatrixM2B[FRAG_M2B_WORDS];
+    /*!
+     * Bit i is set when the uncoded fragment i has been received
+     */
+    uint32_t FragReceived[FRAG_BIT_WORDS( FRAG_MAX_NB )];
+    /*!
+     * Index of the lost fragments, in increasing order
+     */
+    uint16_t FragLostIndex[FRAG_MAX_REDUNDANCY];
 
-    uint8_t S[( FRAG_MAX_REDUNDANCY >> 3 ) + 1];
+    /*!
+     * Bit k is set when row k of MatrixM2B holds an equation
+     */
+    uint32_t S[FRAG_BIT_WORDS( FRAG_MAX_REDUNDANCY )];
+
+    /*!
+     * Parity matrix row of the coded fragment being processed
+     */
+    uint32_t MatrixRow[FRAG_BIT_WORDS( FRAG_MAX_NB )];
+    /*!
+     * Word aligned data lines
+     */
+    uint32_t DataLine[FRAG_BIT_WORDS( FRAG_MAX_SIZE * 8 )];
+    uint32_t DataTemp[FRAG_BIT_WORDS( FRAG_MAX_SIZE * 8 )];
 
     FragDecoderStatus_t Status;
 }FragDecoder_t;
@@ -118,16 +161,15 @@ static void GetRow( uint8_t *dst, uint8_t *src, uint16_t row, uint16_t size );
  *
  * \retval parity         Parity value at the given index
  */
-static uint8_t GetParity( uint16_t index, uint8_t *matrixRow  );
+static uint8_t GetParity( uint16_t index, const uint32_t *matrixRow );
 
 /*!
  * \brief Sets the parity value on the given row of the parity matrix
  *
  * \param [IN]     index     The index of the row to be computed
  * \param [IN/OUT] matrixRow Pointer to the parity matrix.
- * \param [IN]     parity    The parity value to be set in the parity matrix
  */
-static void SetParity( uint16_t index, uint8_t *matrixRow, uint8_t parity );
+static void SetParity( uint16_t index, uint32_t *matrixRow );
 
 /*!
  * \brief Check if the provided value is a power of 2
@@ -143,22 +185,22 @@ static bool IsPowerOfTwo( uint32_t x );
  *
  * \param [IN]  line1  1st Data line to be XORed
  * \param [IN]  line2  2nd Data line to be XORed
- * \param [IN]  size   Number of elements in line1
+ * \param [IN]  size   Number of bytes in line1
  *
  * \param [OUT] result XOR( line1, line2 ) result stored in line1
  */
-static void XorDataLine( uint8_t *line1, uint8_t *line2, int32_t size );
+static void XorDataLine( uint32_t *line1, const uint32_t *line2, int32_t size );
 
 /*!
  * \brief XORs two parity lines
  *
  * \param [IN]  line1  1st Parity line to be XORed
  * \param [IN]  line2  2nd Parity line to be XORed
- * \param [IN]  size   Number of elements in line1
+ * \param [IN]  words  Number of words in line1
  *
  * \param [OUT] result XOR( line1, line2 ) result stored in line1
  */
-static void XorParityLine( uint8_t* line1, uint8_t* line2, int32_t size );
+static void XorParityLine( uint32_t* line1, const uint32_t* line2, int32_t words );
 
 /*!
  * \brief Generates a pseudo random number : PRBS23
@@ -176,7 +218,16 @@ static int32_t FragPrbs23( int32_t value );
  * \param [IN]  m         Fragment number
  * \param [OUT] matrixRow Parity matrix
  */
-static void FragGetParityMatrixRow( int32_t n, int32_t m, uint8_t *matrixRow );
+static void FragGetParityMatrixRow( int32_t n, int32_t m, uint32_t *matrixRow );
+
+/*!
+ * \brief Returns the index of the lowest bit set in a word (count of
+ *        trailing zeros)
+ *
+ * \param [IN] word Word, not 0
+ * \retval index    Index of the lowest bit set
+ */
+static uint8_t LowestBit( uint32_t word );
 
 /*!
  * \brief Finds the index of the first one in a bit array
@@ -185,7 +236,7 @@ static void FragGetParityMatrixRow( int32_t n, int32_t m, uint8_t *matrixRow );
  * \param [IN] size     Bit array size
  * \retval index        The index of the first 1 in the bit array
  */
-static uint16_t BitArrayFindFirstOne( uint8_t *bitArray, uint16_t size );
+static uint16_t BitArrayFindFirstOne( const uint32_t *bitArray, uint16_t size );
 
 /*!
  * \brief Checks if the provided bit array only contains zeros
@@ -194,42 +245,23 @@ static uint16_t BitArrayFindFirstOne( uint8_t *bitArray, uint16_t size );
  * \param [IN] size     Bit array size
  * \retval isAllZeros   [0: Contains ones, 1: Contains all zeros]
  */
-static uint8_t BitArrayIsAllZeros( uint8_t *bitArray, uint16_t  size );
+static uint8_t BitArrayIsAllZeros( const uint32_t *bitArray, uint16_t size );
 
 /*!
  * \brief Finds & marks missing fragments
  *
  * \param [IN]  counter Current fragment counter
- * \param [OUT] FragDecoder.FragNbMissingIndex[] array is updated in place
+ * \param [OUT] FragDecoder.FragLostIndex[] array is updated in place
  */
 static void FragFindMissingFrags( uint16_t counter );
 
 /*!
- * \brief Finds the index (frag counter) of the x th missing frag
- *
- * \param [IN] x   x th missing frag
- *
- * \retval counter The counter value associated to the x th missing frag
- */
-static uint16_t FragFindMissingIndex( uint16_t x );
-
-/*!
- * \brief Extacts a row from the binary matrix and expands it to a bitArray
+ * \brief Gets a row of the lost fragments matrix
  *
- * \param [IN] bitArray  Pointer to the bit array
  * \param [IN] rowIndex  Matrix row index
- * \param [IN] bitsInRow Number of bits in one row
+ * \retval row           Pointer to the word holding bit rowIndex of the row
  */
-static void FragExtractLineFromBinaryMatrix( uint8_t* bitArray, uint16_t rowIndex, uint16_t bitsInRow );
-
-/*!
- * \brief Collapses and Pushs a row of a bit array to the matrix
- *
- * \param [IN] bitArray  Pointer to the bit array
- * \param [IN] rowIndex  Matrix row index
- * \param [IN] bitsInRow Number of bits in one row
- */
-static void FragPushLineToBinaryMatrix( uint8_t *bitArray, uint16_t rowIndex, uint16_t bitsInRow );
+static uint32_t* FragGetM2BRow( uint16_t rowIndex );
 
 /*
  *=============================================================================
@@ -255,39 +287,24 @@ void FragDecoderInit( uint16_t fragNb, uint8_t fragSize, uint8_t *file, uint32_t
     FragDecoder.FragSize = fragSize;                            // number of byte on a row
     FragDecoder.Status.FragNbLastRx = 0;
     FragDecoder.Status.FragNbLost = 0;
+    FragDecoder.Status.MatrixError = 0;
     FragDecoder.M2BLine = 0;
 
-    // Initialize missing fragments index array
-    for( uint16_t i = 0; i < FRAG_MAX_NB; i++ )
-    {
-        FragDecoder.FragNbMissingIndex[i] = 1;
-    }
-
-    // Initialize parity matrix
-    for( uint32_t i = 0; i < ( ( FRAG_MAX_REDUNDANCY >> 3 ) + 1 ); i++ )
-    {
-        FragDecoder.S[i] = 0;
-    }
+    // Initialize received fragments and parity matrix
+    memset1( ( uint8_t* )FragDecoder.FragReceived, 0, sizeof( FragDecoder.FragReceived ) );
+    memset1( ( uint8_t* )FragDecoder.S, 0, sizeof( FragDecoder.S ) );
 
-    for( uint32_t i = 0; i < ( ( ( FRAG_MAX_REDUNDANCY >> 3 ) + 1 ) * FRAG_MAX_REDUNDANCY ); i++ )
-    {
-       FragDecoder.MatrixM2B[i] = 0xFF;
-    }
-    
-    // Initialize final uncoded data buffer ( FRAG_MAX_NB * FRAG_MAX_SIZE )
-    for( uint32_t i = 0; i < ( fragNb * fragSize ); i++ )
+    // Initialize final uncoded data buffer ( FRAG_MAX_NB * FRAG_MAX_SIZE ),
+    // one row at a time
+    memset1( ( uint8_t* )FragDecoder.DataTemp, 0xFF, sizeof( FragDecoder.DataTemp ) );
+    for( uint16_t i = 0; i < fragNb; i++ )
     {
 #if( FRAG_DECODER_FILE_HANDLING_NEW_API == 1 )
-        if( ( FragDecoder.Callbacks != NULL ) && ( FragDecoder.Callbacks->FragDecoderWrite != NULL ) )
-        {
-            FragDecoder.Callbacks->FragDecoderWrite( i, ( uint8_t[] ){ 0xFF }, 1 );
-        }
+        SetRow( ( uint8_t* )FragDecoder.DataTemp, i, fragSize );
 #else
-        FragDecoder.File[i] = 0xFF;
+        SetRow( FragDecoder.File, ( uint8_t* )FragDecoder.DataTemp, i, fragSize );
 #endif
     }
-    FragDecoder.Status.FragNbLost = 0;
-    FragDecoder.Status.FragNbLastRx = 0;
 }
 
 #if( FRAG_DECODER_FILE_HANDLING_NEW_API == 1 )
@@ -303,19 +320,13 @@ int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t *rawData )
     int32_t first = 0;
     int32_t noInfo = 0;
 
-    uint8_t matrixRow[(FRAG_MAX_NB >> 3 ) + 1];
-    uint8_t matrixDataTemp[FRAG_MAX_SIZE];
-    uint8_t dataTempVector[( FRAG_MAX_REDUNDANCY >> 3 ) + 1];
-    uint8_t dataTempVector2[( FRAG_MAX_REDUNDANCY >> 3 ) + 1];
+    uint32_t dataTempVector[FRAG_BIT_WORDS( FRAG_MAX_REDUNDANCY )];
 
-    memset1( matrixRow, 0, ( FRAG_MAX_NB >> 3 ) + 1 );
-    memset1( matrixDataTemp, 0, FRAG_MAX_SIZE );
-    memset1( dataTempVector, 0, ( FRAG_MAX_REDUNDANCY >> 3 ) + 1 );
-    memset1( dataTempVector2, 0, ( FRAG_MAX_REDUNDANCY >> 3 ) + 1 );
+    memset1( ( uint8_t* )dataTempVector, 0, sizeof( dataTempVector ) );
 
     FragDecoder.Status.FragNbRx = fragCounter;
 
-    if( fragCounter < FragDecoder.Status.FragNbLastRx )
+    if( ( fragCounter == 0 ) || ( fragCounter < FragDecoder.Status.FragNbLastRx ) )
     {
         return FRAG_SESSION_ONGOING;  // Drop frame out of order
     }
@@ -331,13 +342,16 @@ int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t *rawData )
         SetRow( FragDecoder.File, rawData, fragCounter - 1, FragDecoder.FragSize );
 #endif
 
-        FragDecoder.FragNbMissingIndex[fragCounter - 1] = 0;
+        SetParity( fragCounter - 1, FragDecoder.FragReceived );
 
-        // Update the FragDecoder.FragNbMissingIndex with the loosing frame
+        // Update the FragDecoder.FragLostIndex with the loosing frame
         FragFindMissingFrags( fragCounter );
     }
     else
     {
+        // In case of the end of true data is missing
+        FragFindMissingFrags( fragCounter );
+
         if( FragDecoder.Status.FragNbLost > FRAG_MAX_REDUNDANCY )
         {
            FragDecoder.Status.MatrixError = 1;
@@ -346,42 +360,49 @@ int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t *rawData )
         // At this point we receive encoded frames and the number of loosing frames
         // is well known: FragDecoder.FragNbLost - 1;
 
-        // In case of the end of true data is missing
-        FragFindMissingFrags( fragCounter );
-
         if( FragDecoder.Status.FragNbLost == 0 )
         { 
             // the case : all the M(FragNb) first rows have been transmitted with no error
             return FragDecoder.Status.FragNbLost;
         }
 
+        uint16_t lostWords = FRAG_BIT_WORDS( FragDecoder.Status.FragNbLost );
+        uint16_t lost = 0;
+
+        memcpy1( ( uint8_t* )FragDecoder.DataLine, rawData, FragDecoder.FragSize );
+
         // fragCounter - FragDecoder.FragNb
-        FragGetParityMatrixRow( fragCounter - FragDecoder.FragNb, FragDecoder.FragNb, matrixRow );
+        FragGetParityMatrixRow( fragCounter - FragDecoder.FragNb, FragDecoder.FragNb, FragDecoder.MatrixRow );
 
-        for( int32_t i = 0; i < FragDecoder.FragNb; i++ )
+        for( uint16_t w = 0; w < FRAG_BIT_WORDS( FragDecoder.FragNb ); w++ )
         {
-            if( GetParity( i , matrixRow ) == 1 )
+            uint32_t received = FragDecoder.MatrixRow[w] & FragDecoder.FragReceived[w];
+            uint32_t missing = FragDecoder.MatrixRow[w] & ~FragDecoder.FragReceived[w];
+
+            while( received != 0 )
             {
-                if( FragDecoder.FragNbMissingIndex[i] == 0 )
-                {
-                    // XOR with already receive frag
-                    SetParity( i, matrixRow, 0 );
+                // XOR with already receive frag
 #if( FRAG_DECODER_FILE_HANDLING_NEW_API == 1 )
-                    GetRow( matrixDataTemp, i, FragDecoder.FragSize );
+                GetRow( ( uint8_t* )FragDecoder.DataTemp, ( w << 5 ) + LowestBit( received ), FragDecoder.FragSize );
 #else
-                    GetRow( matrixDataTemp, FragDecoder.File, i, FragDecoder.FragSize );
+                GetRow( ( uint8_t* )FragDecoder.DataTemp, FragDecoder.File, ( w << 5 ) + LowestBit( received ), FragDecoder.FragSize );
 #endif
-                    XorDataLine( rawData, matrixDataTemp, FragDecoder.FragSize );
-                }
-                else
+                XorDataLine( FragDecoder.DataLine, FragDecoder.DataTemp, FragDecoder.FragSize );
+                received &= received - 1;
+            }
+            while( missing != 0 )
+            {
+                // Fill the "little" boolean matrix m2b. The lost fragments are
+                // sorted, their rank is found by walking along the row.
+                uint16_t index = ( w << 5 ) + LowestBit( missing );
+
+                while( FragDecoder.FragLostIndex[lost] != index )
                 {
-                    // Fill the "little" boolean matrix m2b
-                    SetParity( FragDecoder.FragNbMissingIndex[i] - 1, dataTempVector, 1 );
-                    if( first == 0 )
-                    {
-                        first = 1;
-                    }
+                    lost++;
                 }
+                SetParity( lost, dataTempVector );
+                first = 1;
+                missing &= missing - 1;
             }
         }
 
@@ -389,23 +410,18 @@ int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t *rawData )
 
         if( first > 0 )
         {
-            int32_t li;
-            int32_t lj;
-
             // Manage a new line in MatrixM2B
             while( GetParity( firstOneInRow, FragDecoder.S ) == 1 )
             { 
                 // Row already diagonalized exist & ( FragDecoder.MatrixM2B[firstOneInRow][0] )
-                FragExtractLineFromBinaryMatrix( dataTempVector2, firstOneInRow, FragDecoder.Status.FragNbLost );
-                XorParityLine( dataTempVector, dataTempVector2, FragDecoder.Status.FragNbLost );
+                XorParityLine( &dataTempVector[firstOneInRow >> 5], FragGetM2BRow( firstOneInRow ), lostWords - ( firstOneInRow >> 5 ) );
                 // Have to store it in the mi th position of the missing frag
-                li = FragFindMissingIndex( firstOneInRow );
 #if( FRAG_DECODER_FILE_HANDLING_NEW_API == 1 )
-                GetRow( matrixDataTemp, li, FragDecoder.FragSize );
+                GetRow( ( uint8_t* )FragDecoder.DataTemp, FragDecoder.FragLostIndex[firstOneInRow], FragDecoder.FragSize );
 #else
-                GetRow( matrixDataTemp, FragDecoder.File, li, FragDecoder.FragSize );
+                GetRow( ( uint8_t* )FragDecoder.DataTemp, FragDecoder.File, FragDecoder.FragLostIndex[firstOneInRow], FragDecoder.FragSize );
 #endif
-                XorDataLine( rawData, matrixDataTemp, FragDecoder.FragSize );
+                XorDataLine( FragDecoder.DataLine, FragDecoder.DataTemp, FragDecoder.FragSize );
                 if( BitArrayIsAllZeros( dataTempVector, FragDecoder.Status.FragNbLost ) )
                 {
                     noInfo = 1;
@@ -416,63 +432,62 @@ int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t *rawData )
 
             if( noInfo == 0 )
             {
-                FragPushLineToBinaryMatrix( dataTempVector, firstOneInRow, FragDecoder.Status.FragNbLost );
-                li = FragFindMissingIndex( firstOneInRow );
+                // The bits below firstOneInRow are 0, the row is stored from
+                // the word holding its first one
+                memcpy1( ( uint8_t* )FragGetM2BRow( firstOneInRow ), ( uint8_t* )&dataTempVector[firstOneInRow >> 5],
+                         ( lostWords - ( firstOneInRow >> 5 ) ) * sizeof( uint32_t ) );
 #if( FRAG_DECODER_FILE_HANDLING_NEW_API == 1 )
-                SetRow( rawData, li, FragDecoder.FragSize );
+                SetRow( ( uint8_t* )FragDecoder.DataLine, FragDecoder.FragLostIndex[firstOneInRow], FragDecoder.FragSize );
 #else
-                SetRow( FragDecoder.File, rawData, li, FragDecoder.FragSize );
+                SetRow( FragDecoder.File, ( uint8_t* )FragDecoder.DataLine, FragDecoder.FragLostIndex[firstOneInRow], FragDecoder.FragSize );
 #endif
-                SetParity( firstOneInRow, FragDecoder.S, 1 );
+                SetParity( firstOneInRow, FragDecoder.S );
                 FragDecoder.M2BLine++;
             }
 
             if( FragDecoder.M2BLine == FragDecoder.Status.FragNbLost )
             { 
-                // Then last step diagonalized
-                if( FragDecoder.Status.FragNbLost > 1 )
+                // Then last step diagonalized. The rows are solved from the
+                // last one, so each row only needs the already solved
+                // fragments of its upper triangular part.
+                for( int32_t i = ( FragDecoder.Status.FragNbLost - 2 ); i >= 0 ; i-- )
                 {
-                    int32_t i, j;
+                    const uint32_t *row = FragGetM2BRow( i );
 
-                    for( i = ( FragDecoder.Status.FragNbLost - 2 ); i >= 0 ; i-- )
-                    {
-                        li = FragFindMissingIndex( i );
 #if( FRAG_DECODER_FILE_HANDLING_NEW_API == 1 )
-                        GetRow( matrixDataTemp, li, FragDecoder.FragSize );
+                    GetRow( ( uint8_t* )FragDecoder.DataTemp, FragDecoder.FragLostIndex[i], FragDecoder.FragSize );
 #else
-                        GetRow( matrixDataTemp, FragDecoder.File, li, FragDecoder.FragSize );
+                    GetRow( ( uint8_t* )FragDecoder.DataTemp, FragDecoder.File, FragDecoder.FragLostIndex[i], FragDecoder.FragSize );
 #endif
-                        for( j = ( FragDecoder.Status.FragNbLost - 1 ); j > i; j--)
-                        {
-                            FragExtractLineFromBinaryMatrix( dataTempVector2, i, FragDecoder.Status.FragNbLost );
-                            FragExtractLineFromBinaryMatrix( dataTempVector, j, FragDecoder.Status.FragNbLost );
-                            if( GetParity( j, dataTempVector2 ) == 1 )
-                            {
-                                XorParityLine( dataTempVector2, dataTempVector, FragDecoder.Status.FragNbLost );
+                    for( uint16_t w = ( i >> 5 ); w < lostWords; w++ )
+                    {
+                        uint32_t bits = row[w - ( i >> 5 )];
 
-                                lj = FragFindMissingIndex( j );
+                        if( w == ( i >> 5 ) )
+                        {
+                            // Skip the diagonal
+                            bits &= ~( ( uint32_t )1 << ( i & 31 ) );
+                        }
+                        while( bits != 0 )
+                        {
+                            uint16_t j = ( w << 5 ) + LowestBit( bits );
 
 #if( FRAG_DECODER_FILE_HANDLING_NEW_API == 1 )
-                                GetRow( rawData, lj, FragDecoder.FragSize );
+                            GetRow( ( uint8_t* )FragDecoder.DataLine, FragDecoder.FragLostIndex[j], FragDecoder.FragSize );
 #else
-                                GetRow( rawData, FragDecoder.File, lj, FragDecoder.FragSize );
+                            GetRow( ( uint8_t* )FragDecoder.DataLine, FragDecoder.File, FragDecoder.FragLostIndex[j], FragDecoder.FragSize );
 #endif
-                                XorDataLine( matrixDataTemp , rawData , FragDecoder.FragSize );
-                            }
+                            XorDataLine( FragDecoder.DataTemp, FragDecoder.DataLine, FragDecoder.FragSize );
+                            bits &= bits - 1;
                         }
+                    }
 #if( FRAG_DECODER_FILE_HANDLING_NEW_API == 1 )
-                        SetRow( matrixDataTemp, li, FragDecoder.FragSize );
+                    SetRow( ( uint8_t* )FragDecoder.DataTemp, FragDecoder.FragLostIndex[i], FragDecoder.FragSize );
 #else
-                        SetRow( FragDecoder.File, matrixDataTemp, li, FragDecoder.FragSize );
+                    SetRow( FragDecoder.File, ( uint8_t* )FragDecoder.DataTemp, FragDecoder.FragLostIndex[i], FragDecoder.FragSize );
 #endif
-                    }
-                    return FragDecoder.Status.FragNbLost;
-                }
-                else
-                { 
-                    //If not ( FragDecoder.FragNbLost > 1 )
-                    return FragDecoder.Status.FragNbLost;
                 }
+                return FragDecoder.Status.FragNbLost;
             }
         }
     }
@@ -495,7 +510,7 @@ static void SetRow( uint8_t *src, uint16_t row, uint16_t size )
 {
     if( ( FragDecoder.Callbacks != NULL ) && ( FragDecoder.Callbacks->FragDecoderWrite != NULL ) )
     {
-        FragDecoder.Callbacks->FragDecoderWrite( row * size, src, size );
+        FragDecoder.Callbacks->FragDecoderWrite( ( uint32_t )row * size, src, size );
     }
 }
 
@@ -503,64 +518,50 @@ static void GetRow( uint8_t *dst, uint16_t row, uint16_t size )
 {
     if( ( FragDecoder.Callbacks != NULL ) && ( FragDecoder.Callbacks->FragDecoderRead != NULL ) )
     {
-        FragDecoder.Callbacks->FragDecoderRead( row * size, dst, size );
+        FragDecoder.Callbacks->FragDecoderRead( ( uint32_t )row * size, dst, size );
     }
 }
 #else
 static void SetRow( uint8_t *dst, uint8_t *src, uint16_t row, uint16_t size )
 {
-    memcpy1( &dst[row * size], src, size );
+    memcpy1( &dst[( uint32_t )row * size], src, size );
 }
 
 static void GetRow( uint8_t *dst, uint8_t *src, uint16_t row, uint16_t size )
 {
-    memcpy1( dst, &src[row * size], size );
+    memcpy1( dst, &src[( uint32_t )row * size], size );
 }
 #endif
 
-static uint8_t GetParity( uint16_t index, uint8_t *matrixRow  )
+static uint8_t GetParity( uint16_t index, const uint32_t *matrixRow )
 {
-    uint8_t parity;
-    parity = matrixRow[index >> 3];
-    parity = ( parity >> ( 7 - ( index % 8 ) ) ) & 0x01;
-    return parity;
+    return ( matrixRow[index >> 5] >> ( index & 31 ) ) & 0x01;
 }
 
-static void SetParity( uint16_t index, uint8_t *matrixRow, uint8_t parity )
+static void SetParity( uint16_t index, uint32_t *matrixRow )
 {
-    uint8_t mask = 0xFF - ( 1 << ( 7 - ( index % 8 ) ) );
-    parity = parity << ( 7 - ( index % 8 ) );
-    matrixRow[index >> 3] = ( matrixRow[index >> 3] & mask ) + parity;
+    matrixRow[index >> 5] |= ( uint32_t )1 << ( index & 31 );
 }
 
 static bool IsPowerOfTwo( uint32_t x )
 {
-    uint8_t sumBit = 0;
-
-    for( uint8_t i = 0; i < 32; i++ )
-    {
-        sumBit += ( x & ( 1 << i ) ) >> i;
-    }
-    if( sumBit == 1 )
-    {
-        return true;
-    }
-    return false;
+    return ( x != 0 ) && ( ( x & ( x - 1 ) ) == 0 );
 }
 
-static void XorDataLine( uint8_t *line1, uint8_t *line2, int32_t size )
+static void XorDataLine( uint32_t *line1, const uint32_t *line2, int32_t size )
 {
-    for( int32_t i = 0; i < size; i++ )
+    // The lines are word buffers, the bytes past size are don't care
+    for( int32_t i = 0; i < FRAG_BIT_WORDS( size * 8 ); i++ )
     {
-        line1[i] = line1[i] ^ line2[i];
+        line1[i] ^= line2[i];
     }
 }
 
-static void XorParityLine( uint8_t* line1, uint8_t* line2, int32_t size )
+static void XorParityLine( uint32_t* line1, const uint32_t* line2, int32_t words )
 {
-    for( int32_t i = 0; i < size; i++ )
+    for( int32_t i = 0; i < words; i++ )
     {
-        SetParity( i, line1, ( GetParity( i, line1 ) ^ GetParity( i, line2 ) ) );
+        line1[i] ^= line2[i];
     }
 }
 
@@ -571,7 +572,7 @@ static int32_t FragPrbs23( int32_t value )
     return ( value >> 1 ) + ( ( b0 ^ b1 ) << 22 );;
 }
 
-static void FragGetParityMatrixRow( int32_t n, int32_t m, uint8_t *matrixRow )
+static void FragGetParityMatrixRow( int32_t n, int32_t m, uint32_t *matrixRow )
 {
     int32_t mTemp;
     int32_t x;
@@ -588,7 +589,7 @@ static void FragGetParityMatrixRow( int32_t n, int32_t m, uint8_t *matrixRow )
     }
 
     x = 1 + ( 1001 * n );
-    for( uint8_t i = 0; i < ( ( m >> 3 ) + 1 ); i++ )
+    for( uint16_t i = 0; i < FRAG_BIT_WORDS( m ); i++ )
     {
         matrixRow[i] = 0;
     }
@@ -600,28 +601,42 @@ static void FragGetParityMatrixRow( int32_t n, int32_t m, uint8_t *matrixRow )
             x = FragPrbs23( x );
             r = x % ( m + mTemp );
         }
-        SetParity( r, matrixRow, 1 );
+        SetParity( r, matrixRow );
         nbCoeff += 1;
     }
 }
 
-static uint16_t BitArrayFindFirstOne( uint8_t *bitArray, uint16_t size )
+/*!
+ * Bit index of a single bit set in a 32 bit word, see LowestBit
+ */
+static const uint8_t DeBruijnBitIndex[32] =
+{
+    0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+    31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+};
+
+static uint8_t LowestBit( uint32_t word )
+{
+    return DeBruijnBitIndex[( uint32_t )( ( word & ( ~word + 1 ) ) * 0x077CB531UL ) >> 27];
+}
+
+static uint16_t BitArrayFindFirstOne( const uint32_t *bitArray, uint16_t size )
 {
-    for( uint16_t i = 0; i < size; i++)
+    for( uint16_t i = 0; i < FRAG_BIT_WORDS( size ); i++ )
     {
-        if ( GetParity( i, bitArray ) == 1 )
+        if( bitArray[i] != 0 )
         {
-            return i;
+            return ( i << 5 ) + LowestBit( bitArray[i] );
         }
     }
     return 0;
 }
 
-static uint8_t BitArrayIsAllZeros( uint8_t *bitArray, uint16_t  size )
+static uint8_t BitArrayIsAllZeros( const uint32_t *bitArray, uint16_t size )
 {
-    for( uint16_t i = 0; i < size; i++ )
+    for( uint16_t i = 0; i < FRAG_BIT_WORDS( size ); i++ )
     {
-        if( GetParity( i, bitArray ) == 1 )
+        if( bitArray[i] != 0 )
         {
             return 0;
         }
@@ -633,7 +648,7 @@ static uint8_t BitArrayIsAllZeros( uint8_t *bitArray, uint16_t  size )
  * \brief Finds & marks missing fragments
  *
  * \param [IN]  counter Current fragment counter
- * \param [OUT] FragDecoder.FragNbMissingIndex[] array is updated in place
+ * \param [OUT] FragDecoder.FragLostIndex[] array is updated in place
  */
 static void FragFindMissingFrags( uint16_t counter )
 {
@@ -642,8 +657,13 @@ static void FragFindMissingFrags( uint16_t counter )
     {
         if( i < FragDecoder.FragNb )
         {
+            // Past FRAG_MAX_REDUNDANCY only the count is kept, the session
+            // can't be recovered anymore
+            if( FragDecoder.Status.FragNbLost < FRAG_MAX_REDUNDANCY )
+            {
+                FragDecoder.FragLostIndex[FragDecoder.Status.FragNbLost] = i;
+            }
             FragDecoder.Status.FragNbLost++;
-            FragDecoder.FragNbMissingIndex[i] = FragDecoder.Status.FragNbLost;
         }
     }
     if( i < FragDecoder.FragNb )
@@ -660,91 +680,12 @@ static void FragFindMissingFrags( uint16_t counter )
 }
 
 /*!
- * \brief Finds the index (frag counter) of the x th missing frag
- *
- * \param [IN] x   x th missing frag
- *
- * \retval counter The counter value associated to the x th missing frag
- */
-static uint16_t FragFindMissingIndex( uint16_t x )
-{
-    for( uint16_t i = 0; i < FragDecoder.FragNb; i++ )
-    {
-        if( FragDecoder.FragNbMissingIndex[i] == ( x + 1 ) )
-        {
-            return i;
-        }
-    }
-    return 0;
-}
-
-/*!
- * \brief Extacts a row from the binary matrix and expands it to a bitArray
- *
- * \param [IN] bitArray  Pointer to the bit array
- * \param [IN] rowIndex  Matrix row index
- * \param [IN] bitsInRow Number of bits in one row
- */
-static void FragExtractLineFromBinaryMatrix( uint8_t* bitArray, uint16_t rowIndex, uint16_t bitsInRow )
-{
-    uint32_t findByte = 0;
-    uint32_t findBitInByte = 0;
-
-    if( rowIndex > 0 )
-    {
-        findByte      = ( rowIndex * bitsInRow - ( ( rowIndex * ( rowIndex - 1 ) ) >> 1 ) ) >> 3;
-        findBitInByte = ( rowIndex * bitsInRow - ( ( rowIndex * ( rowIndex - 1 ) ) >> 1 ) ) % 8;
-    }
-    if( rowIndex > 0 )
-    {
-        for( uint16_t i = 0; i < rowIndex; i++ )
-        {
-            SetParity( i, bitArray, 0 );
-        }
-    }
-    for( uint16_t i = rowIndex; i < bitsInRow; i++ )
-    {
-        SetParity( i,
-                   bitArray, 
-                   ( FragDecoder.MatrixM2B[findByte] >> ( 7 - findBitInByte ) ) & 0x01 );
-
-        findBitInByte++;
-        if( findBitInByte == 8 )
-        {
-            findBitInByte = 0;
-            findByte++;
-        }
-    }
-}
-
-/*!
- * \brief Collapses and Pushs a row of a bit array to the matrix
+ * \brief Gets a row of the lost fragments matrix
  *
- * \param [IN] bitArray  Pointer to the bit array
  * \param [IN] rowIndex  Matrix row index
- * \param [IN] bitsInRow Number of bits in one row
+ * \retval row           Pointer to the word holding bit rowIndex of the row
  */
-static void FragPushLineToBinaryMatrix( uint8_t *bitArray, uint16_t rowIndex, uint16_t bitsInRow )
+static uint32_t* FragGetM2BRow( uint16_t rowIndex )
 {
-    uint32_t findByte = 0;
-    uint32_t findBitInByte = 0;
-
-    if ( rowIndex > 0) {
-        findByte      = ( rowIndex * bitsInRow - ( ( rowIndex * ( rowIndex - 1 ) ) >> 1 ) ) >> 3;
-        findBitInByte = ( rowIndex * bitsInRow - ( ( rowIndex * ( rowIndex - 1 ) ) >> 1 ) ) % 8;
-
-    }
-    for( uint16_t i = rowIndex; i < bitsInRow; i++ )
-    {
-        if( GetParity( i, bitArray ) == 0 )
-        {
-            FragDecoder.MatrixM2B[findByte] = FragDecoder.MatrixM2B[findByte] & ( 0xFF - ( 1 << ( 7 - findBitInByte ) ) );
-        }
-        findBitInByte++;
-        if( findBitInByte == 8 )
-        {
-            findBitInByte = 0;
-            findByte++;
-        }
-    }
+    return &FragDecoder.MatrixM2B[FRAG_M2B_ROW_OFFSET( ( uint32_t )rowIndex, ( uint32_t )FRAG_BIT_WORDS( FragDecoder.Status.FragNbLost ) )];
 }
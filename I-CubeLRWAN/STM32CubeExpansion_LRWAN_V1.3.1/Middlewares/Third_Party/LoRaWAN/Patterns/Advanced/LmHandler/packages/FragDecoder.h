@@ -34,23 +34,34 @@
 /*!
  * Maximum number of fragment that can be handled.
  *
- * \remark This parameter has an impact on the memory footprint.
+ * \remark This parameter has an impact on the memory footprint: 2 bits of
+ *         RAM per fragment. Sessions of thousands of fragments are supported.
  */
+#ifndef FRAG_MAX_NB
 #define FRAG_MAX_NB                                 21
+#endif
 
 /*!
  * Maximum fragment size that can be handled.
  *
- * \remark This parameter has an impact on the memory footprint.
+ * \remark This parameter has an impact on the memory footprint: 2 bytes of
+ *         RAM per byte of fragment.
  */
+#ifndef FRAG_MAX_SIZE
 #define FRAG_MAX_SIZE                               50
+#endif
 
 /*!
- * Maximum number of extra frames that can be handled.
+ * Maximum number of extra frames that can be handled, which is also the
+ * maximum number of lost fragments that can be recovered.
  *
- * \remark This parameter has an impact on the memory footprint.
+ * \remark This parameter has an impact on the memory footprint: about
+ *         FRAG_MAX_REDUNDANCY * FRAG_MAX_REDUNDANCY / 16 bytes of RAM for the
+ *         lost fragments matrix, e.g. 10 Kbytes for 400 lost fragments.
  */
+#ifndef FRAG_MAX_REDUNDANCY
 #define FRAG_MAX_REDUNDANCY                         5
+#endif
 
 #define FRAG_SESSION_FINISHED                       ( int32_t )0
 #define FRAG_SESSION_NOT_STARTED                    ( int32_t )-2
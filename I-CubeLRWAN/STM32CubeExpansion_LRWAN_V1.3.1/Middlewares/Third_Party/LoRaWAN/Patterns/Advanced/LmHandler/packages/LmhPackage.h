@@ -28,7 +28,7 @@
 /*!
  * Maximum number of packages
  */
-#define PKG_MAX_NUMBER                              4
+#define PKG_MAX_NUMBER                              5
 
 typedef struct LmhPackage_s
 {
@@ -0,0 +1,420 @@
+/*!
+ * \file      LmhpAggregation.c
+ *
+ * \brief     Implements the uplink aggregation package
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2018 Semtech
+ *
+ * \endcode
+ */
+#include "utilities.h"
+#include "timer.h"
+#include "LmHandler.h"
+#include "LmhpAggregation.h"
+
+/*!
+ * Size of the length prefix of a record
+ */
+#define AGGREGATION_RECORD_HEADER_SIZE              1
+
+/*!
+ * Delay before retrying a frame the handler didn't accept [ms]
+ */
+#define AGGREGATION_RETRY_DELAY                     5000
+
+/*!
+ * Package current context
+ */
+typedef struct LmhpAggregationState_s
+{
+    bool Initialized;
+    bool IsRunning;
+    LmHandlerMsgTypes_t MsgType;
+    uint32_t MaxDelay;
+    uint8_t Buffer[AGGREGATION_BUFFER_MAX_SIZE];
+    uint8_t BufferSize;
+    /*!
+     * The pending records must be sent as soon as the MAC is available
+     */
+    bool FlushPending;
+    /*!
+     * The last frame wasn't accepted, waiting for the retry delay
+     */
+    bool RetryPending;
+    /*!
+     * Set by the timer, handled by LmhpAggregationProcess
+     */
+    volatile bool TxTimerElapsed;
+    /*!
+     * Records carried by the frame waiting for its MCPS confirm, 0 if none
+     */
+    uint8_t TxRecords;
+    LmhpAggregationStats_t Stats;
+}LmhpAggregationState_t;
+
+/*!
+ * Initializes the package with provided parameters
+ *
+ * \param [IN] params            Pointer to the package parameters
+ * \param [IN] dataBuffer        Pointer to main application buffer
+ * \param [IN] dataBufferMaxSize Main application buffer maximum size
+ */
+static void LmhpAggregationInit( void *params, uint8_t *dataBuffer, uint8_t dataBufferMaxSize );
+
+/*!
+ * Returns the current package initialization status.
+ *
+ * \retval status Package initialization status
+ *                [true: Initialized, false: Not initialized]
+ */
+static bool LmhpAggregationIsInitialized( void );
+
+/*!
+ * Returns the package operation status.
+ *
+ * \retval status Package operation status
+ *                [true: Running, false: Not running]
+ */
+static bool LmhpAggregationIsRunning( void );
+
+/*!
+ * Processes the internal package events.
+ */
+static void LmhpAggregationProcess( void );
+
+/*!
+ * Processes the MCSP Confirm
+ *
+ * \param [IN] mcpsConfirm MCPS confirmation primitive data
+ */
+static void LmhpAggregationOnMcpsConfirm( McpsConfirm_t *mcpsConfirm );
+
+/*!
+ * Sends the records fitting in the maximum payload of the current datarate
+ */
+static void LmhpAggregationSend( void );
+
+/*!
+ * Requests a flush when no further record fits in the frame, otherwise
+ * makes sure the maximum delay timer runs for the pending records
+ */
+static void LmhpAggregationUpdateTriggers( void );
+
+/*!
+ * Removes the first records of the buffer
+ *
+ * \param [IN] size Size of the records to remove, framing included
+ */
+static void LmhpAggregationRemove( uint8_t size );
+
+/*!
+ * Function executed on the maximum delay or retry timer event
+ */
+static void OnAggregationTxTimerEvent( void *context );
+
+static LmhpAggregationState_t LmhpAggregationState =
+{
+    .Initialized = false,
+    .IsRunning = false,
+    .BufferSize = 0,
+    .FlushPending = false,
+    .RetryPending = false,
+    .TxTimerElapsed = false,
+    .TxRecords = 0
+};
+
+static LmhPackage_t LmhpAggregationPackage =
+{
+    .Port = 0,                                                 // Given by the package parameters
+    .Init = LmhpAggregationInit,
+    .IsInitialized = LmhpAggregationIsInitialized,
+    .IsRunning = LmhpAggregationIsRunning,
+    .Process = LmhpAggregationProcess,
+    .OnMcpsConfirmProcess = LmhpAggregationOnMcpsConfirm,
+    .OnMcpsIndicationProcess = NULL,                           // Not used in this package
+    .OnMlmeConfirmProcess = NULL,                              // Not used in this package
+    .OnMlmeIndicationProcess = NULL,                           // Not used in this package
+    .OnMacMcpsRequest = NULL,                                  // To be initialized by LmHandler
+    .OnMacMlmeRequest = NULL,                                  // To be initialized by LmHandler
+    .OnJoinRequest = NULL,                                     // To be initialized by LmHandler
+    .OnSendRequest = NULL,                                     // To be initialized by LmHandler
+    .OnDeviceTimeRequest = NULL,                               // To be initialized by LmHandler
+    .OnSysTimeUpdate = NULL,                                   // To be initialized by LmHandler
+};
+
+/*!
+ * Maximum delay and retry timer
+ */
+static TimerEvent_t AggregationTxTimer;
+
+LmhPackage_t *LmhpAggregationPackageFactory( void )
+{
+    return &LmhpAggregationPackage;
+}
+
+static void LmhpAggregationInit( void *params, uint8_t *dataBuffer, uint8_t dataBufferMaxSize )
+{
+    LmhpAggregationParams_t *aggregationParams = ( LmhpAggregationParams_t* )params;
+
+    if( aggregationParams != NULL )
+    {
+        // The records are packed in the package own buffer, the main
+        // application buffer stays available to the application.
+        LmhpAggregationPackage.Port = aggregationParams->Port;
+        LmhpAggregationState.MsgType = aggregationParams->MsgType;
+        LmhpAggregationState.MaxDelay = aggregationParams->MaxDelay;
+        LmhpAggregationState.BufferSize = 0;
+        LmhpAggregationState.FlushPending = false;
+        LmhpAggregationState.RetryPending = false;
+        LmhpAggregationState.TxTimerElapsed = false;
+        LmhpAggregationState.TxRecords = 0;
+        memset1( ( uint8_t* )&LmhpAggregationState.Stats, 0, sizeof( LmhpAggregationStats_t ) );
+
+        TimerInit( &AggregationTxTimer, OnAggregationTxTimerEvent );
+
+        LmhpAggregationState.Initialized = true;
+        LmhpAggregationState.IsRunning = true;
+    }
+    else
+    {
+        LmhpAggregationState.IsRunning = false;
+        LmhpAggregationState.Initialized = false;
+    }
+}
+
+static bool LmhpAggregationIsInitialized( void )
+{
+    return LmhpAggregationState.Initialized;
+}
+
+static bool LmhpAggregationIsRunning( void )
+{
+    if( LmhpAggregationState.Initialized == false )
+    {
+        return false;
+    }
+
+    return LmhpAggregationState.IsRunning;
+}
+
+static void LmhpAggregationProcess( void )
+{
+    if( LmhpAggregationState.TxTimerElapsed == true )
+    {
+        LmhpAggregationState.TxTimerElapsed = false;
+
+        if( LmhpAggregationState.RetryPending == true )
+        {
+            LmhpAggregationState.RetryPending = false;
+        }
+        else if( ( LmhpAggregationState.BufferSize != 0 ) && ( LmhpAggregationState.FlushPending == false ) )
+        {
+            LmhpAggregationState.FlushPending = true;
+            LmhpAggregationState.Stats.DelayFlushes++;
+        }
+    }
+
+    if( ( LmhpAggregationState.FlushPending == false ) ||
+        ( LmhpAggregationState.RetryPending == true ) ||
+        ( LmhpAggregationState.TxRecords != 0 ) ||
+        ( LoRaMacIsBusy( ) == true ) )
+    {
+        return;
+    }
+
+    LmhpAggregationSend( );
+}
+
+static void LmhpAggregationOnMcpsConfirm( McpsConfirm_t *mcpsConfirm )
+{
+    if( LmhpAggregationState.TxRecords == 0 )
+    {
+        // Not an aggregated frame
+        return;
+    }
+
+    if( ( mcpsConfirm->Status == LORAMAC_EVENT_INFO_STATUS_OK ) &&
+        ( ( mcpsConfirm->McpsRequest != MCPS_CONFIRMED ) || ( mcpsConfirm->AckReceived == true ) ) )
+    {
+        LmhpAggregationState.Stats.FramesDelivered++;
+        LmhpAggregationState.Stats.RecordsDelivered += LmhpAggregationState.TxRecords;
+    }
+    else
+    {
+        LmhpAggregationState.Stats.FramesLost++;
+        LmhpAggregationState.Stats.RecordsLost += LmhpAggregationState.TxRecords;
+    }
+    LmhpAggregationState.TxRecords = 0;
+}
+
+static void LmhpAggregationSend( void )
+{
+    LoRaMacTxInfo_t txInfo = { 0 };
+    uint8_t size = 0;
+    uint8_t nbRecords = 0;
+    uint8_t recordSize;
+
+    if( LmhpAggregationState.BufferSize == 0 )
+    {
+        LmhpAggregationState.FlushPending = false;
+        return;
+    }
+
+    // The datarate may have changed since the records were queued, only the
+    // records fitting in the current frame are sent.
+    LoRaMacQueryTxPossible( 0, &txInfo );
+    while( size < LmhpAggregationState.BufferSize )
+    {
+        recordSize = AGGREGATION_RECORD_HEADER_SIZE + LmhpAggregationState.Buffer[size];
+        if( ( size + recordSize ) > txInfo.MaxPossibleApplicationDataSize )
+        {
+            break;
+        }
+        size += recordSize;
+        nbRecords++;
+    }
+
+    if( nbRecords == 0 )
+    {
+        recordSize = AGGREGATION_RECORD_HEADER_SIZE + LmhpAggregationState.Buffer[0];
+        if( recordSize > txInfo.CurrentPossiblePayloadSize )
+        {
+            // The record can't be sent at this datarate, it would block the
+            // following ones.
+            LmhpAggregationRemove( recordSize );
+            LmhpAggregationState.Stats.RecordsLost++;
+            LmhpAggregationUpdateTriggers( );
+            return;
+        }
+        // The pending MAC commands leave no room for the record, the handler
+        // sends an empty frame to flush them and the records are sent next.
+    }
+
+    LmHandlerAppData_t appData =
+    {
+        .Buffer = LmhpAggregationState.Buffer,
+        .BufferSize = size,
+        .Port = LmhpAggregationPackage.Port
+    };
+
+    if( LmhpAggregationPackage.OnSendRequest( &appData, LmhpAggregationState.MsgType ) != LORAMAC_HANDLER_SUCCESS )
+    {
+        // Not joined, duty cycle or compliance test running
+        LmhpAggregationState.RetryPending = true;
+        TimerStop( &AggregationTxTimer );
+        TimerSetValue( &AggregationTxTimer, AGGREGATION_RETRY_DELAY );
+        TimerStart( &AggregationTxTimer );
+        return;
+    }
+
+    if( nbRecords == 0 )
+    {
+        return;
+    }
+
+    // The MAC keeps its own copy of the payload
+    LmhpAggregationState.TxRecords = nbRecords;
+    LmhpAggregationState.Stats.BytesSent += size;
+    LmhpAggregationRemove( size );
+    LmhpAggregationState.FlushPending = false;
+    LmhpAggregationUpdateTriggers( );
+}
+
+static void LmhpAggregationUpdateTriggers( void )
+{
+    LoRaMacTxInfo_t txInfo = { 0 };
+
+    if( LmhpAggregationState.BufferSize == 0 )
+    {
+        LmhpAggregationState.FlushPending = false;
+        if( LmhpAggregationState.RetryPending == false )
+        {
+            TimerStop( &AggregationTxTimer );
+        }
+        return;
+    }
+
+    LoRaMacQueryTxPossible( 0, &txInfo );
+    if( ( LmhpAggregationState.BufferSize + AGGREGATION_RECORD_HEADER_SIZE + 1 ) > txInfo.CurrentPossiblePayloadSize )
+    {
+        if( LmhpAggregationState.FlushPending == false )
+        {
+            LmhpAggregationState.FlushPending = true;
+            LmhpAggregationState.Stats.SizeFlushes++;
+        }
+    }
+    else if( TimerIsStarted( &AggregationTxTimer ) == false )
+    {
+        TimerSetValue( &AggregationTxTimer, LmhpAggregationState.MaxDelay );
+        TimerStart( &AggregationTxTimer );
+    }
+}
+
+static void LmhpAggregationRemove( uint8_t size )
+{
+    LmhpAggregationState.BufferSize -= size;
+    // memcpy1 copies upwards, the areas may overlap
+    memcpy1( LmhpAggregationState.Buffer, LmhpAggregationState.Buffer + size, LmhpAggregationState.BufferSize );
+}
+
+LmHandlerErrorStatus_t LmhpAggregationAdd( uint8_t *record, uint8_t size )
+{
+    LoRaMacTxInfo_t txInfo = { 0 };
+
+    if( ( LmhpAggregationState.Initialized == false ) || ( record == NULL ) || ( size == 0 ) )
+    {
+        return LORAMAC_HANDLER_ERROR;
+    }
+
+    LoRaMacQueryTxPossible( 0, &txInfo );
+    if( ( ( AGGREGATION_RECORD_HEADER_SIZE + size ) > txInfo.CurrentPossiblePayloadSize ) ||
+        ( ( LmhpAggregationState.BufferSize + AGGREGATION_RECORD_HEADER_SIZE + size ) > AGGREGATION_BUFFER_MAX_SIZE ) )
+    {
+        LmhpAggregationState.Stats.RecordsDropped++;
+        return LORAMAC_HANDLER_ERROR;
+    }
+
+    LmhpAggregationState.Buffer[LmhpAggregationState.BufferSize++] = size;
+    memcpy1( LmhpAggregationState.Buffer + LmhpAggregationState.BufferSize, record, size );
+    LmhpAggregationState.BufferSize += size;
+    LmhpAggregationState.Stats.RecordsAdded++;
+
+    LmhpAggregationUpdateTriggers( );
+    return LORAMAC_HANDLER_SUCCESS;
+}
+
+LmHandlerErrorStatus_t LmhpAggregationFlush( void )
+{
+    if( LmhpAggregationState.Initialized == false )
+    {
+        return LORAMAC_HANDLER_ERROR;
+    }
+
+    if( LmhpAggregationState.BufferSize != 0 )
+    {
+        LmhpAggregationState.FlushPending = true;
+    }
+    return LORAMAC_HANDLER_SUCCESS;
+}
+
+void LmhpAggregationGetStats( LmhpAggregationStats_t *stats )
+{
+    if( stats != NULL )
+    {
+        *stats = LmhpAggregationState.Stats;
+    }
+}
+
+static void OnAggregationTxTimerEvent( void *context )
+{
+    LmhpAggregationState.TxTimerElapsed = true;
+}
@@ -0,0 +1,137 @@
+/*!
+ * \file      LmhpAggregation.h
+ *
+ * \brief     Implements the uplink aggregation package
+ *
+ * \details   Application records are packed into a single uplink instead of
+ *            being sent one frame each. Each record is prefixed with its
+ *            length on one byte:
+ *
+ *            | Size (1) | Record (Size) | Size (1) | Record (Size) | ...
+ *
+ *            The frame is sent as soon as no further record fits in the
+ *            maximum application payload of the current datarate, or when
+ *            the oldest pending record reaches the maximum delay.
+ *
+ * \copyright Revised BSD License, see section \ref LICENSE.
+ *
+ * \code
+ *                ______                              _
+ *               / _____)             _              | |
+ *              ( (____  _____ ____ _| |_ _____  ____| |__
+ *               \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ *               _____) ) ____| | | || |_| ____( (___| | | |
+ *              (______/|_____)_|_|_| \__)_____)\____)_| |_|
+ *              (C)2013-2018 Semtech
+ *
+ * \endcode
+ */
+#ifndef __LMHP_AGGREGATION_H__
+#define __LMHP_AGGREGATION_H__
+
+#include "LoRaMac.h"
+#include "LmHandlerTypes.h"
+#include "LmhPackage.h"
+
+/*!
+ * Aggregation package identifier.
+ *
+ * \remark This value must be unique amongst the packages
+ */
+#define PACKAGE_ID_AGGREGATION                      4
+
+/*!
+ * Maximum size of the pending records, framing included
+ */
+#define AGGREGATION_BUFFER_MAX_SIZE                 242
+
+/*!
+ * Aggregation package parameters
+ */
+typedef struct LmhpAggregationParams_s
+{
+    /*!
+     * Port the aggregated frames are sent on
+     */
+    uint8_t Port;
+    /*!
+     * Type of the aggregated frames
+     */
+    LmHandlerMsgTypes_t MsgType;
+    /*!
+     * Maximum time a record waits before being sent [ms]
+     */
+    uint32_t MaxDelay;
+}LmhpAggregationParams_t;
+
+/*!
+ * Aggregation package delivery statistics
+ */
+typedef struct LmhpAggregationStats_s
+{
+    /*!
+     * Records accepted by LmhpAggregationAdd
+     */
+    uint32_t RecordsAdded;
+    /*!
+     * Records rejected because the buffer was full
+     */
+    uint32_t RecordsDropped;
+    /*!
+     * Records carried by a frame confirmed by the MAC
+     */
+    uint32_t RecordsDelivered;
+    /*!
+     * Records carried by a frame which failed
+     */
+    uint32_t RecordsLost;
+    /*!
+     * Frames confirmed by the MAC (acknowledged for confirmed frames)
+     */
+    uint32_t FramesDelivered;
+    /*!
+     * Frames not acknowledged or aborted by the MAC
+     */
+    uint32_t FramesLost;
+    /*!
+     * Application bytes sent, framing included
+     */
+    uint32_t BytesSent;
+    /*!
+     * Flushes triggered by a full frame
+     */
+    uint32_t SizeFlushes;
+    /*!
+     * Flushes triggered by the maximum delay
+     */
+    uint32_t DelayFlushes;
+}LmhpAggregationStats_t;
+
+LmhPackage_t *LmhpAggregationPackageFactory( void );
+
+/*!
+ * Queues a record for the next aggregated frame
+ *
+ * \param [IN] record Record to send
+ * \param [IN] size   Record size, at most AGGREGATION_BUFFER_MAX_SIZE - 1
+ *
+ * \retval status [LORAMAC_HANDLER_SUCCESS, LORAMAC_HANDLER_ERROR]
+ */
+LmHandlerErrorStatus_t LmhpAggregationAdd( uint8_t *record, uint8_t size );
+
+/*!
+ * Sends the pending records without waiting for the frame to be full or
+ * for the maximum delay
+ *
+ * \retval status [LORAMAC_HANDLER_SUCCESS, LORAMAC_HANDLER_ERROR]
+ */
+LmHandlerErrorStatus_t LmhpAggregationFlush( void );
+
+/*!
+ * Returns the delivery statistics
+ *
+ * \param [OUT] stats Delivery statistics
+ */
+void LmhpAggregationGetStats( LmhpAggregationStats_t *stats );
+
+#endif // __LMHP_AGGREGATION_H__
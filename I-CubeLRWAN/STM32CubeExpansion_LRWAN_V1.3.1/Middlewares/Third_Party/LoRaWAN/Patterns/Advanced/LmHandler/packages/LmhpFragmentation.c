@@ -297,6 +297,11 @@ static void LmhpFragmentationOnMcpsIndication( McpsIndication_t *mcpsIndication
                     status |= 0x02; // Not enough Memory
                 }
 #endif
+                if( ( fragSessionData.FragGroupData.FragNb > FRAG_MAX_NB ) ||
+                    ( fragSessionData.FragGroupData.FragSize > FRAG_MAX_SIZE ) )
+                {
+                    status |= 0x02; // Not enough Memory for the decoder
+                }
                 status |= ( fragSessionData.FragGroupData.FragSession.Fields.FragIndex << 6 ) & 0xC0;
                 if( fragSessionData.FragGroupData.FragSession.Fields.FragIndex >= FRAGMENTATION_MAX_SESSIONS )
                 {
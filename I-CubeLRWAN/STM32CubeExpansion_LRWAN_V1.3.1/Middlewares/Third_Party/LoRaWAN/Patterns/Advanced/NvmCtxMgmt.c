@@ -36,18 +36,21 @@
 #include "utilities.h"
 
 
-
 /*!
  * Enables/Disables the context storage management storage at all. Must be enabled for LoRaWAN 1.1.x.
  * WARNING: Still under development and not tested yet.
  */
+#ifndef CONTEXT_MANAGEMENT_ENABLED
 #define CONTEXT_MANAGEMENT_ENABLED         0
+#endif
 
 /*!
  * Enables/Disables maximum persistent context storage management. All module contexts will be saved on a non-volatile memory.
  * WARNING: Still under development and not tested yet.
  */
+#ifndef MAX_PERSISTENT_CTX_MGMT_ENABLED
 #define MAX_PERSISTENT_CTX_MGMT_ENABLED    0
+#endif
 
 #if ( MAX_PERSISTENT_CTX_MGMT_ENABLED == 1 )
 #define NVM_CTX_STORAGE_MASK               0xFF
@@ -56,6 +59,110 @@
 #endif
 
 #if ( CONTEXT_MANAGEMENT_ENABLED == 1 )
+/*!
+ * The contexts are stored in a journal spread over NVM_CTX_JOURNAL_PAGES pages
+ * provided by the platform, see \ref NvmCtxMgmtPageRead.
+ *
+ * The active page starts with a snapshot of all the stored contexts, followed
+ * by records holding the bytes of a context which changed since it was last
+ * written. The frame counters changing on every uplink thus cost a record of a
+ * few bytes instead of a rewrite of the whole contexts.
+ *
+ * When the active page is full, a new snapshot is written to the next page,
+ * which is the only page erased. The pages are used round-robin, which levels
+ * the wear, and the previous page remains valid until the new snapshot is
+ * complete. On restore, the page with the highest sequence number is replayed
+ * up to its first blank or corrupted record.
+ */
+
+/*!
+ * Number of pages of the journal, at least 2
+ */
+#ifndef NVM_CTX_JOURNAL_PAGES
+#define NVM_CTX_JOURNAL_PAGES              4
+#endif
+
+/*!
+ * Size of a journal page in bytes, must hold a snapshot of all the stored
+ * contexts
+ */
+#ifndef NVM_CTX_JOURNAL_PAGE_SIZE
+#if ( MAX_PERSISTENT_CTX_MGMT_ENABLED == 1 )
+#define NVM_CTX_JOURNAL_PAGE_SIZE          4096
+#else
+#define NVM_CTX_JOURNAL_PAGE_SIZE          2048
+#endif
+#endif
+
+/*!
+ * Programming unit of the memory in bytes. Every write is a multiple of it, is
+ * aligned on it and targets erased memory (8 for the STM32L4 flash double-word)
+ */
+#ifndef NVM_CTX_JOURNAL_WRITE_SIZE
+#define NVM_CTX_JOURNAL_WRITE_SIZE         8
+#endif
+
+/*!
+ * Value of an erased byte
+ */
+#ifndef NVM_CTX_JOURNAL_ERASED_VALUE
+#define NVM_CTX_JOURNAL_ERASED_VALUE       0xFF
+#endif
+
+/*!
+ * Size in bytes of the RAM copy of the stored contexts, must hold all of them
+ */
+#ifndef NVM_CTX_SHADOW_SIZE
+#if ( MAX_PERSISTENT_CTX_MGMT_ENABLED == 1 )
+#define NVM_CTX_SHADOW_SIZE                3072
+#else
+#define NVM_CTX_SHADOW_SIZE                1024
+#endif
+#endif
+
+#if ( NVM_CTX_JOURNAL_PAGES < 2 )
+#error "The context journal needs at least 2 pages"
+#endif
+
+/*!
+ * Number of modules having a context
+ */
+#define NVM_CTX_MODULES                    ( LORAMAC_NVMCTXMODULE_CONFIRM_QUEUE + 1 )
+
+/*!
+ * Size rounded up to the programming unit
+ */
+#define NVM_CTX_JOURNAL_ALIGN( size )      ( ( ( size ) + NVM_CTX_JOURNAL_WRITE_SIZE - 1 ) / NVM_CTX_JOURNAL_WRITE_SIZE * NVM_CTX_JOURNAL_WRITE_SIZE )
+
+/*!
+ * Page header: magic (2), sequence number (4), CRC (2)
+ */
+#define NVM_CTX_PAGE_HEADER_SIZE           8
+#define NVM_CTX_PAGE_MAGIC                 0x4A4E
+
+/*!
+ * Record header: tag (1), module (1), offset (2), length (2), CRC (2), followed
+ * by the data. The CRC covers the header fields and the data.
+ *
+ * The last record of a snapshot or of a store carries the commit tag. The
+ * records following the last commit are ignored on restore, so that the
+ * contexts are restored as left by a complete store.
+ */
+#define NVM_CTX_RECORD_HEADER_SIZE         8
+#define NVM_CTX_RECORD_TAG                 0x5A
+#define NVM_CTX_RECORD_TAG_COMMIT          0xA5
+
+/*!
+ * Space taken by the page header and by a record header in the journal
+ */
+#define NVM_CTX_PAGE_HEADER_SPACE          NVM_CTX_JOURNAL_ALIGN( NVM_CTX_PAGE_HEADER_SIZE )
+#define NVM_CTX_RECORD_HEADER_SPACE        NVM_CTX_JOURNAL_ALIGN( NVM_CTX_RECORD_HEADER_SIZE )
+
+/*!
+ * Space taken by a record of length bytes in the journal
+ */
+#define NVM_CTX_RECORD_SPACE( length )     ( NVM_CTX_RECORD_HEADER_SPACE + NVM_CTX_JOURNAL_ALIGN( length ) )
+
 /*!
  * LoRaMAC Structure holding contexts changed status
  * in case of a \ref MLME_NVM_CTXS_UPDATE indication.
@@ -109,58 +216,174 @@ typedef union uLoRaMacCtxsUpdateInfo
 
 LoRaMacCtxUpdateStatus_t CtxUpdateStatus = { .Value = 0 };
 
-/*
- * Nvmm handles
+/*!
+ * Context journal state
  */
-static NvmmDataBlock_t SecureElementNvmCtxDataBlock;
-static NvmmDataBlock_t CryptoNvmCtxDataBlock;
-#if ( MAX_PERSISTENT_CTX_MGMT_ENABLED == 1 )
-static NvmmDataBlock_t MacNvmCtxDataBlock;
-static NvmmDataBlock_t RegionNvmCtxDataBlock;
-static NvmmDataBlock_t CommandsNvmCtxDataBlock;
-static NvmmDataBlock_t ConfirmQueueNvmCtxDataBlock;
-static NvmmDataBlock_t ClassBNvmCtxDataBlock;
-#endif
-#endif
+typedef struct sNvmCtxJournal
+{
+    /*!
+     * Location of each stored context in the shadow
+     */
+    uint16_t ShadowOffset[NVM_CTX_MODULES];
+    /*!
+     * Size of each stored context, 0 if the context is not stored
+     */
+    uint16_t ShadowSize[NVM_CTX_MODULES];
+    /*!
+     * Set once the shadow layout is known
+     */
+    bool Ready;
+    /*!
+     * Active page, NVM_CTX_JOURNAL_PAGES if there is none
+     */
+    uint8_t Page;
+    /*!
+     * Sequence number of the active page
+     */
+    uint32_t Sequence;
+    /*!
+     * Offset of the next record in the active page
+     */
+    uint32_t WriteOffset;
+}NvmCtxJournal_t;
 
-void NvmCtxMgmtEvent( LoRaMacNvmCtxModule_t module )
+static NvmCtxJournal_t Journal = { .Page = NVM_CTX_JOURNAL_PAGES };
+
+/*!
+ * Stored contexts as last written to the journal
+ */
+static uint8_t Shadow[NVM_CTX_SHADOW_SIZE];
+
+/*!
+ * \brief Computes the CRC-16 CCITT of a buffer
+ *
+ * \param [IN] crc    CRC of the previous data
+ * \param [IN] buffer Data
+ * \param [IN] length Data length
+ *
+ * \retval Updated CRC
+ */
+static uint16_t JournalCrc( uint16_t crc, const uint8_t* buffer, uint16_t length )
+{
+    for( uint16_t i = 0; i < length; i++ )
+    {
+        crc ^= ( uint16_t )buffer[i] << 8;
+        for( uint8_t j = 0; j < 8; j++ )
+        {
+            crc = ( crc & 0x8000 ) ? ( crc << 1 ) ^ 0x1021 : ( crc << 1 );
+        }
+    }
+    return crc;
+}
+
+/*!
+ * \brief Returns the context of a module
+ *
+ * \param [IN]  contexts Contexts of the MAC
+ * \param [IN]  module   Module
+ * \param [OUT] size     Context size
+ *
+ * \retval Context, NULL if the module has none
+ */
+static uint8_t* GetModuleCtx( LoRaMacCtxs_t* contexts, uint8_t module, size_t* size )
 {
-#if ( CONTEXT_MANAGEMENT_ENABLED == 1 )
     switch( module )
     {
         case LORAMAC_NVMCTXMODULE_MAC:
         {
-            CtxUpdateStatus.Elements.Mac = 1;
+            *size = contexts->MacNvmCtxSize;
+            return contexts->MacNvmCtx;
+        }
+        case LORAMAC_NVMCTXMODULE_REGION:
+        {
+            *size = contexts->RegionNvmCtxSize;
+            return contexts->RegionNvmCtx;
+        }
+        case LORAMAC_NVMCTXMODULE_CRYPTO:
+        {
+            *size = contexts->CryptoNvmCtxSize;
+            return contexts->CryptoNvmCtx;
+        }
+        case LORAMAC_NVMCTXMODULE_SECURE_ELEMENT:
+        {
+            *size = contexts->SecureElementNvmCtxSize;
+            return contexts->SecureElementNvmCtx;
+        }
+        case LORAMAC_NVMCTXMODULE_COMMANDS:
+        {
+            *size = contexts->CommandsNvmCtxSize;
+            return contexts->CommandsNvmCtx;
+        }
+        case LORAMAC_NVMCTXMODULE_CLASS_B:
+        {
+            *size = contexts->ClassBNvmCtxSize;
+            return contexts->ClassBNvmCtx;
+        }
+        case LORAMAC_NVMCTXMODULE_CONFIRM_QUEUE:
+        {
+            *size = contexts->ConfirmQueueNvmCtxSize;
+            return contexts->ConfirmQueueNvmCtx;
+        }
+        default:
+        {
+            *size = 0;
+            return NULL;
+        }
+    }
+}
+
+/*!
+ * \brief Sets the context of a module to restore
+ *
+ * \param [IN] contexts Contexts to restore
+ * \param [IN] module   Module
+ * \param [IN] ctx      Context
+ * \param [IN] size     Context size
+ */
+static void SetModuleCtx( LoRaMacCtxs_t* contexts, uint8_t module, uint8_t* ctx, size_t size )
+{
+    switch( module )
+    {
+        case LORAMAC_NVMCTXMODULE_MAC:
+        {
+            contexts->MacNvmCtx = ctx;
+            contexts->MacNvmCtxSize = size;
             break;
         }
         case LORAMAC_NVMCTXMODULE_REGION:
         {
-            CtxUpdateStatus.Elements.Region = 1;
+            contexts->RegionNvmCtx = ctx;
+            contexts->RegionNvmCtxSize = size;
             break;
         }
         case LORAMAC_NVMCTXMODULE_CRYPTO:
         {
-            CtxUpdateStatus.Elements.Crypto = 1;
+            contexts->CryptoNvmCtx = ctx;
+            contexts->CryptoNvmCtxSize = size;
             break;
         }
         case LORAMAC_NVMCTXMODULE_SECURE_ELEMENT:
         {
-            CtxUpdateStatus.Elements.SecureElement = 1;
+            contexts->SecureElementNvmCtx = ctx;
+            contexts->SecureElementNvmCtxSize = size;
             break;
         }
         case LORAMAC_NVMCTXMODULE_COMMANDS:
         {
-            CtxUpdateStatus.Elements.Commands = 1;
+            contexts->CommandsNvmCtx = ctx;
+            contexts->CommandsNvmCtxSize = size;
             break;
         }
         case LORAMAC_NVMCTXMODULE_CLASS_B:
         {
-            CtxUpdateStatus.Elements.ClassB = 1;
+            contexts->ClassBNvmCtx = ctx;
+            contexts->ClassBNvmCtxSize = size;
             break;
         }
         case LORAMAC_NVMCTXMODULE_CONFIRM_QUEUE:
         {
-            CtxUpdateStatus.Elements.ConfirmQueue = 1;
+            contexts->ConfirmQueueNvmCtx = ctx;
+            contexts->ConfirmQueueNvmCtxSize = size;
             break;
         }
         default:
@@ -168,198 +391,547 @@ void NvmCtxMgmtEvent( LoRaMacNvmCtxModule_t module )
             break;
         }
     }
-#endif
 }
 
-NvmCtxMgmtStatus_t NvmCtxMgmtStore( void )
+/*!
+ * \brief Locates the stored contexts in the shadow
+ *
+ * \param [IN] contexts Contexts of the MAC
+ *
+ * \retval false if the contexts do not fit in the shadow
+ */
+static bool JournalSetup( LoRaMacCtxs_t* contexts )
 {
-#if ( CONTEXT_MANAGEMENT_ENABLED == 1 )
-    // Read out the contexts lengths and pointers
-    MibRequestConfirm_t mibReq;
-    mibReq.Type = MIB_NVM_CTXS;
-    LoRaMacMibGetRequestConfirm( &mibReq );
-    LoRaMacCtxs_t* MacContexts = mibReq.Param.Contexts;
+    uint32_t offset = 0;
+    size_t size;
 
-    // Input checks
-    if( ( CtxUpdateStatus.Value & NVM_CTX_STORAGE_MASK ) == 0 )
-    {
-        return NVMCTXMGMT_STATUS_FAIL;
-    }
-    if( LoRaMacStop( ) != LORAMAC_STATUS_OK )
+    if( Journal.Ready == true )
     {
-        return NVMCTXMGMT_STATUS_FAIL;
+        return true;
     }
 
-    // Write
-    if( CtxUpdateStatus.Elements.Crypto == 1 )
+    for( uint8_t module = 0; module < NVM_CTX_MODULES; module++ )
     {
-        if( NvmmWrite( &CryptoNvmCtxDataBlock, MacContexts->CryptoNvmCtx, MacContexts->CryptoNvmCtxSize ) != NVMM_SUCCESS )
+        Journal.ShadowOffset[module] = offset;
+        Journal.ShadowSize[module] = 0;
+        if( ( ( NVM_CTX_STORAGE_MASK >> module ) & 0x01 ) == 0 )
         {
-            return NVMCTXMGMT_STATUS_FAIL;
+            continue;
         }
-    }
-
-    if( CtxUpdateStatus.Elements.SecureElement == 1 )
-    {
-        if( NvmmWrite( &SecureElementNvmCtxDataBlock, MacContexts->SecureElementNvmCtx, MacContexts->SecureElementNvmCtxSize ) != NVMM_SUCCESS )
+        if( GetModuleCtx( contexts, module, &size ) == NULL )
         {
-            return NVMCTXMGMT_STATUS_FAIL;
+            continue;
         }
+        if( ( offset + size ) > NVM_CTX_SHADOW_SIZE )
+        {
+            return false;
+        }
+        Journal.ShadowSize[module] = size;
+        offset += size;
     }
+    Journal.Ready = true;
+    return true;
+}
 
-#if ( MAX_PERSISTENT_CTX_MGMT_ENABLED == 1 )
-    if( CtxUpdateStatus.Elements.Mac == 1 )
+/*!
+ * \brief Writes a record with bytes of a context taken from the shadow
+ *
+ * \param [IN] page     Journal page
+ * \param [IN] offset   Location of the record in the page
+ * \param [IN] module   Module
+ * \param [IN] start    Offset of the bytes in the context
+ * \param [IN] length   Number of bytes
+ * \param [IN] commit   Set on the last record of a snapshot or of a store
+ *
+ * \retval Operation status
+ */
+static NvmCtxMgmtStatus_t JournalWriteRecord( uint8_t page, uint32_t offset, uint8_t module, uint16_t start, uint16_t length, bool commit )
+{
+    uint8_t header[NVM_CTX_RECORD_HEADER_SPACE];
+    uint8_t tail[NVM_CTX_JOURNAL_WRITE_SIZE];
+    const uint8_t* data = &Shadow[Journal.ShadowOffset[module] + start];
+    uint16_t body = length - ( length % NVM_CTX_JOURNAL_WRITE_SIZE );
+    uint16_t crc;
+
+    memset1( header, NVM_CTX_JOURNAL_ERASED_VALUE, sizeof( header ) );
+    header[0] = ( commit == true ) ? NVM_CTX_RECORD_TAG_COMMIT : NVM_CTX_RECORD_TAG;
+    header[1] = module;
+    header[2] = start & 0xFF;
+    header[3] = ( start >> 8 ) & 0xFF;
+    header[4] = length & 0xFF;
+    header[5] = ( length >> 8 ) & 0xFF;
+    crc = JournalCrc( JournalCrc( 0xFFFF, header, 6 ), data, length );
+    header[6] = crc & 0xFF;
+    header[7] = ( crc >> 8 ) & 0xFF;
+
+    // The header goes first: a record torn by a reset fails its CRC
+    if( NvmCtxMgmtPageWrite( page, offset, header, sizeof( header ) ) != NVMCTXMGMT_STATUS_SUCCESS )
+    {
+        return NVMCTXMGMT_STATUS_FAIL;
+    }
+    offset += sizeof( header );
+    if( body > 0 )
     {
-        if( NvmmWrite( &MacNvmCtxDataBlock, MacContexts->MacNvmCtx, MacContexts->MacNvmCtxSize ) != NVMM_SUCCESS )
+        if( NvmCtxMgmtPageWrite( page, offset, data, body ) != NVMCTXMGMT_STATUS_SUCCESS )
         {
             return NVMCTXMGMT_STATUS_FAIL;
         }
+        offset += body;
     }
-
-    if( CtxUpdateStatus.Elements.Region == 1 )
+    if( length > body )
     {
-        if( NvmmWrite( &RegionNvmCtxDataBlock, MacContexts->RegionNvmCtx, MacContexts->RegionNvmCtxSize ) != NVMM_SUCCESS )
+        memset1( tail, NVM_CTX_JOURNAL_ERASED_VALUE, sizeof( tail ) );
+        memcpy1( tail, data + body, length - body );
+        if( NvmCtxMgmtPageWrite( page, offset, tail, sizeof( tail ) ) != NVMCTXMGMT_STATUS_SUCCESS )
         {
             return NVMCTXMGMT_STATUS_FAIL;
         }
     }
+    return NVMCTXMGMT_STATUS_SUCCESS;
+}
 
-    if( CtxUpdateStatus.Elements.Commands == 1 )
+/*!
+ * \brief Writes a snapshot of all the stored contexts to the next page, which
+ *        becomes the active page
+ *
+ * \param [IN] contexts Contexts of the MAC
+ *
+ * \retval Operation status
+ */
+static NvmCtxMgmtStatus_t JournalCompact( LoRaMacCtxs_t* contexts )
+{
+    uint8_t header[NVM_CTX_PAGE_HEADER_SPACE];
+    uint8_t page = ( Journal.Page + 1 ) % NVM_CTX_JOURNAL_PAGES;
+    uint32_t sequence = Journal.Sequence + 1;
+    uint32_t offset = NVM_CTX_PAGE_HEADER_SPACE;
+    uint8_t last = 0;
+    uint16_t crc;
+    size_t size;
+
+    for( uint8_t module = 0; module < NVM_CTX_MODULES; module++ )
     {
-        if( NvmmWrite( &CommandsNvmCtxDataBlock, MacContexts->CommandsNvmCtx, MacContexts->CommandsNvmCtxSize ) != NVMM_SUCCESS )
+        if( Journal.ShadowSize[module] != 0 )
         {
-            return NVMCTXMGMT_STATUS_FAIL;
+            last = module;
         }
     }
 
-    if( CtxUpdateStatus.Elements.ClassB == 1 )
+    // Until a snapshot is complete, the next store compacts again
+    Journal.WriteOffset = NVM_CTX_JOURNAL_PAGE_SIZE;
+
+    if( NvmCtxMgmtPageErase( page ) != NVMCTXMGMT_STATUS_SUCCESS )
     {
-        if( NvmmWrite( &ClassBNvmCtxDataBlock, MacContexts->ClassBNvmCtx, MacContexts->ClassBNvmCtxSize ) != NVMM_SUCCESS )
+        return NVMCTXMGMT_STATUS_FAIL;
+    }
+    for( uint8_t module = 0; module < NVM_CTX_MODULES; module++ )
+    {
+        size = Journal.ShadowSize[module];
+        if( size == 0 )
+        {
+            continue;
+        }
+        if( ( offset + NVM_CTX_RECORD_SPACE( size ) ) > NVM_CTX_JOURNAL_PAGE_SIZE )
         {
             return NVMCTXMGMT_STATUS_FAIL;
         }
-    }
-
-    if( CtxUpdateStatus.Elements.ConfirmQueue == 1 )
-    {
-        if( NvmmWrite( &ConfirmQueueNvmCtxDataBlock, MacContexts->ConfirmQueueNvmCtx, MacContexts->ConfirmQueueNvmCtxSize ) != NVMM_SUCCESS )
+        memcpy1( &Shadow[Journal.ShadowOffset[module]], GetModuleCtx( contexts, module, &size ), size );
+        if( JournalWriteRecord( page, offset, module, 0, size, module == last ) != NVMCTXMGMT_STATUS_SUCCESS )
         {
             return NVMCTXMGMT_STATUS_FAIL;
         }
+        offset += NVM_CTX_RECORD_SPACE( size );
     }
-#endif
 
-    CtxUpdateStatus.Value = 0x00;
+    // The page header goes last: the page is only valid with a whole snapshot
+    memset1( header, NVM_CTX_JOURNAL_ERASED_VALUE, sizeof( header ) );
+    header[0] = NVM_CTX_PAGE_MAGIC & 0xFF;
+    header[1] = ( NVM_CTX_PAGE_MAGIC >> 8 ) & 0xFF;
+    header[2] = sequence & 0xFF;
+    header[3] = ( sequence >> 8 ) & 0xFF;
+    header[4] = ( sequence >> 16 ) & 0xFF;
+    header[5] = ( sequence >> 24 ) & 0xFF;
+    crc = JournalCrc( 0xFFFF, header, 6 );
+    header[6] = crc & 0xFF;
+    header[7] = ( crc >> 8 ) & 0xFF;
+    if( NvmCtxMgmtPageWrite( page, 0, header, sizeof( header ) ) != NVMCTXMGMT_STATUS_SUCCESS )
+    {
+        return NVMCTXMGMT_STATUS_FAIL;
+    }
 
-    // Resume LoRaMac
-    LoRaMacStart( );
+    Journal.Page = page;
+    Journal.Sequence = sequence;
+    Journal.WriteOffset = offset;
+    return NVMCTXMGMT_STATUS_SUCCESS;
+}
 
+/*!
+ * \brief Appends a record to the active page
+ *
+ * \param [IN] module Module
+ * \param [IN] start  Offset of the bytes in the context
+ * \param [IN] length Number of bytes
+ * \param [IN] commit Set on the last record of the store
+ *
+ * \retval Operation status, NVMCTXMGMT_STATUS_FAIL if the page is full
+ */
+static NvmCtxMgmtStatus_t JournalAppendRecord( uint8_t module, uint16_t start, uint16_t length, bool commit )
+{
+    if( ( Journal.WriteOffset + NVM_CTX_RECORD_SPACE( length ) ) > NVM_CTX_JOURNAL_PAGE_SIZE )
+    {
+        return NVMCTXMGMT_STATUS_FAIL;
+    }
+    if( JournalWriteRecord( Journal.Page, Journal.WriteOffset, module, start, length, commit ) != NVMCTXMGMT_STATUS_SUCCESS )
+    {
+        return NVMCTXMGMT_STATUS_FAIL;
+    }
+    Journal.WriteOffset += NVM_CTX_RECORD_SPACE( length );
     return NVMCTXMGMT_STATUS_SUCCESS;
-#else
-    return NVMCTXMGMT_STATUS_FAIL;
-#endif
 }
 
-NvmCtxMgmtStatus_t NvmCtxMgmtRestore( void )
+/*!
+ * \brief Appends records for the bytes of the contexts which differ from the
+ *        shadow
+ *
+ * \param [IN] contexts Contexts of the MAC
+ * \param [IN] modules  Modules whose context changed, one bit per module
+ *
+ * \retval Operation status, NVMCTXMGMT_STATUS_FAIL if the page is full
+ */
+static NvmCtxMgmtStatus_t JournalAppend( LoRaMacCtxs_t* contexts, uint8_t modules )
 {
-#if ( CONTEXT_MANAGEMENT_ENABLED == 1 )
-    MibRequestConfirm_t mibReq;
-    LoRaMacCtxs_t contexts = { 0 };
-    NvmCtxMgmtStatus_t status = NVMCTXMGMT_STATUS_SUCCESS;
+    // A record is written once the next one is known, so the last one commits
+    uint8_t pending = NVM_CTX_MODULES;
+    uint16_t pendingStart = 0;
+    uint16_t pendingLength = 0;
+    uint8_t* shadow;
+    uint8_t* ctx;
+    size_t size;
+    uint16_t start;
+    uint16_t end;
+    uint16_t i;
+
+    for( uint8_t module = 0; module < NVM_CTX_MODULES; module++ )
+    {
+        if( ( ( modules >> module ) & 0x01 ) == 0 )
+        {
+            continue;
+        }
+        ctx = GetModuleCtx( contexts, module, &size );
+        if( ( ctx == NULL ) || ( size != Journal.ShadowSize[module] ) || ( size == 0 ) )
+        {
+            continue;
+        }
+        shadow = &Shadow[Journal.ShadowOffset[module]];
 
-    // Read out the contexts lengths
-    mibReq.Type = MIB_NVM_CTXS;
-    LoRaMacMibGetRequestConfirm( &mibReq );
+        start = 0;
+        while( start < size )
+        {
+            if( ctx[start] == shadow[start] )
+            {
+                start++;
+                continue;
+            }
+
+            // Changes closer than a record header go in the same record
+            end = start + 1;
+            for( i = end; ( i < size ) && ( ( i - end ) < NVM_CTX_RECORD_HEADER_SPACE ); i++ )
+            {
+                if( ctx[i] != shadow[i] )
+                {
+                    end = i + 1;
+                }
+            }
+
+            if( pending != NVM_CTX_MODULES )
+            {
+                if( JournalAppendRecord( pending, pendingStart, pendingLength, false ) != NVMCTXMGMT_STATUS_SUCCESS )
+                {
+                    return NVMCTXMGMT_STATUS_FAIL;
+                }
+            }
+            memcpy1( &shadow[start], &ctx[start], end - start );
+            pending = module;
+            pendingStart = start;
+            pendingLength = end - start;
+            start = end;
+        }
+    }
 
+    if( pending != NVM_CTX_MODULES )
+    {
+        return JournalAppendRecord( pending, pendingStart, pendingLength, true );
+    }
+    return NVMCTXMGMT_STATUS_SUCCESS;
+}
 
-    uint8_t NvmCryptoCtxRestore[mibReq.Param.Contexts->CryptoNvmCtxSize];
-    uint8_t NvmSecureElementCtxRestore[mibReq.Param.Contexts->SecureElementNvmCtxSize];
-#if ( MAX_PERSISTENT_CTX_MGMT_ENABLED == 1 )
-    uint8_t NvmMacCtxRestore[mibReq.Param.Contexts->MacNvmCtxSize];
-    uint8_t NvmRegionCtxRestore[mibReq.Param.Contexts->RegionNvmCtxSize];
-    uint8_t NvmCommandsCtxRestore[mibReq.Param.Contexts->CommandsNvmCtxSize];
-    uint8_t NvmClassBCtxRestore[mibReq.Param.Contexts->ClassBNvmCtxSize];
-    uint8_t NvmConfirmQueueCtxRestore[mibReq.Param.Contexts->ConfirmQueueNvmCtxSize];
-#endif
+/*!
+ * \brief Checks the CRC of a record
+ *
+ * \param [IN] page   Journal page
+ * \param [IN] offset Location of the record data in the page
+ * \param [IN] crc    CRC of the record header fields
+ * \param [IN] length Data length
+ *
+ * \retval CRC of the record header fields and data
+ */
+static uint16_t JournalRecordCrc( uint8_t page, uint32_t offset, uint16_t crc, uint16_t length )
+{
+    uint8_t buffer[32];
+    uint16_t chunk;
 
-    if ( NvmmDeclare( &CryptoNvmCtxDataBlock, mibReq.Param.Contexts->CryptoNvmCtxSize ) == NVMM_SUCCESS )
+    while( length > 0 )
     {
-        NvmmRead( &CryptoNvmCtxDataBlock, NvmCryptoCtxRestore, mibReq.Param.Contexts->CryptoNvmCtxSize );
-        contexts.CryptoNvmCtx = &NvmCryptoCtxRestore;
-        contexts.CryptoNvmCtxSize = mibReq.Param.Contexts->CryptoNvmCtxSize;
+        chunk = ( length < sizeof( buffer ) ) ? length : sizeof( buffer );
+        NvmCtxMgmtPageRead( page, offset, buffer, chunk );
+        crc = JournalCrc( crc, buffer, chunk );
+        offset += chunk;
+        length -= chunk;
     }
-    else
+    return crc;
+}
+
+/*!
+ * \brief Reads and checks the record header at an offset of the active page
+ *
+ * \param [IN]  offset Location of the record in the page
+ * \param [OUT] header Record header
+ *
+ * \retval false if the header is blank or the record is invalid
+ */
+static bool JournalReadRecord( uint32_t offset, uint8_t* header )
+{
+    uint16_t start;
+    uint16_t length;
+
+    NvmCtxMgmtPageRead( Journal.Page, offset, header, NVM_CTX_RECORD_HEADER_SIZE );
+    start = header[2] | ( ( uint16_t )header[3] << 8 );
+    length = header[4] | ( ( uint16_t )header[5] << 8 );
+    if( ( ( header[0] != NVM_CTX_RECORD_TAG ) && ( header[0] != NVM_CTX_RECORD_TAG_COMMIT ) ) ||
+        ( header[1] >= NVM_CTX_MODULES ) || ( length == 0 ) ||
+        ( ( ( uint32_t )start + length ) > Journal.ShadowSize[header[1]] ) ||
+        ( ( offset + NVM_CTX_RECORD_SPACE( length ) ) > NVM_CTX_JOURNAL_PAGE_SIZE ) )
     {
-        status = NVMCTXMGMT_STATUS_FAIL;
+        return false;
     }
+    return JournalRecordCrc( Journal.Page, offset + NVM_CTX_RECORD_HEADER_SPACE, JournalCrc( 0xFFFF, header, 6 ), length ) ==
+           ( header[6] | ( ( uint16_t )header[7] << 8 ) );
+}
 
-    if ( NvmmDeclare( &SecureElementNvmCtxDataBlock, mibReq.Param.Contexts->SecureElementNvmCtxSize ) == NVMM_SUCCESS )
+/*!
+ * \brief Restores the shadow from the newest valid page
+ *
+ * \retval Operation status
+ */
+static NvmCtxMgmtStatus_t JournalRestore( void )
+{
+    uint8_t header[NVM_CTX_PAGE_HEADER_SIZE];
+    uint8_t restored = 0;
+    uint8_t stored = 0;
+    uint32_t offset;
+    uint32_t committed;
+    uint32_t sequence;
+    uint16_t start;
+    uint16_t length;
+    uint8_t module;
+    uint8_t i;
+
+    Journal.Page = NVM_CTX_JOURNAL_PAGES;
+    for( uint8_t page = 0; page < NVM_CTX_JOURNAL_PAGES; page++ )
     {
-        NvmmRead( &SecureElementNvmCtxDataBlock, NvmSecureElementCtxRestore, mibReq.Param.Contexts->SecureElementNvmCtxSize );
-        contexts.SecureElementNvmCtx = &NvmSecureElementCtxRestore;
-        contexts.SecureElementNvmCtxSize = mibReq.Param.Contexts->SecureElementNvmCtxSize;
+        NvmCtxMgmtPageRead( page, 0, header, NVM_CTX_PAGE_HEADER_SIZE );
+        if( ( header[0] != ( NVM_CTX_PAGE_MAGIC & 0xFF ) ) || ( header[1] != ( ( NVM_CTX_PAGE_MAGIC >> 8 ) & 0xFF ) ) ||
+            ( JournalCrc( 0xFFFF, header, 6 ) != ( header[6] | ( ( uint16_t )header[7] << 8 ) ) ) )
+        {
+            continue;
+        }
+        sequence = header[2] | ( ( uint32_t )header[3] << 8 ) | ( ( uint32_t )header[4] << 16 ) | ( ( uint32_t )header[5] << 24 );
+        if( ( Journal.Page == NVM_CTX_JOURNAL_PAGES ) || ( ( int32_t )( sequence - Journal.Sequence ) > 0 ) )
+        {
+            Journal.Page = page;
+            Journal.Sequence = sequence;
+        }
     }
-    else
+    if( Journal.Page == NVM_CTX_JOURNAL_PAGES )
     {
-        status = NVMCTXMGMT_STATUS_FAIL;
+        Journal.Sequence = 0;
+        return NVMCTXMGMT_STATUS_FAIL;
     }
 
-#if ( MAX_PERSISTENT_CTX_MGMT_ENABLED == 1 )
-    if( NvmmDeclare( &MacNvmCtxDataBlock, mibReq.Param.Contexts->MacNvmCtxSize ) == NVMM_SUCCESS )
+    // Find the end of the last complete store
+    offset = NVM_CTX_PAGE_HEADER_SPACE;
+    committed = offset;
+    Journal.WriteOffset = NVM_CTX_JOURNAL_PAGE_SIZE;
+    while( ( offset + NVM_CTX_RECORD_HEADER_SPACE ) <= NVM_CTX_JOURNAL_PAGE_SIZE )
     {
-        NvmmRead( &MacNvmCtxDataBlock, NvmMacCtxRestore, mibReq.Param.Contexts->MacNvmCtxSize );
-        contexts.MacNvmCtx = &NvmMacCtxRestore;
-        contexts.MacNvmCtxSize = mibReq.Param.Contexts->MacNvmCtxSize;
+        if( JournalReadRecord( offset, header ) == false )
+        {
+            for( i = 0; ( i < NVM_CTX_RECORD_HEADER_SIZE ) && ( header[i] == NVM_CTX_JOURNAL_ERASED_VALUE ); i++ )
+            {
+            }
+            if( ( i == NVM_CTX_RECORD_HEADER_SIZE ) && ( offset == committed ) )
+            {
+                // Blank: the following records can be appended here
+                Journal.WriteOffset = offset;
+            }
+            // Otherwise a store was torn by a reset, the page cannot be
+            // appended anymore
+            break;
+        }
+        offset += NVM_CTX_RECORD_SPACE( header[4] | ( ( uint16_t )header[5] << 8 ) );
+        if( header[0] == NVM_CTX_RECORD_TAG_COMMIT )
+        {
+            committed = offset;
+        }
     }
-    else
+
+    // Replay the records up to there
+    offset = NVM_CTX_PAGE_HEADER_SPACE;
+    while( offset < committed )
     {
-        status = NVMCTXMGMT_STATUS_FAIL;
+        NvmCtxMgmtPageRead( Journal.Page, offset, header, NVM_CTX_RECORD_HEADER_SIZE );
+        module = header[1];
+        start = header[2] | ( ( uint16_t )header[3] << 8 );
+        length = header[4] | ( ( uint16_t )header[5] << 8 );
+        NvmCtxMgmtPageRead( Journal.Page, offset + NVM_CTX_RECORD_HEADER_SPACE, &Shadow[Journal.ShadowOffset[module] + start], length );
+        if( ( start == 0 ) && ( length == Journal.ShadowSize[module] ) )
+        {
+            restored |= 1 << module;
+        }
+        offset += NVM_CTX_RECORD_SPACE( length );
     }
 
-    if ( NvmmDeclare( &RegionNvmCtxDataBlock, mibReq.Param.Contexts->RegionNvmCtxSize ) == NVMM_SUCCESS )
+    // The snapshot must cover every stored context
+    for( module = 0; module < NVM_CTX_MODULES; module++ )
     {
-        NvmmRead( &RegionNvmCtxDataBlock, NvmRegionCtxRestore, mibReq.Param.Contexts->RegionNvmCtxSize );
-        contexts.RegionNvmCtx = &NvmRegionCtxRestore;
-        contexts.RegionNvmCtxSize = mibReq.Param.Contexts->RegionNvmCtxSize;
+        if( Journal.ShadowSize[module] != 0 )
+        {
+            stored |= 1 << module;
+        }
     }
-    else
+    if( ( restored & stored ) != stored )
+    {
+        return NVMCTXMGMT_STATUS_FAIL;
+    }
+    return NVMCTXMGMT_STATUS_SUCCESS;
+}
+#endif
+
+void NvmCtxMgmtEvent( LoRaMacNvmCtxModule_t module )
+{
+#if ( CONTEXT_MANAGEMENT_ENABLED == 1 )
+    switch( module )
     {
-        status = NVMCTXMGMT_STATUS_FAIL;
+        case LORAMAC_NVMCTXMODULE_MAC:
+        {
+            CtxUpdateStatus.Elements.Mac = 1;
+            break;
+        }
+        case LORAMAC_NVMCTXMODULE_REGION:
+        {
+            CtxUpdateStatus.Elements.Region = 1;
+            break;
+        }
+        case LORAMAC_NVMCTXMODULE_CRYPTO:
+        {
+            CtxUpdateStatus.Elements.Crypto = 1;
+            break;
+        }
+        case LORAMAC_NVMCTXMODULE_SECURE_ELEMENT:
+        {
+            CtxUpdateStatus.Elements.SecureElement = 1;
+            break;
+        }
+        case LORAMAC_NVMCTXMODULE_COMMANDS:
+        {
+            CtxUpdateStatus.Elements.Commands = 1;
+            break;
+        }
+        case LORAMAC_NVMCTXMODULE_CLASS_B:
+        {
+            CtxUpdateStatus.Elements.ClassB = 1;
+            break;
+        }
+        case LORAMAC_NVMCTXMODULE_CONFIRM_QUEUE:
+        {
+            CtxUpdateStatus.Elements.ConfirmQueue = 1;
+            break;
+        }
+        default:
+        {
+            break;
+        }
     }
+#endif
+}
 
-    if ( NvmmDeclare( &CommandsNvmCtxDataBlock, mibReq.Param.Contexts->CommandsNvmCtxSize ) == NVMM_SUCCESS )
+NvmCtxMgmtStatus_t NvmCtxMgmtStore( void )
+{
+#if ( CONTEXT_MANAGEMENT_ENABLED == 1 )
+    NvmCtxMgmtStatus_t status = NVMCTXMGMT_STATUS_SUCCESS;
+
+    // Read out the contexts lengths and pointers
+    MibRequestConfirm_t mibReq;
+    mibReq.Type = MIB_NVM_CTXS;
+    LoRaMacMibGetRequestConfirm( &mibReq );
+    LoRaMacCtxs_t* MacContexts = mibReq.Param.Contexts;
+
+    // Input checks
+    if( ( CtxUpdateStatus.Value & NVM_CTX_STORAGE_MASK ) == 0 )
     {
-        NvmmRead( &CommandsNvmCtxDataBlock, NvmCommandsCtxRestore, mibReq.Param.Contexts->CommandsNvmCtxSize );
-        contexts.CommandsNvmCtx = &NvmCommandsCtxRestore;
-        contexts.CommandsNvmCtxSize = mibReq.Param.Contexts->CommandsNvmCtxSize;
+        return NVMCTXMGMT_STATUS_FAIL;
     }
-    else
+    if( JournalSetup( MacContexts ) == false )
     {
-        status = NVMCTXMGMT_STATUS_FAIL;
+        return NVMCTXMGMT_STATUS_FAIL;
+    }
+    if( LoRaMacStop( ) != LORAMAC_STATUS_OK )
+    {
+        return NVMCTXMGMT_STATUS_FAIL;
     }
 
-    if ( NvmmDeclare( &ClassBNvmCtxDataBlock, mibReq.Param.Contexts->ClassBNvmCtxSize ) == NVMM_SUCCESS )
+    // Write
+    if( Journal.Page == NVM_CTX_JOURNAL_PAGES )
     {
-        NvmmRead( &ClassBNvmCtxDataBlock, NvmClassBCtxRestore, mibReq.Param.Contexts->ClassBNvmCtxSize );
-        contexts.ClassBNvmCtx = &NvmClassBCtxRestore;
-        contexts.ClassBNvmCtxSize = mibReq.Param.Contexts->ClassBNvmCtxSize;
+        status = JournalCompact( MacContexts );
     }
     else
     {
-        status = NVMCTXMGMT_STATUS_FAIL;
+        if( JournalAppend( MacContexts, CtxUpdateStatus.Value & NVM_CTX_STORAGE_MASK ) != NVMCTXMGMT_STATUS_SUCCESS )
+        {
+            // Page full or write error, the snapshot holds all the changes
+            status = JournalCompact( MacContexts );
+        }
     }
 
-    if ( NvmmDeclare( &ConfirmQueueNvmCtxDataBlock, mibReq.Param.Contexts->ConfirmQueueNvmCtxSize ) == NVMM_SUCCESS )
+    if( status == NVMCTXMGMT_STATUS_SUCCESS )
     {
-        NvmmRead( &ConfirmQueueNvmCtxDataBlock, NvmConfirmQueueCtxRestore, mibReq.Param.Contexts->ConfirmQueueNvmCtxSize );
-        contexts.ConfirmQueueNvmCtx = &NvmConfirmQueueCtxRestore;
-        contexts.ConfirmQueueNvmCtxSize = mibReq.Param.Contexts->ConfirmQueueNvmCtxSize;
+        CtxUpdateStatus.Value = 0x00;
     }
-    else
+
+    // Resume LoRaMac
+    LoRaMacStart( );
+
+    return status;
+#else
+    return NVMCTXMGMT_STATUS_FAIL;
+#endif
+}
+
+NvmCtxMgmtStatus_t NvmCtxMgmtRestore( void )
+{
+#if ( CONTEXT_MANAGEMENT_ENABLED == 1 )
+    MibRequestConfirm_t mibReq;
+    LoRaMacCtxs_t contexts = { 0 };
+    NvmCtxMgmtStatus_t status = NVMCTXMGMT_STATUS_FAIL;
+
+    // Read out the contexts lengths
+    mibReq.Type = MIB_NVM_CTXS;
+    LoRaMacMibGetRequestConfirm( &mibReq );
+
+    if( JournalSetup( mibReq.Param.Contexts ) == true )
     {
-        status = NVMCTXMGMT_STATUS_FAIL;
+        status = JournalRestore( );
     }
-#endif
 
     // Enforce storing all contexts
     if( status == NVMCTXMGMT_STATUS_FAIL )
@@ -369,6 +941,13 @@ NvmCtxMgmtStatus_t NvmCtxMgmtRestore( void )
     }
     else
     {  // If successful query the mac to restore contexts
+        for( uint8_t module = 0; module < NVM_CTX_MODULES; module++ )
+        {
+            if( Journal.ShadowSize[module] != 0 )
+            {
+                SetModuleCtx( &contexts, module, &Shadow[Journal.ShadowOffset[module]], Journal.ShadowSize[module] );
+            }
+        }
         mibReq.Type = MIB_NVM_CTXS;
         mibReq.Param.Contexts = &contexts;
         LoRaMacMibSetRequestConfirm( &mibReq );
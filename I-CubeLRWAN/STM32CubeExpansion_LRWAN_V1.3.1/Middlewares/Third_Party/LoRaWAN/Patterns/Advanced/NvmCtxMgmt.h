@@ -66,4 +66,40 @@ NvmCtxMgmtStatus_t NvmCtxMgmtStore( void );
 
 NvmCtxMgmtStatus_t NvmCtxMgmtRestore(void );
 
+/*!
+ * \brief Reads data from a page of the context journal. To be implemented by
+ *        the platform when the context management is enabled.
+ *
+ * \param [IN]  page   Page index, from 0 to NVM_CTX_JOURNAL_PAGES - 1
+ * \param [IN]  offset Offset in the page
+ * \param [OUT] buffer Data read
+ * \param [IN]  size   Number of bytes to read
+ *
+ * \retval Operation status
+ */
+NvmCtxMgmtStatus_t NvmCtxMgmtPageRead( uint8_t page, uint32_t offset, uint8_t* buffer, uint16_t size );
+
+/*!
+ * \brief Programs data in an erased area of a page of the context journal. To
+ *        be implemented by the platform when the context management is enabled.
+ *
+ * \param [IN] page   Page index, from 0 to NVM_CTX_JOURNAL_PAGES - 1
+ * \param [IN] offset Offset in the page, multiple of NVM_CTX_JOURNAL_WRITE_SIZE
+ * \param [IN] buffer Data to write, not necessarily aligned
+ * \param [IN] size   Number of bytes, multiple of NVM_CTX_JOURNAL_WRITE_SIZE
+ *
+ * \retval Operation status
+ */
+NvmCtxMgmtStatus_t NvmCtxMgmtPageWrite( uint8_t page, uint32_t offset, const uint8_t* buffer, uint16_t size );
+
+/*!
+ * \brief Erases a page of the context journal. To be implemented by the
+ *        platform when the context management is enabled.
+ *
+ * \param [IN] page Page index, from 0 to NVM_CTX_JOURNAL_PAGES - 1
+ *
+ * \retval Operation status
+ */
+NvmCtxMgmtStatus_t NvmCtxMgmtPageErase( uint8_t page );
+
 #endif // __NVMCTXMGMT_H__
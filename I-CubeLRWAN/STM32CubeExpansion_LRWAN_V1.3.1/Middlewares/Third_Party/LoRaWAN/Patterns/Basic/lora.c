@@ -683,6 +683,19 @@ bool LORA_send(lora_AppData_t* AppData, LoraConfirm_t IsTxConfirmed)
     return true;
 }  
 
+uint8_t LORA_GetMaxPayloadSize( void)
+{
+    LoRaMacTxInfo_t txInfo;
+
+    if( LoRaMacQueryTxPossible( 0, &txInfo ) != LORAMAC_STATUS_OK )
+    {
+        // The MAC commands don't fit in FOpts, LORA_send flushes them in an
+        // empty frame first
+        return txInfo.CurrentPossiblePayloadSize;
+    }
+    return txInfo.MaxPossibleApplicationDataSize;
+}
+
 #ifdef LORAMAC_CLASSB_ENABLED
 #if defined( USE_DEVICE_TIMING )
 static LoraErrorStatus LORA_DeviceTimeReq( void)
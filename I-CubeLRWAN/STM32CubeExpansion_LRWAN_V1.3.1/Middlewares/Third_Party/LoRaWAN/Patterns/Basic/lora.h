@@ -217,6 +217,14 @@ void LORA_Init (LoRaMainCallback_t *callbacks, LoRaParam_t* LoRaParam );
  */
 bool LORA_send(lora_AppData_t* AppData, LoraConfirm_t IsTxConfirmed);
 
+/**
+ * @brief Maximum application payload of the next uplink
+ * @Note depends on the current datarate and on the pending MAC commands
+ * @param [IN] none
+ * @retval maximum payload size in bytes
+ */
+uint8_t LORA_GetMaxPayloadSize( void);
+
 /**
  * @brief Join a Lora Network in classA
  * @Note if the device is ABP, this is a pass through functon
@@ -373,6 +373,19 @@ struct Radio_s
      * \param [in]  sleepTime     Structure describing sleep timeout value
      */
     void ( *SetRxDutyCycle ) ( uint32_t rxTime, uint32_t sleepTime );
+    /*!
+     * \brief Sets the buffer the next received frames are read into
+     *
+     * \remark The frame is delivered by the RxDone event in this buffer and
+     *         stays there until a new buffer is set, so the upper layer can
+     *         process it in place. Only to be changed while no reception is
+     *         running, e.g. from the RxDone event. NULL pointer when the
+     *         radio driver doesn't support it.
+     *
+     * \param [IN] buffer Buffer of at least 255 bytes,
+     *                    NULL to use the driver internal buffer
+     */
+    void ( *SetRxBuffer )( uint8_t *buffer );
 };
 
 /*!
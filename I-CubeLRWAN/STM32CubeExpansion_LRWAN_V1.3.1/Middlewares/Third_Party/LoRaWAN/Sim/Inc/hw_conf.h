@@ -0,0 +1,67 @@
+/**
+  ******************************************************************************
+  * @file    hw_conf.h
+  * @author  MCD Application Team
+  * @brief   Host configuration of the simulation, replaces the board hw_conf.h
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HW_CONF_H__
+#define __HW_CONF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/* Exported macros -----------------------------------------------------------*/
+/*
+ * The simulation runs in a single thread and its events are dispatched one
+ * after the other, there is nothing to mask.
+ */
+static inline uint32_t __get_PRIMASK( void )
+{
+  return 0;
+}
+
+static inline void __set_PRIMASK( uint32_t priMask )
+{
+  ( void )priMask;
+}
+
+static inline void __disable_irq( void )
+{
+}
+
+static inline void __enable_irq( void )
+{
+}
+
+/* blocking delays advance the virtual clock */
+#define HAL_Delay( n )                              HW_RTC_DelayMs( n )
+
+/* Exported functions ------------------------------------------------------- */
+void HW_RTC_DelayMs( uint32_t delay );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HW_CONF_H__ */
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,140 @@
+/**
+  ******************************************************************************
+  * @file    sim_event.h
+  * @author  MCD Application Team
+  * @brief   Discrete-event scheduler and virtual clock of the host simulation
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SIM_EVENT_H__
+#define __SIM_EVENT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/*!
+ * Maximum number of pending events. The RTC alarm uses one of them and each
+ * simulated radio at most 4, the remaining ones are left to the scenario.
+ */
+#ifndef SIM_EVENT_QUEUE_SIZE
+#define SIM_EVENT_QUEUE_SIZE                        32
+#endif
+
+/*!
+ * Virtual time units
+ */
+#define SIM_TIME_MS( ms )                           ( ( SimTime_t )( ms ) * 1000 )
+#define SIM_TIME_S( s )                             ( ( SimTime_t )( s ) * 1000000 )
+
+/* Exported types ------------------------------------------------------------*/
+/*!
+ * Virtual time in microseconds since SimEventReset
+ */
+typedef uint64_t SimTime_t;
+
+/*!
+ * Simulation event, owned by the caller as TimerEvent_t
+ */
+typedef struct SimEvent_s
+{
+  SimTime_t Time;                       //!< Absolute expiry time
+  uint32_t Sequence;                    //!< Keeps FIFO order between events of the same time
+  uint32_t HeapIndex;                   //!< Position in the queue while pending
+  bool IsPending;                       //!< Event is in the queue
+  void ( *Callback )( void *context );  //!< Event callback
+  void *Context;                        //!< Argument of the callback
+} SimEvent_t;
+
+/* Exported functions ------------------------------------------------------- */
+/*!
+ * @brief Empties the event queue and sets the virtual clock back to 0
+ */
+void SimEventReset( void );
+
+/*!
+ * @brief Initializes an event
+ * @param [IN] obj Event to initialize
+ * @param [IN] callback Function called when the event expires
+ * @param [IN] context Argument of the callback
+ */
+void SimEventInit( SimEvent_t *obj, void ( *callback )( void *context ), void *context );
+
+/*!
+ * @brief Schedules an event, rescheduling it if it is already pending
+ * @note A time in the past expires on the next dispatch
+ * @param [IN] obj Event to schedule
+ * @param [IN] time Absolute expiry time
+ */
+void SimEventStart( SimEvent_t *obj, SimTime_t time );
+
+/*!
+ * @brief Removes an event from the queue
+ * @param [IN] obj Event to cancel
+ */
+void SimEventStop( SimEvent_t *obj );
+
+/*!
+ * @brief Checks if an event is pending
+ * @param [IN] obj Event to check
+ * @retval true if the event is in the queue
+ */
+bool SimEventIsPending( SimEvent_t *obj );
+
+/*!
+ * @brief Returns the virtual clock
+ * @retval Current virtual time
+ */
+SimTime_t SimEventGetTime( void );
+
+/*!
+ * @brief Returns the expiry time of the next event
+ * @param [OUT] time Expiry time of the next event
+ * @retval false if the queue is empty
+ */
+bool SimEventGetNextTime( SimTime_t *time );
+
+/*!
+ * @brief Sets the function called after each dispatched event
+ * @note This is the main loop body of the simulated device, e.g. a function
+ *       calling LoRaMacProcess or LmHandlerProcess
+ * @param [IN] process Function to call, NULL for none
+ */
+void SimEventSetProcess( void ( *process )( void ) );
+
+/*!
+ * @brief Advances the virtual clock to the next event and dispatches it
+ * @retval false if the queue is empty
+ */
+bool SimEventRunNext( void );
+
+/*!
+ * @brief Dispatches all the events expiring up to time included, then sets the
+ *        virtual clock to time
+ * @param [IN] time Absolute end time
+ */
+void SimEventRunUntil( SimTime_t time );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SIM_EVENT_H__ */
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
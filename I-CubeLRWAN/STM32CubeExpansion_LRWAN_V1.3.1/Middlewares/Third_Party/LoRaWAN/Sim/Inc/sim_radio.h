@@ -0,0 +1,160 @@
+/**
+  ******************************************************************************
+  * @file    sim_radio.h
+  * @author  MCD Application Team
+  * @brief   Simulated radio of the host simulation
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SIM_RADIO_H__
+#define __SIM_RADIO_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "radio.h"
+#include "sim_event.h"
+
+/* Exported constants --------------------------------------------------------*/
+/*!
+ * Maximum number of frames injected and not yet received
+ */
+#ifndef SIM_RADIO_RX_QUEUE_SIZE
+#define SIM_RADIO_RX_QUEUE_SIZE                     4
+#endif
+
+/*!
+ * Number of preamble symbols the receiver needs to lock on a frame
+ */
+#ifndef SIM_RADIO_PREAMBLE_DETECT_SYMBOLS
+#define SIM_RADIO_PREAMBLE_DETECT_SYMBOLS           4
+#endif
+
+/*!
+ * Rssi returned when no frame is on air
+ */
+#define SIM_RADIO_NOISE_FLOOR                       -120
+
+/* Exported types ------------------------------------------------------------*/
+/*!
+ * Frame on air, with the modulation parameters of Radio.SetTxConfig
+ */
+typedef struct
+{
+  SimTime_t Time;         //!< Start of the frame
+  SimTime_t Duration;     //!< Time on air, computed by SimRadioInject when 0
+  uint32_t Frequency;     //!< Channel frequency in Hz
+  RadioModems_t Modem;    //!< Radio modem
+  uint32_t Bandwidth;     //!< LoRa: 0 125 kHz, 1 250 kHz, 2 500 kHz, FSK: not used
+  uint32_t Datarate;      //!< LoRa: spreading factor, FSK: bits per second
+  uint8_t Coderate;       //!< LoRa: 1 4/5, 2 4/6, 3 4/7, 4 4/8, FSK: not used
+  uint16_t PreambleLen;   //!< Preamble length in symbols (LoRa) or bytes (FSK)
+  bool FixLen;            //!< Implicit header (LoRa) or fixed length (FSK)
+  bool CrcOn;             //!< Payload CRC
+  bool IqInverted;        //!< LoRa inverted IQ
+  int8_t Power;           //!< Transmit power of an uplink in dBm
+  int16_t Rssi;           //!< Rssi of a downlink in dBm
+  int8_t Snr;             //!< Snr of a downlink in dB
+  uint8_t Size;           //!< Payload size
+  uint8_t Payload[255];   //!< Payload
+} SimRadioFrame_t;
+
+/*!
+ * Reception settings of Radio.SetRxConfig
+ */
+typedef struct
+{
+  RadioModems_t Modem;
+  uint32_t Bandwidth;
+  uint32_t Datarate;
+  uint16_t SymbTimeout;
+  bool RxContinuous;
+} SimRadioRxSettings_t;
+
+/*!
+ * Simulated radio. A single device uses the default radio of the driver.
+ * With LORAMAC_MULTI_INSTANCE, each simulated device owns one, zeroed and
+ * bound to its instance with LoRaMacInstanceSetRadio: the driver then works on
+ * the radio of the selected instance, and selects the instance which called
+ * Radio.Init on a radio before raising the events of that radio.
+ */
+typedef struct SimRadio_s
+{
+  RadioEvents_t *Events;                //!< Events given to Radio.Init
+  void *Owner;                          //!< LoRaMac instance selected by Radio.Init
+  RadioState_t State;
+  RadioModems_t Modem;
+  uint32_t Channel;
+  uint32_t RandomState;                 //!< State of Radio.Random
+  SimRadioFrame_t TxFrame;              //!< Settings of the next transmission, then frame being transmitted
+  SimRadioRxSettings_t RxSettings;
+  SimTime_t RxStart;                    //!< Reception window, RxEnd is 0 for a reception without timeout
+  SimTime_t RxEnd;
+  SimRadioFrame_t RxQueue[SIM_RADIO_RX_QUEUE_SIZE]; //!< Frames on air towards the device
+  bool RxQueueUsed[SIM_RADIO_RX_QUEUE_SIZE];
+  int8_t RxLocked;                      //!< Frame being received, -1 for none
+  uint8_t RxPayload[255];
+  uint8_t *RxBuffer;                    //!< Buffer the received frames are read into
+  SimEvent_t TxDoneEvent;
+  SimEvent_t TxTimeoutEvent;
+  SimEvent_t RxDoneEvent;
+  SimEvent_t RxTimeoutEvent;
+  SimEvent_t CadDoneEvent;
+  bool IsListed;                        //!< In the list of the radios hearing SimRadioInject
+  struct SimRadio_s *Next;
+} SimRadio_t;
+
+/* Exported functions ------------------------------------------------------- */
+/*!
+ * @brief Sets the function called with each frame sent by the device, before
+ *        the TxDone event. This is where the scenario plays the network: the
+ *        downlinks are given to SimRadioInject. With several instances, the
+ *        instance owning the radio is selected when the handler is called.
+ * @param [IN] handler Function to call, NULL for none
+ */
+void SimRadioSetTxHandler( void ( *handler )( const SimRadioFrame_t *frame ) );
+
+/*!
+ * @brief Puts a frame on air. Every radio initialized by Radio.Init hears it:
+ *        a device receives it if a reception with the same modem, frequency
+ *        and datarate is running while the preamble is on air, as long as the
+ *        window is not over.
+ * @param [IN] frame Frame to transmit, Time may be in the future
+ * @retval false if a radio already has SIM_RADIO_RX_QUEUE_SIZE frames on air
+ */
+bool SimRadioInject( const SimRadioFrame_t *frame );
+
+/*!
+ * @brief Computes the time on air of a frame
+ * @param [IN] frame Frame, only the modulation parameters and Size are used
+ * @retval Time on air
+ */
+SimTime_t SimRadioGetTimeOnAir( const SimRadioFrame_t *frame );
+
+/*!
+ * @brief Seeds the generator of Radio.Random, of the radio of the selected
+ *        instance with LORAMAC_MULTI_INSTANCE
+ * @param [IN] seed Seed, one per simulated device keeps the runs reproducible
+ */
+void SimRadioSetSeed( uint32_t seed );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SIM_RADIO_H__ */
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,187 @@
+/**
+  ******************************************************************************
+  * @file    capacity.c
+  * @author  MCD Application Team
+  * @brief   Host simulation of a long run of uplinks on one end-device
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+/*
+ * One EU868 ABP device sends unconfirmed uplinks back to back, as fast as
+ * the duty cycle allows. Every other uplink, the network puts a frame on
+ * air in RX1 so the reception path runs as well as the RX timeouts. The
+ * frame is not addressed to the device and is dropped by the MAC.
+ *
+ * The run passes when each uplink is transmitted once and confirmed, and
+ * reports the virtual time covered and the host CPU time it took.
+ *
+ * Usage: capacity [uplinks]
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "LoRaMac.h"
+#include "hw_rtc.h"
+#include "sim_event.h"
+#include "sim_radio.h"
+
+/* Private define ------------------------------------------------------------*/
+#define DEV_ADDR                                    0x26011234
+#define UPLINK_SIZE                                 10
+#define RX1_DELAY                                   SIM_TIME_MS( 1000 )
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t TxCount = 0;
+static uint32_t Confirms = 0;
+static bool InjectRx1 = false;
+
+/* Private functions ---------------------------------------------------------*/
+static void OnTx( const SimRadioFrame_t *frame )
+{
+  SimRadioFrame_t down = *frame;
+
+  TxCount++;
+  if( InjectRx1 == true )
+  {
+    down.Time = frame->Time + frame->Duration + RX1_DELAY;
+    down.Duration = 0;
+    down.Size = 12;
+    memset( down.Payload, 0x60, down.Size );
+    down.Rssi = -50;
+    down.Snr = 5;
+    down.IqInverted = true;
+    if( SimRadioInject( &down ) == false )
+    {
+      printf( "downlink dropped, increase SIM_RADIO_RX_QUEUE_SIZE\n" );
+      exit( 1 );
+    }
+  }
+}
+
+static void McpsConfirm( McpsConfirm_t *mcpsConfirm )
+{
+  ( void )mcpsConfirm;
+  Confirms++;
+}
+
+static void McpsIndication( McpsIndication_t *mcpsIndication )
+{
+  ( void )mcpsIndication;
+}
+
+static void MlmeConfirm( MlmeConfirm_t *mlmeConfirm )
+{
+  ( void )mlmeConfirm;
+}
+
+static void MlmeIndication( MlmeIndication_t *mlmeIndication )
+{
+  ( void )mlmeIndication;
+}
+
+static void Process( void )
+{
+  LoRaMacProcess( );
+}
+
+static uint8_t GetBatteryLevel( void )
+{
+  return 254;
+}
+
+static uint16_t GetTemperatureLevel( void )
+{
+  return 25;
+}
+
+int main( int argc, char *argv[] )
+{
+  static LoRaMacPrimitives_t primitives = { McpsConfirm, McpsIndication, MlmeConfirm, MlmeIndication };
+  static LoRaMacCallback_t callbacks = { GetBatteryLevel, GetTemperatureLevel, NULL, NULL };
+  uint8_t payload[UPLINK_SIZE] = { 0 };
+  uint32_t uplinks = 2000;
+  MibRequestConfirm_t mibReq;
+  McpsReq_t mcpsReq;
+  clock_t start;
+
+  if( argc > 1 )
+  {
+    uplinks = ( uint32_t )strtoul( argv[1], NULL, 0 );
+  }
+
+  SimEventReset( );
+  HW_RTC_Init( );
+  SimRadioSetTxHandler( OnTx );
+  SimEventSetProcess( Process );
+
+  if( LoRaMacInitialization( &primitives, &callbacks, LORAMAC_REGION_EU868 ) != LORAMAC_STATUS_OK )
+  {
+    printf( "LoRaMacInitialization failed\n" );
+    return 1;
+  }
+  mibReq.Type = MIB_NETWORK_ACTIVATION;
+  mibReq.Param.NetworkActivation = ACTIVATION_TYPE_ABP;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+  mibReq.Type = MIB_DEV_ADDR;
+  mibReq.Param.DevAddr = DEV_ADDR;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+  mibReq.Type = MIB_ADR;
+  mibReq.Param.AdrEnable = false;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+  LoRaMacStart( );
+
+  mcpsReq.Type = MCPS_UNCONFIRMED;
+  mcpsReq.Req.Unconfirmed.fPort = 2;
+  mcpsReq.Req.Unconfirmed.fBuffer = payload;
+  mcpsReq.Req.Unconfirmed.fBufferSize = sizeof( payload );
+  mcpsReq.Req.Unconfirmed.Datarate = DR_5;
+
+  start = clock( );
+  for( uint32_t i = 0; i < uplinks; i++ )
+  {
+    uint32_t confirms = Confirms;
+    LoRaMacStatus_t status;
+
+    InjectRx1 = ( ( i % 2 ) == 1 );
+    while( ( status = LoRaMacMcpsRequest( &mcpsReq ) ) != LORAMAC_STATUS_OK )
+    {
+      if( ( status != LORAMAC_STATUS_DUTYCYCLE_RESTRICTED ) && ( status != LORAMAC_STATUS_BUSY ) )
+      {
+        printf( "uplink %u: LoRaMacMcpsRequest failed (%d)\n", ( unsigned )i, status );
+        return 1;
+      }
+      /* wait for the duty cycle: let the clock run */
+      if( SimEventRunNext( ) == false )
+      {
+        SimEventRunUntil( SimEventGetTime( ) + SIM_TIME_S( 1 ) );
+      }
+    }
+    while( Confirms == confirms )
+    {
+      if( SimEventRunNext( ) == false )
+      {
+        printf( "uplink %u: no confirm, the simulation stalled\n", ( unsigned )i );
+        return 1;
+      }
+    }
+  }
+
+  printf( "%u uplinks, %u transmitted, %.1f h of virtual time in %.2f s cpu\n", ( unsigned )uplinks,
+          ( unsigned )TxCount, SimEventGetTime( ) / 3.6e9, ( double )( clock( ) - start ) / CLOCKS_PER_SEC );
+
+  return ( TxCount == uplinks ) ? 0 : 1;
+}
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,484 @@
+/**
+  ******************************************************************************
+  * @file    multi_node.c
+  * @author  MCD Application Team
+  * @brief   Host simulation of many end-devices sharing a network
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+/*
+ * Each simulated device is a LoRaMac instance (LORAMAC_MULTI_INSTANCE) with
+ * its own simulated radio and session keys. The devices send confirmed EU868
+ * ABP uplinks at random times. The network handler plays a single gateway:
+ * uplinks overlapping on the same channel and datarate are lost, the others
+ * are acknowledged in RX1 when the gateway is free. All the devices hear all
+ * the downlinks, so a radio event routed to the wrong instance fails the
+ * address or MIC check and the acknowledgement is lost.
+ *
+ * The run passes when every device received exactly the acknowledgements the
+ * network sent to it.
+ *
+ * Each device needs TIMERS_PER_DEVICE timers and EVENTS_PER_DEVICE simulation
+ * events, which bounds the number of devices to MAX_DEVICES for the
+ * TIMER_QUEUE_SIZE and SIM_EVENT_QUEUE_SIZE of the build (2048 devices with
+ * the Makefile).
+ *
+ * Usage: multi_node [devices] [hours]
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "LoRaMacInstance.h"
+#include "cmac.h"
+#include "hw_rtc.h"
+#include "sim_event.h"
+#include "sim_radio.h"
+#include "timeServer.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  LoRaMacInstance_t Instance;       //!< First member, the callbacks cast the selected instance
+  SimRadio_t Radio;
+  SimEvent_t UplinkEvent;
+  uint32_t DevAddr;
+  uint8_t Key[16];                  //!< All the session keys of the device
+  uint32_t FCntDown;
+  bool ProcessPending;
+  uint32_t Uplinks;
+  uint32_t Confirms;
+  uint32_t AcksSent;
+  uint32_t AcksReceived;
+} Node_t;
+
+typedef struct
+{
+  SimRadioFrame_t Frame;
+  Node_t *Node;
+  bool Collided;
+  bool Used;
+  SimEvent_t DecisionEvent;
+} Uplink_t;
+
+/* Private define ------------------------------------------------------------*/
+#define DEV_ADDR_BASE                               0x26010000
+#define UPLINK_PERIOD                               SIM_TIME_S( 60 )
+#define UPLINK_SIZE                                 10
+#define RX1_DELAY                                   SIM_TIME_MS( 1000 )
+#define UPLINK_POOL_SIZE                            256
+
+/* LoRaMac class A timers */
+#define TIMERS_PER_DEVICE                           4
+/* simulated radio events and uplink event */
+#define EVENTS_PER_DEVICE                           5
+/* the RTC alarm and the uplink decisions share the event queue */
+#define EVENTS_SHARED                               ( 1 + UPLINK_POOL_SIZE )
+
+#define MAX_DEVICES_TIMERS                          ( TIMER_QUEUE_SIZE / TIMERS_PER_DEVICE )
+#define MAX_DEVICES_EVENTS                          ( ( SIM_EVENT_QUEUE_SIZE - EVENTS_SHARED ) / EVENTS_PER_DEVICE )
+#define MAX_DEVICES                                 ( ( MAX_DEVICES_TIMERS < MAX_DEVICES_EVENTS ) ? \
+                                                      MAX_DEVICES_TIMERS : MAX_DEVICES_EVENTS )
+
+#if ( SIM_EVENT_QUEUE_SIZE <= EVENTS_SHARED )
+#error "SIM_EVENT_QUEUE_SIZE too small for the uplink pool"
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+static Node_t *Nodes;
+static uint32_t NodeCount = 100;
+static SimTime_t UplinksEnd;
+
+static Uplink_t Uplinks[UPLINK_POOL_SIZE];
+static SimTime_t GatewayBusyUntil = 0;
+static uint32_t UplinksHeard = 0;
+static uint32_t Collisions = 0;
+static uint32_t GatewayBusy = 0;
+
+static uint32_t RandomState = 0x12345678;
+
+/* Private function prototypes -----------------------------------------------*/
+static Node_t *SelectedNode( void );
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t Random( void )
+{
+  RandomState ^= RandomState << 13;
+  RandomState ^= RandomState >> 17;
+  RandomState ^= RandomState << 5;
+  return RandomState;
+}
+
+static Node_t *SelectedNode( void )
+{
+  return ( Node_t * )LoRaMacInstanceGetCurrent( );
+}
+
+static void McpsConfirm( McpsConfirm_t *mcpsConfirm )
+{
+  Node_t *node = SelectedNode( );
+
+  node->Confirms++;
+  if( mcpsConfirm->AckReceived == true )
+  {
+    node->AcksReceived++;
+  }
+}
+
+static void McpsIndication( McpsIndication_t *mcpsIndication )
+{
+  ( void )mcpsIndication;
+}
+
+static void MlmeConfirm( MlmeConfirm_t *mlmeConfirm )
+{
+  ( void )mlmeConfirm;
+}
+
+static void MlmeIndication( MlmeIndication_t *mlmeIndication )
+{
+  ( void )mlmeIndication;
+}
+
+static void OnMacProcessNotify( void )
+{
+  SelectedNode( )->ProcessPending = true;
+}
+
+/*!
+ * Main loop of the devices, after each event
+ */
+static void Process( void )
+{
+  bool pending;
+
+  do
+  {
+    pending = false;
+    for( uint32_t i = 0; i < NodeCount; i++ )
+    {
+      if( Nodes[i].ProcessPending == true )
+      {
+        Nodes[i].ProcessPending = false;
+        LoRaMacInstanceProcess( &Nodes[i].Instance );
+        pending = true;
+      }
+    }
+  } while( pending == true );
+}
+
+static void OnUplinkEvent( void *context )
+{
+  Node_t *node = ( Node_t * )context;
+  uint8_t payload[UPLINK_SIZE] = { 0 };
+  McpsReq_t mcpsReq;
+  SimTime_t next = UPLINK_PERIOD / 2 + ( Random( ) % UPLINK_PERIOD );
+
+  if( SimEventGetTime( ) >= UplinksEnd )
+  {
+    return;
+  }
+  mcpsReq.Type = MCPS_CONFIRMED;
+  mcpsReq.Req.Confirmed.fPort = 2;
+  mcpsReq.Req.Confirmed.fBuffer = payload;
+  mcpsReq.Req.Confirmed.fBufferSize = sizeof( payload );
+  mcpsReq.Req.Confirmed.NbTrials = 1;
+  mcpsReq.Req.Confirmed.Datarate = DR_5;
+
+  if( LoRaMacInstanceMcpsRequest( &node->Instance, &mcpsReq ) == LORAMAC_STATUS_OK )
+  {
+    node->Uplinks++;
+  }
+  else
+  {
+    /* previous uplink still running */
+    next = SIM_TIME_S( 1 );
+  }
+  SimEventStart( &node->UplinkEvent, SimEventGetTime( ) + next );
+}
+
+/*!
+ * Acknowledges an uplink in RX1, once all the frames overlapping it ended
+ */
+static void OnDecisionEvent( void *context )
+{
+  Uplink_t *uplink = ( Uplink_t * )context;
+  Node_t *node = uplink->Node;
+  SimRadioFrame_t down = uplink->Frame;
+  uint8_t b0[16] = { 0x49, 0, 0, 0, 0, 1 };
+  uint8_t mic[AES_CMAC_DIGEST_LENGTH];
+  AES_CMAC_CTX cmac;
+
+  uplink->Used = false;
+  if( uplink->Collided == true )
+  {
+    Collisions++;
+    return;
+  }
+
+  down.Time = uplink->Frame.Time + uplink->Frame.Duration + RX1_DELAY;
+  down.Duration = 0;
+  down.IqInverted = true;
+  down.CrcOn = false;
+  down.Rssi = -60;
+  down.Snr = 5;
+
+  /* unconfirmed data down, FCtrl ACK, no port */
+  down.Size = 0;
+  down.Payload[down.Size++] = 0x60;
+  for( uint8_t i = 0; i < 4; i++ )
+  {
+    down.Payload[down.Size++] = ( uint8_t )( node->DevAddr >> ( 8 * i ) );
+  }
+  down.Payload[down.Size++] = 0x20;
+  down.Payload[down.Size++] = ( uint8_t )node->FCntDown;
+  down.Payload[down.Size++] = ( uint8_t )( node->FCntDown >> 8 );
+
+  /* LoRaWAN 1.0 MIC: B0 block then the frame */
+  for( uint8_t i = 0; i < 4; i++ )
+  {
+    b0[6 + i] = ( uint8_t )( node->DevAddr >> ( 8 * i ) );
+    b0[10 + i] = ( uint8_t )( node->FCntDown >> ( 8 * i ) );
+  }
+  b0[15] = down.Size;
+  AES_CMAC_Init( &cmac );
+  AES_CMAC_SetKey( &cmac, node->Key );
+  AES_CMAC_Update( &cmac, b0, sizeof( b0 ) );
+  AES_CMAC_Update( &cmac, down.Payload, down.Size );
+  AES_CMAC_Final( mic, &cmac );
+  memcpy( &down.Payload[down.Size], mic, 4 );
+  down.Size += 4;
+
+  /* the gateway sends one downlink at a time */
+  if( down.Time < GatewayBusyUntil )
+  {
+    GatewayBusy++;
+    return;
+  }
+  down.Duration = SimRadioGetTimeOnAir( &down );
+  GatewayBusyUntil = down.Time + down.Duration;
+
+  if( SimRadioInject( &down ) == false )
+  {
+    printf( "downlink queue full, increase SIM_RADIO_RX_QUEUE_SIZE\n" );
+    exit( 1 );
+  }
+  node->FCntDown++;
+  node->AcksSent++;
+}
+
+/*!
+ * Network: receives the frames sent by the devices
+ */
+static void OnTx( const SimRadioFrame_t *frame )
+{
+  uint32_t devAddr = frame->Payload[1] | ( frame->Payload[2] << 8 ) |
+                     ( frame->Payload[3] << 16 ) | ( ( uint32_t )frame->Payload[4] << 24 );
+  Uplink_t *uplink = NULL;
+  uint32_t i;
+
+  /* the handler runs with the instance owning the radio selected */
+  if( ( devAddr < DEV_ADDR_BASE ) || ( devAddr >= ( DEV_ADDR_BASE + NodeCount ) ) ||
+      ( SelectedNode( ) != &Nodes[devAddr - DEV_ADDR_BASE] ) )
+  {
+    printf( "uplink of 0x%08x raised on the wrong instance\n", ( unsigned )devAddr );
+    exit( 1 );
+  }
+  UplinksHeard++;
+
+  for( i = 0; ( i < UPLINK_POOL_SIZE ) && ( uplink == NULL ); i++ )
+  {
+    if( Uplinks[i].Used == false )
+    {
+      uplink = &Uplinks[i];
+    }
+  }
+  if( uplink == NULL )
+  {
+    printf( "uplink pool full, increase UPLINK_POOL_SIZE\n" );
+    exit( 1 );
+  }
+  uplink->Frame = *frame;
+  uplink->Node = &Nodes[devAddr - DEV_ADDR_BASE];
+  uplink->Collided = false;
+
+  /* same channel and datarate on air at the same time: both are lost */
+  for( i = 0; i < UPLINK_POOL_SIZE; i++ )
+  {
+    Uplink_t *other = &Uplinks[i];
+
+    if( ( other->Used == true ) &&
+        ( other->Frame.Frequency == frame->Frequency ) && ( other->Frame.Datarate == frame->Datarate ) &&
+        ( other->Frame.Time < ( frame->Time + frame->Duration ) ) &&
+        ( frame->Time < ( other->Frame.Time + other->Frame.Duration ) ) )
+    {
+      other->Collided = true;
+      uplink->Collided = true;
+    }
+  }
+
+  /* all the uplinks have the same duration: the ones overlapping this one
+     are over before the decision */
+  uplink->Used = true;
+  SimEventInit( &uplink->DecisionEvent, OnDecisionEvent, uplink );
+  SimEventStart( &uplink->DecisionEvent, frame->Time + ( 2 * frame->Duration ) );
+}
+
+static uint8_t GetBatteryLevel( void )
+{
+  return 254;
+}
+
+static uint16_t GetTemperatureLevel( void )
+{
+  return 25;
+}
+
+int main( int argc, char *argv[] )
+{
+  static LoRaMacPrimitives_t primitives = { McpsConfirm, McpsIndication, MlmeConfirm, MlmeIndication };
+  static LoRaMacCallback_t callbacks = { GetBatteryLevel, GetTemperatureLevel, NULL, OnMacProcessNotify };
+  size_t ctxSize = LoRaMacInstanceGetSize( LORAMAC_REGION_EU868 );
+  SimTime_t duration = SIM_TIME_S( 3600 );
+  uint32_t acksSent = 0;
+  uint32_t acksReceived = 0;
+  uint32_t uplinks = 0;
+  uint32_t confirms = 0;
+  uint32_t misrouted = 0;
+  TimerStats_t timerStats;
+  clock_t start;
+
+  if( argc > 1 )
+  {
+    NodeCount = ( uint32_t )strtoul( argv[1], NULL, 0 );
+  }
+  if( argc > 2 )
+  {
+    duration = SIM_TIME_S( strtoul( argv[2], NULL, 0 ) * 3600 );
+  }
+
+  if( ( NodeCount == 0 ) || ( NodeCount > MAX_DEVICES ) )
+  {
+    printf( "1 to %u devices with TIMER_QUEUE_SIZE %u and SIM_EVENT_QUEUE_SIZE %u, %u devices need %u and %u\n",
+            ( unsigned )MAX_DEVICES, ( unsigned )TIMER_QUEUE_SIZE, ( unsigned )SIM_EVENT_QUEUE_SIZE,
+            ( unsigned )NodeCount, ( unsigned )( NodeCount * TIMERS_PER_DEVICE ),
+            ( unsigned )( ( NodeCount * EVENTS_PER_DEVICE ) + EVENTS_SHARED ) );
+    return 1;
+  }
+
+  Nodes = calloc( NodeCount, sizeof( Node_t ) );
+  if( Nodes == NULL )
+  {
+    return 1;
+  }
+
+  SimEventReset( );
+  HW_RTC_Init( );
+  SimRadioSetTxHandler( OnTx );
+  SimEventSetProcess( Process );
+
+  for( uint32_t n = 0; n < NodeCount; n++ )
+  {
+    Node_t *node = &Nodes[n];
+    void *ctx = malloc( ctxSize );
+    MibRequestConfirm_t mibReq;
+
+    node->DevAddr = DEV_ADDR_BASE + n;
+    for( uint8_t i = 0; i < sizeof( node->Key ); i++ )
+    {
+      node->Key[i] = ( uint8_t )( n * 16 + i );
+    }
+
+    if( ( ctx == NULL ) ||
+        ( LoRaMacInstanceInit( &node->Instance, LORAMAC_REGION_EU868, ctx, ctxSize ) != LORAMAC_STATUS_OK ) )
+    {
+      printf( "instance %u: init failed\n", ( unsigned )n );
+      return 1;
+    }
+    LoRaMacInstanceSetRadio( &node->Instance, &node->Radio );
+    if( LoRaMacInstanceInitialization( &node->Instance, &primitives, &callbacks, LORAMAC_REGION_EU868 ) != LORAMAC_STATUS_OK )
+    {
+      printf( "instance %u: LoRaMacInitialization failed\n", ( unsigned )n );
+      return 1;
+    }
+    SimRadioSetSeed( n + 1 );
+
+    mibReq.Type = MIB_ABP_LORAWAN_VERSION;
+    mibReq.Param.AbpLrWanVersion.Value = 0x01000300;
+    LoRaMacInstanceMibSetRequestConfirm( &node->Instance, &mibReq );
+    mibReq.Type = MIB_NETWORK_ACTIVATION;
+    mibReq.Param.NetworkActivation = ACTIVATION_TYPE_ABP;
+    LoRaMacInstanceMibSetRequestConfirm( &node->Instance, &mibReq );
+    mibReq.Type = MIB_DEV_ADDR;
+    mibReq.Param.DevAddr = node->DevAddr;
+    LoRaMacInstanceMibSetRequestConfirm( &node->Instance, &mibReq );
+    mibReq.Type = MIB_F_NWK_S_INT_KEY;
+    mibReq.Param.FNwkSIntKey = node->Key;
+    LoRaMacInstanceMibSetRequestConfirm( &node->Instance, &mibReq );
+    mibReq.Type = MIB_S_NWK_S_INT_KEY;
+    mibReq.Param.SNwkSIntKey = node->Key;
+    LoRaMacInstanceMibSetRequestConfirm( &node->Instance, &mibReq );
+    mibReq.Type = MIB_NWK_S_ENC_KEY;
+    mibReq.Param.NwkSEncKey = node->Key;
+    LoRaMacInstanceMibSetRequestConfirm( &node->Instance, &mibReq );
+    mibReq.Type = MIB_APP_S_KEY;
+    mibReq.Param.AppSKey = node->Key;
+    LoRaMacInstanceMibSetRequestConfirm( &node->Instance, &mibReq );
+    mibReq.Type = MIB_ADR;
+    mibReq.Param.AdrEnable = false;
+    LoRaMacInstanceMibSetRequestConfirm( &node->Instance, &mibReq );
+    LoRaMacInstanceStart( &node->Instance );
+
+    SimEventInit( &node->UplinkEvent, OnUplinkEvent, node );
+    SimEventStart( &node->UplinkEvent, Random( ) % UPLINK_PERIOD );
+  }
+
+  /* no uplink starts after the duration, the last exchanges complete */
+  UplinksEnd = duration;
+  start = clock( );
+  SimEventRunUntil( duration + SIM_TIME_S( 60 ) );
+
+  for( uint32_t n = 0; n < NodeCount; n++ )
+  {
+    uplinks += Nodes[n].Uplinks;
+    confirms += Nodes[n].Confirms;
+    acksSent += Nodes[n].AcksSent;
+    acksReceived += Nodes[n].AcksReceived;
+    if( Nodes[n].AcksReceived != Nodes[n].AcksSent )
+    {
+      misrouted++;
+      printf( "device 0x%08x: %u acknowledgements sent, %u received\n", ( unsigned )Nodes[n].DevAddr,
+              ( unsigned )Nodes[n].AcksSent, ( unsigned )Nodes[n].AcksReceived );
+    }
+  }
+
+  printf( "%u devices, %.1f h: %u uplinks, %u heard, %u collided, %u gateway busy\n",
+          ( unsigned )NodeCount, duration / 3.6e9, ( unsigned )uplinks, ( unsigned )UplinksHeard,
+          ( unsigned )Collisions, ( unsigned )GatewayBusy );
+  printf( "%u confirms, %u acknowledgements sent, %u received, %u devices with a mismatch, %.2f s cpu\n",
+          ( unsigned )confirms, ( unsigned )acksSent, ( unsigned )acksReceived, ( unsigned )misrouted,
+          ( double )( clock( ) - start ) / CLOCKS_PER_SEC );
+
+  /* a timer which failed to start stalls its device */
+  TimerGetStats( &timerStats );
+  if( timerStats.QueueFullCount != 0 )
+  {
+    printf( "%u timers not started, increase TIMER_QUEUE_SIZE\n", ( unsigned )timerStats.QueueFullCount );
+    return 1;
+  }
+
+  return ( misrouted == 0 ) ? 0 : 1;
+}
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
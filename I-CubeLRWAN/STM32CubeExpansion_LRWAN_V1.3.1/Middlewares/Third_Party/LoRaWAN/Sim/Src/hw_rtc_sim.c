@@ -0,0 +1,163 @@
+/**
+  ******************************************************************************
+  * @file    hw_rtc_sim.c
+  * @author  MCD Application Team
+  * @brief   Virtual RTC of the host simulation
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "hw.h"
+#include "timeServer.h"
+#include "sim_event.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* MCU wake up time and RTC granularity of the boards, in ticks */
+#define MIN_ALARM_DELAY                             3
+
+/* Private macro -------------------------------------------------------------*/
+#define RTC_TICK_US                                 1000
+
+/* Private variables ---------------------------------------------------------*/
+static SimEvent_t RtcAlarm;
+
+/*!
+ * Keep the value of the RTC timer when the RTC alarm is set
+ * Set with the HW_RTC_SetTimerContext function
+ * Value is kept as a Reference to calculate alarm
+ */
+static uint32_t RtcTimerContext = 0;
+
+static uint32_t RtcBackup[2] = { 0 };
+
+/* Private function prototypes -----------------------------------------------*/
+static void RtcAlarmEvent( void *context );
+
+/* Exported functions ---------------------------------------------------------*/
+void HW_RTC_Init( void )
+{
+  SimEventStop( &RtcAlarm );
+  SimEventInit( &RtcAlarm, RtcAlarmEvent, NULL );
+  HW_RTC_SetTimerContext( );
+}
+
+void HW_RTC_StopAlarm( void )
+{
+  SimEventStop( &RtcAlarm );
+}
+
+uint32_t HW_RTC_GetMinimumTimeout( void )
+{
+  return MIN_ALARM_DELAY;
+}
+
+void HW_RTC_SetAlarm( uint32_t timeout )
+{
+  /* alarm tick relative to now, intentional wrap around */
+  int32_t delta = ( int32_t )( RtcTimerContext + timeout - HW_RTC_GetTimerValue( ) );
+  SimTime_t now = SimEventGetTime( );
+  SimTime_t time = now - ( now % RTC_TICK_US );
+
+  if( delta > 0 )
+  {
+    time += ( SimTime_t )delta * RTC_TICK_US;
+  }
+  SimEventStart( &RtcAlarm, time );
+}
+
+uint32_t HW_RTC_GetTimerElapsedTime( void )
+{
+  return HW_RTC_GetTimerValue( ) - RtcTimerContext;
+}
+
+uint32_t HW_RTC_GetTimerValue( void )
+{
+  return ( uint32_t )( SimEventGetTime( ) / RTC_TICK_US );
+}
+
+uint32_t HW_RTC_SetTimerContext( void )
+{
+  RtcTimerContext = HW_RTC_GetTimerValue( );
+  return RtcTimerContext;
+}
+
+uint32_t HW_RTC_GetTimerContext( void )
+{
+  return RtcTimerContext;
+}
+
+void HW_RTC_IrqHandler( void )
+{
+  TimerIrqHandler( );
+}
+
+void HW_RTC_DelayMs( uint32_t delay )
+{
+  SimEventRunUntil( SimEventGetTime( ) + SIM_TIME_MS( delay ) );
+}
+
+void HW_RTC_setMcuWakeUpTime( void )
+{
+}
+
+int16_t HW_RTC_getMcuWakeUpTime( void )
+{
+  return 0;
+}
+
+uint32_t HW_RTC_ms2Tick( TimerTime_t timeMilliSec )
+{
+  return ( uint32_t )timeMilliSec;
+}
+
+TimerTime_t HW_RTC_Tick2ms( uint32_t tick )
+{
+  return ( TimerTime_t )tick;
+}
+
+TimerTime_t RtcTempCompensation( TimerTime_t period, float temperature )
+{
+  /* the virtual clock does not drift */
+  ( void )temperature;
+  return period;
+}
+
+uint32_t HW_RTC_GetCalendarTime( uint16_t *subSeconds )
+{
+  SimTime_t now = SimEventGetTime( );
+
+  *subSeconds = ( uint16_t )( ( now % SIM_TIME_S( 1 ) ) / RTC_TICK_US );
+  return ( uint32_t )( now / SIM_TIME_S( 1 ) );
+}
+
+void HW_RTC_BKUPRead( uint32_t *Data0, uint32_t *Data1 )
+{
+  *Data0 = RtcBackup[0];
+  *Data1 = RtcBackup[1];
+}
+
+void HW_RTC_BKUPWrite( uint32_t Data0, uint32_t Data1 )
+{
+  RtcBackup[0] = Data0;
+  RtcBackup[1] = Data1;
+}
+
+/* Private functions ---------------------------------------------------------*/
+static void RtcAlarmEvent( void *context )
+{
+  ( void )context;
+  HW_RTC_IrqHandler( );
+}
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
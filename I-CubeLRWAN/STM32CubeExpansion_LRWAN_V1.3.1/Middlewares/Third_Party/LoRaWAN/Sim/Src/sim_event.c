@@ -0,0 +1,237 @@
+/**
+  ******************************************************************************
+  * @file    sim_event.c
+  * @author  MCD Application Team
+  * @brief   Discrete-event scheduler and virtual clock of the host simulation
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "sim_event.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+#define HEAP_PARENT( i )                            ( ( ( i ) - 1 ) / 2 )
+#define HEAP_LEFT( i )                              ( ( 2 * ( i ) ) + 1 )
+
+/* Private variables ---------------------------------------------------------*/
+/*!
+ * Pending events, binary min-heap ordered by expiry time then sequence
+ */
+static SimEvent_t *EventHeap[SIM_EVENT_QUEUE_SIZE];
+
+static uint32_t EventCount = 0;
+
+static uint32_t EventSequence = 0;
+
+static SimTime_t Now = 0;
+
+static void ( *EventProcess )( void ) = NULL;
+
+/* Private function prototypes -----------------------------------------------*/
+static bool EventIsBefore( SimEvent_t *a, SimEvent_t *b );
+
+static void EventHeapSet( uint32_t index, SimEvent_t *obj );
+
+static void EventHeapUp( uint32_t index );
+
+static void EventHeapDown( uint32_t index );
+
+static void EventHeapRemove( uint32_t index );
+
+/* Functions Definition ------------------------------------------------------*/
+void SimEventReset( void )
+{
+  while( EventCount > 0 )
+  {
+    EventHeap[--EventCount]->IsPending = false;
+  }
+  EventSequence = 0;
+  Now = 0;
+}
+
+void SimEventInit( SimEvent_t *obj, void ( *callback )( void *context ), void *context )
+{
+  obj->Time = 0;
+  obj->Sequence = 0;
+  obj->HeapIndex = 0;
+  obj->IsPending = false;
+  obj->Callback = callback;
+  obj->Context = context;
+}
+
+void SimEventStart( SimEvent_t *obj, SimTime_t time )
+{
+  if( obj->IsPending == true )
+  {
+    EventHeapRemove( obj->HeapIndex );
+  }
+  if( EventCount >= SIM_EVENT_QUEUE_SIZE )
+  {
+    /* SIM_EVENT_QUEUE_SIZE is too small for the scenario */
+    fprintf( stderr, "event queue full: %u events pending, build with SIM_EVENT_QUEUE_SIZE above %u\n",
+             ( unsigned )EventCount, ( unsigned )SIM_EVENT_QUEUE_SIZE );
+    abort( );
+  }
+
+  obj->Time = time;
+  obj->Sequence = EventSequence++;
+  obj->IsPending = true;
+  EventHeapSet( EventCount, obj );
+  EventHeapUp( EventCount++ );
+}
+
+void SimEventStop( SimEvent_t *obj )
+{
+  if( obj->IsPending == true )
+  {
+    EventHeapRemove( obj->HeapIndex );
+  }
+}
+
+bool SimEventIsPending( SimEvent_t *obj )
+{
+  return obj->IsPending;
+}
+
+SimTime_t SimEventGetTime( void )
+{
+  return Now;
+}
+
+bool SimEventGetNextTime( SimTime_t *time )
+{
+  if( EventCount == 0 )
+  {
+    return false;
+  }
+  *time = EventHeap[0]->Time;
+  return true;
+}
+
+void SimEventSetProcess( void ( *process )( void ) )
+{
+  EventProcess = process;
+}
+
+bool SimEventRunNext( void )
+{
+  SimEvent_t *obj;
+
+  if( EventCount == 0 )
+  {
+    return false;
+  }
+
+  obj = EventHeap[0];
+  EventHeapRemove( 0 );
+
+  /* the clock never goes back, late events expire now */
+  if( obj->Time > Now )
+  {
+    Now = obj->Time;
+  }
+  if( obj->Callback != NULL )
+  {
+    obj->Callback( obj->Context );
+  }
+  if( EventProcess != NULL )
+  {
+    EventProcess( );
+  }
+  return true;
+}
+
+void SimEventRunUntil( SimTime_t time )
+{
+  while( ( EventCount > 0 ) && ( EventHeap[0]->Time <= time ) )
+  {
+    SimEventRunNext( );
+  }
+  if( time > Now )
+  {
+    Now = time;
+  }
+}
+
+/* Private Functions Definition ----------------------------------------------*/
+static bool EventIsBefore( SimEvent_t *a, SimEvent_t *b )
+{
+  if( a->Time != b->Time )
+  {
+    return a->Time < b->Time;
+  }
+  /* intentional wrap around */
+  return ( int32_t )( a->Sequence - b->Sequence ) < 0;
+}
+
+static void EventHeapSet( uint32_t index, SimEvent_t *obj )
+{
+  EventHeap[index] = obj;
+  obj->HeapIndex = index;
+}
+
+static void EventHeapUp( uint32_t index )
+{
+  SimEvent_t *obj = EventHeap[index];
+
+  while( ( index > 0 ) && ( EventIsBefore( obj, EventHeap[HEAP_PARENT( index )] ) == true ) )
+  {
+    EventHeapSet( index, EventHeap[HEAP_PARENT( index )] );
+    index = HEAP_PARENT( index );
+  }
+  EventHeapSet( index, obj );
+}
+
+static void EventHeapDown( uint32_t index )
+{
+  SimEvent_t *obj = EventHeap[index];
+  uint32_t child;
+
+  while( ( child = HEAP_LEFT( index ) ) < EventCount )
+  {
+    if( ( ( child + 1 ) < EventCount ) && ( EventIsBefore( EventHeap[child + 1], EventHeap[child] ) == true ) )
+    {
+      child++;
+    }
+    if( EventIsBefore( EventHeap[child], obj ) == false )
+    {
+      break;
+    }
+    EventHeapSet( index, EventHeap[child] );
+    index = child;
+  }
+  EventHeapSet( index, obj );
+}
+
+static void EventHeapRemove( uint32_t index )
+{
+  SimEvent_t *last;
+
+  EventHeap[index]->IsPending = false;
+
+  if( index != --EventCount )
+  {
+    /* move the last event in the hole, then restore the order */
+    last = EventHeap[EventCount];
+    EventHeapSet( index, last );
+    EventHeapUp( index );
+    EventHeapDown( last->HeapIndex );
+  }
+}
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
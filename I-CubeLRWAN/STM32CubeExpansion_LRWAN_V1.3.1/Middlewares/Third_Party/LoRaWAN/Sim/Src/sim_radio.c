@@ -0,0 +1,717 @@
+/**
+  ******************************************************************************
+  * @file    sim_radio.c
+  * @author  MCD Application Team
+  * @brief   Simulated radio of the host simulation
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <string.h>
+#include "sim_radio.h"
+#if defined( LORAMAC_MULTI_INSTANCE )
+#include "LoRaMacInstance.h"
+#endif
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* LoRaWAN FSK sync word size in bytes, see SX1276SetTxConfig */
+#define FSK_SYNCWORD_SIZE                           3
+
+/* LoRaWAN FSK preamble length is given in bytes */
+#define FSK_SYMBOL_BITS                             8
+
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/*!
+ * Radio of a single device, or of the instances without a radio of their own
+ */
+static SimRadio_t DefaultRadio = { .RandomState = 1 };
+
+/*!
+ * Radios hearing the injected frames
+ */
+static SimRadio_t *RadioList = NULL;
+
+static void ( *RadioTxHandler )( const SimRadioFrame_t *frame ) = NULL;
+
+/* Private function prototypes -----------------------------------------------*/
+static void SimRadioIoInit( void );
+static void SimRadioIoDeInit( void );
+static uint32_t SimRadioInit( RadioEvents_t *events );
+static RadioState_t SimRadioGetStatus( void );
+static void SimRadioSetModem( RadioModems_t modem );
+static void SimRadioSetChannel( uint32_t freq );
+static bool SimRadioIsChannelFree( RadioModems_t modem, uint32_t freq, int16_t rssiThresh, uint32_t maxCarrierSenseTime );
+static uint32_t SimRadioRandom( void );
+static void SimRadioSetRxConfig( RadioModems_t modem, uint32_t bandwidth,
+                                 uint32_t datarate, uint8_t coderate,
+                                 uint32_t bandwidthAfc, uint16_t preambleLen,
+                                 uint16_t symbTimeout, bool fixLen,
+                                 uint8_t payloadLen,
+                                 bool crcOn, bool freqHopOn, uint8_t hopPeriod,
+                                 bool iqInverted, bool rxContinuous );
+static void SimRadioSetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev,
+                                 uint32_t bandwidth, uint32_t datarate,
+                                 uint8_t coderate, uint16_t preambleLen,
+                                 bool fixLen, bool crcOn, bool freqHopOn,
+                                 uint8_t hopPeriod, bool iqInverted, uint32_t timeout );
+static bool SimRadioCheckRfFrequency( uint32_t frequency );
+static uint32_t SimRadioTimeOnAir( RadioModems_t modem, uint8_t pktLen );
+static void SimRadioSend( uint8_t *buffer, uint8_t size );
+static void SimRadioSleep( void );
+static void SimRadioStandby( void );
+static void SimRadioRx( uint32_t timeout );
+static void SimRadioStartCad( void );
+static void SimRadioSetTxContinuousWave( uint32_t freq, int8_t power, uint16_t time );
+static int16_t SimRadioRssi( RadioModems_t modem );
+static void SimRadioWrite( uint16_t addr, uint8_t data );
+static uint8_t SimRadioRead( uint16_t addr );
+static void SimRadioWriteBuffer( uint16_t addr, uint8_t *buffer, uint8_t size );
+static void SimRadioReadBuffer( uint16_t addr, uint8_t *buffer, uint8_t size );
+static void SimRadioSetMaxPayloadLength( RadioModems_t modem, uint8_t max );
+static void SimRadioSetPublicNetwork( bool enable );
+static uint32_t SimRadioGetWakeupTime( void );
+static void SimRadioSetRxBuffer( uint8_t *buffer );
+
+static SimTime_t SymbolTime( RadioModems_t modem, uint32_t bandwidth, uint32_t datarate );
+static SimRadio_t *RadioGet( void );
+static void RadioSelectOwner( SimRadio_t *radio );
+static void RadioStop( SimRadio_t *radio );
+static void RxSchedule( SimRadio_t *radio );
+static int8_t RxFrameOnAir( SimRadio_t *radio, uint32_t freq );
+static void OnTxDone( void *context );
+static void OnTxTimeout( void *context );
+static void OnRxDone( void *context );
+static void OnRxTimeout( void *context );
+static void OnCadDone( void *context );
+
+/*!
+ * Radio driver structure initialization
+ */
+const struct Radio_s Radio =
+{
+  SimRadioIoInit,
+  SimRadioIoDeInit,
+  SimRadioInit,
+  SimRadioGetStatus,
+  SimRadioSetModem,
+  SimRadioSetChannel,
+  SimRadioIsChannelFree,
+  SimRadioRandom,
+  SimRadioSetRxConfig,
+  SimRadioSetTxConfig,
+  SimRadioCheckRfFrequency,
+  SimRadioTimeOnAir,
+  SimRadioSend,
+  SimRadioSleep,
+  SimRadioStandby,
+  SimRadioRx,
+  SimRadioStartCad,
+  SimRadioSetTxContinuousWave,
+  SimRadioRssi,
+  SimRadioWrite,
+  SimRadioRead,
+  SimRadioWriteBuffer,
+  SimRadioReadBuffer,
+  SimRadioSetMaxPayloadLength,
+  SimRadioSetPublicNetwork,
+  SimRadioGetWakeupTime,
+  NULL,
+  NULL,
+  NULL,
+  SimRadioSetRxBuffer
+};
+
+/* Functions Definition ------------------------------------------------------*/
+void SimRadioSetTxHandler( void ( *handler )( const SimRadioFrame_t *frame ) )
+{
+  RadioTxHandler = handler;
+}
+
+bool SimRadioInject( const SimRadioFrame_t *frame )
+{
+  bool queued = ( RadioList != NULL );
+
+  for( SimRadio_t *radio = RadioList; radio != NULL; radio = radio->Next )
+  {
+    uint8_t i;
+
+    for( i = 0; i < SIM_RADIO_RX_QUEUE_SIZE; i++ )
+    {
+      /* frames over can no longer be received */
+      if( ( radio->RxQueueUsed[i] == true ) && ( radio->RxLocked != i ) &&
+          ( ( radio->RxQueue[i].Time + radio->RxQueue[i].Duration ) < SimEventGetTime( ) ) )
+      {
+        radio->RxQueueUsed[i] = false;
+      }
+    }
+    for( i = 0; i < SIM_RADIO_RX_QUEUE_SIZE; i++ )
+    {
+      if( radio->RxQueueUsed[i] == false )
+      {
+        radio->RxQueue[i] = *frame;
+        if( radio->RxQueue[i].Duration == 0 )
+        {
+          radio->RxQueue[i].Duration = SimRadioGetTimeOnAir( frame );
+        }
+        radio->RxQueueUsed[i] = true;
+        RxSchedule( radio );
+        break;
+      }
+    }
+    if( i == SIM_RADIO_RX_QUEUE_SIZE )
+    {
+      queued = false;
+    }
+  }
+  return queued;
+}
+
+SimTime_t SimRadioGetTimeOnAir( const SimRadioFrame_t *frame )
+{
+  double airTime = 0.0;
+
+  /* same computation as SX1276GetTimeOnAir, in microseconds */
+  switch( frame->Modem )
+  {
+  case MODEM_FSK:
+    {
+      airTime = ( FSK_SYMBOL_BITS * ( frame->PreambleLen + FSK_SYNCWORD_SIZE +
+                                      ( ( frame->FixLen == true ) ? 0.0 : 1.0 ) +
+                                      frame->Size +
+                                      ( ( frame->CrcOn == true ) ? 2.0 : 0.0 ) ) /
+                 frame->Datarate ) * 1e6;
+    }
+    break;
+  case MODEM_LORA:
+    {
+      double ts = ( double )SymbolTime( MODEM_LORA, frame->Bandwidth, frame->Datarate );
+      bool lowDatarateOptimize = ( ( frame->Bandwidth == 0 ) && ( frame->Datarate >= 11 ) ) ||
+                                 ( ( frame->Bandwidth == 1 ) && ( frame->Datarate == 12 ) );
+      double tmp = ceil( ( 8.0 * frame->Size - 4.0 * frame->Datarate +
+                           28 + ( ( frame->CrcOn == true ) ? 16 : 0 ) -
+                           ( ( frame->FixLen == true ) ? 20 : 0 ) ) /
+                           ( double )( 4 * ( frame->Datarate - ( lowDatarateOptimize ? 2 : 0 ) ) ) ) *
+                           ( frame->Coderate + 4 );
+      double nPayload = 8 + ( ( tmp > 0 ) ? tmp : 0 );
+
+      airTime = ( frame->PreambleLen + 4.25 + nPayload ) * ts;
+    }
+    break;
+  }
+  return ( SimTime_t )ceil( airTime );
+}
+
+void SimRadioSetSeed( uint32_t seed )
+{
+  RadioGet( )->RandomState = ( seed != 0 ) ? seed : 1;
+}
+
+/* Private Functions Definition ----------------------------------------------*/
+static void SimRadioIoInit( void )
+{
+}
+
+static void SimRadioIoDeInit( void )
+{
+}
+
+static uint32_t SimRadioInit( RadioEvents_t *events )
+{
+  SimRadio_t *radio = RadioGet( );
+
+  radio->Events = events;
+#if defined( LORAMAC_MULTI_INSTANCE )
+  radio->Owner = LoRaMacInstanceGetCurrent( );
+#endif
+
+  SimEventStop( &radio->TxDoneEvent );
+  SimEventStop( &radio->TxTimeoutEvent );
+  SimEventStop( &radio->RxDoneEvent );
+  SimEventStop( &radio->RxTimeoutEvent );
+  SimEventStop( &radio->CadDoneEvent );
+  SimEventInit( &radio->TxDoneEvent, OnTxDone, radio );
+  SimEventInit( &radio->TxTimeoutEvent, OnTxTimeout, radio );
+  SimEventInit( &radio->RxDoneEvent, OnRxDone, radio );
+  SimEventInit( &radio->RxTimeoutEvent, OnRxTimeout, radio );
+  SimEventInit( &radio->CadDoneEvent, OnCadDone, radio );
+
+  if( radio->IsListed == false )
+  {
+    radio->Next = RadioList;
+    RadioList = radio;
+    radio->IsListed = true;
+  }
+  if( radio->RandomState == 0 )
+  {
+    radio->RandomState = 1;
+  }
+  if( radio->RxBuffer == NULL )
+  {
+    radio->RxBuffer = radio->RxPayload;
+  }
+  memset( radio->RxQueueUsed, 0, sizeof( radio->RxQueueUsed ) );
+  radio->RxLocked = -1;
+  radio->State = RF_IDLE;
+  return 0;
+}
+
+static RadioState_t SimRadioGetStatus( void )
+{
+  return RadioGet( )->State;
+}
+
+static void SimRadioSetModem( RadioModems_t modem )
+{
+  RadioGet( )->Modem = modem;
+}
+
+static void SimRadioSetChannel( uint32_t freq )
+{
+  RadioGet( )->Channel = freq;
+}
+
+static bool SimRadioIsChannelFree( RadioModems_t modem, uint32_t freq, int16_t rssiThresh, uint32_t maxCarrierSenseTime )
+{
+  SimRadio_t *radio = RadioGet( );
+  int8_t i = RxFrameOnAir( radio, freq );
+
+  ( void )modem;
+  ( void )maxCarrierSenseTime;
+  /* the carrier sense does not advance the virtual clock */
+  return ( i < 0 ) || ( radio->RxQueue[i].Rssi <= rssiThresh );
+}
+
+static uint32_t SimRadioRandom( void )
+{
+  SimRadio_t *radio = RadioGet( );
+
+  /* xorshift32, reproducible from SimRadioSetSeed */
+  radio->RandomState ^= radio->RandomState << 13;
+  radio->RandomState ^= radio->RandomState >> 17;
+  radio->RandomState ^= radio->RandomState << 5;
+  return radio->RandomState;
+}
+
+static void SimRadioSetRxConfig( RadioModems_t modem, uint32_t bandwidth,
+                                 uint32_t datarate, uint8_t coderate,
+                                 uint32_t bandwidthAfc, uint16_t preambleLen,
+                                 uint16_t symbTimeout, bool fixLen,
+                                 uint8_t payloadLen,
+                                 bool crcOn, bool freqHopOn, uint8_t hopPeriod,
+                                 bool iqInverted, bool rxContinuous )
+{
+  SimRadio_t *radio = RadioGet( );
+
+  /* the frame format is not checked, only the reception window is modelled */
+  ( void )coderate;
+  ( void )bandwidthAfc;
+  ( void )preambleLen;
+  ( void )fixLen;
+  ( void )payloadLen;
+  ( void )crcOn;
+  ( void )freqHopOn;
+  ( void )hopPeriod;
+  ( void )iqInverted;
+
+  radio->Modem = modem;
+  radio->RxSettings.Modem = modem;
+  radio->RxSettings.Bandwidth = bandwidth;
+  radio->RxSettings.Datarate = datarate;
+  radio->RxSettings.SymbTimeout = symbTimeout;
+  radio->RxSettings.RxContinuous = rxContinuous;
+}
+
+static void SimRadioSetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev,
+                                 uint32_t bandwidth, uint32_t datarate,
+                                 uint8_t coderate, uint16_t preambleLen,
+                                 bool fixLen, bool crcOn, bool freqHopOn,
+                                 uint8_t hopPeriod, bool iqInverted, uint32_t timeout )
+{
+  SimRadio_t *radio = RadioGet( );
+
+  ( void )fdev;
+  ( void )freqHopOn;
+  ( void )hopPeriod;
+  ( void )timeout;
+
+  radio->Modem = modem;
+  radio->TxFrame.Modem = modem;
+  radio->TxFrame.Power = power;
+  radio->TxFrame.Bandwidth = bandwidth;
+  radio->TxFrame.Datarate = datarate;
+  radio->TxFrame.Coderate = coderate;
+  radio->TxFrame.PreambleLen = preambleLen;
+  radio->TxFrame.FixLen = fixLen;
+  radio->TxFrame.CrcOn = crcOn;
+  radio->TxFrame.IqInverted = iqInverted;
+}
+
+static bool SimRadioCheckRfFrequency( uint32_t frequency )
+{
+  ( void )frequency;
+  return true;
+}
+
+static uint32_t SimRadioTimeOnAir( RadioModems_t modem, uint8_t pktLen )
+{
+  SimRadioFrame_t frame = RadioGet( )->TxFrame;
+
+  frame.Modem = modem;
+  frame.Size = pktLen;
+  /* milliseconds rounded up, as the SX1276 driver */
+  return ( uint32_t )( ( SimRadioGetTimeOnAir( &frame ) + 999 ) / 1000 );
+}
+
+static void SimRadioSend( uint8_t *buffer, uint8_t size )
+{
+  SimRadio_t *radio = RadioGet( );
+
+  RadioStop( radio );
+
+  memcpy( radio->TxFrame.Payload, buffer, size );
+  radio->TxFrame.Size = size;
+  radio->TxFrame.Frequency = radio->Channel;
+  radio->TxFrame.Time = SimEventGetTime( );
+  radio->TxFrame.Duration = SimRadioGetTimeOnAir( &radio->TxFrame );
+
+  radio->State = RF_TX_RUNNING;
+  SimEventStart( &radio->TxDoneEvent, radio->TxFrame.Time + radio->TxFrame.Duration );
+}
+
+static void SimRadioSleep( void )
+{
+  RadioStop( RadioGet( ) );
+}
+
+static void SimRadioStandby( void )
+{
+  RadioStop( RadioGet( ) );
+}
+
+static void SimRadioRx( uint32_t timeout )
+{
+  SimRadio_t *radio = RadioGet( );
+  SimTime_t symbolTime = SymbolTime( radio->RxSettings.Modem, radio->RxSettings.Bandwidth, radio->RxSettings.Datarate );
+
+  RadioStop( radio );
+
+  radio->RxStart = SimEventGetTime( );
+  radio->RxEnd = 0;
+  if( radio->RxSettings.RxContinuous == false )
+  {
+    /* single reception: the radio gives up after SymbTimeout symbols */
+    radio->RxEnd = radio->RxStart + ( radio->RxSettings.SymbTimeout * symbolTime );
+  }
+  if( ( timeout != 0 ) && ( ( radio->RxEnd == 0 ) || ( ( radio->RxStart + SIM_TIME_MS( timeout ) ) < radio->RxEnd ) ) )
+  {
+    radio->RxEnd = radio->RxStart + SIM_TIME_MS( timeout );
+  }
+
+  radio->State = RF_RX_RUNNING;
+  RxSchedule( radio );
+}
+
+static void SimRadioStartCad( void )
+{
+  SimRadio_t *radio = RadioGet( );
+
+  RadioStop( radio );
+
+  radio->State = RF_CAD;
+  SimEventStart( &radio->CadDoneEvent, SimEventGetTime( ) +
+                 ( 2 * SymbolTime( MODEM_LORA, radio->TxFrame.Bandwidth, radio->TxFrame.Datarate ) ) );
+}
+
+static void SimRadioSetTxContinuousWave( uint32_t freq, int8_t power, uint16_t time )
+{
+  SimRadio_t *radio = RadioGet( );
+
+  ( void )power;
+  RadioStop( radio );
+
+  radio->Channel = freq;
+  radio->State = RF_TX_RUNNING;
+  SimEventStart( &radio->TxTimeoutEvent, SimEventGetTime( ) + SIM_TIME_S( time ) );
+}
+
+static int16_t SimRadioRssi( RadioModems_t modem )
+{
+  SimRadio_t *radio = RadioGet( );
+  int8_t i = RxFrameOnAir( radio, radio->Channel );
+
+  ( void )modem;
+  return ( i < 0 ) ? SIM_RADIO_NOISE_FLOOR : radio->RxQueue[i].Rssi;
+}
+
+static void SimRadioWrite( uint16_t addr, uint8_t data )
+{
+  ( void )addr;
+  ( void )data;
+}
+
+static uint8_t SimRadioRead( uint16_t addr )
+{
+  ( void )addr;
+  return 0;
+}
+
+static void SimRadioWriteBuffer( uint16_t addr, uint8_t *buffer, uint8_t size )
+{
+  ( void )addr;
+  ( void )buffer;
+  ( void )size;
+}
+
+static void SimRadioReadBuffer( uint16_t addr, uint8_t *buffer, uint8_t size )
+{
+  ( void )addr;
+  memset( buffer, 0, size );
+}
+
+static void SimRadioSetMaxPayloadLength( RadioModems_t modem, uint8_t max )
+{
+  ( void )modem;
+  ( void )max;
+}
+
+static void SimRadioSetPublicNetwork( bool enable )
+{
+  ( void )enable;
+}
+
+static uint32_t SimRadioGetWakeupTime( void )
+{
+  return 0;
+}
+
+static void SimRadioSetRxBuffer( uint8_t *buffer )
+{
+  SimRadio_t *radio = RadioGet( );
+
+  radio->RxBuffer = ( buffer != NULL ) ? buffer : radio->RxPayload;
+}
+
+static SimTime_t SymbolTime( RadioModems_t modem, uint32_t bandwidth, uint32_t datarate )
+{
+  if( modem == MODEM_FSK )
+  {
+    /* one byte */
+    return ( SimTime_t )( ( FSK_SYMBOL_BITS * 1000000UL ) / datarate );
+  }
+  /* LoRa bandwidth 0: 125 kHz, 1: 250 kHz, 2: 500 kHz */
+  return ( ( SimTime_t )1000000 << datarate ) / ( 125000UL << bandwidth );
+}
+
+/*!
+ * Radio the driver functions work on: the one bound to the selected LoRaMac
+ * instance, the default radio otherwise
+ */
+static SimRadio_t *RadioGet( void )
+{
+#if defined( LORAMAC_MULTI_INSTANCE )
+  LoRaMacInstance_t *instance = LoRaMacInstanceGetCurrent( );
+
+  if( ( instance != NULL ) && ( instance->Radio != NULL ) )
+  {
+    return ( SimRadio_t * )instance->Radio;
+  }
+#endif
+  return &DefaultRadio;
+}
+
+/*!
+ * Routes the events of a radio to the LoRaMac instance which initialized it
+ */
+static void RadioSelectOwner( SimRadio_t *radio )
+{
+#if defined( LORAMAC_MULTI_INSTANCE )
+  if( radio->Owner != NULL )
+  {
+    LoRaMacInstanceSelect( ( LoRaMacInstance_t * )radio->Owner );
+  }
+#else
+  ( void )radio;
+#endif
+}
+
+static void RadioStop( SimRadio_t *radio )
+{
+  SimEventStop( &radio->TxDoneEvent );
+  SimEventStop( &radio->TxTimeoutEvent );
+  SimEventStop( &radio->RxDoneEvent );
+  SimEventStop( &radio->RxTimeoutEvent );
+  SimEventStop( &radio->CadDoneEvent );
+  radio->RxLocked = -1;
+  radio->State = RF_IDLE;
+}
+
+/*!
+ * Locks the reception on the first frame the receiver detects, or waits for
+ * the end of the window.
+ */
+static void RxSchedule( SimRadio_t *radio )
+{
+  SimRadioRxSettings_t *settings = &radio->RxSettings;
+  SimTime_t symbolTime;
+  SimTime_t detectTime;
+  SimTime_t lockTime = 0;
+  int8_t lock = -1;
+
+  if( ( radio->State != RF_RX_RUNNING ) || ( radio->RxLocked >= 0 ) )
+  {
+    return;
+  }
+
+  symbolTime = SymbolTime( settings->Modem, settings->Bandwidth, settings->Datarate );
+  for( uint8_t i = 0; i < SIM_RADIO_RX_QUEUE_SIZE; i++ )
+  {
+    SimRadioFrame_t *frame = &radio->RxQueue[i];
+
+    if( ( radio->RxQueueUsed[i] == false ) || ( frame->Modem != settings->Modem ) ||
+        ( frame->Frequency != radio->Channel ) || ( frame->Datarate != settings->Datarate ) ||
+        ( ( frame->Modem == MODEM_LORA ) && ( frame->Bandwidth != settings->Bandwidth ) ) )
+    {
+      continue;
+    }
+    /* enough preamble symbols must be heard, before the window is over */
+    detectTime = ( ( frame->Time > radio->RxStart ) ? frame->Time : radio->RxStart ) + ( SIM_RADIO_PREAMBLE_DETECT_SYMBOLS * symbolTime );
+    if( ( detectTime > ( frame->Time + ( frame->PreambleLen * symbolTime ) ) ) ||
+        ( ( radio->RxEnd != 0 ) && ( detectTime > radio->RxEnd ) ) )
+    {
+      continue;
+    }
+    if( ( lock < 0 ) || ( detectTime < lockTime ) )
+    {
+      lock = i;
+      lockTime = detectTime;
+    }
+  }
+
+  if( lock >= 0 )
+  {
+    radio->RxLocked = lock;
+    SimEventStop( &radio->RxTimeoutEvent );
+    SimEventStart( &radio->RxDoneEvent, radio->RxQueue[lock].Time + radio->RxQueue[lock].Duration );
+  }
+  else if( ( radio->RxEnd != 0 ) && ( SimEventIsPending( &radio->RxTimeoutEvent ) == false ) )
+  {
+    SimEventStart( &radio->RxTimeoutEvent, radio->RxEnd );
+  }
+}
+
+static int8_t RxFrameOnAir( SimRadio_t *radio, uint32_t freq )
+{
+  SimTime_t now = SimEventGetTime( );
+
+  for( uint8_t i = 0; i < SIM_RADIO_RX_QUEUE_SIZE; i++ )
+  {
+    if( ( radio->RxQueueUsed[i] == true ) && ( radio->RxQueue[i].Frequency == freq ) &&
+        ( radio->RxQueue[i].Time <= now ) && ( now < ( radio->RxQueue[i].Time + radio->RxQueue[i].Duration ) ) )
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void OnTxDone( void *context )
+{
+  SimRadio_t *radio = ( SimRadio_t * )context;
+
+  radio->State = RF_IDLE;
+  RadioSelectOwner( radio );
+
+  if( RadioTxHandler != NULL )
+  {
+    RadioTxHandler( &radio->TxFrame );
+  }
+  if( ( radio->Events != NULL ) && ( radio->Events->TxDone != NULL ) )
+  {
+    radio->Events->TxDone( );
+  }
+}
+
+static void OnTxTimeout( void *context )
+{
+  SimRadio_t *radio = ( SimRadio_t * )context;
+
+  radio->State = RF_IDLE;
+  RadioSelectOwner( radio );
+
+  if( ( radio->Events != NULL ) && ( radio->Events->TxTimeout != NULL ) )
+  {
+    radio->Events->TxTimeout( );
+  }
+}
+
+static void OnRxDone( void *context )
+{
+  SimRadio_t *radio = ( SimRadio_t * )context;
+  SimRadioFrame_t *frame = &radio->RxQueue[radio->RxLocked];
+  uint8_t size = frame->Size;
+  int16_t rssi = frame->Rssi;
+  int8_t snr = frame->Snr;
+
+  memcpy( radio->RxBuffer, frame->Payload, size );
+  radio->RxQueueUsed[radio->RxLocked] = false;
+  radio->RxLocked = -1;
+
+  if( radio->RxSettings.RxContinuous == true )
+  {
+    /* keeps listening for the next frame */
+    radio->RxStart = SimEventGetTime( );
+    RxSchedule( radio );
+  }
+  else
+  {
+    SimEventStop( &radio->RxTimeoutEvent );
+    radio->State = RF_IDLE;
+  }
+
+  RadioSelectOwner( radio );
+  if( ( radio->Events != NULL ) && ( radio->Events->RxDone != NULL ) )
+  {
+    radio->Events->RxDone( radio->RxBuffer, size, rssi, snr );
+  }
+}
+
+static void OnRxTimeout( void *context )
+{
+  SimRadio_t *radio = ( SimRadio_t * )context;
+
+  radio->State = RF_IDLE;
+  RadioSelectOwner( radio );
+
+  if( ( radio->Events != NULL ) && ( radio->Events->RxTimeout != NULL ) )
+  {
+    radio->Events->RxTimeout( );
+  }
+}
+
+static void OnCadDone( void *context )
+{
+  SimRadio_t *radio = ( SimRadio_t * )context;
+
+  radio->State = RF_IDLE;
+  RadioSelectOwner( radio );
+
+  if( ( radio->Events != NULL ) && ( radio->Events->CadDone != NULL ) )
+  {
+    radio->Events->CadDone( RxFrameOnAir( radio, radio->Channel ) >= 0 );
+  }
+}
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,62 @@
+/**
+  ******************************************************************************
+  * @file    trace_sim.c
+  * @author  MCD Application Team
+  * @brief   Trace of the host simulation, replaces trace.c
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include "trace.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+/* Private macros ------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Functions Definition ------------------------------------------------------*/
+void TraceInit( void )
+{
+}
+
+int32_t TraceSend( const char *strFormat, ...)
+{
+  va_list vaArgs;
+
+  /* no queue, the host console is always ready */
+  va_start( vaArgs, strFormat );
+  vprintf( strFormat, vaArgs );
+  va_end( vaArgs );
+  return 0;
+}
+
+const char *TraceGetFileName( const char *fullpath )
+{
+  const char *ret = fullpath;
+
+  if( strrchr( fullpath, '\\' ) != NULL )
+  {
+    ret = strrchr( fullpath, '\\' ) + 1;
+  }
+  else if( strrchr( fullpath, '/' ) != NULL )
+  {
+    ret = strrchr( fullpath, '/' ) + 1;
+  }
+  return ret;
+}
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
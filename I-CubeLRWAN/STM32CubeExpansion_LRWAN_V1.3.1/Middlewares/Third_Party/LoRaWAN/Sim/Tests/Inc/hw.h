@@ -0,0 +1,78 @@
+/**
+  ******************************************************************************
+  * @file    hw.h
+  * @author  MCD Application Team
+  * @brief   Board layer of the host tests building the radio drivers
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HW_H__
+#define __HW_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "hw_conf.h"
+#include "hw_rtc.h"
+#include "util_console.h"
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum
+{
+  RESET = 0,
+  SET = !RESET
+} FlagStatus;
+
+typedef struct
+{
+  uint32_t Mode;
+  uint32_t Pull;
+  uint32_t Speed;
+} GPIO_InitTypeDef;
+
+/* Exported constants --------------------------------------------------------*/
+#define GPIO_MODE_OUTPUT_PP                         1
+#define GPIO_MODE_ANALOG                            3
+#define GPIO_NOPULL                                 0
+#define GPIO_SPEED_HIGH                             2
+
+#define RADIO_RESET_PORT                            NULL
+#define RADIO_RESET_PIN                             0
+#define RADIO_NSS_PORT                              NULL
+#define RADIO_NSS_PIN                               1
+
+/* Exported functions ------------------------------------------------------- */
+/*!
+ * The test implements the GPIO and SPI access of the radio, e.g. with a
+ * register array behind HW_SPI_InOut
+ */
+void HW_GPIO_Init( void *port, uint16_t pin, GPIO_InitTypeDef *initStruct );
+
+void HW_GPIO_Write( void *port, uint16_t pin, uint32_t value );
+
+uint16_t HW_SPI_InOut( uint16_t outData );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HW_H__ */
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
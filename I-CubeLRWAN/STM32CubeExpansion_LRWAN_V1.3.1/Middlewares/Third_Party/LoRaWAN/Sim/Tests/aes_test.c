@@ -0,0 +1,234 @@
+/**
+  ******************************************************************************
+  * @file    aes_test.c
+  * @author  MCD Application Team
+  * @brief   Host known-answer test and throughput of the AES backends
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+/*
+ * Built once per AES_BACKEND. Checks the backend against known answers:
+ *  - aes_set_key/aes_encrypt: FIPS-197 appendix C.1 to C.3 (128, 192 and
+ *    256-bit keys)
+ *  - AES_CMAC_*: RFC 4493 (SP 800-38B) examples 1 to 4
+ *  - SecureElementAesCtrEncrypt: a 51-byte LoRaWAN FRMPayload, with the
+ *    buffer aligned and unaligned, and SecureElementComputeAesCmac: the MIC
+ *    of a 40-byte LoRaWAN uplink. The expected values were computed with
+ *    OpenSSL from the SP 800-38A key and plaintext.
+ * then measures the CTR and CMAC throughput of the secure element over
+ * LoRaWAN frames of 1 to 255 bytes.
+ *
+ * Usage: aes_test [rounds]    rounds of 255 frames per measure, default 2000
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "aes.h"
+#include "cmac.h"
+#include "secure-element.h"
+
+/* Private define ------------------------------------------------------------*/
+#if ( AES_BACKEND == AES_BACKEND_BYTE )
+#define AES_BACKEND_NAME                            "byte"
+#elif ( AES_BACKEND == AES_BACKEND_TTABLE )
+#define AES_BACKEND_NAME                            "T-table"
+#elif ( AES_BACKEND == AES_BACKEND_BITSLICE )
+#define AES_BACKEND_NAME                            "bitsliced"
+#elif ( AES_BACKEND == AES_BACKEND_AESNI )
+#define AES_BACKEND_NAME                            "AES-NI"
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+/* SP 800-38A / RFC 4493 key and plaintext */
+static uint8_t Key[16] =
+{
+  0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C
+};
+
+static const uint8_t Plaintext[64] =
+{
+  0x6B, 0xC1, 0xBE, 0xE2, 0x2E, 0x40, 0x9F, 0x96, 0xE9, 0x3D, 0x7E, 0x11, 0x73, 0x93, 0x17, 0x2A,
+  0xAE, 0x2D, 0x8A, 0x57, 0x1E, 0x03, 0xAC, 0x9C, 0x9E, 0xB7, 0x6F, 0xAC, 0x45, 0xAF, 0x8E, 0x51,
+  0x30, 0xC8, 0x1C, 0x46, 0xA3, 0x5C, 0xE4, 0x11, 0xE5, 0xFB, 0xC1, 0x19, 0x1A, 0x0A, 0x52, 0xEF,
+  0xF6, 0x9F, 0x24, 0x45, 0xDF, 0x4F, 0x9B, 0x17, 0xAD, 0x2B, 0x41, 0x7B, 0xE6, 0x6C, 0x37, 0x10
+};
+
+/* FIPS-197 appendix C: key 000102..1F, plaintext 00112233..FF */
+static const uint8_t Fips197Ciphertext[3][16] =
+{
+  { 0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30, 0xD8, 0xCD, 0xB7, 0x80, 0x70, 0xB4, 0xC5, 0x5A },
+  { 0xDD, 0xA9, 0x7C, 0xA4, 0x86, 0x4C, 0xDF, 0xE0, 0x6E, 0xAF, 0x70, 0xA0, 0xEC, 0x0D, 0x71, 0x91 },
+  { 0x8E, 0xA2, 0xB7, 0xCA, 0x51, 0x67, 0x45, 0xBF, 0xEA, 0xFC, 0x49, 0x90, 0x4B, 0x49, 0x60, 0x89 }
+};
+
+/* RFC 4493 examples: CMAC of the first 0, 16, 40 and 64 plaintext bytes */
+static const uint8_t Rfc4493Length[4] = { 0, 16, 40, 64 };
+
+static const uint8_t Rfc4493Cmac[4][16] =
+{
+  { 0xBB, 0x1D, 0x69, 0x29, 0xE9, 0x59, 0x37, 0x28, 0x7F, 0xA3, 0x7D, 0x12, 0x9B, 0x75, 0x67, 0x46 },
+  { 0x07, 0x0A, 0x16, 0xB4, 0x6B, 0x4D, 0x41, 0x44, 0xF7, 0x9B, 0xDD, 0x9D, 0xD0, 0x4A, 0x28, 0x7C },
+  { 0xDF, 0xA6, 0x67, 0x47, 0xDE, 0x9A, 0xE6, 0x30, 0x30, 0xCA, 0x32, 0x61, 0x14, 0x97, 0xC8, 0x27 },
+  { 0x51, 0xF0, 0xBE, 0xBF, 0x7E, 0x3B, 0x9D, 0x92, 0xFC, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3C, 0xFE }
+};
+
+/* LoRaWAN uplink, DevAddr 0x26011234, FCnt 7 */
+static const uint8_t CtrABlock[16] =
+{
+  0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x34, 0x12, 0x01, 0x26, 0x07, 0x00, 0x00, 0x00, 0x00, 0x01
+};
+
+static const uint8_t CtrCiphertext[51] =
+{
+  0xB1, 0xF6, 0x1F, 0x59, 0x22, 0xB5, 0xF3, 0x69, 0xF3, 0x2C, 0x86, 0x94, 0x95, 0x1A, 0xF5, 0xA7,
+  0x43, 0xFC, 0xA2, 0xB9, 0xDE, 0x46, 0xB6, 0xAA, 0x61, 0x28, 0x66, 0xDD, 0xD8, 0x7E, 0xC2, 0x27,
+  0x5A, 0xB2, 0x53, 0x1D, 0x35, 0x33, 0x44, 0x1B, 0xEB, 0x13, 0x5F, 0x8B, 0x81, 0x2D, 0x01, 0xA9,
+  0x06, 0x7B, 0xE8
+};
+
+static const uint8_t MicB0Block[16] =
+{
+  0x49, 0x00, 0x00, 0x00, 0x00, 0x00, 0x34, 0x12, 0x01, 0x26, 0x07, 0x00, 0x00, 0x00, 0x00, 40
+};
+
+#define MIC_40                                      0xDCB63C81
+
+static uint32_t Failures = 0;
+
+/* Private functions ---------------------------------------------------------*/
+static void Check( const char *what, const uint8_t *result, const uint8_t *expected, size_t size )
+{
+  if( memcmp( result, expected, size ) != 0 )
+  {
+    printf( "%s: FAILED\n", what );
+    Failures++;
+  }
+}
+
+static void TestKnownAnswers( void )
+{
+  uint8_t key[32];
+  uint8_t block[16];
+  uint8_t out[16];
+  uint8_t frame[64 + 1];
+  uint8_t b0[16];
+  aes_context ctx;
+  AES_CMAC_CTX cmac;
+  uint32_t mic = 0;
+
+  for( uint8_t i = 0; i < 32; i++ )
+  {
+    key[i] = i;
+  }
+  for( uint8_t i = 0; i < 16; i++ )
+  {
+    block[i] = i * 0x11;
+  }
+  for( uint8_t k = 0; k < 3; k++ )
+  {
+    memset( &ctx, 0, sizeof( ctx ) );
+    aes_set_key( key, 16 + ( 8 * k ), &ctx );
+    aes_encrypt( block, out, &ctx );
+    Check( ( k == 0 ) ? "FIPS-197 C.1" : ( ( k == 1 ) ? "FIPS-197 C.2" : "FIPS-197 C.3" ), out, Fips197Ciphertext[k], 16 );
+  }
+
+  for( uint8_t n = 0; n < 4; n++ )
+  {
+    AES_CMAC_Init( &cmac );
+    AES_CMAC_SetKey( &cmac, Key );
+    AES_CMAC_Update( &cmac, Plaintext, Rfc4493Length[n] );
+    AES_CMAC_Final( out, &cmac );
+    Check( "RFC 4493", out, Rfc4493Cmac[n], 16 );
+  }
+
+  SecureElementInit( NULL );
+  SecureElementSetKey( APP_S_KEY, Key );
+  SecureElementSetKey( F_NWK_S_INT_KEY, Key );
+
+  /* aligned and unaligned payload */
+  for( uint8_t offset = 0; offset < 2; offset++ )
+  {
+    memcpy( frame + offset, Plaintext, sizeof( CtrCiphertext ) );
+    SecureElementAesCtrEncrypt( CtrABlock, frame + offset, sizeof( CtrCiphertext ), APP_S_KEY );
+    Check( ( offset == 0 ) ? "LoRaWAN CTR" : "LoRaWAN CTR, unaligned", frame + offset, CtrCiphertext,
+           sizeof( CtrCiphertext ) );
+  }
+
+  memcpy( b0, MicB0Block, sizeof( b0 ) );
+  memcpy( frame, Plaintext, 40 );
+  SecureElementComputeAesCmac( b0, frame, 40, F_NWK_S_INT_KEY, &mic );
+  if( mic != MIC_40 )
+  {
+    printf( "LoRaWAN MIC: FAILED\n" );
+    Failures++;
+  }
+}
+
+static void Benchmark( uint32_t rounds )
+{
+  uint8_t aBlock[16];
+  uint8_t frame[255];
+  uint64_t bytes = 0;
+  uint32_t mic = 0;
+  double ctrTime, cmacTime;
+  clock_t start;
+
+  memcpy( aBlock, CtrABlock, sizeof( aBlock ) );
+  memset( frame, 0xA5, sizeof( frame ) );
+
+  /* FRMPayload encryption of every frame size */
+  start = clock( );
+  for( uint32_t r = 0; r < rounds; r++ )
+  {
+    for( uint16_t len = 1; len <= 255; len++ )
+    {
+      SecureElementAesCtrEncrypt( aBlock, frame, len, APP_S_KEY );
+      bytes += len;
+    }
+  }
+  ctrTime = ( double )( clock( ) - start ) / CLOCKS_PER_SEC;
+
+  /* MIC over B0 and the frame */
+  start = clock( );
+  for( uint32_t r = 0; r < rounds; r++ )
+  {
+    for( uint16_t len = 1; len <= 255; len++ )
+    {
+      aBlock[15] = ( uint8_t )len;
+      SecureElementComputeAesCmac( aBlock, frame, len, F_NWK_S_INT_KEY, &mic );
+      frame[0] ^= ( uint8_t )mic;
+    }
+  }
+  cmacTime = ( double )( clock( ) - start ) / CLOCKS_PER_SEC;
+
+  printf( "%s: CTR %.1f MB/s, CMAC %.1f MB/s over frames of 1 to 255 bytes (%02X)\n", AES_BACKEND_NAME,
+          bytes / ctrTime / 1e6, bytes / cmacTime / 1e6, frame[0] );
+}
+
+int main( int argc, char *argv[] )
+{
+  uint32_t rounds = ( argc > 1 ) ? ( uint32_t )strtoul( argv[1], NULL, 0 ) : 2000;
+
+  TestKnownAnswers( );
+  if( Failures != 0 )
+  {
+    printf( "%s: %u known-answer tests failed\n", AES_BACKEND_NAME, ( unsigned )Failures );
+    return 1;
+  }
+  Benchmark( rounds );
+  return 0;
+}
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
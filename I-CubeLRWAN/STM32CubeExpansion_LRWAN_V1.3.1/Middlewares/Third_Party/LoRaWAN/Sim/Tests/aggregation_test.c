@@ -0,0 +1,498 @@
+/**
+  ******************************************************************************
+  * @file    aggregation_test.c
+  * @author  MCD Application Team
+  * @brief   Host test of the LmHandler uplink aggregation package
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+/*
+ * An EU868 ABP device on the simulator runs LmHandler with the compliance and
+ * the aggregation packages registered, as an application does. It queues
+ * records of random size at random times with LmhpAggregationAdd. The uplink
+ * datarate changes at the end of each phase, DR5 to DR0 included, right after
+ * a burst of records: the records pending for a large frame are split over
+ * small ones.
+ *
+ * The network decrypts the uplinks and splits the records out of them. The
+ * run passes when:
+ *  - every record queued is received once, in order, with its content
+ *  - each frame fits in the maximum payload of its datarate
+ *  - no record but the bursts waits more than the maximum delay, plus
+ *    LATENCY_MARGIN for the previous frame to complete
+ *  - the package statistics match what the network received, both flushes
+ *    (frame full and maximum delay) having been used
+ *
+ * Usage: aggregation_test [hours per phase]
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "LmHandler.h"
+#include "LmhpCompliance.h"
+#include "LmhpAggregation.h"
+#include "aes.h"
+#include "hw_rtc.h"
+#include "sim_event.h"
+#include "sim_radio.h"
+
+/* Private define ------------------------------------------------------------*/
+#define DEV_ADDR                                    0x26011234
+#define RECORD_PORT                                 10
+#define RECORD_MIN_SIZE                             2
+#define RECORD_MAX_SIZE                             24
+#define RECORD_MAX_PERIOD                           40
+#define MAX_RECORDS                                 16384
+/* maximum delay of the package [ms] */
+#define MAX_DELAY                                   60000
+/* RX windows of the previous frame and time on air at DR0 */
+#define LATENCY_MARGIN                              SIM_TIME_S( 10 )
+#define PHASES                                      4
+/* records queued at once before a datarate change, more than a DR0 frame */
+#define BURST_RECORDS                               8
+#define APP_DATA_BUFFER_MAX_SIZE                    242
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint8_t Size;
+  SimTime_t Added;
+  bool Burst;                     //!< Queued with or behind a burst, not bound by the maximum delay
+} Record_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const uint8_t Key[16] = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6,
+                                 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C };
+
+/* datarate of each phase */
+static const int8_t PhaseDatarate[PHASES] = { DR_0, DR_3, DR_5, DR_0 };
+
+/* EU868 maximum FOpts and FRMPayload size per datarate */
+static const uint8_t MaxPayload[] = { 51, 51, 51, 115, 242, 242 };
+
+static uint8_t AppDataBuffer[APP_DATA_BUFFER_MAX_SIZE];
+
+static LmHandlerParams_t HandlerParams =
+{
+  .Region = LORAMAC_REGION_EU868,
+  .AdrEnable = false,
+  .TxDatarate = DR_0,
+  .PublicNetworkEnable = true,
+  .DutyCycleEnabled = false,
+  .DataBufferMaxSize = APP_DATA_BUFFER_MAX_SIZE,
+  .DataBuffer = AppDataBuffer
+};
+
+static LmhpComplianceParams_t ComplianceParams =
+{
+  .AdrEnabled = false,
+  .DutyCycleEnabled = false,
+  .StopPeripherals = NULL,
+  .StartPeripherals = NULL,
+};
+
+static LmhpAggregationParams_t AggregationParams =
+{
+  .Port = RECORD_PORT,
+  .MsgType = LORAMAC_HANDLER_UNCONFIRMED_MSG,
+  .MaxDelay = MAX_DELAY
+};
+
+static Record_t Records[MAX_RECORDS];
+static uint32_t RecordsAdded = 0;
+static uint32_t RecordsRejected = 0;
+static uint32_t BurstRejected = 0;
+static uint32_t BurstEnd = 0;
+static SimTime_t RecordsEnd;
+static SimEvent_t RecordEvent;
+
+static uint8_t Phase = 0;
+static SimTime_t PhaseDuration = SIM_TIME_S( 6 * 3600 );
+static SimEvent_t PhaseEvent;
+
+/* network */
+static uint32_t NextRecord = 0;
+static uint32_t RecordsReceived = 0;
+static uint32_t RecordsSkipped = 0;
+static uint32_t Frames = 0;
+static uint32_t EmptyFrames = 0;
+static uint32_t BytesReceived = 0;
+static uint32_t PhaseFrames[PHASES];
+static uint32_t PhaseRecords[PHASES];
+static SimTime_t MaxLatency = 0;
+static uint32_t Failures = 0;
+
+static uint32_t RandomState = 0x3C6EF372;
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t Random( void )
+{
+  RandomState ^= RandomState << 13;
+  RandomState ^= RandomState >> 17;
+  RandomState ^= RandomState << 5;
+  return RandomState;
+}
+
+static void Fail( const char *what, uint32_t fCnt )
+{
+  if( Failures++ < 10 )
+  {
+    printf( "uplink %u: %s\n", ( unsigned )fCnt, what );
+  }
+}
+
+/* Record content: its index then bytes derived from it */
+static uint8_t RecordByte( uint32_t index, uint8_t i )
+{
+  if( i < 2 )
+  {
+    return ( uint8_t )( index >> ( 8 * i ) );
+  }
+  return ( uint8_t )( ( index * 31 ) + i );
+}
+
+static void AddRecord( bool burst )
+{
+  uint8_t record[RECORD_MAX_SIZE];
+  uint8_t size = RECORD_MIN_SIZE + ( Random( ) % ( RECORD_MAX_SIZE - RECORD_MIN_SIZE + 1 ) );
+
+  if( RecordsAdded >= MAX_RECORDS )
+  {
+    return;
+  }
+  for( uint8_t i = 0; i < size; i++ )
+  {
+    record[i] = RecordByte( RecordsAdded, i );
+  }
+  if( LmhpAggregationAdd( record, size ) == LORAMAC_HANDLER_SUCCESS )
+  {
+    Records[RecordsAdded].Size = size;
+    Records[RecordsAdded].Added = SimEventGetTime( );
+    Records[RecordsAdded].Burst = ( burst == true ) || ( BurstEnd > NextRecord );
+    RecordsAdded++;
+  }
+  else if( burst == true )
+  {
+    // The buffer may be full
+    BurstRejected++;
+  }
+  else
+  {
+    RecordsRejected++;
+  }
+}
+
+static void OnRecordEvent( void *context )
+{
+  if( SimEventGetTime( ) >= RecordsEnd )
+  {
+    return;
+  }
+  AddRecord( false );
+  SimEventStart( &RecordEvent, SimEventGetTime( ) + SIM_TIME_S( 1 + ( Random( ) % RECORD_MAX_PERIOD ) ) );
+}
+
+/*!
+ * Queues a burst of records at the datarate of the phase, then changes it
+ */
+static void OnPhaseEvent( void *context )
+{
+  for( uint8_t i = 0; i < BURST_RECORDS; i++ )
+  {
+    AddRecord( true );
+  }
+  BurstEnd = RecordsAdded;
+  if( ( Phase + 1 ) < PHASES )
+  {
+    Phase++;
+    HandlerParams.TxDatarate = PhaseDatarate[Phase];
+    SimEventStart( &PhaseEvent, SimEventGetTime( ) + PhaseDuration );
+  }
+}
+
+/*!
+ * Network: splits the records out of the frames sent by the device
+ */
+static void OnTx( const SimRadioFrame_t *frame )
+{
+  const uint8_t *p = frame->Payload;
+  uint32_t devAddr = p[1] | ( p[2] << 8 ) | ( p[3] << 16 ) | ( ( uint32_t )p[4] << 24 );
+  uint8_t fOptsLen = p[5] & 0x0F;
+  uint32_t fCnt = p[6] | ( p[7] << 8 );
+  uint8_t header = 8 + fOptsLen;
+  uint8_t datarate = 12 - frame->Datarate;
+  uint8_t payload[256];
+  uint8_t size;
+  uint8_t offset = 0;
+  aes_context aes;
+
+  if( ( frame->Size < ( header + 4 ) ) || ( devAddr != DEV_ADDR ) )
+  {
+    Fail( "not a data frame of the device", fCnt );
+    return;
+  }
+  if( frame->Size == ( header + 4 ) )
+  {
+    /* MAC commands only */
+    EmptyFrames++;
+    return;
+  }
+  size = frame->Size - header - 1 - 4;
+  if( p[header] != RECORD_PORT )
+  {
+    Fail( "not on the aggregation port", fCnt );
+    return;
+  }
+  if( ( datarate > DR_5 ) || ( ( fOptsLen + size ) > MaxPayload[datarate] ) )
+  {
+    Fail( "frame over the maximum payload of its datarate", fCnt );
+  }
+
+  /* LoRaWAN 1.0 payload decryption, uplink A blocks */
+  aes_set_key( Key, sizeof( Key ), &aes );
+  for( uint8_t i = 0; i < size; i += 16 )
+  {
+    uint8_t a[16] = { 0x01, 0, 0, 0, 0, 0 };
+    uint8_t s[16];
+
+    for( uint8_t j = 0; j < 4; j++ )
+    {
+      a[6 + j] = ( uint8_t )( devAddr >> ( 8 * j ) );
+      a[10 + j] = ( uint8_t )( fCnt >> ( 8 * j ) );
+    }
+    a[15] = ( i / 16 ) + 1;
+    aes_encrypt( a, s, &aes );
+    for( uint8_t j = 0; ( j < 16 ) && ( ( i + j ) < size ); j++ )
+    {
+      payload[i + j] = p[header + 1 + i + j] ^ s[j];
+    }
+  }
+
+  Frames++;
+  PhaseFrames[Phase]++;
+  BytesReceived += size;
+  while( offset < size )
+  {
+    uint8_t length = payload[offset];
+    const uint8_t *record = &payload[offset + 1];
+    uint32_t index;
+
+    if( ( length < RECORD_MIN_SIZE ) || ( ( offset + 1 + length ) > size ) )
+    {
+      Fail( "malformed record", fCnt );
+      return;
+    }
+    offset += 1 + length;
+
+    index = record[0] | ( record[1] << 8 );
+    if( ( index < NextRecord ) || ( index >= RecordsAdded ) )
+    {
+      Fail( "record received twice, out of order or never queued", fCnt );
+      continue;
+    }
+    RecordsSkipped += index - NextRecord;
+    NextRecord = index + 1;
+    RecordsReceived++;
+    PhaseRecords[Phase]++;
+
+    if( length != Records[index].Size )
+    {
+      Fail( "record of the wrong size", fCnt );
+      continue;
+    }
+    for( uint8_t i = 0; i < length; i++ )
+    {
+      if( record[i] != RecordByte( index, i ) )
+      {
+        Fail( "record content changed", fCnt );
+        break;
+      }
+    }
+    if( ( Records[index].Burst == false ) && ( ( frame->Time - Records[index].Added ) > MaxLatency ) )
+    {
+      MaxLatency = frame->Time - Records[index].Added;
+    }
+  }
+}
+
+static uint8_t GetBatteryLevel( void )
+{
+  return 254;
+}
+
+static uint16_t GetTemperature( void )
+{
+  return 25;
+}
+
+static void GetUniqueId( uint8_t *id )
+{
+  memset( id, 0x01, 8 );
+}
+
+static uint32_t GetRandomSeed( void )
+{
+  return 1;
+}
+
+static void OnMacProcess( void )
+{
+}
+
+static void OnNvmContextChange( LmHandlerNvmContextStates_t state )
+{
+}
+
+static void OnNetworkParametersChange( CommissioningParams_t *params )
+{
+}
+
+static void OnMacMcpsRequest( LoRaMacStatus_t status, McpsReq_t *mcpsReq )
+{
+}
+
+static void OnMacMlmeRequest( LoRaMacStatus_t status, MlmeReq_t *mlmeReq )
+{
+}
+
+static void OnJoinRequest( LmHandlerJoinParams_t *params )
+{
+}
+
+static void OnTxData( LmHandlerTxParams_t *params )
+{
+}
+
+static void OnRxData( LmHandlerAppData_t *appData, LmHandlerRxParams_t *params )
+{
+}
+
+static void OnClassChange( DeviceClass_t deviceClass )
+{
+}
+
+static void OnBeaconStatusChange( LoRaMAcHandlerBeaconParams_t *params )
+{
+}
+
+static void OnSysTimeUpdate( void )
+{
+}
+
+/*!
+ * Main loop of the device, after each event
+ */
+static void Process( void )
+{
+  LmHandlerProcess( );
+}
+
+int main( int argc, char *argv[] )
+{
+  static LmHandlerCallbacks_t callbacks =
+  {
+    .GetBatteryLevel = GetBatteryLevel,
+    .GetTemperature = GetTemperature,
+    .GetUniqueId = GetUniqueId,
+    .GetRandomSeed = GetRandomSeed,
+    .OnMacProcess = OnMacProcess,
+    .OnNvmContextChange = OnNvmContextChange,
+    .OnNetworkParametersChange = OnNetworkParametersChange,
+    .OnMacMcpsRequest = OnMacMcpsRequest,
+    .OnMacMlmeRequest = OnMacMlmeRequest,
+    .OnJoinRequest = OnJoinRequest,
+    .OnTxData = OnTxData,
+    .OnRxData = OnRxData,
+    .OnClassChange = OnClassChange,
+    .OnBeaconStatusChange = OnBeaconStatusChange,
+    .OnSysTimeUpdate = OnSysTimeUpdate
+  };
+  LmhpAggregationStats_t stats;
+
+  if( argc > 1 )
+  {
+    PhaseDuration = SIM_TIME_S( strtoul( argv[1], NULL, 0 ) * 3600 );
+  }
+
+  SimEventReset( );
+  HW_RTC_Init( );
+  SimRadioSetTxHandler( OnTx );
+  SimEventSetProcess( Process );
+
+  if( LmHandlerInit( &callbacks, &HandlerParams ) != LORAMAC_HANDLER_SUCCESS )
+  {
+    printf( "LmHandlerInit failed\n" );
+    return 1;
+  }
+  LmHandlerPackageRegister( PACKAGE_ID_COMPLIANCE, &ComplianceParams );
+  if( LmHandlerPackageRegister( PACKAGE_ID_AGGREGATION, &AggregationParams ) != LORAMAC_HANDLER_SUCCESS )
+  {
+    printf( "aggregation package not registered\n" );
+    return 1;
+  }
+  LmHandlerJoin( );
+
+  HandlerParams.TxDatarate = PhaseDatarate[0];
+  RecordsEnd = PHASES * PhaseDuration;
+  SimEventInit( &RecordEvent, OnRecordEvent, NULL );
+  SimEventStart( &RecordEvent, SIM_TIME_S( 1 ) );
+  SimEventInit( &PhaseEvent, OnPhaseEvent, NULL );
+  SimEventStart( &PhaseEvent, PhaseDuration );
+
+  /* the last records go on the maximum delay */
+  SimEventRunUntil( RecordsEnd + LATENCY_MARGIN + SIM_TIME_MS( MAX_DELAY ) );
+
+  LmhpAggregationGetStats( &stats );
+  printf( "%u records queued, %u rejected, %u received in %u frames (%u without records), %u skipped\n",
+          ( unsigned )RecordsAdded, ( unsigned )RecordsRejected, ( unsigned )RecordsReceived,
+          ( unsigned )Frames, ( unsigned )EmptyFrames, ( unsigned )RecordsSkipped );
+  for( uint8_t i = 0; i < PHASES; i++ )
+  {
+    printf( "  DR%u: %u frames, %.2f records per frame\n", PhaseDatarate[i], ( unsigned )PhaseFrames[i],
+            ( PhaseFrames[i] != 0 ) ? ( double )PhaseRecords[i] / PhaseFrames[i] : 0.0 );
+  }
+  printf( "%u records queued in bursts before the datarate changes, %u rejected on a full buffer\n",
+          ( unsigned )( ( PHASES - 1 ) * BURST_RECORDS - BurstRejected ), ( unsigned )BurstRejected );
+  printf( "%u flushes on a full frame, %u on the maximum delay, %.1f s maximum latency\n",
+          ( unsigned )stats.SizeFlushes, ( unsigned )stats.DelayFlushes, MaxLatency / 1e6 );
+
+  if( ( RecordsRejected != 0 ) || ( RecordsReceived != RecordsAdded ) || ( RecordsSkipped != 0 ) )
+  {
+    printf( "records rejected or lost\n" );
+    Failures++;
+  }
+  if( MaxLatency > ( SIM_TIME_MS( MAX_DELAY ) + LATENCY_MARGIN ) )
+  {
+    printf( "records waited over the maximum delay\n" );
+    Failures++;
+  }
+  if( ( stats.RecordsAdded != RecordsAdded ) || ( stats.RecordsDelivered != RecordsReceived ) ||
+      ( stats.FramesDelivered != Frames ) || ( stats.BytesSent != BytesReceived ) ||
+      ( stats.RecordsLost != 0 ) || ( stats.FramesLost != 0 ) )
+  {
+    printf( "statistics: %u added, %u delivered in %u frames, %u bytes, %u lost in %u frames\n",
+            ( unsigned )stats.RecordsAdded, ( unsigned )stats.RecordsDelivered, ( unsigned )stats.FramesDelivered,
+            ( unsigned )stats.BytesSent, ( unsigned )stats.RecordsLost, ( unsigned )stats.FramesLost );
+    Failures++;
+  }
+  if( ( stats.SizeFlushes == 0 ) || ( stats.DelayFlushes == 0 ) )
+  {
+    printf( "a flush trigger was not used\n" );
+    Failures++;
+  }
+
+  return ( Failures == 0 ) ? 0 : 1;
+}
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
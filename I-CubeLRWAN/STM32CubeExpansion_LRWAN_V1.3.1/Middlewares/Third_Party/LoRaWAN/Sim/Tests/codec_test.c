@@ -0,0 +1,257 @@
+/**
+  ******************************************************************************
+  * @file    codec_test.c
+  * @author  MCD Application Team
+  * @brief   Host round trip check and benchmark of the payload codec
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+/*
+ * Encodes random frames (1 to PAYLOAD_CODEC_MAX_CHANNELS channels, small
+ * values, random 32 bits values and INT32_MIN/INT32_MAX) until a reading is
+ * refused, and checks that:
+ * - a refused reading leaves the frame unchanged,
+ * - the frame fits in the maximum size,
+ * - PayloadCodec_Decode gives back the readings added,
+ * - the frame less its last byte is rejected.
+ *
+ * Then reports the bytes per reading of a slowly drifting sensor series
+ * (temperature 0.01 C, pressure 0.1 hPa, humidity 0.1 %, battery level) for
+ * the maximum payload sizes of the regions, against the 7 bytes of the fixed
+ * layout, and the encode time of a reading. The series is sent as the
+ * End_Node COMPACT_PAYLOAD mode does: a frame of a single reading goes in the
+ * fixed layout when it is not smaller, so the run fails if the frames sent take
+ * more than the fixed layout.
+ *
+ * Usage: codec_test [random frames]
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "payload_codec.h"
+
+/* Private define ------------------------------------------------------------*/
+#define FRAME_SIZE                                  256
+#define MAX_READINGS                                60
+#define SENSOR_CHANNELS                             4
+#define SENSOR_READINGS                             10000
+#define FIXED_LAYOUT_SIZE                           7
+#define ENCODE_READINGS                             20000000
+
+/* Private variables ---------------------------------------------------------*/
+/* US915 DR0 with 3 bytes of MAC commands, US915 DR0, EU868 DR0, DR3 and DR5 */
+static const uint16_t MaxPayload[] = { 8, 11, 51, 115, 222 };
+
+static uint8_t Frame[FRAME_SIZE];
+static uint8_t Saved[FRAME_SIZE];
+static int32_t Added[MAX_READINGS * PAYLOAD_CODEC_MAX_CHANNELS];
+static int32_t Decoded[MAX_READINGS * PAYLOAD_CODEC_MAX_CHANNELS];
+
+static uint32_t RandomState = 0x12345678;
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t Random( void )
+{
+  RandomState ^= RandomState << 13;
+  RandomState ^= RandomState >> 17;
+  RandomState ^= RandomState << 5;
+  return RandomState;
+}
+
+static int32_t RandomValue( void )
+{
+  switch( Random( ) % 4 )
+  {
+    case 0:
+      return ( int32_t )Random( );
+    case 1:
+      return ( ( Random( ) & 1 ) != 0 ) ? INT32_MAX : INT32_MIN;
+    default:
+      return ( int32_t )( Random( ) % 100 ) - 50;
+  }
+}
+
+static uint32_t RoundTrip( uint16_t maxSize, uint8_t nbChannels )
+{
+  payload_codec_t codec;
+  int32_t values[PAYLOAD_CODEC_MAX_CHANNELS];
+  uint16_t size;
+  uint8_t channels = 0;
+  int readings = 0;
+
+  PayloadCodec_Init( &codec, Frame, sizeof( Frame ), nbChannels );
+  while( readings < MAX_READINGS )
+  {
+    for( uint8_t i = 0; i < nbChannels; i++ )
+    {
+      values[i] = RandomValue( );
+    }
+    size = PayloadCodec_GetSize( &codec );
+    memcpy( Saved, Frame, size );
+    if( PayloadCodec_Add( &codec, values, maxSize ) != 0 )
+    {
+      if( ( PayloadCodec_GetSize( &codec ) != size ) || ( memcmp( Saved, Frame, size ) != 0 ) )
+      {
+        printf( "%u channels, max %u: refused reading changed the frame\n", nbChannels, maxSize );
+        return 1;
+      }
+      break;
+    }
+    memcpy( Added + ( readings * nbChannels ), values, nbChannels * sizeof( int32_t ) );
+    readings++;
+  }
+
+  size = PayloadCodec_GetSize( &codec );
+  if( readings == 0 )
+  {
+    return ( size == 0 ) ? 0 : 1;
+  }
+  if( size > maxSize )
+  {
+    printf( "%u channels, max %u: frame of %u bytes\n", nbChannels, maxSize, size );
+    return 1;
+  }
+  if( ( PayloadCodec_Decode( Frame, size, Decoded, MAX_READINGS * PAYLOAD_CODEC_MAX_CHANNELS, &channels ) != readings ) ||
+      ( channels != nbChannels ) ||
+      ( memcmp( Added, Decoded, readings * nbChannels * sizeof( int32_t ) ) != 0 ) )
+  {
+    printf( "%u channels, max %u: %d readings not decoded back\n", nbChannels, maxSize, readings );
+    return 1;
+  }
+  if( PayloadCodec_Decode( Frame, size - 1, Decoded, MAX_READINGS * PAYLOAD_CODEC_MAX_CHANNELS, NULL ) != -1 )
+  {
+    printf( "%u channels, max %u: truncated frame decoded\n", nbChannels, maxSize );
+    return 1;
+  }
+  return 0;
+}
+
+/* readings of a slowly drifting sensor, fixed point */
+static void SensorReading( int32_t *values, uint32_t k )
+{
+  values[0] += ( int32_t )( Random( ) % 5 ) - 2;
+  values[1] += ( int32_t )( Random( ) % 3 ) - 1;
+  values[2] += ( int32_t )( Random( ) % 5 ) - 2;
+  values[3] = 254 - ( int32_t )( k / 2000 );
+}
+
+/* size of the frame as End_Node sends it, in the fixed layout when smaller */
+static uint16_t SentSize( const payload_codec_t *codec )
+{
+  uint16_t size = PayloadCodec_GetSize( codec );
+
+  if( ( codec->nb_readings == 1 ) && ( size >= FIXED_LAYOUT_SIZE ) )
+  {
+    return FIXED_LAYOUT_SIZE;
+  }
+  return size;
+}
+
+static uint32_t SensorSeries( uint16_t maxSize )
+{
+  payload_codec_t codec;
+  int32_t values[SENSOR_CHANNELS] = { 2150, 10132, 455, 254 };
+  uint32_t bytes = 0;
+  uint32_t frames = 0;
+  uint32_t fixed = 0;
+
+  PayloadCodec_Init( &codec, Frame, sizeof( Frame ), SENSOR_CHANNELS );
+  for( uint32_t k = 0; k < SENSOR_READINGS; k++ )
+  {
+    SensorReading( values, k );
+    if( PayloadCodec_Add( &codec, values, maxSize ) == 0 )
+    {
+      continue;
+    }
+    if( PayloadCodec_GetSize( &codec ) != 0 )
+    {
+      /* send the frame, the reading starts the next one */
+      fixed += ( SentSize( &codec ) == FIXED_LAYOUT_SIZE ) ? 1 : 0;
+      bytes += SentSize( &codec );
+      frames++;
+      PayloadCodec_Init( &codec, Frame, sizeof( Frame ), SENSOR_CHANNELS );
+      if( PayloadCodec_Add( &codec, values, maxSize ) == 0 )
+      {
+        continue;
+      }
+    }
+    /* the reading alone only fits in the fixed layout */
+    PayloadCodec_Add( &codec, values, sizeof( Frame ) );
+  }
+  if( PayloadCodec_GetSize( &codec ) != 0 )
+  {
+    fixed += ( SentSize( &codec ) == FIXED_LAYOUT_SIZE ) ? 1 : 0;
+    bytes += SentSize( &codec );
+    frames++;
+  }
+
+  printf( "%5u  %13.2f  %16.1f  %12.1f%%\n", maxSize, ( double )bytes / SENSOR_READINGS,
+          ( double )SENSOR_READINGS / frames, fixed * 100.0 / frames );
+  if( bytes > ( SENSOR_READINGS * FIXED_LAYOUT_SIZE ) )
+  {
+    printf( "max %u: frames larger than the fixed layout\n", maxSize );
+    return 1;
+  }
+  return 0;
+}
+
+static double EncodeTime( void )
+{
+  payload_codec_t codec;
+  int32_t values[SENSOR_CHANNELS] = { 2150, 10132, 455, 254 };
+  volatile uint32_t sink = 0;
+  clock_t start = clock( );
+
+  PayloadCodec_Init( &codec, Frame, sizeof( Frame ), SENSOR_CHANNELS );
+  for( uint32_t k = 0; k < ENCODE_READINGS; k++ )
+  {
+    values[0] += ( int32_t )( k & 3 ) - 1;
+    if( PayloadCodec_Add( &codec, values, 222 ) != 0 )
+    {
+      PayloadCodec_Init( &codec, Frame, sizeof( Frame ), SENSOR_CHANNELS );
+    }
+    sink += codec.size;
+  }
+  return ( double )( clock( ) - start ) / CLOCKS_PER_SEC * 1e9 / ENCODE_READINGS;
+}
+
+int main( int argc, char *argv[] )
+{
+  uint32_t frames = ( argc > 1 ) ? ( uint32_t )strtoul( argv[1], NULL, 0 ) : 200000;
+  uint32_t failures = 0;
+
+  for( uint32_t f = 0; f < frames; f++ )
+  {
+    uint16_t maxSize = PAYLOAD_CODEC_HEADER_SIZE + ( Random( ) % 240 );
+    uint8_t nbChannels = 1 + ( Random( ) % PAYLOAD_CODEC_MAX_CHANNELS );
+
+    failures += RoundTrip( maxSize, nbChannels );
+  }
+  printf( "%u random frames: %u failures\n", ( unsigned )frames, ( unsigned )failures );
+
+  printf( "%u readings of %u channels, %u bytes per reading in the fixed layout\n", SENSOR_READINGS,
+          SENSOR_CHANNELS, FIXED_LAYOUT_SIZE );
+  printf( "  max  bytes/reading  readings/frame  fixed layout\n" );
+  for( uint8_t m = 0; m < sizeof( MaxPayload ) / sizeof( MaxPayload[0] ); m++ )
+  {
+    failures += SensorSeries( MaxPayload[m] );
+  }
+
+  printf( "encode %.1f ns per reading of %u channels\n", EncodeTime( ), SENSOR_CHANNELS );
+
+  return ( failures == 0 ) ? 0 : 1;
+}
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,227 @@
+/**
+  ******************************************************************************
+  * @file    frag_bench.c
+  * @author  MCD Application Team
+  * @brief   Host benchmark of the fragmentation decoder against the loss rate
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+/*
+ * Encodes a random file as in the LoRaWAN Fragmented Data Block Transport
+ * specification (uncoded fragments, then coded fragments from the PRBS23
+ * parity matrix), drops fragments at random and feeds the others to
+ * FragDecoderProcess, with the file in RAM behind the callbacks.
+ *
+ * For each loss rate it reports the decode time of a session (FragDecoderInit
+ * and all the FragDecoderProcess calls) and checks the rebuilt file. The run
+ * fails if a session completes with a wrong file, or fails to complete with
+ * fewer lost fragments than coded ones received.
+ *
+ * Build with FRAG_MAX_NB, FRAG_MAX_SIZE and FRAG_MAX_REDUNDANCY large enough
+ * for the session, see the Makefile.
+ *
+ * Usage: frag_bench [fragments] [fragment size] [sessions per loss rate]
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "FragDecoder.h"
+
+/* Private define ------------------------------------------------------------*/
+/* coded fragments sent, per 100 expected losses, and the extra ones */
+#define CODED_MARGIN_PERCENT                        140
+#define CODED_MARGIN_MIN                            20
+
+/* Private variables ---------------------------------------------------------*/
+static const uint8_t LossPercent[] = { 0, 1, 2, 5, 10, 15, 20 };
+
+static uint8_t Source[FRAG_MAX_NB * FRAG_MAX_SIZE];
+static uint8_t File[FRAG_MAX_NB * FRAG_MAX_SIZE];
+static uint8_t Row[FRAG_MAX_NB];
+
+static uint32_t RandomState = 0x12345678;
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t Random( void )
+{
+  RandomState ^= RandomState << 13;
+  RandomState ^= RandomState >> 17;
+  RandomState ^= RandomState << 5;
+  return RandomState;
+}
+
+static uint8_t FileWrite( uint32_t addr, uint8_t *data, uint32_t size )
+{
+  memcpy( File + addr, data, size );
+  return 0;
+}
+
+static uint8_t FileRead( uint32_t addr, uint8_t *data, uint32_t size )
+{
+  memcpy( data, File + addr, size );
+  return 0;
+}
+
+/*
+ * Encoder side, written from the specification: row n of the parity matrix
+ * for m fragments, one byte per coefficient
+ */
+static void ParityMatrixRow( int32_t n, int32_t m, uint8_t *row )
+{
+  int32_t mTemp = ( ( m & ( m - 1 ) ) == 0 ) ? 1 : 0;
+  int32_t x = 1 + ( 1001 * n );
+  int32_t nbCoeff = 0;
+  int32_t r;
+
+  memset( row, 0, m );
+  while( nbCoeff < ( m >> 1 ) )
+  {
+    r = 1 << 16;
+    while( r >= m )
+    {
+      /* PRBS23 */
+      x = ( x >> 1 ) + ( ( ( x & 0x01 ) ^ ( ( x & 0x20 ) >> 5 ) ) << 22 );
+      r = x % ( m + mTemp );
+    }
+    row[r] = 1;
+    nbCoeff++;
+  }
+}
+
+static void CodedFragment( uint16_t n, uint16_t fragNb, uint8_t fragSize, uint8_t *fragment )
+{
+  ParityMatrixRow( n, fragNb, Row );
+  memset( fragment, 0, fragSize );
+  for( uint16_t i = 0; i < fragNb; i++ )
+  {
+    if( Row[i] != 0 )
+    {
+      for( uint8_t b = 0; b < fragSize; b++ )
+      {
+        fragment[b] ^= Source[( i * fragSize ) + b];
+      }
+    }
+  }
+}
+
+int main( int argc, char *argv[] )
+{
+  static FragDecoderCallbacks_t callbacks = { FileWrite, FileRead };
+  uint16_t fragNb = ( argc > 1 ) ? ( uint16_t )strtoul( argv[1], NULL, 0 ) : 2000;
+  uint8_t fragSize = ( argc > 2 ) ? ( uint8_t )strtoul( argv[2], NULL, 0 ) : 50;
+  uint32_t sessions = ( argc > 3 ) ? ( uint32_t )strtoul( argv[3], NULL, 0 ) : 5;
+  uint8_t fragment[FRAG_MAX_SIZE];
+  uint32_t failures = 0;
+
+  if( ( fragNb == 0 ) || ( fragNb > FRAG_MAX_NB ) || ( fragSize == 0 ) || ( fragSize > FRAG_MAX_SIZE ) )
+  {
+    printf( "at most %u fragments of %u bytes\n", FRAG_MAX_NB, FRAG_MAX_SIZE );
+    return 1;
+  }
+
+  printf( "%u fragments of %u bytes, %u coded fragments at most, %u sessions per loss rate\n", fragNb, fragSize,
+          FRAG_MAX_REDUNDANCY, ( unsigned )sessions );
+  printf( "loss  lost  coded rx  decode ms  rebuilt\n" );
+
+  for( uint8_t l = 0; l < sizeof( LossPercent ); l++ )
+  {
+    uint32_t coded = ( ( fragNb * LossPercent[l] * CODED_MARGIN_PERCENT ) / 10000 ) + CODED_MARGIN_MIN;
+    uint32_t lostTotal = 0;
+    uint32_t codedRxTotal = 0;
+    uint32_t rebuilt = 0;
+    double seconds = 0;
+
+    if( coded > FRAG_MAX_REDUNDANCY )
+    {
+      coded = FRAG_MAX_REDUNDANCY;
+    }
+
+    for( uint32_t s = 0; s < sessions; s++ )
+    {
+      uint32_t lost = 0;
+      uint32_t codedRx = 0;
+      int32_t status = FRAG_SESSION_ONGOING;
+      clock_t start;
+
+      for( uint32_t i = 0; i < ( uint32_t )fragNb * fragSize; i++ )
+      {
+        Source[i] = ( uint8_t )Random( );
+      }
+      memset( File, 0, sizeof( File ) );
+
+      start = clock( );
+      FragDecoderInit( fragNb, fragSize, &callbacks );
+      seconds += ( double )( clock( ) - start ) / CLOCKS_PER_SEC;
+
+      for( uint32_t counter = 1; ( counter <= fragNb + coded ) && ( status == FRAG_SESSION_ONGOING ); counter++ )
+      {
+        if( counter <= fragNb )
+        {
+          memcpy( fragment, Source + ( ( counter - 1 ) * fragSize ), fragSize );
+        }
+        else
+        {
+          CodedFragment( counter - fragNb, fragNb, fragSize, fragment );
+        }
+        if( ( Random( ) % 10000 ) < ( LossPercent[l] * 100u ) )
+        {
+          lost += ( counter <= fragNb ) ? 1 : 0;
+          continue;
+        }
+        codedRx += ( counter > fragNb ) ? 1 : 0;
+
+        start = clock( );
+        status = FragDecoderProcess( counter, fragment );
+        seconds += ( double )( clock( ) - start ) / CLOCKS_PER_SEC;
+      }
+
+      lostTotal += lost;
+      codedRxTotal += codedRx;
+      /* a completed session returns the number of lost fragments */
+      if( status >= FRAG_SESSION_FINISHED )
+      {
+        if( FragDecoderGetStatus( ).MatrixError != 0 )
+        {
+          printf( "session with %u lost fragments: matrix error\n", ( unsigned )lost );
+          failures++;
+        }
+        else if( memcmp( File, Source, ( uint32_t )fragNb * fragSize ) != 0 )
+        {
+          printf( "session with %u lost fragments: wrong file\n", ( unsigned )lost );
+          failures++;
+        }
+        else
+        {
+          rebuilt++;
+        }
+      }
+      else if( ( lost == 0 ) || ( ( lost + CODED_MARGIN_MIN ) <= codedRx ) )
+      {
+        /* enough coded fragments for the spec matrix, the session must end */
+        printf( "session with %u lost fragments not completed after %u coded ones\n", ( unsigned )lost,
+                ( unsigned )codedRx );
+        failures++;
+      }
+    }
+
+    printf( "%3u%%  %4u  %8u  %9.2f  %u/%u\n", LossPercent[l], ( unsigned )( lostTotal / sessions ),
+            ( unsigned )( codedRxTotal / sessions ), seconds * 1000 / sessions, ( unsigned )rebuilt,
+            ( unsigned )sessions );
+  }
+
+  return ( failures == 0 ) ? 0 : 1;
+}
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,513 @@
+/**
+  ******************************************************************************
+  * @file    nvm_test.c
+  * @author  MCD Application Team
+  * @brief   Host test of the context journal of Patterns/Advanced/NvmCtxMgmt.c
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+/*
+ * Implements NvmCtxMgmtPageRead/Write/Erase over RAM pages behaving as flash:
+ * a write must be aligned on NVM_CTX_JOURNAL_WRITE_SIZE and target erased
+ * bytes. An EU868 ABP device on the simulator stores its contexts after each
+ * uplink, then:
+ *  - reports the bytes written per uplink against a full rewrite of the
+ *    changed contexts, and the erases of each page, which must not differ by
+ *    more than one (round-robin wear)
+ *  - reboots and checks the contexts are restored as stored
+ *  - cuts the power at a random byte of a store, of a record or of a page
+ *    erase, reboots and checks the contexts are restored either as before the
+ *    store or as after it, and that the device carries on storing
+ *
+ * NvmCtxMgmt.c is included so that a reboot can clear its RAM state as a
+ * reset does. The CMAC scratch context of the secure element context is not
+ * compared: the MAC overwrites it before each use.
+ *
+ * Usage: nvm_test [uplinks] [power cuts]
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "LoRaMac.h"
+#include "hw_rtc.h"
+#include "sim_event.h"
+#include "secure-element.h"
+#include "cmac.h"
+#include "NvmCtxMgmt.c"
+
+/* Private define ------------------------------------------------------------*/
+#define DEV_ADDR                                    0x26011234
+#define UPLINK_SIZE                                 10
+
+/* power always on */
+#define POWER_ON                                    -1
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t Pages[NVM_CTX_JOURNAL_PAGES][NVM_CTX_JOURNAL_PAGE_SIZE];
+
+/* bytes programmed, or pages erased, before the power cut */
+static int32_t PowerBudget = POWER_ON;
+static bool PowerCut = false;
+static bool PowerCutInErase = false;
+
+static uint32_t WrittenBytes = 0;
+static uint32_t Erases[NVM_CTX_JOURNAL_PAGES];
+static uint32_t FlashErrors = 0;
+
+static uint32_t Confirms = 0;
+static uint32_t RandomState = 0x2545F491;
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t Random( void )
+{
+  RandomState ^= RandomState << 13;
+  RandomState ^= RandomState >> 17;
+  RandomState ^= RandomState << 5;
+  return RandomState;
+}
+
+static void FlashError( const char *what, uint8_t page, uint32_t offset )
+{
+  if( FlashErrors++ == 0 )
+  {
+    printf( "%s at page %u offset %u\n", what, page, ( unsigned )offset );
+  }
+}
+
+/* Returns false when the power is cut */
+static bool PowerStep( void )
+{
+  if( PowerBudget == 0 )
+  {
+    PowerCut = true;
+    return false;
+  }
+  if( PowerBudget > 0 )
+  {
+    PowerBudget--;
+  }
+  return true;
+}
+
+NvmCtxMgmtStatus_t NvmCtxMgmtPageRead( uint8_t page, uint32_t offset, uint8_t* buffer, uint16_t size )
+{
+  if( ( page >= NVM_CTX_JOURNAL_PAGES ) || ( ( offset + size ) > NVM_CTX_JOURNAL_PAGE_SIZE ) )
+  {
+    FlashError( "read out of the journal", page, offset );
+    return NVMCTXMGMT_STATUS_FAIL;
+  }
+  memcpy( buffer, &Pages[page][offset], size );
+  return NVMCTXMGMT_STATUS_SUCCESS;
+}
+
+NvmCtxMgmtStatus_t NvmCtxMgmtPageWrite( uint8_t page, uint32_t offset, const uint8_t* buffer, uint16_t size )
+{
+  if( ( page >= NVM_CTX_JOURNAL_PAGES ) || ( ( offset + size ) > NVM_CTX_JOURNAL_PAGE_SIZE ) ||
+      ( ( offset % NVM_CTX_JOURNAL_WRITE_SIZE ) != 0 ) || ( ( size % NVM_CTX_JOURNAL_WRITE_SIZE ) != 0 ) )
+  {
+    FlashError( "unaligned write", page, offset );
+    return NVMCTXMGMT_STATUS_FAIL;
+  }
+  if( PowerCut == true )
+  {
+    return NVMCTXMGMT_STATUS_FAIL;
+  }
+  for( uint16_t i = 0; i < size; i++ )
+  {
+    if( Pages[page][offset + i] != NVM_CTX_JOURNAL_ERASED_VALUE )
+    {
+      FlashError( "write to programmed memory", page, offset + i );
+      return NVMCTXMGMT_STATUS_FAIL;
+    }
+  }
+  for( uint16_t i = 0; i < size; i++ )
+  {
+    if( PowerStep( ) == false )
+    {
+      /* the byte being programmed is left with random bits cleared */
+      Pages[page][offset + i] &= ( uint8_t )Random( );
+      return NVMCTXMGMT_STATUS_FAIL;
+    }
+    Pages[page][offset + i] = buffer[i];
+    WrittenBytes++;
+  }
+  return NVMCTXMGMT_STATUS_SUCCESS;
+}
+
+NvmCtxMgmtStatus_t NvmCtxMgmtPageErase( uint8_t page )
+{
+  if( page >= NVM_CTX_JOURNAL_PAGES )
+  {
+    FlashError( "erase out of the journal", page, 0 );
+    return NVMCTXMGMT_STATUS_FAIL;
+  }
+  if( PowerCut == true )
+  {
+    return NVMCTXMGMT_STATUS_FAIL;
+  }
+  if( PowerStep( ) == false )
+  {
+    /* an interrupted erase leaves part of the page as it was */
+    uint32_t start = Random( ) % NVM_CTX_JOURNAL_PAGE_SIZE;
+    uint32_t size = Random( ) % ( NVM_CTX_JOURNAL_PAGE_SIZE - start );
+
+    memset( &Pages[page][start], NVM_CTX_JOURNAL_ERASED_VALUE, size );
+    PowerCutInErase = true;
+    return NVMCTXMGMT_STATUS_FAIL;
+  }
+  memset( Pages[page], NVM_CTX_JOURNAL_ERASED_VALUE, NVM_CTX_JOURNAL_PAGE_SIZE );
+  Erases[page]++;
+  return NVMCTXMGMT_STATUS_SUCCESS;
+}
+
+static void McpsConfirm( McpsConfirm_t *mcpsConfirm )
+{
+  ( void )mcpsConfirm;
+  Confirms++;
+}
+
+static void McpsIndication( McpsIndication_t *mcpsIndication )
+{
+  ( void )mcpsIndication;
+}
+
+static void MlmeConfirm( MlmeConfirm_t *mlmeConfirm )
+{
+  ( void )mlmeConfirm;
+}
+
+static void MlmeIndication( MlmeIndication_t *mlmeIndication )
+{
+  ( void )mlmeIndication;
+}
+
+static void Process( void )
+{
+  LoRaMacProcess( );
+}
+
+static uint8_t GetBatteryLevel( void )
+{
+  return 254;
+}
+
+static uint16_t GetTemperatureLevel( void )
+{
+  return 25;
+}
+
+static LoRaMacCtxs_t *GetContexts( void )
+{
+  MibRequestConfirm_t mibReq;
+
+  mibReq.Type = MIB_NVM_CTXS;
+  LoRaMacMibGetRequestConfirm( &mibReq );
+  return mibReq.Param.Contexts;
+}
+
+/* Copies the stored contexts, returns their size */
+static uint32_t CopyContexts( uint8_t *copy )
+{
+  LoRaMacCtxs_t *contexts = GetContexts( );
+  uint32_t offset = 0;
+  uint8_t *ctx;
+  size_t size;
+
+  for( uint8_t module = 0; module < NVM_CTX_MODULES; module++ )
+  {
+    if( ( ( NVM_CTX_STORAGE_MASK >> module ) & 0x01 ) == 0 )
+    {
+      continue;
+    }
+    ctx = GetModuleCtx( contexts, module, &size );
+    if( ctx == NULL )
+    {
+      continue;
+    }
+    memcpy( &copy[offset], ctx, size );
+    if( module == LORAMAC_NVMCTXMODULE_SECURE_ELEMENT )
+    {
+      memset( &copy[offset + ( 2 * SE_EUI_SIZE )], 0, sizeof( AES_CMAC_CTX ) );
+    }
+    offset += size;
+  }
+  return offset;
+}
+
+/* Size of a full rewrite of the changed contexts */
+static uint32_t ChangedContextsSize( void )
+{
+  LoRaMacCtxs_t *contexts = GetContexts( );
+  uint32_t total = 0;
+  size_t size;
+
+  for( uint8_t module = 0; module < NVM_CTX_MODULES; module++ )
+  {
+    if( ( ( ( CtxUpdateStatus.Value & NVM_CTX_STORAGE_MASK ) >> module ) & 0x01 ) != 0 )
+    {
+      if( GetModuleCtx( contexts, module, &size ) != NULL )
+      {
+        total += size;
+      }
+    }
+  }
+  return total;
+}
+
+/* Powers the device up, returns the status of the restore */
+static NvmCtxMgmtStatus_t Boot( void )
+{
+  static LoRaMacPrimitives_t primitives = { McpsConfirm, McpsIndication, MlmeConfirm, MlmeIndication };
+  static LoRaMacCallback_t callbacks = { GetBatteryLevel, GetTemperatureLevel, NvmCtxMgmtEvent, NULL };
+  NvmCtxMgmtStatus_t status;
+  MibRequestConfirm_t mibReq;
+
+  /* RAM state of NvmCtxMgmt.c lost by the reset */
+  memset( &Journal, 0, sizeof( Journal ) );
+  Journal.Page = NVM_CTX_JOURNAL_PAGES;
+  memset( Shadow, 0, sizeof( Shadow ) );
+  CtxUpdateStatus.Value = 0;
+  PowerBudget = POWER_ON;
+  PowerCut = false;
+  PowerCutInErase = false;
+
+  SimEventReset( );
+  HW_RTC_Init( );
+  SimEventSetProcess( Process );
+  if( LoRaMacInitialization( &primitives, &callbacks, LORAMAC_REGION_EU868 ) != LORAMAC_STATUS_OK )
+  {
+    printf( "LoRaMacInitialization failed\n" );
+    exit( 1 );
+  }
+
+  status = NvmCtxMgmtRestore( );
+
+  /* the MAC context is only stored with MAX_PERSISTENT_CTX_MGMT_ENABLED */
+  mibReq.Type = MIB_NETWORK_ACTIVATION;
+  mibReq.Param.NetworkActivation = ACTIVATION_TYPE_ABP;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+  mibReq.Type = MIB_DEV_ADDR;
+  mibReq.Param.DevAddr = DEV_ADDR;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+  mibReq.Type = MIB_ADR;
+  mibReq.Param.AdrEnable = false;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+  LoRaMacStart( );
+  return status;
+}
+
+static void Uplink( void )
+{
+  uint8_t payload[UPLINK_SIZE] = { 0 };
+  uint32_t confirms = Confirms;
+  LoRaMacStatus_t status;
+  McpsReq_t mcpsReq;
+
+  mcpsReq.Type = MCPS_UNCONFIRMED;
+  mcpsReq.Req.Unconfirmed.fPort = 2;
+  mcpsReq.Req.Unconfirmed.fBuffer = payload;
+  mcpsReq.Req.Unconfirmed.fBufferSize = sizeof( payload );
+  mcpsReq.Req.Unconfirmed.Datarate = DR_5;
+
+  while( ( status = LoRaMacMcpsRequest( &mcpsReq ) ) != LORAMAC_STATUS_OK )
+  {
+    if( ( status != LORAMAC_STATUS_DUTYCYCLE_RESTRICTED ) && ( status != LORAMAC_STATUS_BUSY ) )
+    {
+      printf( "LoRaMacMcpsRequest failed (%d)\n", status );
+      exit( 1 );
+    }
+    if( SimEventRunNext( ) == false )
+    {
+      SimEventRunUntil( SimEventGetTime( ) + SIM_TIME_S( 1 ) );
+    }
+  }
+  while( Confirms == confirms )
+  {
+    if( SimEventRunNext( ) == false )
+    {
+      printf( "no confirm, the simulation stalled\n" );
+      exit( 1 );
+    }
+  }
+}
+
+/*
+ * Stores the contexts once the MAC is idle, as the application does. The
+ * region does not signal the changes of the band timings: with all set, every
+ * stored context is compared with the shadow, and the restored contexts can be
+ * checked against the RAM ones.
+ */
+static NvmCtxMgmtStatus_t Store( bool all )
+{
+  while( LoRaMacStop( ) != LORAMAC_STATUS_OK )
+  {
+    SimEventRunNext( );
+  }
+  LoRaMacStart( );
+  if( all == true )
+  {
+    CtxUpdateStatus.Value = 0xFF;
+  }
+  return NvmCtxMgmtStore( );
+}
+
+int main( int argc, char *argv[] )
+{
+  static uint8_t before[NVM_CTX_SHADOW_SIZE];
+  static uint8_t after[NVM_CTX_SHADOW_SIZE];
+  static uint8_t restored[NVM_CTX_SHADOW_SIZE];
+  uint32_t uplinks = ( argc > 1 ) ? ( uint32_t )strtoul( argv[1], NULL, 0 ) : 2000;
+  uint32_t cuts = ( argc > 2 ) ? ( uint32_t )strtoul( argv[2], NULL, 0 ) : 3000;
+  uint32_t fullBytes = 0;
+  uint32_t minErases = UINT32_MAX;
+  uint32_t maxErases = 0;
+  uint32_t size;
+  uint32_t failures = 0;
+  uint32_t restoredBefore = 0;
+  uint32_t restoredAfter = 0;
+  uint32_t cutsInStore = 0;
+  uint32_t cutsInCompaction = 0;
+  uint32_t cutsInErase = 0;
+
+  memset( Pages, NVM_CTX_JOURNAL_ERASED_VALUE, sizeof( Pages ) );
+  if( Boot( ) == NVMCTXMGMT_STATUS_SUCCESS )
+  {
+    printf( "restore succeeded from a blank journal\n" );
+    failures++;
+  }
+
+  /* stores after each uplink */
+  WrittenBytes = 0;
+  memset( Erases, 0, sizeof( Erases ) );
+  for( uint32_t i = 0; i < uplinks; i++ )
+  {
+    Uplink( );
+    fullBytes += ChangedContextsSize( );
+    if( Store( false ) != NVMCTXMGMT_STATUS_SUCCESS )
+    {
+      printf( "uplink %u: store failed\n", ( unsigned )i );
+      failures++;
+    }
+  }
+  for( uint8_t page = 0; page < NVM_CTX_JOURNAL_PAGES; page++ )
+  {
+    minErases = ( Erases[page] < minErases ) ? Erases[page] : minErases;
+    maxErases = ( Erases[page] > maxErases ) ? Erases[page] : maxErases;
+  }
+  printf( "%u uplinks: %.1f bytes written per uplink, %.1f for a full rewrite, %u to %u erases per page\n",
+          ( unsigned )uplinks, ( double )WrittenBytes / uplinks, ( double )fullBytes / uplinks,
+          ( unsigned )minErases, ( unsigned )maxErases );
+  if( ( maxErases - minErases ) > 1 )
+  {
+    printf( "uneven page wear\n" );
+    failures++;
+  }
+
+  /* reboot */
+  Store( true );
+  size = CopyContexts( before );
+  if( ( Boot( ) != NVMCTXMGMT_STATUS_SUCCESS ) || ( CopyContexts( restored ) != size ) ||
+      ( memcmp( restored, before, size ) != 0 ) )
+  {
+    printf( "reboot: contexts not restored as stored\n" );
+    failures++;
+  }
+
+  /* power cuts during a store */
+  for( uint32_t cut = 0; cut < cuts; cut++ )
+  {
+    uint32_t stores = 1 + ( Random( ) % 40 );
+    uint32_t erases = Erases[0];
+
+    for( uint32_t i = 0; i < stores; i++ )
+    {
+      Uplink( );
+      Store( true );
+    }
+    CopyContexts( before );
+    Uplink( );
+    CopyContexts( after );
+
+    for( uint8_t page = 1; page < NVM_CTX_JOURNAL_PAGES; page++ )
+    {
+      erases += Erases[page];
+    }
+    switch( cut % 4 )
+    {
+      case 0:
+        /* within the bytes of a few records */
+        PowerBudget = Random( ) % 24;
+        break;
+      case 1:
+        PowerBudget = Random( ) % NVM_CTX_JOURNAL_PAGE_SIZE;
+        break;
+      default:
+        /* active page full: the store rotates to the next page, the power is
+           cut in the erase or in the snapshot */
+        Journal.WriteOffset = NVM_CTX_JOURNAL_PAGE_SIZE;
+        PowerBudget = ( ( cut % 4 ) == 2 ) ? 0 : ( Random( ) % NVM_CTX_SHADOW_SIZE );
+        break;
+    }
+    Store( true );
+    if( PowerCut == true )
+    {
+      cutsInStore++;
+      cutsInErase += ( PowerCutInErase == true ) ? 1 : 0;
+      for( uint8_t page = 0; page < NVM_CTX_JOURNAL_PAGES; page++ )
+      {
+        erases -= Erases[page];
+      }
+      cutsInCompaction += ( ( erases != 0 ) || ( PowerCutInErase == true ) ) ? 1 : 0;
+    }
+
+    if( Boot( ) != NVMCTXMGMT_STATUS_SUCCESS )
+    {
+      printf( "power cut %u: restore failed\n", ( unsigned )cut );
+      failures++;
+      break;
+    }
+    CopyContexts( restored );
+    if( memcmp( restored, after, size ) == 0 )
+    {
+      restoredAfter++;
+    }
+    else if( memcmp( restored, before, size ) == 0 )
+    {
+      restoredBefore++;
+    }
+    else
+    {
+      printf( "power cut %u: contexts restored neither as before nor as after the store\n", ( unsigned )cut );
+      failures++;
+      break;
+    }
+  }
+  printf( "%u power cuts, %u during a store (%u in a page rotation, %u in an erase): %u restored as after the store,"
+          " %u as before\n", ( unsigned )cuts, ( unsigned )cutsInStore, ( unsigned )cutsInCompaction,
+          ( unsigned )cutsInErase, ( unsigned )restoredAfter, ( unsigned )restoredBefore );
+  if( ( cuts > 0 ) && ( ( cutsInCompaction == 0 ) || ( cutsInErase == 0 ) ) )
+  {
+    printf( "no power cut during a page rotation, increase the power cuts\n" );
+    failures++;
+  }
+  if( FlashErrors != 0 )
+  {
+    printf( "%u flash errors\n", ( unsigned )FlashErrors );
+    failures++;
+  }
+
+  return ( failures == 0 ) ? 0 : 1;
+}
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,482 @@
+/**
+  ******************************************************************************
+  * @file    rxpool_test.c
+  * @author  MCD Application Team
+  * @brief   Host test of the reception buffer pool of LoRaMac.c
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+/*
+ * An EU868 ABP class C device on the simulator receives unconfirmed downlinks
+ * on port 2 with the default pool of 2 buffers. Each indication is checked
+ * against the payload sent, in order and without loss, and:
+ *  - in place: the downlinks are indicated in the pool buffer the radio
+ *    received them in, right after their header
+ *  - retain: with a buffer retained, the next downlink is still indicated in
+ *    place, but retaining it returns LORAMAC_STATUS_BUSY as the radio needs
+ *    the last buffer
+ *  - exhausted pool: a downlink received while the frame of the only free
+ *    buffer is processed goes to the buffer of the radio driver, the next one
+ *    is back in place, and the retained buffer is usable again once released
+ *  - back to back: the next downlink is received while ProcessRadioRxDone
+ *    handles the previous one, without overwriting it
+ *
+ * LoRaMac.c is included to check the state of the pool. The test raises the
+ * RxDone interrupt of the next downlink where a radio interrupt may preempt
+ * ProcessRadioRxDone: at the end of the critical section taking the frame,
+ * before Radio.Sleep. The main loop is held while the simulated time runs to
+ * the end of the next downlink.
+ *
+ * Usage: rxpool_test [downlinks]
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utilities.h"
+
+static void OnCriticalSectionEnd( const char *function );
+
+#undef CRITICAL_SECTION_END
+#define CRITICAL_SECTION_END( )   do { __set_PRIMASK( primask_bit ); OnCriticalSectionEnd( __func__ ); } while( 0 )
+
+#include "LoRaMac.c"
+#include "aes.h"
+#include "cmac.h"
+#include "hw_rtc.h"
+#include "sim_event.h"
+#include "sim_radio.h"
+
+#if ( LORAMAC_RX_POOL_SIZE != 2 )
+#error "rxpool_test expects the default LORAMAC_RX_POOL_SIZE"
+#endif
+
+/* Private define ------------------------------------------------------------*/
+#define DEV_ADDR                                    0x26011234
+#define DOWNLINK_PORT                               2
+#define DOWNLINK_SIZE                               16
+/* MHDR, DevAddr, FCtrl, FCnt and FPort before the payload */
+#define DOWNLINK_HEADER_SIZE                        9
+/* EU868 RX2 channel, used by the class C window */
+#define RXC_FREQUENCY                               869525000
+#define RXC_SPREADING_FACTOR                        12
+/* between a downlink and the next one */
+#define DOWNLINK_GAP                                SIM_TIME_MS( 500 )
+#define BACK_TO_BACK_GAP                            SIM_TIME_MS( 20 )
+
+/* Private variables ---------------------------------------------------------*/
+static const uint8_t Key[16] = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6,
+                                 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C };
+
+static uint32_t FCntDown = 0;
+static SimTime_t NextDownlink = 0;
+static bool ProcessPending = false;
+
+/* last indication, its pool buffer or LORAMAC_RX_BUFFER_NONE for the driver buffer */
+static uint32_t Indications = 0;
+static uint32_t LastFCnt = 0;
+static uint8_t *LastBuffer = NULL;
+static uint8_t LastPool = LORAMAC_RX_BUFFER_NONE;
+static uint32_t InPlace = 0;
+
+/* retain of the next indication */
+static bool RetainNext = false;
+static LoRaMacStatus_t RetainStatus;
+static uint8_t *RetainBuffer = NULL;
+
+/* RxDone interrupts to raise in ProcessRadioRxDone */
+static uint32_t RaiseRxDone = 0;
+
+static uint32_t Failures = 0;
+
+/* Private functions ---------------------------------------------------------*/
+static void Fail( const char *what )
+{
+  printf( "downlink %u: %s\n", ( unsigned )LastFCnt, what );
+  Failures++;
+}
+
+static void Check( bool condition, const char *what )
+{
+  if( condition == false )
+  {
+    Fail( what );
+  }
+}
+
+static uint8_t PayloadByte( uint32_t fCnt, uint8_t i )
+{
+  return ( uint8_t )( ( fCnt * 7 ) + i );
+}
+
+static bool PayloadIntact( const uint8_t *buffer, uint32_t fCnt )
+{
+  for( uint8_t i = 0; i < DOWNLINK_SIZE; i++ )
+  {
+    if( buffer[i] != PayloadByte( fCnt, i ) )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void McpsConfirm( McpsConfirm_t *mcpsConfirm )
+{
+  ( void )mcpsConfirm;
+}
+
+static void McpsIndication( McpsIndication_t *mcpsIndication )
+{
+  if( ( mcpsIndication->Status != LORAMAC_EVENT_INFO_STATUS_OK ) || ( mcpsIndication->RxData == false ) )
+  {
+    return;
+  }
+
+  LastFCnt = mcpsIndication->DownLinkCounter;
+  LastBuffer = mcpsIndication->Buffer;
+  LastPool = RxPoolFind( mcpsIndication->Buffer );
+
+  Check( LastFCnt == Indications, "indicated out of order or after a lost downlink" );
+  Indications = LastFCnt + 1;
+
+  if( ( mcpsIndication->Port != DOWNLINK_PORT ) || ( mcpsIndication->BufferSize != DOWNLINK_SIZE ) )
+  {
+    Fail( "wrong port or size" );
+    return;
+  }
+  Check( PayloadIntact( mcpsIndication->Buffer, LastFCnt ) == true, "payload overwritten" );
+  /* the payload is decrypted where the radio received the frame */
+  Check( *( mcpsIndication->Buffer - DOWNLINK_HEADER_SIZE ) == 0x60, "payload not right after its header" );
+  if( LastPool != LORAMAC_RX_BUFFER_NONE )
+  {
+    Check( LastPool == MacCtx.RxPoolIndication, "indicated in a pool buffer which is not the frame's" );
+    InPlace++;
+  }
+
+  if( RetainNext == true )
+  {
+    RetainNext = false;
+    RetainBuffer = mcpsIndication->Buffer;
+    RetainStatus = LoRaMacRxBufferRetain( mcpsIndication->Buffer );
+  }
+}
+
+static void MlmeConfirm( MlmeConfirm_t *mlmeConfirm )
+{
+  ( void )mlmeConfirm;
+}
+
+static void MlmeIndication( MlmeIndication_t *mlmeIndication )
+{
+  ( void )mlmeIndication;
+}
+
+static void OnMacProcessNotify( void )
+{
+  ProcessPending = true;
+}
+
+/*!
+ * Main loop of the device, after each event
+ */
+static void Process( void )
+{
+  while( ProcessPending == true )
+  {
+    ProcessPending = false;
+    LoRaMacProcess( );
+  }
+}
+
+/*!
+ * Raises the RxDone interrupt of the next downlink when ProcessRadioRxDone has
+ * taken its frame
+ */
+static void OnCriticalSectionEnd( const char *function )
+{
+  uint8_t taken = MacCtx.RxPoolIndication;
+
+  if( ( RaiseRxDone == 0 ) || ( strcmp( function, "ProcessRadioRxDone" ) != 0 ) )
+  {
+    return;
+  }
+  RaiseRxDone--;
+
+  SimEventSetProcess( NULL );
+  while( LoRaMacRadioEvents.Events.RxDone == 0 )
+  {
+    if( SimEventRunNext( ) == false )
+    {
+      printf( "no downlink received in ProcessRadioRxDone, the simulation stalled\n" );
+      exit( 1 );
+    }
+  }
+  SimEventSetProcess( Process );
+
+  if( ( taken != LORAMAC_RX_BUFFER_NONE ) && ( RxPoolFind( RxDoneParams.Payload ) == taken ) )
+  {
+    printf( "downlink received in the buffer of the frame being processed\n" );
+    Failures++;
+  }
+}
+
+/*!
+ * Puts on air the next downlink, DOWNLINK_GAP or gap after the previous one
+ */
+static void Downlink( SimTime_t gap )
+{
+  SimRadioFrame_t down;
+  uint8_t b0[16] = { 0x49, 0, 0, 0, 0, 1 };
+  uint8_t mic[AES_CMAC_DIGEST_LENGTH];
+  AES_CMAC_CTX cmac;
+  aes_context aes;
+
+  memset( &down, 0, sizeof( down ) );
+  if( NextDownlink < SimEventGetTime( ) )
+  {
+    NextDownlink = SimEventGetTime( );
+  }
+  down.Time = NextDownlink + gap;
+  down.Frequency = RXC_FREQUENCY;
+  down.Modem = MODEM_LORA;
+  down.Bandwidth = 0;
+  down.Datarate = RXC_SPREADING_FACTOR;
+  down.Coderate = 1;
+  down.PreambleLen = 8;
+  down.IqInverted = true;
+  down.Rssi = -60;
+  down.Snr = 5;
+
+  /* unconfirmed data down, no FOpts */
+  down.Payload[down.Size++] = 0x60;
+  for( uint8_t i = 0; i < 4; i++ )
+  {
+    down.Payload[down.Size++] = ( uint8_t )( DEV_ADDR >> ( 8 * i ) );
+  }
+  down.Payload[down.Size++] = 0x00;
+  down.Payload[down.Size++] = ( uint8_t )FCntDown;
+  down.Payload[down.Size++] = ( uint8_t )( FCntDown >> 8 );
+  down.Payload[down.Size++] = DOWNLINK_PORT;
+
+  /* LoRaWAN 1.0 payload encryption: A blocks then the frame */
+  aes_set_key( Key, sizeof( Key ), &aes );
+  for( uint8_t i = 0; i < DOWNLINK_SIZE; i += 16 )
+  {
+    uint8_t a[16] = { 0x01, 0, 0, 0, 0, 1 };
+    uint8_t s[16];
+
+    for( uint8_t j = 0; j < 4; j++ )
+    {
+      a[6 + j] = ( uint8_t )( DEV_ADDR >> ( 8 * j ) );
+      a[10 + j] = ( uint8_t )( FCntDown >> ( 8 * j ) );
+    }
+    a[15] = ( i / 16 ) + 1;
+    aes_encrypt( a, s, &aes );
+    for( uint8_t j = 0; ( j < 16 ) && ( ( i + j ) < DOWNLINK_SIZE ); j++ )
+    {
+      down.Payload[down.Size++] = PayloadByte( FCntDown, i + j ) ^ s[j];
+    }
+  }
+
+  /* LoRaWAN 1.0 MIC: B0 block then the frame */
+  for( uint8_t i = 0; i < 4; i++ )
+  {
+    b0[6 + i] = ( uint8_t )( DEV_ADDR >> ( 8 * i ) );
+    b0[10 + i] = ( uint8_t )( FCntDown >> ( 8 * i ) );
+  }
+  b0[15] = down.Size;
+  AES_CMAC_Init( &cmac );
+  AES_CMAC_SetKey( &cmac, Key );
+  AES_CMAC_Update( &cmac, b0, sizeof( b0 ) );
+  AES_CMAC_Update( &cmac, down.Payload, down.Size );
+  AES_CMAC_Final( mic, &cmac );
+  memcpy( &down.Payload[down.Size], mic, 4 );
+  down.Size += 4;
+
+  down.Duration = SimRadioGetTimeOnAir( &down );
+  if( SimRadioInject( &down ) == false )
+  {
+    printf( "downlink queue full, increase SIM_RADIO_RX_QUEUE_SIZE\n" );
+    exit( 1 );
+  }
+  NextDownlink = down.Time + down.Duration;
+  FCntDown++;
+}
+
+/*!
+ * Runs the simulation until the downlinks sent are all indicated
+ */
+static void RunUntilIndicated( void )
+{
+  while( Indications < FCntDown )
+  {
+    if( SimEventRunNext( ) == false )
+    {
+      printf( "downlink %u not indicated, the simulation stalled\n", ( unsigned )Indications );
+      exit( 1 );
+    }
+  }
+  /* the device carries on with its last event */
+  Process( );
+}
+
+static uint8_t GetBatteryLevel( void )
+{
+  return 254;
+}
+
+static uint16_t GetTemperatureLevel( void )
+{
+  return 25;
+}
+
+static void Start( void )
+{
+  static LoRaMacPrimitives_t primitives = { McpsConfirm, McpsIndication, MlmeConfirm, MlmeIndication };
+  static LoRaMacCallback_t callbacks = { GetBatteryLevel, GetTemperatureLevel, NULL, OnMacProcessNotify };
+  MibRequestConfirm_t mibReq;
+
+  SimEventReset( );
+  HW_RTC_Init( );
+  SimEventSetProcess( Process );
+  if( LoRaMacInitialization( &primitives, &callbacks, LORAMAC_REGION_EU868 ) != LORAMAC_STATUS_OK )
+  {
+    printf( "LoRaMacInitialization failed\n" );
+    exit( 1 );
+  }
+
+  mibReq.Type = MIB_ABP_LORAWAN_VERSION;
+  mibReq.Param.AbpLrWanVersion.Value = 0x01000300;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+  mibReq.Type = MIB_NETWORK_ACTIVATION;
+  mibReq.Param.NetworkActivation = ACTIVATION_TYPE_ABP;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+  mibReq.Type = MIB_DEV_ADDR;
+  mibReq.Param.DevAddr = DEV_ADDR;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+  mibReq.Type = MIB_F_NWK_S_INT_KEY;
+  mibReq.Param.FNwkSIntKey = ( uint8_t * )Key;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+  mibReq.Type = MIB_S_NWK_S_INT_KEY;
+  mibReq.Param.SNwkSIntKey = ( uint8_t * )Key;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+  mibReq.Type = MIB_NWK_S_ENC_KEY;
+  mibReq.Param.NwkSEncKey = ( uint8_t * )Key;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+  mibReq.Type = MIB_APP_S_KEY;
+  mibReq.Param.AppSKey = ( uint8_t * )Key;
+  LoRaMacMibSetRequestConfirm( &mibReq );
+  LoRaMacStart( );
+
+  mibReq.Type = MIB_DEVICE_CLASS;
+  mibReq.Param.Class = CLASS_C;
+  if( LoRaMacMibSetRequestConfirm( &mibReq ) != LORAMAC_STATUS_OK )
+  {
+    printf( "switch to class C failed\n" );
+    exit( 1 );
+  }
+  Process( );
+}
+
+int main( int argc, char *argv[] )
+{
+  uint32_t downlinks = ( argc > 1 ) ? ( uint32_t )strtoul( argv[1], NULL, 0 ) : 200;
+  uint32_t failures;
+  uint32_t inPlace;
+  uint32_t retainedFCnt;
+  uint8_t *retained;
+  uint8_t retainedPool;
+
+  Start( );
+
+  /* in place */
+  for( uint32_t i = 0; i < downlinks; i++ )
+  {
+    Downlink( DOWNLINK_GAP );
+    RunUntilIndicated( );
+  }
+  printf( "%u downlinks: %u indicated in place, %u failures\n", ( unsigned )downlinks, ( unsigned )InPlace,
+          ( unsigned )Failures );
+  if( InPlace != downlinks )
+  {
+    printf( "downlinks indicated out of the pool\n" );
+    Failures++;
+  }
+
+  /* retain */
+  failures = Failures;
+  RetainNext = true;
+  Downlink( DOWNLINK_GAP );
+  RunUntilIndicated( );
+  Check( ( LastPool != LORAMAC_RX_BUFFER_NONE ) && ( RetainStatus == LORAMAC_STATUS_OK ),
+         "retain refused with a free buffer" );
+  retained = RetainBuffer;
+  retainedPool = LastPool;
+  retainedFCnt = LastFCnt;
+
+  RetainNext = true;
+  Downlink( DOWNLINK_GAP );
+  RunUntilIndicated( );
+  Check( ( LastPool != LORAMAC_RX_BUFFER_NONE ) && ( LastPool != retainedPool ), "not indicated in place" );
+  Check( RetainStatus == LORAMAC_STATUS_BUSY, "last buffer retained" );
+
+  /* exhausted pool: the second downlink is received while the first one, in
+     the last free buffer, is processed */
+  RaiseRxDone = 1;
+  Downlink( DOWNLINK_GAP );
+  Downlink( BACK_TO_BACK_GAP );
+  RunUntilIndicated( );
+  Check( RaiseRxDone == 0, "no frame processed" );
+  Check( LastPool == LORAMAC_RX_BUFFER_NONE, "indicated in the pool while it was exhausted" );
+  Downlink( DOWNLINK_GAP );
+  RunUntilIndicated( );
+  Check( ( LastPool != LORAMAC_RX_BUFFER_NONE ) && ( LastPool != retainedPool ),
+         "not back in the pool after the driver buffer" );
+
+  Check( PayloadIntact( retained, retainedFCnt ) == true, "retained payload overwritten" );
+  Check( LoRaMacRxBufferRelease( retained ) == LORAMAC_STATUS_OK, "release failed" );
+  Check( LoRaMacRxBufferRelease( retained ) == LORAMAC_STATUS_PARAMETER_INVALID, "released twice" );
+  Check( ( MacCtx.RxPoolRetained == 0 ) && ( MacCtx.RxPoolUsed == ( 1 << MacCtx.RxPoolRadio ) ),
+         "released buffer not back in the pool" );
+  RetainNext = true;
+  Downlink( DOWNLINK_GAP );
+  RunUntilIndicated( );
+  Check( RetainStatus == LORAMAC_STATUS_OK, "retain refused after the release" );
+  Check( LoRaMacRxBufferRelease( RetainBuffer ) == LORAMAC_STATUS_OK, "release failed" );
+  printf( "retain, exhausted pool: %u failures\n", ( unsigned )( Failures - failures ) );
+
+  /* back to back */
+  failures = Failures;
+  inPlace = InPlace;
+  for( uint32_t i = 0; i < ( downlinks / 2 ); i++ )
+  {
+    RaiseRxDone = 1;
+    Downlink( DOWNLINK_GAP );
+    Downlink( BACK_TO_BACK_GAP );
+    RunUntilIndicated( );
+    Check( RaiseRxDone == 0, "no frame processed" );
+  }
+  inPlace = InPlace - inPlace;
+  printf( "%u downlinks back to back: %u indicated in place, %u failures\n", ( unsigned )( 2 * ( downlinks / 2 ) ),
+          ( unsigned )inPlace, ( unsigned )( Failures - failures ) );
+  if( inPlace != ( 2 * ( downlinks / 2 ) ) )
+  {
+    printf( "downlinks indicated out of the pool\n" );
+    Failures++;
+  }
+
+  return ( Failures == 0 ) ? 0 : 1;
+}
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
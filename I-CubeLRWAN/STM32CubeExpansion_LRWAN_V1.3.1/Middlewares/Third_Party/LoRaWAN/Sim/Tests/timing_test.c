@@ -0,0 +1,390 @@
+/**
+  ******************************************************************************
+  * @file    timing_test.c
+  * @author  MCD Application Team
+  * @brief   Host test of the LORA_FIXED_POINT_TIMING computations
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+/*
+ * Runs the integer SX1276GetTimeOnAir and RegionCommonComputeRxWindowParameters,
+ * built from the driver and region sources with LORA_FIXED_POINT_TIMING:
+ *  - against the exact result, computed with 64-bit integers, which they
+ *    must always match
+ *  - against the double implementations they replace, copied below, which
+ *    may only differ where the exact result sits on a rounding boundary (an
+ *    integer under ceil, a .5 under round) or where the double LoRa payload
+ *    formula wraps around for payloads shorter than its header
+ *
+ * Covered:
+ *  - LoRa time on air: every bandwidth, SF6 to SF12, coding rate, low datarate
+ *    optimization, CRC and header mode, payloads 0 to 255, preambles 0 to 64
+ *    and 65535
+ *  - FSK time on air: every datarate from 600 to 300000 bps with payloads 0 to
+ *    255, and at 50 kbps every sync word size, address filtering, header and
+ *    CRC setting with preambles 0 to 64 and 65535
+ *  - RX windows: SF6 to SF12 at 125, 250 and 500 kHz and FSK 50 kbps, every
+ *    minRxSymbols, rxError 0 to 1000 ms and wakeUpTime 0 to 10 ms
+ * With "full", the time on air runs for every preamble length (a few minutes).
+ *
+ * Usage: timing_test [full]
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hw.h"
+#include "radio.h"
+#include "sx1276.h"
+#include "RegionCommon.h"
+
+/* Private define ------------------------------------------------------------*/
+#define MAX_REPORTS                                 10
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t Registers[0x80];
+static int32_t SpiAddress = -1;
+static bool SpiWrite = false;
+
+static bool Full = false;
+
+static uint64_t Cases = 0;
+static uint32_t Boundaries = 0;
+static uint32_t Wraps = 0;
+static uint32_t Failures = 0;
+
+/* Private functions ---------------------------------------------------------*/
+/*
+ * Radio registers behind the SPI, for the reads of SX1276GetTimeOnAir
+ */
+void HW_GPIO_Init( void *port, uint16_t pin, GPIO_InitTypeDef *initStruct )
+{
+  ( void )port;
+  ( void )pin;
+  ( void )initStruct;
+}
+
+void HW_GPIO_Write( void *port, uint16_t pin, uint32_t value )
+{
+  if( pin == RADIO_NSS_PIN )
+  {
+    ( void )port;
+    SpiAddress = ( value == 0 ) ? -1 : SpiAddress;
+  }
+}
+
+uint16_t HW_SPI_InOut( uint16_t outData )
+{
+  uint8_t inData = 0;
+
+  if( SpiAddress < 0 )
+  {
+    /* first byte of the transfer: address and direction */
+    SpiAddress = outData & 0x7F;
+    SpiWrite = ( outData & 0x80 ) != 0;
+  }
+  else
+  {
+    if( SpiWrite == true )
+    {
+      Registers[SpiAddress] = ( uint8_t )outData;
+    }
+    inData = Registers[SpiAddress];
+    /* burst access, the FIFO address does not increment */
+    SpiAddress = ( SpiAddress == 0 ) ? 0 : ( ( SpiAddress + 1 ) & 0x7F );
+  }
+  return inData;
+}
+
+static void Fail( const char *what, const char *format, ... )
+{
+  va_list args;
+
+  if( ++Failures <= MAX_REPORTS )
+  {
+    printf( "%s: ", what );
+    va_start( args, format );
+    vprintf( format, args );
+    va_end( args );
+    printf( "\n" );
+  }
+}
+
+/*
+ * Preamble lengths under test
+ */
+static uint32_t NextPreamble( uint32_t preamble )
+{
+  return ( ( Full == false ) && ( preamble == 64 ) ) ? 0xFFFF : ( preamble + 1 );
+}
+
+static int64_t DivCeil64( int64_t num, int64_t den )
+{
+  return ( num >= 0 ) ? ( ( num + den - 1 ) / den ) : -( -num / den );
+}
+
+/*
+ * Reference: double implementation of SX1276GetTimeOnAir
+ */
+static uint32_t TimeOnAirDouble( RadioModems_t modem, uint8_t pktLen )
+{
+  uint32_t airTime = 0;
+
+  switch( modem )
+  {
+    case MODEM_FSK:
+      airTime = ( uint32_t )round( ( 8 * ( SX1276.Settings.Fsk.PreambleLen +
+                                   ( ( SX1276Read( REG_SYNCCONFIG ) & ~RF_SYNCCONFIG_SYNCSIZE_MASK ) + 1 ) +
+                                   ( ( SX1276.Settings.Fsk.FixLen == 0x01 ) ? 0.0 : 1.0 ) +
+                                   ( ( ( SX1276Read( REG_PACKETCONFIG1 ) & ~RF_PACKETCONFIG1_ADDRSFILTERING_MASK ) != 0x00 ) ? 1.0 : 0 ) +
+                                   pktLen +
+                                   ( ( SX1276.Settings.Fsk.CrcOn == 0x01 ) ? 2.0 : 0 ) ) /
+                                   SX1276.Settings.Fsk.Datarate ) * 1000 );
+      break;
+    case MODEM_LORA:
+    {
+      double bw = 125000.0 * ( 1 << ( SX1276.Settings.LoRa.Bandwidth - 7 ) );
+      double rs = bw / ( 1 << SX1276.Settings.LoRa.Datarate );
+      double ts = 1 / rs;
+      double tPreamble = ( SX1276.Settings.LoRa.PreambleLen + 4.25 ) * ts;
+      double tmp = ceil( ( 8 * pktLen - 4 * SX1276.Settings.LoRa.Datarate +
+                           28 + 16 * SX1276.Settings.LoRa.CrcOn -
+                           ( SX1276.Settings.LoRa.FixLen ? 20 : 0 ) ) /
+                         ( double )( 4 * ( SX1276.Settings.LoRa.Datarate -
+                                     ( ( SX1276.Settings.LoRa.LowDatarateOptimize > 0 ) ? 2 : 0 ) ) ) ) *
+                   ( SX1276.Settings.LoRa.Coderate + 4 );
+      double nPayload = 8 + ( ( tmp > 0 ) ? tmp : 0 );
+      double tPayload = nPayload * ts;
+      double tOnAir = tPreamble + tPayload;
+
+      airTime = ( uint32_t )floor( tOnAir * 1000 + 0.999 );
+      break;
+    }
+  }
+  return airTime;
+}
+
+/*
+ * Reference: double implementation of RegionCommonComputeRxWindowParameters
+ */
+static void RxWindowDouble( double tSymbol, uint8_t minRxSymbols, uint32_t rxError, uint32_t wakeUpTime,
+                            uint32_t *windowTimeout, int32_t *windowOffset )
+{
+  *windowTimeout = MAX( ( uint32_t )ceil( ( ( 2 * minRxSymbols - 8 ) * tSymbol + 2 * rxError ) / tSymbol ), minRxSymbols );
+  *windowOffset = ( int32_t )ceil( ( 4.0 * tSymbol ) - ( ( *windowTimeout * tSymbol ) / 2.0 ) - wakeUpTime );
+}
+
+static void CheckLoRaTimeOnAir( uint8_t len )
+{
+  int32_t sf = SX1276.Settings.LoRa.Datarate;
+  int32_t num = 8 * len - 4 * sf + 28 + 16 * SX1276.Settings.LoRa.CrcOn - ( SX1276.Settings.LoRa.FixLen ? 20 : 0 );
+  int32_t den = 4 * ( sf - ( ( SX1276.Settings.LoRa.LowDatarateOptimize > 0 ) ? 2 : 0 ) );
+  int64_t nbSymbols = 8 + MAX( DivCeil64( num, den ), 0 ) * ( SX1276.Settings.LoRa.Coderate + 4 );
+  /* ( preamble + 4.25 + symbols ) * 2^SF / bw, rounded up past 0.001 ms */
+  int64_t bwQuarterKhz = 4 * ( 125 << ( SX1276.Settings.LoRa.Bandwidth - 7 ) );
+  int64_t quarterSymbols = ( 4 * ( int64_t )SX1276.Settings.LoRa.PreambleLen + 17 + 4 * nbSymbols ) << sf;
+  uint32_t exact = ( uint32_t )( ( 1000 * quarterSymbols + 999 * bwQuarterKhz ) / ( 1000 * bwQuarterKhz ) );
+  uint32_t fixed = SX1276GetTimeOnAir( MODEM_LORA, len );
+  uint32_t reference = TimeOnAirDouble( MODEM_LORA, len );
+
+  Cases++;
+  if( ( fixed == exact ) && ( fixed == reference ) )
+  {
+    return;
+  }
+  if( ( fixed == exact ) && ( num < 0 ) )
+  {
+    /* the unsigned datarate makes the double numerator wrap around */
+    Wraps++;
+    return;
+  }
+  Fail( "LoRa time on air", "BW%u SF%u CR4/%u LDRO%u CRC%u FixLen%u preamble %u payload %u: %u ms, exact %u, double %u",
+        ( unsigned )SX1276.Settings.LoRa.Bandwidth, ( unsigned )sf, SX1276.Settings.LoRa.Coderate + 4,
+        SX1276.Settings.LoRa.LowDatarateOptimize, SX1276.Settings.LoRa.CrcOn, SX1276.Settings.LoRa.FixLen,
+        SX1276.Settings.LoRa.PreambleLen, len, ( unsigned )fixed, ( unsigned )exact, ( unsigned )reference );
+}
+
+static void TestLoRaTimeOnAir( void )
+{
+  for( uint32_t bw = 7; bw <= 9; bw++ )
+  {
+    for( uint32_t sf = 6; sf <= 12; sf++ )
+    {
+      for( uint32_t flags = 0; flags < 32; flags++ )
+      {
+        SX1276.Settings.LoRa.Bandwidth = bw;
+        SX1276.Settings.LoRa.Datarate = sf;
+        SX1276.Settings.LoRa.Coderate = 1 + ( flags & 3 );
+        SX1276.Settings.LoRa.LowDatarateOptimize = ( flags >> 2 ) & 1;
+        SX1276.Settings.LoRa.CrcOn = ( flags >> 3 ) & 1;
+        SX1276.Settings.LoRa.FixLen = ( flags >> 4 ) & 1;
+        for( uint32_t preamble = 0; preamble <= 0xFFFF; preamble = NextPreamble( preamble ) )
+        {
+          SX1276.Settings.LoRa.PreambleLen = preamble;
+          for( uint32_t len = 0; len <= 255; len++ )
+          {
+            CheckLoRaTimeOnAir( len );
+          }
+        }
+      }
+    }
+  }
+}
+
+static void CheckFskTimeOnAir( uint8_t len )
+{
+  uint32_t datarate = SX1276.Settings.Fsk.Datarate;
+  uint32_t nbBytes = SX1276.Settings.Fsk.PreambleLen + ( Registers[REG_SYNCCONFIG] & 0x07 ) + 1 +
+                     ( ( SX1276.Settings.Fsk.FixLen == 1 ) ? 0 : 1 ) + ( ( Registers[REG_PACKETCONFIG1] & 0x06 ) ? 1 : 0 ) +
+                     len + ( ( SX1276.Settings.Fsk.CrcOn == 1 ) ? 2 : 0 );
+  /* 8000 * nbBytes / datarate ms, rounded half up */
+  uint64_t twice = 16000 * ( uint64_t )nbBytes;
+  uint32_t exact = ( uint32_t )( ( twice + datarate ) / ( 2 * ( uint64_t )datarate ) );
+  uint32_t fixed = SX1276GetTimeOnAir( MODEM_FSK, len );
+  uint32_t reference = TimeOnAirDouble( MODEM_FSK, len );
+
+  Cases++;
+  if( ( fixed == exact ) && ( fixed == reference ) )
+  {
+    return;
+  }
+  if( ( fixed == exact ) && ( ( twice % datarate ) == 0 ) && ( ( ( twice / datarate ) & 1 ) == 1 ) )
+  {
+    Boundaries++;
+    return;
+  }
+  Fail( "FSK time on air", "%u bps, %u bytes: %u ms, exact %u, double %u", ( unsigned )datarate,
+        ( unsigned )nbBytes, ( unsigned )fixed, ( unsigned )exact, ( unsigned )reference );
+}
+
+static void TestFskTimeOnAir( void )
+{
+  /* every datarate, usual frame format */
+  SX1276.Settings.Fsk.PreambleLen = 5;
+  SX1276.Settings.Fsk.FixLen = 0;
+  SX1276.Settings.Fsk.CrcOn = 1;
+  SX1276Write( REG_SYNCCONFIG, RF_SYNCCONFIG_SYNCSIZE_3 );
+  SX1276Write( REG_PACKETCONFIG1, 0 );
+  for( uint32_t datarate = 600; datarate <= 300000; datarate++ )
+  {
+    SX1276.Settings.Fsk.Datarate = datarate;
+    for( uint32_t len = 0; len <= 255; len++ )
+    {
+      CheckFskTimeOnAir( len );
+    }
+  }
+
+  /* LoRaWAN datarate, every frame format */
+  SX1276.Settings.Fsk.Datarate = 50000;
+  for( uint32_t flags = 0; flags < 64; flags++ )
+  {
+    SX1276Write( REG_SYNCCONFIG, flags & 0x07 );
+    SX1276Write( REG_PACKETCONFIG1, ( ( flags >> 3 ) & 1 ) ? RF_PACKETCONFIG1_ADDRSFILTERING_NODE : 0 );
+    SX1276.Settings.Fsk.FixLen = ( flags >> 4 ) & 1;
+    SX1276.Settings.Fsk.CrcOn = ( flags >> 5 ) & 1;
+    for( uint32_t preamble = 0; preamble <= 0xFFFF; preamble = NextPreamble( preamble ) )
+    {
+      SX1276.Settings.Fsk.PreambleLen = preamble;
+      for( uint32_t len = 0; len <= 255; len++ )
+      {
+        CheckFskTimeOnAir( len );
+      }
+    }
+  }
+}
+
+static void CheckRxWindow( const char *what, RegionCommonSymbolTime_t tSymbolUs, double tSymbolMs )
+{
+  for( uint32_t minRxSymbols = 0; minRxSymbols <= 255; minRxSymbols++ )
+  {
+    for( uint32_t rxError = 0; rxError <= 1000; rxError++ )
+    {
+      for( uint32_t wakeUpTime = 0; wakeUpTime <= 10; wakeUpTime++ )
+      {
+        /* window length in us: ( 2 * minRxSymbols - 8 ) symbols and twice the error */
+        int64_t windowUs = ( 2 * ( int64_t )minRxSymbols - 8 ) * tSymbolUs + 2000 * ( int64_t )rxError;
+        int64_t exactTimeout = MAX( DivCeil64( windowUs, tSymbolUs ), ( int64_t )minRxSymbols );
+        /* 4 symbols minus half the window, in half us */
+        int64_t offsetHalfUs = ( 8 - exactTimeout ) * tSymbolUs;
+        int64_t exactOffset = DivCeil64( offsetHalfUs, 2000 ) - wakeUpTime;
+        uint32_t timeout, refTimeout;
+        int32_t offset, refOffset;
+
+        RegionCommonComputeRxWindowParameters( tSymbolUs, minRxSymbols, rxError, wakeUpTime, &timeout, &offset );
+        Cases++;
+        if( ( timeout != exactTimeout ) || ( offset != exactOffset ) )
+        {
+          Fail( what, "minRxSymbols %u rxError %u wakeUpTime %u: timeout %u offset %d, exact %d %d",
+                ( unsigned )minRxSymbols, ( unsigned )rxError, ( unsigned )wakeUpTime, ( unsigned )timeout,
+                ( int )offset, ( int )exactTimeout, ( int )exactOffset );
+          continue;
+        }
+        if( windowUs < 0 )
+        {
+          /* the double implementation converts the negative number of
+             symbols to unsigned */
+          Wraps++;
+          continue;
+        }
+
+        RxWindowDouble( tSymbolMs, minRxSymbols, rxError, wakeUpTime, &refTimeout, &refOffset );
+        if( ( timeout == refTimeout ) && ( offset == refOffset ) )
+        {
+          continue;
+        }
+        if( ( ( windowUs % tSymbolUs ) == 0 ) || ( ( offsetHalfUs % 2000 ) == 0 ) )
+        {
+          Boundaries++;
+          continue;
+        }
+        Fail( what, "minRxSymbols %u rxError %u wakeUpTime %u: timeout %u offset %d, double %u %d",
+              ( unsigned )minRxSymbols, ( unsigned )rxError, ( unsigned )wakeUpTime, ( unsigned )timeout,
+              ( int )offset, ( unsigned )refTimeout, ( int )refOffset );
+      }
+    }
+  }
+}
+
+static void TestRxWindows( void )
+{
+  static const uint32_t bandwidths[] = { 125000, 250000, 500000 };
+  char what[32];
+
+  for( uint32_t bw = 0; bw < 3; bw++ )
+  {
+    for( uint8_t sf = 6; sf <= 12; sf++ )
+    {
+      snprintf( what, sizeof( what ), "RX window SF%u %u kHz", sf, ( unsigned )( bandwidths[bw] / 1000 ) );
+      CheckRxWindow( what, RegionCommonComputeSymbolTimeLoRa( sf, bandwidths[bw] ),
+                     ( ( double )( 1 << sf ) / ( double )bandwidths[bw] ) * 1000 );
+    }
+  }
+  CheckRxWindow( "RX window FSK 50 kbps", RegionCommonComputeSymbolTimeFsk( 50 ), 8.0 / 50.0 );
+}
+
+int main( int argc, char *argv[] )
+{
+  Full = ( argc > 1 ) && ( strcmp( argv[1], "full" ) == 0 );
+
+  TestLoRaTimeOnAir( );
+  TestFskTimeOnAir( );
+  TestRxWindows( );
+
+  printf( "%llu cases: %u on a rounding boundary and %u wrapping around in the double version, %u failures\n",
+          ( unsigned long long )Cases, ( unsigned )Boundaries, ( unsigned )Wraps, ( unsigned )Failures );
+  return ( Failures == 0 ) ? 0 : 1;
+}
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
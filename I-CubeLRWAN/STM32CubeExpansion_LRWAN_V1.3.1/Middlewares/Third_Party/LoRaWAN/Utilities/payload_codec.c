@@ -0,0 +1,197 @@
+/**
+  ******************************************************************************
+  * @file    payload_codec.c
+  * @author  MCD Application Team
+  * @brief   Delta, zigzag and varint encoding of sensor time series
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include "payload_codec.h"
+
+/* Private define ------------------------------------------------------------*/
+/* Private typedef -----------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* The differences are computed modulo 2^32: a wrapped difference is decoded back
+   to the same value */
+#define ZIGZAG_ENCODE(v)    ((((uint32_t)(v)) << 1) ^ (uint32_t)(-(int32_t)(((uint32_t)(v)) >> 31)))
+#define ZIGZAG_DECODE(u)    ((int32_t)(((u) >> 1) ^ (uint32_t)(-(int32_t)((u) & 1))))
+
+/* Private function prototypes -----------------------------------------------*/
+static int varint_write(uint8_t *buff, uint16_t size, uint16_t max_size, uint32_t value);
+static int varint_read(const uint8_t *buff, uint16_t size, uint16_t *index, uint32_t *value);
+
+/* Public functions ----------------------------------------------------------*/
+int PayloadCodec_Init(payload_codec_t *codec, uint8_t *buff, uint16_t buff_size, uint8_t nb_channels)
+{
+  if ((codec == NULL) || (buff == NULL) ||
+      (nb_channels == 0) || (nb_channels > PAYLOAD_CODEC_MAX_CHANNELS))
+  {
+    return -1;
+  }
+  codec->buff = buff;
+  codec->buff_size = buff_size;
+  codec->size = PAYLOAD_CODEC_HEADER_SIZE;
+  codec->nb_channels = nb_channels;
+  codec->nb_readings = 0;
+  return 0;
+}
+
+int PayloadCodec_Add(payload_codec_t *codec, const int32_t *values, uint16_t max_size)
+{
+  uint16_t size = codec->size;
+  uint32_t delta;
+  int written;
+
+  if (max_size > codec->buff_size)
+  {
+    max_size = codec->buff_size;
+  }
+  if ((max_size < PAYLOAD_CODEC_HEADER_SIZE) || (codec->nb_readings == UINT8_MAX))
+  {
+    return -1;
+  }
+
+  for (uint8_t i = 0; i < codec->nb_channels; i++)
+  {
+    delta = (uint32_t)values[i];
+    if (codec->nb_readings != 0)
+    {
+      delta -= (uint32_t)codec->prev[i];
+    }
+    written = varint_write(codec->buff, size, max_size, ZIGZAG_ENCODE(delta));
+    if (written < 0)
+    {
+      /* the frame size is only updated on success */
+      return -1;
+    }
+    size += written;
+  }
+
+  for (uint8_t i = 0; i < codec->nb_channels; i++)
+  {
+    codec->prev[i] = values[i];
+  }
+  codec->size = size;
+  codec->nb_readings++;
+  codec->buff[0] = (PAYLOAD_CODEC_VERSION << 4) | codec->nb_channels;
+  codec->buff[1] = codec->nb_readings;
+  return 0;
+}
+
+uint16_t PayloadCodec_GetSize(const payload_codec_t *codec)
+{
+  if (codec->nb_readings == 0)
+  {
+    return 0;
+  }
+  return codec->size;
+}
+
+int PayloadCodec_Decode(const uint8_t *frame, uint16_t size, int32_t *values, uint16_t max_values, uint8_t *nb_channels)
+{
+  uint16_t index = PAYLOAD_CODEC_HEADER_SIZE;
+  uint8_t channels;
+  uint8_t readings;
+  uint32_t value;
+
+  if ((frame == NULL) || (values == NULL) || (size < PAYLOAD_CODEC_HEADER_SIZE) ||
+      ((frame[0] >> 4) != PAYLOAD_CODEC_VERSION))
+  {
+    return -1;
+  }
+  channels = frame[0] & 0x0F;
+  readings = frame[1];
+  if ((channels == 0) || ((uint32_t)channels * readings > max_values))
+  {
+    return -1;
+  }
+
+  for (uint16_t n = 0; n < (uint16_t)channels * readings; n++)
+  {
+    if (varint_read(frame, size, &index, &value) < 0)
+    {
+      return -1;
+    }
+    values[n] = ZIGZAG_DECODE(value);
+    if (n >= channels)
+    {
+      values[n] = (int32_t)((uint32_t)values[n - channels] + (uint32_t)values[n]);
+    }
+  }
+  if (index != size)
+  {
+    return -1;
+  }
+
+  if (nb_channels != NULL)
+  {
+    *nb_channels = channels;
+  }
+  return readings;
+}
+
+/* Private functions ---------------------------------------------------------*/
+/**
+  * @brief  Writes a varint at buff[size]
+  * @retval number of bytes written, -1 when it doesn't fit in max_size
+  */
+static int varint_write(uint8_t *buff, uint16_t size, uint16_t max_size, uint32_t value)
+{
+  uint16_t index = size;
+
+  while (value >= 0x80)
+  {
+    if (index >= max_size)
+    {
+      return -1;
+    }
+    buff[index++] = (uint8_t)value | 0x80;
+    value >>= 7;
+  }
+  if (index >= max_size)
+  {
+    return -1;
+  }
+  buff[index++] = (uint8_t)value;
+  return index - size;
+}
+
+/**
+  * @brief  Reads a varint at buff[*index] and moves the index after it
+  * @retval 0 when OK, -1 when the varint is truncated or too long
+  */
+static int varint_read(const uint8_t *buff, uint16_t size, uint16_t *index, uint32_t *value)
+{
+  uint32_t result = 0;
+  uint8_t shift = 0;
+  uint8_t byte;
+
+  do
+  {
+    if ((*index >= size) || (shift >= 7 * PAYLOAD_CODEC_VARINT_MAX_SIZE))
+    {
+      return -1;
+    }
+    byte = buff[(*index)++];
+    result |= (uint32_t)(byte & 0x7F) << shift;
+    shift += 7;
+  } while ((byte & 0x80) != 0);
+
+  *value = result;
+  return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,136 @@
+/**
+  ******************************************************************************
+  * @file    payload_codec.h
+  * @author  MCD Application Team
+  * @brief   Header for payload_codec.c
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+/**
+  * Compact encoding of sensor time series for uplinks.
+  *
+  * A frame carries successive readings of up to PAYLOAD_CODEC_MAX_CHANNELS
+  * integer channels (fixed point sensor values):
+  *
+  *   | Header (1) | Count (1) | Reading 0 | Reading 1 | ... |
+  *
+  *   Header: bits 7..4 format version, bits 3..0 number of channels
+  *   Count : number of readings in the frame
+  *
+  * Reading 0 holds the value of each channel, the following readings the
+  * difference with the previous reading. Each value or difference is zigzag
+  * mapped (0, -1, 1, -2 ... to 0, 1, 2, 3 ...) and written as a varint: 7 bits
+  * per byte, least significant first, bit 7 set when more bytes follow. A slow
+  * changing channel takes one byte per reading.
+  *
+  * The module only depends on the C library: the decoder is meant to be built
+  * on the host as well, e.g. by the application server.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PAYLOAD_CODEC_H__
+#define __PAYLOAD_CODEC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+/**
+  * Format version written in the frame header
+  */
+#define PAYLOAD_CODEC_VERSION           1
+
+/**
+  * Maximum number of channels of a reading
+  */
+#define PAYLOAD_CODEC_MAX_CHANNELS      15
+
+/**
+  * Size of the frame header and reading count
+  */
+#define PAYLOAD_CODEC_HEADER_SIZE       2
+
+/**
+  * Maximum size of a varint coded 32 bits value
+  */
+#define PAYLOAD_CODEC_VARINT_MAX_SIZE   5
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * Encoder context, one per frame being built
+  */
+typedef struct
+{
+  uint8_t *buff;                                   /* frame buffer */
+  uint16_t buff_size;                              /* size of the frame buffer */
+  uint16_t size;                                   /* size of the frame */
+  uint8_t nb_channels;                             /* channels of a reading */
+  uint8_t nb_readings;                             /* readings in the frame */
+  int32_t prev[PAYLOAD_CODEC_MAX_CHANNELS];        /* last reading added */
+} payload_codec_t;
+
+/* External variables --------------------------------------------------------*/
+/* Exported macros -----------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+/**
+  * @brief  Starts a new frame
+  * @param  codec: encoder context
+  * @param  buff: frame buffer, filled by PayloadCodec_Add
+  * @param  buff_size: size of the frame buffer
+  * @param  nb_channels: channels of a reading, 1 to PAYLOAD_CODEC_MAX_CHANNELS
+  * @retval 0 when OK, -1 when a parameter is invalid
+  */
+int PayloadCodec_Init(payload_codec_t *codec, uint8_t *buff, uint16_t buff_size, uint8_t nb_channels);
+
+/**
+  * @brief  Appends a reading to the frame
+  * @note   the frame is left unchanged when the reading doesn't fit: the caller
+  *         sends the frame and adds the reading to a new one
+  * @param  codec: encoder context
+  * @param  values: value of each channel
+  * @param  max_size: maximum frame size, e.g. the maximum application payload
+  *         of the current datarate
+  * @retval 0 when OK, -1 when the reading doesn't fit in max_size
+  */
+int PayloadCodec_Add(payload_codec_t *codec, const int32_t *values, uint16_t max_size);
+
+/**
+  * @brief  Returns the size of the frame
+  * @param  codec: encoder context
+  * @retval frame size in bytes, 0 when the frame holds no reading
+  */
+uint16_t PayloadCodec_GetSize(const payload_codec_t *codec);
+
+/**
+  * @brief  Decodes a frame
+  * @param  frame: frame to decode
+  * @param  size: frame size
+  * @param  values: decoded values, reading after reading, nb_channels per reading
+  * @param  max_values: size of the values array
+  * @param  nb_channels: number of channels of a reading, may be NULL
+  * @retval number of readings decoded, -1 when the frame is invalid or values
+  *         too small
+  */
+int PayloadCodec_Decode(const uint8_t *frame, uint16_t size, int32_t *values, uint16_t max_values, uint8_t *nb_channels);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PAYLOAD_CODEC_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -52,59 +52,96 @@ Maintainer: Miguel Luis, Gregory Cristian and Wael Guibene
       }                           \
   } while(0);                   
 
+/*!
+ * Queue index of a stopped timer
+ */
+#define TIMER_QUEUE_INDEX_NONE                      0xFFFF
 
+#define TIMER_QUEUE_PARENT( i )                     ( ( ( i ) - 1 ) / 2 )
+#define TIMER_QUEUE_LEFT( i )                       ( ( 2 * ( i ) ) + 1 )
 
 /*!
- * Timers list head pointer
+ * Measure of the IRQ masked sections, see TimerGetStats
  */
-static TimerEvent_t *TimerListHead = NULL;
+#if defined( TIMER_STATS_GET_CYCLES )
+#define TIMER_STATS_MASK_BEGIN( )                   uint32_t maskStart = TIMER_STATS_GET_CYCLES( )
+#define TIMER_STATS_MASK_END( )                     TimerStatsMaskEnd( maskStart )
+#else
+#define TIMER_STATS_MASK_BEGIN( )
+#define TIMER_STATS_MASK_END( )
+#endif
 
 /*!
- * \brief Adds or replace the head timer of the list.
- *
- * \remark The list is automatically sorted. The list head always contains the
- *         next timer to expire.
- *
- * \param [IN]  obj Timer object to be become the new head
- * \param [IN]  remainingTime Remaining time of the previous head to be replaced
+ * Started timers, binary min-heap ordered by expiry time.
+ * TimerQueue[0] is the next timer to expire.
  */
-static void TimerInsertNewHeadTimer( TimerEvent_t *obj );
+static TimerEvent_t *TimerQueue[TIMER_QUEUE_SIZE];
+
+static uint16_t TimerQueueLength = 0;
 
 /*!
- * \brief Adds a timer to the list.
- *
- * \remark The list is automatically sorted. The list head always contains the
- *         next timer to expire.
+ * Timer the RTC alarm is set for. It is NULL when the timer has been removed
+ * from the queue since, TimerAlarmIsSet tells if the alarm is still running.
+ */
+static TimerEvent_t *TimerAlarm = NULL;
+
+static bool TimerAlarmIsSet = false;
+
+static TimerStats_t TimerStats = { 0 };
+
+/*!
+ * \brief Sets the RTC alarm for the next timer to expire, or stops it when no
+ *        timer is started
+ */
+static void TimerUpdateAlarm( void );
+
+/*!
+ * \brief Sets the RTC alarm for the next timer to expire
+ */
+static void TimerSetTimeout( void );
+
+/*!
+ * \brief Check if the Object to be added is not already in the queue
  *
- * \param [IN]  obj Timer object to be added to the list
- * \param [IN]  remainingTime Remaining time of the running head after which the object may be added
+ * \param [IN] obj Timer object
+ * \retval true (the object is already in the queue) or false
  */
-static void TimerInsertTimer( TimerEvent_t *obj );
+static bool TimerExists( TimerEvent_t *obj );
 
 /*!
- * \brief Sets a timeout with the duration "timestamp"
+ * \brief Removes the next timer to expire from the queue
  *
- * \param [IN] timestamp Delay duration
+ * \param [IN] expiredOnly Only removes it if its expiry time is reached
+ * \retval Removed timer, NULL if none
  */
-static void TimerSetTimeout( TimerEvent_t *obj );
+static TimerEvent_t *TimerQueuePop( bool expiredOnly );
 
 /*!
- * \brief Check if the Object to be added is not already in the list
+ * \brief Adds a timer to the queue
  *
- * \param [IN] timestamp Delay duration
- * \retval true (the object is already in the list) or false
+ * \param [IN] obj Timer object
+ * \retval false when the queue is full, the timer is not added
  */
-static bool TimerExists( TimerEvent_t *obj );
+static bool TimerQueueInsert( TimerEvent_t *obj );
+
+static void TimerQueueRemove( TimerEvent_t *obj );
+
+static void TimerQueueUp( uint16_t index );
+
+static void TimerQueueDown( uint16_t index );
+
+#if defined( TIMER_STATS_GET_CYCLES )
+static void TimerStatsMaskEnd( uint32_t maskStart );
+#endif
 
 void TimerInit( TimerEvent_t *obj, void ( *callback )( void *context ) )
 {
   obj->Timestamp = 0;
   obj->ReloadValue = 0;
   obj->IsStarted = false;
-  obj->IsNext2Expire = false;
+  obj->QueueIndex = TIMER_QUEUE_INDEX_NONE;
   obj->Callback = callback;
   obj->Context = NULL;
-  obj->Next = NULL;
 }
 
 void TimerSetContext( TimerEvent_t *obj, void* context )
@@ -112,44 +149,40 @@ void TimerSetContext( TimerEvent_t *obj, void* context )
   obj->Context = context;
 }
 
-void TimerStart( TimerEvent_t *obj )
+bool TimerStart( TimerEvent_t *obj )
 {
-  uint32_t elapsedTime = 0;
-  
+  bool started = true;
+
   BACKUP_PRIMASK();
   
   DISABLE_IRQ( );
-  
+  TIMER_STATS_MASK_BEGIN( );
 
-  if( ( obj == NULL ) || ( TimerExists( obj ) == true ) )
+  if( obj == NULL )
   {
-    RESTORE_PRIMASK( );
-    return;
+    started = false;
   }
-  obj->Timestamp = obj->ReloadValue;
-  obj->IsStarted = true;
-  obj->IsNext2Expire = false;
-
-  if( TimerListHead == NULL )
-  {
-    HW_RTC_SetTimerContext( );
-    TimerInsertNewHeadTimer( obj ); // insert a timeout at now+obj->Timestamp
-  }
-  else 
+  else if( TimerExists( obj ) == false )
   {
-    elapsedTime = HW_RTC_GetTimerElapsedTime( );
-    obj->Timestamp += elapsedTime;
-  
-    if( obj->Timestamp < TimerListHead->Timestamp )
+    if( TimerQueueLength == 0 )
     {
-      TimerInsertNewHeadTimer( obj);
+      HW_RTC_SetTimerContext( );
     }
-    else
+    obj->Timestamp = HW_RTC_GetTimerValue( ) + obj->ReloadValue;
+
+    /* a full queue leaves the timer stopped, the application sizes
+       TIMER_QUEUE_SIZE from TimerStats.QueueFullCount */
+    started = TimerQueueInsert( obj );
+    obj->IsStarted = started;
+    if( started == true )
     {
-      TimerInsertTimer( obj);
+      TimerUpdateAlarm( );
     }
   }
+
+  TIMER_STATS_MASK_END( );
   RESTORE_PRIMASK( );
+  return started;
 }
 
 
@@ -162,56 +195,35 @@ bool TimerIsStarted( TimerEvent_t *obj )
 void TimerIrqHandler( void )
 {
   TimerEvent_t* cur;
-  TimerEvent_t* next;
-  
 
-  
-  uint32_t old =  HW_RTC_GetTimerContext( );
-  uint32_t now =  HW_RTC_SetTimerContext( );
-  uint32_t DeltaContext = now - old; //intentionnal wrap around
-  
-  /* Update timeStamp based upon new Time Reference*/
-  /* because delta context should never exceed 2^32*/
-  if ( TimerListHead != NULL )
-  {
-    for (cur=TimerListHead; cur->Next != NULL; cur= cur->Next)
-    {
-      next =cur->Next;
-      if (next->Timestamp > DeltaContext)
-      {
-        next->Timestamp -= DeltaContext;
-      }
-      else
-      {
-        next->Timestamp = 0 ;
-      }
-    }
-  }
-  
+  HW_RTC_SetTimerContext( );
+  /* the alarm expired */
+  TimerAlarm = NULL;
+  TimerAlarmIsSet = false;
+
   /* execute imediately the alarm callback */
-  if ( TimerListHead != NULL )
+  cur = TimerQueuePop( false );
+  if( cur != NULL )
   {
-    cur = TimerListHead;
-    TimerListHead = TimerListHead->Next;
-    cur->IsStarted = false;
     exec_cb( cur->Callback, cur->Context );
   }
 
-
-  // remove all the expired object from the list
-  while( ( TimerListHead != NULL ) && ( TimerListHead->Timestamp < HW_RTC_GetTimerElapsedTime(  )  ))
+  // remove all the expired object from the queue
+  while( ( cur = TimerQueuePop( true ) ) != NULL )
   {
-   cur = TimerListHead;
-   TimerListHead = TimerListHead->Next;
-   cur->IsStarted = false;
-   exec_cb( cur->Callback, cur->Context );
+    exec_cb( cur->Callback, cur->Context );
   }
 
-  /* start the next TimerListHead if it exists AND NOT running */
-  if( ( TimerListHead != NULL ) && ( TimerListHead->IsNext2Expire == false ) )
-  {
-    TimerSetTimeout( TimerListHead );
-  }
+  /* start the next timer if it exists AND NOT running */
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ( );
+  TIMER_STATS_MASK_BEGIN( );
+
+  TimerUpdateAlarm( );
+
+  TIMER_STATS_MASK_END( );
+  RESTORE_PRIMASK( );
 }
 
 void TimerStop( TimerEvent_t *obj ) 
@@ -219,83 +231,29 @@ void TimerStop( TimerEvent_t *obj )
   BACKUP_PRIMASK();
   
   DISABLE_IRQ( );
-  
-  TimerEvent_t* prev = TimerListHead;
-  TimerEvent_t* cur = TimerListHead;
+  TIMER_STATS_MASK_BEGIN( );
 
-  // List is empty or the Obj to stop does not exist 
-  if( ( TimerListHead == NULL ) || ( obj == NULL ) )
+  if( obj != NULL )
   {
-    RESTORE_PRIMASK( );
-    return;
-  }
+    obj->IsStarted = false;
 
-  obj->IsStarted = false;
-
-  if( TimerListHead == obj ) // Stop the Head                  
-  {
-    if( TimerListHead->IsNext2Expire == true ) // The head is already running 
-    {  
-	  
-      TimerListHead->IsNext2Expire = false;
-      if( TimerListHead->Next != NULL )
-      {
-        TimerListHead = TimerListHead->Next;
-        TimerSetTimeout( TimerListHead );
-      }
-      else
-      {
-        HW_RTC_StopAlarm( );
-        TimerListHead = NULL;
-      }
-    }
-    else // Stop the head before it is started
-    {   
-      if( TimerListHead->Next != NULL )   
-      {
-        TimerListHead = TimerListHead->Next;
-      }
-      else
-      {
-        TimerListHead = NULL;
-      }
-    }
-  }
-  else // Stop an object within the list
-  {      
-    while( cur != NULL )
+    if( TimerExists( obj ) == true )
     {
-      if( cur == obj )
-      {
-        if( cur->Next != NULL )
-        {
-          cur = cur->Next;
-          prev->Next = cur;
-        }
-        else
-        {
-          cur = NULL;
-          prev->Next = cur;
-        }
-        break;
-      }
-      else
-      {
-        prev = cur;
-        cur = cur->Next;
-      }
-    }   
+      TimerQueueRemove( obj );
+      TimerUpdateAlarm( );
+    }
   }
-  
+
+  TIMER_STATS_MASK_END( );
   RESTORE_PRIMASK( );
 }  
   
 
 
-void TimerReset( TimerEvent_t *obj )
+bool TimerReset( TimerEvent_t *obj )
 {
   TimerStop( obj );
-  TimerStart( obj );
+  return TimerStart( obj );
 }
 
 void TimerSetValue( TimerEvent_t *obj, uint32_t value )
@@ -334,74 +292,192 @@ TimerTime_t TimerGetElapsedTime( TimerTime_t past )
   return HW_RTC_Tick2ms( nowInTicks- pastInTicks );
 }
 
-static bool TimerExists( TimerEvent_t *obj )
+TimerTime_t TimerTempCompensation( TimerTime_t period, float temperature )
+{
+    return RtcTempCompensation( period, temperature );
+}
+
+void TimerGetStats( TimerStats_t *stats )
 {
-  TimerEvent_t* cur = TimerListHead;
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ( );
+
+  *stats = TimerStats;
+
+  RESTORE_PRIMASK( );
+}
+
+void TimerResetStats( void )
+{
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ( );
+
+  TimerStats.MaxQueueLength = TimerQueueLength;
+  TimerStats.QueueFullCount = 0;
+  TimerStats.MaxIrqMaskedTime = 0;
+
+  RESTORE_PRIMASK( );
+}
 
-  while( cur != NULL )
+static void TimerUpdateAlarm( void )
+{
+  if( TimerQueueLength == 0 )
   {
-    if( cur == obj )
+    if( TimerAlarmIsSet == true )
     {
-      return true;
+      HW_RTC_StopAlarm( );
+      TimerAlarmIsSet = false;
     }
-    cur = cur->Next;
   }
-  return false;
+  else if( TimerQueue[0] != TimerAlarm )
+  {
+    TimerSetTimeout( );
+  }
 }
-static void TimerSetTimeout( TimerEvent_t *obj )
+
+static void TimerSetTimeout( void )
 {
-  int32_t minTicks= HW_RTC_GetMinimumTimeout( );
-  obj->IsNext2Expire = true; 
+  uint32_t minTicks = HW_RTC_GetMinimumTimeout( );
+  uint32_t elapsedTime = HW_RTC_GetTimerElapsedTime( );
+  uint32_t timeout = TimerQueue[0]->Timestamp - HW_RTC_GetTimerContext( );
+
+  TimerAlarm = TimerQueue[0];
+  TimerAlarmIsSet = true;
 
   // In case deadline too soon
-  if(obj->Timestamp  < (HW_RTC_GetTimerElapsedTime(  ) + minTicks) )
+  if( ( int32_t )( timeout - ( elapsedTime + minTicks ) ) < 0 )
   {
-    obj->Timestamp = HW_RTC_GetTimerElapsedTime(  ) + minTicks;
+    timeout = elapsedTime + minTicks;
   }
-  HW_RTC_SetAlarm( obj->Timestamp );
+  HW_RTC_SetAlarm( timeout );
 }
 
-TimerTime_t TimerTempCompensation( TimerTime_t period, float temperature )
+static bool TimerExists( TimerEvent_t *obj )
 {
-    return RtcTempCompensation( period, temperature );
+  return ( obj->QueueIndex < TimerQueueLength ) && ( TimerQueue[obj->QueueIndex] == obj );
+}
+
+static TimerEvent_t *TimerQueuePop( bool expiredOnly )
+{
+  TimerEvent_t* cur = NULL;
+
+  BACKUP_PRIMASK();
+
+  DISABLE_IRQ( );
+  TIMER_STATS_MASK_BEGIN( );
+
+  if( ( TimerQueueLength > 0 ) &&
+      ( ( expiredOnly == false ) || ( ( int32_t )( TimerQueue[0]->Timestamp - HW_RTC_GetTimerValue( ) ) <= 0 ) ) )
+  {
+    cur = TimerQueue[0];
+    TimerQueueRemove( cur );
+    cur->IsStarted = false;
+  }
+
+  TIMER_STATS_MASK_END( );
+  RESTORE_PRIMASK( );
+  return cur;
+}
+
+static bool TimerQueueInsert( TimerEvent_t *obj )
+{
+  if( TimerQueueLength >= TIMER_QUEUE_SIZE )
+  {
+    /* TIMER_QUEUE_SIZE is too small for the application */
+    TimerStats.QueueFullCount++;
+    return false;
+  }
+
+  TimerQueue[TimerQueueLength] = obj;
+  obj->QueueIndex = TimerQueueLength;
+  TimerQueueUp( TimerQueueLength++ );
+
+  if( TimerQueueLength > TimerStats.MaxQueueLength )
+  {
+    TimerStats.MaxQueueLength = TimerQueueLength;
+  }
+  return true;
+}
+
+static void TimerQueueRemove( TimerEvent_t *obj )
+{
+  uint16_t index = obj->QueueIndex;
+  TimerEvent_t* last = TimerQueue[--TimerQueueLength];
+
+  obj->QueueIndex = TIMER_QUEUE_INDEX_NONE;
+  if( obj == TimerAlarm )
+  {
+    /* a restart of obj needs a new alarm */
+    TimerAlarm = NULL;
+  }
+
+  if( last != obj )
+  {
+    /* move the last timer in the hole, then restore the order */
+    TimerQueue[index] = last;
+    last->QueueIndex = index;
+    TimerQueueUp( index );
+    TimerQueueDown( last->QueueIndex );
+  }
 }
 
+static void TimerQueueUp( uint16_t index )
+{
+  TimerEvent_t* obj = TimerQueue[index];
+  TimerEvent_t* parent;
 
-static void TimerInsertTimer( TimerEvent_t *obj)
+  while( index > 0 )
+  {
+    parent = TimerQueue[TIMER_QUEUE_PARENT( index )];
+    /* intentional wrap around */
+    if( ( int32_t )( obj->Timestamp - parent->Timestamp ) >= 0 )
+    {
+      break;
+    }
+    TimerQueue[index] = parent;
+    parent->QueueIndex = index;
+    index = TIMER_QUEUE_PARENT( index );
+  }
+  TimerQueue[index] = obj;
+  obj->QueueIndex = index;
+}
+
+static void TimerQueueDown( uint16_t index )
 {
-  TimerEvent_t* cur = TimerListHead;
-  TimerEvent_t* next = TimerListHead->Next;
+  TimerEvent_t* obj = TimerQueue[index];
+  uint16_t child;
 
-  while (cur->Next != NULL )
-  {  
-    if( obj->Timestamp  > next->Timestamp )
+  while( ( child = TIMER_QUEUE_LEFT( index ) ) < TimerQueueLength )
+  {
+    if( ( ( child + 1 ) < TimerQueueLength ) &&
+        ( ( int32_t )( TimerQueue[child + 1]->Timestamp - TimerQueue[child]->Timestamp ) < 0 ) )
     {
-        cur = next;
-        next = next->Next;
+      child++;
     }
-    else
+    if( ( int32_t )( TimerQueue[child]->Timestamp - obj->Timestamp ) >= 0 )
     {
-        cur->Next = obj;
-        obj->Next = next;
-        return;
-
+      break;
     }
+    TimerQueue[index] = TimerQueue[child];
+    TimerQueue[index]->QueueIndex = index;
+    index = child;
   }
-  cur->Next = obj;
-  obj->Next = NULL;
+  TimerQueue[index] = obj;
+  obj->QueueIndex = index;
 }
 
-static void TimerInsertNewHeadTimer( TimerEvent_t *obj )
+#if defined( TIMER_STATS_GET_CYCLES )
+static void TimerStatsMaskEnd( uint32_t maskStart )
 {
-  TimerEvent_t* cur = TimerListHead;
+  /* intentional wrap around */
+  uint32_t maskedTime = ( uint32_t )TIMER_STATS_GET_CYCLES( ) - maskStart;
 
-  if( cur != NULL )
+  if( maskedTime > TimerStats.MaxIrqMaskedTime )
   {
-    cur->IsNext2Expire = false;
+    TimerStats.MaxIrqMaskedTime = maskedTime;
   }
-
-  obj->Next = cur;
-  TimerListHead = obj;
-  TimerSetTimeout( TimerListHead );
 }
+#endif
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
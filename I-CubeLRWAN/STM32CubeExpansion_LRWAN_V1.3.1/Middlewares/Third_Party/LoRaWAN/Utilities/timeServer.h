@@ -50,17 +50,39 @@ Maintainer: Miguel Luis and Gregory Cristian
  */
 typedef struct TimerEvent_s
 {
-    uint32_t Timestamp;                  //! Expiring timer value in ticks from TimerContext
+    uint32_t Timestamp;                  //! Expiring RTC timer value in ticks, while started
     uint32_t ReloadValue;                //! Reload Value when Timer is restarted
     bool IsStarted;                      //! Is the timer currently running
-    bool IsNext2Expire;                  //! Is the next timer to expire
+    uint16_t QueueIndex;                 //! Position in the timer queue while started
     void ( *Callback )( void* context ); //! Timer IRQ callback function
     void *Context;                       //! User defined data object pointer to pass back
-    struct TimerEvent_s *Next;           //! Pointer to the next Timer object.
 }TimerEvent_t;
 
+/*!
+ * \brief Timer queue statistics
+ */
+typedef struct TimerStats_s
+{
+    uint32_t MaxQueueLength;             //! Highest number of timers started at once
+    uint32_t QueueFullCount;             //! TimerStart calls failed on a full queue
+    uint32_t MaxIrqMaskedTime;           //! Longest IRQ masked section, in TIMER_STATS_GET_CYCLES units
+}TimerStats_t;
+
 
 /* Exported constants --------------------------------------------------------*/
+/*!
+ * Maximum number of timers started at once, may be overridden in
+ * utilities_conf.h. The timers expire within 2^31 RTC ticks of each other.
+ * TimerStart fails when the queue is full, see TimerGetStats.
+ */
+#ifndef TIMER_QUEUE_SIZE
+#define TIMER_QUEUE_SIZE                            32
+#endif
+
+#if ( TIMER_QUEUE_SIZE < 1 ) || ( TIMER_QUEUE_SIZE > 0xFFFE )
+#error "TIMER_QUEUE_SIZE must be in [1, 0xFFFE], the queue index is 16-bit"
+#endif
+
 /* External variables --------------------------------------------------------*/
 /* Exported macros -----------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */ 
@@ -97,8 +119,11 @@ void TimerIrqHandler( void );
  * \brief Starts and adds the timer object to the list of timer events
  *
  * \param [IN] obj Structure containing the timer object parameters
+ *
+ * \retval status  [true: Started or already running,
+ *                  false: TIMER_QUEUE_SIZE timers already started]
  */
-void TimerStart( TimerEvent_t *obj );
+bool TimerStart( TimerEvent_t *obj );
 
 /*!
  * \brief Checks if the provided timer is running
@@ -121,8 +146,10 @@ void TimerStop( TimerEvent_t *obj );
  * \brief Resets the timer object
  *
  * \param [IN] obj Structure containing the timer object parameters
+ *
+ * \retval status  Status of the restart, see TimerStart
  */
-void TimerReset( TimerEvent_t *obj );
+bool TimerReset( TimerEvent_t *obj );
 
 /*!
  * \brief Set timer new timeout value
@@ -158,6 +185,22 @@ TimerTime_t TimerGetElapsedTime( TimerTime_t savedTime );
  */
 TimerTime_t TimerTempCompensation( TimerTime_t period, float temperature );
 
+/*!
+ * \brief Reads the timer queue statistics
+ *
+ * \note MaxIrqMaskedTime is measured when utilities_conf.h defines
+ *       TIMER_STATS_GET_CYCLES( ) returning a free running counter, e.g. the
+ *       DWT cycle counter of the Cortex-M3/M4. It stays 0 otherwise.
+ *
+ * \param [OUT] stats Statistics since startup or TimerResetStats
+ */
+void TimerGetStats( TimerStats_t *stats );
+
+/*!
+ * \brief Clears the timer queue statistics
+ */
+void TimerResetStats( void );
+
 #ifdef __cplusplus
 }
 #endif
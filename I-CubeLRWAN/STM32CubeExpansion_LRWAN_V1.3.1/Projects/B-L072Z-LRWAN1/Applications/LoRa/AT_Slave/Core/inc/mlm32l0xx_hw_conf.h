@@ -130,11 +130,13 @@ extern "C" {
 #define USARTx_IRQHandler                RNG_LPUART1_IRQHandler
 /* Definition for USARTx's DMA */
 #define USARTx_TX_DMA_CHANNEL             DMA1_Channel7
+#define USARTx_RX_DMA_CHANNEL             DMA1_Channel6
 
 /* Definition for USARTx's DMA Request */
 #define USARTx_TX_DMA_REQUEST             DMA_REQUEST_5
+#define USARTx_RX_DMA_REQUEST             DMA_REQUEST_5
 
-/* Definition for USARTx's NVIC */
+/* Definition for USARTx's NVIC, shared by the Tx and Rx DMA channels */
 #define USARTx_DMA_TX_IRQn                DMA1_Channel4_5_6_7_IRQn
 #define USARTx_DMA_TX_IRQHandler          DMA1_Channel4_5_6_7_IRQHandler
 
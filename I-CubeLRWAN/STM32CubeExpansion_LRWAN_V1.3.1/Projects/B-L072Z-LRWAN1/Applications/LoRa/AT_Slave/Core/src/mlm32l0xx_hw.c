@@ -459,6 +459,8 @@ void LPM_EnterStopMode(void)
 
   HW_AdcDeInit();
 
+  vcom_EnterStopMode();
+
   /*clear wake up flag*/
   SET_BIT(PWR->CR, PWR_CR_CWUF);
 
@@ -502,6 +504,8 @@ void LPM_ExitStopMode(void)
   /*initilizes the peripherals*/
   HW_IoInit();
 
+  vcom_ExitStopMode();
+
   RESTORE_PRIMASK();
 }
 
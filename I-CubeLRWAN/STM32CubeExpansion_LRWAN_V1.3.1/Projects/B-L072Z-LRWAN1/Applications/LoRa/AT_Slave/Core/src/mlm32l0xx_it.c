@@ -109,6 +109,7 @@ void USARTx_DMA_TX_IRQHandler(void)
 {
   vcom_DMA_TX_IRQHandler();
 
+  vcom_DMA_RX_IRQHandler();
 }
 
 /* Private functions ---------------------------------------------------------*/
@@ -31,10 +31,6 @@ extern "C" {
 /* Exported constants --------------------------------------------------------*/
 /* External variables --------------------------------------------------------*/
 /* Exported macros -----------------------------------------------------------*/
-
-/* Character added when a RX error has been detected */
-#define AT_ERROR_RX_CHAR 0x01
-
 /* Exported functions ------------------------------------------------------- */
 
 /**
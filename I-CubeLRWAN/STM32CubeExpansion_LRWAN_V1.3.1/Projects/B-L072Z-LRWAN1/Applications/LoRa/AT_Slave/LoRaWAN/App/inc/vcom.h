@@ -27,6 +27,16 @@ extern "C" {
 
 /* Includes ------------------------------------------------------------------*/
 /* Exported types ------------------------------------------------------------*/
+/**
+* @brief  status of the vcom receiver
+*/
+typedef enum
+{
+  VCOM_RX_OK = 0,
+  VCOM_RX_OVERFLOW,    /* characters lost, the receiver has not been read in time */
+  VCOM_RX_ERROR,       /* characters lost on a line error (frame, noise, overrun) */
+} vcom_RxStatus_t;
+
 /* Exported constants --------------------------------------------------------*/
 /* External variables --------------------------------------------------------*/
 
@@ -39,11 +49,46 @@ extern "C" {
 void vcom_Init(void (*Txcb)(void));
 
 /**
-* @brief  init receiver of vcom
-* @param  callback when Rx char is received
+* @brief  init receiver of vcom, the characters are received by DMA in a
+*         circular buffer and read with vcom_GetRxData
+* @param  None
+* @return None
+*/
+void vcom_ReceiveInit(void);
+
+/**
+* @brief  get the received characters not yet released
+* @note   when characters have been lost, the characters received before are
+*         flushed and the error is returned once
+* @param  p_data set to the first character
+* @param  size set to the number of contiguous characters, 0 if none
+* @return status of the receiver
+*/
+vcom_RxStatus_t vcom_GetRxData(const uint8_t **p_data, uint16_t *size);
+
+/**
+* @brief  release characters read with vcom_GetRxData, their place in the
+*         buffer can be reused
+* @param  size number of characters to release
+* @return None
+*/
+void vcom_ReleaseRxData(uint16_t size);
+
+/**
+* @brief  suspend the Rx DMA requests and enable the start bit wakeup before
+*         entering stop mode
+* @param  None
 * @return None
 */
-void vcom_ReceiveInit(void (*RxCb)(uint8_t *rxChar));
+void vcom_EnterStopMode(void);
+
+/**
+* @brief  disable the start bit wakeup and resume the Rx DMA requests when
+*         exiting stop mode
+* @param  None
+* @return None
+*/
+void vcom_ExitStopMode(void);
 
 /**
 * @brief  send buffer @p_data of size size to vcom in dma mode
@@ -88,6 +133,13 @@ void vcom_IRQHandler(void);
 */
 void vcom_DMA_TX_IRQHandler(void);
 
+/**
+* @brief  half or full Rx buffer has been written by the DMA
+* @param  None
+* @return None
+*/
+void vcom_DMA_RX_IRQHandler(void);
+
 #ifdef __cplusplus
 }
 #endif
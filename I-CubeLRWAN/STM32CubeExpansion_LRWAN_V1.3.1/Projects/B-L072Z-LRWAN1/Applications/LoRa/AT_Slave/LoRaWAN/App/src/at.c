@@ -211,6 +211,22 @@ static uint8_t ReceivedDataPort;
  */
 static ATEerror_t translate_status(LoRaMacStatus_t status);
 
+/**
+ * @brief  Get the value of an hexadecimal digit
+ * @param  The character to decode
+ * @retval The value of the digit, -1 if the character is not an hexadecimal digit
+ */
+static int hex_digit(char c);
+
+/**
+ * @brief  Get bytes values in hexa, separated by ':'
+ * @param  The string containing the bytes, something like ab:cd:01:...
+ * @param  The buffer that will contain the bytes read
+ * @param  The number of bytes to read
+ * @retval The number of bytes read
+ */
+static int sscanf_hhx_list(const char *from, uint8_t *pt, int nb);
+
 /**
  * @brief  Get 16 bytes values in hexa
  * @param  The string containing the 16 bytes, something like ab:cd:01:...
@@ -354,9 +370,7 @@ ATEerror_t at_JoinEUI_get(const char *param)
 ATEerror_t at_JoinEUI_set(const char *param)
 {
   uint8_t JoinEui[8];
-  if (tiny_sscanf(param, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx:%hhx:%hhx",
-                  &JoinEui[0], &JoinEui[1], &JoinEui[2], &JoinEui[3],
-                  &JoinEui[4], &JoinEui[5], &JoinEui[6], &JoinEui[7]) != 8)
+  if (sscanf_hhx_list(param, JoinEui, 8) != 8)
   {
     return AT_PARAM_ERROR;
   }
@@ -1164,7 +1178,8 @@ ATEerror_t at_SendBinary(const char *param)
   unsigned char bufSize = strlen(param);
   uint32_t appPort;
   unsigned size = 0;
-  char hex[3];
+  int high;
+  int low;
 
   /* read and set the application port */
   if (1 != tiny_sscanf(buf, "%u:", &appPort))
@@ -1192,15 +1207,15 @@ ATEerror_t at_SendBinary(const char *param)
     bufSize --;
   }
 
-  hex[2] = 0;
   while ((size < LORAWAN_APP_DATA_BUFF_SIZE) && (bufSize > 1))
   {
-    hex[0] = buf[size * 2];
-    hex[1] = buf[size * 2 + 1];
-    if (tiny_sscanf(hex, "%hhx", &AppData.Buff[size]) != 1)
+    high = hex_digit(buf[size * 2]);
+    low = hex_digit(buf[size * 2 + 1]);
+    if ((high < 0) || (low < 0))
     {
       return AT_PARAM_ERROR;
     }
+    AppData.Buff[size] = (uint8_t)((high << 4) | low);
     size++;
     bufSize -= 2;
   }
@@ -1450,12 +1465,52 @@ static ATEerror_t translate_status(LoRaMacStatus_t status)
   return AT_OK;
 }
 
+static int hex_digit(char c)
+{
+  if ((c >= '0') && (c <= '9'))
+  {
+    return c - '0';
+  }
+  c |= 0x20; /* lower case */
+  if ((c >= 'a') && (c <= 'f'))
+  {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+static int sscanf_hhx_list(const char *from, uint8_t *pt, int nb)
+{
+  int i;
+  int digit;
+  uint8_t value;
+
+  for (i = 0; i < nb; i++)
+  {
+    if ((i != 0) && (*from++ != ':'))
+    {
+      break;
+    }
+    digit = hex_digit(*from);
+    if (digit < 0)
+    {
+      break;
+    }
+    /* as %hhx, all the digits are read and the value is truncated to a byte */
+    value = 0;
+    do
+    {
+      value = (uint8_t)((value << 4) | digit);
+      digit = hex_digit(*++from);
+    } while (digit >= 0);
+    pt[i] = value;
+  }
+  return i;
+}
+
 static int sscanf_16_hhx(const char *from, uint8_t *pt)
 {
-  return tiny_sscanf(from, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx:%hhx:%hhx:%hhx:%hhx:%hhx:%hhx:%hhx:%hhx:%hhx:%hhx",
-                     &pt[0], &pt[1], &pt[2], &pt[3], &pt[4], &pt[5], &pt[6],
-                     &pt[7], &pt[8], &pt[9], &pt[10], &pt[11], &pt[12], &pt[13],
-                     &pt[14], &pt[15]);
+  return sscanf_hhx_list(from, pt, 16);
 }
 
 static void print_16_02x(uint8_t *pt)
@@ -1469,11 +1524,15 @@ static void print_16_02x(uint8_t *pt)
 
 static int sscanf_uint32_as_hhx(const char *from, uint32_t *value)
 {
-  return tiny_sscanf(from, "%hhx:%hhx:%hhx:%hhx",
-                     &((unsigned char *)(value))[3],
-                     &((unsigned char *)(value))[2],
-                     &((unsigned char *)(value))[1],
-                     &((unsigned char *)(value))[0]);
+  uint8_t bytes[4];
+  int nb = sscanf_hhx_list(from, bytes, 4);
+
+  if (nb == 4)
+  {
+    *value = ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) |
+             ((uint32_t)bytes[2] << 8) | bytes[3];
+  }
+  return nb;
 }
 
 static void print_uint32_as_02x(uint32_t value)
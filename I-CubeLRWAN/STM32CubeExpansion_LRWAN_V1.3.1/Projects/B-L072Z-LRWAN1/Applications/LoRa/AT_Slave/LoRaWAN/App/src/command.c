@@ -19,6 +19,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include <stdlib.h>
+#include <string.h>
 #include "at.h"
 #include "hw.h"
 #include "command.h"
@@ -45,9 +46,19 @@ struct ATCommand_s
 
 /* Private define ------------------------------------------------------------*/
 #define CMD_SIZE 270
-#define CIRC_BUFF_SIZE 8
 #define HELP_DISPLAY_FLUSH_DELAY 100
 
+/* Command lookup hash table: 2^CMD_HASH_BITS slots, more than the number of
+   commands. The seed makes the hash collision free on the command table, so a
+   lookup is a single probe; a command added later costs at most a few more.
+   The table is filled by CMD_Init() from ATCommand[] instead of being a
+   compile-time table: there is no generator in the build, and a table built at
+   run time follows the NO_KEY_ADDR_EUI and LORAMAC_CLASSB_ENABLED entries */
+#define CMD_HASH_BITS 7
+#define CMD_HASH_SIZE (1U << CMD_HASH_BITS)
+#define CMD_HASH_SEED 14645U
+#define CMD_HASH_EMPTY 0xFFU
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 
@@ -592,114 +603,97 @@ static const struct ATCommand_s ATCommand[] =
  */
 static void parse_cmd(const char *cmd);
 
-/* Exported functions ---------------------------------------------------------*/
-static void CMD_GetChar(uint8_t *rxChar);
+/**
+ * @brief  Hash a command string into a slot of the lookup table
+ * @param  The command string, after the "AT"
+ * @param  The size of the command string
+ * @retval The slot index
+ */
+static uint32_t cmd_hash(const char *cmd, uint32_t size);
+
+/**
+ * @brief  Fill the lookup table with the index of each AT Command
+ * @param  None
+ * @retval None
+ */
+static void cmd_hash_init(void);
 
-static char circBuffer[CIRC_BUFF_SIZE];
+/**
+ * @brief  Find an AT Command in the lookup table
+ * @param  The command string, after the "AT"
+ * @param  The size of the command string
+ * @retval The AT Command, NULL if not found
+ */
+static const struct ATCommand_s *cmd_find(const char *cmd, uint32_t size);
+
+/* Exported functions ---------------------------------------------------------*/
 static char command[CMD_SIZE];
 static unsigned i = 0;
-static uint32_t widx = 0;
-static uint32_t ridx = 0;
-static uint32_t charCount = 0;
-static FlagStatus circBuffOverflow = RESET;
+static uint8_t ATCommand_hash[CMD_HASH_SIZE];
 
 void CMD_Init(void)
 {
-  vcom_ReceiveInit(CMD_GetChar);
-  widx = 0;
-  ridx = 0;
-  charCount = 0;
+  vcom_ReceiveInit();
   i = 0;
-  circBuffOverflow = RESET;
-}
-
-static void CMD_GetChar(uint8_t *rxChar)
-{
-  charCount++;
-  if (charCount == (CIRC_BUFF_SIZE + 1))
-  {
-    circBuffOverflow = SET;
-    charCount--;
-  }
-  else
-  {
-    circBuffer[widx++] = *rxChar;
-    if (widx == CIRC_BUFF_SIZE)
-    {
-      widx = 0;
-    }
-  }
+  cmd_hash_init();
 }
 
 void CMD_Process(void)
 {
-  /* Process all commands */
-  if (circBuffOverflow == SET)
-  {
-    com_error(AT_TEST_PARAM_OVERFLOW);
-    /*Full flush in case of overflow */
-    CRITICAL_SECTION_BEGIN();
-    ridx = widx;
-    charCount = 0;
-    circBuffOverflow = RESET;
-    CRITICAL_SECTION_END();
-    i = 0;
-  }
+  const uint8_t *rxData;
+  uint16_t rxSize;
+  uint16_t n;
+  vcom_RxStatus_t rxStatus;
+  FlagStatus lineEnd;
 
-  while (charCount != 0)
+  /* Process all commands */
+  do
   {
-#if 0 /* echo On    */
-    PRINTF("%c", circBuffer[ridx]);
-#endif
-
-    if (circBuffer[ridx] == AT_ERROR_RX_CHAR)
+    /* the characters are read in place in the vcom DMA buffer */
+    rxStatus = vcom_GetRxData(&rxData, &rxSize);
+    if (rxStatus == VCOM_RX_OVERFLOW)
+    {
+      /* the vcom flushed all the received characters */
+      com_error(AT_TEST_PARAM_OVERFLOW);
+      i = 0;
+    }
+    else if (rxStatus == VCOM_RX_ERROR)
     {
-      ridx++;
-      if (ridx == CIRC_BUFF_SIZE)
-      {
-        ridx = 0;
-      }
-      CRITICAL_SECTION_BEGIN();
-      charCount--;
-      CRITICAL_SECTION_END();
       com_error(AT_RX_ERROR);
       i = 0;
     }
-    else if ((circBuffer[ridx] == '\r') || (circBuffer[ridx] == '\n'))
+
+    lineEnd = RESET;
+    for (n = 0; (n < rxSize) && (lineEnd == RESET); n++)
     {
-      ridx++;
-      if (ridx == CIRC_BUFF_SIZE)
+#if 0 /* echo On    */
+      PRINTF("%c", rxData[n]);
+#endif
+
+      if ((rxData[n] == '\r') || (rxData[n] == '\n'))
       {
-        ridx = 0;
+        lineEnd = (i != 0) ? SET : RESET;
       }
-      CRITICAL_SECTION_BEGIN();
-      charCount--;
-      CRITICAL_SECTION_END();
-
-      if (i != 0)
+      else if (i == (CMD_SIZE - 1))
       {
-        command[i] = '\0';
-        parse_cmd(command);
         i = 0;
+        com_error(AT_TEST_PARAM_OVERFLOW);
+      }
+      else
+      {
+        command[i++] = rxData[n];
       }
     }
-    else if (i == (CMD_SIZE - 1))
+
+    /* release the line before processing it, the DMA can go on meanwhile */
+    vcom_ReleaseRxData(n);
+    if (lineEnd == SET)
     {
+      command[i] = '\0';
+      parse_cmd(command);
       i = 0;
-      com_error(AT_TEST_PARAM_OVERFLOW);
     }
-    else
-    {
-      command[i++] = circBuffer[ridx++];
-      if (ridx == CIRC_BUFF_SIZE)
-      {
-        ridx = 0;
-      }
-      CRITICAL_SECTION_BEGIN();
-      charCount--;
-      CRITICAL_SECTION_END();
-    }
-  }
+  } while (rxSize != 0);
 }
 
 void com_error(ATEerror_t error_type)
@@ -717,7 +711,10 @@ static void parse_cmd(const char *cmd)
 {
   ATEerror_t status = AT_OK;
   const struct ATCommand_s *Current_ATCommand;
+  uint32_t size;
+#ifndef NO_HELP
   int i;
+#endif
 
   if ((cmd[0] != 'A') || (cmd[1] != 'T'))
   {
@@ -749,43 +746,39 @@ static void parse_cmd(const char *cmd)
     /* point to the start of the command, excluding AT */
     status = AT_ERROR;
     cmd += 2;
-    for (i = 0; i < (sizeof(ATCommand) / sizeof(struct ATCommand_s)); i++)
+    /* the command string ends where its parameters start */
+    size = strcspn(cmd, "=?");
+    Current_ATCommand = cmd_find(cmd, size);
+    if (Current_ATCommand != NULL)
     {
-      if (strncmp(cmd, ATCommand[i].string, ATCommand[i].size_string) == 0)
+      /* point to the string after the command to parse it */
+      cmd += size;
+
+      /* parse after the command */
+      switch (cmd[0])
       {
-        Current_ATCommand = &(ATCommand[i]);
-        /* point to the string after the command to parse it */
-        cmd += Current_ATCommand->size_string;
-
-        /* parse after the command */
-        switch (cmd[0])
-        {
-          case '\0':    /* nothing after the command */
-            status = Current_ATCommand->run(cmd);
-            break;
-          case '=':
-            if ((cmd[1] == '?') && (cmd[2] == '\0'))
-            {
-              status = Current_ATCommand->get(cmd + 1);
-            }
-            else
-            {
-              status = Current_ATCommand->set(cmd + 1);
-            }
-            break;
-          case '?':
-#ifndef NO_HELP
-            AT_PRINTF(Current_ATCommand->help_string);
-#endif
-            status = AT_OK;
-            break;
-          default:
-            /* not recognized */
-            break;
-        }
-
-        /* we end the loop as the command was found */
-        break;
+        case '\0':    /* nothing after the command */
+          status = Current_ATCommand->run(cmd);
+          break;
+        case '=':
+          if ((cmd[1] == '?') && (cmd[2] == '\0'))
+          {
+            status = Current_ATCommand->get(cmd + 1);
+          }
+          else
+          {
+            status = Current_ATCommand->set(cmd + 1);
+          }
+          break;
+        case '?':
+#ifndef NO_HELP
+          AT_PRINTF(Current_ATCommand->help_string);
+#endif
+          status = AT_OK;
+          break;
+        default:
+          /* not recognized */
+          break;
       }
     }
   }
@@ -793,4 +786,52 @@ static void parse_cmd(const char *cmd)
   com_error(status);
 }
 
+static uint32_t cmd_hash(const char *cmd, uint32_t size)
+{
+  /* FNV-1a, the slot is taken from the upper bits */
+  uint32_t hash = 2166136261U ^ CMD_HASH_SEED;
+
+  while (size-- != 0)
+  {
+    hash = (hash ^ (uint8_t)(*cmd++)) * 16777619U;
+  }
+  return hash >> (32 - CMD_HASH_BITS);
+}
+
+static void cmd_hash_init(void)
+{
+  uint32_t slot;
+  uint32_t i;
+
+  memset(ATCommand_hash, CMD_HASH_EMPTY, sizeof(ATCommand_hash));
+  for (i = 0; i < (sizeof(ATCommand) / sizeof(struct ATCommand_s)); i++)
+  {
+    /* linear probing in case of collision */
+    slot = cmd_hash(ATCommand[i].string, ATCommand[i].size_string);
+    while (ATCommand_hash[slot] != CMD_HASH_EMPTY)
+    {
+      slot = (slot + 1) & (CMD_HASH_SIZE - 1);
+    }
+    ATCommand_hash[slot] = i;
+  }
+}
+
+static const struct ATCommand_s *cmd_find(const char *cmd, uint32_t size)
+{
+  const struct ATCommand_s *Current_ATCommand;
+  uint32_t slot = cmd_hash(cmd, size);
+
+  while (ATCommand_hash[slot] != CMD_HASH_EMPTY)
+  {
+    Current_ATCommand = &(ATCommand[ATCommand_hash[slot]]);
+    if (((uint32_t)Current_ATCommand->size_string == size) &&
+        (strncmp(cmd, Current_ATCommand->string, size) == 0))
+    {
+      return Current_ATCommand;
+    }
+    slot = (slot + 1) & (CMD_HASH_SIZE - 1);
+  }
+  return NULL;
+}
+
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
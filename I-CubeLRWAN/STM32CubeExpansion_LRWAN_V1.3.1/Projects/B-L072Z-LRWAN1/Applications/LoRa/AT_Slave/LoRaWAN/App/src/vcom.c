@@ -22,17 +22,43 @@
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
+/* Size of the DMA circular reception buffer. The half and full transfer
+   interrupts must not be delayed by more than half of it */
+#define VCOM_RX_BUFF_SIZE 512
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 /* Uart Handle */
 static UART_HandleTypeDef UartHandle;
 
-uint8_t charRx;
-
 static void (*TxCpltCallback)(void);
 
-static void (*RxCpltCallback)(uint8_t *rxChar);
+/* Circular buffer written by the Rx DMA */
+static uint8_t RxBuffer[VCOM_RX_BUFF_SIZE];
+/* DMA write index at the last update */
+static uint16_t RxWriteIdx = 0;
+/* Index of the first character not yet released */
+static uint16_t RxReadIdx = 0;
+/* Number of characters received and not yet released */
+static uint16_t RxCount = 0;
+static vcom_RxStatus_t RxStatus = VCOM_RX_OK;
+
 /* Private function prototypes -----------------------------------------------*/
+/**
+* @brief  start the DMA reception at the beginning of the buffer
+* @param  None
+* @return None
+*/
+static void vcom_ReceiveStart(void);
+
+/**
+* @brief  account for the characters written by the DMA since the last update
+* @note   called with interrupts disabled or from the vcom interrupts
+* @param  None
+* @return None
+*/
+static void vcom_ReceiveUpdate(void);
+
 /* Functions Definition ------------------------------------------------------*/
 void vcom_Init(void (*TxCb)(void))
 {
@@ -78,32 +104,110 @@ void HAL_UART_TxCpltCallback(UART_HandleTypeDef *UartHandle)
   }
 }
 
-void vcom_ReceiveInit(void (*RxCb)(uint8_t *rxChar))
+void vcom_ReceiveInit(void)
 {
   UART_WakeUpTypeDef WakeUpSelection;
 
-  /*record call back*/
-  RxCpltCallback = RxCb;
-
   /*Set wakeUp event on start bit*/
   WakeUpSelection.WakeUpEvent = UART_WAKEUP_ON_STARTBIT;
 //
   HAL_UARTEx_StopModeWakeUpSourceConfig(&UartHandle, WakeUpSelection);
 
-  /*Enable wakeup from stop mode*/
+  /*Enable wakeup from stop mode, the WUF interrupt is only enabled in stop mode*/
   HAL_UARTEx_EnableStopMode(&UartHandle);
 
-  /*Start LPUART receive on IT*/
-  HAL_UART_Receive_IT(&UartHandle, &charRx, 1);
+  /*Start LPUART receive on circular DMA, the idle line ends the lines*/
+  vcom_ReceiveStart();
+  __HAL_UART_CLEAR_IDLEFLAG(&UartHandle);
+  __HAL_UART_ENABLE_IT(&UartHandle, UART_IT_IDLE);
+}
+
+vcom_RxStatus_t vcom_GetRxData(const uint8_t **p_data, uint16_t *size)
+{
+  vcom_RxStatus_t status;
+
+  CRITICAL_SECTION_BEGIN();
+  vcom_ReceiveUpdate();
+  status = RxStatus;
+  if (status == VCOM_RX_OVERFLOW)
+  {
+    /*Characters have been overwritten, flush all the received ones*/
+    RxReadIdx = RxWriteIdx;
+    RxCount = 0;
+  }
+  else if (status == VCOM_RX_ERROR)
+  {
+    /*The reception has been restarted at the beginning of the buffer*/
+    RxReadIdx = 0;
+  }
+  RxStatus = VCOM_RX_OK;
+  *size = RxCount;
+  CRITICAL_SECTION_END();
+
+  /*Only the characters up to the end of the buffer are contiguous*/
+  if (*size > (VCOM_RX_BUFF_SIZE - RxReadIdx))
+  {
+    *size = VCOM_RX_BUFF_SIZE - RxReadIdx;
+  }
+  *p_data = &RxBuffer[RxReadIdx];
+  return status;
+}
+
+void vcom_ReleaseRxData(uint16_t size)
+{
+  CRITICAL_SECTION_BEGIN();
+  /*Nothing to release if the characters have been flushed in between*/
+  if (RxStatus == VCOM_RX_OK)
+  {
+    RxReadIdx = (RxReadIdx + size) % VCOM_RX_BUFF_SIZE;
+    RxCount -= size;
+  }
+  CRITICAL_SECTION_END();
+}
+
+void vcom_EnterStopMode(void)
+{
+  /*The Rx DMA request must be disabled in stop mode*/
+  CLEAR_BIT(UartHandle.Instance->CR3, USART_CR3_DMAR);
+
+  /*There is no Rx interrupt to wake up in DMA mode, the start bit does*/
+  __HAL_UART_CLEAR_FLAG(&UartHandle, UART_CLEAR_WUF);
+  __HAL_UART_ENABLE_IT(&UartHandle, UART_IT_WUF);
+}
+
+void vcom_ExitStopMode(void)
+{
+  /*In run mode the DMA and the idle line handle the reception*/
+  __HAL_UART_DISABLE_IT(&UartHandle, UART_IT_WUF);
+  __HAL_UART_CLEAR_FLAG(&UartHandle, UART_CLEAR_WUF);
+
+  if (UartHandle.RxState == HAL_UART_STATE_BUSY_RX)
+  {
+    SET_BIT(UartHandle.Instance->CR3, USART_CR3_DMAR);
+  }
+}
+
+void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef *UartHandle)
+{
+  vcom_ReceiveUpdate();
 }
 
 void HAL_UART_RxCpltCallback(UART_HandleTypeDef *UartHandle)
 {
-  if ((NULL != RxCpltCallback) && (HAL_UART_ERROR_NONE == UartHandle->ErrorCode))
+  /*Circular mode: the DMA goes on at the beginning of the buffer*/
+  vcom_ReceiveUpdate();
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *UartHandle)
+{
+  /*A line error aborts the reception, restart it*/
+  if (UartHandle->RxState == HAL_UART_STATE_READY)
   {
-    RxCpltCallback(&charRx);
+    RxWriteIdx = 0;
+    RxCount = 0;
+    RxStatus = VCOM_RX_ERROR;
+    vcom_ReceiveStart();
   }
-  HAL_UART_Receive_IT(UartHandle, &charRx, 1);
 }
 
 void vcom_DMA_TX_IRQHandler(void)
@@ -111,8 +215,20 @@ void vcom_DMA_TX_IRQHandler(void)
   HAL_DMA_IRQHandler(UartHandle.hdmatx);
 }
 
+void vcom_DMA_RX_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(UartHandle.hdmarx);
+}
+
 void vcom_IRQHandler(void)
 {
+  /*Idle line: the end of the received characters, not handled by the HAL*/
+  if ((__HAL_UART_GET_FLAG(&UartHandle, UART_FLAG_IDLE) != RESET) &&
+      (__HAL_UART_GET_IT_SOURCE(&UartHandle, UART_IT_IDLE) != RESET))
+  {
+    __HAL_UART_CLEAR_IDLEFLAG(&UartHandle);
+    vcom_ReceiveUpdate();
+  }
   HAL_UART_IRQHandler(&UartHandle);
 }
 
@@ -124,6 +240,7 @@ void vcom_DeInit(void)
 void HAL_UART_MspInit(UART_HandleTypeDef *huart)
 {
   static DMA_HandleTypeDef hdma_tx;
+  static DMA_HandleTypeDef hdma_rx;
 
 
   /*##-1- Enable peripherals and GPIO Clocks #################################*/
@@ -164,8 +281,25 @@ void HAL_UART_MspInit(UART_HandleTypeDef *huart)
   /* Associate the initialized DMA handle to the UART handle */
   __HAL_LINKDMA(huart, hdmatx, hdma_tx);
 
+  /* Configure the DMA handler for reception process, in circular mode */
+  hdma_rx.Instance                 = USARTx_RX_DMA_CHANNEL;
+  hdma_rx.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+  hdma_rx.Init.PeriphInc           = DMA_PINC_DISABLE;
+  hdma_rx.Init.MemInc              = DMA_MINC_ENABLE;
+  hdma_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+  hdma_rx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+  hdma_rx.Init.Mode                = DMA_CIRCULAR;
+  hdma_rx.Init.Priority            = DMA_PRIORITY_HIGH;
+#ifndef STM32L152xE
+  hdma_rx.Init.Request             = USARTx_RX_DMA_REQUEST;
+#endif
+  HAL_DMA_Init(&hdma_rx);
+
+  /* Associate the initialized DMA handle to the UART handle */
+  __HAL_LINKDMA(huart, hdmarx, hdma_rx);
+
   /*##-4- Configure the NVIC for DMA #########################################*/
-  /* NVIC configuration for DMA transfer complete interrupt*/
+  /* NVIC configuration for DMA transfer complete interrupt, Tx and Rx channels share it*/
   HAL_NVIC_SetPriority(USARTx_DMA_TX_IRQn, USARTx_Priority, 1);
   HAL_NVIC_EnableIRQ(USARTx_DMA_TX_IRQn);
 
@@ -234,4 +368,28 @@ void vcom_IoDeInit(void)
   GPIO_InitStructure.Pin =  USARTx_RX_PIN ;
   HAL_GPIO_Init(USARTx_RX_GPIO_PORT, &GPIO_InitStructure);
 }
+
+/* Private functions ---------------------------------------------------------*/
+
+static void vcom_ReceiveStart(void)
+{
+  HAL_UART_Receive_DMA(&UartHandle, RxBuffer, VCOM_RX_BUFF_SIZE);
+}
+
+static void vcom_ReceiveUpdate(void)
+{
+  uint16_t writeIdx;
+
+  /*NDTR counts down from the buffer size, and is reloaded at the end*/
+  writeIdx = (VCOM_RX_BUFF_SIZE - __HAL_DMA_GET_COUNTER(UartHandle.hdmarx)) % VCOM_RX_BUFF_SIZE;
+
+  /*No more than half the buffer between two updates, the difference is not ambiguous*/
+  RxCount += (writeIdx + VCOM_RX_BUFF_SIZE - RxWriteIdx) % VCOM_RX_BUFF_SIZE;
+  RxWriteIdx = writeIdx;
+  if (RxCount > VCOM_RX_BUFF_SIZE)
+  {
+    /*Characters not yet released have been overwritten*/
+    RxStatus = VCOM_RX_OVERFLOW;
+  }
+}
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
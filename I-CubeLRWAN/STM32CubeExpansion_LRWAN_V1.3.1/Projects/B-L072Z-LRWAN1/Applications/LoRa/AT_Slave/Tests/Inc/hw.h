@@ -0,0 +1,53 @@
+/**
+  ******************************************************************************
+  * @file    hw.h
+  * @author  MCD Application Team
+  * @brief   Host replacement of the hardware interface for the AT tests
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HW_H__
+#define __HW_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "util_console.h"
+#include "vcom.h"
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum
+{
+  RESET = 0,
+  SET = !RESET
+} FlagStatus;
+
+/* Exported macros -----------------------------------------------------------*/
+#define CRITICAL_SECTION_BEGIN( )
+#define CRITICAL_SECTION_END( )
+
+#define DelayMs( ms )
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HW_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,60 @@
+/**
+  ******************************************************************************
+  * @file    util_console.h
+  * @author  MCD Application Team
+  * @brief   Host replacement of the console for the AT tests, the output is
+  *          appended to ConsoleOutput
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __UTIL_CONSOLE_H__
+#define __UTIL_CONSOLE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define CONSOLE_OUTPUT_SIZE 4096
+
+/* External variables --------------------------------------------------------*/
+extern char ConsoleOutput[CONSOLE_OUTPUT_SIZE];
+extern int ConsoleQuiet;
+
+/* Exported macros -----------------------------------------------------------*/
+#define PRINTF(...)                                                                   \
+  do                                                                                  \
+  {                                                                                   \
+    if (ConsoleQuiet == 0)                                                            \
+    {                                                                                 \
+      size_t length_ = strlen(ConsoleOutput);                                         \
+      snprintf(ConsoleOutput + length_, sizeof(ConsoleOutput) - length_, __VA_ARGS__); \
+    }                                                                                 \
+  } while (0)
+
+#define PPRINTF(...) PRINTF(__VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTIL_CONSOLE_H__ */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,266 @@
+/**
+  ******************************************************************************
+  * @file    at_test.c
+  * @author  MCD Application Team
+  * @brief   Host test of the AT command parser of command.c
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+/*
+ * command.c is included with the AT handlers replaced by stubs recording their
+ * name and parameter. Each line of the session file goes through parse_cmd and
+ * gives a transcript line:
+ *   [<command>] <handler called> +<parameter offset in the command> <response>
+ * which must match the reference file. The references were recorded with the
+ * parser searching ATCommand[] linearly, before the lookup table. The test
+ * also checks every entry of ATCommand[] is found by its own string, then
+ * measures the parse time of a command over the session.
+ *
+ * Usage: at_test <session> <reference> [rounds]
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "command.c"
+
+/* Private define ------------------------------------------------------------*/
+#define SESSION_MAX_LINES                           256
+#define LINE_SIZE                                   512
+
+#define AT_STUB( handler, status )                  \
+  ATEerror_t handler( const char *param )           \
+  {                                                 \
+    LastHandler = #handler;                         \
+    LastParam = param;                              \
+    return status;                                  \
+  }
+
+/* Private variables ---------------------------------------------------------*/
+static const char *LastHandler;
+static const char *LastParam;
+
+char ConsoleOutput[CONSOLE_OUTPUT_SIZE];
+int ConsoleQuiet = 0;
+
+static char Session[SESSION_MAX_LINES][LINE_SIZE];
+static uint32_t SessionLines = 0;
+
+/* Private functions ---------------------------------------------------------*/
+AT_STUB( at_ADR_get, AT_OK )
+AT_STUB( at_ADR_set, AT_OK )
+AT_STUB( at_AppKey_get, AT_OK )
+AT_STUB( at_AppKey_set, AT_OK )
+AT_STUB( at_AppSKey_get, AT_OK )
+AT_STUB( at_AppSKey_set, AT_OK )
+AT_STUB( at_BeaconFreq_get, AT_OK )
+AT_STUB( at_BeaconGatewayCoordinate_get, AT_OK )
+AT_STUB( at_BeaconTime_get, AT_OK )
+AT_STUB( at_Certif, AT_OK )
+AT_STUB( at_DataRate_get, AT_OK )
+AT_STUB( at_DataRate_set, AT_OK )
+AT_STUB( at_DevAddr_get, AT_OK )
+AT_STUB( at_DevAddr_set, AT_OK )
+AT_STUB( at_DevEUI_get, AT_OK )
+AT_STUB( at_DeviceClass_get, AT_OK )
+AT_STUB( at_DeviceClass_set, AT_OK )
+AT_STUB( at_DutyCycle_get, AT_OK )
+AT_STUB( at_DutyCycle_set, AT_OK )
+AT_STUB( at_Join, AT_OK )
+AT_STUB( at_JoinAcceptDelay1_get, AT_OK )
+AT_STUB( at_JoinAcceptDelay1_set, AT_OK )
+AT_STUB( at_JoinAcceptDelay2_get, AT_OK )
+AT_STUB( at_JoinAcceptDelay2_set, AT_OK )
+AT_STUB( at_JoinEUI_get, AT_OK )
+AT_STUB( at_JoinEUI_set, AT_OK )
+AT_STUB( at_LocalTime_get, AT_OK )
+AT_STUB( at_NetworkID_get, AT_OK )
+AT_STUB( at_NetworkID_set, AT_OK )
+AT_STUB( at_NetworkJoinMode_get, AT_OK )
+AT_STUB( at_NetworkJoinMode_set, AT_OK )
+AT_STUB( at_NetworkJoinStatus, AT_OK )
+AT_STUB( at_NwkSKey_get, AT_OK )
+AT_STUB( at_NwkSKey_set, AT_OK )
+AT_STUB( at_PingSlot_get, AT_OK )
+AT_STUB( at_PingSlot_set, AT_OK )
+AT_STUB( at_PublicNetwork_get, AT_OK )
+AT_STUB( at_PublicNetwork_set, AT_OK )
+AT_STUB( at_Receive, AT_OK )
+AT_STUB( at_ReceiveBinary, AT_OK )
+AT_STUB( at_Rx1Delay_get, AT_OK )
+AT_STUB( at_Rx1Delay_set, AT_OK )
+AT_STUB( at_Rx2DataRate_get, AT_OK )
+AT_STUB( at_Rx2DataRate_set, AT_OK )
+AT_STUB( at_Rx2Delay_get, AT_OK )
+AT_STUB( at_Rx2Delay_set, AT_OK )
+AT_STUB( at_Rx2Frequency_get, AT_OK )
+AT_STUB( at_Rx2Frequency_set, AT_OK )
+AT_STUB( at_Send, AT_OK )
+AT_STUB( at_SendBinary, AT_OK )
+AT_STUB( at_TransmitPower_get, AT_OK )
+AT_STUB( at_TransmitPower_set, AT_OK )
+AT_STUB( at_ack_get, AT_OK )
+AT_STUB( at_ack_set, AT_OK )
+AT_STUB( at_bat_get, AT_OK )
+AT_STUB( at_isack_get, AT_OK )
+AT_STUB( at_reset, AT_OK )
+AT_STUB( at_return_error, AT_ERROR )
+AT_STUB( at_return_ok, AT_OK )
+AT_STUB( at_rssi_get, AT_OK )
+AT_STUB( at_snr_get, AT_OK )
+AT_STUB( at_test_get_lora_config, AT_OK )
+AT_STUB( at_test_rxTone, AT_OK )
+AT_STUB( at_test_rxlora, AT_OK )
+AT_STUB( at_test_set_lora_config, AT_OK )
+AT_STUB( at_test_stop, AT_OK )
+AT_STUB( at_test_txTone, AT_OK )
+AT_STUB( at_test_txlora, AT_OK )
+AT_STUB( at_version_get, AT_OK )
+
+void vcom_ReceiveInit( void )
+{
+}
+
+vcom_RxStatus_t vcom_GetRxData( const uint8_t **p_data, uint16_t *size )
+{
+  *p_data = NULL;
+  *size = 0;
+  return VCOM_RX_OK;
+}
+
+void vcom_ReleaseRxData( uint16_t size )
+{
+  ( void )size;
+}
+
+/* Reads the lines of a file, without their end of line */
+static uint32_t ReadLines( const char *path, char lines[][LINE_SIZE], uint32_t max )
+{
+  FILE *file = fopen( path, "r" );
+  uint32_t n = 0;
+
+  if( file == NULL )
+  {
+    printf( "cannot open %s\n", path );
+    exit( 1 );
+  }
+  while( ( n < max ) && ( fgets( lines[n], LINE_SIZE, file ) != NULL ) )
+  {
+    lines[n][strcspn( lines[n], "\r\n" )] = '\0';
+    n++;
+  }
+  fclose( file );
+  return n;
+}
+
+/* Parses a command and writes its transcript line, the response on one line */
+static void Transcript( const char *cmd, char *line )
+{
+  size_t length;
+
+  LastHandler = "-";
+  LastParam = cmd;
+  ConsoleOutput[0] = '\0';
+  parse_cmd( cmd );
+
+  length = snprintf( line, LINE_SIZE, "[%s] %s +%ld ", cmd, LastHandler, ( long )( LastParam - cmd ) );
+  for( const char *c = ConsoleOutput; ( *c != '\0' ) && ( length < ( LINE_SIZE - 3 ) ); c++ )
+  {
+    if( *c == '\r' )
+    {
+      line[length++] = '\\';
+      line[length++] = 'r';
+    }
+    else if( *c == '\n' )
+    {
+      line[length++] = '\\';
+      line[length++] = 'n';
+    }
+    else
+    {
+      line[length++] = *c;
+    }
+  }
+  line[length] = '\0';
+}
+
+int main( int argc, char *argv[] )
+{
+  static char reference[SESSION_MAX_LINES][LINE_SIZE];
+  char line[LINE_SIZE];
+  uint32_t rounds = ( argc > 3 ) ? ( uint32_t )strtoul( argv[3], NULL, 0 ) : 200000;
+  uint32_t references;
+  uint32_t failures = 0;
+  struct timespec start;
+  struct timespec end;
+  double ns;
+
+  if( argc < 3 )
+  {
+    printf( "usage: at_test <session> <reference> [rounds]\n" );
+    return 1;
+  }
+  SessionLines = ReadLines( argv[1], Session, SESSION_MAX_LINES );
+  references = ReadLines( argv[2], reference, SESSION_MAX_LINES );
+  if( references != SessionLines )
+  {
+    printf( "%u commands, %u reference lines\n", ( unsigned )SessionLines, ( unsigned )references );
+    failures++;
+  }
+
+  CMD_Init( );
+
+  /* same handler, parameter and response as the reference */
+  for( uint32_t n = 0; ( n < SessionLines ) && ( n < references ); n++ )
+  {
+    Transcript( Session[n], line );
+    if( strcmp( line, reference[n] ) != 0 )
+    {
+      printf( "line %u:\n  got      %s\n  expected %s\n", ( unsigned )( n + 1 ), line, reference[n] );
+      failures++;
+    }
+  }
+
+  /* every command of the table is found */
+  for( uint32_t n = 0; n < ( sizeof( ATCommand ) / sizeof( ATCommand[0] ) ); n++ )
+  {
+    if( cmd_find( ATCommand[n].string, ATCommand[n].size_string ) != &ATCommand[n] )
+    {
+      printf( "AT%s not found\n", ATCommand[n].string );
+      failures++;
+    }
+  }
+
+  /* parse time, without the console output */
+  ConsoleQuiet = 1;
+  clock_gettime( CLOCK_MONOTONIC, &start );
+  for( uint32_t r = 0; r < rounds; r++ )
+  {
+    for( uint32_t n = 0; n < SessionLines; n++ )
+    {
+      parse_cmd( Session[n] );
+    }
+  }
+  clock_gettime( CLOCK_MONOTONIC, &end );
+  ConsoleQuiet = 0;
+  ns = ( ( end.tv_sec - start.tv_sec ) * 1e9 ) + ( end.tv_nsec - start.tv_nsec );
+
+  printf( "%u commands of %s, %u table entries: %u failures, %.1f ns per command\n", ( unsigned )SessionLines,
+          argv[1], ( unsigned )( sizeof( ATCommand ) / sizeof( ATCommand[0] ) ), ( unsigned )failures,
+          ns / ( ( double )rounds * SessionLines ) );
+
+  return ( failures == 0 ) ? 0 : 1;
+}
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -25,6 +25,7 @@
 #include "timeServer.h"
 #include "vcom.h"
 #include "version.h"
+#include "payload_codec.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -41,6 +42,25 @@
 #define LPP_DATATYPE_TEMPERATURE    0x67
 #define LPP_DATATYPE_BAROMETER      0x73
 #define LPP_APP_PORT 99
+/*!
+ * COMPACT_PAYLOAD sends several readings per uplink, delta coded with payload_codec.c.
+ * The readings are taken every APP_TX_DUTYCYCLE.
+ */
+//#define COMPACT_PAYLOAD
+#define COMPACT_APP_PORT                            3
+#define COMPACT_NB_CHANNELS                         4
+/*!
+ * A single reading is sent on COMPACT_FIXED_APP_PORT in a fixed layout when the
+ * delta frame is not smaller: temperature, pressure and humidity on 2 bytes,
+ * battery level on 1 byte, MSB first
+ */
+#define COMPACT_FIXED_APP_PORT                      4
+#define COMPACT_FIXED_SIZE                          7
+/*!
+ * Maximum number of readings in a COMPACT_PAYLOAD uplink, fewer are sent when
+ * the maximum payload of the datarate is reached
+ */
+#define APP_READINGS_PER_UPLINK                     6
 /*!
  * Defines the application data transmission duty cycle. 5s, value in [ms].
  */
@@ -83,6 +103,13 @@ static uint8_t AppDataBuff[LORAWAN_APP_DATA_BUFF_SIZE];
 //static lora_AppData_t AppData={ AppDataBuff,  0 ,0 };
 lora_AppData_t AppData = { AppDataBuff,  0, 0 };
 
+#ifdef COMPACT_PAYLOAD
+/*!
+ * Readings of the next uplink
+ */
+static payload_codec_t AppCodec;
+#endif
+
 /* Private macro -------------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 
@@ -104,6 +131,11 @@ static uint8_t LORA_GetBatteryLevel(void);
 /* LoRa endNode send request*/
 static void Send(void *context);
 
+#ifdef COMPACT_PAYLOAD
+/* set the port of the COMPACT_PAYLOAD frame, returns its size*/
+static uint8_t CompactFrame(void);
+#endif
+
 /* start the tx process*/
 static void LoraStartTx(TxEventType_t EventType);
 
@@ -184,6 +216,10 @@ int main(void)
 
   LORA_Join();
 
+#ifdef COMPACT_PAYLOAD
+  PayloadCodec_Init(&AppCodec, AppData.Buff, LORAWAN_APP_DATA_BUFF_SIZE, COMPACT_NB_CHANNELS);
+#endif
+
   LoraStartTx(TX_ON_TIMER) ;
 
   while (1)
@@ -252,7 +288,7 @@ static void Send(void *context)
   }
 
   TVL1(PRINTF("SEND REQUEST\n\r");)
-#ifndef CAYENNE_LPP
+#if !defined( CAYENNE_LPP ) && !defined( COMPACT_PAYLOAD )
   int32_t latitude, longitude = 0;
   uint16_t altitudeGps = 0;
 #endif
@@ -269,7 +305,54 @@ static void Send(void *context)
 
   BSP_sensor_Read(&sensor_data);
 
-#ifdef CAYENNE_LPP
+#if defined( COMPACT_PAYLOAD )
+  int32_t readings[COMPACT_NB_CHANNELS];
+  uint8_t maxSize = LORA_GetMaxPayloadSize();
+
+  temperature = (int16_t)(sensor_data.temperature * 100);         /* in C * 100 */
+  pressure    = (uint16_t)(sensor_data.pressure * 100 / 10);      /* in hPa / 10 */
+  humidity    = (uint16_t)(sensor_data.humidity * 10);            /* in %*10     */
+  batteryLevel = LORA_GetBatteryLevel();                      /* 1 (very low) to 254 (fully charged) */
+
+  readings[0] = temperature;
+  readings[1] = pressure;
+  readings[2] = humidity;
+  readings[3] = batteryLevel;
+
+  if (PayloadCodec_Add(&AppCodec, readings, maxSize) != 0)
+  {
+    /* No room left at the current datarate: send the frame, the reading starts the next one */
+    if (PayloadCodec_GetSize(&AppCodec) != 0)
+    {
+      AppData.BuffSize = CompactFrame();
+      LORA_send(&AppData, LORAWAN_DEFAULT_CONFIRM_MSG_STATE);
+
+      PayloadCodec_Init(&AppCodec, AppData.Buff, LORAWAN_APP_DATA_BUFF_SIZE, COMPACT_NB_CHANNELS);
+      if (PayloadCodec_Add(&AppCodec, readings, maxSize) == 0)
+      {
+        return;
+      }
+    }
+    if (maxSize < COMPACT_FIXED_SIZE)
+    {
+      /* The reading exceeds the maximum payload even in the fixed layout, e.g. with pending MAC commands */
+      TVL1(PRINTF("READING DROPPED, MAX PAYLOAD %d\n\r", maxSize);)
+      return;
+    }
+    /* The reading alone only fits in the fixed layout */
+    PayloadCodec_Add(&AppCodec, readings, LORAWAN_APP_DATA_BUFF_SIZE);
+  }
+  else if (AppCodec.nb_readings < APP_READINGS_PER_UPLINK)
+  {
+    /* Wait for the next readings */
+    return;
+  }
+
+  uint32_t i = CompactFrame();
+
+  /* The frame stays in AppData.Buff until the next reading */
+  PayloadCodec_Init(&AppCodec, AppData.Buff, LORAWAN_APP_DATA_BUFF_SIZE, COMPACT_NB_CHANNELS);
+#elif defined( CAYENNE_LPP )
   uint8_t cchannel = 0;
   temperature = (int16_t)(sensor_data.temperature * 10);         /* in C * 10 */
   pressure    = (uint16_t)(sensor_data.pressure * 100 / 10);      /* in hPa / 10 */
@@ -353,6 +436,31 @@ static void Send(void *context)
 }
 
 
+#ifdef COMPACT_PAYLOAD
+static uint8_t CompactFrame(void)
+{
+  uint16_t size = PayloadCodec_GetSize(&AppCodec);
+  const int32_t *reading = AppCodec.prev;
+
+  if ((AppCodec.nb_readings == 1) && (size >= COMPACT_FIXED_SIZE))
+  {
+    /* The frame header and the absolute values only pay off over several readings */
+    AppData.Buff[0] = (reading[0] >> 8) & 0xFF;
+    AppData.Buff[1] = reading[0] & 0xFF;
+    AppData.Buff[2] = (reading[1] >> 8) & 0xFF;
+    AppData.Buff[3] = reading[1] & 0xFF;
+    AppData.Buff[4] = (reading[2] >> 8) & 0xFF;
+    AppData.Buff[5] = reading[2] & 0xFF;
+    AppData.Buff[6] = reading[3] & 0xFF;
+    AppData.Port = COMPACT_FIXED_APP_PORT;
+    return COMPACT_FIXED_SIZE;
+  }
+
+  AppData.Port = COMPACT_APP_PORT;
+  return size;
+}
+#endif
+
 static void LORA_RxData(lora_AppData_t *AppData)
 {
   /* USER CODE BEGIN 4 */
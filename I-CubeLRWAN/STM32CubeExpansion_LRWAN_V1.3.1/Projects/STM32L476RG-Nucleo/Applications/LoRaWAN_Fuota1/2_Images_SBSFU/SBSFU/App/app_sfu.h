@@ -71,6 +71,20 @@ extern "C" {
 #define SFU_ENCRYPTED_IMAGE (0U) /*!< The Firmware Image to be installed is downloaded in ENCRYPTED format */
 #define SFU_CLEAR_IMAGE     (1U) /*!< The Firmware Image to be installed is downloaded in CLEAR format */
 
+/*#define SFU_IMG_STREAMED_VERIFY*/  /*!< Uncomment this define to verify the decrypted Firmware Image while it is
+                                          written instead of in a dedicated FLASH pass before installing it.
+                                          When defined, the image tag is computed on the decrypted chunks while they
+                                          are written (with AES-GCM the tag is checked by the decryption itself):
+                                          the installation reads the image once less. The installed image is still
+                                          verified at each boot */
+
+/*#define SFU_IMG_BOOT_CACHE*/       /*!< Uncomment this define to skip the tag computation of the active Firmware at
+                                          boot when it has already been verified with the current protections.
+                                          The verification is recorded once in slot #0 after the VALID tags and the
+                                          boots using it are counted in a backup register */
+#define SFU_IMG_BOOT_CACHE_PERIOD (64U) /*!< Number of boots relying on the boot cache between 2 full verifications
+                                             of the active Firmware (1 to 65535) */
+
 /**
   * @}
   */
@@ -21,12 +21,14 @@
 #define SFU_FWIMG_CORE_C
 
 /* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
 #include <string.h>
 #include "main.h"
 #include "sfu_fsm_states.h" /* needed for sfu_error.h */
 #include "sfu_error.h"
 #include "sfu_low_level_flash.h"
 #include "sfu_low_level_security.h"
+#include "sfu_low_level.h"
 #include "se_interface_bootloader.h"
 #include "sfu_fwimg_regions.h"
 #include "sfu_fwimg_services.h" /* to have definitions like SFU_IMG_InitStatusTypeDef
@@ -69,6 +71,7 @@
   */
 #define VALID_SIZE (3*MAGIC_LENGTH)
 #define CHUNK_SIZE_SIGN_VERIFICATION (1024U)  /*!< Signature verification chunk size*/
+#define CHUNK_SIZE_COMPARE (64U)  /*!< Unchanged block detection chunk size*/
 #define SFU_IMG_CHUNK_SIZE  (512U)
 
 /**
@@ -119,6 +122,35 @@
 
 #define AES_BLOCK_SIZE (16U)  /*!< Size of an AES block to check padding needs for decrypting */
 
+/**
+  * @brief Delta partial image.
+  * The partial FW image is a patch when the Reserved field of its FW header starts with a delta descriptor.
+  * The patch rebuilds the new FW from PartialFwOffset to its end, taking the unchanged parts from the active FW in
+  * slot #0. It is a sequence of commands: a command byte (bit 7: COPY or INSERT, bits 6..0: length, 0 when the
+  * length follows as a LEB128 varint), followed by the inserted bytes for an INSERT or by the zigzag LEB128
+  * displacement of the slot #0 source from the source cursor for a COPY. The source cursor starts at PartialFwOffset
+  * and moves forward with each command.
+  */
+#define SFU_IMG_DELTA_MAGIC      (0x44554653U)  /*!< "SFUD" */
+#define SFU_IMG_DELTA_TAG_LEN    (16U)          /*!< Bytes of the active FW tag kept in the delta descriptor */
+#define SFU_IMG_DELTA_COPY       (0x80U)        /*!< COPY command flag */
+#define SFU_IMG_DELTA_LEN_MASK   (0x7FU)        /*!< Length of a command, 0 if it follows as a varint */
+
+#if defined(SFU_IMG_BOOT_CACHE)
+/**
+  * @brief Boot cache.
+  * The boot cache record is programmed in slot #0 after the VALID tags, in the header area which is only written by
+  * SBSFU. It is erased with the header when a new FW is installed, and revoked when slot #0 is invalidated.
+  * The backup register keeps the first 2 bytes of the FW tag (bits 31:16) and the number of boots relying on the
+  * record since the last full verification (bits 15:0).
+  */
+#define SFU_IMG_BOOT_CACHE_MAGIC (0x43554653U)  /*!< "SFUC" */
+#define SFU_IMG_BOOT_CACHE_ADDR  ((uint8_t *)((uint32_t)SFU_IMG_SLOT_0_REGION_BEGIN + \
+                                              ((FW_INFO_TOT_LEN + VALID_SIZE + sizeof(SFU_LL_FLASH_write_t) - 1U) & \
+                                               ~(sizeof(SFU_LL_FLASH_write_t) - 1U))))
+#define SFU_IMG_BOOT_CACHE_COUNTER(TAG, N) ((((uint32_t)(TAG)[0]) << 24U) | (((uint32_t)(TAG)[1]) << 16U) | (N))
+#endif /* SFU_IMG_BOOT_CACHE */
+
 /**
   * @}
   */
@@ -128,6 +160,47 @@
   * @{
   */
 
+/**
+  * Delta descriptor, at the beginning of the Reserved field of the FW header of a patch
+  */
+typedef struct
+{
+  uint32_t DeltaMagic;                        /*!< SFU_IMG_DELTA_MAGIC */
+  uint32_t TargetSize;                        /*!< Size of the FW rebuilt by the patch, from PartialFwOffset */
+  uint8_t  SourceTag[SFU_IMG_DELTA_TAG_LEN];  /*!< Beginning of the FW tag of the FW the patch applies to */
+} SFU_IMG_DeltaDescTypeDef;
+
+/**
+  * Patch application state
+  */
+typedef struct
+{
+  uint8_t *pPatch;                            /*!< Copy of the patch in slot #1 */
+  uint32_t PatchSize;                         /*!< Size of the patch */
+  uint32_t PatchRead;                         /*!< Number of patch bytes loaded in PatchChunk */
+  uint32_t PatchIndex;                        /*!< Next byte to decode in PatchChunk */
+  uint32_t PatchFill;                         /*!< Number of valid bytes in PatchChunk */
+  uint32_t Start;                             /*!< Offset of the rebuilt FW in the swap area */
+  uint32_t Position;                          /*!< Number of bytes rebuilt */
+  uint32_t Fill;                              /*!< Number of rebuilt bytes pending in Chunk */
+  uint8_t  PatchChunk[SFU_IMG_CHUNK_SIZE] __attribute__((aligned(4)));
+  uint8_t  Chunk[SFU_IMG_CHUNK_SIZE] __attribute__((aligned(4)));
+} SFU_IMG_DeltaStreamTypeDef;
+
+#if defined(SFU_IMG_BOOT_CACHE)
+/**
+  * Boot cache record, programmed in one write up to Magic so that a valid magic means a complete record
+  */
+typedef struct
+{
+  uint32_t ProtectionState[SFU_PROTECTION_STATE_LEN]; /*!< Static protections when the FW was verified */
+  uint8_t  FwTag[SE_TAG_LEN];                         /*!< Tag of the verified FW */
+  uint32_t Magic;                                     /*!< SFU_IMG_BOOT_CACHE_MAGIC */
+  uint32_t Reserved;                                  /*!< Left erased */
+  SFU_LL_FLASH_write_t Revoked;                       /*!< Programmed when slot #0 is invalidated */
+} SFU_IMG_BootCacheTypeDef;
+#endif /* SFU_IMG_BOOT_CACHE */
+
 /**
   * @}
   */
@@ -147,6 +220,13 @@ static uint8_t fw_header_to_test[FW_INFO_TOT_LEN] __attribute__((aligned(4)));
 static uint8_t fw_header_validated[FW_INFO_TOT_LEN] __attribute__((aligned(4)));
 static uint8_t fw_tag_validated[SE_TAG_LEN];
 
+#if defined(SFU_IMG_BOOT_CACHE)
+/**
+  * Set when the boot counter of the boot cache has been updated for this boot
+  */
+static uint32_t boot_cache_counted = 0U;
+#endif /* SFU_IMG_BOOT_CACHE */
+
 /**
   * @}
   */
@@ -485,6 +565,7 @@ static SFU_ErrorStatus CheckHeaderValidated(uint8_t *phdr)
 }
 
 
+#if !defined(SFU_IMG_STREAMED_VERIFY)
 /**
   * @brief  Verify image signature of binary not contiguous in flash
   * @param  pSeStatus pointer giving the SE status result
@@ -564,6 +645,7 @@ static SFU_ErrorStatus VerifyFwSignatureScatter(SE_StatusTypeDef *pSeStatus, SE_
   /* Signature Verification */
   return VerifyTagScatter(pSeStatus, pFwImageHeader, pPayloadDesc, SE_FwType);
 }
+#endif /* !SFU_IMG_STREAMED_VERIFY */
 
 
 /**
@@ -704,6 +786,7 @@ static SFU_ErrorStatus EraseSlotIndex(uint32_t SlotNumber, uint32_t index)
   return e_ret_status;
 }
 
+#if !defined(SFU_IMG_STREAMED_VERIFY)
 /**
   * @brief  Verify image signature of binary after decryption
   * @param  pSeStatus pointer giving the SE status result
@@ -725,6 +808,440 @@ static SFU_ErrorStatus VerifyFwSignatureAfterDecrypt(SE_StatusTypeDef *pSeStatus
   return VerifyFwSignatureScatter(pSeStatus, pFwImageHeader, &payload_desc, SE_FW_IMAGE_PARTIAL);
 }
 
+#else
+/**
+  * @brief  Verify image signature computed during decryption
+  * @note   The tag is computed by @ref DecryptImageInSlot1 on the decrypted chunks, this avoids reading the decrypted
+  *         image again. With AES-GCM, the tag has already been checked when finishing the decryption.
+  * @param  pSeStatus pointer giving the SE status result
+  * @param  pFwImageHeader pointer to fw header
+  * @retval SFU_SUCCESS if successful, a SFU_ErrorStatus error otherwise.
+  */
+static SFU_ErrorStatus VerifyFwSignatureStreamed(SE_StatusTypeDef *pSeStatus, SE_FwRawHeaderTypeDef *pFwImageHeader)
+{
+  SFU_ErrorStatus e_ret_status = SFU_ERROR;
+#if (SECBOOT_CRYPTO_SCHEME != SECBOOT_AES128_GCM_AES128_GCM_AES128_GCM)
+  SE_ErrorStatus se_ret_status;
+  uint8_t fw_tag_output[SE_TAG_LEN] __attribute__((aligned(4)));
+  int32_t fw_tag_len = sizeof(fw_tag_output);
+
+  se_ret_status = SE_AuthenticateFW_Finish(pSeStatus, fw_tag_output, &fw_tag_len);
+  if ((se_ret_status == SE_SUCCESS) && (*pSeStatus == SE_OK) && (fw_tag_len == SE_TAG_LEN))
+  {
+    /* Firmware tag verification */
+    e_ret_status = MemoryCompare(fw_tag_output, pFwImageHeader->PartialFwTag, SE_TAG_LEN);
+    if (e_ret_status != SFU_SUCCESS)
+    {
+      *pSeStatus = SE_SIGNATURE_ERR;
+    }
+  }
+#else
+  *pSeStatus = SE_OK;
+  e_ret_status = SFU_SUCCESS;
+#endif /* SECBOOT_CRYPTO_SCHEME */
+
+  if (e_ret_status == SFU_SUCCESS)
+  {
+    FLOW_STEP(uFlowCryptoValue, FLOW_STEP_INTEGRITY);
+    memcpy(fw_tag_validated, pFwImageHeader->PartialFwTag, SE_TAG_LEN);
+  }
+  else
+  {
+    memset(fw_tag_validated, 0x00, SE_TAG_LEN);
+  }
+  return e_ret_status;
+}
+#endif /* SFU_IMG_STREAMED_VERIFY */
+
+/**
+  * @brief  Get the delta descriptor of a FW header.
+  * @param  pFwImageHeader pointer to fw header
+  * @param  pDelta pointer to the delta descriptor to fill
+  * @retval SFU_SUCCESS if the partial FW image is a patch, SFU_ERROR otherwise.
+  */
+static SFU_ErrorStatus GetDeltaDescriptor(SE_FwRawHeaderTypeDef *pFwImageHeader, SFU_IMG_DeltaDescTypeDef *pDelta)
+{
+  memcpy(pDelta, pFwImageHeader->Reserved, sizeof(SFU_IMG_DeltaDescTypeDef));
+  return (pDelta->DeltaMagic == SFU_IMG_DELTA_MAGIC) ? SFU_SUCCESS : SFU_ERROR;
+}
+
+/**
+  * @brief  Size of the partial FW image once prepared for the swap.
+  * @note   This is the size of the FW range rebuilt by the patch for a delta image, the partial FW size otherwise.
+  * @param  pFwImageHeader pointer to fw header
+  * @retval Size in bytes.
+  */
+static uint32_t PartialImageSize(SE_FwRawHeaderTypeDef *pFwImageHeader)
+{
+  SFU_IMG_DeltaDescTypeDef delta;
+
+  if (GetDeltaDescriptor(pFwImageHeader, &delta) == SFU_SUCCESS)
+  {
+    return delta.TargetSize;
+  }
+  return pFwImageHeader->PartialFwSize;
+}
+
+/**
+  * @brief  Check that a delta image applies to the active FW.
+  * @note   The delta descriptor is authenticated with the FW header.
+  * @param  pFwImageHeader pointer to fw header
+  * @retval SFU_SUCCESS if the patch can be applied, SFU_ERROR otherwise.
+  */
+static SFU_ErrorStatus CheckDeltaImage(SE_FwRawHeaderTypeDef *pFwImageHeader)
+{
+  SFU_IMG_DeltaDescTypeDef delta;
+
+  (void)GetDeltaDescriptor(pFwImageHeader, &delta);
+  if ((delta.TargetSize == 0U) || (delta.TargetSize > pFwImageHeader->FwSize)
+      || ((pFwImageHeader->PartialFwOffset + delta.TargetSize) != pFwImageHeader->FwSize))
+  {
+    return SFU_ERROR;
+  }
+  return MemoryCompare(delta.SourceTag, fw_image_header_validated.FwTag, SFU_IMG_DELTA_TAG_LEN);
+}
+
+/**
+  * @brief  Address of a byte of the partial FW image prepared for the swap.
+  * @note   The partial FW image starts in the swap area and continues at the beginning of slot #1.
+  * @param  Start offset of the partial FW image in the swap area
+  * @param  Position position of the byte in the partial FW image
+  * @retval Address in FLASH.
+  */
+static uint8_t *PartialImageAddress(uint32_t Start, uint32_t Position)
+{
+  if ((Start + Position) < SFU_IMG_SWAP_REGION_SIZE)
+  {
+    return (uint8_t *)((uint32_t)SFU_IMG_SWAP_REGION_BEGIN + Start + Position);
+  }
+  return (uint8_t *)((uint32_t)SFU_IMG_SLOT_1_REGION_BEGIN + Start + Position - SFU_IMG_SWAP_REGION_SIZE);
+}
+
+/**
+  * @brief  Read the next byte of the patch.
+  * @param  pStream pointer to the patch application state
+  * @param  pByte pointer to the byte read
+  * @retval SFU_SUCCESS if successful, SFU_ERROR at the end of the patch or on FLASH error.
+  */
+static SFU_ErrorStatus DeltaReadByte(SFU_IMG_DeltaStreamTypeDef *pStream, uint8_t *pByte)
+{
+  if (pStream->PatchIndex == pStream->PatchFill)
+  {
+    pStream->PatchFill = pStream->PatchSize - pStream->PatchRead;
+    if (pStream->PatchFill > SFU_IMG_CHUNK_SIZE)
+    {
+      pStream->PatchFill = SFU_IMG_CHUNK_SIZE;
+    }
+    if ((pStream->PatchFill == 0U)
+        || (SFU_LL_FLASH_Read(pStream->PatchChunk, pStream->pPatch + pStream->PatchRead, pStream->PatchFill)
+            != SFU_SUCCESS))
+    {
+      return SFU_ERROR;
+    }
+    pStream->PatchRead += pStream->PatchFill;
+    pStream->PatchIndex = 0U;
+  }
+  *pByte = pStream->PatchChunk[pStream->PatchIndex];
+  pStream->PatchIndex++;
+  return SFU_SUCCESS;
+}
+
+/**
+  * @brief  Read a LEB128 varint from the patch.
+  * @note   A varint is at most 5 bytes, and its value must fit in 32 bits.
+  * @param  pStream pointer to the patch application state
+  * @param  pValue pointer to the value read
+  * @retval SFU_SUCCESS if successful, SFU_ERROR otherwise.
+  */
+static SFU_ErrorStatus DeltaReadVarint(SFU_IMG_DeltaStreamTypeDef *pStream, uint32_t *pValue)
+{
+  uint8_t byte;
+  uint32_t shift = 0U;
+
+  *pValue = 0U;
+  do
+  {
+    if ((shift > 28U) || (DeltaReadByte(pStream, &byte) != SFU_SUCCESS))
+    {
+      return SFU_ERROR;
+    }
+    if ((shift == 28U) && ((byte & 0x7FU) > 0x0FU))
+    {
+      return SFU_ERROR;
+    }
+    *pValue |= (uint32_t)(byte & 0x7FU) << shift;
+    shift += 7U;
+  } while ((byte & 0x80U) != 0U);
+  return SFU_SUCCESS;
+}
+
+/**
+  * @brief  Account for rebuilt bytes added to the chunk, and write the chunk when it is complete.
+  * @note   Chunks follow the layout of the decrypted image: the first one ends on a SFU_IMG_CHUNK_SIZE boundary of
+  *         the swap area, so a chunk never spans the swap area and slot #1.
+  * @param  pStream pointer to the patch application state
+  * @param  Size number of bytes added to the chunk
+  * @param  TargetSize size of the rebuilt FW
+  * @retval SFU_SUCCESS if successful, SFU_ERROR otherwise.
+  */
+static SFU_ErrorStatus DeltaWrite(SFU_IMG_DeltaStreamTypeDef *pStream, uint32_t Size, uint32_t TargetSize)
+{
+  SFU_ErrorStatus e_ret_status = SFU_SUCCESS;
+  SFU_FLASH_StatusTypeDef flash_if_status;
+  uint32_t size;
+
+  pStream->Position += Size;
+  pStream->Fill += Size;
+  if ((((pStream->Start + pStream->Position) % SFU_IMG_CHUNK_SIZE) == 0U) || (pStream->Position == TargetSize))
+  {
+    /* Set dimension to the appropriate length for FLASH programming */
+    size = pStream->Fill;
+    while ((size % (uint32_t)sizeof(SFU_LL_FLASH_write_t)) != 0U)
+    {
+      pStream->Chunk[size] = 0xFFU;
+      size++;
+    }
+    e_ret_status = SFU_LL_FLASH_Write(&flash_if_status, PartialImageAddress(pStream->Start,
+                                                                            pStream->Position - pStream->Fill),
+                                      pStream->Chunk, size);
+    StatusFWIMG(e_ret_status == SFU_ERROR, SFU_IMG_FLASH_WRITE_FAILED);
+    pStream->Fill = 0U;
+  }
+  return e_ret_status;
+}
+
+/**
+  * @brief  Rebuild the new FW from a decrypted delta image.
+  * @note   The patch is first moved to the end of slot #1, before the trailer block, then the rebuilt FW is written
+  *         in the swap area and slot #1 with the layout of a decrypted partial image, so the swap procedure handles
+  *         it as a partial image of PartialImageSize() bytes.
+  *         The active FW in slot #0 is only read: if this step is interrupted the candidate image is lost as for an
+  *         interrupted decryption, the active FW is kept.
+  * @param  pFwImageHeader pointer to fw header
+  * @retval SFU_SUCCESS if successful, a SFU_ErrorStatus error otherwise.
+  */
+static SFU_ErrorStatus ApplyDeltaInSlot1(SE_FwRawHeaderTypeDef *pFwImageHeader)
+{
+  SFU_ErrorStatus e_ret_status = SFU_SUCCESS;
+  SFU_FLASH_StatusTypeDef flash_if_status;
+  SFU_IMG_DeltaDescTypeDef delta;
+  SFU_IMG_DeltaStreamTypeDef stream;
+  uint32_t number_of_index_slot1 = SFU_IMG_SLOT_1_REGION_SIZE / SFU_IMG_SWAP_REGION_SIZE;
+  uint32_t index_patch_begin;
+  uint32_t index_patch_end;
+  uint32_t index_target_end;
+  uint32_t index;
+  uint32_t position;
+  uint32_t size;
+  uint32_t length;
+  uint32_t source;
+  uint32_t value;
+  uint8_t command;
+
+  (void)GetDeltaDescriptor(pFwImageHeader, &delta);
+  memset(&stream, 0x00, sizeof(stream));
+  stream.Start = (SFU_IMG_IMAGE_OFFSET + (pFwImageHeader->PartialFwOffset % SFU_IMG_SWAP_REGION_SIZE)) %
+                 SFU_IMG_SWAP_REGION_SIZE;
+  stream.PatchSize = pFwImageHeader->PartialFwSize;
+
+  /*
+   * Slot #1 blocks used by the decrypted patch and by the rebuilt FW (the first part of both is in the swap area),
+   * and first block of the copy of the patch: they must not overlap.
+   */
+  index_patch_end = (stream.Start + stream.PatchSize + SFU_IMG_SWAP_REGION_SIZE - 1U) / SFU_IMG_SWAP_REGION_SIZE - 1U;
+  index_target_end = (stream.Start + delta.TargetSize + SFU_IMG_SWAP_REGION_SIZE - 1U) / SFU_IMG_SWAP_REGION_SIZE - 1U;
+  index = (stream.PatchSize + SFU_IMG_SWAP_REGION_SIZE - 1U) / SFU_IMG_SWAP_REGION_SIZE;
+  if ((index + 1U) > number_of_index_slot1)
+  {
+    return SFU_ERROR;
+  }
+  index_patch_begin = number_of_index_slot1 - 1U - index;
+  if ((index_patch_end > index_patch_begin) || (index_target_end > index_patch_begin))
+  {
+#if defined(SFU_VERBOSE_DEBUG_MODE)
+    TRACE("\r\n\t  Slot #1 too small to apply the patch.");
+#endif /* SFU_VERBOSE_DEBUG_MODE */
+    return SFU_ERROR;
+  }
+  stream.pPatch = (uint8_t *)((uint32_t)SFU_IMG_SLOT_1_REGION_BEGIN + (index_patch_begin * SFU_IMG_SWAP_REGION_SIZE));
+
+  /* Move the patch */
+  for (index = index_patch_begin; (index < (number_of_index_slot1 - 1U)) && (e_ret_status == SFU_SUCCESS); index++)
+  {
+    SFU_LL_SECU_IWDG_Refresh();
+    e_ret_status = EraseSlotIndex(1U, index);
+  }
+  for (position = 0U; (position < stream.PatchSize) && (e_ret_status == SFU_SUCCESS); position += size)
+  {
+    size = stream.PatchSize - position;
+    if (size > SFU_IMG_CHUNK_SIZE)
+    {
+      size = SFU_IMG_CHUNK_SIZE;
+    }
+    /* The part in the swap area and the part in slot #1 are read separately */
+    length = size;
+    if (((stream.Start + position) < SFU_IMG_SWAP_REGION_SIZE)
+        && ((stream.Start + position + size) > SFU_IMG_SWAP_REGION_SIZE))
+    {
+      length = SFU_IMG_SWAP_REGION_SIZE - (stream.Start + position);
+      e_ret_status = SFU_LL_FLASH_Read(&stream.Chunk[length], PartialImageAddress(stream.Start, position + length),
+                                       size - length);
+    }
+    if (e_ret_status == SFU_SUCCESS)
+    {
+      e_ret_status = SFU_LL_FLASH_Read(stream.Chunk, PartialImageAddress(stream.Start, position), length);
+    }
+    if (e_ret_status == SFU_SUCCESS)
+    {
+      length = size;
+      while ((length % (uint32_t)sizeof(SFU_LL_FLASH_write_t)) != 0U)
+      {
+        stream.Chunk[length] = 0xFFU;
+        length++;
+      }
+      e_ret_status = SFU_LL_FLASH_Write(&flash_if_status, stream.pPatch + position, stream.Chunk, length);
+      StatusFWIMG(e_ret_status == SFU_ERROR, SFU_IMG_FLASH_WRITE_FAILED);
+    }
+  }
+
+  /* Make room for the rebuilt FW */
+  if (e_ret_status == SFU_SUCCESS)
+  {
+    SFU_LL_SECU_IWDG_Refresh();
+    e_ret_status = SFU_LL_FLASH_Erase_Size(&flash_if_status, (void *)SFU_IMG_SWAP_REGION_BEGIN,
+                                           SFU_IMG_SWAP_REGION_SIZE);
+    StatusFWIMG(e_ret_status == SFU_ERROR, SFU_IMG_FLASH_ERASE_FAILED);
+  }
+  for (index = 0U; (index < index_target_end) && (e_ret_status == SFU_SUCCESS); index++)
+  {
+    SFU_LL_SECU_IWDG_Refresh();
+    e_ret_status = EraseSlotIndex(1U, index);
+  }
+
+  /* Apply the patch */
+  source = pFwImageHeader->PartialFwOffset;
+  while ((stream.Position < delta.TargetSize) && (e_ret_status == SFU_SUCCESS))
+  {
+    e_ret_status = DeltaReadByte(&stream, &command);
+    length = command & SFU_IMG_DELTA_LEN_MASK;
+    if ((e_ret_status == SFU_SUCCESS) && (length == 0U))
+    {
+      e_ret_status = DeltaReadVarint(&stream, &length);
+    }
+    if ((e_ret_status == SFU_SUCCESS) && ((command & SFU_IMG_DELTA_COPY) != 0U))
+    {
+      /* Zigzag decoding of the source displacement */
+      e_ret_status = DeltaReadVarint(&stream, &value);
+      source += ((value & 1U) != 0U) ? (0U - ((value + 1U) >> 1)) : (value >> 1);
+      if ((source > fw_image_header_validated.FwSize) || (length > (fw_image_header_validated.FwSize - source)))
+      {
+        e_ret_status = SFU_ERROR;
+      }
+    }
+    if ((length == 0U) || (length > (delta.TargetSize - stream.Position)))
+    {
+      e_ret_status = SFU_ERROR;
+    }
+
+    while ((length > 0U) && (e_ret_status == SFU_SUCCESS))
+    {
+      /* Fill the chunk up to its end */
+      size = SFU_IMG_CHUNK_SIZE - ((stream.Start + stream.Position) % SFU_IMG_CHUNK_SIZE);
+      if (size > length)
+      {
+        size = length;
+      }
+      if ((command & SFU_IMG_DELTA_COPY) != 0U)
+      {
+        e_ret_status = SFU_LL_FLASH_Read(&stream.Chunk[stream.Fill], (uint8_t *)((uint32_t)SFU_IMG_SLOT_0_REGION_BEGIN
+                                         + SFU_IMG_IMAGE_OFFSET + source), size);
+      }
+      else
+      {
+        for (position = 0U; (position < size) && (e_ret_status == SFU_SUCCESS); position++)
+        {
+          e_ret_status = DeltaReadByte(&stream, &stream.Chunk[stream.Fill + position]);
+        }
+      }
+      if (e_ret_status == SFU_SUCCESS)
+      {
+        e_ret_status = DeltaWrite(&stream, size, delta.TargetSize);
+      }
+      source += size;
+      length -= size;
+    }
+  }
+
+#if defined(SFU_VERBOSE_DEBUG_MODE)
+  TRACE("\r\n\t  %d bytes rebuilt from a %d bytes patch.", stream.Position, stream.PatchSize);
+#endif /* SFU_VERBOSE_DEBUG_MODE */
+
+  return e_ret_status;
+}
+
+
+/**
+  * @brief  Check if a block of slot #0 already holds its content in the image being installed.
+  * @note   Only the bytes taken from the updated image and the empty bytes following the final image can differ:
+  *         the other bytes of the block are kept from the initial image.
+  * @param  IndexSlot0 index of the block in slot #0
+  * @param  IndexSlot1Read index of the block of the updated image in slot #1, -1 for the swap area
+  * @param  Begin offset of the first byte taken from the updated image in the block
+  * @param  End offset of the first byte following the bytes taken from the updated image in the block
+  * @param  FinalEnd offset of the first empty byte in the block, SFU_IMG_SWAP_REGION_SIZE if none
+  * @retval SFU_SUCCESS if the block is unchanged, SFU_ERROR otherwise.
+  */
+static SFU_ErrorStatus CompareSlot0Block(int32_t IndexSlot0, int32_t IndexSlot1Read, uint32_t Begin, uint32_t End,
+                                         uint32_t FinalEnd)
+{
+  uint8_t buffer_slot0[CHUNK_SIZE_COMPARE] __attribute__((aligned(4)));
+  uint8_t buffer_update[CHUNK_SIZE_COMPARE] __attribute__((aligned(4)));
+  uint8_t *pupdate;
+  uint32_t offset = Begin;
+  uint32_t limit;
+  uint32_t length;
+
+  pupdate = (IndexSlot1Read == -1) ? SFU_IMG_SWAP_REGION_BEGIN : CHUNK_1_ADDR(IndexSlot1Read, 0);
+  if (End > FinalEnd)
+  {
+    End = FinalEnd;
+  }
+
+  while (offset < SFU_IMG_SWAP_REGION_SIZE)
+  {
+    /* Bytes kept from the initial image */
+    if ((offset >= End) && (offset < FinalEnd))
+    {
+      offset = FinalEnd;
+    }
+    else
+    {
+      limit = (offset < End) ? End : SFU_IMG_SWAP_REGION_SIZE;
+      length = ((limit - offset) < CHUNK_SIZE_COMPARE) ? (limit - offset) : CHUNK_SIZE_COMPARE;
+      if (SFU_LL_FLASH_Read(buffer_slot0, CHUNK_0_ADDR(IndexSlot0, 0) + offset, length) != SFU_SUCCESS)
+      {
+        return SFU_ERROR;
+      }
+      if (offset < End)
+      {
+        if (SFU_LL_FLASH_Read(buffer_update, pupdate + offset, length) != SFU_SUCCESS)
+        {
+          return SFU_ERROR;
+        }
+      }
+      else
+      {
+        memset(buffer_update, 0xFF, length);
+      }
+      if (memcmp(buffer_slot0, buffer_update, length) != 0)
+      {
+        return SFU_ERROR;
+      }
+      offset += length;
+    }
+  }
+  return SFU_SUCCESS;
+}
 
 /**
   * @brief  Swap Slot 0 with decrypted FW to install
@@ -735,6 +1252,8 @@ static SFU_ErrorStatus VerifyFwSignatureAfterDecrypt(SE_StatusTypeDef *pSeStatus
   *         Each of these blocks is swapped using smaller chunks of SFU_IMG_CHUNK_SIZE size.
   *         The swap starts from the tail of the image and ends with the beginning of the image ("swap from tail to
   *         head").
+  *         A block of slot #0 which already holds its final content (unchanged between both images) is not swapped:
+  *         it is only marked as swapped in the trailer.
   * @param  None.
   * @retval SFU_SUCCESS if successful, a SFU_ErrorStatus error otherwise.
   */
@@ -764,6 +1283,9 @@ static SFU_ErrorStatus SwapFirmwareImages(void)
   uint32_t offset_block_partial_begin;
   uint32_t offset_block_partial_end;
   uint32_t offset_block_final_end;
+#if defined(SFU_VERBOSE_DEBUG_MODE)
+  uint32_t number_of_unchanged = 0U;
+#endif /* SFU_VERBOSE_DEBUG_MODE */
 
   TRACE("\r\n\t  Image preparation done.\r\n\t  Swapping the firmware images");
 
@@ -779,18 +1301,18 @@ static SFU_ErrorStatus SwapFirmwareImages(void)
   /* index_slot0_partial_end is the index of block (of SFU_IMG_SWAP_REGION_SIZE bytes) of first byte following partial
      image in slot #0 */
   index_slot0_partial_end = (SFU_IMG_IMAGE_OFFSET + fw_image_header_to_test.PartialFwOffset +
-                             fw_image_header_to_test.PartialFwSize) / SFU_IMG_SWAP_REGION_SIZE;
+                             PartialImageSize(&fw_image_header_to_test)) / SFU_IMG_SWAP_REGION_SIZE;
 
   /* offset_block_partial_end is the offset of first byte following partial image, inside index_slot0_partial_end
      block */
   offset_block_partial_end = (SFU_IMG_IMAGE_OFFSET + fw_image_header_to_test.PartialFwOffset +
-                              fw_image_header_to_test.PartialFwSize) % SFU_IMG_SWAP_REGION_SIZE;
+                              PartialImageSize(&fw_image_header_to_test)) % SFU_IMG_SWAP_REGION_SIZE;
 
   /* index_slot1_partial_end is the index of block (of SFU_IMG_SWAP_REGION_SIZE bytes) of first byte following partial
      image in slot #1 or swap area */
   index_slot1_partial_end = (((SFU_IMG_IMAGE_OFFSET + (fw_image_header_to_test.PartialFwOffset %
                                                        SFU_IMG_SWAP_REGION_SIZE)) % SFU_IMG_SWAP_REGION_SIZE +
-                              fw_image_header_to_test.PartialFwSize) / SFU_IMG_SWAP_REGION_SIZE) - 1;
+                              PartialImageSize(&fw_image_header_to_test)) / SFU_IMG_SWAP_REGION_SIZE) - 1;
 
   /* index_slot0_final_end is the index of block (of SFU_IMG_SWAP_REGION_SIZE bytes) of first byte following final
      image in slot #0 */
@@ -849,6 +1371,43 @@ static SFU_ErrorStatus SwapFirmwareImages(void)
       return SFU_ERROR;
     }
 
+    /*
+     * If the block is not swapped yet and the updated image does not change it, both CPY bytes are set to SWAPPED
+     * without any erase or copy: the steps below are then skipped for this block.
+     * CPY_TO_SLOT0 is set first: if a reset occurs before CPY_TO_SLOT1 is set, the resume backs up the block as usual
+     * but keeps it in slot #0. The header block is always swapped as it is completed by the installation.
+     */
+    if ((index_slot0 != 0)
+        && (SFU_LL_FLASH_Read(&trailer, TRAILER_CPY_TO_SLOT0(TRAILER_INDEX - 1 - index_slot0), sizeof(trailer))
+            == SFU_SUCCESS)
+        && (memcmp(&trailer, NOT_SWAPPED, sizeof(trailer)) == 0)
+        && (SFU_LL_FLASH_Read(&trailer, TRAILER_CPY_TO_SLOT1(TRAILER_INDEX - 1 - index_slot0), sizeof(trailer))
+            == SFU_SUCCESS)
+        && (memcmp(&trailer, NOT_SWAPPED, sizeof(trailer)) == 0)
+        && (CompareSlot0Block(index_slot0, index_slot1_read,
+                              (index_slot0 == index_slot0_partial_begin) ? offset_block_partial_begin : 0U,
+                              (index_slot0 == index_slot0_partial_end) ? offset_block_partial_end :
+                              SFU_IMG_SWAP_REGION_SIZE,
+                              (index_slot0 == index_slot0_final_end) ? offset_block_final_end :
+                              SFU_IMG_SWAP_REGION_SIZE) == SFU_SUCCESS))
+    {
+      e_ret_status = AtomicWrite(TRAILER_CPY_TO_SLOT0((TRAILER_INDEX - 1 - index_slot0)),
+                                 (SFU_LL_FLASH_write_t *) SWAPPED);
+      if (e_ret_status == SFU_SUCCESS)
+      {
+        e_ret_status = AtomicWrite(TRAILER_CPY_TO_SLOT1((TRAILER_INDEX - 1 - index_slot0)),
+                                   (SFU_LL_FLASH_write_t *) SWAPPED);
+      }
+      StatusFWIMG(e_ret_status == SFU_ERROR, SFU_IMG_FLASH_WRITE_FAILED);
+      if (e_ret_status != SFU_SUCCESS)
+      {
+        return e_ret_status;
+      }
+#if defined(SFU_VERBOSE_DEBUG_MODE)
+      number_of_unchanged++;
+#endif /* SFU_VERBOSE_DEBUG_MODE */
+    }
+
     /* If CPY_TO_SLOT1(i) is still virgin (value NOT_SWAPPED, and no NMI), then swap the block from slot #0 to
        slot #1 */
     e_ret_status = SFU_LL_FLASH_Read(&trailer, TRAILER_CPY_TO_SLOT1(TRAILER_INDEX - 1 - index_slot0), sizeof(trailer));
@@ -1105,6 +1664,10 @@ static SFU_ErrorStatus SwapFirmwareImages(void)
     }
   }
 
+#if defined(SFU_VERBOSE_DEBUG_MODE)
+  TRACE("\r\n\t  %d unchanged block(s) kept in place.", number_of_unchanged);
+#endif /* SFU_VERBOSE_DEBUG_MODE */
+
   /*
    * Now, erase the blocks in slot #0, located after final image
    */
@@ -1120,10 +1683,14 @@ static SFU_ErrorStatus SwapFirmwareImages(void)
   index_slot0 = number_of_index_slot0 - 1;
   while (index_slot0 >= index_slot0_empty_begin)
   {
-    e_ret_status = EraseSlotIndex(0, index_slot0);
-    if (e_ret_status !=  SFU_SUCCESS)
+    /* Blocks already empty are not erased again */
+    if (CompareSlot0Block(index_slot0, -1, 0U, 0U, 0U) != SFU_SUCCESS)
     {
-      return SFU_ERROR;
+      e_ret_status = EraseSlotIndex(0, index_slot0);
+      if (e_ret_status !=  SFU_SUCCESS)
+      {
+        return SFU_ERROR;
+      }
     }
 
     /* Decrement block index */
@@ -1169,6 +1736,13 @@ static SFU_ErrorStatus DecryptImageInSlot1(SE_FwRawHeaderTypeDef *pFwImageHeader
 
   /* Decryption process*/
   se_ret_status = SE_Decrypt_Init(&e_se_status, pFwImageHeader, SE_FW_IMAGE_PARTIAL);
+#if defined(SFU_IMG_STREAMED_VERIFY) && (SECBOOT_CRYPTO_SCHEME != SECBOOT_AES128_GCM_AES128_GCM_AES128_GCM)
+  if ((se_ret_status == SE_SUCCESS) && (e_se_status == SE_OK))
+  {
+    /* The decrypted chunks are hashed as they are written, see @ref VerifyFwSignatureStreamed */
+    se_ret_status = SE_AuthenticateFW_Init(&e_se_status, pFwImageHeader, SE_FW_IMAGE_PARTIAL);
+  }
+#endif /* SFU_IMG_STREAMED_VERIFY && SECBOOT_CRYPTO_SCHEME */
   if ((se_ret_status == SE_SUCCESS) && (e_se_status == SE_OK))
   {
     e_ret_status = SFU_SUCCESS;
@@ -1303,6 +1877,12 @@ static SFU_ErrorStatus DecryptImageInSlot1(SE_FwRawHeaderTypeDef *pFwImageHeader
 
           if (e_ret_status == SFU_SUCCESS)
           {
+#if defined(SFU_IMG_STREAMED_VERIFY) && (SECBOOT_CRYPTO_SCHEME != SECBOOT_AES128_GCM_AES128_GCM_AES128_GCM)
+            /* Hash the decrypted data without the FLASH padding. The output buffer is not used by the hash. */
+            se_ret_status = SE_AuthenticateFW_Append(&e_se_status, fw_decrypted_chunk, fw_decrypted_chunk_size,
+                                                     fw_encrypted_chunk, &fw_tag_len);
+#endif /* SFU_IMG_STREAMED_VERIFY && SECBOOT_CRYPTO_SCHEME */
+
             /* Update flash pointer */
             fw_dest_address_write  += (size);
 
@@ -2053,7 +2633,7 @@ SFU_ErrorStatus SFU_IMG_FirmwareToInstall(void)
 /**
   * @brief Prepares the Candidate FW image for Installation.
   *        This stage depends on the supported features: in this example this consists in decrypting the candidate
-  *        image.
+  *        image, and in applying it to the active image when it is a patch (delta image).
   * @note This function relies on following FWIMG module ram variables, already filled by the checks:
   *       fw_header_to_test,fw_image_header_validated, fw_image_header_to_test
   * @note Even if the Firmware Image is in clear format the decrypt function is called.
@@ -2065,6 +2645,7 @@ SFU_ErrorStatus SFU_IMG_PrepareCandidateImageForInstall(void)
 {
   SFU_ErrorStatus e_ret_status = SFU_ERROR;
   SE_StatusTypeDef e_se_status;
+  SFU_IMG_DeltaDescTypeDef delta;
 
   /*
     * Control if there is no additional code beyond the firmware image (malicious SW)
@@ -2082,6 +2663,19 @@ SFU_ErrorStatus SFU_IMG_PrepareCandidateImageForInstall(void)
     return e_ret_status;
   }
 
+  /*
+    * A delta image must be built against the active FW.
+    */
+  if ((GetDeltaDescriptor(&fw_image_header_to_test, &delta) == SFU_SUCCESS)
+      && (CheckDeltaImage(&fw_image_header_to_test) != SFU_SUCCESS))
+  {
+    (void)SFU_BOOT_SetLastExecError(SFU_EXCPT_INCORRECT_BINARY);
+#if defined(SFU_VERBOSE_DEBUG_MODE)
+    TRACE("\r\n= [FWIMG] The patch does not apply to the active firmware!");
+#endif /* SFU_VERBOSE_DEBUG_MODE */
+    return SFU_ERROR;
+  }
+
   /*
     * Pre-condition: all checks have been performed,
     *                so all FWIMG module variables are populated.
@@ -2136,7 +2730,11 @@ SFU_ErrorStatus SFU_IMG_PrepareCandidateImageForInstall(void)
     * and a "hole" has been created in slot #1 to be able to swap.
     */
 
+#if defined(SFU_IMG_STREAMED_VERIFY)
+  e_ret_status = VerifyFwSignatureStreamed(&e_se_status, &fw_image_header_to_test);
+#else
   e_ret_status = VerifyFwSignatureAfterDecrypt(&e_se_status, &fw_image_header_to_test);
+#endif /* SFU_IMG_STREAMED_VERIFY */
   if (e_ret_status != SFU_SUCCESS)
   {
     (void)SFU_BOOT_SetLastExecError(SFU_EXCPT_SIGNATURE_FAILURE);
@@ -2146,6 +2744,23 @@ SFU_ErrorStatus SFU_IMG_PrepareCandidateImageForInstall(void)
     return e_ret_status;
   }
 
+  /*
+    * For a delta image, the decrypted and verified patch is applied: the new FW range is rebuilt in place of the
+    * patch, with the same layout. The complete FW is verified against FwTag once installed, as any FW in slot #0.
+    */
+  if (GetDeltaDescriptor(&fw_image_header_to_test, &delta) == SFU_SUCCESS)
+  {
+    e_ret_status = ApplyDeltaInSlot1(&fw_image_header_to_test);
+    if (e_ret_status != SFU_SUCCESS)
+    {
+      (void)SFU_BOOT_SetLastExecError(SFU_EXCPT_INCORRECT_BINARY);
+#if defined(SFU_VERBOSE_DEBUG_MODE)
+      TRACE("\r\n= [FWIMG] The patch cannot be applied!");
+#endif /* SFU_VERBOSE_DEBUG_MODE */
+      return e_ret_status;
+    }
+  }
+
   /* Return the result of this preparation */
   return (e_ret_status);
 }
@@ -2313,6 +2928,160 @@ SFU_ErrorStatus SFU_IMG_ControlFwTag(uint8_t *pTag)
   }
 }
 
+#if defined(SFU_IMG_BOOT_CACHE)
+/**
+  * @brief  Check if the FW in slot #0 has already been verified, to skip the computation of its tag.
+  * @note   The boot cache record must have been written for the FW tag of the authenticated header and the current
+  *         static protections, and not revoked. The full verification is required again every
+  *         SFU_IMG_BOOT_CACHE_PERIOD boots, or when the backup registers have been lost.
+  * @param  pFwImageHeader pointer to the authenticated header of the FW in slot #0
+  * @retval SFU_SUCCESS if the FW tag is validated by the boot cache, SFU_ERROR if the FW must be verified.
+  */
+SFU_ErrorStatus SFU_IMG_CheckBootCache(SE_FwRawHeaderTypeDef *pFwImageHeader)
+{
+  SFU_ErrorStatus e_ret_status;
+  SFU_IMG_BootCacheTypeDef boot_cache __attribute__((aligned(8)));
+  uint32_t protection_state[SFU_PROTECTION_STATE_LEN];
+  uint32_t counter;
+
+  if (pFwImageHeader == NULL)
+  {
+    return SFU_ERROR;
+  }
+
+  e_ret_status = SFU_LL_FLASH_Read(&boot_cache, SFU_IMG_BOOT_CACHE_ADDR, sizeof(boot_cache));
+  StatusFWIMG(e_ret_status == SFU_ERROR, SFU_IMG_FLASH_READ_FAILED);
+
+  if ((e_ret_status == SFU_SUCCESS) && ((boot_cache.Magic != SFU_IMG_BOOT_CACHE_MAGIC) ||
+                                        (boot_cache.Revoked != (SFU_LL_FLASH_write_t)(~0ULL))))
+  {
+    e_ret_status = SFU_ERROR;
+  }
+
+  if (e_ret_status == SFU_SUCCESS)
+  {
+    SFU_LL_SECU_GetStaticProtectionsState(protection_state);
+    if (memcmp(boot_cache.ProtectionState, protection_state, sizeof(protection_state)) != 0)
+    {
+      e_ret_status = SFU_ERROR;
+    }
+  }
+
+  if (e_ret_status == SFU_SUCCESS)
+  {
+    e_ret_status = MemoryCompare(boot_cache.FwTag, pFwImageHeader->FwTag, SE_TAG_LEN);
+  }
+
+  if (e_ret_status == SFU_SUCCESS)
+  {
+    /* Count this boot, the full verification is required once the period is elapsed. The FW is checked several
+       times per boot: the counter may already include this boot. */
+    counter = SFU_LL_BKP_Read(SFU_BKP_BOOT_CACHE);
+    if ((counter < SFU_IMG_BOOT_CACHE_COUNTER(pFwImageHeader->FwTag, 0U))
+        || (counter >= SFU_IMG_BOOT_CACHE_COUNTER(pFwImageHeader->FwTag,
+                                                  SFU_IMG_BOOT_CACHE_PERIOD + boot_cache_counted)))
+    {
+      e_ret_status = SFU_ERROR;
+    }
+    else if (boot_cache_counted == 0U)
+    {
+      SFU_LL_BKP_Write(SFU_BKP_BOOT_CACHE, counter + 1U);
+      boot_cache_counted = 1U;
+    }
+    else
+    {
+      /* already counted */
+    }
+  }
+
+  if (e_ret_status == SFU_SUCCESS)
+  {
+    FLOW_STEP(uFlowCryptoValue, FLOW_STEP_INTEGRITY);
+    memcpy(fw_tag_validated, pFwImageHeader->FwTag, SE_TAG_LEN);
+  }
+  return e_ret_status;
+}
+
+/**
+  * @brief  Record that the FW in slot #0 has been fully verified.
+  * @note   The record is programmed once per installed FW: if it has been written with other protections, the boot
+  *         cache is not used until the next installation.
+  * @param  pFwImageHeader pointer to the authenticated header of the verified FW in slot #0
+  * @retval SFU_SUCCESS if successful, a SFU_ErrorStatus error otherwise.
+  */
+SFU_ErrorStatus SFU_IMG_WriteBootCache(SE_FwRawHeaderTypeDef *pFwImageHeader)
+{
+  SFU_ErrorStatus e_ret_status;
+  SFU_FLASH_StatusTypeDef flash_if_status;
+  SFU_IMG_BootCacheTypeDef boot_cache __attribute__((aligned(8)));
+  SFU_IMG_BootCacheTypeDef new_cache __attribute__((aligned(8)));
+  uint8_t *pbuffer;
+  uint32_t i;
+
+  if (pFwImageHeader == NULL)
+  {
+    return SFU_ERROR;
+  }
+
+  /* Restart the period */
+  SFU_LL_BKP_Write(SFU_BKP_BOOT_CACHE, SFU_IMG_BOOT_CACHE_COUNTER(pFwImageHeader->FwTag, 0U));
+  boot_cache_counted = 1U;
+
+  memset(&new_cache, 0xFF, sizeof(new_cache));
+  SFU_LL_SECU_GetStaticProtectionsState(new_cache.ProtectionState);
+  memcpy(new_cache.FwTag, pFwImageHeader->FwTag, SE_TAG_LEN);
+  new_cache.Magic = SFU_IMG_BOOT_CACHE_MAGIC;
+
+  e_ret_status = SFU_LL_FLASH_Read(&boot_cache, SFU_IMG_BOOT_CACHE_ADDR, sizeof(boot_cache));
+  StatusFWIMG(e_ret_status == SFU_ERROR, SFU_IMG_FLASH_READ_FAILED);
+
+  if ((e_ret_status == SFU_SUCCESS) && (memcmp(&boot_cache, &new_cache, sizeof(boot_cache)) != 0))
+  {
+    /* The record can only be programmed in an erased area */
+    for (i = 0U, pbuffer = (uint8_t *)&boot_cache; i < sizeof(boot_cache); i++)
+    {
+      if (pbuffer[i] != 0xFFU)
+      {
+        e_ret_status = SFU_ERROR;
+      }
+    }
+
+    if (e_ret_status == SFU_SUCCESS)
+    {
+      e_ret_status = SFU_LL_FLASH_Write(&flash_if_status, SFU_IMG_BOOT_CACHE_ADDR, &new_cache,
+                                        offsetof(SFU_IMG_BootCacheTypeDef, Revoked));
+      StatusFWIMG(e_ret_status == SFU_ERROR, SFU_IMG_FLASH_WRITE_FAILED);
+    }
+  }
+  return e_ret_status;
+}
+
+/**
+  * @brief  Revoke the boot cache record of slot #0, to be called before its content is erased.
+  * @param  None
+  * @retval SFU_SUCCESS if successful, a SFU_ErrorStatus error otherwise.
+  */
+SFU_ErrorStatus SFU_IMG_RevokeBootCache(void)
+{
+  SFU_ErrorStatus e_ret_status;
+  SFU_FLASH_StatusTypeDef flash_if_status;
+  SFU_IMG_BootCacheTypeDef boot_cache __attribute__((aligned(8)));
+  SFU_LL_FLASH_write_t revoked = 0U;
+
+  e_ret_status = SFU_LL_FLASH_Read(&boot_cache, SFU_IMG_BOOT_CACHE_ADDR, sizeof(boot_cache));
+  StatusFWIMG(e_ret_status == SFU_ERROR, SFU_IMG_FLASH_READ_FAILED);
+
+  if ((e_ret_status == SFU_SUCCESS) && (boot_cache.Revoked == (SFU_LL_FLASH_write_t)(~0ULL)))
+  {
+    e_ret_status = SFU_LL_FLASH_Write(&flash_if_status,
+                                      SFU_IMG_BOOT_CACHE_ADDR + offsetof(SFU_IMG_BootCacheTypeDef, Revoked),
+                                      &revoked, sizeof(revoked));
+    StatusFWIMG(e_ret_status == SFU_ERROR, SFU_IMG_FLASH_WRITE_FAILED);
+  }
+  return e_ret_status;
+}
+#endif /* SFU_IMG_BOOT_CACHE */
+
 /**
   * @brief  Get size of the trailer
   * @note   This area mapped at the end of a slot#1 is not available for the firmware image
@@ -247,6 +247,14 @@ SFU_ErrorStatus SFU_IMG_WriteHeaderValidated(uint8_t *pHeader);
 SFU_ErrorStatus SFU_IMG_VerifySlot(uint8_t *pSlotBegin, uint32_t uSlotSize, uint32_t uFwSize);
 /* Control FW tag */
 SFU_ErrorStatus SFU_IMG_ControlFwTag(uint8_t *pTag);
+#if defined(SFU_IMG_BOOT_CACHE)
+/* Check if the active FW has already been verified */
+SFU_ErrorStatus SFU_IMG_CheckBootCache(SE_FwRawHeaderTypeDef *pFwImageHeader);
+/* Record the verification of the active FW */
+SFU_ErrorStatus SFU_IMG_WriteBootCache(SE_FwRawHeaderTypeDef *pFwImageHeader);
+/* Revoke the verification record of the active FW */
+SFU_ErrorStatus SFU_IMG_RevokeBootCache(void);
+#endif /* SFU_IMG_BOOT_CACHE */
 
 /* FW installation resume */
 SFU_ErrorStatus SFU_IMG_Resume(void);
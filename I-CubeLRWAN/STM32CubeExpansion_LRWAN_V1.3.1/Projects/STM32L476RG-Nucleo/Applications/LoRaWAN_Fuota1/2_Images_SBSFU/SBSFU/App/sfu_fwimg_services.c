@@ -335,6 +335,11 @@ SFU_ErrorStatus SFU_IMG_InvalidateCurrentFirmware(void)
   /* Reload Watchdog */
   SFU_LL_SECU_IWDG_Refresh();
 
+#if defined(SFU_IMG_BOOT_CACHE)
+  /* The header is kept: the FW must not be considered as verified anymore */
+  (void)SFU_IMG_RevokeBootCache(); /* If this fails, the FW verification fails anyway */
+#endif /* SFU_IMG_BOOT_CACHE */
+
   /* erase Slot0 except Header (under SECoreBin protection) for the anti-rollback check during next Fw update */
   e_ret_status = SFU_LL_FLASH_CleanUp(&x_flash_info, SFU_IMG_SLOT_0_REGION_BEGIN + SFU_IMG_IMAGE_OFFSET,
                                       SFU_IMG_SLOT_0_REGION_SIZE - SFU_IMG_IMAGE_OFFSET);
@@ -377,7 +382,19 @@ SFU_ErrorStatus SFU_IMG_VerifyActiveImg(void)
    * fw_image_header_validated MUST have been populated with valid metadata first,
    * slot #0 is the active FW image
    */
+#if defined(SFU_IMG_BOOT_CACHE)
+  if (SFU_IMG_CheckBootCache(&fw_image_header_validated) == SFU_SUCCESS)
+  {
+    return SFU_SUCCESS;
+  }
+#endif /* SFU_IMG_BOOT_CACHE */
   e_ret_status = SFU_IMG_VerifyFwSignature(&e_se_status, &fw_image_header_validated, 0U, SE_FW_IMAGE_COMPLETE);
+#if defined(SFU_IMG_BOOT_CACHE)
+  if (SFU_SUCCESS == e_ret_status)
+  {
+    (void)SFU_IMG_WriteBootCache(&fw_image_header_validated); /* If this fails, the FW is verified at next boot */
+  }
+#endif /* SFU_IMG_BOOT_CACHE */
 #if defined(SFU_VERBOSE_DEBUG_MODE)
   if (SFU_ERROR == e_ret_status)
   {
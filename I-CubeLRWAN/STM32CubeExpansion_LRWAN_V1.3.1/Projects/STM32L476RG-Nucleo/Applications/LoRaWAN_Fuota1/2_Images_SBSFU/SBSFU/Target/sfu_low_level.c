@@ -375,6 +375,53 @@ void SFU_LL_SB_SRAM_Erase(void)
   * @}
   */
 
+#if defined(SFU_IMG_BOOT_CACHE)
+/** @defgroup SFU_LOW_LEVEL_BKP_Functions Backup Registers Functions
+  * @{
+  */
+
+/**
+  * @brief  Read a backup register.
+  * @note   The backup registers are kept in Standby and Shutdown modes, and erased on a tamper event.
+  * @param  BackupRegister RTC_BKP_DRx number of the backup register.
+  * @retval Content of the backup register.
+  */
+uint32_t SFU_LL_BKP_Read(uint32_t BackupRegister)
+{
+  RTC_HandleTypeDef hrtc;
+
+#if defined(RCC_APB1ENR1_RTCAPBEN)
+  __HAL_RCC_RTCAPB_CLK_ENABLE();
+#endif /* RCC_APB1ENR1_RTCAPBEN */
+  hrtc.Instance = RTC;
+  return HAL_RTCEx_BKUPRead(&hrtc, BackupRegister);
+}
+
+/**
+  * @brief  Write a backup register.
+  * @param  BackupRegister RTC_BKP_DRx number of the backup register.
+  * @param  Data value to write.
+  * @retval None
+  */
+void SFU_LL_BKP_Write(uint32_t BackupRegister, uint32_t Data)
+{
+  RTC_HandleTypeDef hrtc;
+
+  /* Enables access to the backup domain */
+  __HAL_RCC_PWR_CLK_ENABLE();
+  HAL_PWR_EnableBkUpAccess();
+#if defined(RCC_APB1ENR1_RTCAPBEN)
+  __HAL_RCC_RTCAPB_CLK_ENABLE();
+#endif /* RCC_APB1ENR1_RTCAPBEN */
+  hrtc.Instance = RTC;
+  HAL_RTCEx_BKUPWrite(&hrtc, BackupRegister, Data);
+}
+
+/**
+  * @}
+  */
+#endif /* SFU_IMG_BOOT_CACHE */
+
 /** @defgroup SFU_LOW_LEVEL_MSP_Functions MSP Functions
   * @{
   */
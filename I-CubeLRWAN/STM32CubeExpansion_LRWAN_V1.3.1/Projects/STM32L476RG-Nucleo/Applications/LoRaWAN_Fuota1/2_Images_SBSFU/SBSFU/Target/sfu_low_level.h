@@ -65,6 +65,15 @@ extern "C" {
 #define SFU_UART_RX_GPIO_CLK_ENABLE()           __HAL_RCC_GPIOA_CLK_ENABLE()
 #define SFU_UART_RX_GPIO_CLK_DISABLE()          __HAL_RCC_GPIOA_CLK_DISABLE()
 
+/**
+  * @}
+  */
+
+/** @defgroup SFU_CONFIG_BKP Backup Registers Configuration
+  * @{
+  */
+#define SFU_BKP_BOOT_CACHE                      RTC_BKP_DR31  /*!< Counter of the boots relying on the boot cache */
+
 /**
   * @}
   */
@@ -175,6 +184,18 @@ SFU_ErrorStatus SFU_LL_RTC_DeInit(void);
   */
 #endif /*SFU_TAMPER_PROTECT_ENABLE*/
 
+#if defined(SFU_IMG_BOOT_CACHE)
+/** @defgroup SFU_LOW_LEVEL_BKP_Functions Backup Registers Functions
+  * @{
+  */
+uint32_t SFU_LL_BKP_Read(uint32_t BackupRegister);
+void SFU_LL_BKP_Write(uint32_t BackupRegister, uint32_t Data);
+
+/**
+  * @}
+  */
+#endif /* SFU_IMG_BOOT_CACHE */
+
 /** @defgroup SFU_LOW_LEVEL_SRAM_Functions SRAM Functions
   * @{
   */
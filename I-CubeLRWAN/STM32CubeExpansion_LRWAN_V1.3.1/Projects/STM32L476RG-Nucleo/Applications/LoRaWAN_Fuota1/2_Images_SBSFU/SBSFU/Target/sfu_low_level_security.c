@@ -528,6 +528,21 @@ void SFU_LL_SECU_ClearResetSources()
   __HAL_RCC_CLEAR_RESET_FLAGS();
 }
 
+#if defined(SFU_IMG_BOOT_CACHE)
+/**
+  * @brief  Get the current state of the static protections from the option bytes.
+  * @param  pState array of SFU_PROTECTION_STATE_LEN words filled with:
+  *         word 0: RDP level (bits 7:0), WRP area A of bank 1 start (bits 15:8) and end (bits 31:24) pages,
+  *         word 1: PCROP area of bank 1 start (bits 15:0) and end (bits 31:16) offsets.
+  * @retval None
+  */
+void SFU_LL_SECU_GetStaticProtectionsState(uint32_t *pState)
+{
+  pState[0] = READ_BIT(FLASH->OPTR, FLASH_OPTR_RDP) | (READ_REG(FLASH->WRP1AR) << 8U);
+  pState[1] = (READ_REG(FLASH->PCROP1SR) & 0x0000FFFFU) | (READ_REG(FLASH->PCROP1ER) << 16U);
+}
+#endif /* SFU_IMG_BOOT_CACHE */
+
 /**
   * @brief  Refresh Watchdog : reload counter
   *         This function must be called just before jumping to the UserFirmware
@@ -307,6 +307,9 @@ typedef enum
 #define SFU_INITIAL_CONFIGURATION           (0x00)     /*!< Initial configuration */
 #define SFU_SECOND_CONFIGURATION            (0x01)     /*!< Second configuration */
 #define SFU_THIRD_CONFIGURATION             (0x02)     /*!< Third configuration */
+
+#define SFU_PROTECTION_STATE_LEN            (2U)       /*!< Number of words describing the static protections state,
+                                                            see SFU_LL_SECU_GetStaticProtectionsState */
 /**
   * @}
   */
@@ -369,6 +372,9 @@ SFU_ErrorStatus    SFU_LL_SECU_CheckApplyStaticProtections(void);
 SFU_ErrorStatus    SFU_LL_SECU_CheckApplyRuntimeProtections(uint8_t uStep);
 void               SFU_LL_SECU_GetResetSources(SFU_RESET_IdTypeDef *peResetpSourceId);
 void               SFU_LL_SECU_ClearResetSources(void);
+#if defined(SFU_IMG_BOOT_CACHE)
+void               SFU_LL_SECU_GetStaticProtectionsState(uint32_t *pState);
+#endif /* SFU_IMG_BOOT_CACHE */
 #ifdef SFU_MPU_PROTECT_ENABLE
 SFU_ErrorStatus    SFU_LL_SECU_SetProtectionMPU(void);
 #endif /*SFU_MPU_PROTECT_ENABLE*/
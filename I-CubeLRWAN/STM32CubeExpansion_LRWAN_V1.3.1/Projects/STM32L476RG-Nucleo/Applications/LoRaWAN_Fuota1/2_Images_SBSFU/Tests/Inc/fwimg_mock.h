@@ -0,0 +1,109 @@
+/**
+  ******************************************************************************
+  * @file    fwimg_mock.h
+  * @author  MCD Application Team
+  * @brief   Host replacement of the FLASH and Secure Engine for the FWIMG tests
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef FWIMG_MOCK_H
+#define FWIMG_MOCK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <setjmp.h>
+#include "main.h"
+#include "se_def.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define MOCK_FLASH_SIZE                             0x00100000U   /* 1 Mbyte of the STM32L476RG */
+#define MOCK_FW_VERSION_ACTIVE                      1U
+#define MOCK_FW_VERSION_CANDIDATE                   2U
+
+/* Exported variables --------------------------------------------------------*/
+/*
+ * Number of FLASH operations (programming of a double word, erase of a page) left before a reset, -1 for none.
+ * The reset jumps to MockReset.
+ */
+extern int32_t MockFlashBudget;
+extern jmp_buf MockReset;
+
+/* FLASH accesses the target would reject: unaligned, programming a non-erased double word, out of the slots */
+extern uint32_t MockFlashErrors;
+
+/* Number of FLASH operations done, and whether one of them modified slot #0 */
+extern uint32_t MockFlashOperations;
+extern uint32_t MockSlot0Modified;
+
+/* Exported functions ------------------------------------------------------- */
+/**
+  * @brief  Map the erased FLASH at its address on the target.
+  * @retval 0 if successful, -1 otherwise.
+  */
+int32_t Mock_FlashInit(void);
+
+/**
+  * @brief  Erase the whole FLASH and clear the counters.
+  */
+void Mock_FlashErase(void);
+
+/**
+  * @brief  Tag of a FW, standing for the SHA-256 computed by the Secure Engine.
+  * @param  pData FW
+  * @param  Size size of the FW
+  * @param  pTag tag of SE_TAG_LEN bytes
+  */
+void Mock_Tag(const uint8_t *pData, uint32_t Size, uint8_t *pTag);
+
+/**
+  * @brief  Fill a FW header and its MAC.
+  * @param  pHeader header to fill
+  * @param  Version FW version
+  * @param  pFw complete FW
+  * @param  FwSize size of the complete FW
+  * @param  PartialOffset offset of the partial FW in the complete FW
+  * @param  pPartial partial FW
+  * @param  PartialSize size of the partial FW
+  * @param  pReserved content of the Reserved field, NULL to leave it empty
+  * @param  ReservedSize size of the content of the Reserved field
+  */
+void Mock_Header(SE_FwRawHeaderTypeDef *pHeader, uint16_t Version, const uint8_t *pFw, uint32_t FwSize,
+                 uint32_t PartialOffset, const uint8_t *pPartial, uint32_t PartialSize, const void *pReserved,
+                 uint32_t ReservedSize);
+
+/**
+  * @brief  Install a FW in slot #0 as SBSFU leaves it after a validated installation.
+  * @param  pHeader FW header
+  * @param  pFw complete FW
+  */
+void Mock_WriteActive(const SE_FwRawHeaderTypeDef *pHeader, const uint8_t *pFw);
+
+/**
+  * @brief  Write a candidate FW in slot #1 and its header in the swap area, as the loader leaves them.
+  * @param  pHeader FW header
+  * @param  pPartial partial FW
+  */
+void Mock_WriteCandidate(const SE_FwRawHeaderTypeDef *pHeader, const uint8_t *pPartial);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FWIMG_MOCK_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
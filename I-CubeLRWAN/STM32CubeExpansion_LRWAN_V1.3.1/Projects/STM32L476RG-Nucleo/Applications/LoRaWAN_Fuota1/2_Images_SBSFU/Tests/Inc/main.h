@@ -0,0 +1,57 @@
+/**
+  ******************************************************************************
+  * @file    main.h
+  * @author  MCD Application Team
+  * @brief   Host replacement of the SBSFU main header for the FWIMG tests
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef MAIN_H
+#define MAIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  int dummy;
+} RTC_HandleTypeDef;
+
+typedef struct
+{
+  int dummy;
+} UART_HandleTypeDef;
+
+/* Exported constants --------------------------------------------------------*/
+#define __IO                                        volatile
+#define FLASH_BASE                                  0x08000000UL
+#define FLASH_PAGE_SIZE                             0x800U
+
+#include "app_sfu.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MAIN_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,43 @@
+/**
+  ******************************************************************************
+  * @file    mapping_export.h
+  * @author  MCD Application Team
+  * @brief   Host replacement of the FLASH mapping export for the FWIMG tests
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef MAPPING_EXPORT_H
+#define MAPPING_EXPORT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Exported constants --------------------------------------------------------*/
+/* SE and SBSFU code, as in mapping_sbsfu.ld. The slots and the swap area are
+   taken from mapping_fwimg.ld by the Makefile (REGION_xxx). */
+#define INTVECT_START                               0x08000000U
+#define SE_CODE_REGION_ROM_START                    0x08000200U
+#define SE_CODE_REGION_ROM_END                      0x080094FFU
+#define SB_REGION_ROM_START                         0x08009B00U
+#define SB_REGION_ROM_END                           0x08013FFFU
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MAPPING_EXPORT_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,360 @@
+/**
+  ******************************************************************************
+  * @file    delta_test.c
+  * @author  MCD Application Team
+  * @brief   Host test of the delta FW images applied by sfu_fwimg_core.c
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+/*
+ * sfu_fwimg_core.c is included and runs on the FLASH of fwimg_mock.c.
+ * The patch made by "prepareimage.py delta" between 2 FW images is installed
+ * over the first one as SBSFU does it: checks of the candidate, preparation
+ * (patch applied in slot #1 by ApplyDeltaInSlot1) and swap. Slot #0 must then
+ * hold the second FW, tagged as valid.
+ * Hand-made patches check that a patch which does not rebuild exactly the
+ * target range is rejected before the swap, slot #0 unmodified: truncated and
+ * overlong varints, COPY ranges out of the active FW, commands going past the
+ * target size, patch ending early.
+ *
+ * Usage: delta_test <v1> <v2> <patch> <patch offset> <delta descriptor>
+ *        delta_test -i <v1> <v2> <v1 tag>  writes the FW images of the fixtures
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "main.h"
+#include "sfu_trace.h"
+/* The traces of the FWIMG module are not printed */
+#undef TRACE
+#define TRACE( ... )
+#include "sfu_fwimg_core.c"
+#include "fwimg_mock.h"
+
+/* Private define ------------------------------------------------------------*/
+#define FW_MAX_SIZE                                 0x10000U
+#define DELTA_TARGET_SIZE                           64U
+
+#define CHECK( cond )                               \
+  if( !( cond ) )                                   \
+  {                                                 \
+    printf( "  line %d: %s\n", __LINE__, #cond );   \
+    return -1;                                      \
+  }
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t Fw1[FW_MAX_SIZE];
+static uint8_t Fw2[FW_MAX_SIZE];
+static uint8_t Patch[FW_MAX_SIZE];
+static uint32_t Fw1Size;
+static uint32_t Fw2Size;
+static uint32_t PatchSize;
+static uint32_t PatchOffset;
+static SFU_IMG_DeltaDescTypeDef Descriptor;
+
+static uint32_t RandomState = 0x2545F491;
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t Random( void )
+{
+  RandomState ^= RandomState << 13;
+  RandomState ^= RandomState >> 17;
+  RandomState ^= RandomState << 5;
+  return RandomState;
+}
+
+static uint32_t ReadFile( const char *name, void *data, uint32_t size )
+{
+  FILE *f = fopen( name, "rb" );
+  size_t n;
+
+  if( f == NULL )
+  {
+    fprintf( stderr, "cannot open %s\n", name );
+    exit( 2 );
+  }
+  n = fread( data, 1, size, f );
+  fclose( f );
+  return n;
+}
+
+static void WriteFile( const char *name, const void *data, uint32_t size )
+{
+  FILE *f = fopen( name, "wb" );
+
+  if( ( f == NULL ) || ( fwrite( data, 1, size, f ) != size ) )
+  {
+    fprintf( stderr, "cannot write %s\n", name );
+    exit( 2 );
+  }
+  fclose( f );
+}
+
+/*
+ * FW images of the fixtures: code-like bytes drawn from a small set, and a new
+ * version with changed constants, inserted and removed functions, and a longer
+ * end. The first difference is in the first block of slot #0, not aligned.
+ */
+static void MakeImages( void )
+{
+  static const uint8_t opcodes[] = { 0x00, 0x08, 0x10, 0x20, 0x46, 0x47, 0x68, 0x70, 0xB5, 0xBD, 0xD0, 0xF0 };
+  uint32_t i;
+  uint32_t j = 0;
+
+  Fw1Size = 30000;
+  for( i = 0; i < Fw1Size; i++ )
+  {
+    Fw1[i] = ( ( Random( ) % 4 ) == 0 ) ? ( uint8_t )Random( ) : opcodes[Random( ) % sizeof( opcodes )];
+  }
+  for( i = 0; i < Fw1Size; i++ )
+  {
+    if( ( i == 3000 ) || ( i == 9000 ) || ( i == 21000 ) )
+    {
+      Fw2[j++] = Fw1[i] ^ 0x5A;
+    }
+    else if( i == 12000 )
+    {
+      /* New function */
+      for( ; j < ( i + 300 ); j++ )
+      {
+        Fw2[j] = ( uint8_t )Random( );
+      }
+      Fw2[j++] = Fw1[i];
+    }
+    else if( ( i < 16000 ) || ( i >= 16500 ) )
+    {
+      /* Removed function from 16000 */
+      Fw2[j++] = Fw1[i];
+    }
+  }
+  for( i = 0; i < 2000; i++ )
+  {
+    Fw2[j++] = ( uint8_t )Random( );
+  }
+  Fw2Size = j;
+}
+
+/* Boot with the FWIMG module variables of a reset, and the active FW checked */
+static int32_t Boot( void )
+{
+  memset( fw_header_validated, 0x00, sizeof( fw_header_validated ) );
+  memset( fw_header_to_test, 0x00, sizeof( fw_header_to_test ) );
+  memset( fw_tag_validated, 0x00, sizeof( fw_tag_validated ) );
+  memset( &fw_image_header_validated, 0x00, sizeof( fw_image_header_validated ) );
+  memset( &fw_image_header_to_test, 0x00, sizeof( fw_image_header_to_test ) );
+  CHECK( SFU_IMG_CoreInit( ) == SFU_IMG_INIT_OK );
+  CHECK( SFU_IMG_GetFWInfoMAC( &fw_image_header_validated, 0 ) == SFU_SUCCESS );
+  CHECK( SFU_IMG_CheckSlot0FwValid( ) == SFU_SUCCESS );
+  return 0;
+}
+
+/* Active FW v1 in slot #0 and the patch as candidate, with its delta descriptor or one made for v1 */
+static int32_t Load( const uint8_t *patch, uint32_t patchSize, uint32_t offset, uint32_t targetSize,
+                     const uint8_t *fw, uint32_t fwSize, const SFU_IMG_DeltaDescTypeDef *pDelta )
+{
+  SE_FwRawHeaderTypeDef header;
+  SFU_IMG_DeltaDescTypeDef delta;
+
+  Mock_FlashErase( );
+  Mock_Header( &header, MOCK_FW_VERSION_ACTIVE, Fw1, Fw1Size, 0, Fw1, Fw1Size, NULL, 0 );
+  Mock_WriteActive( &header, Fw1 );
+  if( pDelta != NULL )
+  {
+    delta = *pDelta;
+  }
+  else
+  {
+    delta.DeltaMagic = SFU_IMG_DELTA_MAGIC;
+    delta.TargetSize = targetSize;
+    memcpy( delta.SourceTag, header.FwTag, sizeof( delta.SourceTag ) );
+  }
+  Mock_Header( &header, MOCK_FW_VERSION_CANDIDATE, fw, fwSize, offset, patch, patchSize, &delta, sizeof( delta ) );
+  Mock_WriteCandidate( &header, patch );
+  return Boot( );
+}
+
+/* Candidate checked and prepared for the swap */
+static SFU_ErrorStatus Prepare( void )
+{
+  if( SFU_IMG_FirmwareToInstall( ) != SFU_SUCCESS )
+  {
+    return SFU_ERROR;
+  }
+  return SFU_IMG_PrepareCandidateImageForInstall( );
+}
+
+/* Patch rebuilding the FW, installed */
+static int32_t TestInstall( const uint8_t *patch, uint32_t patchSize, uint32_t offset, const uint8_t *fw,
+                            uint32_t fwSize, const SFU_IMG_DeltaDescTypeDef *pDelta )
+{
+  SE_StatusTypeDef se_status;
+  uint32_t i;
+
+  CHECK( Load( patch, patchSize, offset, fwSize - offset, fw, fwSize, pDelta ) == 0 );
+  CHECK( Prepare( ) == SFU_SUCCESS );
+  CHECK( SFU_IMG_InstallNewVersion( ) == SFU_SUCCESS );
+  CHECK( MockFlashErrors == 0 );
+
+  /* New FW active and valid, nothing left after it */
+  CHECK( Boot( ) == 0 );
+  CHECK( fw_image_header_validated.FwVersion == MOCK_FW_VERSION_CANDIDATE );
+  CHECK( memcmp( SFU_IMG_SLOT_0_REGION_BEGIN + SFU_IMG_IMAGE_OFFSET, fw, fwSize ) == 0 );
+  for( i = SFU_IMG_IMAGE_OFFSET + fwSize; i < SFU_IMG_SLOT_0_REGION_SIZE; i++ )
+  {
+    CHECK( SFU_IMG_SLOT_0_REGION_BEGIN[i] == 0xFF );
+  }
+  CHECK( SFU_IMG_VerifyFwSignature( &se_status, &fw_image_header_validated, 0, SE_FW_IMAGE_COMPLETE )
+         == SFU_SUCCESS );
+  CHECK( SFU_IMG_CheckTrailerValid( ) != SFU_SUCCESS );
+  return 0;
+}
+
+/* Patch not rebuilding the target range: the candidate is rejected, the active FW kept */
+static int32_t TestReject( const char *name, const uint8_t *patch, uint32_t patchSize )
+{
+  uint32_t offset = Fw1Size - DELTA_TARGET_SIZE;
+
+  printf( "  %s\n", name );
+  CHECK( Load( patch, patchSize, offset, DELTA_TARGET_SIZE, Fw1, Fw1Size, NULL ) == 0 );
+  CHECK( Prepare( ) != SFU_SUCCESS );
+  CHECK( MockFlashErrors == 0 );
+  CHECK( MockSlot0Modified == 0 );
+  CHECK( Boot( ) == 0 );
+  CHECK( fw_image_header_validated.FwVersion == MOCK_FW_VERSION_ACTIVE );
+  CHECK( memcmp( SFU_IMG_SLOT_0_REGION_BEGIN + SFU_IMG_IMAGE_OFFSET, Fw1, Fw1Size ) == 0 );
+  return 0;
+}
+
+static int32_t TestRoundTrip( void )
+{
+  uint8_t tag[SE_TAG_LEN];
+
+  printf( "prepareimage.py delta: %u bytes rebuilt from offset %u with a %u bytes patch\n",
+          ( unsigned )( Fw2Size - PatchOffset ), ( unsigned )PatchOffset, ( unsigned )PatchSize );
+  Mock_Tag( Fw1, Fw1Size, tag );
+  CHECK( Descriptor.DeltaMagic == SFU_IMG_DELTA_MAGIC );
+  CHECK( Descriptor.TargetSize == ( Fw2Size - PatchOffset ) );
+  CHECK( memcmp( Descriptor.SourceTag, tag, sizeof( Descriptor.SourceTag ) ) == 0 );
+  CHECK( TestInstall( Patch, PatchSize, PatchOffset, Fw2, Fw2Size, &Descriptor ) == 0 );
+
+  /* The patch only applies to the FW it was made from */
+  Fw1[Fw1Size - 1] ^= 1;
+  CHECK( Load( Patch, PatchSize, PatchOffset, Fw2Size - PatchOffset, Fw2, Fw2Size, &Descriptor ) == 0 );
+  Fw1[Fw1Size - 1] ^= 1;
+  CHECK( Prepare( ) != SFU_SUCCESS );
+  CHECK( MockSlot0Modified == 0 );
+  return 0;
+}
+
+static int32_t TestPatches( void )
+{
+  uint32_t offset = Fw1Size - DELTA_TARGET_SIZE;
+  uint8_t fw[FW_MAX_SIZE];
+  uint8_t patch[DELTA_TARGET_SIZE + 16];
+  uint32_t i;
+
+  /* INSERT of 3 bytes, COPY of the beginning of the active FW with a negative displacement (zigzag) */
+  memcpy( fw, Fw1, offset );
+  memcpy( &fw[offset], "\x01\x02\x03", 3 );
+  memcpy( &fw[offset + 3], Fw1, DELTA_TARGET_SIZE - 3 );
+  i = 0;
+  patch[i++] = 0x03;
+  memcpy( &patch[i], "\x01\x02\x03", 3 );
+  i += 3;
+  patch[i++] = 0x80 | ( DELTA_TARGET_SIZE - 3 );
+  /* -(offset + 3) */
+  patch[i++] = 0x80 | ( ( ( ( offset + 3 ) << 1 ) - 1 ) & 0x7F );
+  patch[i++] = 0x80 | ( ( ( ( ( offset + 3 ) << 1 ) - 1 ) >> 7 ) & 0x7F );
+  patch[i++] = ( ( ( ( offset + 3 ) << 1 ) - 1 ) >> 14 ) & 0x7F;
+  printf( "  hand-made patch\n" );
+  CHECK( TestInstall( patch, i, offset, fw, offset + DELTA_TARGET_SIZE, NULL ) == 0 );
+
+  /* Length of 64 as a varint, then the inserted bytes */
+  patch[0] = 0x00;
+  patch[1] = DELTA_TARGET_SIZE;
+  memcpy( &patch[2], &fw[offset], DELTA_TARGET_SIZE );
+  printf( "  varint length\n" );
+  CHECK( TestInstall( patch, 2 + DELTA_TARGET_SIZE, offset, fw, offset + DELTA_TARGET_SIZE, NULL ) == 0 );
+
+  CHECK( TestReject( "truncated varint length", ( const uint8_t * )"\x00\x80", 2 ) == 0 );
+  CHECK( TestReject( "truncated varint displacement", ( const uint8_t * )"\x84\x81", 2 ) == 0 );
+  CHECK( TestReject( "overlong varint", ( const uint8_t * )"\x00\xC0\x80\x80\x80\x80\x00", 7 ) == 0 );
+  /* 64 + 2^32, the 64 bytes of the target follow */
+  memcpy( patch, "\x00\xC0\x80\x80\x80\x10", 6 );
+  memcpy( &patch[6], &Fw1[offset], DELTA_TARGET_SIZE );
+  CHECK( TestReject( "varint beyond 32 bits", patch, 6 + DELTA_TARGET_SIZE ) == 0 );
+  CHECK( TestReject( "zero length", ( const uint8_t * )"\x00\x00", 2 ) == 0 );
+  CHECK( TestReject( "INSERT past the target", ( const uint8_t * )"\x41\xAA", 2 ) == 0 );
+  CHECK( TestReject( "patch ending early", ( const uint8_t * )"\x04\xAA\xBB\xCC\xDD", 5 ) == 0 );
+  /* Cursor at offset: +64 starts at the end of the active FW, +56 ends 8 bytes after it */
+  CHECK( TestReject( "COPY from the end of the active FW", ( const uint8_t * )"\x90\x80\x01", 3 ) == 0 );
+  CHECK( TestReject( "COPY across the end of the active FW", ( const uint8_t * )"\x90\x70", 2 ) == 0 );
+  /* -(2^31): before the beginning of the active FW */
+  CHECK( TestReject( "COPY before the active FW", ( const uint8_t * )"\x90\xFF\xFF\xFF\xFF\x0F", 6 ) == 0 );
+  CHECK( TestReject( "COPY past the target", ( const uint8_t * )"\xC1\x00", 2 ) == 0 );
+  return 0;
+}
+
+/* Exported functions ------------------------------------------------------- */
+int main( int argc, char **argv )
+{
+  char offset[16] = { 0 };
+
+  if( ( argc == 5 ) && ( strcmp( argv[1], "-i" ) == 0 ) )
+  {
+    uint8_t tag[SE_TAG_LEN];
+
+    MakeImages( );
+    Mock_Tag( Fw1, Fw1Size, tag );
+    WriteFile( argv[2], Fw1, Fw1Size );
+    WriteFile( argv[3], Fw2, Fw2Size );
+    WriteFile( argv[4], tag, sizeof( tag ) );
+    return 0;
+  }
+  if( argc != 6 )
+  {
+    fprintf( stderr, "usage: %s <v1> <v2> <patch> <patch offset> <delta descriptor>\n"
+             "       %s -i <v1> <v2> <v1 tag>\n", argv[0], argv[0] );
+    return 2;
+  }
+  Fw1Size = ReadFile( argv[1], Fw1, sizeof( Fw1 ) );
+  Fw2Size = ReadFile( argv[2], Fw2, sizeof( Fw2 ) );
+  PatchSize = ReadFile( argv[3], Patch, sizeof( Patch ) );
+  ReadFile( argv[4], offset, sizeof( offset ) - 1 );
+  PatchOffset = strtoul( offset, NULL, 10 );
+  if( ReadFile( argv[5], &Descriptor, sizeof( Descriptor ) ) != sizeof( Descriptor ) )
+  {
+    fprintf( stderr, "%s: wrong delta descriptor\n", argv[5] );
+    return 2;
+  }
+  if( Mock_FlashInit( ) != 0 )
+  {
+    return 2;
+  }
+
+  if( TestRoundTrip( ) != 0 )
+  {
+    printf( "FAILED: round trip of the prepareimage.py patch\n" );
+    return 1;
+  }
+  if( TestPatches( ) != 0 )
+  {
+    printf( "FAILED: hand-made patches\n" );
+    return 1;
+  }
+  printf( "delta_test: OK\n" );
+  return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
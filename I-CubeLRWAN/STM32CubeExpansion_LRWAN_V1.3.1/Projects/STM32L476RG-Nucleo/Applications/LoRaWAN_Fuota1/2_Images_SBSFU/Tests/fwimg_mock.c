@@ -0,0 +1,352 @@
+/**
+  ******************************************************************************
+  * @file    fwimg_mock.c
+  * @author  MCD Application Team
+  * @brief   Host replacement of the FLASH and Secure Engine for the FWIMG tests
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+/*
+ * The FLASH is mapped at its address on the target, so that sfu_fwimg_core.c
+ * reads it directly as it does on the target, and is programmed with the rules
+ * of the STM32L4: double words programmed once between erases (except to 0),
+ * pages of FLASH_PAGE_SIZE bytes erased. An access the target would reject is
+ * counted in MockFlashErrors and not done.
+ * Each double word programmed and each page erased is a FLASH operation: when
+ * MockFlashBudget operations have been done, the next one resets the device
+ * (longjmp to MockReset) before being done.
+ * The Secure Engine keeps the FW in clear (SFU_CLEAR_IMAGE) and the tag of a FW
+ * stands for its SHA-256; the header MAC is the tag of the header.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <sys/mman.h>
+#include "fwimg_mock.h"
+#include "sfu_fsm_states.h"
+#include "sfu_error.h"
+#include "sfu_low_level_flash.h"
+#include "sfu_low_level_security.h"
+#include "sfu_fwimg_regions.h"
+#include "sfu_fwimg_services.h"
+#include "sfu_fwimg_internal.h"
+#include "se_interface_bootloader.h"
+
+/* Private define ------------------------------------------------------------*/
+#define MOCK_MAGIC_LENGTH                           32U   /* MAGIC_LENGTH of sfu_low_level_flash.h */
+#define MOCK_TAG_LANES                              ( SE_TAG_LEN / 8 )
+
+/* Private variables ---------------------------------------------------------*/
+int32_t MockFlashBudget = -1;
+jmp_buf MockReset;
+uint32_t MockFlashErrors = 0;
+uint32_t MockFlashOperations = 0;
+uint32_t MockSlot0Modified = 0;
+
+uint32_t uFlowCryptoValue;
+
+/* FNV-1a lanes of the tag being computed by SE_AuthenticateFW */
+static uint64_t AuthLanes[MOCK_TAG_LANES];
+
+/* Private functions ---------------------------------------------------------*/
+static uint8_t *FlashAddress( uint32_t Address )
+{
+  return ( uint8_t * )( uintptr_t )Address;
+}
+
+static int32_t InRegion( uint32_t Address, uint32_t Length, uint32_t Begin, uint32_t Size )
+{
+  return ( Address >= Begin ) && ( Length <= Size ) && ( ( Address - Begin ) <= ( Size - Length ) );
+}
+
+/* The FWIMG module only accesses the slots and the swap area */
+static int32_t InSlots( uint32_t Address, uint32_t Length )
+{
+  return InRegion( Address, Length, SFU_IMG_SLOT_0_REGION_BEGIN_VALUE, SFU_IMG_SLOT_0_REGION_SIZE )
+         || InRegion( Address, Length, SFU_IMG_SLOT_1_REGION_BEGIN_VALUE, SFU_IMG_SLOT_1_REGION_SIZE )
+         || InRegion( Address, Length, SFU_IMG_SWAP_REGION_BEGIN_VALUE, SFU_IMG_SWAP_REGION_SIZE );
+}
+
+static void FlashOperation( uint32_t Address )
+{
+  if( MockFlashBudget == 0 )
+  {
+    longjmp( MockReset, 1 );
+  }
+  if( MockFlashBudget > 0 )
+  {
+    MockFlashBudget--;
+  }
+  MockFlashOperations++;
+  if( InRegion( Address, 1, SFU_IMG_SLOT_0_REGION_BEGIN_VALUE, SFU_IMG_SLOT_0_REGION_SIZE ) )
+  {
+    MockSlot0Modified = 1;
+  }
+}
+
+static void TagInit( uint64_t *pLanes )
+{
+  uint32_t i;
+
+  for( i = 0; i < MOCK_TAG_LANES; i++ )
+  {
+    pLanes[i] = 0xCBF29CE484222325ULL + i;
+  }
+}
+
+static void TagAppend( uint64_t *pLanes, const uint8_t *pData, uint32_t Size )
+{
+  uint32_t i;
+  uint32_t j;
+
+  for( i = 0; i < Size; i++ )
+  {
+    for( j = 0; j < MOCK_TAG_LANES; j++ )
+    {
+      pLanes[j] = ( pLanes[j] ^ pData[i] ) * 0x100000001B3ULL;
+    }
+  }
+}
+
+static void TagFinish( uint64_t *pLanes, uint8_t *pTag )
+{
+  memcpy( pTag, pLanes, SE_TAG_LEN );
+}
+
+static void HeaderMac( const SE_FwRawHeaderTypeDef *pHeader, uint8_t *pMac )
+{
+  uint32_t i;
+
+  Mock_Tag( ( const uint8_t * )pHeader, offsetof( SE_FwRawHeaderTypeDef, HeaderMAC ), pMac );
+  for( i = SE_TAG_LEN; i < sizeof( pHeader->HeaderMAC ); i++ )
+  {
+    pMac[i] = pMac[i - SE_TAG_LEN] ^ 0x5A;
+  }
+}
+
+/* Exported functions ------------------------------------------------------- */
+int32_t Mock_FlashInit( void )
+{
+  void *flash = mmap( FlashAddress( FLASH_BASE ), MOCK_FLASH_SIZE, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0 );
+
+  if( flash != FlashAddress( FLASH_BASE ) )
+  {
+    fprintf( stderr, "cannot map the FLASH at 0x%08lx\n", FLASH_BASE );
+    return -1;
+  }
+  Mock_FlashErase( );
+  return 0;
+}
+
+void Mock_FlashErase( void )
+{
+  memset( FlashAddress( FLASH_BASE ), 0xFF, MOCK_FLASH_SIZE );
+  MockFlashBudget = -1;
+  MockFlashErrors = 0;
+  MockFlashOperations = 0;
+  MockSlot0Modified = 0;
+}
+
+void Mock_Tag( const uint8_t *pData, uint32_t Size, uint8_t *pTag )
+{
+  uint64_t lanes[MOCK_TAG_LANES];
+
+  TagInit( lanes );
+  TagAppend( lanes, pData, Size );
+  TagFinish( lanes, pTag );
+}
+
+void Mock_Header( SE_FwRawHeaderTypeDef *pHeader, uint16_t Version, const uint8_t *pFw, uint32_t FwSize,
+                  uint32_t PartialOffset, const uint8_t *pPartial, uint32_t PartialSize, const void *pReserved,
+                  uint32_t ReservedSize )
+{
+  memset( pHeader, 0x00, sizeof( *pHeader ) );
+  memcpy( &pHeader->SFUMagic, "SFUM", 4 );
+  pHeader->ProtocolVersion = 1;
+  pHeader->FwVersion = Version;
+  pHeader->FwSize = FwSize;
+  pHeader->PartialFwOffset = PartialOffset;
+  pHeader->PartialFwSize = PartialSize;
+  Mock_Tag( pFw, FwSize, pHeader->FwTag );
+  Mock_Tag( pPartial, PartialSize, pHeader->PartialFwTag );
+  if( pReserved != NULL )
+  {
+    memcpy( pHeader->Reserved, pReserved, ReservedSize );
+  }
+  HeaderMac( pHeader, pHeader->HeaderMAC );
+}
+
+void Mock_WriteActive( const SE_FwRawHeaderTypeDef *pHeader, const uint8_t *pFw )
+{
+  uint8_t *slot0 = SFU_IMG_SLOT_0_REGION_BEGIN;
+  uint32_t i;
+
+  /* The header tagged as VALID: followed by 3 copies of the beginning of its MAC */
+  memcpy( slot0, pHeader, sizeof( *pHeader ) );
+  for( i = 0; i < 3; i++ )
+  {
+    memcpy( slot0 + sizeof( *pHeader ) + i * MOCK_MAGIC_LENGTH, pHeader->HeaderMAC, MOCK_MAGIC_LENGTH );
+  }
+  memcpy( slot0 + SFU_IMG_IMAGE_OFFSET, pFw, pHeader->FwSize );
+}
+
+void Mock_WriteCandidate( const SE_FwRawHeaderTypeDef *pHeader, const uint8_t *pPartial )
+{
+  memcpy( SFU_IMG_SLOT_1_REGION_BEGIN, pHeader, sizeof( *pHeader ) );
+  memcpy( SFU_IMG_SWAP_REGION_BEGIN, pHeader, sizeof( *pHeader ) );
+  memcpy( SFU_IMG_SLOT_1_REGION_BEGIN + SFU_IMG_IMAGE_OFFSET + pHeader->PartialFwOffset % SFU_IMG_SWAP_REGION_SIZE,
+          pPartial, pHeader->PartialFwSize );
+}
+
+/* FLASH ---------------------------------------------------------------------*/
+SFU_ErrorStatus SFU_LL_FLASH_Write( SFU_FLASH_StatusTypeDef *pFlashStatus, void *pDestination, const void *pSource,
+                                    uint32_t Length )
+{
+  uint32_t address = ( uint32_t )( uintptr_t )pDestination;
+  const uint8_t *source = pSource;
+  uint64_t value;
+  uint32_t i;
+
+  *pFlashStatus = SFU_FLASH_ERROR;
+  if( ( ( address % sizeof( SFU_LL_FLASH_write_t ) ) != 0 ) || ( ( Length % sizeof( SFU_LL_FLASH_write_t ) ) != 0 )
+      || !InSlots( address, Length ) )
+  {
+    MockFlashErrors++;
+    return SFU_ERROR;
+  }
+  for( i = 0; i < Length; i += sizeof( SFU_LL_FLASH_write_t ) )
+  {
+    memcpy( &value, source + i, sizeof( value ) );
+    /* A double word is programmed once after an erase, it can only be programmed again to 0 */
+    if( ( value != 0 ) && ( *( uint64_t * )FlashAddress( address + i ) != UINT64_MAX ) )
+    {
+      MockFlashErrors++;
+      *pFlashStatus = SFU_FLASH_ERR_WRITING;
+      return SFU_ERROR;
+    }
+    FlashOperation( address + i );
+    memcpy( FlashAddress( address + i ), &value, sizeof( value ) );
+  }
+  *pFlashStatus = SFU_FLASH_SUCCESS;
+  return SFU_SUCCESS;
+}
+
+SFU_ErrorStatus SFU_LL_FLASH_Erase_Size( SFU_FLASH_StatusTypeDef *pFlashStatus, void *pStart, uint32_t Length )
+{
+  uint32_t address = ( uint32_t )( uintptr_t )pStart;
+  uint32_t page;
+
+  *pFlashStatus = SFU_FLASH_ERROR;
+  /* The target erases the whole pages holding the range */
+  if( ( ( address % FLASH_PAGE_SIZE ) != 0 ) || ( ( Length % FLASH_PAGE_SIZE ) != 0 ) || !InSlots( address, Length ) )
+  {
+    MockFlashErrors++;
+    return SFU_ERROR;
+  }
+  for( page = address; page < ( address + Length ); page += FLASH_PAGE_SIZE )
+  {
+    FlashOperation( page );
+    memset( FlashAddress( page ), 0xFF, FLASH_PAGE_SIZE );
+  }
+  *pFlashStatus = SFU_FLASH_SUCCESS;
+  return SFU_SUCCESS;
+}
+
+SFU_ErrorStatus SFU_LL_FLASH_Read( void *pDestination, const void *pSource, uint32_t Length )
+{
+  if( !InSlots( ( uint32_t )( uintptr_t )pSource, Length ) )
+  {
+    MockFlashErrors++;
+    return SFU_ERROR;
+  }
+  memcpy( pDestination, pSource, Length );
+  return SFU_SUCCESS;
+}
+
+SFU_ErrorStatus SFU_LL_SECU_IWDG_Refresh( void )
+{
+  return SFU_SUCCESS;
+}
+
+/* Secure Engine -------------------------------------------------------------*/
+SE_ErrorStatus SE_VerifyFwRawHeaderTag( SE_StatusTypeDef *peSE_Status, SE_FwRawHeaderTypeDef *pxFwRawHeader )
+{
+  uint8_t mac[sizeof( pxFwRawHeader->HeaderMAC )];
+
+  HeaderMac( pxFwRawHeader, mac );
+  *peSE_Status = SE_OK;
+  return ( memcmp( mac, pxFwRawHeader->HeaderMAC, sizeof( mac ) ) == 0 ) ? SE_SUCCESS : SE_ERROR;
+}
+
+SE_ErrorStatus SE_Decrypt_Init( SE_StatusTypeDef *peSE_Status, SE_FwRawHeaderTypeDef *pxSE_Metadata,
+                                int32_t SE_FwType )
+{
+  *peSE_Status = SE_OK;
+  return SE_SUCCESS;
+}
+
+SE_ErrorStatus SE_Decrypt_Append( SE_StatusTypeDef *peSE_Status, const uint8_t *pInputBuffer, int32_t InputSize,
+                                  uint8_t *pOutputBuffer, int32_t *pOutputSize )
+{
+  memcpy( pOutputBuffer, pInputBuffer, InputSize );
+  *pOutputSize = InputSize;
+  *peSE_Status = SE_OK;
+  return SE_SUCCESS;
+}
+
+SE_ErrorStatus SE_Decrypt_Finish( SE_StatusTypeDef *peSE_Status, uint8_t *pOutputBuffer, int32_t *pOutputSize )
+{
+  *pOutputSize = 0;
+  *peSE_Status = SE_OK;
+  return SE_SUCCESS;
+}
+
+SE_ErrorStatus SE_AuthenticateFW_Init( SE_StatusTypeDef *peSE_Status, SE_FwRawHeaderTypeDef *pxSE_Metadata,
+                                       int32_t SE_FwType )
+{
+  TagInit( AuthLanes );
+  *peSE_Status = SE_OK;
+  return SE_SUCCESS;
+}
+
+SE_ErrorStatus SE_AuthenticateFW_Append( SE_StatusTypeDef *peSE_Status, const uint8_t *pInputBuffer,
+                                         int32_t InputSize, uint8_t *pOutputBuffer, int32_t *pOutputSize )
+{
+  TagAppend( AuthLanes, pInputBuffer, InputSize );
+  *pOutputSize = InputSize;
+  *peSE_Status = SE_OK;
+  return SE_SUCCESS;
+}
+
+SE_ErrorStatus SE_AuthenticateFW_Finish( SE_StatusTypeDef *peSE_Status, uint8_t *pOutputBuffer, int32_t *pOutputSize )
+{
+  TagFinish( AuthLanes, pOutputBuffer );
+  *pOutputSize = SE_TAG_LEN;
+  *peSE_Status = SE_OK;
+  return SE_SUCCESS;
+}
+
+/* Bootloader ----------------------------------------------------------------*/
+SFU_ErrorStatus SFU_BOOT_SetLastExecError( uint32_t uLastExecError )
+{
+  return SFU_SUCCESS;
+}
+
+/* As in sfu_fwimg_services.c */
+SFU_ErrorStatus SFU_IMG_Validation( uint8_t *pHeader )
+{
+  return SFU_IMG_WriteHeaderValidated( pHeader );
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,365 @@
+/**
+  ******************************************************************************
+  * @file    swap_test.c
+  * @author  MCD Application Team
+  * @brief   Host test of the FW image swap of sfu_fwimg_core.c with resets
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2019 STMicroelectronics.
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed by ST under Ultimate Liberty license
+  * SLA0044, the "License"; You may not use this file except in compliance with
+  * the License. You may obtain a copy of the License at:
+  *                             www.st.com/SLA0044
+  *
+  ******************************************************************************
+  */
+/*
+ * sfu_fwimg_core.c is included and runs on the FLASH of fwimg_mock.c.
+ * A partial FW image is installed over the active FW, and the device is reset
+ * before each FLASH operation of the installation in turn: trailer writing,
+ * backup and installation of each block, block of slot #0 kept as is because
+ * the new FW does not change it, and erase of the blocks following the new
+ * FW. After each reset the boot resumes the installation as SBSFU does it,
+ * and is itself reset once more at a random point.
+ * Slot #0 must then hold the new FW, tagged as valid, as after an installation
+ * without reset, or the previous FW untouched when the reset came before the
+ * swap started. Slot #1 and the swap area must hold the same backup as after
+ * an installation without reset, except that a block kept in slot #0 can have
+ * been backed up.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "main.h"
+#include "sfu_trace.h"
+/* The traces of the FWIMG module are not printed */
+#undef TRACE
+#define TRACE( ... )
+#include "sfu_fwimg_core.c"
+#include "fwimg_mock.h"
+
+/* Private define ------------------------------------------------------------*/
+#define FW1_SIZE                                    50000U
+#define FW2_SIZE                                    42000U
+/*
+ * Partial image from the middle of block #1 of slot #0: changes in blocks #2, #4 and #5, blocks #1 and #3 kept.
+ * Block #1 is made of the initial image up to the partial image, and of the partial image.
+ */
+#define FW2_PARTIAL_OFFSET                          8992U
+#define FW2_CHANGE_1                                17000U
+#define FW2_CHANGE_2                                33000U
+#define BLOCK_SIZE                                  SFU_IMG_SWAP_REGION_SIZE
+#define SLOT_1_BLOCKS                               ( SFU_IMG_SLOT_1_REGION_SIZE / BLOCK_SIZE )
+#define RESUME_RESETS_RANGE                         20000U
+
+#define CHECK( cond )                               \
+  if( !( cond ) )                                   \
+  {                                                 \
+    printf( "  line %d: %s\n", __LINE__, #cond );   \
+    return -1;                                      \
+  }
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t Fw1[FW1_SIZE];
+static uint8_t Fw2[FW2_SIZE];
+
+/* FLASH before the installation, and after the installation without reset */
+static uint8_t Slot0Before[SFU_IMG_SLOT_0_REGION_SIZE];
+static uint8_t Slot1Before[SFU_IMG_SLOT_1_REGION_SIZE];
+static uint8_t SwapBefore[SFU_IMG_SWAP_REGION_SIZE];
+static uint8_t Slot0Installed[SFU_IMG_SLOT_0_REGION_SIZE];
+static uint8_t Slot1Installed[SFU_IMG_SLOT_1_REGION_SIZE];
+static uint8_t SwapInstalled[SFU_IMG_SWAP_REGION_SIZE];
+
+/* FWIMG module variables filled by the preparation */
+static uint8_t HeaderValidatedBefore[FW_INFO_TOT_LEN];
+static uint8_t HeaderToTestBefore[FW_INFO_TOT_LEN];
+static uint8_t TagValidatedBefore[SE_TAG_LEN];
+static SE_FwRawHeaderTypeDef ImageHeaderValidatedBefore;
+static SE_FwRawHeaderTypeDef ImageHeaderToTestBefore;
+
+static uint32_t RandomState = 0x2545F491;
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t Random( void )
+{
+  RandomState ^= RandomState << 13;
+  RandomState ^= RandomState >> 17;
+  RandomState ^= RandomState << 5;
+  return RandomState;
+}
+
+static void MakeImages( void )
+{
+  uint32_t i;
+
+  for( i = 0; i < FW1_SIZE; i++ )
+  {
+    Fw1[i] = ( uint8_t )Random( );
+  }
+  memcpy( Fw2, Fw1, FW2_SIZE );
+  for( i = FW2_CHANGE_1; i < ( FW2_CHANGE_1 + 100 ); i++ )
+  {
+    Fw2[i] ^= 0xA5;
+  }
+  for( i = FW2_CHANGE_2; i < FW2_SIZE; i++ )
+  {
+    Fw2[i] = ( uint8_t )Random( );
+  }
+}
+
+/* Boot with the FWIMG module variables of a reset */
+static int32_t Boot( void )
+{
+  memset( fw_header_validated, 0x00, sizeof( fw_header_validated ) );
+  memset( fw_header_to_test, 0x00, sizeof( fw_header_to_test ) );
+  memset( fw_tag_validated, 0x00, sizeof( fw_tag_validated ) );
+  memset( &fw_image_header_validated, 0x00, sizeof( fw_image_header_validated ) );
+  memset( &fw_image_header_to_test, 0x00, sizeof( fw_image_header_to_test ) );
+  CHECK( SFU_IMG_CoreInit( ) == SFU_IMG_INIT_OK );
+  return 0;
+}
+
+/* FW v1 active, FW v2 candidate checked and prepared for the swap */
+static int32_t Prepare( void )
+{
+  SE_FwRawHeaderTypeDef header;
+
+  Mock_FlashErase( );
+  Mock_Header( &header, MOCK_FW_VERSION_ACTIVE, Fw1, FW1_SIZE, 0, Fw1, FW1_SIZE, NULL, 0 );
+  Mock_WriteActive( &header, Fw1 );
+  Mock_Header( &header, MOCK_FW_VERSION_CANDIDATE, Fw2, FW2_SIZE, FW2_PARTIAL_OFFSET, &Fw2[FW2_PARTIAL_OFFSET],
+               FW2_SIZE - FW2_PARTIAL_OFFSET, NULL, 0 );
+  Mock_WriteCandidate( &header, &Fw2[FW2_PARTIAL_OFFSET] );
+  CHECK( Boot( ) == 0 );
+  CHECK( SFU_IMG_GetFWInfoMAC( &fw_image_header_validated, 0 ) == SFU_SUCCESS );
+  CHECK( SFU_IMG_CheckSlot0FwValid( ) == SFU_SUCCESS );
+  CHECK( SFU_IMG_FirmwareToInstall( ) == SFU_SUCCESS );
+  CHECK( SFU_IMG_CheckFwVersion( fw_image_header_validated.FwVersion, fw_image_header_to_test.FwVersion )
+         == SFU_SUCCESS );
+  CHECK( SFU_IMG_PrepareCandidateImageForInstall( ) == SFU_SUCCESS );
+  CHECK( MockFlashErrors == 0 );
+  return 0;
+}
+
+static void Save( uint8_t *pSlot0, uint8_t *pSlot1, uint8_t *pSwap )
+{
+  memcpy( pSlot0, SFU_IMG_SLOT_0_REGION_BEGIN, SFU_IMG_SLOT_0_REGION_SIZE );
+  memcpy( pSlot1, SFU_IMG_SLOT_1_REGION_BEGIN, SFU_IMG_SLOT_1_REGION_SIZE );
+  memcpy( pSwap, SFU_IMG_SWAP_REGION_BEGIN, SFU_IMG_SWAP_REGION_SIZE );
+}
+
+/* FLASH and FWIMG module variables as after the preparation */
+static void Restore( void )
+{
+  memcpy( SFU_IMG_SLOT_0_REGION_BEGIN, Slot0Before, SFU_IMG_SLOT_0_REGION_SIZE );
+  memcpy( SFU_IMG_SLOT_1_REGION_BEGIN, Slot1Before, SFU_IMG_SLOT_1_REGION_SIZE );
+  memcpy( SFU_IMG_SWAP_REGION_BEGIN, SwapBefore, SFU_IMG_SWAP_REGION_SIZE );
+  memcpy( fw_header_validated, HeaderValidatedBefore, sizeof( fw_header_validated ) );
+  memcpy( fw_header_to_test, HeaderToTestBefore, sizeof( fw_header_to_test ) );
+  memcpy( fw_tag_validated, TagValidatedBefore, sizeof( fw_tag_validated ) );
+  fw_image_header_validated = ImageHeaderValidatedBefore;
+  fw_image_header_to_test = ImageHeaderToTestBefore;
+  MockFlashBudget = -1;
+  MockFlashErrors = 0;
+  MockSlot0Modified = 0;
+}
+
+/* Block kept in slot #0 by the installation: the new FW does not change it */
+static int32_t KeptBlock( const uint8_t *pBlock )
+{
+  uint32_t i;
+
+  /* Block #0 holds the header: it is always swapped */
+  for( i = BLOCK_SIZE; i < SFU_IMG_SLOT_0_REGION_SIZE; i += BLOCK_SIZE )
+  {
+    if( ( memcmp( &Slot0Before[i], &Slot0Installed[i], BLOCK_SIZE ) == 0 )
+        && ( memcmp( &Slot0Before[i], pBlock, BLOCK_SIZE ) == 0 ) )
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* Backup block of slot #1 or swap area: as without reset, or a kept block backed up in a block left as is */
+static int32_t CheckBackup( const uint8_t *pBlock, const uint8_t *pInstalled, const uint8_t *pBefore )
+{
+  if( memcmp( pBlock, pInstalled, BLOCK_SIZE ) == 0 )
+  {
+    return 0;
+  }
+  CHECK( memcmp( pInstalled, pBefore, BLOCK_SIZE ) == 0 );
+  CHECK( KeptBlock( pBlock ) );
+  return 0;
+}
+
+/* Boot after a reset: installation resumed if the trailer is valid, with the FLASH operations budget given */
+static int32_t Resume( int32_t Budget )
+{
+  CHECK( Boot( ) == 0 );
+  if( SFU_IMG_CheckTrailerValid( ) == SFU_SUCCESS )
+  {
+    MockFlashBudget = Budget;
+    CHECK( SFU_IMG_Resume( ) == SFU_SUCCESS );
+    MockFlashBudget = -1;
+  }
+  return 0;
+}
+
+/* FLASH after the installation with resets */
+static int32_t CheckFlash( int32_t *pInstalled )
+{
+  SE_StatusTypeDef se_status;
+  uint32_t i;
+
+  CHECK( MockFlashErrors == 0 );
+  CHECK( Boot( ) == 0 );
+  CHECK( SFU_IMG_CheckTrailerValid( ) != SFU_SUCCESS );
+  CHECK( SFU_IMG_GetFWInfoMAC( &fw_image_header_validated, 0 ) == SFU_SUCCESS );
+  CHECK( SFU_IMG_CheckSlot0FwValid( ) == SFU_SUCCESS );
+  CHECK( SFU_IMG_VerifyFwSignature( &se_status, &fw_image_header_validated, 0, SE_FW_IMAGE_COMPLETE )
+         == SFU_SUCCESS );
+  if( fw_image_header_validated.FwVersion == MOCK_FW_VERSION_ACTIVE )
+  {
+    /* Reset before the swap: the candidate is not installed */
+    CHECK( MockSlot0Modified == 0 );
+    *pInstalled = 0;
+    return 0;
+  }
+  CHECK( fw_image_header_validated.FwVersion == MOCK_FW_VERSION_CANDIDATE );
+  /* A reset during the validation can leave the third copy of the VALID tag unwritten: it is not checked */
+  for( i = FW_INFO_TOT_LEN + ( 2U * MAGIC_LENGTH ); i < ( FW_INFO_TOT_LEN + VALID_SIZE ); i++ )
+  {
+    CHECK( ( SFU_IMG_SLOT_0_REGION_BEGIN[i] == Slot0Installed[i] ) || ( SFU_IMG_SLOT_0_REGION_BEGIN[i] == 0xFF ) );
+  }
+  i = FW_INFO_TOT_LEN + ( 2U * MAGIC_LENGTH );
+  CHECK( memcmp( SFU_IMG_SLOT_0_REGION_BEGIN, Slot0Installed, i ) == 0 );
+  i = FW_INFO_TOT_LEN + VALID_SIZE;
+  CHECK( memcmp( SFU_IMG_SLOT_0_REGION_BEGIN + i, &Slot0Installed[i], SFU_IMG_SLOT_0_REGION_SIZE - i ) == 0 );
+  for( i = 0; i < ( SLOT_1_BLOCKS - 1U ); i++ )
+  {
+    CHECK( CheckBackup( SFU_IMG_SLOT_1_REGION_BEGIN + ( i * BLOCK_SIZE ), &Slot1Installed[i * BLOCK_SIZE],
+                        &Slot1Before[i * BLOCK_SIZE] ) == 0 );
+  }
+  /* The last block of slot #1 ends with the trailer */
+  i = ( SLOT_1_BLOCKS - 1U ) * BLOCK_SIZE;
+  CHECK( memcmp( SFU_IMG_SLOT_1_REGION_BEGIN + i, &Slot1Installed[i], TRAILER_BEGIN - SFU_IMG_SLOT_1_REGION_BEGIN - i )
+         == 0 );
+  CHECK( CheckBackup( SFU_IMG_SWAP_REGION_BEGIN, SwapInstalled, SwapBefore ) == 0 );
+  *pInstalled = 1;
+  return 0;
+}
+
+/* Installation without reset */
+static int32_t TestInstall( uint32_t *pOperations )
+{
+  uint32_t i;
+  uint32_t kept = 0;
+  uint32_t erased = 0;
+
+  CHECK( Prepare( ) == 0 );
+  Save( Slot0Before, Slot1Before, SwapBefore );
+  memcpy( HeaderValidatedBefore, fw_header_validated, sizeof( HeaderValidatedBefore ) );
+  memcpy( HeaderToTestBefore, fw_header_to_test, sizeof( HeaderToTestBefore ) );
+  memcpy( TagValidatedBefore, fw_tag_validated, sizeof( TagValidatedBefore ) );
+  ImageHeaderValidatedBefore = fw_image_header_validated;
+  ImageHeaderToTestBefore = fw_image_header_to_test;
+  MockFlashOperations = 0;
+  MockSlot0Modified = 0;
+  CHECK( SFU_IMG_InstallNewVersion( ) == SFU_SUCCESS );
+  *pOperations = MockFlashOperations;
+  Save( Slot0Installed, Slot1Installed, SwapInstalled );
+
+  /* New FW active, nothing left after it */
+  CHECK( MockFlashErrors == 0 );
+  CHECK( memcmp( &Slot0Installed[SFU_IMG_IMAGE_OFFSET], Fw2, FW2_SIZE ) == 0 );
+  for( i = SFU_IMG_IMAGE_OFFSET + FW2_SIZE; i < SFU_IMG_SLOT_0_REGION_SIZE; i++ )
+  {
+    CHECK( Slot0Installed[i] == 0xFF );
+  }
+
+  /* The test covers a kept block and erased blocks */
+  for( i = BLOCK_SIZE; i < SFU_IMG_SLOT_0_REGION_SIZE; i += BLOCK_SIZE )
+  {
+    if( memcmp( &Slot0Before[i], &Slot0Installed[i], BLOCK_SIZE ) == 0 )
+    {
+      kept += ( Slot0Before[i] != 0xFF ) ? 1U : 0U;
+    }
+    else
+    {
+      erased += ( i >= ( SFU_IMG_IMAGE_OFFSET + FW2_SIZE ) ) ? 1U : 0U;
+    }
+  }
+  printf( "installation: %u FLASH operations, %u block(s) kept, %u block(s) erased after the FW\n",
+          ( unsigned )*pOperations, ( unsigned )kept, ( unsigned )erased );
+  CHECK( kept == 2 );
+  CHECK( erased > 0 );
+  return 0;
+}
+
+/* Reset before the FLASH operation Operation of the installation, then before a random one of the resume */
+static int32_t TestReset( uint32_t Operation, int32_t *pInstalled )
+{
+  volatile int32_t resets = 0;
+
+  Restore( );
+  if( setjmp( MockReset ) == 0 )
+  {
+    MockFlashBudget = Operation;
+    ( void )SFU_IMG_InstallNewVersion( );
+    CHECK( 0 );
+  }
+  if( ( resets++ ) == 0 )
+  {
+    if( setjmp( MockReset ) == 0 )
+    {
+      CHECK( Resume( Random( ) % RESUME_RESETS_RANGE ) == 0 );
+    }
+  }
+  if( resets == 1 )
+  {
+    resets++;
+    CHECK( Resume( -1 ) == 0 );
+  }
+  return CheckFlash( pInstalled );
+}
+
+/* Exported functions ------------------------------------------------------- */
+int main( void )
+{
+  uint32_t operations;
+  uint32_t operation;
+  uint32_t installed = 0;
+  int32_t is_installed;
+
+  if( Mock_FlashInit( ) != 0 )
+  {
+    return 2;
+  }
+  MakeImages( );
+  if( TestInstall( &operations ) != 0 )
+  {
+    printf( "FAILED: installation without reset\n" );
+    return 1;
+  }
+  for( operation = 0; operation < operations; operation++ )
+  {
+    if( TestReset( operation, &is_installed ) != 0 )
+    {
+      printf( "FAILED: reset before FLASH operation %u of the installation\n", ( unsigned )operation );
+      return 1;
+    }
+    installed += ( uint32_t )is_installed;
+  }
+  printf( "%u resets: FW installed after %u, previous FW kept after %u\n", ( unsigned )operations,
+          ( unsigned )installed, ( unsigned )( operations - installed ) );
+  printf( "swap_test: OK\n" );
+  return 0;
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,134 @@
+/**
+  ******************************************************************************
+  * @file    Host.c
+  * @author  Central LAB
+  * @version V4.0.0
+  * @date    30-Oct-2019
+  * @brief   Generic services of the Linux host board
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2018 STMicroelectronics</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without modification,
+  * are permitted provided that the following conditions are met:
+  *   1. Redistributions of source code must retain the above copyright notice,
+  *      this list of conditions and the following disclaimer.
+  *   2. Redistributions in binary form must reproduce the above copyright notice,
+  *      this list of conditions and the following disclaimer in the documentation
+  *      and/or other materials provided with the distribution.
+  *   3. Neither the name of STMicroelectronics nor the names of its contributors
+  *      may be used to endorse or promote products derived from this software
+  *      without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <unistd.h>
+#include "Host.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/** @addtogroup HOST
+  * @{
+  */
+
+/** @defgroup HOST_Exported_Functions HOST Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Provides a tick value in millisecond
+  * @note   The tick of the kernel is used as time base, as on the boards
+  *         where SysTick feeds both the HAL and FreeRTOS
+  * @retval Tick value
+  */
+uint32_t HAL_GetTick(void)
+{
+  return (uint32_t)xTaskGetTickCount() * portTICK_PERIOD_MS;
+}
+
+/**
+  * @brief  Provides a minimum delay in millisecond
+  * @param  Delay  Delay length, in milliseconds
+  * @retval None
+  */
+void HAL_Delay(uint32_t Delay)
+{
+  if(xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+  {
+    vTaskDelay(Delay / portTICK_PERIOD_MS + 1);
+  }
+  else
+  {
+    usleep(Delay * 1000U);
+  }
+}
+
+/**
+  * @brief  BSP time base for the HCI transport layer
+  * @retval Tick value
+  */
+int32_t BSP_GetTick(void)
+{
+  return (int32_t)HAL_GetTick();
+}
+
+/**
+  * @brief  Get the interrupt mask
+  * @retval Always 0: see __set_PRIMASK()
+  */
+uint32_t __get_PRIMASK(void)
+{
+  return 0;
+}
+
+/**
+  * @brief  Disable the interrupts
+  * @retval None
+  */
+void __disable_irq(void)
+{
+  taskENTER_CRITICAL();
+}
+
+/**
+  * @brief  Restore the interrupt mask read by __get_PRIMASK()
+  * @param  priMask Value returned by __get_PRIMASK() before __disable_irq()
+  * @retval None
+  */
+void __set_PRIMASK(uint32_t priMask)
+{
+  (void)priMask;
+  taskEXIT_CRITICAL();
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
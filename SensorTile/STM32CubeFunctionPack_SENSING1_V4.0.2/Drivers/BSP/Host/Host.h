@@ -0,0 +1,122 @@
+/**
+  ******************************************************************************
+  * @file    Host.h
+  * @author  Central LAB
+  * @version V4.0.0
+  * @date    30-Oct-2019
+  * @brief   Generic services of the Linux host board
+  *
+  *          Stand-ins for the few HAL and CMSIS services used by the middlewares
+  *          when the application runs as a Linux process on the FreeRTOS Posix
+  *          port (portable/GCC/Posix): time base, delays and the PRIMASK based
+  *          critical sections of the BlueNRG utilities.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2018 STMicroelectronics</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without modification,
+  * are permitted provided that the following conditions are met:
+  *   1. Redistributions of source code must retain the above copyright notice,
+  *      this list of conditions and the following disclaimer.
+  *   2. Redistributions in binary form must reproduce the above copyright notice,
+  *      this list of conditions and the following disclaimer in the documentation
+  *      and/or other materials provided with the distribution.
+  *   3. Neither the name of STMicroelectronics nor the names of its contributors
+  *      may be used to endorse or promote products derived from this software
+  *      without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HOST_H
+#define __HOST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/** @addtogroup HOST
+  * @{
+  */
+
+/** @defgroup HOST_Exported_Constants HOST Exported Constants
+  * @{
+  */
+
+/* Same values as the <board>_errno.h of the STM32 boards */
+#define BSP_ERROR_NONE                    0
+#define BSP_ERROR_NO_INIT                -1
+#define BSP_ERROR_WRONG_PARAM            -2
+#define BSP_ERROR_BUSY                   -3
+#define BSP_ERROR_PERIPH_FAILURE         -4
+#define BSP_ERROR_COMPONENT_FAILURE      -5
+#define BSP_ERROR_UNKNOWN_FAILURE        -6
+#define BSP_ERROR_UNKNOWN_COMPONENT      -7
+
+#ifndef __IO
+#define __IO volatile
+#endif
+
+#ifndef __weak
+#define __weak __attribute__((weak))
+#endif
+
+/**
+  * @}
+  */
+
+/** @defgroup HOST_Exported_Functions HOST Exported Functions
+  * @{
+  */
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+int32_t BSP_GetTick(void);
+
+/* Only the sequence used by the BlueNRG list utilities is supported:
+   __get_PRIMASK(), __disable_irq() then __set_PRIMASK() with the value read.
+   The interrupts are the signals of the FreeRTOS Posix port, so this is a
+   kernel critical section. */
+uint32_t __get_PRIMASK(void);
+void __disable_irq(void);
+void __set_PRIMASK(uint32_t priMask);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
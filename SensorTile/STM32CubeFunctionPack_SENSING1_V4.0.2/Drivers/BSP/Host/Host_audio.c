@@ -0,0 +1,615 @@
+/**
+  ******************************************************************************
+  * @file    Host_audio.c
+  * @author  Central LAB
+  * @version V4.0.0
+  * @date    30-Oct-2019
+  * @brief   WAV-file microphone of the Linux host board
+  *
+  *          A task at the highest priority plays the role of the DMA: it copies
+  *          the samples of the file into the record buffer at the sample rate
+  *          of the file, using the kernel tick as clock, and calls the half and
+  *          complete transfer callbacks from there. The file is played in loop.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2018 STMicroelectronics</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without modification,
+  * are permitted provided that the following conditions are met:
+  *   1. Redistributions of source code must retain the above copyright notice,
+  *      this list of conditions and the following disclaimer.
+  *   2. Redistributions in binary form must reproduce the above copyright notice,
+  *      this list of conditions and the following disclaimer in the documentation
+  *      and/or other materials provided with the distribution.
+  *   3. Neither the name of STMicroelectronics nor the names of its contributors
+  *      may be used to endorse or promote products derived from this software
+  *      without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "Host_audio.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/** @addtogroup HOST
+  * @{
+  */
+
+/** @defgroup HOST_AUDIO HOST_AUDIO
+  * @{
+  */
+
+/** @defgroup HOST_AUDIO_Private_Defines HOST_AUDIO Private Defines
+  * @{
+  */
+
+/* Priority of the task moving the samples: above the application tasks, as
+   the DMA interrupt on the boards */
+#ifndef HOST_AUDIO_IN_TASK_PRIORITY
+#define HOST_AUDIO_IN_TASK_PRIORITY        (configMAX_PRIORITIES - 1)
+#endif
+
+#define HOST_AUDIO_IN_TASK_STACK_SIZE      (configMINIMAL_STACK_SIZE * 2)
+
+#define WAV_FORMAT_PCM                     1U
+
+/**
+  * @}
+  */
+
+/** @defgroup HOST_AUDIO_Private_Types HOST_AUDIO Private Types
+  * @{
+  */
+typedef struct
+{
+  uint32_t  Instance;        /* Audio IN instance recording       */
+  uint32_t  SampleRate;      /* Audio IN Sample rate              */
+  uint32_t  ChannelsNbr;     /* Audio IN number of channel        */
+  uint32_t  Volume;          /* Audio IN volume                   */
+  __IO uint32_t State;       /* Audio IN State                    */
+  uint8_t  *pBuff;           /* Audio IN record buffer            */
+  uint32_t  Size;            /* Audio IN record buffer size       */
+  FILE     *File;            /* WAV file                          */
+  long      DataStart;       /* Offset of the samples in the file */
+  uint32_t  DataSize;        /* Size of the samples in the file   */
+  uint32_t  DataPos;         /* Offset of the next sample to read */
+  uint32_t  HalfCount;       /* Half buffers delivered            */
+  TickType_t StartTick;      /* Tick of the first sample          */
+  TaskHandle_t Task;         /* Task playing the DMA              */
+} HOST_AUDIO_IN_Ctx_t;
+/**
+  * @}
+  */
+
+/** @defgroup HOST_AUDIO_Private_Variables HOST_AUDIO Private Variables
+  * @{
+  */
+static const char *AudioInPath = "mic.wav";
+static HOST_AUDIO_IN_Ctx_t AudioInCtx;
+/**
+  * @}
+  */
+
+/** @defgroup HOST_AUDIO_Private_Functions HOST_AUDIO Private Functions
+  * @{
+  */
+
+static uint32_t ReadLE(const uint8_t *pData, uint32_t Size)
+{
+  uint32_t Value = 0;
+
+  while(Size > 0U)
+  {
+    Size--;
+    Value = (Value << 8) | pData[Size];
+  }
+
+  return Value;
+}
+
+/**
+  * @brief  Opens the WAV file and checks its format against the one requested
+  * @param  AudioInit  Requested format
+  * @retval BSP status
+  */
+static int32_t WavOpen(BSP_AUDIO_Init_t *AudioInit)
+{
+  uint8_t Header[16];
+  uint32_t ChunkSize;
+  int32_t FmtFound = 0;
+
+  AudioInCtx.File = fopen(AudioInPath, "rb");
+  if(AudioInCtx.File == NULL)
+  {
+    return BSP_ERROR_PERIPH_FAILURE;
+  }
+
+  if((fread(Header, 1, 12, AudioInCtx.File) != 12) ||
+     (memcmp(Header, "RIFF", 4) != 0) || (memcmp(&Header[8], "WAVE", 4) != 0))
+  {
+    return BSP_ERROR_COMPONENT_FAILURE;
+  }
+
+  /* Walk the chunks up to the samples */
+  while(fread(Header, 1, 8, AudioInCtx.File) == 8)
+  {
+    ChunkSize = ReadLE(&Header[4], 4);
+
+    if(memcmp(Header, "fmt ", 4) == 0)
+    {
+      if((ChunkSize < 16U) || (fread(Header, 1, 16, AudioInCtx.File) != 16))
+      {
+        return BSP_ERROR_COMPONENT_FAILURE;
+      }
+      if((ReadLE(&Header[0], 2) != WAV_FORMAT_PCM) ||
+         (ReadLE(&Header[2], 2) != AudioInit->ChannelsNbr) ||
+         (ReadLE(&Header[4], 4) != AudioInit->SampleRate) ||
+         (ReadLE(&Header[14], 2) != AudioInit->BitsPerSample))
+      {
+        return BSP_ERROR_WRONG_PARAM;
+      }
+      FmtFound = 1;
+      ChunkSize -= 16U;
+    }
+    else if(memcmp(Header, "data", 4) == 0)
+    {
+      if((FmtFound == 0) || (ChunkSize == 0U))
+      {
+        return BSP_ERROR_COMPONENT_FAILURE;
+      }
+      AudioInCtx.DataStart = ftell(AudioInCtx.File);
+      AudioInCtx.DataSize = ChunkSize - (ChunkSize % (2U * AudioInit->ChannelsNbr));
+      AudioInCtx.DataPos = 0;
+      return BSP_ERROR_NONE;
+    }
+
+    /* Chunks are word aligned */
+    if(fseek(AudioInCtx.File, (long)(ChunkSize + (ChunkSize & 1U)), SEEK_CUR) != 0)
+    {
+      break;
+    }
+  }
+
+  return BSP_ERROR_COMPONENT_FAILURE;
+}
+
+/**
+  * @brief  Fills one half of the record buffer with the next samples of the file
+  * @param  pDest  Half of the record buffer
+  * @param  Size  Size of the half buffer in bytes
+  * @retval BSP status
+  */
+static int32_t WavRead(uint8_t *pDest, uint32_t Size)
+{
+  uint32_t Len;
+
+  while(Size > 0U)
+  {
+    if(AudioInCtx.DataPos == AudioInCtx.DataSize)
+    {
+      AudioInCtx.DataPos = 0;
+    }
+    if(AudioInCtx.DataPos == 0U)
+    {
+      if(fseek(AudioInCtx.File, AudioInCtx.DataStart, SEEK_SET) != 0)
+      {
+        return BSP_ERROR_PERIPH_FAILURE;
+      }
+    }
+
+    Len = AudioInCtx.DataSize - AudioInCtx.DataPos;
+    if(Len > Size)
+    {
+      Len = Size;
+    }
+    if(fread(pDest, 1, Len, AudioInCtx.File) != Len)
+    {
+      return BSP_ERROR_PERIPH_FAILURE;
+    }
+    AudioInCtx.DataPos += Len;
+    pDest += Len;
+    Size -= Len;
+  }
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Tick at which the given number of half buffers have been recorded
+  * @param  HalfCount  Number of half buffers
+  * @retval Tick, relative to the first sample
+  */
+static TickType_t HalfBufferTick(uint32_t HalfCount)
+{
+  uint64_t Bytes = (uint64_t)HalfCount * (AudioInCtx.Size / 2U);
+  uint64_t BytesPerSecond = (uint64_t)AudioInCtx.SampleRate * AudioInCtx.ChannelsNbr * 2U;
+
+  return (TickType_t)((Bytes * configTICK_RATE_HZ) / BytesPerSecond);
+}
+
+/**
+  * @brief  Task playing the DMA of the microphone
+  * @param  argument  Not used
+  * @retval None
+  */
+static void AudioInTask(void *argument)
+{
+  uint32_t HalfSize;
+  TickType_t Elapsed;
+  TickType_t Due;
+  (void)argument;
+
+  for(;;)
+  {
+    if(AudioInCtx.State != AUDIO_IN_STATE_RECORDING)
+    {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      continue;
+    }
+
+    /* Wait for the samples of the next half buffer */
+    Due = HalfBufferTick(AudioInCtx.HalfCount + 1U);
+    Elapsed = xTaskGetTickCount() - AudioInCtx.StartTick;
+    if(Elapsed < Due)
+    {
+      ulTaskNotifyTake(pdTRUE, Due - Elapsed);
+      continue;
+    }
+
+    HalfSize = AudioInCtx.Size / 2U;
+    if(WavRead(AudioInCtx.pBuff + ((AudioInCtx.HalfCount & 1U) * HalfSize), HalfSize) != BSP_ERROR_NONE)
+    {
+      AudioInCtx.State = AUDIO_IN_STATE_STOP;
+      BSP_AUDIO_IN_Error_CallBack(AudioInCtx.Instance);
+      continue;
+    }
+
+    if((AudioInCtx.HalfCount & 1U) == 0U)
+    {
+      BSP_AUDIO_IN_HalfTransfer_CallBack(AudioInCtx.Instance);
+    }
+    else
+    {
+      BSP_AUDIO_IN_TransferComplete_CallBack(AudioInCtx.Instance);
+    }
+    AudioInCtx.HalfCount++;
+  }
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup HOST_AUDIO_Exported_Functions HOST_AUDIO Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Selects the WAV file played as microphone
+  * @param  Path  Path of the file, opened by the next BSP_AUDIO_IN_Init()
+  * @retval None
+  */
+void BSP_AUDIO_IN_SetSource(const char *Path)
+{
+  AudioInPath = Path;
+}
+
+/**
+  * @brief  Initializes the audio in peripheral
+  * @note   The WAV file must be 16-bit PCM with the requested sample rate
+  *         and number of channels
+  * @param  Instance  Audio IN instance
+  * @param  AudioInit  Audio IN init structure
+  * @retval BSP status
+  */
+int32_t BSP_AUDIO_IN_Init(uint32_t Instance, BSP_AUDIO_Init_t* AudioInit)
+{
+  int32_t ret;
+
+  if((Instance >= AUDIO_IN_INSTANCES_NBR) || (AudioInit->BitsPerSample != AUDIO_RESOLUTION_16b) ||
+     (AudioInit->ChannelsNbr == 0U))
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  if(AudioInCtx.State != AUDIO_IN_STATE_RESET)
+  {
+    return BSP_ERROR_BUSY;
+  }
+
+  ret = WavOpen(AudioInit);
+  if(ret != BSP_ERROR_NONE)
+  {
+    if(AudioInCtx.File != NULL)
+    {
+      fclose(AudioInCtx.File);
+      AudioInCtx.File = NULL;
+    }
+    return ret;
+  }
+
+  if((AudioInCtx.Task == NULL) &&
+     (xTaskCreate(AudioInTask, "AudioIn", HOST_AUDIO_IN_TASK_STACK_SIZE, NULL,
+                  HOST_AUDIO_IN_TASK_PRIORITY, &AudioInCtx.Task) != pdPASS))
+  {
+    fclose(AudioInCtx.File);
+    AudioInCtx.File = NULL;
+    return BSP_ERROR_NO_INIT;
+  }
+
+  AudioInCtx.Instance = Instance;
+  AudioInCtx.SampleRate = AudioInit->SampleRate;
+  AudioInCtx.ChannelsNbr = AudioInit->ChannelsNbr;
+  AudioInCtx.Volume = AudioInit->Volume;
+  AudioInCtx.State = AUDIO_IN_STATE_STOP;
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Deinitializes the audio in peripheral
+  * @param  Instance  Audio IN instance
+  * @retval BSP status
+  */
+int32_t BSP_AUDIO_IN_DeInit(uint32_t Instance)
+{
+  if(Instance >= AUDIO_IN_INSTANCES_NBR)
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  AudioInCtx.State = AUDIO_IN_STATE_RESET;
+  if(AudioInCtx.File != NULL)
+  {
+    fclose(AudioInCtx.File);
+    AudioInCtx.File = NULL;
+  }
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Starts audio recording
+  * @note   As with the DMA in circular mode, the first half of pBuf is
+  *         filled before BSP_AUDIO_IN_HalfTransfer_CallBack() and the
+  *         second half before BSP_AUDIO_IN_TransferComplete_CallBack()
+  * @param  Instance  Audio IN instance
+  * @param  pBuf  Main buffer pointer for the recorded data storing
+  * @param  NbrOfBytes  Size of the record buffer
+  * @retval BSP status
+  */
+int32_t BSP_AUDIO_IN_Record(uint32_t Instance, uint8_t* pBuf, uint32_t NbrOfBytes)
+{
+  uint32_t Frame = 2U * AudioInCtx.ChannelsNbr;
+
+  if((Instance >= AUDIO_IN_INSTANCES_NBR) || (pBuf == NULL) || (NbrOfBytes < (2U * Frame)) ||
+     ((NbrOfBytes % (2U * Frame)) != 0U))
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  if(AudioInCtx.State == AUDIO_IN_STATE_RESET)
+  {
+    return BSP_ERROR_NO_INIT;
+  }
+
+  AudioInCtx.pBuff = pBuf;
+  AudioInCtx.Size = NbrOfBytes;
+  AudioInCtx.HalfCount = 0;
+  AudioInCtx.StartTick = xTaskGetTickCount();
+  AudioInCtx.State = AUDIO_IN_STATE_RECORDING;
+  xTaskNotifyGive(AudioInCtx.Task);
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Stops audio recording
+  * @param  Instance  Audio IN instance
+  * @retval BSP status
+  */
+int32_t BSP_AUDIO_IN_Stop(uint32_t Instance)
+{
+  if(Instance >= AUDIO_IN_INSTANCES_NBR)
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  if(AudioInCtx.State == AUDIO_IN_STATE_RESET)
+  {
+    return BSP_ERROR_NO_INIT;
+  }
+
+  AudioInCtx.State = AUDIO_IN_STATE_STOP;
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Pauses the audio file stream
+  * @param  Instance  Audio IN instance
+  * @retval BSP status
+  */
+int32_t BSP_AUDIO_IN_Pause(uint32_t Instance)
+{
+  if(Instance >= AUDIO_IN_INSTANCES_NBR)
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  if(AudioInCtx.State != AUDIO_IN_STATE_RECORDING)
+  {
+    return BSP_ERROR_BUSY;
+  }
+
+  AudioInCtx.State = AUDIO_IN_STATE_PAUSE;
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Resumes the audio file stream, from the next half buffer
+  * @param  Instance  Audio IN instance
+  * @retval BSP status
+  */
+int32_t BSP_AUDIO_IN_Resume(uint32_t Instance)
+{
+  if(Instance >= AUDIO_IN_INSTANCES_NBR)
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  if(AudioInCtx.State != AUDIO_IN_STATE_PAUSE)
+  {
+    return BSP_ERROR_BUSY;
+  }
+
+  AudioInCtx.StartTick = xTaskGetTickCount() - HalfBufferTick(AudioInCtx.HalfCount);
+  AudioInCtx.State = AUDIO_IN_STATE_RECORDING;
+  xTaskNotifyGive(AudioInCtx.Task);
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Sets the volume: recorded only, the samples are not scaled
+  * @param  Instance  Audio IN instance
+  * @param  Volume  Volume level to be returned
+  * @retval BSP status
+  */
+int32_t BSP_AUDIO_IN_SetVolume(uint32_t Instance, uint32_t Volume)
+{
+  if(Instance >= AUDIO_IN_INSTANCES_NBR)
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  AudioInCtx.Volume = Volume;
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Gets the volume
+  * @param  Instance  Audio IN instance
+  * @param  Volume  Volume level to be returned
+  * @retval BSP status
+  */
+int32_t BSP_AUDIO_IN_GetVolume(uint32_t Instance, uint32_t *Volume)
+{
+  if(Instance >= AUDIO_IN_INSTANCES_NBR)
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  *Volume = AudioInCtx.Volume;
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Gets the sample rate
+  * @param  Instance  Audio IN instance
+  * @param  SampleRate  Sample rate of the audio
+  * @retval BSP status
+  */
+int32_t BSP_AUDIO_IN_GetSampleRate(uint32_t Instance, uint32_t *SampleRate)
+{
+  if(Instance >= AUDIO_IN_INSTANCES_NBR)
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  *SampleRate = AudioInCtx.SampleRate;
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Gets the audio in state
+  * @param  Instance  Audio IN instance
+  * @param  State  Audio In state
+  * @retval BSP status
+  */
+int32_t BSP_AUDIO_IN_GetState(uint32_t Instance, uint32_t *State)
+{
+  if(Instance >= AUDIO_IN_INSTANCES_NBR)
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  *State = AudioInCtx.State;
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  User callback when record buffer is filled
+  * @param  Instance  Audio IN instance
+  * @retval None
+  */
+__weak void BSP_AUDIO_IN_TransferComplete_CallBack(uint32_t Instance)
+{
+  /* Prevent unused argument(s) compilation warning */
+  (void)Instance;
+}
+
+/**
+  * @brief  Manages the DMA Half Transfer complete event
+  * @param  Instance  Audio IN instance
+  * @retval None
+  */
+__weak void BSP_AUDIO_IN_HalfTransfer_CallBack(uint32_t Instance)
+{
+  /* Prevent unused argument(s) compilation warning */
+  (void)Instance;
+}
+
+/**
+  * @brief  Audio IN Error callback function
+  * @param  Instance  Audio IN instance
+  * @retval None
+  */
+__weak void BSP_AUDIO_IN_Error_CallBack(uint32_t Instance)
+{
+  /* Prevent unused argument(s) compilation warning */
+  (void)Instance;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
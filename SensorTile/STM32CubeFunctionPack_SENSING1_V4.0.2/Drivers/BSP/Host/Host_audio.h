@@ -0,0 +1,161 @@
+/**
+  ******************************************************************************
+  * @file    Host_audio.h
+  * @author  Central LAB
+  * @version V4.0.0
+  * @date    30-Oct-2019
+  * @brief   Header of the WAV-file microphone of the Linux host board
+  *
+  *          Same Audio IN API as SensorTile_audio.h: the PCM samples are read
+  *          from a 16-bit WAV file, in real time, and delivered to the record
+  *          buffer with the half and complete transfer callbacks of the DMA.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2018 STMicroelectronics</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without modification,
+  * are permitted provided that the following conditions are met:
+  *   1. Redistributions of source code must retain the above copyright notice,
+  *      this list of conditions and the following disclaimer.
+  *   2. Redistributions in binary form must reproduce the above copyright notice,
+  *      this list of conditions and the following disclaimer in the documentation
+  *      and/or other materials provided with the distribution.
+  *   3. Neither the name of STMicroelectronics nor the names of its contributors
+  *      may be used to endorse or promote products derived from this software
+  *      without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HOST_AUDIO_H
+#define __HOST_AUDIO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "Host.h"
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/** @addtogroup HOST
+  * @{
+  */
+
+/** @addtogroup HOST_AUDIO
+  * @{
+  */
+
+/** @defgroup HOST_AUDIO_Exported_Types HOST_AUDIO Exported Types
+  * @{
+  */
+
+typedef struct
+{
+  uint32_t                    Device;
+  uint32_t                    SampleRate;
+  uint32_t                    BitsPerSample;
+  uint32_t                    ChannelsNbr;
+  uint32_t                    Volume;
+}BSP_AUDIO_Init_t;
+
+/**
+  * @}
+  */
+
+/** @defgroup HOST_AUDIO_Exported_Constants HOST_AUDIO Exported Constants
+  * @{
+  */
+
+/* AUDIO FREQUENCY */
+#define AUDIO_FREQUENCY_8K     8000U
+#define AUDIO_FREQUENCY_16K    16000U
+#define AUDIO_FREQUENCY_32K    32000U
+#define AUDIO_FREQUENCY_48K    48000U
+
+/* AUDIO RESOLUTION */
+#define AUDIO_RESOLUTION_16b   16U
+
+/* Audio In devices */
+#define AUDIO_IN_DIGITAL_MIC1      0x10U
+#define AUDIO_IN_DIGITAL_MIC       (AUDIO_IN_DIGITAL_MIC1)
+
+/* Audio In states */
+#define AUDIO_IN_STATE_RESET               0U
+#define AUDIO_IN_STATE_RECORDING           1U
+#define AUDIO_IN_STATE_STOP                2U
+#define AUDIO_IN_STATE_PAUSE               3U
+
+/* Audio In instances number */
+#define AUDIO_IN_INSTANCES_NBR             2U
+
+/**
+  * @}
+  */
+
+/** @defgroup HOST_AUDIO_Exported_Functions HOST_AUDIO Exported Functions
+  * @{
+  */
+
+void    BSP_AUDIO_IN_SetSource(const char *Path);
+int32_t BSP_AUDIO_IN_Init(uint32_t Instance, BSP_AUDIO_Init_t* AudioInit);
+int32_t BSP_AUDIO_IN_DeInit(uint32_t Instance);
+int32_t BSP_AUDIO_IN_Record(uint32_t Instance, uint8_t* pBuf, uint32_t NbrOfBytes);
+int32_t BSP_AUDIO_IN_Stop(uint32_t Instance);
+int32_t BSP_AUDIO_IN_Pause(uint32_t Instance);
+int32_t BSP_AUDIO_IN_Resume(uint32_t Instance);
+int32_t BSP_AUDIO_IN_SetVolume(uint32_t Instance, uint32_t Volume);
+int32_t BSP_AUDIO_IN_GetVolume(uint32_t Instance, uint32_t *Volume);
+int32_t BSP_AUDIO_IN_GetSampleRate(uint32_t Instance, uint32_t *SampleRate);
+int32_t BSP_AUDIO_IN_GetState(uint32_t Instance, uint32_t *State);
+
+/* User Callbacks: user has to implement these functions in his code if they are needed. */
+/* This function should be implemented by the user application.
+   It is called into this driver when the current buffer is filled to prepare the next
+   buffer pointer and its size. */
+void BSP_AUDIO_IN_TransferComplete_CallBack(uint32_t Instance);
+void BSP_AUDIO_IN_HalfTransfer_CallBack(uint32_t Instance);
+
+/* This function is called when an Interrupt due to transfer error on or peripheral
+   error occurs. */
+void BSP_AUDIO_IN_Error_CallBack(uint32_t Instance);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_AUDIO_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,596 @@
+/**
+  ******************************************************************************
+  * @file    Host_motion_sensors.c
+  * @author  Central LAB
+  * @version V4.0.0
+  * @date    30-Oct-2019
+  * @brief   CSV-file motion sensors of the Linux host board
+  *
+  *          The file is the one written by the SD card data log (DataLog_Manager.c):
+  *          optional description lines, then the header "hh:mm:ss.ms, Annotation,
+  *          AccX [mg], AccY, AccZ, GyroX [mdps], ..." and one line per sample. The
+  *          columns are found by name, so any subset of Acc, Gyro and Mag can be
+  *          logged. The samples are replayed with their time stamps from the first
+  *          BSP_MOTION_SENSOR_Enable(): GetAxes() returns the last sample due.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2018 STMicroelectronics</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without modification,
+  * are permitted provided that the following conditions are met:
+  *   1. Redistributions of source code must retain the above copyright notice,
+  *      this list of conditions and the following disclaimer.
+  *   2. Redistributions in binary form must reproduce the above copyright notice,
+  *      this list of conditions and the following disclaimer in the documentation
+  *      and/or other materials provided with the distribution.
+  *   3. Neither the name of STMicroelectronics nor the names of its contributors
+  *      may be used to endorse or promote products derived from this software
+  *      without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Host_motion_sensors.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/** @addtogroup HOST
+  * @{
+  */
+
+/** @defgroup HOST_MOTION_SENSOR HOST_MOTION_SENSOR
+  * @{
+  */
+
+/** @defgroup HOST_MOTION_SENSOR_Private_Defines HOST_MOTION_SENSOR Private Defines
+  * @{
+  */
+#define AXES_ACC           0U
+#define AXES_GYRO          1U
+#define AXES_MAG           2U
+#define AXES_NBR           3U
+
+#define CSV_LINE_MAX_LEN   512U
+/**
+  * @}
+  */
+
+/** @defgroup HOST_MOTION_SENSOR_Private_Types HOST_MOTION_SENSOR Private Types
+  * @{
+  */
+typedef struct
+{
+  uint32_t Time;                   /* Time stamp in ms */
+  int32_t  Axes[AXES_NBR][3];      /* mg, mdps and mgauss */
+} HOST_MOTION_SENSOR_Sample_t;
+/**
+  * @}
+  */
+
+/** @defgroup HOST_MOTION_SENSOR_Private_Variables HOST_MOTION_SENSOR Private Variables
+  * @{
+  */
+static const char *MotionSensorPath = "mems.csv";
+static HOST_MOTION_SENSOR_Sample_t *Samples = NULL;
+static uint32_t SamplesNbr = 0;
+static uint32_t SampleIndex = 0;
+static uint8_t  SourceEnded = 0;
+static TickType_t StartTick;
+static uint8_t  Started = 0;
+
+static const uint32_t InstanceFunctions[MOTION_INSTANCES_NBR] =
+{
+  MOTION_ACCELERO | MOTION_GYRO,   /* LSM6DSM_0 */
+  MOTION_ACCELERO,                 /* LSM303AGR_ACC_0 */
+  MOTION_MAGNETO                   /* LSM303AGR_MAG_0 */
+};
+static uint32_t InitFunctions[MOTION_INSTANCES_NBR];
+static uint32_t EnabledFunctions[MOTION_INSTANCES_NBR];
+static float    SensorOdr[MOTION_INSTANCES_NBR][MOTION_FUNCTIONS_NBR];
+static int32_t  SensorFullScale[MOTION_INSTANCES_NBR][MOTION_FUNCTIONS_NBR];
+/**
+  * @}
+  */
+
+/** @defgroup HOST_MOTION_SENSOR_Private_Functions HOST_MOTION_SENSOR Private Functions
+  * @{
+  */
+
+/**
+  * @brief  Converts a function to its index in the samples
+  */
+static uint32_t FunctionIndex(uint32_t Function)
+{
+  return (Function == MOTION_GYRO) ? AXES_GYRO : ((Function == MOTION_ACCELERO) ? AXES_ACC : AXES_MAG);
+}
+
+/**
+  * @brief  Checks an instance and one of its functions
+  */
+static int32_t CheckFunction(uint32_t Instance, uint32_t Function)
+{
+  if((Instance >= MOTION_INSTANCES_NBR) ||
+     ((Function != MOTION_GYRO) && (Function != MOTION_ACCELERO) && (Function != MOTION_MAGNETO)) ||
+     ((InstanceFunctions[Instance] & Function) == 0U))
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Splits a line of the file in place
+  * @param  pLine  Line, modified
+  * @param  pField  Array of the fields found
+  * @param  MaxFields  Size of the array
+  * @retval Number of fields
+  */
+static uint32_t CsvSplit(char *pLine, char **pField, uint32_t MaxFields)
+{
+  uint32_t Count = 0;
+
+  while(Count < MaxFields)
+  {
+    while(*pLine == ' ')
+    {
+      pLine++;
+    }
+    pField[Count++] = pLine;
+    pLine = strchr(pLine, ',');
+    if(pLine == NULL)
+    {
+      break;
+    }
+    *pLine++ = '\0';
+  }
+
+  return Count;
+}
+
+/**
+  * @brief  Loads the samples of the file
+  * @retval BSP status
+  */
+static int32_t CsvLoad(void)
+{
+  char Line[CSV_LINE_MAX_LEN];
+  char *Field[32];
+  int32_t Column[AXES_NBR] = {-1, -1, -1};
+  static const char *ColumnName[AXES_NBR] = {"AccX", "GyroX", "MagX"};
+  uint32_t FieldsNbr;
+  uint32_t Axes;
+  uint32_t Axis;
+  uint32_t HeaderFound = 0;
+  unsigned Hours, Minutes, Seconds, Ms;
+  HOST_MOTION_SENSOR_Sample_t *pSample;
+  FILE *File;
+
+  File = fopen(MotionSensorPath, "r");
+  if(File == NULL)
+  {
+    return BSP_ERROR_PERIPH_FAILURE;
+  }
+
+  Samples = malloc(HOST_MOTION_SENSOR_MAX_SAMPLES * sizeof(HOST_MOTION_SENSOR_Sample_t));
+  if(Samples == NULL)
+  {
+    fclose(File);
+    return BSP_ERROR_NO_INIT;
+  }
+  SamplesNbr = 0;
+
+  while((fgets(Line, sizeof(Line), File) != NULL) && (SamplesNbr < HOST_MOTION_SENSOR_MAX_SAMPLES))
+  {
+    Line[strcspn(Line, "\r\n")] = '\0';
+    FieldsNbr = CsvSplit(Line, Field, sizeof(Field) / sizeof(Field[0]));
+
+    if(HeaderFound == 0U)
+    {
+      /* Skip the description of the acquisition, up to the header */
+      if(strncmp(Field[0], "hh:mm:ss", 8) != 0)
+      {
+        continue;
+      }
+      for(Axes = 0; Axes < AXES_NBR; Axes++)
+      {
+        for(Axis = 1; Axis < FieldsNbr; Axis++)
+        {
+          if(strncmp(Field[Axis], ColumnName[Axes], strlen(ColumnName[Axes])) == 0)
+          {
+            Column[Axes] = (int32_t)Axis;
+          }
+        }
+      }
+      HeaderFound = 1;
+      continue;
+    }
+
+    if(sscanf(Field[0], "%u:%u:%u.%u", &Hours, &Minutes, &Seconds, &Ms) != 4)
+    {
+      continue;
+    }
+
+    /* Empty fields keep the previous value, as when a sensor is not logged */
+    pSample = &Samples[SamplesNbr];
+    if(SamplesNbr > 0U)
+    {
+      *pSample = Samples[SamplesNbr - 1U];
+    }
+    else
+    {
+      memset(pSample, 0, sizeof(*pSample));
+    }
+    pSample->Time = ((Hours * 60U + Minutes) * 60U + Seconds) * 1000U + Ms;
+
+    for(Axes = 0; Axes < AXES_NBR; Axes++)
+    {
+      for(Axis = 0; Axis < 3U; Axis++)
+      {
+        if((Column[Axes] >= 0) && (((uint32_t)Column[Axes] + Axis) < FieldsNbr) &&
+           (*Field[Column[Axes] + Axis] != '\0'))
+        {
+          pSample->Axes[Axes][Axis] = (int32_t)strtol(Field[Column[Axes] + Axis], NULL, 10);
+        }
+      }
+    }
+    SamplesNbr++;
+  }
+
+  fclose(File);
+
+  if(SamplesNbr == 0U)
+  {
+    free(Samples);
+    Samples = NULL;
+    return BSP_ERROR_COMPONENT_FAILURE;
+  }
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Gets the sample due at the current tick
+  * @retval Pointer to the sample
+  */
+static const HOST_MOTION_SENSOR_Sample_t *CurrentSample(void)
+{
+  uint32_t Elapsed = (uint32_t)((xTaskGetTickCount() - StartTick) * portTICK_PERIOD_MS);
+
+  while(((SampleIndex + 1U) < SamplesNbr) &&
+        ((Samples[SampleIndex + 1U].Time - Samples[0].Time) <= Elapsed))
+  {
+    SampleIndex++;
+  }
+
+  if(((SampleIndex + 1U) == SamplesNbr) && ((Samples[SampleIndex].Time - Samples[0].Time) <= Elapsed))
+  {
+    SourceEnded = 1;
+  }
+
+  return &Samples[SampleIndex];
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup HOST_MOTION_SENSOR_Exported_Functions HOST_MOTION_SENSOR Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Selects the .csv file replayed by the sensors
+  * @param  Path  Path of the file, loaded by the first BSP_MOTION_SENSOR_Init()
+  * @retval None
+  */
+void BSP_MOTION_SENSOR_SetSource(const char *Path)
+{
+  MotionSensorPath = Path;
+}
+
+/**
+  * @brief  Tells if the last sample of the file has been reached
+  * @retval 1 once the last sample is the current one, 0 otherwise
+  */
+uint8_t BSP_MOTION_SENSOR_IsSourceEnded(void)
+{
+  if((Samples != NULL) && (Started != 0U))
+  {
+    (void)CurrentSample();
+  }
+
+  return SourceEnded;
+}
+
+/**
+  * @brief  Initializes the motion sensors
+  * @param  Instance  Motion sensor instance
+  * @param  Functions  Motion sensor functions. Could be :
+  *         - MOTION_GYRO and/or MOTION_ACCELERO for instance LSM6DSM_0
+  *         - MOTION_ACCELERO for instance LSM303AGR_ACC_0
+  *         - MOTION_MAGNETO for instance LSM303AGR_MAG_0
+  * @retval BSP status
+  */
+int32_t BSP_MOTION_SENSOR_Init(uint32_t Instance, uint32_t Functions)
+{
+  int32_t ret;
+  uint32_t Function;
+
+  if((Instance >= MOTION_INSTANCES_NBR) || (Functions == 0U) ||
+     ((Functions & ~InstanceFunctions[Instance]) != 0U))
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  if(Samples == NULL)
+  {
+    ret = CsvLoad();
+    if(ret != BSP_ERROR_NONE)
+    {
+      return ret;
+    }
+  }
+
+  InitFunctions[Instance] |= Functions;
+  for(Function = 0; Function < MOTION_FUNCTIONS_NBR; Function++)
+  {
+    SensorOdr[Instance][Function] = 50.0f;
+  }
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Deinitializes the motion sensors
+  * @param  Instance  Motion sensor instance
+  * @retval BSP status
+  */
+int32_t BSP_MOTION_SENSOR_DeInit(uint32_t Instance)
+{
+  if(Instance >= MOTION_INSTANCES_NBR)
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  InitFunctions[Instance] = 0;
+  EnabledFunctions[Instance] = 0;
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Enables the motion sensors
+  * @note   The first sensor enabled starts the replay of the file
+  * @param  Instance  Motion sensor instance
+  * @param  Function  Motion sensor function
+  * @retval BSP status
+  */
+int32_t BSP_MOTION_SENSOR_Enable(uint32_t Instance, uint32_t Function)
+{
+  if(CheckFunction(Instance, Function) != BSP_ERROR_NONE)
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  if((InitFunctions[Instance] & Function) == 0U)
+  {
+    return BSP_ERROR_NO_INIT;
+  }
+
+  if(Started == 0U)
+  {
+    StartTick = xTaskGetTickCount();
+    SampleIndex = 0;
+    Started = 1;
+  }
+  EnabledFunctions[Instance] |= Function;
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Disables the motion sensors
+  * @param  Instance  Motion sensor instance
+  * @param  Function  Motion sensor function
+  * @retval BSP status
+  */
+int32_t BSP_MOTION_SENSOR_Disable(uint32_t Instance, uint32_t Function)
+{
+  if(CheckFunction(Instance, Function) != BSP_ERROR_NONE)
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  EnabledFunctions[Instance] &= ~Function;
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Gets the axes of the sample due
+  * @param  Instance  Motion sensor instance
+  * @param  Function  Motion sensor function
+  * @param  Axes  Values in mg, mdps or mgauss
+  * @retval BSP status
+  */
+int32_t BSP_MOTION_SENSOR_GetAxes(uint32_t Instance, uint32_t Function, BSP_MOTION_SENSOR_Axes_t *Axes)
+{
+  const HOST_MOTION_SENSOR_Sample_t *pSample;
+  uint32_t Index;
+
+  if(CheckFunction(Instance, Function) != BSP_ERROR_NONE)
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  if((EnabledFunctions[Instance] & Function) == 0U)
+  {
+    return BSP_ERROR_NO_INIT;
+  }
+
+  pSample = CurrentSample();
+  Index = FunctionIndex(Function);
+  Axes->x = pSample->Axes[Index][0];
+  Axes->y = pSample->Axes[Index][1];
+  Axes->z = pSample->Axes[Index][2];
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Gets the raw axes of the sample due, with a sensitivity of 1
+  * @param  Instance  Motion sensor instance
+  * @param  Function  Motion sensor function
+  * @param  Axes  Raw values, saturated to 16 bits
+  * @retval BSP status
+  */
+int32_t BSP_MOTION_SENSOR_GetAxesRaw(uint32_t Instance, uint32_t Function, BSP_MOTION_SENSOR_AxesRaw_t *Axes)
+{
+  BSP_MOTION_SENSOR_Axes_t Value;
+  int32_t ret;
+
+  ret = BSP_MOTION_SENSOR_GetAxes(Instance, Function, &Value);
+  if(ret == BSP_ERROR_NONE)
+  {
+    Axes->x = (int16_t)((Value.x > INT16_MAX) ? INT16_MAX : ((Value.x < INT16_MIN) ? INT16_MIN : Value.x));
+    Axes->y = (int16_t)((Value.y > INT16_MAX) ? INT16_MAX : ((Value.y < INT16_MIN) ? INT16_MIN : Value.y));
+    Axes->z = (int16_t)((Value.z > INT16_MAX) ? INT16_MAX : ((Value.z < INT16_MIN) ? INT16_MIN : Value.z));
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Gets the sensitivity: the file holds the values in physical units
+  * @param  Instance  Motion sensor instance
+  * @param  Function  Motion sensor function
+  * @param  Sensitivity  Always 1.0
+  * @retval BSP status
+  */
+int32_t BSP_MOTION_SENSOR_GetSensitivity(uint32_t Instance, uint32_t Function, float *Sensitivity)
+{
+  if(CheckFunction(Instance, Function) != BSP_ERROR_NONE)
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  *Sensitivity = 1.0f;
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Gets the output data rate
+  * @param  Instance  Motion sensor instance
+  * @param  Function  Motion sensor function
+  * @param  Odr  Output data rate
+  * @retval BSP status
+  */
+int32_t BSP_MOTION_SENSOR_GetOutputDataRate(uint32_t Instance, uint32_t Function, float *Odr)
+{
+  if(CheckFunction(Instance, Function) != BSP_ERROR_NONE)
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  *Odr = SensorOdr[Instance][FunctionIndex(Function)];
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Sets the output data rate: recorded only, the file sets the rate
+  *         of the samples
+  * @param  Instance  Motion sensor instance
+  * @param  Function  Motion sensor function
+  * @param  Odr  Output data rate
+  * @retval BSP status
+  */
+int32_t BSP_MOTION_SENSOR_SetOutputDataRate(uint32_t Instance, uint32_t Function, float Odr)
+{
+  if(CheckFunction(Instance, Function) != BSP_ERROR_NONE)
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  SensorOdr[Instance][FunctionIndex(Function)] = Odr;
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Gets the full scale
+  * @param  Instance  Motion sensor instance
+  * @param  Function  Motion sensor function
+  * @param  Fullscale  Full scale
+  * @retval BSP status
+  */
+int32_t BSP_MOTION_SENSOR_GetFullScale(uint32_t Instance, uint32_t Function, int32_t *Fullscale)
+{
+  if(CheckFunction(Instance, Function) != BSP_ERROR_NONE)
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  *Fullscale = SensorFullScale[Instance][FunctionIndex(Function)];
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @brief  Sets the full scale: recorded only, the values are not clipped
+  * @param  Instance  Motion sensor instance
+  * @param  Function  Motion sensor function
+  * @param  Fullscale  Full scale
+  * @retval BSP status
+  */
+int32_t BSP_MOTION_SENSOR_SetFullScale(uint32_t Instance, uint32_t Function, int32_t Fullscale)
+{
+  if(CheckFunction(Instance, Function) != BSP_ERROR_NONE)
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  SensorFullScale[Instance][FunctionIndex(Function)] = Fullscale;
+
+  return BSP_ERROR_NONE;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
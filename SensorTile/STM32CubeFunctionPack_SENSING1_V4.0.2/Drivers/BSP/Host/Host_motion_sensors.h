@@ -0,0 +1,151 @@
+/**
+  ******************************************************************************
+  * @file    Host_motion_sensors.h
+  * @author  Central LAB
+  * @version V4.0.0
+  * @date    30-Oct-2019
+  * @brief   Header of the CSV-file motion sensors of the Linux host board
+  *
+  *          Same API as SensorTile_motion_sensors.h: the axes are replayed from
+  *          a .csv file in the format of the SD card data log of SENSING1.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2018 STMicroelectronics</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without modification,
+  * are permitted provided that the following conditions are met:
+  *   1. Redistributions of source code must retain the above copyright notice,
+  *      this list of conditions and the following disclaimer.
+  *   2. Redistributions in binary form must reproduce the above copyright notice,
+  *      this list of conditions and the following disclaimer in the documentation
+  *      and/or other materials provided with the distribution.
+  *   3. Neither the name of STMicroelectronics nor the names of its contributors
+  *      may be used to endorse or promote products derived from this software
+  *      without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HOST_MOTION_SENSORS_H
+#define __HOST_MOTION_SENSORS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "Host.h"
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/** @addtogroup HOST
+  * @{
+  */
+
+/** @addtogroup HOST_MOTION_SENSOR
+  * @{
+  */
+
+/** @defgroup HOST_MOTION_SENSOR_Exported_Types HOST_MOTION_SENSOR Exported Types
+  * @{
+  */
+
+typedef struct
+{
+  int32_t x;
+  int32_t y;
+  int32_t z;
+} BSP_MOTION_SENSOR_Axes_t;
+
+typedef struct
+{
+  int16_t x;
+  int16_t y;
+  int16_t z;
+} BSP_MOTION_SENSOR_AxesRaw_t;
+
+/**
+  * @}
+  */
+
+/** @defgroup HOST_MOTION_SENSOR_Exported_Constants HOST_MOTION_SENSOR Exported Constants
+  * @{
+  */
+
+/* Same instances as on the SensorTile, all fed by the same file */
+#define LSM6DSM_0               0U
+#define LSM303AGR_ACC_0         1U
+#define LSM303AGR_MAG_0         2U
+
+#define MOTION_GYRO             1U
+#define MOTION_ACCELERO         2U
+#define MOTION_MAGNETO          4U
+
+#define MOTION_FUNCTIONS_NBR    3U
+#define MOTION_INSTANCES_NBR    3U
+
+/* Maximum number of samples loaded from the file */
+#ifndef HOST_MOTION_SENSOR_MAX_SAMPLES
+#define HOST_MOTION_SENSOR_MAX_SAMPLES  65536U
+#endif
+
+/**
+  * @}
+  */
+
+/** @defgroup HOST_MOTION_SENSOR_Exported_Functions HOST_MOTION_SENSOR Exported Functions
+  * @{
+  */
+
+void    BSP_MOTION_SENSOR_SetSource(const char *Path);
+uint8_t BSP_MOTION_SENSOR_IsSourceEnded(void);
+int32_t BSP_MOTION_SENSOR_Init(uint32_t Instance, uint32_t Functions);
+int32_t BSP_MOTION_SENSOR_DeInit(uint32_t Instance);
+int32_t BSP_MOTION_SENSOR_Enable(uint32_t Instance, uint32_t Function);
+int32_t BSP_MOTION_SENSOR_Disable(uint32_t Instance, uint32_t Function);
+int32_t BSP_MOTION_SENSOR_GetAxes(uint32_t Instance, uint32_t Function, BSP_MOTION_SENSOR_Axes_t *Axes);
+int32_t BSP_MOTION_SENSOR_GetAxesRaw(uint32_t Instance, uint32_t Function, BSP_MOTION_SENSOR_AxesRaw_t *Axes);
+int32_t BSP_MOTION_SENSOR_GetSensitivity(uint32_t Instance, uint32_t Function, float *Sensitivity);
+int32_t BSP_MOTION_SENSOR_GetOutputDataRate(uint32_t Instance, uint32_t Function, float *Odr);
+int32_t BSP_MOTION_SENSOR_SetOutputDataRate(uint32_t Instance, uint32_t Function, float Odr);
+int32_t BSP_MOTION_SENSOR_GetFullScale(uint32_t Instance, uint32_t Function, int32_t *Fullscale);
+int32_t BSP_MOTION_SENSOR_SetFullScale(uint32_t Instance, uint32_t Function, int32_t Fullscale);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_MOTION_SENSORS_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,268 @@
+/**
+  ******************************************************************************
+  * @file    Host_sd.c
+  * @author  Central LAB
+  * @version V4.0.0
+  * @date    30-Oct-2019
+  * @brief   File-backed SD card of the Linux host board
+  *
+  *          The card is an image file of whole blocks: an existing file keeps
+  *          its size (rounded down to a block), a missing one is created with
+  *          HOST_SD_DEFAULT_BLOCK_NBR blocks of zeros, i.e. an unformatted card.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2018 STMicroelectronics</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without modification,
+  * are permitted provided that the following conditions are met:
+  *   1. Redistributions of source code must retain the above copyright notice,
+  *      this list of conditions and the following disclaimer.
+  *   2. Redistributions in binary form must reproduce the above copyright notice,
+  *      this list of conditions and the following disclaimer in the documentation
+  *      and/or other materials provided with the distribution.
+  *   3. Neither the name of STMicroelectronics nor the names of its contributors
+  *      may be used to endorse or promote products derived from this software
+  *      without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "Host_sd.h"
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/** @addtogroup HOST
+  * @{
+  */
+
+/** @defgroup HOST_SD HOST_SD
+  * @{
+  */
+
+/** @defgroup HOST_SD_Private_Variables HOST_SD Private Variables
+  * @{
+  */
+static const char *SdImagePath = "sd.img";
+static int SdImageFd = -1;
+static uint32_t SdBlockNbr = 0;
+/**
+  * @}
+  */
+
+/** @defgroup HOST_SD_Exported_Functions HOST_SD Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Selects the image file used as SD card
+  * @param  Path  Path of the image file, used by the next BSP_SD_Init()
+  * @retval None
+  */
+void BSP_SD_SetImage(const char *Path)
+{
+  SdImagePath = Path;
+}
+
+/**
+  * @brief  Opens the image file of the card, creating it if needed
+  * @retval SD status
+  */
+uint8_t BSP_SD_Init(void)
+{
+  struct stat st;
+
+  if(SdImageFd >= 0)
+  {
+    return MSD_OK;
+  }
+
+  SdImageFd = open(SdImagePath, O_RDWR | O_CREAT, 0644);
+  if((SdImageFd < 0) || (fstat(SdImageFd, &st) != 0))
+  {
+    BSP_SD_DeInit();
+    return MSD_ERROR;
+  }
+
+  if(st.st_size < BLOCK_SIZE)
+  {
+    if(ftruncate(SdImageFd, (off_t)HOST_SD_DEFAULT_BLOCK_NBR * BLOCK_SIZE) != 0)
+    {
+      BSP_SD_DeInit();
+      return MSD_ERROR;
+    }
+    SdBlockNbr = HOST_SD_DEFAULT_BLOCK_NBR;
+  }
+  else
+  {
+    SdBlockNbr = (uint32_t)(st.st_size / BLOCK_SIZE);
+  }
+
+  return MSD_OK;
+}
+
+/**
+  * @brief  Closes the image file of the card
+  * @retval SD status
+  */
+uint8_t BSP_SD_DeInit(void)
+{
+  if(SdImageFd >= 0)
+  {
+    close(SdImageFd);
+    SdImageFd = -1;
+  }
+  SdBlockNbr = 0;
+
+  return MSD_OK;
+}
+
+/**
+  * @brief  Detects if the card is present: always true on the host
+  * @retval Returns if SD is detected or not
+  */
+uint8_t BSP_SD_IsDetected(void)
+{
+  return 1;
+}
+
+/**
+  * @brief  Reads block(s) from a specified address in the card
+  * @param  p32Data  Pointer to the buffer that will contain the data
+  * @param  Sector  Index of the first block to read
+  * @param  NumberOfBlocks  Number of blocks to read
+  * @param  timeout  Not used: the file is read synchronously
+  * @retval SD status
+  */
+uint8_t BSP_SD_ReadBlocks(uint32_t* p32Data, uint64_t Sector, uint32_t NumberOfBlocks, uint32_t timeout)
+{
+  size_t Len = (size_t)NumberOfBlocks * BLOCK_SIZE;
+  (void)timeout;
+
+  if((SdImageFd < 0) || ((Sector + NumberOfBlocks) > SdBlockNbr))
+  {
+    return MSD_ERROR;
+  }
+
+  if(pread(SdImageFd, p32Data, Len, (off_t)(Sector * BLOCK_SIZE)) != (ssize_t)Len)
+  {
+    return MSD_ERROR;
+  }
+
+  return MSD_OK;
+}
+
+/**
+  * @brief  Writes block(s) to a specified address in the card
+  * @param  p32Data  Pointer to the buffer that contains the data to write
+  * @param  Sector  Index of the first block to write
+  * @param  NumberOfBlocks  Number of blocks to write
+  * @param  timeout  Not used: the file is written synchronously
+  * @retval SD status
+  */
+uint8_t BSP_SD_WriteBlocks(uint32_t* p32Data, uint64_t Sector, uint32_t NumberOfBlocks, uint32_t timeout)
+{
+  size_t Len = (size_t)NumberOfBlocks * BLOCK_SIZE;
+  (void)timeout;
+
+  if((SdImageFd < 0) || ((Sector + NumberOfBlocks) > SdBlockNbr))
+  {
+    return MSD_ERROR;
+  }
+
+  if(pwrite(SdImageFd, p32Data, Len, (off_t)(Sector * BLOCK_SIZE)) != (ssize_t)Len)
+  {
+    return MSD_ERROR;
+  }
+
+  return MSD_OK;
+}
+
+/**
+  * @brief  Erases the specified blocks of the card (filled with zeros)
+  * @param  StartAddr  Index of the first block to erase
+  * @param  EndAddr  Index of the last block to erase
+  * @retval SD status
+  */
+uint8_t BSP_SD_Erase(uint32_t StartAddr, uint32_t EndAddr)
+{
+  uint32_t Zero[BLOCK_SIZE / sizeof(uint32_t)];
+  uint32_t Block;
+
+  memset(Zero, 0, sizeof(Zero));
+
+  for(Block = StartAddr; Block <= EndAddr; Block++)
+  {
+    if(BSP_SD_WriteBlocks(Zero, Block, 1, SD_DATATIMEOUT) != MSD_OK)
+    {
+      return MSD_ERROR;
+    }
+  }
+
+  return MSD_OK;
+}
+
+/**
+  * @brief  Gets the current card state
+  * @retval MSD_OK when the card is ready, as every transfer is synchronous
+  */
+uint8_t BSP_SD_GetCardState(void)
+{
+  return (SdImageFd >= 0) ? MSD_OK : MSD_ERROR;
+}
+
+/**
+  * @brief  Gets the card information
+  * @param  pCardInfo  Pointer to the card information structure
+  * @retval SD status
+  */
+uint8_t BSP_SD_GetCardInfo(SD_CardInfo *pCardInfo)
+{
+  if(SdImageFd < 0)
+  {
+    return MSD_ERROR;
+  }
+
+  pCardInfo->CardBlockSize = BLOCK_SIZE;
+  pCardInfo->LogBlockSize = BLOCK_SIZE;
+  pCardInfo->LogBlockNbr = SdBlockNbr;
+  pCardInfo->CardCapacity = SdBlockNbr * BLOCK_SIZE;
+
+  return MSD_OK;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,136 @@
+/**
+  ******************************************************************************
+  * @file    Host_sd.h
+  * @author  Central LAB
+  * @version V4.0.0
+  * @date    30-Oct-2019
+  * @brief   Header of the file-backed SD card of the Linux host board
+  *
+  *          Same API as SensorTile_sd.h: the blocks of the card are the blocks
+  *          of an image file, which can be mounted on the host after the run
+  *          (e.g. with mtools or a loop device).
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2018 STMicroelectronics</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without modification,
+  * are permitted provided that the following conditions are met:
+  *   1. Redistributions of source code must retain the above copyright notice,
+  *      this list of conditions and the following disclaimer.
+  *   2. Redistributions in binary form must reproduce the above copyright notice,
+  *      this list of conditions and the following disclaimer in the documentation
+  *      and/or other materials provided with the distribution.
+  *   3. Neither the name of STMicroelectronics nor the names of its contributors
+  *      may be used to endorse or promote products derived from this software
+  *      without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HOST_SD_H
+#define __HOST_SD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "Host.h"
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/** @addtogroup HOST
+  * @{
+  */
+
+/** @addtogroup HOST_SD
+  * @{
+  */
+
+/** @defgroup HOST_SD_Exported_Types HOST_SD Exported Types
+  * @{
+  */
+
+/**
+  * @brief  SD status structure definition
+  */
+#define MSD_OK         0x00
+#define MSD_ERROR      0x01
+
+#define SD_DATATIMEOUT           ((uint32_t)100000000)
+
+/* Block Size in Bytes */
+#define BLOCK_SIZE                512
+
+/* Size of the image created when the file does not exist: 32 MB */
+#define HOST_SD_DEFAULT_BLOCK_NBR ((32U * 1024U * 1024U) / BLOCK_SIZE)
+
+#define BSP_SD_CardInfo SD_CardInfo
+
+/**
+  * @brief SD Card information
+  */
+typedef struct
+{
+  uint32_t CardCapacity;  /* Card Capacity */
+  uint32_t CardBlockSize; /* Card Block Size */
+  uint32_t LogBlockNbr;   /*!< Specifies the Card logical Capacity in blocks   */
+  uint32_t LogBlockSize;  /*!< Specifies logical block size in bytes           */
+} SD_CardInfo;
+
+/**
+  * @}
+  */
+
+/** @defgroup HOST_SD_Exported_Functions HOST_SD Exported Functions
+  * @{
+  */
+
+void    BSP_SD_SetImage(const char *Path);
+uint8_t BSP_SD_Init(void);
+uint8_t BSP_SD_DeInit(void);
+uint8_t BSP_SD_IsDetected(void);
+uint8_t BSP_SD_ReadBlocks(uint32_t* p32Data, uint64_t Sector, uint32_t NumberOfBlocks, uint32_t timeout);
+uint8_t BSP_SD_WriteBlocks(uint32_t* p32Data, uint64_t Sector, uint32_t NumberOfBlocks, uint32_t timeout);
+uint8_t BSP_SD_Erase(uint32_t StartAddr, uint32_t EndAddr);
+uint8_t BSP_SD_GetCardState(void);
+uint8_t BSP_SD_GetCardInfo(SD_CardInfo *pCardInfo);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_SD_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
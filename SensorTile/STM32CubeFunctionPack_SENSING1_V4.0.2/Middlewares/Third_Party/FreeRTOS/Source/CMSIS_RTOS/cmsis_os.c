@@ -56,10 +56,18 @@
 #include <string.h>
 #include "cmsis_os.h"
 
+/*
+ * POSIX host port: no Cortex-M core registers
+ */
+#if   defined ( portHOST_POSIX )
+
+  #define __INLINE         inline
+  #define __STATIC_INLINE  static inline
+
 /*
  * ARM Compiler 4/5
  */
-#if   defined ( __CC_ARM )
+#elif defined ( __CC_ARM )
 
   #define __ASM            __asm                                      
   #define __INLINE         __inline                                     
@@ -129,7 +137,11 @@ static osPriority makeCmsisPriority (unsigned portBASE_TYPE fpriority)
 /* Determine whether we are in thread mode or handler mode. */
 static int inHandlerMode (void)
 {
+#if defined ( portHOST_POSIX )
+  return xPortIsInsideInterrupt() != pdFALSE;
+#else
   return __get_IPSR() != 0;
+#endif
 }
 
 /*********************** Kernel Control Functions *****************************/
@@ -952,7 +964,7 @@ void *osPoolAlloc (osPoolId pool_id)
     
     if (pool_id->markers[index] == 0) {
       pool_id->markers[index] = 1;
-      p = (void *)((uint32_t)(pool_id->pool) + (index * pool_id->item_sz));
+      p = (void *)((uintptr_t)(pool_id->pool) + (index * pool_id->item_sz));
       pool_id->currentIndex = index;
       break;
     }
@@ -1009,7 +1021,7 @@ osStatus osPoolFree (osPoolId pool_id, void *block)
     return osErrorParameter;
   }
   
-  index = (uint32_t)block - (uint32_t)(pool_id->pool);
+  index = (uintptr_t)block - (uintptr_t)(pool_id->pool);
   if (index % pool_id->item_sz) {
     return osErrorParameter;
   }
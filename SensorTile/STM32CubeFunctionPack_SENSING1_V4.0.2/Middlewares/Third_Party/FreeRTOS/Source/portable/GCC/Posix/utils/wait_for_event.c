@@ -0,0 +1,86 @@
+/*
+ * FreeRTOS Kernel V10.0.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "wait_for_event.h"
+
+struct event
+{
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	int event_triggered;
+};
+/*-----------------------------------------------------------*/
+
+struct event * event_create( void )
+{
+struct event * ev = malloc( sizeof( struct event ) );
+
+	if( ev != NULL )
+	{
+		ev->event_triggered = 0;
+		pthread_mutex_init( &ev->mutex, NULL );
+		pthread_cond_init( &ev->cond, NULL );
+	}
+
+	return ev;
+}
+/*-----------------------------------------------------------*/
+
+void event_delete( struct event * ev )
+{
+	pthread_mutex_destroy( &ev->mutex );
+	pthread_cond_destroy( &ev->cond );
+	free( ev );
+}
+/*-----------------------------------------------------------*/
+
+void event_wait( struct event * ev )
+{
+	pthread_mutex_lock( &ev->mutex );
+
+	while( ev->event_triggered == 0 )
+	{
+		pthread_cond_wait( &ev->cond, &ev->mutex );
+	}
+
+	ev->event_triggered = 0;
+	pthread_mutex_unlock( &ev->mutex );
+}
+/*-----------------------------------------------------------*/
+
+void event_signal( struct event * ev )
+{
+	pthread_mutex_lock( &ev->mutex );
+	ev->event_triggered = 1;
+	pthread_cond_signal( &ev->cond );
+	pthread_mutex_unlock( &ev->mutex );
+}
+
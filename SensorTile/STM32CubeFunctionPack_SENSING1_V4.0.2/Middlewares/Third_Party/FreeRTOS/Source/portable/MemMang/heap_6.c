@@ -0,0 +1,702 @@
+/*
+ * FreeRTOS Kernel V10.0.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A sample implementation of pvPortMalloc() and vPortFree() based on the
+ * Two-Level Segregated Fit (TLSF) algorithm.  Free blocks are kept in an array
+ * of size class lists indexed by two levels of bitmap - the first level splits
+ * sizes by power of two, the second level splits each power of two into
+ * heapSL_INDEX_COUNT linear sub-ranges.  Finding a block large enough for a
+ * request and returning a block to the heap (including coalescing with both
+ * physical neighbours) are therefore bounded, constant time operations,
+ * whereas the time taken by heap_4.c grows with the number of free blocks.
+ *
+ * Like heap_4.c the heap is a single statically allocated array of
+ * configTOTAL_HEAP_SIZE bytes, and the per allocation overhead is the same.
+ *
+ * See heap_1.c, heap_2.c, heap_3.c, heap_4.c and heap_5.c for alternative
+ * implementations, and the memory management pages of http://www.FreeRTOS.org
+ * for more information.
+ */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+/* The largest block that can be managed is ( 1 << configHEAP_FL_INDEX_MAX )
+bytes.  Each first level index costs heapSL_INDEX_COUNT list heads of RAM, so
+the default only covers heaps up to 64K.  Set configHEAP_FL_INDEX_MAX in
+FreeRTOSConfig.h if configTOTAL_HEAP_SIZE is larger. */
+#ifndef configHEAP_FL_INDEX_MAX
+	#define configHEAP_FL_INDEX_MAX		16
+#endif
+
+#if( configHEAP_FL_INDEX_MAX > 31 )
+	#error configHEAP_FL_INDEX_MAX must not be greater than 31
+#endif
+
+#if( portBYTE_ALIGNMENT == 32 )
+	#define heapALIGNMENT_LOG2		5
+#elif( portBYTE_ALIGNMENT == 16 )
+	#define heapALIGNMENT_LOG2		4
+#elif( portBYTE_ALIGNMENT == 8 )
+	#define heapALIGNMENT_LOG2		3
+#elif( portBYTE_ALIGNMENT == 4 )
+	#define heapALIGNMENT_LOG2		2
+#else
+	#error Unsupported portBYTE_ALIGNMENT
+#endif
+
+/* Number of second level size classes per power of two, as a power of two. */
+#define heapSL_INDEX_COUNT_LOG2		3
+#define heapSL_INDEX_COUNT			( 1 << heapSL_INDEX_COUNT_LOG2 )
+
+/* Blocks smaller than heapSMALL_BLOCK_SIZE all map onto first level index 0,
+which is split linearly in steps of portBYTE_ALIGNMENT. */
+#define heapFL_INDEX_SHIFT			( heapSL_INDEX_COUNT_LOG2 + heapALIGNMENT_LOG2 )
+#define heapFL_INDEX_COUNT			( configHEAP_FL_INDEX_MAX - heapFL_INDEX_SHIFT + 1 )
+#define heapSMALL_BLOCK_SIZE		( ( size_t ) 1 << heapFL_INDEX_SHIFT )
+
+#if( heapFL_INDEX_COUNT < 2 )
+	#error configHEAP_FL_INDEX_MAX is too small for the configured portBYTE_ALIGNMENT
+#endif
+
+/* The two low bits of xBlockSize are always zero as block sizes are a multiple
+of portBYTE_ALIGNMENT, so they are used to hold the state of the block and of
+the block physically in front of it. */
+#define heapBLOCK_FREE_BIT			( ( size_t ) 0x01 )
+#define heapPREV_BLOCK_FREE_BIT		( ( size_t ) 0x02 )
+#define heapBLOCK_FLAGS_MASK		( heapBLOCK_FREE_BIT | heapPREV_BLOCK_FREE_BIT )
+
+/* Find the index of the most significant / least significant set bit of a
+non zero 32-bit value. */
+#if defined( __GNUC__ )
+	#define heapFLS( x )			( 31 - __builtin_clz( ( uint32_t ) ( x ) ) )
+#elif defined( __ICCARM__ )
+	#include <intrinsics.h>
+	#define heapFLS( x )			( 31 - __CLZ( ( uint32_t ) ( x ) ) )
+#elif defined( __CC_ARM )
+	#define heapFLS( x )			( 31 - __clz( ( uint32_t ) ( x ) ) )
+#else
+	#define heapFLS( x )			prvGenericFLS( ( uint32_t ) ( x ) )
+	#define heapUSE_GENERIC_FLS		1
+#endif
+#ifndef heapUSE_GENERIC_FLS
+	#define heapUSE_GENERIC_FLS		0
+#endif
+#define heapFFS( x )				heapFLS( ( uint32_t ) ( x ) & ( 0U - ( uint32_t ) ( x ) ) )
+
+/* Allocate the memory for the heap. */
+#if( configAPPLICATION_ALLOCATED_HEAP == 1 )
+	/* The application writer has already defined the array used for the RTOS
+	heap - probably so it can be placed in a special segment or address. */
+	extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#else
+	static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#endif /* configAPPLICATION_ALLOCATED_HEAP */
+
+/* Header placed in front of every block, free or allocated.  pxPrevPhysBlock
+is only valid when heapPREV_BLOCK_FREE_BIT is set.  The two free list links are
+only used while the block is free, so they overlay the first bytes of the
+memory handed to the application. */
+typedef struct A_BLOCK_HEADER
+{
+	struct A_BLOCK_HEADER *pxPrevPhysBlock;	/*<< The block physically in front of this one. */
+	size_t xBlockSize;						/*<< Usable size of the block, plus the state flags. */
+	struct A_BLOCK_HEADER *pxNextFree;		/*<< The next block in the same size class. */
+	struct A_BLOCK_HEADER *pxPrevFree;		/*<< The previous block in the same size class. */
+} BlockHeader_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called automatically to setup the required heap structures the first time
+ * pvPortMalloc() is called.
+ */
+static void prvHeapInit( void );
+
+/*
+ * Map a block size onto the first and second level index of the size class
+ * that holds it.  prvMappingSearch() rounds the size up first so every block in
+ * the returned class is guaranteed to be large enough.
+ */
+static void prvMappingInsert( size_t xSize, BaseType_t *pxFl, BaseType_t *pxSl );
+static void prvMappingSearch( size_t xSize, BaseType_t *pxFl, BaseType_t *pxSl );
+
+/*
+ * Add a block to, or remove a block from, the free list of its size class,
+ * keeping the bitmaps in step.
+ */
+static void prvInsertFreeBlock( BlockHeader_t *pxBlock );
+static void prvRemoveFreeBlock( BlockHeader_t *pxBlock );
+
+#if( heapUSE_GENERIC_FLS == 1 )
+	static BaseType_t prvGenericFLS( uint32_t ulValue );
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* The size of the part of BlockHeader_t that stays in front of an allocated
+block, rounded up so the memory returned is correctly byte aligned. */
+static const size_t xHeapStructSize = ( ( sizeof( BlockHeader_t * ) + sizeof( size_t ) ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* A free block must be able to hold the two free list links. */
+static const size_t xMinimumBlockSize = ( ( sizeof( BlockHeader_t * ) * 2 ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* One bit per first level index that has at least one non empty second level
+list, and one bit per non empty second level list. */
+static uint32_t ulFlBitmap = 0U;
+static uint32_t ulSlBitmap[ heapFL_INDEX_COUNT ];
+
+/* Heads of the free lists. */
+static BlockHeader_t *pxFreeLists[ heapFL_INDEX_COUNT ][ heapSL_INDEX_COUNT ];
+
+/* Zero sized, permanently allocated block at the end of the heap so the last
+real block always has a physical successor. */
+static BlockHeader_t *pxEnd = NULL;
+
+/* Keeps track of the number of free bytes remaining, but says nothing about
+fragmentation - see vPortGetHeapStats() for that. */
+static size_t xFreeBytesRemaining = 0U;
+static size_t xMinimumEverFreeBytesRemaining = 0U;
+static size_t xNumberOfSuccessfulAllocations = 0U;
+static size_t xNumberOfSuccessfulFrees = 0U;
+
+/*-----------------------------------------------------------*/
+
+#define heapBLOCK_SIZE( pxBlock )		( ( pxBlock )->xBlockSize & ~heapBLOCK_FLAGS_MASK )
+#define heapBLOCK_TO_PTR( pxBlock )		( ( void * ) ( ( ( uint8_t * ) ( pxBlock ) ) + xHeapStructSize ) )
+#define heapPTR_TO_BLOCK( pv )			( ( BlockHeader_t * ) ( void * ) ( ( ( uint8_t * ) ( pv ) ) - xHeapStructSize ) )
+#define heapNEXT_PHYS_BLOCK( pxBlock )	( ( BlockHeader_t * ) ( void * ) ( ( ( uint8_t * ) ( pxBlock ) ) + xHeapStructSize + heapBLOCK_SIZE( pxBlock ) ) )
+
+/*-----------------------------------------------------------*/
+
+void *pvPortMalloc( size_t xWantedSize )
+{
+BlockHeader_t *pxBlock, *pxNewBlock, *pxNextBlock;
+BaseType_t xFl, xSl;
+uint32_t ulMap;
+void *pvReturn = NULL;
+
+	vTaskSuspendAll();
+	{
+		/* If this is the first call to malloc then the heap will require
+		initialisation to setup the free lists. */
+		if( pxEnd == NULL )
+		{
+			prvHeapInit();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( ( xWantedSize > 0 ) && ( xWantedSize < ( ( size_t ) 1 << configHEAP_FL_INDEX_MAX ) ) )
+		{
+			/* Ensure that blocks are always aligned to the required number
+			of bytes and can hold the free list links once freed. */
+			if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+			{
+				xWantedSize += ( portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK ) );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( xWantedSize < xMinimumBlockSize )
+			{
+				xWantedSize = xMinimumBlockSize;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			pxBlock = NULL;
+			prvMappingSearch( xWantedSize, &xFl, &xSl );
+
+			if( xFl < heapFL_INDEX_COUNT )
+			{
+				/* Look for a non empty list in the wanted class or a larger
+				class with the same first level index, then fall back to the
+				smallest non empty larger first level index. */
+				ulMap = ulSlBitmap[ xFl ] & ( ~0UL << xSl );
+				if( ulMap == 0U )
+				{
+					ulMap = ulFlBitmap & ( ~0UL << ( xFl + 1 ) );
+					if( ulMap != 0U )
+					{
+						xFl = heapFFS( ulMap );
+						ulMap = ulSlBitmap[ xFl ];
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				if( ulMap != 0U )
+				{
+					xSl = heapFFS( ulMap );
+					pxBlock = pxFreeLists[ xFl ][ xSl ];
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( pxBlock != NULL )
+			{
+				configASSERT( heapBLOCK_SIZE( pxBlock ) >= xWantedSize );
+				prvRemoveFreeBlock( pxBlock );
+
+				if( heapBLOCK_SIZE( pxBlock ) >= ( xWantedSize + xHeapStructSize + xMinimumBlockSize ) )
+				{
+					/* The block is larger than required so split off the
+					remainder and give it back to the free lists.  The void
+					cast is used to prevent byte alignment warnings from the
+					compiler. */
+					pxNewBlock = ( void * ) ( ( ( uint8_t * ) heapBLOCK_TO_PTR( pxBlock ) ) + xWantedSize );
+					configASSERT( ( ( ( size_t ) pxNewBlock ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+
+					pxNewBlock->xBlockSize = ( heapBLOCK_SIZE( pxBlock ) - xWantedSize - xHeapStructSize ) | heapBLOCK_FREE_BIT;
+					pxNewBlock->pxPrevPhysBlock = pxBlock;
+					pxBlock->xBlockSize = xWantedSize | ( pxBlock->xBlockSize & heapPREV_BLOCK_FREE_BIT );
+
+					/* The block after the remainder still follows a free
+					block, but a different one. */
+					pxNextBlock = heapNEXT_PHYS_BLOCK( pxNewBlock );
+					pxNextBlock->pxPrevPhysBlock = pxNewBlock;
+
+					prvInsertFreeBlock( pxNewBlock );
+				}
+				else
+				{
+					/* The whole block is used, so the block after it no
+					longer follows a free block. */
+					pxNextBlock = heapNEXT_PHYS_BLOCK( pxBlock );
+					pxNextBlock->xBlockSize &= ~heapPREV_BLOCK_FREE_BIT;
+				}
+
+				pxBlock->xBlockSize &= ~heapBLOCK_FREE_BIT;
+
+				xFreeBytesRemaining -= heapBLOCK_SIZE( pxBlock ) + xHeapStructSize;
+
+				if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+				{
+					xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				xNumberOfSuccessfulAllocations++;
+				pvReturn = heapBLOCK_TO_PTR( pxBlock );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		traceMALLOC( pvReturn, xWantedSize );
+	}
+	( void ) xTaskResumeAll();
+
+	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+	{
+		if( pvReturn == NULL )
+		{
+			extern void vApplicationMallocFailedHook( void );
+			vApplicationMallocFailedHook();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
+	configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+BlockHeader_t *pxBlock, *pxNextBlock, *pxPrevBlock;
+
+	if( pv != NULL )
+	{
+		/* The memory being freed will have a block header immediately before
+		it. */
+		pxBlock = heapPTR_TO_BLOCK( pv );
+
+		/* Check the block is actually allocated. */
+		configASSERT( ( pxBlock->xBlockSize & heapBLOCK_FREE_BIT ) == 0 );
+
+		if( ( pxBlock->xBlockSize & heapBLOCK_FREE_BIT ) == 0 )
+		{
+			vTaskSuspendAll();
+			{
+				xFreeBytesRemaining += heapBLOCK_SIZE( pxBlock ) + xHeapStructSize;
+				xNumberOfSuccessfulFrees++;
+				traceFREE( pv, heapBLOCK_SIZE( pxBlock ) );
+
+				pxBlock->xBlockSize |= heapBLOCK_FREE_BIT;
+
+				/* Merge with the block in front of it if that one is free.
+				The header of the block being freed becomes free space. */
+				if( ( pxBlock->xBlockSize & heapPREV_BLOCK_FREE_BIT ) != 0 )
+				{
+					pxPrevBlock = pxBlock->pxPrevPhysBlock;
+					prvRemoveFreeBlock( pxPrevBlock );
+					pxPrevBlock->xBlockSize += heapBLOCK_SIZE( pxBlock ) + xHeapStructSize;
+					pxBlock = pxPrevBlock;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* Merge with the block behind it if that one is free.  pxEnd
+				is never free so this cannot run off the end of the heap. */
+				pxNextBlock = heapNEXT_PHYS_BLOCK( pxBlock );
+				if( ( pxNextBlock->xBlockSize & heapBLOCK_FREE_BIT ) != 0 )
+				{
+					prvRemoveFreeBlock( pxNextBlock );
+					pxBlock->xBlockSize += heapBLOCK_SIZE( pxNextBlock ) + xHeapStructSize;
+					pxNextBlock = heapNEXT_PHYS_BLOCK( pxBlock );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				pxNextBlock->pxPrevPhysBlock = pxBlock;
+				pxNextBlock->xBlockSize |= heapPREV_BLOCK_FREE_BIT;
+
+				prvInsertFreeBlock( pxBlock );
+			}
+			( void ) xTaskResumeAll();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+	return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+	return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+	/* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t *pxHeapStats )
+{
+BlockHeader_t *pxBlock;
+size_t xBlocks = 0, xMaxSize = 0, xMinSize = 0, xSize;
+BaseType_t xFl, xSl;
+
+	vTaskSuspendAll();
+	{
+		/* pxEnd will be NULL if the heap has not been initialised. */
+		if( pxEnd != NULL )
+		{
+			/* Walking the size classes in order visits the free blocks from
+			the smallest to the largest. */
+			for( xFl = 0; xFl < heapFL_INDEX_COUNT; xFl++ )
+			{
+				for( xSl = 0; xSl < heapSL_INDEX_COUNT; xSl++ )
+				{
+					for( pxBlock = pxFreeLists[ xFl ][ xSl ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFree )
+					{
+						/* Sizes include the header, to match the free byte
+						count and the figures reported by heap_4.c. */
+						xSize = heapBLOCK_SIZE( pxBlock ) + xHeapStructSize;
+
+						if( ( xBlocks == 0 ) || ( xSize < xMinSize ) )
+						{
+							xMinSize = xSize;
+						}
+
+						if( xSize > xMaxSize )
+						{
+							xMaxSize = xSize;
+						}
+
+						xBlocks++;
+					}
+				}
+			}
+		}
+
+		pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+		pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+		pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+		pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+		pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+		pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+		pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+	}
+	( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void )
+{
+BlockHeader_t *pxFirstFreeBlock;
+uint8_t *pucAlignedHeap;
+size_t uxAddress;
+size_t xTotalHeapSize = configTOTAL_HEAP_SIZE;
+BaseType_t xFl, xSl;
+
+	/* Ensure the heap starts on a correctly aligned boundary. */
+	uxAddress = ( size_t ) ucHeap;
+
+	if( ( uxAddress & portBYTE_ALIGNMENT_MASK ) != 0 )
+	{
+		uxAddress += ( portBYTE_ALIGNMENT - 1 );
+		uxAddress &= ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+		xTotalHeapSize -= uxAddress - ( size_t ) ucHeap;
+	}
+
+	pucAlignedHeap = ( uint8_t * ) uxAddress;
+
+	for( xFl = 0; xFl < heapFL_INDEX_COUNT; xFl++ )
+	{
+		ulSlBitmap[ xFl ] = 0U;
+
+		for( xSl = 0; xSl < heapSL_INDEX_COUNT; xSl++ )
+		{
+			pxFreeLists[ xFl ][ xSl ] = NULL;
+		}
+	}
+	ulFlBitmap = 0U;
+
+	/* pxEnd is used to mark the end of the heap space.  It is a zero sized
+	block that is never free, so no block will ever try to merge past it. */
+	uxAddress = ( ( size_t ) pucAlignedHeap ) + xTotalHeapSize;
+	uxAddress -= xHeapStructSize;
+	uxAddress &= ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+	pxEnd = ( void * ) uxAddress;
+
+	/* To start with there is a single free block that is sized to take up the
+	entire heap space, minus the space taken by its header and by pxEnd. */
+	pxFirstFreeBlock = ( void * ) pucAlignedHeap;
+	pxFirstFreeBlock->pxPrevPhysBlock = NULL;
+	pxFirstFreeBlock->xBlockSize = ( uxAddress - ( size_t ) pxFirstFreeBlock - xHeapStructSize );
+
+	/* Blocks larger than the top size class cannot be indexed, so the unused
+	tail of an oversized heap is simply never handed out. */
+	if( pxFirstFreeBlock->xBlockSize >= ( ( size_t ) 1 << configHEAP_FL_INDEX_MAX ) )
+	{
+		pxFirstFreeBlock->xBlockSize = ( ( ( size_t ) 1 << configHEAP_FL_INDEX_MAX ) - portBYTE_ALIGNMENT );
+		pxEnd = heapNEXT_PHYS_BLOCK( pxFirstFreeBlock );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	pxFirstFreeBlock->xBlockSize |= heapBLOCK_FREE_BIT;
+
+	pxEnd->pxPrevPhysBlock = pxFirstFreeBlock;
+	pxEnd->xBlockSize = heapPREV_BLOCK_FREE_BIT;
+
+	prvInsertFreeBlock( pxFirstFreeBlock );
+
+	/* As in heap_4.c the free byte count includes the headers of the free
+	blocks, so it does not change when blocks are merged or split. */
+	xMinimumEverFreeBytesRemaining = heapBLOCK_SIZE( pxFirstFreeBlock ) + xHeapStructSize;
+	xFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMappingInsert( size_t xSize, BaseType_t *pxFl, BaseType_t *pxSl )
+{
+BaseType_t xFl;
+
+	if( xSize < heapSMALL_BLOCK_SIZE )
+	{
+		/* Small blocks are split linearly in portBYTE_ALIGNMENT steps. */
+		*pxFl = 0;
+		*pxSl = ( BaseType_t ) ( xSize / ( heapSMALL_BLOCK_SIZE / heapSL_INDEX_COUNT ) );
+	}
+	else
+	{
+		xFl = heapFLS( xSize );
+		*pxSl = ( BaseType_t ) ( ( xSize >> ( xFl - heapSL_INDEX_COUNT_LOG2 ) ) ^ ( ( size_t ) 1 << heapSL_INDEX_COUNT_LOG2 ) );
+		*pxFl = xFl - ( heapFL_INDEX_SHIFT - 1 );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvMappingSearch( size_t xSize, BaseType_t *pxFl, BaseType_t *pxSl )
+{
+	if( xSize >= heapSMALL_BLOCK_SIZE )
+	{
+		/* Round up to the start of the next size class so that any block
+		found in the resulting class is large enough. */
+		xSize += ( ( size_t ) 1 << ( heapFLS( xSize ) - heapSL_INDEX_COUNT_LOG2 ) ) - 1;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	prvMappingInsert( xSize, pxFl, pxSl );
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertFreeBlock( BlockHeader_t *pxBlock )
+{
+BaseType_t xFl, xSl;
+
+	prvMappingInsert( heapBLOCK_SIZE( pxBlock ), &xFl, &xSl );
+	configASSERT( xFl < heapFL_INDEX_COUNT );
+
+	/* Push onto the front of the size class list. */
+	pxBlock->pxPrevFree = NULL;
+	pxBlock->pxNextFree = pxFreeLists[ xFl ][ xSl ];
+
+	if( pxBlock->pxNextFree != NULL )
+	{
+		pxBlock->pxNextFree->pxPrevFree = pxBlock;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	pxFreeLists[ xFl ][ xSl ] = pxBlock;
+	ulFlBitmap |= ( 1UL << xFl );
+	ulSlBitmap[ xFl ] |= ( 1UL << xSl );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveFreeBlock( BlockHeader_t *pxBlock )
+{
+BaseType_t xFl, xSl;
+
+	prvMappingInsert( heapBLOCK_SIZE( pxBlock ), &xFl, &xSl );
+
+	if( pxBlock->pxNextFree != NULL )
+	{
+		pxBlock->pxNextFree->pxPrevFree = pxBlock->pxPrevFree;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( pxBlock->pxPrevFree != NULL )
+	{
+		pxBlock->pxPrevFree->pxNextFree = pxBlock->pxNextFree;
+	}
+	else
+	{
+		/* The block was the head of its list. */
+		pxFreeLists[ xFl ][ xSl ] = pxBlock->pxNextFree;
+
+		if( pxFreeLists[ xFl ][ xSl ] == NULL )
+		{
+			ulSlBitmap[ xFl ] &= ~( 1UL << xSl );
+
+			if( ulSlBitmap[ xFl ] == 0U )
+			{
+				ulFlBitmap &= ~( 1UL << xFl );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( heapUSE_GENERIC_FLS == 1 )
+
+	static BaseType_t prvGenericFLS( uint32_t ulValue )
+	{
+	BaseType_t xBit = 31;
+
+		while( ( ulValue & 0x80000000UL ) == 0U )
+		{
+			ulValue <<= 1;
+			xBit--;
+		}
+
+		return xBit;
+	}
+
+#endif /* heapUSE_GENERIC_FLS */
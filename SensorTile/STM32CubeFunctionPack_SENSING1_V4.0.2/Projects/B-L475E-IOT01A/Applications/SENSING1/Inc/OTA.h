@@ -63,6 +63,16 @@ extern void StartUpdateFWBlueMS(uint32_t SizeOfUpdate,uint32_t uwCRCValue);
  * it writes the Magic Number in Flash for BootLoader */
 extern int8_t UpdateFWBlueMS(uint32_t *SizeOfUpdateBlueFW,uint8_t * att_data, int32_t data_length,uint8_t WriteMagicNum);
 
+/* API for resuming one update interrupted by a disconnection.
+ * If the progress saved in Flash matches the Size of the Update and the CRC value,
+ * it returns the offset from which the image must be resent,
+ * otherwise it behaves like StartUpdateFWBlueMS and returns 0 */
+extern uint32_t ResumeUpdateFWBlueMS(uint32_t SizeOfUpdate,uint32_t uwCRCValue);
+
+/* API for reading the image offset from which one interrupted update continues.
+ * It returns the number of bytes to resend from there (0 if there is nothing to resume) */
+extern uint32_t GetResumePointFWBlueMS(uint32_t *Offset);
+
 /* API for checking the BootLoader compliance */
 extern int8_t CheckBootLoaderCompliance(void);
 
@@ -167,6 +167,7 @@ typedef enum
   BATTERY_PLUG        = 0x10,
   SD_CARD_LOGGING     = 0x11,
   SET_HOST_LINK_TYPE  = 0x12,
+  FOTA_PREPARE        = 0x13,
   NUMBER_OF_MSG_TYPE
 }msgType_t;
 
@@ -208,6 +209,13 @@ typedef struct
   uint8_t  data[W2ST_MAX_CHAR_LEN];
 } term_data_t;
 
+typedef struct
+{
+  uint32_t SizeOfUpdate;
+  uint32_t uwCRCValue;
+  uint8_t  Resume;
+} fota_t;
+
 typedef struct
 {
   uint32_t soc_status;
@@ -245,6 +253,7 @@ typedef struct
     MultiNN_Output_t multiNN;
     term_data_t    term;
     battery_data_t batteryInfo;
+    fota_t         fota;
   };
 }msgData_t;
 
@@ -289,6 +298,7 @@ extern int stopProc(msgType_t Type);
 extern void startBlinkLed(void);
 extern void stopBlinkLed(void);
 extern tBleStatus Config_NotifyBLE(uint32_t Feature,uint8_t Command,uint8_t data);
+extern void FOTA_Prepare(uint32_t SizeOfUpdate, uint32_t uwCRCValue, uint8_t Resume);
 
 #ifdef __cplusplus
 }
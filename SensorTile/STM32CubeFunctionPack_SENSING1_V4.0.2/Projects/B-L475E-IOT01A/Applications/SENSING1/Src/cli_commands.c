@@ -20,6 +20,32 @@ extern uint8_t set_connectable;
 
 extern char DefaultDataFileName[12];
 
+#if (configUSE_TRACE_RECORDER == 1)
+#if SENSING1_USE_USB_CDC
+/* Time given to the user for starting the capture on the host */
+#define TRACE_START_DELAY_MS 5000
+#elif (defined(STM32_SENSORTILEBOX) && SENSING1_USE_DATALOG)
+/* The trace is written to the SD card (see DataLog_Manager.c) */
+#define TRACE_START_DELAY_MS 0
+#else
+#error "configUSE_TRACE_RECORDER needs the USB CDC console or the SensorTile.box SD card data log"
+#endif /* SENSING1_USE_USB_CDC */
+
+static void TraceStartCallback(void const *argument);
+static void TraceStopCallback(void const *argument);
+osTimerDef(TimerTraceStartHandle, TraceStartCallback);
+osTimerDef(TimerTraceHandle, TraceStopCallback);
+
+static osTimerId TimerTraceStartId = NULL;
+static osTimerId TimerTraceId = NULL;
+static uint32_t TraceDurationMs = 0;
+#endif /* (configUSE_TRACE_RECORDER == 1) */
+
+#if (configGENERATE_RUN_TIME_STATS == 1)
+/* Max number of tasks reported by the cpu command */
+#define CPU_STATS_MAX_TASKS 16
+#endif /* (configGENERATE_RUN_TIME_STATS == 1) */
+
 static BaseType_t prvInfoCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
 static BaseType_t prvUidCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
 static BaseType_t prvNameCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
@@ -46,6 +72,14 @@ static BaseType_t prvFORMATCommand(char *pcWriteBuffer, size_t xWriteBufferLen,
 static BaseType_t prvUsbCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
 #endif /* SENSING1_USE_USB_MSC */
 
+#if (configGENERATE_RUN_TIME_STATS == 1)
+static BaseType_t prvCpuCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+#endif /* (configGENERATE_RUN_TIME_STATS == 1) */
+
+#if (configUSE_TRACE_RECORDER == 1)
+static BaseType_t prvTraceCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+#endif /* (configUSE_TRACE_RECORDER == 1) */
+
 static BaseType_t prvResetCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
 
 #ifdef STM32_SENSORTILEBOX
@@ -64,7 +98,7 @@ static const CLI_Command_Definition_t xNameCommand =
 static const CLI_Command_Definition_t xInfoCommand =
 {
     "info", /* The command string to type */
-    "\r\ninfo:\r\n Show firmware details and version.\r\n",
+    "\r\ninfo:\r\n Show firmware details, version and heap usage.\r\n",
     prvInfoCommand, /* The function to run */
     0 /* No parameters are expected. */
 };
@@ -211,6 +245,34 @@ static const CLI_Command_Definition_t xUsbCommand =
 };
 #endif /* SENSING1_USE_USB_MSC */
 
+#if (configGENERATE_RUN_TIME_STATS == 1)
+static const CLI_Command_Definition_t xCpuCommand =
+{
+    "cpu", /* The command string to type */
+    "\r\ncpu:\r\n Show the CPU time used by each task since boot.\r\n",
+    prvCpuCommand, /* The function to run */
+    0 /* No parameters are expected. */
+};
+#endif /* (configGENERATE_RUN_TIME_STATS == 1) */
+
+#if (configUSE_TRACE_RECORDER == 1)
+static const CLI_Command_Definition_t xTraceCommand =
+{
+    "trace", /* The command string to type */
+#if SENSING1_USE_USB_CDC
+    "\r\ntrace [start [seconds] | stop]:\r\n Stream the kernel trace on USB CDC.\r\n"\
+                                "  Capture it on the host (cat /dev/ttyACM0 > trace.psf) for Tracealyzer.\r\n"\
+                                "  No arguments: display the trace status.\r\n",
+#else
+    "\r\ntrace [start [seconds] | stop]:\r\n Record the kernel trace to a .psf file on the SD card.\r\n"\
+                                "  Open the file with Tracealyzer.\r\n"\
+                                "  When called with no arguments, display the trace status.\r\n",
+#endif /* SENSING1_USE_USB_CDC */
+    prvTraceCommand, /* The function to run */
+    -1 /* The user can enter any number of commands. */
+};
+#endif /* (configUSE_TRACE_RECORDER == 1) */
+
 static const CLI_Command_Definition_t xResetCommand =
 {
     "reset",
@@ -258,6 +320,14 @@ void RegisterCLICommands(void)
     FreeRTOS_CLIRegisterCommand(&xUsbCommand);
 #endif /* SENSING1_USE_USB_AUDIO */
 
+#if (configGENERATE_RUN_TIME_STATS == 1)
+    FreeRTOS_CLIRegisterCommand(&xCpuCommand);
+#endif /* (configGENERATE_RUN_TIME_STATS == 1) */
+
+#if (configUSE_TRACE_RECORDER == 1)
+    FreeRTOS_CLIRegisterCommand(&xTraceCommand);
+#endif /* (configUSE_TRACE_RECORDER == 1) */
+
     FreeRTOS_CLIRegisterCommand(&xResetCommand);
 
 #ifdef STM32_SENSORTILEBOX
@@ -293,7 +363,7 @@ static BaseType_t prvInfoCommand(char *pcWriteBuffer, size_t xWriteBufferLen, co
             SENSING1_VERSION_MAJOR,SENSING1_VERSION_MINOR,SENSING1_VERSION_PATCH);
         xReturn = 1; /* There is more to output */
     }
-    else
+    else if (xReturn == 1)
     {
         sprintf(pcWriteBuffer,
             "\t(HAL %ld.%ld.%ld_%ld)\r\n\tCompiled %s %s"
@@ -309,6 +379,30 @@ static BaseType_t prvInfoCommand(char *pcWriteBuffer, size_t xWriteBufferLen, co
             (HAL_GetHalVersion() >> 8)&0xFF,
             HAL_GetHalVersion()      &0xFF,
             __DATE__,__TIME__);
+        xReturn = 2; /* There is more to output */
+    }
+    else
+    {
+        HeapStats_t xHeapStats;
+        uint32_t Fragmentation = 0;
+
+        vPortGetHeapStats(&xHeapStats);
+
+        /* Share of the free heap that is not part of the largest free block */
+        if (xHeapStats.xAvailableHeapSpaceInBytes != 0)
+        {
+            Fragmentation = 100 - ((xHeapStats.xSizeOfLargestFreeBlockInBytes * 100) / xHeapStats.xAvailableHeapSpaceInBytes);
+        }
+
+        sprintf(pcWriteBuffer,
+            "\tHeap %u bytes: %u free, peak used %u\r\n"
+            "\tFree blocks %u (largest %u) fragmentation %lu%%\r\n",
+            (unsigned int)configTOTAL_HEAP_SIZE,
+            (unsigned int)xHeapStats.xAvailableHeapSpaceInBytes,
+            (unsigned int)(configTOTAL_HEAP_SIZE - xHeapStats.xMinimumEverFreeBytesRemaining),
+            (unsigned int)xHeapStats.xNumberOfFreeBlocks,
+            (unsigned int)xHeapStats.xSizeOfLargestFreeBlockInBytes,
+            Fragmentation);
         xReturn = 0; /* done */
     }
 
@@ -967,6 +1061,195 @@ static BaseType_t prvUsbCommand(char *pcWriteBuffer, size_t xWriteBufferLen, con
 }
 #endif /* SENSING1_USE_USB_MSC */
 
+#if (configGENERATE_RUN_TIME_STATS == 1)
+static BaseType_t prvCpuCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    /* The run time counters do not advance in STOP mode, so the CPU time of
+       each task is reported against the wall clock time since boot and the
+       difference is shown as sleep time. One task is output per call. */
+    static TaskStatus_t xTaskStatus[CPU_STATS_MAX_TASKS];
+    static UBaseType_t uxTasks = 0;
+    static UBaseType_t uxIndex = 0;
+    static uint32_t ulElapsedMs = 0;
+    static uint32_t ulRunMs = 0;
+    uint32_t ulCyclesPerMs = SystemCoreClock / 1000;
+    uint32_t ulTaskMs;
+
+    (void) pcCommandString;
+    (void) xWriteBufferLen;
+
+    if (uxIndex == 0)
+    {
+        uint32_t ulTotalRunTime;
+
+        uxTasks = uxTaskGetSystemState(xTaskStatus, CPU_STATS_MAX_TASKS, &ulTotalRunTime);
+        if (uxTasks == 0)
+        {
+            sprintf(pcWriteBuffer, "\r\nMore than %d tasks, increase CPU_STATS_MAX_TASKS\r\n", CPU_STATS_MAX_TASKS);
+            return 0;
+        }
+
+        ulElapsedMs = xTaskGetTickCount() * portTICK_PERIOD_MS;
+        if (ulElapsedMs == 0)
+        {
+            ulElapsedMs = 1;
+        }
+        ulRunMs = (uint32_t)(((uint64_t)ulTotalRunTime << configRUN_TIME_COUNTER_SHIFT) / ulCyclesPerMs);
+
+        sprintf(pcWriteBuffer, "\r\nTask                  ms   CPU%%\r\n");
+        uxIndex = 1;
+        return 1; /* There is more to output */
+    }
+
+    if (uxIndex <= uxTasks)
+    {
+        TaskStatus_t *pxTask = &xTaskStatus[uxIndex - 1];
+
+        ulTaskMs = (uint32_t)(((uint64_t)pxTask->ulRunTimeCounter << configRUN_TIME_COUNTER_SHIFT) / ulCyclesPerMs);
+        sprintf(pcWriteBuffer, "%-16s %9lu %3lu.%lu\r\n",
+                pxTask->pcTaskName,
+                ulTaskMs,
+                (uint32_t)(((uint64_t)ulTaskMs * 100) / ulElapsedMs),
+                (uint32_t)((((uint64_t)ulTaskMs * 1000) / ulElapsedMs) % 10));
+        uxIndex++;
+        return 1; /* There is more to output */
+    }
+
+    /* Time spent in STOP mode (or not accounted yet) */
+    ulTaskMs = (ulElapsedMs > ulRunMs) ? (ulElapsedMs - ulRunMs) : 0;
+    sprintf(pcWriteBuffer, "%-16s %9lu %3lu.%lu\r\n",
+            "(sleep)",
+            ulTaskMs,
+            (uint32_t)(((uint64_t)ulTaskMs * 100) / ulElapsedMs),
+            (uint32_t)((((uint64_t)ulTaskMs * 1000) / ulElapsedMs) % 10));
+    uxIndex = 0;
+
+    return 0;
+}
+#endif /* (configGENERATE_RUN_TIME_STATS == 1) */
+
+#if (configUSE_TRACE_RECORDER == 1)
+static BaseType_t prvTraceCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    const char *pcParameter;
+    BaseType_t xParameterStringLength;
+    const char *pcError;
+
+    (void) xWriteBufferLen;
+
+    pcParameter = FreeRTOS_CLIGetParameter(
+        pcCommandString,        /* The command string itself. */
+        1,                      /* Return the first parameter. */
+        &xParameterStringLength /* Store the parameter string length. */
+    );
+
+    if (pcParameter == NULL)
+    {
+        pcError = xTraceGetLastError();
+        sprintf(pcWriteBuffer, "\r\nTrace %s%s%s\r\n",
+                xTraceIsRecordingEnabled() ? "running" : "stopped",
+                (pcError != NULL) ? ", last error: " : "",
+                (pcError != NULL) ? pcError : "");
+    }
+    else if (strncmp(pcParameter, "start", strlen("start")) == 0)
+    {
+        if (xTraceIsRecordingEnabled() ||
+            ((TimerTraceStartId != NULL) && xTimerIsTimerActive((TimerHandle_t)TimerTraceStartId)))
+        {
+            sprintf(pcWriteBuffer, "\r\nTrace already running\r\n");
+            return 0;
+        }
+
+        pcParameter = FreeRTOS_CLIGetParameter(
+            pcCommandString,        /* The command string itself. */
+            2,                      /* Return the second parameter. */
+            &xParameterStringLength /* Store the parameter string length. */
+        );
+        TraceDurationMs = (pcParameter != NULL) ? (uint32_t)atoi(pcParameter) * 1000 : 0;
+
+        vTraceClearError();
+#if (TRACE_START_DELAY_MS > 0)
+        /* Started by the timer task, the console stays responsive meanwhile */
+        if (TimerTraceStartId == NULL)
+        {
+            TimerTraceStartId = osTimerCreate(osTimer(TimerTraceStartHandle), osTimerOnce, NULL);
+        }
+        osTimerStart(TimerTraceStartId, TRACE_START_DELAY_MS);
+        sprintf(pcWriteBuffer, "\r\nTrace starts in %d s, capture the port to a file now\r\n",
+                TRACE_START_DELAY_MS / 1000);
+#else
+        TraceStartCallback(NULL);
+        sprintf(pcWriteBuffer, "\r\nTrace started\r\n");
+#endif /* (TRACE_START_DELAY_MS > 0) */
+    }
+    else if (strncmp(pcParameter, "stop", strlen("stop")) == 0)
+    {
+        if (TimerTraceStartId != NULL)
+        {
+            osTimerStop(TimerTraceStartId);
+        }
+        if (TimerTraceId != NULL)
+        {
+            osTimerStop(TimerTraceId);
+        }
+        vTraceStop();
+#if !SENSING1_USE_USB_CDC
+        DATALOG_SD_TraceFlush();
+#endif /* !SENSING1_USE_USB_CDC */
+        sprintf(pcWriteBuffer, "\r\nTrace stopped\r\n");
+    }
+    else
+    {
+        sprintf(pcWriteBuffer, "\r\nValid parameters are 'start' and 'stop'.\r\n");
+    }
+
+    return 0;
+}
+
+/**
+  * @brief  Starts the trace, from the one shot timer of "trace start" when the
+  *         host needs time for starting the capture
+  * @param  argument not used
+  * @retval None
+  */
+static void TraceStartCallback(void const *argument)
+{
+    (void) argument;
+
+    /* The trace recorder resets the DWT cycle counter, that is shared with
+       the run time statistics */
+    vTaskSuspendAll();
+    vTraceEnable(TRC_START);
+#if (configGENERATE_RUN_TIME_STATS == 1)
+    vRunTimeCounterResync();
+#endif /* (configGENERATE_RUN_TIME_STATS == 1) */
+    xTaskResumeAll();
+
+    if (TraceDurationMs != 0)
+    {
+        if (TimerTraceId == NULL)
+        {
+            TimerTraceId = osTimerCreate(osTimer(TimerTraceHandle), osTimerOnce, NULL);
+        }
+        osTimerStart(TimerTraceId, TraceDurationMs);
+    }
+}
+
+/**
+  * @brief  One shot timer callback that ends a "trace start <seconds>" capture
+  * @param  argument not used
+  * @retval None
+  */
+static void TraceStopCallback(void const *argument)
+{
+    (void) argument;
+    vTraceStop();
+#if !SENSING1_USE_USB_CDC
+    DATALOG_SD_TraceFlush();
+#endif /* !SENSING1_USE_USB_CDC */
+}
+#endif /* (configUSE_TRACE_RECORDER == 1) */
+
 static BaseType_t prvResetCommand(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
 {
     /* System Reset */
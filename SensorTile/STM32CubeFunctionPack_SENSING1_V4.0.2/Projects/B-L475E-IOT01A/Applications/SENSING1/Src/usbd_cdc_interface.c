@@ -46,6 +46,7 @@
   */
 
 /* Includes ------------------------------------------------------------------*/
+#include <string.h>
 #include "TargetFeatures.h"
 #include "main.h"
 #include "usbd_core.h"
@@ -59,6 +60,9 @@
 #define APP_RX_DATA_SIZE  2048
 #define APP_TX_DATA_SIZE  2048
 
+/* Max time waited by the trace stream for the previous IN transfer to end */
+#define TRACE_TX_TIMEOUT_MS  100
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 USBD_CDC_LineCodingTypeDef LineCoding =
@@ -86,11 +90,16 @@ extern USBD_HandleTypeDef  hUSBDevice;
 extern osSemaphoreId semRxChar;
 extern uint8_t cRxedChar;
 
+/* When set, the IN endpoint carries the trace recorder stream and the console
+   output is discarded, so that the host capture is not corrupted */
+static volatile uint8_t TraceStreaming = 0;
+
 /* Private function prototypes -----------------------------------------------*/
 static int8_t CDC_Itf_Init     (void);
 static int8_t CDC_Itf_DeInit   (void);
 static int8_t CDC_Itf_Control  (uint8_t cmd, uint8_t* pbuf, uint16_t length);
 static int8_t CDC_Itf_Receive  (uint8_t* pbuf, uint32_t *Len);
+static uint8_t CDC_Itf_SendPacket(uint8_t* Buf, uint16_t Len);
 
 USBD_CDC_ItfTypeDef USBD_CDC_fops =
 {
@@ -204,6 +213,91 @@ static int8_t CDC_Itf_Control(uint8_t cmd, uint8_t* pbuf, uint16_t length)
   * @retval USBD_OK if all operations are OK else USBD_FAIL or USBD_BUSY
   */
 uint8_t CDC_Itf_Transmit(uint8_t* Buf, uint16_t Len)
+{
+  if (TraceStreaming)
+  {
+    /* Console output is dropped while the trace is streamed */
+    return USBD_OK;
+  }
+
+  return CDC_Itf_SendPacket(Buf, Len);
+}
+
+/**
+  * @brief  CDC_Itf_SetTraceMode
+  *         Reserve the IN endpoint to the trace recorder stream or give it
+  *         back to the console
+  * @param  Enable: 1 to stream the trace, 0 to restore the console
+  * @retval None
+  */
+void CDC_Itf_SetTraceMode(uint8_t Enable)
+{
+  TraceStreaming = Enable;
+}
+
+/**
+  * @brief  CDC_Itf_TraceWrite
+  *         Write function of the trace recorder stream port (called by TzCtrl)
+  *
+  *         Up to APP_TX_DATA_SIZE bytes are copied to UserTxBuffer and sent in
+  *         one transfer, so that the recorder can release its buffer page as
+  *         soon as this function returns.
+  * @param  Buf: Trace data
+  * @param  Len: Number of bytes to be sent
+  * @param  BytesSent: Number of bytes accepted for transmission
+  * @retval 0 on success, -1 if the host is not reading the stream
+  */
+int32_t CDC_Itf_TraceWrite(void* Buf, uint32_t Len, int32_t* BytesSent)
+{
+  USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef*)hUSBDevice.pClassData;
+  uint32_t Timeout = TRACE_TX_TIMEOUT_MS;
+
+  *BytesSent = 0;
+
+  if (!TraceStreaming)
+  {
+    /* Trace stopped: discard the data left in the recorder buffer */
+    *BytesSent = Len;
+    return 0;
+  }
+
+  if (hcdc == NULL)
+  {
+    return -1;
+  }
+
+  while (hcdc->TxState != 0)
+  {
+    if (Timeout-- == 0)
+    {
+      return -1;
+    }
+    osDelay(1);
+  }
+
+  if (Len > APP_TX_DATA_SIZE)
+  {
+    Len = APP_TX_DATA_SIZE;
+  }
+  memcpy(UserTxBuffer, Buf, Len);
+
+  if (CDC_Itf_SendPacket(UserTxBuffer, (uint16_t)Len) != USBD_OK)
+  {
+    return -1;
+  }
+
+  *BytesSent = Len;
+  return 0;
+}
+
+/**
+  * @brief  CDC_Itf_SendPacket
+  *         Start an IN transfer if the endpoint is free
+  * @param  Buf: Buffer of data to be sent
+  * @param  Len: Number of data to be sent (in bytes)
+  * @retval USBD_OK if all operations are OK else USBD_FAIL or USBD_BUSY
+  */
+static uint8_t CDC_Itf_SendPacket(uint8_t* Buf, uint16_t Len)
 {
   uint8_t result = USBD_OK;
 
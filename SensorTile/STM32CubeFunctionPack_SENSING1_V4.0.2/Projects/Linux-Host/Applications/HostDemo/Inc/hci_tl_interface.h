@@ -0,0 +1,83 @@
+/**
+  ******************************************************************************
+  * @file    hci_tl_interface.h
+  * @author  Central LAB
+  * @version V4.0.0
+  * @date    30-Oct-2019
+  * @brief   Header file for the socket HCI Transport Layer interface
+  *
+  *          The BlueNRG expansion board is replaced by a stream socket carrying
+  *          the HCI packets in the UART (H4) format, so that the BlueNRG stack
+  *          can talk to a controller emulator or to a real controller bridged
+  *          by a tool such as socat.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2018 STMicroelectronics</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without modification,
+  * are permitted provided that the following conditions are met:
+  *   1. Redistributions of source code must retain the above copyright notice,
+  *      this list of conditions and the following disclaimer.
+  *   2. Redistributions in binary form must reproduce the above copyright notice,
+  *      this list of conditions and the following disclaimer in the documentation
+  *      and/or other materials provided with the distribution.
+  *   3. Neither the name of STMicroelectronics nor the names of its contributors
+  *      may be used to endorse or promote products derived from this software
+  *      without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HCI_TL_INTERFACE_H
+#define __HCI_TL_INTERFACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "Host.h"
+
+/* Exported Functions --------------------------------------------------------*/
+void    HCI_TL_SOCKET_SetPath(const char *Path);
+int32_t HCI_TL_SOCKET_Init    (void* pConf);
+int32_t HCI_TL_SOCKET_DeInit  (void);
+int32_t HCI_TL_SOCKET_Receive (uint8_t* buffer, uint16_t size);
+int32_t HCI_TL_SOCKET_Send    (uint8_t* buffer, uint16_t size);
+int32_t HCI_TL_SOCKET_Reset   (void);
+
+/**
+ * @brief  Register hci_tl_interface IO bus services
+ *
+ * @param  None
+ * @retval None
+ */
+void hci_tl_lowlevel_init(void);
+
+/**
+ * @brief HCI Transport Layer Low Level Interrupt Service Routine
+ *
+ * @param  None
+ * @retval None
+ */
+void hci_tl_lowlevel_isr(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __HCI_TL_INTERFACE_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
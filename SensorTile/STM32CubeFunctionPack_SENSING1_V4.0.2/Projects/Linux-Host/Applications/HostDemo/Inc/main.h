@@ -0,0 +1,95 @@
+/**
+  ******************************************************************************
+  * @file    main.h
+  * @author  Central LAB
+  * @version V4.0.0
+  * @date    30-Oct-2019
+  * @brief   Header for main.c module of the Linux host demo
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2018 STMicroelectronics</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without modification,
+  * are permitted provided that the following conditions are met:
+  *   1. Redistributions of source code must retain the above copyright notice,
+  *      this list of conditions and the following disclaimer.
+  *   2. Redistributions in binary form must reproduce the above copyright notice,
+  *      this list of conditions and the following disclaimer in the documentation
+  *      and/or other materials provided with the distribution.
+  *   3. Neither the name of STMicroelectronics nor the names of its contributors
+  *      may be used to endorse or promote products derived from this software
+  *      without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "Host.h"
+#include "Host_audio.h"
+#include "Host_motion_sensors.h"
+#include "Host_sd.h"
+
+/* Exported defines ----------------------------------------------------------*/
+
+/* Microphone: 16 kHz mono, 1 ms per half buffer as in SENSING1 */
+#define AUDIO_SAMPLING_FREQUENCY  16000U
+#define AUDIO_CHANNELS            1U
+#define PCM_AUDIO_IN_SAMPLES      (AUDIO_SAMPLING_FREQUENCY / 1000U)
+
+/* Audio written to the SD card by blocks of one sector */
+#define AUDIO_RING_SIZE           (16U * BLOCK_SIZE)
+#define AUDIO_WRITE_SIZE          BLOCK_SIZE
+
+/* Inertial sensors sampled at 50 Hz, as for the HAR algorithms */
+#define MEMS_SAMPLE_PERIOD_MS     20U
+
+/* Files of the data log on the SD card */
+#define MEMS_LOG_FILE_NAME        "MEMS.CSV"
+#define AUDIO_LOG_FILE_NAME       "MIC.WAV"
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Messages of the Process thread */
+typedef enum
+{
+  MEMS_SAMPLE = 0,
+  AUDIO_DATA,
+  LOG_STOP
+} msgType_t;
+
+typedef struct
+{
+  msgType_t type;
+  uint32_t  Time;
+  BSP_MOTION_SENSOR_Axes_t Acc;
+  BSP_MOTION_SENSOR_Axes_t Gyro;
+  BSP_MOTION_SENSOR_Axes_t Mag;
+} msgData_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MAIN_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,184 @@
+/**
+  ******************************************************************************
+  * @file    hci_socket_peer.c
+  * @author  Central LAB
+  * @version V4.0.0
+  * @date    30-Oct-2019
+  * @brief   Minimal BLE controller on a Unix socket for the Linux host demo
+  *
+  *          Listens on the socket given on the command line and answers the
+  *          HCI commands of HostDemo (H4 format) with a Command Complete
+  *          event: status success for all of them, plus the version of a
+  *          BlueNRG-MS for HCI_LE_Read_Local_Version. It stands in for the
+  *          controller when no BlueNRG is bridged to the host.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2018 STMicroelectronics</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without modification,
+  * are permitted provided that the following conditions are met:
+  *   1. Redistributions of source code must retain the above copyright notice,
+  *      this list of conditions and the following disclaimer.
+  *   2. Redistributions in binary form must reproduce the above copyright notice,
+  *      this list of conditions and the following disclaimer in the documentation
+  *      and/or other materials provided with the distribution.
+  *   3. Neither the name of STMicroelectronics nor the names of its contributors
+  *      may be used to endorse or promote products derived from this software
+  *      without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define HCI_COMMAND_PKT           0x01
+#define HCI_EVENT_PKT             0x04
+#define EVT_CMD_COMPLETE          0x0E
+
+#define OGF_INFO_PARAM            0x04
+#define OCF_READ_LOCAL_VERSION    0x0001
+
+/* Version reported: BlueNRG-MS firmware 7.2c */
+static const uint8_t LocalVersion[] = {
+  0x07,       /* HCI version */
+  0x2c, 0x07, /* HCI revision */
+  0x07,       /* LMP/PAL version */
+  0x30, 0x00, /* Manufacturer: STMicroelectronics */
+  0x00, 0x00  /* LMP/PAL subversion */
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Reads exactly Size bytes
+  * @param  Fd Socket
+  * @param  pBuf Buffer
+  * @param  Size Number of bytes
+  * @retval 0 on success, -1 when the socket is closed
+  */
+static int ReadAll(int Fd, uint8_t *pBuf, size_t Size)
+{
+  ssize_t Count;
+
+  while(Size > 0U) {
+    Count = read(Fd, pBuf, Size);
+    if(Count <= 0) {
+      return -1;
+    }
+    pBuf += Count;
+    Size -= (size_t)Count;
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Answers the commands of one connection until it is closed
+  * @param  Fd Socket of the connection
+  * @retval None
+  */
+static void Serve(int Fd)
+{
+  uint8_t Command[3 + 255];
+  uint8_t Event[3 + 4 + sizeof(LocalVersion)];
+  uint8_t Type;
+  uint16_t Opcode;
+  size_t Length;
+
+  for(;;) {
+    if(ReadAll(Fd, &Type, 1) != 0) {
+      return;
+    }
+    if(Type != HCI_COMMAND_PKT) {
+      fprintf(stderr, "hci_socket_peer: unexpected packet type 0x%02x\n", Type);
+      return;
+    }
+    if((ReadAll(Fd, Command, 3) != 0) || (ReadAll(Fd, &Command[3], Command[2]) != 0)) {
+      return;
+    }
+    Opcode = (uint16_t)(Command[0] | (Command[1] << 8));
+
+    /* Command Complete: packets allowed, opcode, status and parameters */
+    Event[0] = HCI_EVENT_PKT;
+    Event[1] = EVT_CMD_COMPLETE;
+    Event[3] = 1;
+    Event[4] = Command[0];
+    Event[5] = Command[1];
+    Event[6] = 0x00;
+    Length = 7;
+    if(Opcode == ((OGF_INFO_PARAM << 10) | OCF_READ_LOCAL_VERSION)) {
+      memcpy(&Event[7], LocalVersion, sizeof(LocalVersion));
+      Length += sizeof(LocalVersion);
+    }
+    Event[2] = (uint8_t)(Length - 3U);
+
+    printf("hci_socket_peer: command 0x%04x (OGF 0x%02x OCF 0x%03x)\n",
+           Opcode, Opcode >> 10, Opcode & 0x3FFU);
+    if(write(Fd, Event, Length) != (ssize_t)Length) {
+      return;
+    }
+  }
+}
+
+/**
+  * @brief  Main program
+  * @param  argv[1] Path of the socket
+  * @retval None
+  */
+int main(int argc, char *argv[])
+{
+  struct sockaddr_un Address;
+  int Listen;
+  int Fd;
+
+  if((argc != 2) || (strlen(argv[1]) >= sizeof(Address.sun_path))) {
+    fprintf(stderr, "Usage: %s hci.sock\n", argv[0]);
+    return 2;
+  }
+
+  memset(&Address, 0, sizeof(Address));
+  Address.sun_family = AF_UNIX;
+  strcpy(Address.sun_path, argv[1]);
+  unlink(argv[1]);
+
+  Listen = socket(AF_UNIX, SOCK_STREAM, 0);
+  if((Listen < 0) ||
+     (bind(Listen, (struct sockaddr *)&Address, sizeof(Address)) != 0) ||
+     (listen(Listen, 1) != 0)) {
+    perror("hci_socket_peer");
+    return 1;
+  }
+
+  setvbuf(stdout, NULL, _IOLBF, 0);
+  for(;;) {
+    Fd = accept(Listen, NULL, NULL);
+    if(Fd < 0) {
+      perror("hci_socket_peer");
+      return 1;
+    }
+    Serve(Fd);
+    close(Fd);
+  }
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
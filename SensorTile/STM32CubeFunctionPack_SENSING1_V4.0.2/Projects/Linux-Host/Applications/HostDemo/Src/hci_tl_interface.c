@@ -0,0 +1,374 @@
+/**
+  ******************************************************************************
+  * @file    hci_tl_interface.c
+  * @author  Central LAB
+  * @version V4.0.0
+  * @date    30-Oct-2019
+  * @brief   This file provides the implementation of the BlueNRG HCI Transport
+  *          Layer interface on a Unix domain socket
+  *
+  *          The packets are exchanged in the UART (H4) format, the one returned
+  *          by the SPI of the BlueNRG: packet type, header, then parameters. A
+  *          task polls the socket every tick and calls hci_tl_lowlevel_isr() as
+  *          the EXTI interrupt of the BlueNRG does on the boards.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2018 STMicroelectronics</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without modification,
+  * are permitted provided that the following conditions are met:
+  *   1. Redistributions of source code must retain the above copyright notice,
+  *      this list of conditions and the following disclaimer.
+  *   2. Redistributions in binary form must reproduce the above copyright notice,
+  *      this list of conditions and the following disclaimer in the documentation
+  *      and/or other materials provided with the distribution.
+  *   3. Neither the name of STMicroelectronics nor the names of its contributors
+  *      may be used to endorse or promote products derived from this software
+  *      without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+/* Includes ------------------------------------------------------------------*/
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "hci_tl.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Defines -------------------------------------------------------------------*/
+#define HCI_COMMAND_PKT_TYPE   0x01U
+#define HCI_ACLDATA_PKT_TYPE   0x02U
+#define HCI_EVENT_PKT_TYPE     0x04U
+
+/* Priority of the task polling the socket: above the application tasks, as
+   the EXTI interrupt of the BlueNRG on the boards */
+#define HCI_TL_SOCKET_TASK_PRIORITY    (configMAX_PRIORITIES - 1)
+#define HCI_TL_SOCKET_TASK_STACK_SIZE  (configMINIMAL_STACK_SIZE * 2)
+
+/* Private variables ---------------------------------------------------------*/
+static const char *SocketPath = "hci.sock";
+static int SocketFd = -1;
+static TaskHandle_t SocketTask = NULL;
+
+/* Private function prototypes -----------------------------------------------*/
+static int32_t IsDataAvailable(void);
+static int32_t SocketRead(uint8_t *buffer, uint16_t size);
+static void HCI_TL_SOCKET_Task(void *argument);
+
+/******************** IO Operation and BUS services ***************************/
+
+/**
+ * @brief  Selects the socket of the controller
+ *
+ * @param  Path Path of the Unix domain socket, used by HCI_TL_SOCKET_Init()
+ * @retval None
+ */
+void HCI_TL_SOCKET_SetPath(const char *Path)
+{
+  SocketPath = Path;
+}
+
+/**
+ * @brief  Connects to the socket of the controller
+ *
+ * @param  void* Pointer to configuration struct (not used)
+ * @retval int32_t Status
+ */
+int32_t HCI_TL_SOCKET_Init(void* pConf)
+{
+  struct sockaddr_un Addr;
+  (void)pConf;
+
+  if(SocketFd >= 0)
+  {
+    return 0;
+  }
+
+  memset(&Addr, 0, sizeof(Addr));
+  Addr.sun_family = AF_UNIX;
+  strncpy(Addr.sun_path, SocketPath, sizeof(Addr.sun_path) - 1);
+
+  SocketFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if(SocketFd < 0)
+  {
+    return -1;
+  }
+
+  if(connect(SocketFd, (struct sockaddr *)&Addr, sizeof(Addr)) != 0)
+  {
+    close(SocketFd);
+    SocketFd = -1;
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief  Closes the socket of the controller
+ *
+ * @param  None
+ * @retval int32_t 0
+ */
+int32_t HCI_TL_SOCKET_DeInit(void)
+{
+  if(SocketFd >= 0)
+  {
+    close(SocketFd);
+    SocketFd = -1;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Reset BlueNRG module: nothing to do, the controller behind the
+ *        socket is already running
+ *
+ * @param  None
+ * @retval int32_t 0
+ */
+int32_t HCI_TL_SOCKET_Reset(void)
+{
+  return 0;
+}
+
+/**
+ * @brief  Reads one HCI packet from the socket
+ *
+ * @param  buffer : Buffer where the packet is stored
+ * @param  size   : Buffer size
+ * @retval int32_t: Number of read bytes, 0 if the packet has been dropped
+ */
+int32_t HCI_TL_SOCKET_Receive(uint8_t* buffer, uint16_t size)
+{
+  uint8_t Discard[64];
+  uint16_t HeaderSize;
+  uint32_t ParamSize;
+  uint32_t Len;
+
+  if((size < 5U) || (SocketRead(buffer, 1) != 0))
+  {
+    return 0;
+  }
+
+  if(buffer[0] == HCI_EVENT_PKT_TYPE)
+  {
+    HeaderSize = 2;
+  }
+  else if(buffer[0] == HCI_ACLDATA_PKT_TYPE)
+  {
+    HeaderSize = 4;
+  }
+  else
+  {
+    /* Out of sync: drop what is pending */
+    while(IsDataAvailable() && (read(SocketFd, Discard, sizeof(Discard)) > 0))
+    {
+    }
+    return 0;
+  }
+
+  if(SocketRead(&buffer[1], HeaderSize) != 0)
+  {
+    return 0;
+  }
+
+  ParamSize = (HeaderSize == 2U) ? buffer[2] : (uint32_t)(buffer[3] | (buffer[4] << 8));
+
+  if((1U + HeaderSize + ParamSize) > size)
+  {
+    /* Too long for the buffer: drop the packet */
+    while(ParamSize > 0U)
+    {
+      Len = (ParamSize > sizeof(Discard)) ? sizeof(Discard) : ParamSize;
+      if(SocketRead(Discard, (uint16_t)Len) != 0)
+      {
+        break;
+      }
+      ParamSize -= Len;
+    }
+    return 0;
+  }
+
+  if(SocketRead(&buffer[1U + HeaderSize], (uint16_t)ParamSize) != 0)
+  {
+    return 0;
+  }
+
+  return (int32_t)(1U + HeaderSize + ParamSize);
+}
+
+/**
+ * @brief  Writes one HCI packet to the socket
+ *
+ * @param  buffer : data buffer to be written
+ * @param  size   : size of first data buffer to be written
+ * @retval int32_t: Number of written bytes, -1 on error
+ */
+int32_t HCI_TL_SOCKET_Send(uint8_t* buffer, uint16_t size)
+{
+  uint16_t Done = 0;
+  ssize_t Len;
+
+  if(SocketFd < 0)
+  {
+    return -1;
+  }
+
+  while(Done < size)
+  {
+    Len = write(SocketFd, &buffer[Done], size - Done);
+    if(Len < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+      return -1;
+    }
+    Done += (uint16_t)Len;
+  }
+
+  return size;
+}
+
+/**
+ * @brief  Reports if the controller has sent data
+ *
+ * @param  None
+ * @retval int32_t: 1 if data are available, 0 otherwise
+ */
+static int32_t IsDataAvailable(void)
+{
+  struct pollfd Fd;
+
+  if(SocketFd < 0)
+  {
+    return 0;
+  }
+
+  Fd.fd = SocketFd;
+  Fd.events = POLLIN;
+  Fd.revents = 0;
+
+  return ((poll(&Fd, 1, 0) > 0) && ((Fd.revents & POLLIN) != 0)) ? 1 : 0;
+}
+
+/**
+ * @brief  Reads exactly size bytes from the socket
+ *
+ * @param  buffer : Buffer where data are stored
+ * @param  size   : Number of bytes to read
+ * @retval int32_t: 0 on success, -1 if the socket is closed or in error
+ */
+static int32_t SocketRead(uint8_t *buffer, uint16_t size)
+{
+  ssize_t Len;
+
+  while(size > 0U)
+  {
+    /* The tick signal of the Posix port may interrupt the read */
+    Len = read(SocketFd, buffer, size);
+    if(Len < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+      return -1;
+    }
+    if(Len == 0)
+    {
+      /* Controller gone */
+      HCI_TL_SOCKET_DeInit();
+      return -1;
+    }
+    buffer += Len;
+    size -= (uint16_t)Len;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief  Task playing the EXTI interrupt of the BlueNRG
+ *
+ * @param  argument Not used
+ * @retval None
+ */
+static void HCI_TL_SOCKET_Task(void *argument)
+{
+  (void)argument;
+
+  for(;;)
+  {
+    vTaskDelay(1);
+    hci_tl_lowlevel_isr();
+  }
+}
+
+/***************************** hci_tl_interface main functions *****************************/
+/**
+ * @brief  Register hci_tl_interface IO bus services
+ *
+ * @param  None
+ * @retval None
+ */
+void hci_tl_lowlevel_init(void)
+{
+  tHciIO fops;
+
+  /* Register IO bus services */
+  fops.Init    = HCI_TL_SOCKET_Init;
+  fops.DeInit  = HCI_TL_SOCKET_DeInit;
+  fops.Send    = HCI_TL_SOCKET_Send;
+  fops.Receive = HCI_TL_SOCKET_Receive;
+  fops.Reset   = HCI_TL_SOCKET_Reset;
+  fops.GetTick = BSP_GetTick;
+
+  hci_register_io_bus (&fops);
+
+  /* Register event irq handler */
+  if(SocketTask == NULL)
+  {
+    xTaskCreate(HCI_TL_SOCKET_Task, "HciTl", HCI_TL_SOCKET_TASK_STACK_SIZE, NULL,
+                HCI_TL_SOCKET_TASK_PRIORITY, &SocketTask);
+  }
+}
+
+/**
+  * @brief HCI Transport Layer Low Level Interrupt Service Routine
+  *
+  * @param  None
+  * @retval None
+  */
+void hci_tl_lowlevel_isr(void)
+{
+  /* Call hci_notify_asynch_evt() */
+  while(IsDataAvailable())
+  {
+    if (hci_notify_asynch_evt(NULL))
+    {
+      return;
+    }
+  }
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
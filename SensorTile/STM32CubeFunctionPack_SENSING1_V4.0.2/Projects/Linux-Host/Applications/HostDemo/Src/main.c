@@ -0,0 +1,735 @@
+/**
+  ******************************************************************************
+  * @file    main.c
+  * @author  Central LAB
+  * @version V4.0.0
+  * @date    30-Oct-2019
+  * @brief   Main program body of the Linux host demo
+  *
+  *          Runs the data log part of SENSING1 as a Linux process, on the
+  *          FreeRTOS Posix port and the BSP of the host board: the inertial
+  *          sensors replayed from a .csv file and the microphone played from a
+  *          .wav file are logged to the FatFs volume of a file-backed SD card,
+  *          and the BlueNRG stack talks to a controller through a socket.
+  *          At the end, the logs are read back from the SD card and checked
+  *          against the input files.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2018 STMicroelectronics</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without modification,
+  * are permitted provided that the following conditions are met:
+  *   1. Redistributions of source code must retain the above copyright notice,
+  *      this list of conditions and the following disclaimer.
+  *   2. Redistributions in binary form must reproduce the above copyright notice,
+  *      this list of conditions and the following disclaimer in the documentation
+  *      and/or other materials provided with the distribution.
+  *   3. Neither the name of STMicroelectronics nor the names of its contributors
+  *      may be used to endorse or promote products derived from this software
+  *      without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "main.h"
+#include "cmsis_os.h"
+#include "ff_gen_drv.h"
+#include "sd_diskio_Host.h"
+#include "hci.h"
+#include "hci_le.h"
+#include "hci_tl_interface.h"
+
+/* Private variables ---------------------------------------------------------*/
+
+/* Input files */
+static const char *MemsPath  = "mems.csv";
+static const char *AudioPath = "mic.wav";
+static const char *HciPath   = NULL;
+static uint32_t    DurationMs = 0;
+
+/* FatFs */
+static FATFS SDFatFs;
+static FIL MyFileMems;
+static FIL MyFileAudio;
+static char SDPath[4];
+static uint8_t WorkBuffer[_MAX_SS];
+
+/* Microphone record buffer (2 halves of 1 ms) and samples to log */
+static int16_t PCM_Buffer[2 * PCM_AUDIO_IN_SAMPLES * AUDIO_CHANNELS];
+static uint8_t AudioRing[AUDIO_RING_SIZE];
+static volatile uint32_t AudioRingIn  = 0;
+static volatile uint32_t AudioRingOut = 0;
+static uint32_t AudioOverrun = 0;
+
+/* Statistics */
+static uint32_t MemsLogged  = 0;
+static uint32_t AudioLogged = 0;
+static uint64_t AudioEnergy = 0;
+static uint32_t AudioSamples = 0;
+
+static osThreadId ProcessThreadId;
+static osThreadId HostThreadId;
+
+/* Mail queue of the Process thread */
+osMailQDef(mail, 32, msgData_t);
+static osMailQId mail;
+
+static void ProcessThread(void const *argument);
+static void HostThread   (void const *argument);
+static void MemsTimerCallback(void const *argument);
+
+osThreadDef(THREAD_1, ProcessThread, osPriorityNormal     , 0, configMINIMAL_STACK_SIZE*8);
+osThreadDef(THREAD_2, HostThread   , osPriorityAboveNormal, 0, configMINIMAL_STACK_SIZE*6);
+
+osTimerDef (TimerMotionHandle, MemsTimerCallback);
+static osTimerId TimerMotionId;
+
+/* Private function prototypes -----------------------------------------------*/
+static int SendMsgToProcess(msgData_t *msgPtr);
+static uint32_t InitSensors(void);
+static void InitBlueNRG(void);
+static void HCI_Event_CB(void *pckt);
+static uint32_t DataLogStart(void);
+static uint32_t DataLogStop(void);
+static void DataLogMems(msgData_t *msgPtr);
+static void DataLogAudio(uint32_t Final);
+static void WavHeader(uint8_t *pHeader, uint32_t DataSize);
+static uint32_t CheckLogs(void);
+static void Usage(const char *Name);
+
+/**
+  * @brief  Main program
+  * @param  argc, argv: command line, see Usage()
+  * @retval None
+  */
+int main(int argc, char *argv[])
+{
+  int Option;
+
+  while((Option = getopt(argc, argv, "s:m:w:b:t:h")) != -1)
+  {
+    switch(Option)
+    {
+      case 's':
+        BSP_SD_SetImage(optarg);
+        break;
+      case 'm':
+        MemsPath = optarg;
+        break;
+      case 'w':
+        AudioPath = optarg;
+        break;
+      case 'b':
+        HciPath = optarg;
+        break;
+      case 't':
+        DurationMs = (uint32_t)strtoul(optarg, NULL, 10) * 1000U;
+        break;
+      default:
+        Usage(argv[0]);
+        return 2;
+    }
+  }
+
+  BSP_MOTION_SENSOR_SetSource(MemsPath);
+  BSP_AUDIO_IN_SetSource(AudioPath);
+
+  /* Create threads */
+  ProcessThreadId = osThreadCreate(osThread(THREAD_1), NULL);
+  HostThreadId = osThreadCreate(osThread(THREAD_2), NULL);
+
+  /* create mail queue */
+  mail = osMailCreate(osMailQ(mail), NULL);
+
+  TimerMotionId = osTimerCreate(osTimer(TimerMotionHandle), osTimerPeriodic, NULL);
+
+  if((ProcessThreadId == NULL) || (HostThreadId == NULL) || (mail == NULL) || (TimerMotionId == NULL))
+  {
+    printf("Error creating the kernel objects\n");
+    return 1;
+  }
+
+  /* Start scheduler  */
+  osKernelStart();
+
+  /* We should never get here as control is now taken by the scheduler  */
+  return 1;
+}
+
+/**
+  * @brief  Process Thread Function: data log on the SD card
+  * @param  None
+  * @retval None
+  */
+static void ProcessThread(void const *argument)
+{
+  msgData_t *msgPtr;
+  osEvent evt;
+  uint32_t Result;
+  (void)argument;
+
+  if(DataLogStart() == 0)
+  {
+    exit(1);
+  }
+
+  for (;;) {
+    evt = osMailGet(mail, osWaitForever);
+    if (evt.status != osEventMail) {
+      continue;
+    }
+    msgPtr = evt.value.p;
+    switch(msgPtr->type) {
+      case MEMS_SAMPLE:
+        DataLogMems(msgPtr);
+        break;
+      case AUDIO_DATA:
+        DataLogAudio(0);
+        break;
+      case LOG_STOP:
+        Result = DataLogStop();
+        if(Result != 0)
+        {
+          Result = CheckLogs();
+        }
+        exit(Result ? 0 : 1);
+        break;
+      default:
+        break;
+    }
+    osMailFree(mail, msgPtr);
+  }
+}
+
+/**
+  * @brief  Host Thread Function: sensors and BlueNRG
+  * @param  None
+  * @retval None
+  */
+static void HostThread(void const *argument)
+{
+  msgData_t msg;
+  uint32_t StartTick;
+  (void)argument;
+
+  if(InitSensors() == 0)
+  {
+    exit(1);
+  }
+
+  if(HciPath != NULL)
+  {
+    InitBlueNRG();
+  }
+
+  StartTick = osKernelSysTick();
+
+  for (;;) {
+    osDelay(10);
+
+    if(HciPath != NULL)
+    {
+      hci_user_evt_proc();
+    }
+
+    if(((DurationMs == 0U) && BSP_MOTION_SENSOR_IsSourceEnded()) ||
+       ((DurationMs != 0U) && ((osKernelSysTick() - StartTick) >= DurationMs)))
+    {
+      break;
+    }
+  }
+
+  /* Stop the acquisition and close the logs */
+  osTimerStop(TimerMotionId);
+  BSP_AUDIO_IN_Stop(1);
+
+  memset(&msg, 0, sizeof(msg));
+  msg.type = LOG_STOP;
+  SendMsgToProcess(&msg);
+
+  for (;;) {
+    osDelay(osWaitForever);
+  }
+}
+
+/**
+  * @brief  Posts a message to the Process thread
+  * @param  msgPtr Message, copied
+  * @retval 1 if posted, 0 otherwise
+  */
+static int SendMsgToProcess(msgData_t *msgPtr)
+{
+  msgData_t *ptr;
+
+  ptr = osMailAlloc(mail, 0);
+  if (ptr == NULL) {
+    return 0;
+  }
+  memcpy(ptr, msgPtr, sizeof(msgData_t));
+  osMailPut(mail, ptr);
+
+  return 1;
+}
+
+/**
+  * @brief  Initializes the inertial sensors and the microphone
+  * @param  None
+  * @retval 1 on success, 0 otherwise
+  */
+static uint32_t InitSensors(void)
+{
+  BSP_AUDIO_Init_t MicParams;
+
+  if((BSP_MOTION_SENSOR_Init(LSM6DSM_0, MOTION_ACCELERO | MOTION_GYRO) != BSP_ERROR_NONE) ||
+     (BSP_MOTION_SENSOR_Init(LSM303AGR_MAG_0, MOTION_MAGNETO) != BSP_ERROR_NONE))
+  {
+    printf("Error reading the inertial sensors from %s\n", MemsPath);
+    return 0;
+  }
+
+  MicParams.BitsPerSample = AUDIO_RESOLUTION_16b;
+  MicParams.ChannelsNbr = AUDIO_CHANNELS;
+  MicParams.Device = AUDIO_IN_DIGITAL_MIC;
+  MicParams.SampleRate = AUDIO_SAMPLING_FREQUENCY;
+  MicParams.Volume = 32;
+
+  if(BSP_AUDIO_IN_Init(1, &MicParams) != BSP_ERROR_NONE)
+  {
+    printf("Error reading the microphone from %s (16-bit %u Hz mono expected)\n",
+           AudioPath, (unsigned)AUDIO_SAMPLING_FREQUENCY);
+    return 0;
+  }
+
+  BSP_MOTION_SENSOR_Enable(LSM6DSM_0, MOTION_ACCELERO);
+  BSP_MOTION_SENSOR_Enable(LSM6DSM_0, MOTION_GYRO);
+  BSP_MOTION_SENSOR_Enable(LSM303AGR_MAG_0, MOTION_MAGNETO);
+  osTimerStart(TimerMotionId, MEMS_SAMPLE_PERIOD_MS);
+
+  BSP_AUDIO_IN_Record(1, (uint8_t *)PCM_Buffer, sizeof(PCM_Buffer));
+
+  return 1;
+}
+
+/**
+  * @brief  Initializes the BlueNRG stack and reads the controller version
+  * @param  None
+  * @retval None
+  */
+static void InitBlueNRG(void)
+{
+  uint8_t  hci_version, lmp_pal_version;
+  uint16_t hci_revision, manufacturer_name, lmp_pal_subversion;
+  int ret;
+
+  HCI_TL_SOCKET_SetPath(HciPath);
+  hci_init(HCI_Event_CB, NULL);
+
+  ret = hci_reset();
+  if(ret != 0)
+  {
+    printf("HCI reset failed on %s: 0x%02x\n", HciPath, ret);
+    return;
+  }
+
+  ret = hci_le_read_local_version(&hci_version, &hci_revision, &lmp_pal_version,
+                                  &manufacturer_name, &lmp_pal_subversion);
+  if(ret != 0)
+  {
+    printf("HCI read local version failed: 0x%02x\n", ret);
+    return;
+  }
+
+  printf("BlueNRG controller: HCI %u rev 0x%04x, LMP %u subversion 0x%04x, manufacturer 0x%04x\n",
+         hci_version, hci_revision, lmp_pal_version, lmp_pal_subversion, manufacturer_name);
+}
+
+/**
+  * @brief  Callback of the events of the controller not consumed by a request
+  * @param  pckt Packet in H4 format
+  * @retval None
+  */
+static void HCI_Event_CB(void *pckt)
+{
+  const uint8_t *pPacket = pckt;
+
+  printf("HCI event 0x%02x (%u bytes)\n", pPacket[1], pPacket[2]);
+}
+
+/**
+  * @brief  Motion timer: samples the inertial sensors
+  * @param  None
+  * @retval None
+  */
+static void MemsTimerCallback(void const *argument)
+{
+  msgData_t msg;
+  (void)argument;
+
+  msg.type = MEMS_SAMPLE;
+  msg.Time = osKernelSysTick();
+  BSP_MOTION_SENSOR_GetAxes(LSM6DSM_0, MOTION_ACCELERO, &msg.Acc);
+  BSP_MOTION_SENSOR_GetAxes(LSM6DSM_0, MOTION_GYRO, &msg.Gyro);
+  BSP_MOTION_SENSOR_GetAxes(LSM303AGR_MAG_0, MOTION_MAGNETO, &msg.Mag);
+
+  SendMsgToProcess(&msg);
+}
+
+/**
+  * @brief  Copies one half of the record buffer to the samples to log
+  * @param  pPcm Half of the record buffer
+  * @retval None
+  */
+static void AudioProcess(const int16_t *pPcm)
+{
+  msgData_t msg;
+  uint32_t Size = sizeof(PCM_Buffer) / 2U;
+  uint32_t Index;
+  uint32_t Before;
+
+  for(Index = 0; Index < (Size / sizeof(int16_t)); Index++)
+  {
+    AudioEnergy += (uint64_t)((int32_t)pPcm[Index] * pPcm[Index]);
+  }
+  AudioSamples += Size / sizeof(int16_t);
+
+  if((AudioRingIn - AudioRingOut + Size) > AUDIO_RING_SIZE)
+  {
+    AudioOverrun++;
+    return;
+  }
+
+  for(Index = 0; Index < Size; Index++)
+  {
+    AudioRing[(AudioRingIn + Index) % AUDIO_RING_SIZE] = ((const uint8_t *)pPcm)[Index];
+  }
+  Before = AudioRingIn;
+  AudioRingIn += Size;
+
+  /* Wake the Process thread once per sector */
+  if((Before / AUDIO_WRITE_SIZE) != (AudioRingIn / AUDIO_WRITE_SIZE))
+  {
+    msg.type = AUDIO_DATA;
+    SendMsgToProcess(&msg);
+  }
+}
+
+/**
+  * @brief  Half Transfer user callback, called by BSP functions.
+  * @param  None
+  * @retval None
+  */
+void BSP_AUDIO_IN_HalfTransfer_CallBack(uint32_t Instance)
+{
+  (void)Instance;
+  AudioProcess(&PCM_Buffer[0]);
+}
+
+/**
+  * @brief  Transfer Complete user callback, called by BSP functions.
+  * @param  None
+  * @retval None
+  */
+void BSP_AUDIO_IN_TransferComplete_CallBack(uint32_t Instance)
+{
+  (void)Instance;
+  AudioProcess(&PCM_Buffer[PCM_AUDIO_IN_SAMPLES * AUDIO_CHANNELS]);
+}
+
+/**
+  * @brief  Mounts the SD card, formatting it if needed, and creates the logs
+  * @param  None
+  * @retval 1 on success, 0 otherwise
+  */
+static uint32_t DataLogStart(void)
+{
+  static const char Introduction[] =
+    "Sensors' Acquisition [Hz]: Mic@16000 Volume=32 Acc@50.0 Gyro@50.0 Mag@50.0 \n";
+  static const char Header[] =
+    "hh:mm:ss.ms, Annotation , AccX [mg], AccY, AccZ, GyroX [mdps], GyroY, GyroZ, MagX [mgauss], MagY, MagZ\n";
+  uint8_t WavHeaderBuf[44];
+  UINT byteswritten;
+  FRESULT res;
+
+  if (FATFS_LinkDriver(&SD_Driver, SDPath) != 0) {
+    return 0;
+  }
+
+  res = f_mount(&SDFatFs, (TCHAR const *)SDPath, 1);
+  if(res == FR_NO_FILESYSTEM) {
+    printf("Formatting the SD card\n");
+    res = f_mkfs(SDPath, FM_ANY, 0, WorkBuffer, sizeof(WorkBuffer));
+    if(res == FR_OK) {
+      res = f_mount(&SDFatFs, (TCHAR const *)SDPath, 1);
+    }
+  }
+  if(res != FR_OK) {
+    printf("Error mounting the SD card: %d\n", res);
+    return 0;
+  }
+
+  if((f_open(&MyFileMems, MEMS_LOG_FILE_NAME, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) ||
+     (f_write(&MyFileMems, Introduction, sizeof(Introduction) - 1, &byteswritten) != FR_OK) ||
+     (f_write(&MyFileMems, Header, sizeof(Header) - 1, &byteswritten) != FR_OK)) {
+    printf("Error creating %s\n", MEMS_LOG_FILE_NAME);
+    return 0;
+  }
+
+  WavHeader(WavHeaderBuf, 0);
+  if((f_open(&MyFileAudio, AUDIO_LOG_FILE_NAME, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) ||
+     (f_write(&MyFileAudio, WavHeaderBuf, sizeof(WavHeaderBuf), &byteswritten) != FR_OK)) {
+    printf("Error creating %s\n", AUDIO_LOG_FILE_NAME);
+    return 0;
+  }
+
+  return 1;
+}
+
+/**
+  * @brief  Writes the remaining samples, updates the WAV header and closes the logs
+  * @param  None
+  * @retval 1 on success, 0 otherwise
+  */
+static uint32_t DataLogStop(void)
+{
+  uint8_t WavHeaderBuf[44];
+  UINT byteswritten;
+  uint32_t Result = 1;
+
+  DataLogAudio(1);
+
+  WavHeader(WavHeaderBuf, AudioLogged);
+  if((f_lseek(&MyFileAudio, 0) != FR_OK) ||
+     (f_write(&MyFileAudio, WavHeaderBuf, sizeof(WavHeaderBuf), &byteswritten) != FR_OK)) {
+    Result = 0;
+  }
+
+  if((f_close(&MyFileAudio) != FR_OK) || (f_close(&MyFileMems) != FR_OK)) {
+    Result = 0;
+  }
+
+  return Result;
+}
+
+/**
+  * @brief  Writes one line of inertial data, as DataLog_Manager.c
+  * @param  msgPtr Sample
+  * @retval None
+  */
+static void DataLogMems(msgData_t *msgPtr)
+{
+  char myBuffer[160];
+  UINT byteswritten;
+  uint32_t Ms = msgPtr->Time;
+  int CharPos;
+
+  CharPos = sprintf(myBuffer, "%02u:%02u:%02u.%03u,,%d,%d,%d,%d,%d,%d,%d,%d,%d\n",
+                    (unsigned)(Ms / 3600000U), (unsigned)((Ms / 60000U) % 60U),
+                    (unsigned)((Ms / 1000U) % 60U), (unsigned)(Ms % 1000U),
+                    (int)msgPtr->Acc.x, (int)msgPtr->Acc.y, (int)msgPtr->Acc.z,
+                    (int)msgPtr->Gyro.x, (int)msgPtr->Gyro.y, (int)msgPtr->Gyro.z,
+                    (int)msgPtr->Mag.x, (int)msgPtr->Mag.y, (int)msgPtr->Mag.z);
+
+  if(f_write(&MyFileMems, myBuffer, (UINT)CharPos, &byteswritten) == FR_OK) {
+    MemsLogged++;
+  }
+}
+
+/**
+  * @brief  Writes the samples of the microphone by whole sectors
+  * @param  Final 1 to also write the last partial sector
+  * @retval None
+  */
+static void DataLogAudio(uint32_t Final)
+{
+  uint8_t Block[AUDIO_WRITE_SIZE];
+  uint32_t Size;
+  uint32_t Index;
+  UINT byteswritten;
+
+  for(;;) {
+    Size = AudioRingIn - AudioRingOut;
+    if(Size > AUDIO_WRITE_SIZE) {
+      Size = AUDIO_WRITE_SIZE;
+    }
+    if((Size == 0U) || ((Size < AUDIO_WRITE_SIZE) && (Final == 0U))) {
+      break;
+    }
+    for(Index = 0; Index < Size; Index++) {
+      Block[Index] = AudioRing[(AudioRingOut + Index) % AUDIO_RING_SIZE];
+    }
+    AudioRingOut += Size;
+    if(f_write(&MyFileAudio, Block, Size, &byteswritten) == FR_OK) {
+      AudioLogged += byteswritten;
+    }
+  }
+}
+
+/**
+  * @brief  Builds the header of a 16-bit PCM WAV file
+  * @param  pHeader 44 bytes header
+  * @param  DataSize Size of the samples in bytes
+  * @retval None
+  */
+static void WavHeader(uint8_t *pHeader, uint32_t DataSize)
+{
+  uint32_t ByteRate = AUDIO_SAMPLING_FREQUENCY * AUDIO_CHANNELS * 2U;
+  uint32_t Field[] = {36U + DataSize, 16U, ByteRate, DataSize};
+  uint32_t Index;
+
+  memcpy(&pHeader[0], "RIFF\0\0\0\0WAVEfmt \0\0\0\0", 20);
+  pHeader[20] = 1;                         /* PCM */
+  pHeader[21] = 0;
+  pHeader[22] = (uint8_t)AUDIO_CHANNELS;
+  pHeader[23] = 0;
+  for(Index = 0; Index < 4U; Index++) {
+    pHeader[4 + Index]  = (uint8_t)(Field[0] >> (8U * Index));
+    pHeader[16 + Index] = (uint8_t)(Field[1] >> (8U * Index));
+    pHeader[24 + Index] = (uint8_t)(AUDIO_SAMPLING_FREQUENCY >> (8U * Index));
+    pHeader[28 + Index] = (uint8_t)(Field[2] >> (8U * Index));
+    pHeader[40 + Index] = (uint8_t)(Field[3] >> (8U * Index));
+  }
+  pHeader[32] = (uint8_t)(AUDIO_CHANNELS * 2U); /* Block align */
+  pHeader[33] = 0;
+  pHeader[34] = 16;                        /* Bits per sample */
+  pHeader[35] = 0;
+  memcpy(&pHeader[36], "data", 4);
+}
+
+/**
+  * @brief  Offset and size of the samples of a WAV file on the host
+  * @param  File WAV file
+  * @param  pSize Size of the samples
+  * @retval Offset of the samples, -1 if not found
+  */
+static long WavData(FILE *File, uint32_t *pSize)
+{
+  uint8_t Chunk[8];
+  uint32_t Size;
+
+  if(fseek(File, 12, SEEK_SET) != 0) {
+    return -1;
+  }
+  while(fread(Chunk, 1, 8, File) == 8) {
+    Size = Chunk[4] | (Chunk[5] << 8) | (Chunk[6] << 16) | ((uint32_t)Chunk[7] << 24);
+    if(memcmp(Chunk, "data", 4) == 0) {
+      *pSize = Size & ~1U;
+      return ftell(File);
+    }
+    if(fseek(File, (long)(Size + (Size & 1U)), SEEK_CUR) != 0) {
+      break;
+    }
+  }
+
+  return -1;
+}
+
+/**
+  * @brief  Reads the logs back from the SD card and checks them against the inputs
+  * @param  None
+  * @retval 1 if the logs are consistent, 0 otherwise
+  */
+static uint32_t CheckLogs(void)
+{
+  FIL File;
+  char Line[160];
+  uint8_t Logged[512];
+  uint8_t *Source;
+  uint32_t Lines = 0;
+  uint32_t SourceSize = 0;
+  uint32_t Pos = 0;
+  uint32_t Mismatch = 0;
+  uint32_t Index;
+  long SourceStart;
+  UINT bytesread;
+  FILE *Wav;
+  uint32_t Result = 1;
+  double Rms;
+
+  /* Inertial log: one line per sample after the description and the header */
+  if(f_open(&File, MEMS_LOG_FILE_NAME, FA_READ) != FR_OK) {
+    printf("Error opening %s\n", MEMS_LOG_FILE_NAME);
+    return 0;
+  }
+  while(f_gets(Line, sizeof(Line), &File) != NULL) {
+    Lines++;
+  }
+  f_close(&File);
+
+  printf("%s: %u samples logged, %u lines read back\n", MEMS_LOG_FILE_NAME,
+         (unsigned)MemsLogged, (unsigned)(Lines - 2U));
+  if((Lines - 2U) != MemsLogged) {
+    Result = 0;
+  }
+
+  /* Audio log: the samples of the input file, played in loop */
+  Wav = fopen(AudioPath, "rb");
+  SourceStart = (Wav != NULL) ? WavData(Wav, &SourceSize) : -1;
+  Source = (SourceStart >= 0) ? malloc(SourceSize) : NULL;
+  if((Source == NULL) || (SourceSize == 0U) ||
+     (fread(Source, 1, SourceSize, Wav) != SourceSize) ||
+     (f_open(&File, AUDIO_LOG_FILE_NAME, FA_READ) != FR_OK) ||
+     (f_lseek(&File, 44) != FR_OK)) {
+    printf("Error opening the audio files\n");
+    return 0;
+  }
+  fclose(Wav);
+
+  while((f_read(&File, Logged, sizeof(Logged), &bytesread) == FR_OK) && (bytesread > 0U)) {
+    for(Index = 0; Index < bytesread; Index++, Pos++) {
+      if(Logged[Index] != Source[Pos % SourceSize]) {
+        Mismatch++;
+      }
+    }
+  }
+  f_close(&File);
+  free(Source);
+
+  Rms = (AudioSamples != 0U) ? (double)AudioEnergy / AudioSamples : 0.0;
+  printf("%s: %u bytes logged (%u ms), %u overruns, %u bytes differ from %s, mean power %.0f\n",
+         AUDIO_LOG_FILE_NAME, (unsigned)AudioLogged,
+         (unsigned)(AudioLogged / (AUDIO_SAMPLING_FREQUENCY * AUDIO_CHANNELS * 2U / 1000U)),
+         (unsigned)AudioOverrun, (unsigned)Mismatch, AudioPath, Rms);
+  if((Pos != AudioLogged) || (Mismatch != 0U) || (AudioOverrun != 0U)) {
+    Result = 0;
+  }
+
+  printf("%s\n", Result ? "Logs OK" : "Logs KO");
+
+  return Result;
+}
+
+/**
+  * @brief  Prints the command line
+  * @param  Name Name of the program
+  * @retval None
+  */
+static void Usage(const char *Name)
+{
+  printf("Usage: %s [-s sd.img] [-m mems.csv] [-w mic.wav] [-b hci.sock] [-t seconds]\n"
+         "  -s  image file of the SD card, created and formatted if needed\n"
+         "  -m  inertial sensors, in the format of the SD card data log\n"
+         "  -w  microphone, 16-bit 16 kHz mono WAV file\n"
+         "  -b  Unix socket of the BLE controller (HCI packets in H4 format)\n"
+         "  -t  duration, default up to the end of the inertial sensors file\n",
+         Name);
+}
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
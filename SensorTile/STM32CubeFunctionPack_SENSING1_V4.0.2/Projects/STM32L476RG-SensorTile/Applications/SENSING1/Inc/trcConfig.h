@@ -67,7 +67,8 @@ extern "C" {
  *****************************************************************************/
 #ifdef STM32F7 
   #include "stm32f7xx.h"
-#elif defined(USE_STM32L4XX_NUCLEO)
+#elif defined(USE_STM32L4XX_NUCLEO) || defined(STM32_SENSORTILE) || \
+      defined(USE_STM32L475E_IOT01) || defined(STM32_SENSORTILEBOX)
   #include "stm32l4xx.h"
 #else
   #error "Trace Recorder: Please include your processor's header file here and remove this line."
@@ -106,7 +107,7 @@ extern "C" {
  * TRC_RECORDER_MODE_SNAPSHOT
  * TRC_RECORDER_MODE_STREAMING
  ******************************************************************************/
-#define TRC_CFG_RECORDER_MODE TRC_RECORDER_MODE_SNAPSHOT
+#define TRC_CFG_RECORDER_MODE TRC_RECORDER_MODE_STREAMING
 
 /******************************************************************************
  * TRC_CFG_FREERTOS_VERSION
@@ -122,7 +123,7 @@ extern "C" {
  * TRC_FREERTOS_VERSION_9_0_1					If using FreeRTOS v9.0.1
  * TRC_FREERTOS_VERSION_9_0_2					If using FreeRTOS v9.0.2 or later
  *****************************************************************************/
-#define TRC_CFG_FREERTOS_VERSION TRC_FREERTOS_VERSION_9_0_0
+#define TRC_CFG_FREERTOS_VERSION TRC_FREERTOS_VERSION_9_0_2
 
 /*******************************************************************************
  * TRC_CFG_SCHEDULING_ONLY
@@ -137,10 +137,12 @@ extern "C" {
  * Specifies the size of each page in the paged event buffer. This can be tuned 
  * to match any internal low-level buffers used by the streaming interface, like
  * the Ethernet MTU (Maximum Transmission Unit).
+ * Matched to the USB CDC transmit buffer (APP_TX_DATA_SIZE in usbd_cdc_interface.c)
+ * so that each page is sent in one transfer.
  *
  * Note: not used by the J-Link RTT stream port (see SEGGER_RTT_Conf.h instead)
  ******************************************************************************/
-#define TRC_CFG_PAGED_EVENT_BUFFER_PAGE_SIZE 2500
+#define TRC_CFG_PAGED_EVENT_BUFFER_PAGE_SIZE 2048
 
 /*******************************************************************************
  * TRC_CFG_ISR_TAILCHAINING_THRESHOLD
@@ -75,6 +75,8 @@ extern USBD_CDC_ItfTypeDef  USBD_CDC_fops;
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 uint8_t CDC_Itf_Transmit(uint8_t* Buf, uint16_t Len);
+void CDC_Itf_SetTraceMode(uint8_t Enable);
+int32_t CDC_Itf_TraceWrite(void* Buf, uint32_t Len, int32_t* BytesSent);
 #endif /* __USBD_CDC_IF_H */
 
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
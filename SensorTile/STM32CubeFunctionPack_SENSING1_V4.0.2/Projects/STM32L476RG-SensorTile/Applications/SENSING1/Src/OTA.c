@@ -58,6 +58,15 @@ typedef struct
   uint32_t ProgStartAdd;
 } BootLoaderFeatures_t;
 
+/* Header of the persisted OTA state used for resuming one interrupted update */
+typedef struct
+{
+  uint32_t MagicNum;
+  uint32_t SizeOfUpdate;
+  uint32_t uwCRCValue;
+  uint32_t ChunkSize;
+} OTAResumeHeader_t;
+
 /* Local defines -------------------------------------------------------------*/
 
 #ifndef STM32_SENSORTILEBOX
@@ -84,9 +93,27 @@ typedef struct
 
 #endif /* STM32_SENSORTILEBOX */
 
+/* Board  FW OTA resume state Position (4Kbytes just below the MetaDataManager) */
+#define OTA_RESUME_STATE_POS  (MDM_FLASH_ADD-0x1000)
+#define OTA_RESUME_STATE_SIZE 0x1000
+
 /* Board  FW OTA Magic Number */
 #define OTA_MAGIC_NUM 0xDEADBEEF
 
+/* Board  FW OTA resume state Magic Number */
+#define OTA_RESUME_MAGIC_NUM 0xC0DEFEED
+
+/* One chunk of the resume bitmap is one Flash page of the OTA area */
+#define OTA_RESUME_CHUNK_SIZE FLASH_PAGE_SIZE
+
+/* Max number of chunks for the biggest possible update (Magic Numbers included) */
+#define OTA_RESUME_MAX_CHUNKS ((OTA_MAX_PROG_SIZE+16+OTA_RESUME_CHUNK_SIZE-1)/OTA_RESUME_CHUNK_SIZE)
+
+/* First and last address of the journal with the received chunks.
+ * Each entry is one double word: (~ChunkIndex<<32) | ChunkIndex */
+#define OTA_RESUME_JOURNAL_START (OTA_RESUME_STATE_POS+sizeof(OTAResumeHeader_t))
+#define OTA_RESUME_JOURNAL_END   (OTA_RESUME_STATE_POS+OTA_RESUME_STATE_SIZE)
+
 /* Board Partial OTA for NN Weights */
 #define NN_OTA_MAGIC_NUM 0xABADBABE
 
@@ -102,6 +129,18 @@ typedef struct
 /* Local Macros -------------------------------------------------------------*/
 #define OTA_ERROR_FUNCTION() { while(1);}
 
+/* Chunk containing one address of the OTA area */
+#define OTA_CHUNK_OF(Address) (((Address)-OTA_MAGIC_NUM_POS)/OTA_RESUME_CHUNK_SIZE)
+
+/* Image offset where one chunk begins (the first one contains the Magic Numbers) */
+#define OTA_CHUNK_OFFSET(Chunk) (((Chunk)==0) ? 0 : (((Chunk)*OTA_RESUME_CHUNK_SIZE)-16))
+
+/* Number of chunks for one update of SizeOfUpdate bytes */
+#define OTA_CHUNKS_FOR(SizeOfUpdate) (((SizeOfUpdate)+16+OTA_RESUME_CHUNK_SIZE-1)/OTA_RESUME_CHUNK_SIZE)
+
+/* Check if one chunk was already saved in Flash */
+#define OTA_CHUNK_IS_DONE(Chunk) (OTAChunkBitMap[(Chunk)>>3] & (1<<((Chunk)&0x7)))
+
 /* Private variables ---------------------------------------------------------*/
 static uint32_t SizeOfUpdateBlueFW=0;
 static uint32_t ExpecteduwCRCValue=0;
@@ -109,6 +148,17 @@ static uint32_t WritingAddress = OTA_ADDRESS_START;
 
 static BootLoaderFeatures_t *BootLoaderFeatures = (BootLoaderFeatures_t *)0x08003F00;
 
+/* Received chunks bitmap, mirror of the journal saved in Flash */
+static uint8_t OTAChunkBitMap[(OTA_RESUME_MAX_CHUNKS+7)>>3];
+static uint32_t OTAJournalAddress = OTA_RESUME_JOURNAL_START;
+
+/* Local function prototypes --------------------------------------------------*/
+static void EraseFlashPages(uint32_t Address, uint32_t NbPages);
+static void OTAResumeStateReset(void);
+static void OTAResumeStateInvalidate(void);
+static int32_t OTAResumeStateLoad(void);
+static void OTAResumeMarkChunk(uint32_t Chunk);
+
 /* Exported functions  --------------------------------------------------*/
 /**
  * @brief Function for Testing the BootLoader Compliance
@@ -177,10 +227,18 @@ int8_t UpdateFWBlueMS(uint32_t *SizeOfUpdate, uint8_t *att_data, int32_t data_le
     HAL_FLASH_Unlock();
 
     for(Counter=0;Counter<data_length;Counter+=8) {
+      uint32_t Chunk = OTA_CHUNK_OF(WritingAddress);
       memcpy((uint8_t*) &ValueToWrite,att_data+Counter,data_length-Counter+1);
 
-      if(HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, WritingAddress,ValueToWrite)==HAL_OK) {
-       WritingAddress+=8;
+      if(OTA_CHUNK_IS_DONE(Chunk)) {
+        /* Chunk already saved before one disconnection... skip it */
+        WritingAddress+=8;
+      } else if(HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, WritingAddress,ValueToWrite)==HAL_OK) {
+        WritingAddress+=8;
+        if(((WritingAddress-OTA_MAGIC_NUM_POS)%OTA_RESUME_CHUNK_SIZE)==0) {
+          /* One Flash page completed: save the progress */
+          OTAResumeMarkChunk(Chunk);
+        }
       } else {
         /* Error occurred while writing data in Flash memory.
            User can add here some code to deal with this error
@@ -195,6 +253,9 @@ int8_t UpdateFWBlueMS(uint32_t *SizeOfUpdate, uint8_t *att_data, int32_t data_le
       /* We had received the whole firmware and we have saved it in Flash */
       OTA_PRINTF("OTA Update saved\r\n");
 
+      /* Nothing to resume anymore: a wrong CRC needs a full restart */
+      OTAResumeStateInvalidate();
+
       if(WriteMagicNum) {
         uint32_t uwCRCValue = 0;
 
@@ -390,6 +451,242 @@ void StartUpdateFWBlueMS(uint32_t SizeOfUpdate, uint32_t uwCRCValue)
   /* Lock the Flash to disable the flash control register access (recommended
   to protect the FLASH memory against possible unwanted operation) *********/
   HAL_FLASH_Lock();
+
+  /* Start a new progress journal for this update */
+  OTAResumeStateReset();
+  {
+    OTAResumeHeader_t Header;
+    uint64_t ValueToWrite;
+
+    Header.MagicNum     = OTA_RESUME_MAGIC_NUM;
+    Header.SizeOfUpdate = SizeOfUpdate;
+    Header.uwCRCValue   = uwCRCValue;
+    Header.ChunkSize    = OTA_RESUME_CHUNK_SIZE;
+
+    HAL_FLASH_Unlock();
+    memcpy((uint8_t*) &ValueToWrite,((uint8_t*) &Header)+8,8);
+    if(HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, OTA_RESUME_STATE_POS+8,ValueToWrite)!=HAL_OK) {
+      OTA_ERROR_FUNCTION();
+    }
+    /* The Magic Number is written last for validating the header */
+    memcpy((uint8_t*) &ValueToWrite,(uint8_t*) &Header,8);
+    if(HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, OTA_RESUME_STATE_POS,ValueToWrite)!=HAL_OK) {
+      OTA_ERROR_FUNCTION();
+    }
+    HAL_FLASH_Lock();
+  }
+}
+
+/**
+ * @brief Resume Function for Updating the Firmware
+ *
+ * If the Flash contains the progress of one previous update with the same size
+ * and CRC value, the chunks not completed are erased again and the update
+ * continues from the first missing chunk. Otherwise a new update is started.
+ * @param uint32_t SizeOfUpdate  size of the firmware image [bytes]
+ * @param uint32_t uwCRCValue expected CRC value
+ * @retval uint32_t Image offset from which the update must be resent [bytes]
+ */
+uint32_t ResumeUpdateFWBlueMS(uint32_t SizeOfUpdate, uint32_t uwCRCValue)
+{
+  OTAResumeHeader_t *Header = (OTAResumeHeader_t *)OTA_RESUME_STATE_POS;
+  uint32_t NumChunks = OTA_CHUNKS_FOR(SizeOfUpdate);
+  uint32_t FirstMissing = NumChunks;
+  uint32_t Chunk;
+
+  if((OTAResumeStateLoad()==0) ||
+     (Header->SizeOfUpdate!=SizeOfUpdate) ||
+     (Header->uwCRCValue!=uwCRCValue)) {
+    OTA_PRINTF("No OTA to resume\r\n");
+    StartUpdateFWBlueMS(SizeOfUpdate, uwCRCValue);
+    return 0;
+  }
+
+  SizeOfUpdateBlueFW = SizeOfUpdate;
+  ExpecteduwCRCValue = uwCRCValue;
+
+  /* Erase again the chunks that could be partially written */
+  for(Chunk=0;Chunk<NumChunks;Chunk++) {
+    if(!OTA_CHUNK_IS_DONE(Chunk)) {
+      if(FirstMissing==NumChunks) {
+        FirstMissing = Chunk;
+      }
+      EraseFlashPages(OTA_MAGIC_NUM_POS+Chunk*OTA_RESUME_CHUNK_SIZE,1);
+    }
+  }
+
+  if(FirstMissing==NumChunks) {
+    /* Everything is already in Flash: resend only the last chunk for closing the update */
+    FirstMissing = NumChunks-1;
+    OTAChunkBitMap[FirstMissing>>3] &= ~(1<<(FirstMissing&0x7));
+    EraseFlashPages(OTA_MAGIC_NUM_POS+FirstMissing*OTA_RESUME_CHUNK_SIZE,1);
+  }
+
+  WritingAddress = OTA_ADDRESS_START + OTA_CHUNK_OFFSET(FirstMissing);
+  OTA_PRINTF("OTA resumed from %u/%u bytes\r\n",
+             (unsigned int) OTA_CHUNK_OFFSET(FirstMissing), (unsigned int) SizeOfUpdate);
+
+  return OTA_CHUNK_OFFSET(FirstMissing);
+}
+
+/**
+ * @brief Function for Reading the point from which one interrupted update continues
+ *
+ * The image is always written sequentially, so the update must be resent from
+ * the first chunk not saved in Flash up to the end: the chunks already saved
+ * after it are skipped by UpdateFWBlueMS.
+ * @param uint32_t *Offset Image offset from which the update must be resent [bytes]
+ * @retval uint32_t Number of bytes to resend (0 if there is nothing to resume)
+ */
+uint32_t GetResumePointFWBlueMS(uint32_t *Offset)
+{
+  OTAResumeHeader_t *Header = (OTAResumeHeader_t *)OTA_RESUME_STATE_POS;
+  uint32_t NumChunks;
+  uint32_t Chunk;
+
+  *Offset = 0;
+  if(OTAResumeStateLoad()==0) {
+    return 0;
+  }
+
+  NumChunks = OTA_CHUNKS_FOR(Header->SizeOfUpdate);
+  for(Chunk=0;Chunk<NumChunks;Chunk++) {
+    if(!OTA_CHUNK_IS_DONE(Chunk)) {
+      break;
+    }
+  }
+  if(Chunk==NumChunks) {
+    /* Everything is already in Flash: the last chunk closes the update */
+    Chunk = NumChunks-1;
+  }
+
+  *Offset = OTA_CHUNK_OFFSET(Chunk);
+  return Header->SizeOfUpdate - *Offset;
+}
+
+/* Local functions ----------------------------------------------------------*/
+/**
+ * @brief Erase some consecutive pages of Flash
+ * @param uint32_t Address Address of the first page
+ * @param uint32_t NbPages Number of pages to erase
+ * @retval None
+ */
+static void EraseFlashPages(uint32_t Address, uint32_t NbPages)
+{
+  FLASH_EraseInitTypeDef EraseInitStruct;
+  uint32_t SectorError = 0;
+
+  EraseInitStruct.TypeErase   = FLASH_TYPEERASE_PAGES;
+  EraseInitStruct.Banks       = GetBank(Address);
+  EraseInitStruct.Page        = GetPage(Address);
+  EraseInitStruct.NbPages     = NbPages;
+
+  /* Unlock the Flash to enable the flash control register access *************/
+  HAL_FLASH_Unlock();
+
+#ifdef STM32L4R9xx
+  /* Clear PEMPTY bit set (as the code is executed from Flash which is not empty) */
+  if (__HAL_FLASH_GET_FLAG(FLASH_FLAG_PEMPTY) != 0) {
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_PEMPTY);
+  }
+#endif /* STM32L4R9xx */
+
+  if(HAL_FLASHEx_Erase(&EraseInitStruct, &SectorError) != HAL_OK){
+    OTA_ERROR_FUNCTION();
+  }
+
+  /* Lock the Flash to disable the flash control register access */
+  HAL_FLASH_Lock();
+}
+
+/**
+ * @brief Erase the persisted OTA state and clean the received chunks bitmap
+ * @param None
+ * @retval None
+ */
+static void OTAResumeStateReset(void)
+{
+  if(*(uint64_t *)OTA_RESUME_STATE_POS != ((uint64_t)-1)) {
+    EraseFlashPages(OTA_RESUME_STATE_POS,OTA_RESUME_STATE_SIZE/FLASH_PAGE_SIZE);
+  }
+  memset(OTAChunkBitMap,0,sizeof(OTAChunkBitMap));
+  OTAJournalAddress = OTA_RESUME_JOURNAL_START;
+}
+
+/**
+ * @brief Invalidate the persisted OTA state without erasing it (Flash must be unlocked)
+ *
+ * The header is overwritten with zeros, that is the only value allowed on one
+ * double word already programmed. This does not stall the BLE stack with one
+ * erase: the next update erases the state from the task context.
+ * @param None
+ * @retval None
+ */
+static void OTAResumeStateInvalidate(void)
+{
+  if(*(uint64_t *)OTA_RESUME_STATE_POS != ((uint64_t)-1)) {
+    if(HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, OTA_RESUME_STATE_POS,0)!=HAL_OK) {
+      OTA_ERROR_FUNCTION();
+    }
+  }
+  memset(OTAChunkBitMap,0,sizeof(OTAChunkBitMap));
+  OTAJournalAddress = OTA_RESUME_JOURNAL_START;
+}
+
+/**
+ * @brief Rebuild the received chunks bitmap from the journal saved in Flash
+ * @param None
+ * @retval int32_t 1 if there is one valid OTA state, 0 otherwise
+ */
+static int32_t OTAResumeStateLoad(void)
+{
+  OTAResumeHeader_t *Header = (OTAResumeHeader_t *)OTA_RESUME_STATE_POS;
+
+  memset(OTAChunkBitMap,0,sizeof(OTAChunkBitMap));
+  OTAJournalAddress = OTA_RESUME_JOURNAL_START;
+
+  if((Header->MagicNum!=OTA_RESUME_MAGIC_NUM) ||
+     (Header->ChunkSize!=OTA_RESUME_CHUNK_SIZE) ||
+     (Header->SizeOfUpdate>OTA_MAX_PROG_SIZE)) {
+    return 0;
+  }
+
+  /* Each journal entry is one chunk index followed by its complement */
+  while(OTAJournalAddress<OTA_RESUME_JOURNAL_END) {
+    uint32_t Chunk   = *(uint32_t *)OTAJournalAddress;
+    uint32_t NotChunk= *(uint32_t *)(OTAJournalAddress+4);
+
+    if((Chunk==0xFFFFFFFF) && (NotChunk==0xFFFFFFFF)) {
+      /* End of the journal */
+      break;
+    }
+    if((Chunk==~NotChunk) && (Chunk<OTA_RESUME_MAX_CHUNKS)) {
+      OTAChunkBitMap[Chunk>>3] |= (1<<(Chunk&0x7));
+    }
+    OTAJournalAddress+=8;
+  }
+
+  return 1;
+}
+
+/**
+ * @brief Save on the journal one chunk completely written (Flash must be unlocked)
+ * @param uint32_t Chunk Index of the chunk
+ * @retval None
+ */
+static void OTAResumeMarkChunk(uint32_t Chunk)
+{
+  uint64_t ValueToWrite = (((uint64_t)(~Chunk))<<32) | Chunk;
+
+  OTAChunkBitMap[Chunk>>3] |= (1<<(Chunk&0x7));
+
+  if(OTAJournalAddress<OTA_RESUME_JOURNAL_END) {
+    if(HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, OTAJournalAddress,ValueToWrite)==HAL_OK) {
+      OTAJournalAddress+=8;
+    } else {
+      OTA_ERROR_FUNCTION();
+    }
+  }
 }
 
 /******************* (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -128,6 +128,8 @@ static void GAP_ConnectionComplete_CB(uint8_t addr[6], uint16_t handle);
 static void GAP_DisconnectionComplete_CB(void);
 #endif /* SENSING1_BlueNRG2 */
 static uint32_t DebugConsoleCommandParsing(uint8_t * att_data, uint8_t data_length);
+static void ReduceConnectionIntervalForOTA(void);
+static void SendFOTAPrepareMsg(uint32_t SizeOfUpdate, uint32_t uwCRCValue, uint8_t Resume);
 static uint32_t ConfigCommandParsing(uint8_t * att_data, uint8_t data_length);
 
 static void Read_Request_CB(uint16_t handle);
@@ -1732,6 +1734,84 @@ static void Attribute_Modified_Request_CB(uint16_t Connection_Handle, uint16_t a
   }
 }
 
+/**
+ * @brief  Reduce the connection interval for speeding up the FOTA
+ * @param  None
+ * @retval None
+ */
+static void ReduceConnectionIntervalForOTA(void)
+{
+#ifndef SENSING1_BlueNRG2
+  int ret = aci_l2cap_connection_parameter_update_request(
+#else /* SENSING1_BlueNRG2 */
+  int ret = aci_l2cap_connection_parameter_update_req(
+#endif /* SENSING1_BlueNRG2 */
+                                               connection_handle,
+                                               10 /* interval_min*/,
+                                               10 /* interval_max */,
+                                               0   /* slave_latency */,
+                                               400 /*timeout_multiplier*/);
+  /* Go to infinite loop if there is one error */
+  if (ret != BLE_STATUS_SUCCESS) {
+    while (1) {
+      SENSING1_PRINTF("Problem Changing the connection interval\r\n");
+    }
+  }
+}
+
+/**
+ * @brief  Ask the Host thread to prepare the Flash for one FOTA
+ * @param  uint32_t SizeOfUpdate size of the firmware image [bytes]
+ * @param  uint32_t uwCRCValue expected CRC value
+ * @param  uint8_t Resume 1/0 for resuming or not one interrupted update
+ * @retval None
+ */
+static void SendFOTAPrepareMsg(uint32_t SizeOfUpdate, uint32_t uwCRCValue, uint8_t Resume)
+{
+  msgData_t msg;
+  msg.type              = FOTA_PREPARE;
+  msg.fota.SizeOfUpdate = SizeOfUpdate;
+  msg.fota.uwCRCValue   = uwCRCValue;
+  msg.fota.Resume       = Resume;
+  SendMsgToHost(&msg);
+}
+
+/**
+ * @brief  Prepare the Flash for one FOTA and answer to the BlueMS application
+ *         (called from the Host thread for keeping the Flash erase out of the BLE callbacks)
+ * @param  uint32_t SizeOfUpdate size of the firmware image [bytes]
+ * @param  uint32_t uwCRCValue expected CRC value
+ * @param  uint8_t Resume 1/0 for resuming or not one interrupted update
+ * @retval None
+ */
+void FOTA_Prepare(uint32_t SizeOfUpdate, uint32_t uwCRCValue, uint8_t Resume)
+{
+  uint32_t ResumeOffset = 0;
+
+  if (Resume) {
+    /* Restore the progress or Reset the Flash */
+    ResumeOffset = ResumeUpdateFWBlueMS(SizeOfUpdate, uwCRCValue);
+    SENSING1_PRINTF("OTA %s SIZE=%ld uwCRCValue=%lx Resume=%ld\r\n",
+                    SENSING1_PACKAGENAME, SizeOfUpdate, uwCRCValue, ResumeOffset);
+  } else {
+    /* Reset the Flash */
+    StartUpdateFWBlueMS(SizeOfUpdate, uwCRCValue);
+  }
+  SizeOfUpdateBlueFW = SizeOfUpdate - ResumeOffset;
+
+  /* Reduce the connection interval */
+  ReduceConnectionIntervalForOTA();
+
+  /* Signal that we are ready sending back the CRC value (and the offset to restart from) */
+  memcpy(BufferToWrite, (uint8_t *)&uwCRCValue, 4);
+  BytesToWrite = 4;
+  if (Resume) {
+    memcpy(BufferToWrite + 4, (uint8_t *)&ResumeOffset, 4);
+    BytesToWrite = 8;
+  }
+  Term_Update(BufferToWrite, BytesToWrite);
+}
+
 static uint32_t DebugConsoleCommandParsing(uint8_t * att_data, uint8_t data_length)
 {
   BaseType_t xMoreDataToFollow;
@@ -1774,40 +1854,53 @@ static uint32_t DebugConsoleCommandParsing(uint8_t * att_data, uint8_t data_leng
       SENSING1_PRINTF("OTA %s SIZE=%ld uwCRCValue=%lx\r\n",
                       SENSING1_PACKAGENAME, SizeOfUpdateBlueFW, uwCRCValue);
 
-      /* Reset the Flash */
-      StartUpdateFWBlueMS(SizeOfUpdateBlueFW, uwCRCValue);
+      /* Reset the Flash from the Host thread, the answer is sent once done */
+      SendFOTAPrepareMsg(SizeOfUpdateBlueFW, uwCRCValue, 0);
+      SizeOfUpdateBlueFW = 0;
+    }
 
-      /* Reduce the connection interval */
-      {
-#ifndef SENSING1_BlueNRG2
-           int ret = aci_l2cap_connection_parameter_update_request(
-#else /* SENSING1_BlueNRG2 */
-           int ret = aci_l2cap_connection_parameter_update_req(
-#endif /* SENSING1_BlueNRG2 */
+    return 0; /* Do not send data back */
+  }
+  else if (!strncmp("resumeFw", (char *)att_data, 8))
+  {
+    /* Same format of upgradeFw: Size of the Update and CRC value */
+    uint32_t SizeOfUpdate;
+    uint32_t uwCRCValue;
 
-                                                        connection_handle,
-                                                        10 /* interval_min*/,
-                                                        10 /* interval_max */,
-                                                        0   /* slave_latency */,
-                                                        400 /*timeout_multiplier*/);
-          /* Go to infinite loop if there is one error */
-          if (ret != BLE_STATUS_SUCCESS) {
-            while (1) {
-              SENSING1_PRINTF("Problem Changing the connection interval\r\n");
-            }
-          }
-        }
+    memcpy((uint8_t *)&SizeOfUpdate, att_data + 8, 4);
+    memcpy((uint8_t *)&uwCRCValue, att_data + 12, 4);
 
-        /* Signal that we are ready sending back the CRV value*/
-        BufferToWrite[0] = PointerByte[0];
-        BufferToWrite[1] = PointerByte[1];
-        BufferToWrite[2] = PointerByte[2];
-        BufferToWrite[3] = PointerByte[3];
-        BytesToWrite = 4;
-        Term_Update(BufferToWrite, BytesToWrite);
-      }
+    if (SizeOfUpdate > OTA_MAX_PROG_SIZE)
+    {
+      SENSING1_PRINTF("OTA %s SIZE=%ld > %d Max Allowed\r\n",
+                      SENSING1_PACKAGENAME, SizeOfUpdate, OTA_MAX_PROG_SIZE);
+      /* Answer with a wrong CRC value for signaling the problem to BlueMS application */
+      uwCRCValue = ~uwCRCValue;
+      memcpy(BufferToWrite, (uint8_t *)&uwCRCValue, 4);
+      BytesToWrite = 4;
+      Term_Update(BufferToWrite, BytesToWrite);
+    }
+    else
+    {
+      /* Restore the progress or Reset the Flash from the Host thread, the answer is sent once done */
+      SendFOTAPrepareMsg(SizeOfUpdate, uwCRCValue, 1);
+    }
+
+    return 0; /* Do not send data back */
+  }
+  else if (!strncmp("missingFw", (char *)att_data, 9))
+  {
+    /* Answer with the (Offset,Length) to resend for completing the update,
+     * (0,0) if there is nothing to resume */
+    uint32_t ResumeOffset;
+    uint32_t ResumeLength = GetResumePointFWBlueMS(&ResumeOffset);
+
+    memcpy(BufferToWrite, (uint8_t *)&ResumeOffset, 4);
+    memcpy(BufferToWrite + 4, (uint8_t *)&ResumeLength, 4);
+    BytesToWrite = 8;
+    Term_Update(BufferToWrite, BytesToWrite);
 
-      return 0; /* Do not send data back */
+    return 0; /* Do not send data back */
   }
   else if (!strncmp("setName ", (char *)att_data, 8))
   {
@@ -57,12 +57,17 @@ extern void SaveDataAnnotation(uint8_t *Annotation);
 extern void DATALOG_SD_Init(void);
 extern void DATALOG_SD_DeInit(void);
 
+/* Trace recorder stream on the SD card (configUSE_TRACE_RECORDER) */
+extern void SdCardTraceRecordingRun(void);
+extern void DATALOG_SD_TraceFlush(void);
+
 #ifndef STM32_SENSORTILEBOX
 extern void volumeInit(void);
 #endif /* STM32_SENSORTILEBOX */
 
 /* Exported Variables --------------------------------------------------------*/
 extern volatile uint8_t writeAudio_flag;
+extern volatile uint8_t writeTrace_flag;
 extern uint32_t SD_LogAudio_Enabled;
 extern uint32_t SD_LogMems_Enabled;
 extern uint32_t SD_Card_FeaturesMask;
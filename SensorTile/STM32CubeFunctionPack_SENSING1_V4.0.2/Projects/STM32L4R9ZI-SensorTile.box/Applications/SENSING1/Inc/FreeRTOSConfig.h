@@ -91,7 +91,14 @@
  extern uint32_t SystemCoreClock;
 #endif
 
-  #define configUSE_TRACE_FACILITY          0
+/* Needed by uxTaskGetSystemState() for the "cpu" CLI command. The Tracealyzer
+   recorder is controlled separately by configUSE_TRACE_RECORDER. */
+#define configUSE_TRACE_FACILITY          1
+
+/* Stream the kernel trace (Tracealyzer recorder in streaming mode) over USB CDC,
+   or to the SD card on SensorTile.box; see Inc/trcStreamingPort.h. Capture is
+   started and stopped with the "trace" CLI command. */
+#define configUSE_TRACE_RECORDER          0
 
 #define configUSE_TICKLESS_IDLE           1
 #define configEXPECTED_IDLE_TIME_BEFORE_SLEEP  3
@@ -113,7 +120,7 @@
 #define configUSE_MALLOC_FAILED_HOOK      0
 #define configUSE_APPLICATION_TASK_TAG    0
 #define configUSE_COUNTING_SEMAPHORES     1
-#define configGENERATE_RUN_TIME_STATS     0
+#define configGENERATE_RUN_TIME_STATS     1
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES           0
@@ -136,6 +143,20 @@ to exclude the API function. */
 #define INCLUDE_vTaskDelay             1
 #define INCLUDE_xTaskGetSchedulerState 1
 
+/* Run time statistics: the DWT cycle counter extended in software and
+   prescaled by 2^configRUN_TIME_COUNTER_SHIFT, see ulGetRunTimeCounterValue().
+   At 80 MHz one count is 51 us and the 32 bits task counters wrap after ~61 h. */
+#if (configGENERATE_RUN_TIME_STATS == 1)
+  #define configRUN_TIME_COUNTER_SHIFT    12
+  #if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+    extern void vConfigureTimerForRunTimeStats(void);
+    extern uint32_t ulGetRunTimeCounterValue(void);
+    extern void vRunTimeCounterResync(void);
+  #endif
+  #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() vConfigureTimerForRunTimeStats()
+  #define portGET_RUN_TIME_COUNTER_VALUE()         ulGetRunTimeCounterValue()
+#endif /* (configGENERATE_RUN_TIME_STATS == 1) */
+
 /* Cortex-M specific definitions. */
 #ifdef __NVIC_PRIO_BITS
  /* __BVIC_PRIO_BITS will be specified when CMSIS is being used. */
@@ -183,8 +204,8 @@ global buffer is just set to be one byte long as it is not used and should not
 take up unnecessary RAM. */
 #define configCOMMAND_INT_MAX_OUTPUT_SIZE 1
 
-#ifdef __ICCARM__
-  #if ( configUSE_TRACE_FACILITY == 1 )
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+  #if ( configUSE_TRACE_RECORDER == 1 )
     #include "trcRecorder.h"
   #endif
 #endif
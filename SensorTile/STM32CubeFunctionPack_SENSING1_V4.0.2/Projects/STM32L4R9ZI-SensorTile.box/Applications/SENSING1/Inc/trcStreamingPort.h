@@ -0,0 +1,80 @@
+/**
+  ******************************************************************************
+  * @file    trcStreamingPort.h
+  * @author  Central LAB
+  * @version V4.0.0
+  * @date    30-Oct-2019
+  * @brief   Trace recorder stream port on the SD card
+  *
+  *          Used in place of Utilities/TraceRecorder/streamports/File, that
+  *          targets a stdio file: here the trace is written to a .psf file
+  *          on the FatFs volume of the data log (see DataLog_Manager.c),
+  *          through a double buffer flushed by ProcessThread in whole
+  *          sectors. Recording is started and stopped with the "trace" CLI
+  *          command.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; COPYRIGHT(c) 2018 STMicroelectronics</center></h2>
+  *
+  * Redistribution and use in source and binary forms, with or without modification,
+  * are permitted provided that the following conditions are met:
+  *   1. Redistributions of source code must retain the above copyright notice,
+  *      this list of conditions and the following disclaimer.
+  *   2. Redistributions in binary form must reproduce the above copyright notice,
+  *      this list of conditions and the following disclaimer in the documentation
+  *      and/or other materials provided with the distribution.
+  *   3. Neither the name of STMicroelectronics nor the names of its contributors
+  *      may be used to endorse or promote products derived from this software
+  *      without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TRC_STREAMING_PORT_H
+#define TRC_STREAMING_PORT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported functions ------------------------------------------------------- */
+/* Implemented in DataLog_Manager.c */
+void DATALOG_SD_TraceBegin(void);
+void DATALOG_SD_TraceEnd(void);
+int32_t DATALOG_SD_TraceWrite(void *Buf, uint32_t Len, int32_t *BytesWritten);
+
+/* Exported macro ------------------------------------------------------------*/
+/* TRC_STREAM_PORT_INIT is left to its default: the volume is mounted by the
+   data log on the first write */
+#define TRC_STREAM_PORT_READ_DATA(_ptrData, _size, _ptrBytesRead) \
+        ((void)(_ptrData), (void)(_size), *(_ptrBytesRead) = 0, 0)
+
+#define TRC_STREAM_PORT_WRITE_DATA(_ptrData, _size, _ptrBytesSent) \
+        DATALOG_SD_TraceWrite(_ptrData, _size, _ptrBytesSent)
+
+#define TRC_STREAM_PORT_ON_TRACE_BEGIN() DATALOG_SD_TraceBegin()
+#define TRC_STREAM_PORT_ON_TRACE_END()   DATALOG_SD_TraceEnd()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_STREAMING_PORT_H */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
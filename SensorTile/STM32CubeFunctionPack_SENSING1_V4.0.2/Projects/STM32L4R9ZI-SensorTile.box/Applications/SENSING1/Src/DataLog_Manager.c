@@ -58,9 +58,22 @@ extern osSemaphoreId semRun;
 #define AUDIO_BUFF_LEN (PCM_AUDIO_IN_SAMPLES *64)
 #define AUDIO_BUFF_LEN_MASK (AUDIO_BUFF_LEN - 1)
 
+#if (configUSE_TRACE_RECORDER == 1)
+/* Trace recorder stream: each half of the double buffer is a whole number of
+   SD sectors, so that it is written directly to the card by FatFs */
+#define TRACE_BUFF_LEN (8 * 512)
+/* Max time waited by the trace recorder for a free half buffer */
+#define TRACE_WRITE_TIMEOUT_MS 100
+/* Number of half buffers written between two f_sync() (512KB) */
+#define TRACE_SYNC_PERIOD 128
+#endif /* (configUSE_TRACE_RECORDER == 1) */
+
 /* Exported Variables -------------------------------------------------------------*/
 volatile uint8_t writeAudio_flag=0;
 volatile uint32_t NbAudioSamplesCounter;
+#if (configUSE_TRACE_RECORDER == 1)
+volatile uint8_t writeTrace_flag=0;
+#endif /* (configUSE_TRACE_RECORDER == 1) */
 
 /* Feature mask that identify the data mens selected for recording*/
 uint32_t SD_Card_FeaturesMask= 0;
@@ -103,10 +116,30 @@ static char *MonthName[]={"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug"
 
 static uint16_t *Audio_OUT_Buff = NULL;
 
+#if (configUSE_TRACE_RECORDER == 1)
+/* Filled by the trace recorder task (TzCtrl), written by ProcessThread */
+static uint32_t Trace_OUT_Buff[2][TRACE_BUFF_LEN / sizeof(uint32_t)];
+static volatile uint32_t TraceBuffLen[2];
+static volatile uint32_t TraceBuffFull[2];
+static volatile uint32_t TraceBuffIndex = 0;
+static volatile uint32_t IsTraceStreaming = 0;
+static volatile uint32_t TraceStopRequest = 0;
+static uint32_t SD_LogTrace_Enabled = 0;
+static uint32_t TraceWriteCounter = 0;
+static FIL MyFileTrace;
+#endif /* (configUSE_TRACE_RECORDER == 1) */
+
 /* Private Prototypes -------------------------------------------------------------*/
 static uint32_t WavProcess_HeaderInit(void);
 static uint32_t WavProcess_HeaderUpdate(uint32_t len);
 
+#if (configUSE_TRACE_RECORDER == 1)
+static void CreateTraceFileName(char *FileName);
+static uint8_t DATALOG_SD_LogTrace_Enable(void);
+static void DATALOG_SD_LogTrace_Disable(void);
+static void SaveTraceData(uint32_t Index);
+#endif /* (configUSE_TRACE_RECORDER == 1) */
+
 static void CreateMemsFileName(char *FileName,uint32_t OnlyForAnnotation);
 static void CreateAudioFileName(char *FileName);
 
@@ -702,6 +735,217 @@ void SdCardAudioRecordingRun(void)
   LedOffTargetPlatform();
 }
 
+#if (configUSE_TRACE_RECORDER == 1)
+/**
+  * @brief  Start of the trace recorder stream (TRC_STREAM_PORT_ON_TRACE_BEGIN)
+  * @note   Called by the recorder inside a critical section: no RTOS call here,
+  *         the file is opened by ProcessThread with the first full buffer
+  * @param  None
+  * @retval None
+  */
+void DATALOG_SD_TraceBegin(void)
+{
+  TraceBuffLen[0] = TraceBuffLen[1] = 0;
+  TraceBuffFull[0] = TraceBuffFull[1] = 0;
+  TraceBuffIndex = 0;
+  TraceStopRequest = 0;
+  IsTraceStreaming = 1;
+}
+
+/**
+  * @brief  End of the trace recorder stream (TRC_STREAM_PORT_ON_TRACE_END)
+  * @note   Called by the recorder inside a critical section: the last buffer
+  *         is written and the file closed by ProcessThread on its next run,
+  *         see DATALOG_SD_TraceFlush()
+  * @param  None
+  * @retval None
+  */
+void DATALOG_SD_TraceEnd(void)
+{
+  IsTraceStreaming = 0;
+  TraceStopRequest = 1;
+  writeTrace_flag = 1;
+}
+
+/**
+  * @brief  Wake up ProcessThread for closing the trace file after a stop
+  * @param  None
+  * @retval None
+  */
+void DATALOG_SD_TraceFlush(void)
+{
+  writeTrace_flag = 1;
+  if(semRun) {
+    osSemaphoreRelease(semRun);
+  }
+}
+
+/**
+  * @brief  Write function of the trace recorder stream port (called by TzCtrl)
+  *
+  *         Trace data is accumulated in one half of the double buffer, that is
+  *         handed to ProcessThread when full. The recorder task waits here if
+  *         the SD card is late, then gives up and retries later.
+  * @param  Buf          Trace data
+  * @param  Len          Number of bytes to be written
+  * @param  BytesWritten Number of bytes accepted
+  * @retval 0 on success, -1 if no buffer is free
+  */
+int32_t DATALOG_SD_TraceWrite(void *Buf, uint32_t Len, int32_t *BytesWritten)
+{
+  uint32_t Timeout = TRACE_WRITE_TIMEOUT_MS;
+  uint32_t Index = TraceBuffIndex;
+  uint32_t Free;
+
+  *BytesWritten = 0;
+
+  if(!IsTraceStreaming) {
+    /* Trace stopped: discard the data left in the recorder buffer */
+    *BytesWritten = Len;
+    return 0;
+  }
+
+  while(TraceBuffFull[Index]) {
+    if(Timeout-- == 0) {
+      return -1;
+    }
+    osDelay(1);
+  }
+
+  Free = TRACE_BUFF_LEN - TraceBuffLen[Index];
+  if(Len > Free) {
+    Len = Free;
+  }
+  memcpy(((uint8_t *)Trace_OUT_Buff[Index]) + TraceBuffLen[Index], Buf, Len);
+  TraceBuffLen[Index] += Len;
+  *BytesWritten = Len;
+
+  if(TraceBuffLen[Index] == TRACE_BUFF_LEN) {
+    /* Hand the full half to ProcessThread and go on with the other one */
+    TraceBuffFull[Index] = 1;
+    TraceBuffIndex = Index ^ 1;
+    writeTrace_flag = 1;
+    if(semRun) {
+      osSemaphoreRelease(semRun);
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * @brief  SD Card trace recorder logging run
+ * @param  None
+ * @retval None
+ */
+void SdCardTraceRecordingRun(void)
+{
+  uint32_t Index = TraceBuffIndex;
+
+  if((!SD_LogTrace_Enabled) && (TraceBuffFull[0] || TraceBuffFull[1] || TraceStopRequest)) {
+    if(NoSDFlag) {
+      DATALOG_SD_Init();
+    }
+
+    if((NoSDFlag) || (!DATALOG_SD_LogTrace_Enable())) {
+      SENSING1_PRINTF("Error: trace file not opened, trace stopped\r\n");
+      vTraceStop();
+      TraceBuffFull[0] = TraceBuffFull[1] = 0;
+      TraceStopRequest = 0;
+      return;
+    }
+  }
+
+  /* Oldest buffer first: the one being filled is full only if both are */
+  if(TraceBuffFull[Index]) {
+    SaveTraceData(Index);
+  }
+  if(TraceBuffFull[Index ^ 1]) {
+    SaveTraceData(Index ^ 1);
+  }
+
+  if(TraceStopRequest) {
+    TraceStopRequest = 0;
+
+    /* Last partial buffer */
+    Index = TraceBuffIndex;
+    if(TraceBuffLen[Index]) {
+      SaveTraceData(Index);
+    }
+    DATALOG_SD_LogTrace_Disable();
+  }
+}
+
+/**
+  * @brief  Write one half of the trace double buffer to the SD card
+  * @param  Index Half buffer to be written
+  * @retval None
+  */
+static void SaveTraceData(uint32_t Index)
+{
+  uint32_t byteswritten;
+
+  if(f_write(&MyFileTrace, (uint8_t *)Trace_OUT_Buff[Index], TraceBuffLen[Index], (void *)&byteswritten) != FR_OK) {
+    if(W2ST_CHECK_CONNECTION(W2ST_CONNECT_SD_CARD_LOGGING)) {
+      SDLog_Update(SD_CARD_LOGGING_IO_ERROR);
+    }
+  }
+
+  /* Keep what is already on the card readable if the power goes */
+  if((++TraceWriteCounter % TRACE_SYNC_PERIOD) == 0) {
+    f_sync(&MyFileTrace);
+  }
+
+  TraceBuffLen[Index] = 0;
+  TraceBuffFull[Index] = 0;
+}
+
+/**
+  * @brief  Open the trace file
+  * @param  None
+  * @retval 1 if the file is open, 0 otherwise
+  */
+static uint8_t DATALOG_SD_LogTrace_Enable(void)
+{
+  uint32_t SDCardFileCount = 0;
+  char TraceFileName[SENSING1_MAX_LEN_LOG_FILE_NAME];
+
+  CreateTraceFileName(TraceFileName);
+
+  while(SD_LogTrace_Enabled==0) {
+    SDCardFileCount++;
+
+    if(f_open(&MyFileTrace, (char const*)TraceFileName, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) {
+      if(SDCardFileCount > MAX_TRIALS_OPENS_SD) {
+        return 0;
+      }
+      osDelay(100);
+    } else {
+      SD_LogTrace_Enabled =1;
+      SENSING1_PRINTF("Trace FileName=%s\r\n",TraceFileName);
+    }
+  }
+
+  TraceWriteCounter = 0;
+  PowerCtrlLock();
+  return 1;
+}
+
+/**
+  * @brief  Close the trace file
+  * @param  None
+  * @retval None
+  */
+static void DATALOG_SD_LogTrace_Disable(void)
+{
+  if(SD_LogTrace_Enabled) {
+    f_close(&MyFileTrace);
+    SD_LogTrace_Enabled=0;
+    PowerCtrlUnLock();
+  }
+}
+#endif /* (configUSE_TRACE_RECORDER == 1) */
+
 /**
   * @brief  Start SD-Card demo
   * @param  None
@@ -1242,6 +1486,26 @@ static void CreateAudioFileName(char *FileName)
                      CurrentTime.Seconds);
 }
 
+#if (configUSE_TRACE_RECORDER == 1)
+/**
+* @brief  Create file name for trace recorder data loggimg.
+* @param  FileName Name of the create file
+* @retval None
+*/
+static void CreateTraceFileName(char *FileName)
+{
+  RTC_GetCurrentDateTime();
+  sprintf(FileName, "%s-Trace_%02d_%s_%02d_%02dh_%02dm_%02ds.psf",
+                     DefaultDataFileName,
+                     CurrentDate.Date,
+                     MonthName[CurrentDate.Month-1],
+                     CurrentDate.Year,
+                     CurrentTime.Hours,
+                     CurrentTime.Minutes,
+                     CurrentTime.Seconds);
+}
+#endif /* (configUSE_TRACE_RECORDER == 1) */
+
 /**
  * @brief  Gets Time from RTC for FatFs
  * @param  None
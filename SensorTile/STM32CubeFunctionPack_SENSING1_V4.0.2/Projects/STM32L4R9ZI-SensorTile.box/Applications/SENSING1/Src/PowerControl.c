@@ -65,6 +65,12 @@ static RCC_OscInitTypeDef RCC_OscInitStruct = {0};
 static RCC_PeriphCLKInitTypeDef PeriphClkInit = {0};
 static uint32_t pFLatency = 0;
 
+#if (configGENERATE_RUN_TIME_STATS == 1)
+/* Run time statistics counter: DWT cycle counter accumulated on 64 bits */
+static uint64_t RunTimeCycles = 0;
+static uint32_t RunTimeLastCyccnt = 0;
+#endif /* (configGENERATE_RUN_TIME_STATS == 1) */
+
 powerState_t GetMinPowerMode(void)
 {
   return minPowerMode;
@@ -92,9 +98,72 @@ int PowerCtrlGetState(void)
 
 void vApplicationIdleHook( void )
 {
+#if (configGENERATE_RUN_TIME_STATS == 1)
+   /* Keep the counter extension alive across long idle periods */
+   (void) ulGetRunTimeCounterValue();
+#endif /* (configGENERATE_RUN_TIME_STATS == 1) */
    __WFI();
 }
 
+#if (configGENERATE_RUN_TIME_STATS == 1)
+/**
+  * @brief  Enable the DWT cycle counter used for the FreeRTOS run time statistics
+  * @param  None
+  * @retval None
+  */
+void vConfigureTimerForRunTimeStats(void)
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  RunTimeCycles = 0;
+  RunTimeLastCyccnt = DWT->CYCCNT;
+}
+
+/**
+  * @brief  Read the run time statistics counter
+  *
+  *         The 32 bits DWT cycle counter wraps every few tens of seconds, so it
+  *         is accumulated on 64 bits and returned divided by
+  *         2^configRUN_TIME_COUNTER_SHIFT. It must be read at least once per
+  *         wrap period: the kernel does it on each context switch and the idle
+  *         hook on each wake up. The counter does not run in STOP mode, the
+  *         time spent there is not accounted to any task.
+  * @param  None
+  * @retval Counter value in units of 2^configRUN_TIME_COUNTER_SHIFT CPU cycles
+  */
+uint32_t ulGetRunTimeCounterValue(void)
+{
+  uint32_t primask = __get_PRIMASK();
+  uint32_t cyccnt;
+  uint32_t value;
+
+  __disable_irq();
+  cyccnt = DWT->CYCCNT;
+  RunTimeCycles += (uint32_t)(cyccnt - RunTimeLastCyccnt);
+  RunTimeLastCyccnt = cyccnt;
+  value = (uint32_t)(RunTimeCycles >> configRUN_TIME_COUNTER_SHIFT);
+  __set_PRIMASK(primask);
+
+  return value;
+}
+
+/**
+  * @brief  Resynchronize the run time statistics counter after the DWT cycle
+  *         counter has been reset (the trace recorder does it on start)
+  * @param  None
+  * @retval None
+  */
+void vRunTimeCounterResync(void)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  RunTimeLastCyccnt = DWT->CYCCNT;
+  __set_PRIMASK(primask);
+}
+#endif /* (configGENERATE_RUN_TIME_STATS == 1) */
+
 int initPowerController(void)
 {
     SetMinPowerMode (RUN);
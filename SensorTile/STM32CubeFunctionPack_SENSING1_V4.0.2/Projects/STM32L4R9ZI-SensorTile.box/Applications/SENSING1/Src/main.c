@@ -379,8 +379,9 @@ int main(void)
 {
   HardwareInit();
 
-#if ( configUSE_TRACE_FACILITY == 1 )
-  vTraceEnable(TRC_START);
+#if ( configUSE_TRACE_RECORDER == 1 )
+  /* Only register the kernel objects, the streaming is started by the "trace" CLI command */
+  vTraceEnable(TRC_INIT);
 #endif
 
   /* Create threads */
@@ -506,6 +507,14 @@ static void ProcessThread(void const *argument)
         writeAudio_flag=0;
         SdCardAudioRecordingRun();
       }
+
+#if (configUSE_TRACE_RECORDER == 1)
+      /* For trace recorder data */
+      if(writeTrace_flag) {
+        writeTrace_flag=0;
+        SdCardTraceRecordingRun();
+      }
+#endif /* (configUSE_TRACE_RECORDER == 1) */
 #endif /* SENSING1_USE_DATALOG */
 
 #if SENSING1_USE_BATTERY
@@ -651,6 +660,10 @@ static void HostThread(void const *argument)
           UpdateTermStdErr(msgPtr->term.data,msgPtr->term.length);
           break;
 
+        case FOTA_PREPARE:
+          FOTA_Prepare(msgPtr->fota.SizeOfUpdate,msgPtr->fota.uwCRCValue,msgPtr->fota.Resume);
+          break;
+
         default :
           SENSING1_PRINTF("HostThread unexpected message:%d\r\n",msgPtr->type );
       }
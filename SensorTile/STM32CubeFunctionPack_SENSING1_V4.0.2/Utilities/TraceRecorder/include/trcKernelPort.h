@@ -52,7 +52,13 @@
 extern "C" {
 #endif
 
+/* configUSE_TRACE_RECORDER, when defined, enables the recorder independently of
+configUSE_TRACE_FACILITY, so that the kernel statistics API can be used alone */
+#ifdef configUSE_TRACE_RECORDER
+#define TRC_USE_TRACEALYZER_RECORDER configUSE_TRACE_RECORDER
+#else
 #define TRC_USE_TRACEALYZER_RECORDER configUSE_TRACE_FACILITY
+#endif
 
 /*** FreeRTOS version codes **************************************************/
 #define FREERTOS_VERSION_NOT_SET				0
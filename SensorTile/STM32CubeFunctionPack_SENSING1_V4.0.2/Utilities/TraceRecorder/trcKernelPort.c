@@ -44,7 +44,11 @@
 
 #include "FreeRTOS.h"
 
-#if (!defined(TRC_USE_TRACEALYZER_RECORDER) && configUSE_TRACE_FACILITY == 1)
+#if defined(configUSE_TRACE_RECORDER)
+#if (!defined(TRC_USE_TRACEALYZER_RECORDER) && configUSE_TRACE_RECORDER == 1)
+#error Trace Recorder: You need to include trcRecorder.h at the end of your FreeRTOSConfig.h!
+#endif
+#elif (!defined(TRC_USE_TRACEALYZER_RECORDER) && configUSE_TRACE_FACILITY == 1)
 #error Trace Recorder: You need to include trcRecorder.h at the end of your FreeRTOSConfig.h!
 #endif
 